@@ -245,6 +245,8 @@ class Configure(config.package.Package):
       self.addDefine('HAVE_MPI_WIN_ALLOCATE_SHARED', 1)
     if self.checkLink('#include <mpi.h>\n', 'if (MPI_Win_shared_query(MPI_WIN_NULL,0,0,0,0));\n'):
       self.addDefine('HAVE_MPI_WIN_SHARED_QUERY', 1)
+    if self.checkLink('#include <mpi.h>\n', 'MPI_Comm distcomm; MPI_Request req;\n if (MPI_Dist_graph_create_adjacent(MPI_COMM_WORLD,0,0,MPI_UNWEIGHTED,0,0,MPI_UNWEIGHTED,MPI_INFO_NULL,0,&distcomm));\n if (MPI_Ineighbor_alltoallv(0,0,0,MPI_INT,0,0,0,MPI_INT,distcomm,&req));\n'):
+      self.addDefine('HAVE_MPI_NEIGHBORHOOD_COLLECTIVES', 1)
     if 'HAVE_MPI_WIN_CREATE' in self.defines and 'HAVE_MPI_WIN_ALLOCATE_SHARED' in self.defines and 'HAVE_MPI_WIN_SHARED_QUERY' in self.defines:
       if (hasattr(self, 'mpich_numversion') and int(self.mpich_numversion) > 30004300) or not hasattr(self, 'mpich_numversion'):
         self.addDefine('HAVE_MPI_WIN_CREATE_FEATURE',1)
@@ -817,6 +817,16 @@ fprintf(f, "%lu\\n", (unsigned long)sizeof(struct mystruct));
       self.addDefine('HAVE_BUILTIN_EXPECT', 1)
     self.popLanguage()
 
+  def configureCPUDispatch(self):
+    '''Sees if the compiler supports __attribute__((target())) and __builtin_cpu_supports() so that x86 SIMD kernels can be selected at runtime'''
+    self.pushLanguage(self.languages.clanguage)
+    includes = '#include <immintrin.h>\nstatic __attribute__((target("avx512f"))) double f(const double *x) {return _mm512_reduce_add_pd(_mm512_loadu_pd(x));}\n'
+    body     = 'double x[8] = {0}; __builtin_cpu_init(); if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return (int)f(x);'
+    if self.checkLink(includes, body):
+      self.addDefine('HAVE_ATTRIBUTE_TARGET', 1)
+      self.addDefine('HAVE_BUILTIN_CPU_SUPPORTS', 1)
+    self.popLanguage()
+
   def configureFunctionName(self):
     '''Sees if the compiler supports __func__ or a variant.'''
     def getFunctionName(lang):
@@ -1085,6 +1095,7 @@ fprintf(f, "%lu\\n", (unsigned long)sizeof(struct mystruct));
     self.executeTest(self.configureIsatty)
     self.executeTest(self.configureExpect);
     self.executeTest(self.configureAlign);
+    self.executeTest(self.configureCPUDispatch)
     self.executeTest(self.configureFunctionName);
     self.executeTest(self.configureIntptrt);
     self.executeTest(self.configureSolaris)
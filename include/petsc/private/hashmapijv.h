@@ -0,0 +1,34 @@
+#if !defined(_PETSC_HASHMAPIJV_H)
+#define _PETSC_HASHMAPIJV_H
+
+#include <petsc/private/hashmap.h>
+
+#if !defined(_PETSC_HASHIJKEY)
+#define _PETSC_HASHIJKEY
+typedef struct _PetscHashIJKey { PetscInt i, j; } PetscHashIJKey;
+#define PetscHashIJKeyHash(key) PetscHashCombine(PetscHashInt((key).i),PetscHashInt((key).j))
+#define PetscHashIJKeyEqual(k1,k2) (((k1).i == (k2).i) ? ((k1).j == (k2).j) : 0)
+#endif
+
+PETSC_HASH_MAP(HMapIJV, PetscHashIJKey, PetscScalar, PetscHashIJKeyHash, PetscHashIJKeyEqual, -1)
+
+/*
+   PetscHMapIJVQueryAdd - Adds val to the value of key, inserting key with value val if it is missing
+*/
+PETSC_STATIC_INLINE PETSC_UNUSED
+PetscErrorCode PetscHMapIJVQueryAdd(PetscHMapIJV ht,PetscHashIJKey key,PetscScalar val,PetscBool *missing)
+{
+  int      ret;
+  khiter_t iter;
+  PetscFunctionBeginHot;
+  PetscValidPointer(ht,1);
+  PetscValidPointer(missing,4);
+  iter = kh_put(HMapIJV,ht,key,&ret);
+  PetscHashAssert(ret>=0);
+  if (ret) kh_val(ht,iter) = val;
+  else     kh_val(ht,iter) += val;
+  *missing = ret ? PETSC_TRUE : PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+#endif /* _PETSC_HASHMAPIJV_H */
@@ -20,6 +20,7 @@ struct _KSPOps {
                                                           calculates the residual in a
                                                           user-provided area.  */
   PetscErrorCode (*solve)(KSP);                        /* actual solver */
+  PetscErrorCode (*matsolve)(KSP,Mat,Mat);             /* block solver for the columns of a dense matrix */
   PetscErrorCode (*setup)(KSP);
   PetscErrorCode (*setfromoptions)(PetscOptionItems*,KSP);
   PetscErrorCode (*publishoptions)(KSP);
@@ -188,6 +189,18 @@ PETSC_INTERN PetscErrorCode KSPSetUpNorms_Private(KSP,PetscBool,KSPNormType*,PCS
 
 PETSC_INTERN PetscErrorCode KSPPlotEigenContours_Private(KSP,PetscInt,const PetscReal*,const PetscReal*);
 
+/* Polynomial bases of the s-step Krylov methods KSPCACG and KSPCAGMRES: M v_k = gamma_k v_{k+1} + theta_k v_k + mu_k v_{k-1} */
+typedef enum {KSP_SSTEP_BASIS_MONOMIAL,KSP_SSTEP_BASIS_NEWTON,KSP_SSTEP_BASIS_CHEBYSHEV} KSPSStepBasisType;
+PETSC_INTERN const char *const KSPSStepBasisTypes[];
+PETSC_INTERN PetscErrorCode KSPSStepBasisCoefficients_Private(KSPSStepBasisType,PetscInt,const PetscReal*,const PetscReal*,PetscInt,PetscScalar*,PetscScalar*,PetscScalar*);
+
+/* Building blocks of the block Krylov methods used by KSPMatSolve(); the blocks of vectors are dense matrices with one vector per column */
+PETSC_INTERN PetscErrorCode KSPMatSolveColumns_Private(KSP,Mat,Mat);
+PETSC_INTERN PetscErrorCode KSPMatSolveMatMult_Private(KSP,Mat,Mat*,Vec,Vec);
+PETSC_INTERN PetscErrorCode KSPMatSolvePCApply_Private(KSP,Mat,Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode KSPMatSolveDot_Private(KSP,PetscInt,PetscInt,const PetscScalar*,PetscInt,const PetscScalar*,PetscScalar*);
+PETSC_INTERN PetscErrorCode KSPMatSolveConverged_Private(KSP,PetscInt,PetscInt,const PetscReal*,const PetscReal*);
+
 typedef struct _p_DMKSP *DMKSP;
 typedef struct _DMKSPOps *DMKSPOps;
 struct _DMKSPOps {
@@ -330,6 +343,7 @@ PETSC_STATIC_INLINE PetscErrorCode KSP_PCApplyBAorABTranspose(KSP ksp,Vec x,Vec
 PETSC_EXTERN PetscLogEvent KSP_GMRESOrthogonalization;
 PETSC_EXTERN PetscLogEvent KSP_SetUp;
 PETSC_EXTERN PetscLogEvent KSP_Solve;
+PETSC_EXTERN PetscLogEvent KSP_MatSolve;
 PETSC_EXTERN PetscLogEvent KSP_Solve_FS_0;
 PETSC_EXTERN PetscLogEvent KSP_Solve_FS_1;
 PETSC_EXTERN PetscLogEvent KSP_Solve_FS_2;
@@ -332,6 +332,22 @@ struct _MatStash {
   MPI_Datatype   blocktype;
   size_t         blocktype_size;
   InsertMode     *insertmode;   /* Pointer to check mat->insertmode and set upon message arrival in case no local values have been set. */
+
+  /* The following variables are used for persistent communication, -matstash_persistent */
+  PetscBool      pers_setup;       /* The communication of a previous assembly has been recorded */
+  PetscBool      pers_record;      /* The current assembly is being recorded */
+  PetscBool      pers_replay;      /* The current assembly replays the recorded communication */
+  InsertMode     pers_insertmode;  /* InsertMode of the recorded local entries */
+  InsertMode     pers_recvmode;    /* InsertMode of the recorded received entries */
+  PetscInt       pers_n;           /* Number of stashed entries in the recorded assembly */
+  PetscInt       *pers_idx,*pers_idy; /* Recorded stashed rows and columns, in the order of insertion */
+  PetscInt       *pers_map;        /* Block of the send buffer each stashed entry goes to */
+  PetscInt       pers_nblocks;     /* Number of blocks in the send buffer */
+  PetscScalar    *pers_sendvals,*pers_recvvals;
+  PetscInt       *pers_recvrow,*pers_recvcol,*pers_recvoffset;
+  PetscMPIInt    pers_nsend,pers_nrecv,pers_tag;
+  PetscMPIInt    *pers_some_indices;
+  MPI_Request    *pers_sendreqs,*pers_recvreqs;
 };
 
 PETSC_INTERN PetscErrorCode MatStashCreate_Private(MPI_Comm,PetscInt,MatStash*);
@@ -1711,10 +1727,13 @@ PETSC_EXTERN PetscLogEvent MATMFFD_Mult;
 PETSC_EXTERN PetscLogEvent MAT_GetMultiProcBlock;
 PETSC_EXTERN PetscLogEvent MAT_CUSPARSECopyToGPU;
 PETSC_EXTERN PetscLogEvent MAT_SetValuesBatch;
+PETSC_EXTERN PetscLogEvent MAT_PreallCOO;
+PETSC_EXTERN PetscLogEvent MAT_SetValuesCOO;
 PETSC_EXTERN PetscLogEvent MAT_ViennaCLCopyToGPU;
 PETSC_EXTERN PetscLogEvent MAT_Merge;
 PETSC_EXTERN PetscLogEvent MAT_Residual;
 PETSC_EXTERN PetscLogEvent MAT_SetRandom;
+PETSC_EXTERN PetscLogEvent MAT_MultThreadImbalance;
 PETSC_EXTERN PetscLogEvent MATCOLORING_Apply;
 PETSC_EXTERN PetscLogEvent MATCOLORING_Comm;
 PETSC_EXTERN PetscLogEvent MATCOLORING_Local;
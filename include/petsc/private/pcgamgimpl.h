@@ -25,11 +25,13 @@ typedef struct gamg_TAG {
   PetscBool reuse_prol;
   PetscBool use_aggs_in_asm;
   PetscBool use_parallel_coarse_grid_solver;
+  PetscBool use_sa_esteig;
   PetscInt  min_eq_proc;
   PetscInt  coarse_eq_limit;
   PetscReal threshold_scale;
   PetscInt  current_level; /* stash construction state */
   PetscReal threshold[PETSC_GAMG_MAXLEVELS]; /* common quatity to many AMG methods so keep it up here */
+  PetscReal emin[PETSC_GAMG_MAXLEVELS],emax[PETSC_GAMG_MAXLEVELS]; /* estimates of the extreme eigenvalues of D^{-1}A of each level, 0 if not computed */
 
   /* these 4 are all related to the method data and should be in the subctx */
   PetscInt  data_sz;      /* nloc*data_rows*data_cols */
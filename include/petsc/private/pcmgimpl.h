@@ -27,6 +27,9 @@ typedef struct {
   Mat           restrct;                       /* restrict is a reserved word in C99 and on Cray */
   Mat           inject;                        /* Used for moving state if provided. */
   Vec           rscale;                        /* scaling of restriction matrix */
+  PetscReal     emin_DinvA,emax_DinvA;         /* estimates of the extreme eigenvalues of D^{-1}A for the smoothers, 0 if none */
+  PetscObjectId DinvA_matid;                   /* id and state of the matrix A of these estimates */
+  PetscObjectState DinvA_matstate;
   PetscLogEvent eventsmoothsetup;              /* if logging times for each level */
   PetscLogEvent eventsmoothsolve;
   PetscLogEvent eventresidual;
@@ -807,8 +807,6 @@ typedef enum {PETSC_OFFLOAD_UNALLOCATED,PETSC_OFFLOAD_GPU,PETSC_OFFLOAD_CPU,PETS
 
 typedef enum {STATE_BEGIN, STATE_PENDING, STATE_END} SRState;
 
-typedef enum {PETSC_SR_REDUCE_SUM=0,PETSC_SR_REDUCE_MAX=1,PETSC_SR_REDUCE_MIN=2} PetscSRReductionType;
-
 typedef struct {
   MPI_Comm    comm;
   MPI_Request request;
@@ -93,6 +93,8 @@ struct _VecOps {
   PetscErrorCode (*restorelocalvector)(Vec,Vec);
   PetscErrorCode (*getlocalvectorread)(Vec,Vec);
   PetscErrorCode (*restorelocalvectorread)(Vec,Vec);
+  PetscErrorCode (*waxpydotnorm)(Vec,PetscScalar,Vec,Vec,Vec,PetscScalar*,PetscReal*);
+  PetscErrorCode (*aypxaxpy)(Vec,PetscScalar,Vec,PetscScalar,Vec);
 };
 
 /*
@@ -174,6 +176,8 @@ PETSC_EXTERN PetscLogEvent VEC_Swap;
 PETSC_EXTERN PetscLogEvent VEC_AssemblyBegin;
 PETSC_EXTERN PetscLogEvent VEC_DotNorm2;
 PETSC_EXTERN PetscLogEvent VEC_AXPBYPCZ;
+PETSC_EXTERN PetscLogEvent VEC_WAXPYDotNorm;
+PETSC_EXTERN PetscLogEvent VEC_AYPXAXPY;
 PETSC_EXTERN PetscLogEvent VEC_Ops;
 PETSC_EXTERN PetscLogEvent VEC_ViennaCLCopyToGPU;
 PETSC_EXTERN PetscLogEvent VEC_ViennaCLCopyFromGPU;
@@ -277,6 +281,7 @@ PETSC_INTERN PetscErrorCode VecStrideScatter_Default(Vec,PetscInt,Vec,InsertMode
 PETSC_INTERN PetscErrorCode VecReciprocal_Default(Vec);
 PETSC_INTERN PetscErrorCode VecStrideSubSetGather_Default(Vec,PetscInt,const PetscInt[],const PetscInt[],Vec,InsertMode);
 PETSC_INTERN PetscErrorCode VecStrideSubSetScatter_Default(Vec,PetscInt,const PetscInt[],const PetscInt[],Vec,InsertMode);
+PETSC_INTERN PetscErrorCode VecMDotSeqInitialize_Private(void);
 
 #if defined(PETSC_HAVE_MATLAB_ENGINE)
 PETSC_EXTERN PetscErrorCode VecMatlabEnginePut_Default(PetscObject,void*);
@@ -105,7 +105,7 @@ typedef enum {
 
 .seealso:
 E*/
-typedef enum { PC_JACOBI_DIAGONAL,PC_JACOBI_ROWMAX,PC_JACOBI_ROWSUM} PCJacobiType;
+typedef enum { PC_JACOBI_DIAGONAL,PC_JACOBI_ROWMAX,PC_JACOBI_ROWSUM,PC_JACOBI_ROWL1} PCJacobiType;
 
 /*E
     PCASMType - Type of additive Schwarz method to use
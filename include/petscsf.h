@@ -21,12 +21,21 @@ $     PETSCSFBASIC which uses MPI 1 message passing to perform the communication
 $     PETSCSFWINDOW which uses MPI 2 one-sided operations to perform the communication, this may be more efficient,
 $                   but may not be available for all MPI distributions. In particular OpenMPI has bugs in its one-sided
 $                   operations that prevent its use.
+$     PETSCSFNEIGHBOR which uses MPI 3 neighborhood collectives, exchanging the data with all the neighbors of a process
+$                     in one MPI_Ineighbor_alltoallv(); it is available when MPI provides them.
+$     PETSCSFSHARED which reads the data of the other processes of the same node directly from MPI-3 shared memory
+$                   and uses MPI 1 message passing only with the processes of other nodes.
+$     PETSCSFTWOLEVEL which aggregates the messages between nodes on one process of each node, so that the number of
+$                     messages depends on the number of neighboring nodes instead of neighboring processes.
 
 .seealso: PetscSFSetType(), PetscSF
 J*/
 typedef const char *PetscSFType;
-#define PETSCSFBASIC  "basic"
-#define PETSCSFWINDOW "window"
+#define PETSCSFBASIC    "basic"
+#define PETSCSFWINDOW   "window"
+#define PETSCSFNEIGHBOR "neighbor"
+#define PETSCSFSHARED   "shared"
+#define PETSCSFTWOLEVEL "twolevel"
 
 /*E
     PetscSFWindowSyncType - Type of synchronization for PETSCSFWINDOW
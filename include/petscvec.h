@@ -255,6 +255,8 @@ PETSC_EXTERN PetscErrorCode VecMAXPY(Vec,PetscInt,const PetscScalar[],Vec[]);
 PETSC_EXTERN PetscErrorCode VecAYPX(Vec,PetscScalar,Vec);
 PETSC_EXTERN PetscErrorCode VecWAXPY(Vec,PetscScalar,Vec,Vec);
 PETSC_EXTERN PetscErrorCode VecAXPBYPCZ(Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec);
+PETSC_EXTERN PetscErrorCode VecWAXPYDotNorm(Vec,PetscScalar,Vec,Vec,Vec,PetscScalar*,PetscReal*);
+PETSC_EXTERN PetscErrorCode VecAYPXAXPY(Vec,PetscScalar,Vec,PetscScalar,Vec);
 PETSC_EXTERN PetscErrorCode VecPointwiseMax(Vec,Vec,Vec);
 PETSC_EXTERN PetscErrorCode VecPointwiseMaxAbs(Vec,Vec,Vec);
 PETSC_EXTERN PetscErrorCode VecPointwiseMin(Vec,Vec,Vec);
@@ -433,6 +435,22 @@ PETSC_EXTERN PetscErrorCode VecMDotEnd(Vec,PetscInt,const Vec[],PetscScalar[]);
 PETSC_EXTERN PetscErrorCode VecMTDotBegin(Vec,PetscInt,const Vec[],PetscScalar[]);
 PETSC_EXTERN PetscErrorCode VecMTDotEnd(Vec,PetscInt,const Vec[],PetscScalar[]);
 PETSC_EXTERN PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm);
+PETSC_EXTERN PetscErrorCode PetscCommSplitReductionTest(MPI_Comm,PetscBool*);
+
+/*E
+    PetscSRReductionType - the reduction applied to values queued with PetscCommSplitReductionValuesBegin()
+
+    Level: advanced
+
+    Notes:
+    Additional types for user defined reductions are obtained with PetscSplitReductionRegisterOp()
+
+.seealso: PetscCommSplitReductionValuesBegin(), PetscCommSplitReductionValuesEnd(), PetscSplitReductionRegisterOp()
+E*/
+typedef enum {PETSC_SR_REDUCE_SUM=0,PETSC_SR_REDUCE_MAX=1,PETSC_SR_REDUCE_MIN=2} PetscSRReductionType;
+PETSC_EXTERN PetscErrorCode PetscSplitReductionRegisterOp(PetscScalar (*)(PetscScalar,PetscScalar),PetscSRReductionType*);
+PETSC_EXTERN PetscErrorCode PetscCommSplitReductionValuesBegin(MPI_Comm,PetscSRReductionType,PetscInt,const PetscScalar[]);
+PETSC_EXTERN PetscErrorCode PetscCommSplitReductionValuesEnd(MPI_Comm,PetscSRReductionType,PetscInt,PetscScalar[]);
 
 
 typedef enum {VEC_IGNORE_OFF_PROC_ENTRIES,VEC_IGNORE_NEGATIVE_INDICES,VEC_SUBSET_OFF_PROC_ENTRIES} VecOption;
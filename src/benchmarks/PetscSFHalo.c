@@ -0,0 +1,92 @@
+#include <petscsf.h>
+#include <petsctime.h>
+
+/*
+   Times PetscSFSetUp() and the halo exchange of a 3D domain decomposition: the processes form a 3D grid, each one owning
+   a box of n^3 points, and its leaves are the layer of width w of the boxes of its up to 26 neighbors. Compare
+   -sf_type basic with -sf_type twolevel (and -sf_twolevel_node_size) while increasing the number of processes; the
+   messages sent by each process are counted by -log_view.
+*/
+int main(int argc,char **argv)
+{
+  PetscSF        sf;
+  PetscSFNode    *iremote;
+  PetscScalar    *rootdata,*leafdata;
+  PetscLogDouble t0,t1,t2,t3,t[3],tmax[3];
+  PetscErrorCode ierr;
+  PetscInt       n = 16,w = 1,its = 100,nleaves,nroots,lo[3],hi[3],i,j,k,l;
+  PetscMPIInt    rank,size,dims[3] = {0,0,0},c[3],nc[3],d[3],r;
+
+  ierr = PetscInitialize(&argc,&argv,0,0);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-w",&w,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+  if (w > n) SETERRQ2(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"Halo width %D larger than box size %D",w,n);
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = MPI_Dims_create(size,3,dims);CHKERRQ(ierr);
+  c[0] = rank%dims[0];
+  c[1] = (rank/dims[0])%dims[1];
+  c[2] = rank/(dims[0]*dims[1]);
+
+  nroots = n*n*n;
+  ierr = PetscMalloc1(26*n*n*n,&iremote);CHKERRQ(ierr);
+  nleaves = 0;
+  ierr = PetscTime(&t0);CHKERRQ(ierr);
+  for (d[2]=-1; d[2]<=1; d[2]++) {
+    for (d[1]=-1; d[1]<=1; d[1]++) {
+      for (d[0]=-1; d[0]<=1; d[0]++) {
+        if (!d[0] && !d[1] && !d[2]) continue;
+        for (l=0; l<3; l++) {
+          nc[l] = c[l]+d[l];
+          lo[l] = d[l] < 0 ? n-w : 0;
+          hi[l] = d[l] > 0 ? w : n;
+        }
+        if (nc[0] < 0 || nc[0] >= dims[0] || nc[1] < 0 || nc[1] >= dims[1] || nc[2] < 0 || nc[2] >= dims[2]) continue;
+        r = nc[0]+dims[0]*(nc[1]+dims[1]*nc[2]);
+        for (k=lo[2]; k<hi[2]; k++) {
+          for (j=lo[1]; j<hi[1]; j++) {
+            for (i=lo[0]; i<hi[0]; i++, nleaves++) {
+              iremote[nleaves].rank  = r;
+              iremote[nleaves].index = i+n*(j+n*k);
+            }
+          }
+        }
+      }
+    }
+  }
+  ierr = PetscSFCreate(PETSC_COMM_WORLD,&sf);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(sf,nroots,nleaves,NULL,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  t[0] = t1-t0;
+
+  ierr = PetscMalloc2(nroots,&rootdata,nleaves,&leafdata);CHKERRQ(ierr);
+  for (i=0; i<nroots; i++) rootdata[i] = rank;
+  ierr = PetscSFBcastBegin(sf,MPIU_SCALAR,rootdata,leafdata);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sf,MPIU_SCALAR,rootdata,leafdata);CHKERRQ(ierr);
+  ierr = MPI_Barrier(PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscTime(&t1);CHKERRQ(ierr);
+  for (l=0; l<its; l++) {
+    ierr = PetscSFBcastBegin(sf,MPIU_SCALAR,rootdata,leafdata);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,MPIU_SCALAR,rootdata,leafdata);CHKERRQ(ierr);
+  }
+  ierr = PetscTime(&t2);CHKERRQ(ierr);
+  for (l=0; l<its; l++) {
+    ierr = PetscSFReduceBegin(sf,MPIU_SCALAR,leafdata,rootdata,MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(sf,MPIU_SCALAR,leafdata,rootdata,MPIU_SUM);CHKERRQ(ierr);
+  }
+  ierr = PetscTime(&t3);CHKERRQ(ierr);
+  t[1] = (t2-t1)/its;
+  t[2] = (t3-t2)/its;
+  ierr = MPI_Reduce(t,tmax,3,MPIU_PETSCLOGDOUBLE,MPI_MAX,0,PETSC_COMM_WORLD);CHKERRQ(ierr);
+
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%d processes in a %dx%dx%d grid, boxes of %D^3 points, halo width %D\n",size,dims[0],dims[1],dims[2],n,w);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Maximum times: setup %10.3e  broadcast %10.3e  reduction %10.3e\n",tmax[0],tmax[1],tmax[2]);CHKERRQ(ierr);
+
+  ierr = PetscFree2(rootdata,leafdata);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
@@ -0,0 +1,58 @@
+
+#include <petscvec.h>
+#include <petsctime.h>
+
+/*
+   Times VecMDot() and VecMAXPY() as used by the orthogonalization of GMRES for several restart lengths. Run it without
+   options for the default unrolled kernels and with -vec_mdot_kernel avx512, which falls back to the best kernel the CPU
+   supports, to compare them with the blocked ones; the vectors come from
+   one VecDuplicateVecs() so by default they are computed with BLAS gemv, -vec_mdot_use_gemv 0 -vec_maxpy_use_gemv 0
+   gives the kernels.
+*/
+int main(int argc,char **argv)
+{
+  Vec            x,*y;
+  PetscScalar    *z;
+  PetscLogDouble t1,t2,t3;
+  PetscErrorCode ierr;
+  PetscInt       n = 100000,nv[16] = {10,20,50,100,200},nnv = 16,nvmax = 0,i,j,its = 10;
+  PetscBool      flg;
+
+  ierr = PetscInitialize(&argc,&argv,0,0);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-its",&its,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetIntArray(NULL,NULL,"-nv",nv,&nnv,&flg);CHKERRQ(ierr);
+  if (!flg) nnv = 5;
+  for (i=0; i<nnv; i++) nvmax = PetscMax(nvmax,nv[i]);
+
+  ierr = VecCreate(PETSC_COMM_SELF,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,n);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,nvmax,&y);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nvmax,&z);CHKERRQ(ierr);
+  ierr = VecSet(x,1.0);CHKERRQ(ierr);
+  for (j=0; j<nvmax; j++) {ierr = VecSet(y[j],1.0/(j+1));CHKERRQ(ierr);}
+
+  fprintf(stdout,"Vector length %d, times per call\n",(int)n);
+  fprintf(stdout," restart   VecMDot             VecMAXPY\n");
+  for (i=0; i<nnv; i++) {
+    for (j=0; j<nv[i]; j++) z[j] = 1.e-3;
+    ierr = VecMDot(x,nv[i],y,z);CHKERRQ(ierr);
+    ierr = PetscTime(&t1);CHKERRQ(ierr);
+    for (j=0; j<its; j++) {ierr = VecMDot(x,nv[i],y,z);CHKERRQ(ierr);}
+    ierr = PetscTime(&t2);CHKERRQ(ierr);
+    for (j=0; j<nv[i]; j++) z[j] = 1.e-3;
+    for (j=0; j<its; j++) {ierr = VecMAXPY(x,nv[i],z,y);CHKERRQ(ierr);}
+    ierr = PetscTime(&t3);CHKERRQ(ierr);
+    /* VecMDot() reads nv+1 vectors, VecMAXPY() reads nv+1 and writes one */
+    fprintf(stdout," %5d   %10.3e %5.1f GB/s  %10.3e %5.1f GB/s\n",(int)nv[i],
+            (t2-t1)/its,1.e-9*its*(nv[i]+1)*n*sizeof(PetscScalar)/(t2-t1),
+            (t3-t2)/its,1.e-9*its*(nv[i]+2)*n*sizeof(PetscScalar)/(t3-t2));
+  }
+
+  ierr = PetscFree(z);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(nvmax,&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
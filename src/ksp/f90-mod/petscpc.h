@@ -23,9 +23,11 @@
       PetscEnum PC_JACOBI_DIAGONAL
       PetscEnum PC_JACOBI_ROWMAX
       PetscEnum PC_JACOBI_ROWSUM
+      PetscEnum PC_JACOBI_ROWL1
       parameter (PC_JACOBI_DIAGONAL=0)
       parameter (PC_JACOBI_ROWMAX=1)
       parameter (PC_JACOBI_ROWSUM=2)
+      parameter (PC_JACOBI_ROWL1=3)
 !
 ! PCASMType
 !
@@ -0,0 +1,133 @@
+static char help[] = "Solves a linear system with multiple right-hand sides with KSPMatSolve().\n\
+Input parameters include:\n\
+  -m <mesh_x>     : number of mesh points in x-direction\n\
+  -n <mesh_y>     : number of mesh points in y-direction\n\
+  -nrhs <nrhs>    : number of right-hand sides\n\
+  -convection <c> : coefficient of a first order upwind convection term, making the matrix nonsymmetric\n\n";
+
+#include <petscksp.h>
+
+int main(int argc,char **args)
+{
+  KSP            ksp;
+  Mat            A,B,X,Xexact;
+  Vec            x,b,r;
+  PetscScalar    *xexact,*barray,v;
+  PetscReal      convection = 0.0,rnorm,bnorm,maxres = 0.0,rtol;
+  PetscInt       i,j,Ii,J,k,m = 8,n = 7,nrhs = 4,its,Istart,Iend,nlocal;
+  KSPConvergedReason reason;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nrhs",&nrhs,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-convection",&convection,NULL);CHKERRQ(ierr);
+
+  /* five point Laplacian, with an optional upwind convection term in the x-direction */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m*n,m*n);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,5,NULL,5,NULL);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5,NULL);CHKERRQ(ierr);
+  ierr = MatSetUp(A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&Istart,&Iend);CHKERRQ(ierr);
+  for (Ii=Istart; Ii<Iend; Ii++) {
+    v = -1.0; i = Ii/n; j = Ii - i*n;
+    if (i>0)   {J = Ii - n; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + n; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);}
+    if (j<n-1) {J = Ii + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);}
+    v = -1.0 - convection;
+    if (j>0)   {J = Ii - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);}
+    v = 4.0 + convection; ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  /* right-hand sides B = A Xexact */
+  nlocal = Iend - Istart;
+  ierr = MatCreateDense(PETSC_COMM_WORLD,nlocal,PETSC_DECIDE,m*n,nrhs,NULL,&Xexact);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(Xexact,&xexact);CHKERRQ(ierr);
+  for (k=0; k<nrhs; k++) {
+    for (Ii=Istart; Ii<Iend; Ii++) xexact[Ii-Istart+k*nlocal] = 1.0 + PetscSinReal(0.1*(Ii+1)*(k+1));
+  }
+  ierr = MatDenseRestoreArray(Xexact,&xexact);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(Xexact,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(Xexact,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatDuplicate(Xexact,MAT_DO_NOT_COPY_VALUES,&B);CHKERRQ(ierr);
+  ierr = MatDuplicate(Xexact,MAT_DO_NOT_COPY_VALUES,&X);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(B,&barray);CHKERRQ(ierr);
+  for (k=0; k<nrhs; k++) {
+    ierr = MatGetColumnVector(Xexact,x,k);CHKERRQ(ierr);
+    ierr = VecPlaceArray(b,barray+k*nlocal);CHKERRQ(ierr);
+    ierr = MatMult(A,x,b);CHKERRQ(ierr);
+    ierr = VecResetArray(b);CHKERRQ(ierr);
+  }
+  ierr = MatDenseRestoreArray(B,&barray);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-6,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  ierr = KSPMatSolve(ksp,B,X);CHKERRQ(ierr);
+  ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+  ierr = KSPGetConvergedReason(ksp,&reason);CHKERRQ(ierr);
+  ierr = KSPGetTolerances(ksp,&rtol,NULL,NULL,NULL);CHKERRQ(ierr);
+
+  /* check the true residual of each column */
+  for (k=0; k<nrhs; k++) {
+    ierr = MatGetColumnVector(X,x,k);CHKERRQ(ierr);
+    ierr = MatGetColumnVector(B,b,k);CHKERRQ(ierr);
+    ierr = MatMult(A,x,r);CHKERRQ(ierr);
+    ierr = VecAXPY(r,-1.0,b);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+    ierr = VecNorm(b,NORM_2,&bnorm);CHKERRQ(ierr);
+    maxres = PetscMax(maxres,rnorm/bnorm);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%D right-hand sides, %D iterations, %s\n",nrhs,its,KSPConvergedReasons[reason]);CHKERRQ(ierr);
+  if (maxres > 1.e3*rtol) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Largest relative residual norm %g\n",(double)maxres);CHKERRQ(ierr);}
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  ierr = MatDestroy(&Xexact);CHKERRQ(ierr);
+  ierr = MatDestroy(&X);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: cg
+      nsize: 2
+      args: -ksp_type cg -pc_type jacobi -ksp_converged_reason
+
+   test:
+      suffix: cg_none
+      args: -ksp_type cg -pc_type none -nrhs 1
+
+   test:
+      suffix: gmres
+      nsize: 2
+      args: -convection 2 -ksp_type gmres -pc_type bjacobi -ksp_monitor_short -ksp_converged_reason
+
+   test:
+      suffix: gmres_right
+      args: -convection 2 -ksp_type gmres -ksp_gmres_restart 8 -ksp_pc_side right -pc_type ilu -ksp_converged_reason
+
+   test:
+      suffix: bcgs
+      nsize: 2
+      args: -convection 2 -ksp_type bcgs -pc_type bjacobi -ksp_converged_reason
+
+   test:
+      suffix: baij
+      args: -mat_type baij -ksp_type cg -pc_type none -nrhs 3
+
+TEST*/
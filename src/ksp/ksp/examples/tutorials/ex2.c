@@ -208,6 +208,26 @@ int main(int argc,char **args)
    build:
       requires: !complex !single
 
+   test:
+      suffix: cacg
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type cacg -m 9 -n 9 -ksp_cacg_s 3
+
+   test:
+      suffix: cacg_newton
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type cacg -m 9 -n 9 -ksp_cacg_s 3 -ksp_cacg_basis newton -ksp_view
+
+   test:
+      suffix: cagmres
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type cagmres -m 9 -n 9 -ksp_cagmres_s 3 -ksp_gmres_restart 9
+
+   test:
+      suffix: cagmres_chebyshev
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type cagmres -m 9 -n 9 -ksp_cagmres_s 3 -ksp_cagmres_basis chebyshev -ksp_pc_side right -ksp_view
+
    test:
       suffix: chebyest_1
       args: -m 80 -n 80 -ksp_pc_side right -pc_type ksp -ksp_ksp_type chebyshev -ksp_ksp_max_it 5 -ksp_ksp_chebyshev_esteig 0.9,0,0,1.1 -ksp_monitor_short
@@ -238,6 +258,15 @@ int main(int argc,char **args)
       args: -ksp_monitor_short -m 5 -n 5 -mat_view draw -ksp_gmres_cgs_refinement_type refine_always -nox
       output_file: output/ex2_2.out
 
+   test:
+      suffix: aijsingle
+      args: -mat_type aijsingle -pc_type ilu -ksp_monitor_short -m 9 -n 9
+
+   test:
+      suffix: aijsingle_2
+      nsize: 2
+      args: -mat_type aijsingle -pc_type jacobi -ksp_monitor_short -m 9 -n 9
+
    test:
       suffix: bjacobi
       nsize: 4
@@ -262,6 +291,16 @@ int main(int argc,char **args)
       nsize: 3
       args: -ksp_type fbcgsr -pc_type bjacobi
 
+   test:
+      suffix: fgmres_lowsync
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type fgmres -m 9 -n 9 -ksp_gmres_restart 7 -ksp_gmres_lowsyncgramschmidt
+
+   test:
+      suffix: gmres_lowsync
+      nsize: 2
+      args: -ksp_monitor_short -m 9 -n 9 -ksp_gmres_restart 7 -ksp_gmres_lowsyncgramschmidt -ksp_pc_side right -ksp_view
+
    test:
       suffix: groppcg
       args: -ksp_monitor_short -ksp_type groppcg -m 9 -n 9
@@ -306,6 +345,11 @@ int main(int argc,char **args)
       suffix: sell_mumps
       args: -ksp_type preonly -m 9 -n 12 -mat_type sell -pc_type lu -pc_factor_mat_solver_type mumps -pc_factor_mat_ordering_type natural
 
+   test:
+      suffix: sor_multicolor
+      nsize: 2
+      args: -m 20 -n 20 -ksp_type cg -pc_type sor -mat_sor_multicolor -mat_aij_threads 2 -ksp_converged_reason
+
    test:
       suffix: telescope
       nsize: 4
@@ -238,4 +238,16 @@ int main(int argc,char **args)
       requires: triangle
       output_file: output/ex54_0.out
 
+   test:
+      suffix: sa_esteig
+      nsize: 4
+      args: -ne 49 -alpha 1.e-3 -ksp_type cg -pc_type gamg -pc_gamg_type agg -pc_gamg_agg_nsmooths 1 -ksp_converged_reason -gamg_est_ksp_type cg -mg_levels_pc_type jacobi -pc_gamg_use_sa_esteig -ksp_view
+      filter: grep -e "Linear solve" -e "eigenvalue"
+
+   test:
+      suffix: l1
+      nsize: 4
+      args: -ne 49 -alpha 1.e-3 -ksp_type cg -pc_type gamg -pc_gamg_type agg -pc_gamg_agg_nsmooths 1 -ksp_converged_reason -mg_levels_pc_type jacobi -mg_levels_pc_jacobi_type rowl1 -ksp_view
+      filter: grep -e "Linear solve" -e "eigenvalue"
+
 TEST*/
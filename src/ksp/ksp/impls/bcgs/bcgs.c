@@ -28,6 +28,7 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
   PetscScalar    rho,rhoold,alpha,beta,omega,omegaold,d1;
   Vec            X,B,V,P,R,RP,T,S;
   PetscReal      dp    = 0.0,d2;
+  PetscBool      haverho = PETSC_FALSE;
   KSP_BCGS       *bcgs = (KSP_BCGS*)ksp->data;
 
   PetscFunctionBegin;
@@ -82,7 +83,10 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
 
   i=0;
   do {
-    ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);       /*   rho <- (r,rp)      */
+    if (!haverho) {
+      ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);     /*   rho <- (r,rp)      */
+    }
+    haverho = PETSC_FALSE;
     beta = (rho/rhoold) * (alpha/omegaold);
     ierr = VecAXPBYPCZ(P,1.0,-omegaold*beta,beta,R,V);CHKERRQ(ierr);  /* p <- r - omega * beta* v + beta * p */
     ierr = KSP_PCApplyBAorAB(ksp,P,V,T);CHKERRQ(ierr);  /*   v <- K p           */
@@ -119,13 +123,16 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     }
     omega = d1 / d2;                               /*   w <- (t's) / (t't) */
     ierr  = VecAXPBYPCZ(X,alpha,omega,1.0,P,S);CHKERRQ(ierr); /* x <- alpha * p + omega * s + x */
-    ierr  = VecWAXPY(R,-omega,T,S);CHKERRQ(ierr);     /*   r <- s - w t       */
+    rhoold = rho;
     if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
+      /* r <- s - w t, the next rho <- (r,rp) and the norm of r in a single pass */
+      ierr    = VecWAXPYDotNorm(R,-omega,T,S,RP,&rho,&dp);CHKERRQ(ierr);
+      haverho = PETSC_TRUE;
       KSPCheckNorm(ksp,dp);
+    } else {
+      ierr = VecWAXPY(R,-omega,T,S);CHKERRQ(ierr);    /*   r <- s - w t       */
     }
 
-    rhoold   = rho;
     omegaold = omega;
 
     ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
@@ -136,7 +143,7 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     ierr = KSPMonitor(ksp,i+1,dp);CHKERRQ(ierr);
     ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
     if (ksp->reason) break;
-    if (rho == 0.0) {
+    if (rhoold == 0.0) {
       ksp->reason = KSP_DIVERGED_BREAKDOWN;
       break;
     }
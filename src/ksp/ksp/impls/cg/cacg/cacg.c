@@ -0,0 +1,407 @@
+/*
+    This file implements the s-step (communication-avoiding) conjugate gradient method. Each outer step builds bases of
+    the Krylov spaces of degree s generated by the search direction and the preconditioned residual, computes their Gram
+    matrix in a single global reduction, and runs s iterations of CG on the coordinates in these bases.
+*/
+#include <../src/ksp/ksp/impls/cg/cgimpl.h>       /*I "petscksp.h" I*/
+
+extern PetscErrorCode KSPComputeExtremeSingularValues_CG(KSP,PetscReal*,PetscReal*);
+extern PetscErrorCode KSPComputeEigenvalues_CG(KSP,PetscInt,PetscReal*,PetscReal*,PetscInt*);
+
+typedef struct {
+  KSP_CG            cg;                /* first, so that KSPComputeEigenvalues_CG() finds the Lanczos matrix */
+  PetscInt          s;                 /* number of iterations per global reduction */
+  KSPSStepBasisType basis;
+  PetscInt          nlanczos;          /* length of the Lanczos arrays of cg */
+  Vec               *Vz,*Vr;           /* [p,..,rho_s(BA)p,z,..,rho_{s-1}(BA)z] and its image by B^{-1}, starting from q = B^{-1}p and r */
+  PetscScalar       *G,*Gn;            /* Vz^H Vr, and Vz^H Vz or Vr^H Vr for the preconditioned or unpreconditioned norms */
+  PetscScalar       *a,*c,*xc,*w;      /* coordinates of p, of z and r, of the update of x, and of BAp */
+  PetscScalar       *gamma,*theta,*mu; /* recurrence of the basis polynomials rho_k */
+  PetscReal         *re,*im;           /* eigenvalue estimates of BA */
+} KSP_CACG;
+
+static PetscErrorCode KSPSetUp_CACG(KSP ksp)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscInt       s = cacg->s,m = 2*s+1,maxit = ksp->max_it;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetWorkVecs(ksp,4);CHKERRQ(ierr);
+  ierr = KSPCreateVecs(ksp,m,&cacg->Vz,m,&cacg->Vr);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,m,cacg->Vz);CHKERRQ(ierr);
+  ierr = PetscLogObjectParents(ksp,m,cacg->Vr);CHKERRQ(ierr);
+  ierr = PetscMalloc6(m*m,&cacg->G,m*m,&cacg->Gn,m,&cacg->a,m,&cacg->c,m,&cacg->xc,m,&cacg->w);CHKERRQ(ierr);
+  ierr = PetscMalloc5(s,&cacg->gamma,s,&cacg->theta,s,&cacg->mu,s,&cacg->re,s,&cacg->im);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(2*m*m+4*m+3*s)*sizeof(PetscScalar)+2*s*sizeof(PetscReal));CHKERRQ(ierr);
+
+  /* The Lanczos matrix is always stored since it provides the eigenvalue estimates of the Newton and Chebyshev bases */
+  cacg->nlanczos = maxit+1;
+  ierr = PetscMalloc4(maxit+1,&cacg->cg.e,maxit+1,&cacg->cg.d,maxit+1,&cacg->cg.ee,maxit+1,&cacg->cg.dd);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,2*(maxit+1)*(sizeof(PetscScalar)+sizeof(PetscReal)));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCACGExtendBasis - Computes V[k+1] = rho_{k+1}(BA) v from V[k] and V[k-1], for both bases
+*/
+static PetscErrorCode KSPCACGExtendBasis(KSP ksp,Mat Amat,Vec *Vz,Vec *Vr,PetscInt k)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscScalar    g = cacg->gamma[k],t = cacg->theta[k],u = cacg->mu[k];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSP_MatMult(ksp,Amat,Vz[k],Vr[k+1]);CHKERRQ(ierr);                          /* A v_k */
+  if (k && u != 0.0) {
+    ierr = VecAXPBYPCZ(Vr[k+1],-t/g,-u/g,1.0/g,Vr[k],Vr[k-1]);CHKERRQ(ierr);
+  } else if (t != 0.0 || g != 1.0) {
+    ierr = VecAXPBY(Vr[k+1],-t/g,1.0/g,Vr[k]);CHKERRQ(ierr);
+  }
+  ierr = KSP_PCApply(ksp,Vr[k+1],Vz[k+1]);CHKERRQ(ierr);                             /* v_{k+1} = B u_{k+1} */
+  PetscFunctionReturn(0);
+}
+
+/* Returns x^H G y for the m x m matrix G */
+PETSC_STATIC_INLINE PetscScalar KSPCACGForm(PetscInt m,const PetscScalar *G,const PetscScalar *x,const PetscScalar *y)
+{
+  PetscScalar sum = 0.0,t;
+  PetscInt    i,j;
+
+  for (j=0; j<m; j++) {
+    if (y[j] == 0.0) continue;
+    for (i=0,t=0.0; i<m; i++) t += PetscConj(x[i])*G[i+j*m];
+    sum += t*y[j];
+  }
+  return sum;
+}
+
+/*
+     KSPSolve_CACG - Each outer step performs s iterations of preconditioned CG with one global reduction
+
+     With the bases Vz = [p,..,rho_s(BA)p,z,..,rho_{s-1}(BA)z] and Vr = B^{-1}Vz, BA Vz = Vz T where T is block
+   tridiagonal, and the inner products of CG are quadratic forms of G = Vz^H Vr: z^H r = c^H G c and p^H A p = a^H G T a.
+*/
+static PetscErrorCode KSPSolve_CACG(KSP ksp)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       s = cacg->s,m = 2*s+1,i,j,k,neig;
+  PetscScalar    *G = cacg->G,*Gn = cacg->Gn,*a = cacg->a,*c = cacg->c,*xc = cacg->xc,*w = cacg->w,*e = cacg->cg.e,*d = cacg->cg.d;
+  PetscScalar    rz = 0.0,rzold = 1.0,pAp = 0.0,pApold = 0.0,alpha = 1.0,alphaold = 1.0,beta = 0.0,nrm;
+  PetscReal      dp = 0.0;
+  Vec            X,B,R,Z,*Vz = cacg->Vz,*Vr = cacg->Vr,tmp;
+  Mat            Amat,Pmat;
+  PetscBool      diagonalscale;
+  MPI_Comm       comm;
+
+  PetscFunctionBegin;
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+  if (ksp->max_it+1 > cacg->nlanczos) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Can not increase maxit after KSPSetUp()");
+
+  ierr = PetscObjectGetComm((PetscObject)ksp,&comm);CHKERRQ(ierr);
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  X    = ksp->vec_sol;
+  B    = ksp->vec_rhs;
+  R    = Vr[s+1];
+  Z    = Vz[s+1];
+
+  /* The first outer step uses the monomial basis, the next ones the eigenvalue estimates from its Lanczos matrix */
+  ierr = KSPSStepBasisCoefficients_Private(KSP_SSTEP_BASIS_MONOMIAL,0,NULL,NULL,s,cacg->gamma,cacg->theta,cacg->mu);CHKERRQ(ierr);
+
+  ksp->its     = 0;
+  cacg->cg.ned = 0;
+  if (!ksp->guess_zero) {
+    ierr = KSP_MatMult(ksp,Amat,X,R);CHKERRQ(ierr);            /*    r <- b - Ax                       */
+    ierr = VecAYPX(R,-1.0,B);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(B,R);CHKERRQ(ierr);                         /*    r <- b (x is 0)                   */
+  }
+  ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                   /*    z <- Br                           */
+  ierr = VecDotBegin(Z,R,&rz);CHKERRQ(ierr);                   /*    rz <- r'*z, with the norm         */
+  if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+    ierr = VecNormBegin(Z,NORM_2,&dp);CHKERRQ(ierr);
+  } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+    ierr = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);
+  }
+  ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+  ierr = VecDotEnd(Z,R,&rz);CHKERRQ(ierr);
+  KSPCheckDot(ksp,rz);
+  if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+    ierr = VecNormEnd(Z,NORM_2,&dp);CHKERRQ(ierr);
+  } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+    ierr = VecNormEnd(R,NORM_2,&dp);CHKERRQ(ierr);
+  } else if (ksp->normtype == KSP_NORM_NATURAL) {
+    dp = PetscSqrtReal(PetscAbsScalar(rz));
+  }
+  KSPCheckNorm(ksp,dp);
+  ierr       = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+  ierr       = KSPMonitor(ksp,0,dp);CHKERRQ(ierr);
+  ksp->rnorm = dp;
+  ierr = (*ksp->converged)(ksp,0,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);     /* test for convergence */
+  if (ksp->reason) PetscFunctionReturn(0);
+
+  ierr = VecCopy(Z,Vz[0]);CHKERRQ(ierr);                       /*    p <- z, q <- r                    */
+  ierr = VecCopy(R,Vr[0]);CHKERRQ(ierr);
+  do {
+    /* Bases of degree s from p and s-1 from z */
+    for (k=0; k<s; k++) {ierr = KSPCACGExtendBasis(ksp,Amat,Vz,Vr,k);CHKERRQ(ierr);}
+    for (k=0; k<s-1; k++) {ierr = KSPCACGExtendBasis(ksp,Amat,Vz+s+1,Vr+s+1,k);CHKERRQ(ierr);}
+
+    /* Upper triangles of the Gram matrices in a single reduction */
+    for (j=0; j<m; j++) {
+      ierr = VecMDotBegin(Vr[j],j+1,Vz,G+j*m);CHKERRQ(ierr);
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+        ierr = VecMDotBegin(Vz[j],j+1,Vz,Gn+j*m);CHKERRQ(ierr);
+      } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+        ierr = VecMDotBegin(Vr[j],j+1,Vr,Gn+j*m);CHKERRQ(ierr);
+      }
+    }
+    ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+    for (j=0; j<m; j++) {
+      ierr = VecMDotEnd(Vr[j],j+1,Vz,G+j*m);CHKERRQ(ierr);
+      if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+        ierr = VecMDotEnd(Vz[j],j+1,Vz,Gn+j*m);CHKERRQ(ierr);
+      } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+        ierr = VecMDotEnd(Vr[j],j+1,Vr,Gn+j*m);CHKERRQ(ierr);
+      }
+      for (i=0; i<j; i++) {
+        G[j+i*m]  = PetscConj(G[i+j*m]);
+        Gn[j+i*m] = PetscConj(Gn[i+j*m]);
+      }
+    }
+
+    ierr = PetscMemzero(a,m*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscMemzero(c,m*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscMemzero(xc,m*sizeof(PetscScalar));CHKERRQ(ierr);
+    a[0]   = 1.0;
+    c[s+1] = 1.0;
+    for (j=0; j<s; j++) {
+      if (rz == 0.0) {
+        ksp->reason = KSP_CONVERGED_ATOL;
+        ierr        = PetscInfo(ksp,"converged due to beta = 0\n");CHKERRQ(ierr);
+        break;
+#if !defined(PETSC_USE_COMPLEX)
+      } else if (ksp->its && rz*rzold < 0.0) {
+        if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite preconditioner");
+        ksp->reason = KSP_DIVERGED_INDEFINITE_PC;
+        ierr        = PetscInfo(ksp,"diverging due to indefinite preconditioner\n");CHKERRQ(ierr);
+        break;
+#endif
+      }
+
+      /* w <- T a, the coordinates of BAp in Vz and of Ap in Vr, using the recurrence of each block of the basis */
+      ierr = PetscMemzero(w,m*sizeof(PetscScalar));CHKERRQ(ierr);
+      for (k=0; k<m-1; k++) {
+        PetscInt l = k <= s ? k : k-s-1;
+
+        if (k == s || a[k] == 0.0) continue;
+        w[k+1] += cacg->gamma[l]*a[k];
+        w[k]   += cacg->theta[l]*a[k];
+        if (l) w[k-1] += cacg->mu[l]*a[k];
+      }
+      pAp = KSPCACGForm(m,G,a,w);                              /*     pAp <- p'Ap                      */
+      KSPCheckDot(ksp,pAp);
+      if ((pAp == 0.0) || (ksp->its && (PetscSign(PetscRealPart(pAp))*PetscSign(PetscRealPart(pApold)) < 0.0))) {
+        if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite matrix");
+        ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+        ierr        = PetscInfo(ksp,"diverging due to indefinite or negative definite matrix\n");CHKERRQ(ierr);
+        break;
+      }
+      alpha = rz/pAp;
+      i     = ksp->its;
+      if (i < cacg->nlanczos) {
+        if (!i) {
+          e[0] = 0.0;
+          d[0] = 1.0/alpha;
+        } else {
+          e[i] = PetscSqrtReal(PetscAbsScalar(beta))/alphaold;
+          d[i] = PetscSqrtReal(PetscAbsScalar(beta))*e[i] + 1.0/alpha;
+        }
+      }
+      for (k=0; k<m; k++) {
+        xc[k] += alpha*a[k];                                   /*     x <- x + alpha p                 */
+        c[k]  -= alpha*w[k];                                   /*     r <- r - alpha Ap, z <- Br       */
+      }
+      rzold = rz;
+      rz    = KSPCACGForm(m,G,c,c);                            /*     rz <- r'*z                       */
+      KSPCheckDot(ksp,rz);
+      switch (ksp->normtype) {
+      case KSP_NORM_PRECONDITIONED:
+      case KSP_NORM_UNPRECONDITIONED:
+        nrm = KSPCACGForm(m,Gn,c,c);
+        dp  = PetscSqrtReal(PetscAbsScalar(nrm));
+        break;
+      case KSP_NORM_NATURAL:
+        dp = PetscSqrtReal(PetscAbsScalar(rz));
+        break;
+      default:
+        dp = 0.0;
+      }
+      KSPCheckNorm(ksp,dp);
+      ksp->its++;
+      cacg->cg.ned = PetscMin(ksp->its,cacg->nlanczos);
+      ksp->rnorm   = dp;
+      ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+      ierr = KSPMonitor(ksp,ksp->its,dp);CHKERRQ(ierr);
+      ierr = (*ksp->converged)(ksp,ksp->its,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (ksp->reason) break;
+
+      beta = rz/rzold;
+      for (k=0; k<m; k++) a[k] = c[k] + beta*a[k];             /*     p <- z + beta p                  */
+      alphaold = alpha;
+      pApold   = pAp;
+      if (ksp->its >= ksp->max_it) {
+        ksp->reason = KSP_DIVERGED_ITS;
+        break;
+      }
+    }
+
+    /* Back from the coordinates to the vectors */
+    ierr = VecMAXPY(X,m,xc,Vz);CHKERRQ(ierr);
+    if (ksp->reason) break;
+    for (k=0; k<4; k++) {ierr = VecSet(ksp->work[k],0.0);CHKERRQ(ierr);}
+    ierr = VecMAXPY(ksp->work[0],m,a,Vz);CHKERRQ(ierr);
+    ierr = VecMAXPY(ksp->work[1],m,a,Vr);CHKERRQ(ierr);
+    ierr = VecMAXPY(ksp->work[2],m,c,Vz);CHKERRQ(ierr);
+    ierr = VecMAXPY(ksp->work[3],m,c,Vr);CHKERRQ(ierr);
+    tmp = Vz[0];   Vz[0]   = ksp->work[0]; ksp->work[0] = tmp;
+    tmp = Vr[0];   Vr[0]   = ksp->work[1]; ksp->work[1] = tmp;
+    tmp = Vz[s+1]; Vz[s+1] = ksp->work[2]; ksp->work[2] = tmp;
+    tmp = Vr[s+1]; Vr[s+1] = ksp->work[3]; ksp->work[3] = tmp;
+
+    if (ksp->its == s && cacg->basis != KSP_SSTEP_BASIS_MONOMIAL) {
+      ierr = KSPComputeEigenvalues_CG(ksp,s,cacg->re,cacg->im,&neig);CHKERRQ(ierr);
+      ierr = KSPSStepBasisCoefficients_Private(cacg->basis,neig,cacg->re,cacg->im,s,cacg->gamma,cacg->theta,cacg->mu);CHKERRQ(ierr);
+      if (neig) {ierr = PetscInfo4(ksp,"%s basis from %D eigenvalue estimates in [%g,%g]\n",KSPSStepBasisTypes[cacg->basis],neig,(double)cacg->re[0],(double)cacg->re[neig-1]);CHKERRQ(ierr);}
+    }
+  } while (!ksp->reason);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_CACG(KSP ksp)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscInt       m = 2*cacg->s+1;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDestroyVecs(m,&cacg->Vz);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(m,&cacg->Vr);CHKERRQ(ierr);
+  ierr = PetscFree6(cacg->G,cacg->Gn,cacg->a,cacg->c,cacg->xc,cacg->w);CHKERRQ(ierr);
+  ierr = PetscFree5(cacg->gamma,cacg->theta,cacg->mu,cacg->re,cacg->im);CHKERRQ(ierr);
+  ierr = PetscFree4(cacg->cg.e,cacg->cg.d,cacg->cg.ee,cacg->cg.dd);CHKERRQ(ierr);
+  cacg->nlanczos = 0;
+  cacg->cg.ned   = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_CACG(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_CACG(ksp);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_CACG(KSP ksp,PetscViewer viewer)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii,isstring;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  %D iterations per reduction, %s basis\n",cacg->s,KSPSStepBasisTypes[cacg->basis]);CHKERRQ(ierr);
+  } else if (isstring) {
+    ierr = PetscViewerStringSPrintf(viewer,"s %D %s basis",cacg->s,KSPSStepBasisTypes[cacg->basis]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_CACG(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscInt       s = cacg->s;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP CACG options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_cacg_s","Number of iterations per global reduction","",s,&s,NULL);CHKERRQ(ierr);
+  if (s < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of iterations per reduction %D must be positive",s);
+  if (s != cacg->s) {
+    if (ksp->setupstage) {
+      ierr = KSPReset_CACG(ksp);CHKERRQ(ierr);
+      ksp->setupstage = KSP_SETUP_NEW;
+    }
+    cacg->s = s;
+  }
+  ierr = PetscOptionsEnum("-ksp_cacg_basis","Polynomial basis of the Krylov spaces","",KSPSStepBasisTypes,(PetscEnum)cacg->basis,(PetscEnum*)&cacg->basis,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPCACG - The s-step, or communication-avoiding, preconditioned conjugate gradient method
+
+   Options Database Keys:
++   -ksp_cacg_s <4> - number of CG iterations computed with one global reduction
+-   -ksp_cacg_basis <chebyshev> - polynomial basis of the Krylov spaces: monomial, newton or chebyshev
+
+   Level: intermediate
+
+   Notes:
+   Each outer step builds bases of the Krylov spaces of the search direction and of the preconditioned residual, computes
+   all the inner products of the next s iterations in one global reduction, with the Gram matrix of these bases, and then
+   runs these s iterations on the coordinates in the bases. This costs 2s-1 matrix-vector products and preconditioner
+   applications per s iterations instead of s, and trades 2s global reductions for one.
+
+   The monomial basis becomes ill-conditioned quickly as s grows. The first outer step of each solve uses it, then the
+   Newton basis uses the Ritz values of its Lanczos matrix in Leja order as shifts and the Chebyshev basis the interval
+   containing them. The preconditioner and the matrix must be symmetric (Hermitian) and positive definite, as for KSPCG.
+   KSPComputeEigenvalues() is always available.
+
+   References:
++   1. - A. T. Chronopoulos and C. W. Gear, s-step iterative methods for symmetric linear systems, J. Comput. Appl. Math., 1989.
+-   2. - E. Carson, Communication-avoiding Krylov subspace methods in theory and practice, PhD thesis, UC Berkeley, 2015.
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPCG, KSPPIPECG, KSPPIPELCG, KSPCAGMRES
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_CACG(KSP ksp)
+{
+  KSP_CACG       *cacg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&cacg);CHKERRQ(ierr);
+#if !defined(PETSC_USE_COMPLEX)
+  cacg->cg.type = KSP_CG_SYMMETRIC;
+#else
+  cacg->cg.type = KSP_CG_HERMITIAN;
+#endif
+  cacg->s     = 4;
+  cacg->basis = KSP_SSTEP_BASIS_CHEBYSHEV;
+  ksp->data   = (void*)cacg;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NATURAL,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup                        = KSPSetUp_CACG;
+  ksp->ops->solve                        = KSPSolve_CACG;
+  ksp->ops->reset                        = KSPReset_CACG;
+  ksp->ops->destroy                      = KSPDestroy_CACG;
+  ksp->ops->view                         = KSPView_CACG;
+  ksp->ops->setfromoptions               = KSPSetFromOptions_CACG;
+  ksp->ops->buildsolution                = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual                = KSPBuildResidualDefault;
+  ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_CG;
+  ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_CG;
+  PetscFunctionReturn(0);
+}
@@ -42,6 +42,7 @@
     data used during the optional Lanczo process used to compute eigenvalues
 */
 #include <../src/ksp/ksp/impls/cg/cgimpl.h>       /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
 extern PetscErrorCode KSPComputeExtremeSingularValues_CG(KSP,PetscReal*,PetscReal*);
 extern PetscErrorCode KSPComputeEigenvalues_CG(KSP,PetscInt,PetscReal*,PetscReal*,PetscInt*);
 
@@ -205,13 +206,16 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     a = beta/dpi;                                              /*     a = beta/p'w                     */
     if (eigs) d[i] = PetscSqrtReal(PetscAbsScalar(b))*e[i] + 1.0/a;
     ierr = VecAXPY(X,a,P);CHKERRQ(ierr);                       /*     x <- x + ap                      */
-    ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                      /*     r <- r - aw                      */
+    if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
+      ierr = VecWAXPYDotNorm(R,-a,W,R,NULL,NULL,&dp);CHKERRQ(ierr); /*   r <- r - aw, dp <- r'*r          */
+    } else {
+      ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                    /*     r <- r - aw                      */
+    }
     if (ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i+2) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
       ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- z'*z                       */
       KSPCheckNorm(ksp,dp);
     } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- r'*r                       */
       KSPCheckNorm(ksp,dp);
     } else if (ksp->normtype == KSP_NORM_NATURAL) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
@@ -419,6 +423,138 @@ static PetscErrorCode KSPSolve_CG_SingleReduction(KSP ksp)
   PetscFunctionReturn(0);
 }
 
+/*
+     KSPMatSolve_CG - Block conjugate gradient method of O'Leary for the columns of B, used by KSPMatSolve().
+                      The convergence test uses the natural norms of the columns, the square roots of the diagonal of rho.
+
+       R = B - A X, Z = M R, P = Z, rho = Z^H R
+       loop
+         Q     = A P
+         alpha = (P^H Q)^{-1} rho
+         X     = X + P alpha, R = R - Q alpha
+         Z     = M R, rhonew = Z^H R
+         beta  = rho^{-1} rhonew
+         P     = Z + P beta, rho = rhonew
+*/
+static PetscErrorCode KSPMatSolve_CG(KSP ksp,Mat B,Mat X)
+{
+  PetscErrorCode ierr;
+  Mat            R,Z,P,Q = NULL;
+  Vec            x,y;
+  PetscScalar    *rho,*rhonew,*delta,*alpha,*r,*z,*p,*q,*xa,one = 1.0,mone = -1.0,zero = 0.0;
+  PetscReal      *rnorm0,*rnorm;
+  PetscInt       n,N,i,k;
+  PetscBool      none;
+  PetscBLASInt   bn,bN,info;
+
+  PetscFunctionBegin;
+  ierr = MatGetLocalSize(B,&n,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(B,NULL,&N);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(N,&bN);CHKERRQ(ierr);
+  ierr = VecCreateMPIWithArray(PetscObjectComm((PetscObject)B),1,n,PETSC_DECIDE,NULL,&x);CHKERRQ(ierr);
+  ierr = VecCreateMPIWithArray(PetscObjectComm((PetscObject)B),1,n,PETSC_DECIDE,NULL,&y);CHKERRQ(ierr);
+  ierr = PetscMalloc6(N*N,&rho,N*N,&rhonew,N*N,&delta,N*N,&alpha,N,&rnorm0,N,&rnorm);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_COPY_VALUES,&R);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&P);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)ksp->pc,PCNONE,&none);CHKERRQ(ierr);
+  if (none) {
+    ierr = PetscObjectReference((PetscObject)R);CHKERRQ(ierr);
+    Z    = R;
+  } else {
+    ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&Z);CHKERRQ(ierr);
+  }
+
+  if (!ksp->guess_zero) {
+    ierr = KSPMatSolveMatMult_Private(ksp,X,&Q,x,y);CHKERRQ(ierr);        /*     r <- b - Ax                       */
+    ierr = MatAXPY(R,-1.0,Q,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+  }
+  if (!none) {ierr = KSPMatSolvePCApply_Private(ksp,R,Z,x,y);CHKERRQ(ierr);} /*     z <- Br                           */
+  ierr = MatDenseGetArray(R,&r);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(Z,&z);CHKERRQ(ierr);
+  ierr = KSPMatSolveDot_Private(ksp,n,N,z,N,r,rho);CHKERRQ(ierr);           /*     rho <- z'*r                       */
+  ierr = MatDenseRestoreArray(Z,&z);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(R,&r);CHKERRQ(ierr);
+  for (k=0; k<N; k++) rnorm0[k] = PetscSqrtReal(PetscAbsReal(PetscRealPart(rho[k*(N+1)])));
+  ierr = KSPMatSolveConverged_Private(ksp,0,N,rnorm0,rnorm0);CHKERRQ(ierr);
+  ierr = MatCopy(Z,P,SAME_NONZERO_PATTERN);CHKERRQ(ierr);                   /*     p <- z                            */
+
+  i = 0;
+  while (!ksp->reason) {
+    ierr = KSPMatSolveMatMult_Private(ksp,P,&Q,x,y);CHKERRQ(ierr);        /*     q <- Ap                           */
+    ierr = MatDenseGetArray(P,&p);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(Q,&q);CHKERRQ(ierr);
+    ierr = KSPMatSolveDot_Private(ksp,n,N,p,N,q,delta);CHKERRQ(ierr);     /*     delta <- p'*q                     */
+    ierr = PetscMemcpy(alpha,rho,N*N*sizeof(PetscScalar));CHKERRQ(ierr);
+#if defined(PETSC_MISSING_LAPACK_POTRF)
+    SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"POTRF - Lapack routine is unavailable.");
+#else
+    PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&bN,delta,&bN,&info));
+    if (!info) PetscStackCallBLAS("LAPACKpotrs",LAPACKpotrs_("U",&bN,&bN,delta,&bN,alpha,&bN,&info)); /* alpha <- delta^{-1} rho */
+#endif
+    if (info) {
+      ierr = MatDenseRestoreArray(Q,&q);CHKERRQ(ierr);
+      ierr = MatDenseRestoreArray(P,&p);CHKERRQ(ierr);
+      ierr = PetscInfo1(ksp,"Block of search directions is not positive definite or rank deficient at iteration %D\n",i);CHKERRQ(ierr);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      break;
+    }
+    if (bn) {
+      ierr = MatDenseGetArray(X,&xa);CHKERRQ(ierr);
+      ierr = MatDenseGetArray(R,&r);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bN,&bN,&one,p,&bn,alpha,&bN,&one,xa,&bn));  /* x <- x + p alpha */
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bN,&bN,&mone,q,&bn,alpha,&bN,&one,r,&bn)); /* r <- r - q alpha */
+      ierr = PetscLogFlops(4.0*n*N*N);CHKERRQ(ierr);
+      ierr = MatDenseRestoreArray(R,&r);CHKERRQ(ierr);
+      ierr = MatDenseRestoreArray(X,&xa);CHKERRQ(ierr);
+    }
+    ierr = MatDenseRestoreArray(Q,&q);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(P,&p);CHKERRQ(ierr);
+    i++;
+
+    if (!none) {ierr = KSPMatSolvePCApply_Private(ksp,R,Z,x,y);CHKERRQ(ierr);} /*   z <- Br                           */
+    ierr = MatDenseGetArray(R,&r);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(Z,&z);CHKERRQ(ierr);
+    ierr = KSPMatSolveDot_Private(ksp,n,N,z,N,r,rhonew);CHKERRQ(ierr);    /*     rhonew <- z'*r                    */
+    ierr = MatDenseRestoreArray(Z,&z);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(R,&r);CHKERRQ(ierr);
+    for (k=0; k<N; k++) rnorm[k] = PetscSqrtReal(PetscAbsReal(PetscRealPart(rhonew[k*(N+1)])));
+    ierr = KSPMatSolveConverged_Private(ksp,i,N,rnorm0,rnorm);CHKERRQ(ierr);
+    if (ksp->reason) break;
+
+    ierr = PetscMemcpy(alpha,rhonew,N*N*sizeof(PetscScalar));CHKERRQ(ierr);
+#if !defined(PETSC_MISSING_LAPACK_POTRF)
+    PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&bN,rho,&bN,&info));
+    if (!info) PetscStackCallBLAS("LAPACKpotrs",LAPACKpotrs_("U",&bN,&bN,rho,&bN,alpha,&bN,&info)); /* beta <- rho^{-1} rhonew */
+#endif
+    if (info) {
+      ierr = PetscInfo1(ksp,"Block of preconditioned residuals is not positive definite or rank deficient at iteration %D\n",i);CHKERRQ(ierr);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      break;
+    }
+    ierr = PetscMemcpy(rho,rhonew,N*N*sizeof(PetscScalar));CHKERRQ(ierr);
+    if (bn) {
+      ierr = MatDenseGetArray(P,&p);CHKERRQ(ierr);
+      ierr = MatDenseGetArray(Q,&q);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bN,&bN,&one,p,&bn,alpha,&bN,&zero,q,&bn));  /* q <- p beta */
+      ierr = PetscLogFlops(2.0*n*N*N);CHKERRQ(ierr);
+      ierr = MatDenseRestoreArray(Q,&q);CHKERRQ(ierr);
+      ierr = MatDenseRestoreArray(P,&p);CHKERRQ(ierr);
+    }
+    ierr = MatCopy(Z,P,SAME_NONZERO_PATTERN);CHKERRQ(ierr);                 /*     p <- z + p beta                   */
+    ierr = MatAXPY(P,1.0,Q,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+  }
+
+  ierr = PetscFree6(rho,rhonew,delta,alpha,rnorm0,rnorm);CHKERRQ(ierr);
+  ierr = MatDestroy(&Q);CHKERRQ(ierr);
+  ierr = MatDestroy(&P);CHKERRQ(ierr);
+  ierr = MatDestroy(&Z);CHKERRQ(ierr);
+  ierr = MatDestroy(&R);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
      KSPDestroy_CG - Frees resources allocated in KSPSetup_CG and clears function
                      compositions from KSPCreate_CG. If adding your own KSP implementation,
@@ -473,12 +609,17 @@ PetscErrorCode KSPSetFromOptions_CG(PetscOptionItems *PetscOptionsObject,KSP ksp
 {
   PetscErrorCode ierr;
   KSP_CG         *cg = (KSP_CG*)ksp->data;
+#if defined(PETSC_USE_COMPLEX)
+  KSPCGType      type;
+  PetscBool      flg;
+#endif
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"KSP CG and CGNE options");CHKERRQ(ierr);
 #if defined(PETSC_USE_COMPLEX)
   ierr = PetscOptionsEnum("-ksp_cg_type","Matrix is Hermitian or complex symmetric","KSPCGSetType",KSPCGTypes,(PetscEnum)cg->type,
-                          (PetscEnum*)&cg->type,NULL);CHKERRQ(ierr);
+                          (PetscEnum*)&type,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPCGSetType(ksp,type);CHKERRQ(ierr);}
 #endif
   ierr = PetscOptionsBool("-ksp_cg_single_reduction","Merge inner products into single MPIU_Allreduce()","KSPCGUseSingleReduction",cg->singlereduction,&cg->singlereduction,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
@@ -496,6 +637,10 @@ PetscErrorCode  KSPCGSetType_CG(KSP ksp,KSPCGType type)
 
   PetscFunctionBegin;
   cg->type = type;
+#if defined(PETSC_USE_COMPLEX)
+  /* the block method is only implemented for Hermitian matrices */
+  ksp->ops->matsolve = (type == KSP_CG_HERMITIAN) ? KSPMatSolve_CG : NULL;
+#endif
   PetscFunctionReturn(0);
 }
 
@@ -550,6 +695,10 @@ static PetscErrorCode  KSPCGUseSingleReduction_CG(KSP ksp,PetscBool flg)
    For complex numbers there are two different CG methods, one for Hermitian symmetric matrices and one for non-Hermitian symmetric matrices. Use
    KSPCGSetType() to indicate which type you are using.
 
+   KSPMatSolve() solves for several right-hand sides at once with the block CG method of O'Leary [3], which applies the operator to the
+   block of search directions with MatMatMult(). Its convergence test uses the natural norms of the residuals. It is not available for
+   complex symmetric matrices.
+
    Developer Notes:
     KSPSolve_CG() should actually query the matrix to determine if it is Hermitian symmetric or not and NOT require the user to
    indicate it to the KSP object.
@@ -559,9 +708,10 @@ static PetscErrorCode  KSPCGUseSingleReduction_CG(KSP ksp,PetscBool flg)
    Journal of Research of the National Bureau of Standards Vol. 49, No. 6, December 1952 Research Paper 2379
 .   2. - Josef Malek and Zdenek Strakos, Preconditioning and the Conjugate Gradient Method in the Context of Solving PDEs, 
     SIAM, 2014.
+.   3. - Dianne P. O'Leary, The block conjugate gradient algorithm and related methods, Linear Algebra and its Applications 29, 1980.
 
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP,
-           KSPCGSetType(), KSPCGUseSingleReduction(), KSPPIPECG, KSPGROPPCG
+           KSPCGSetType(), KSPCGUseSingleReduction(), KSPPIPECG, KSPGROPPCG, KSPMatSolve()
 
 M*/
 PETSC_EXTERN PetscErrorCode KSPCreate_CG(KSP ksp)
@@ -589,6 +739,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_CG(KSP ksp)
   */
   ksp->ops->setup          = KSPSetUp_CG;
   ksp->ops->solve          = KSPSolve_CG;
+  ksp->ops->matsolve       = KSPMatSolve_CG;
   ksp->ops->destroy        = KSPDestroy_CG;
   ksp->ops->view           = KSPView_CG;
   ksp->ops->setfromoptions = KSPSetFromOptions_CG;
@@ -133,23 +133,17 @@ static PetscErrorCode  KSPSolve_PIPECG(KSP ksp)
     }
 
     if (i == 0) {
+      beta  = 0.0;                               /*     z <- n, q <- m, p <- u, s <- w below */
       alpha = gamma / delta;
-      ierr  = VecCopy(N,Z);CHKERRQ(ierr);        /*     z <- n          */
-      ierr  = VecCopy(M,Q);CHKERRQ(ierr);        /*     q <- m          */
-      ierr  = VecCopy(U,P);CHKERRQ(ierr);        /*     p <- u          */
-      ierr  = VecCopy(W,S);CHKERRQ(ierr);        /*     s <- w          */
     } else {
       beta  = gamma / gammaold;
       alpha = gamma / (delta - beta / alpha * gamma);
-      ierr  = VecAYPX(Z,beta,N);CHKERRQ(ierr);   /*     z <- n + beta * z   */
-      ierr  = VecAYPX(Q,beta,M);CHKERRQ(ierr);   /*     q <- m + beta * q   */
-      ierr  = VecAYPX(P,beta,U);CHKERRQ(ierr);   /*     p <- u + beta * p   */
-      ierr  = VecAYPX(S,beta,W);CHKERRQ(ierr);   /*     s <- w + beta * s   */
     }
-    ierr     = VecAXPY(X, alpha,P);CHKERRQ(ierr); /*     x <- x + alpha * p   */
-    ierr     = VecAXPY(U,-alpha,Q);CHKERRQ(ierr); /*     u <- u - alpha * q   */
-    ierr     = VecAXPY(W,-alpha,Z);CHKERRQ(ierr); /*     w <- w - alpha * z   */
-    ierr     = VecAXPY(R,-alpha,S);CHKERRQ(ierr); /*     r <- r - alpha * s   */
+    /* fused updates, p and s must be formed before u and w change */
+    ierr     = VecAYPXAXPY(P,beta,U, alpha,X);CHKERRQ(ierr); /*     p <- u + beta * p,  x <- x + alpha * p   */
+    ierr     = VecAYPXAXPY(Q,beta,M,-alpha,U);CHKERRQ(ierr); /*     q <- m + beta * q,  u <- u - alpha * q   */
+    ierr     = VecAYPXAXPY(S,beta,W,-alpha,R);CHKERRQ(ierr); /*     s <- w + beta * s,  r <- r - alpha * s   */
+    ierr     = VecAYPXAXPY(Z,beta,N,-alpha,W);CHKERRQ(ierr); /*     z <- n + beta * z,  w <- w - alpha * z   */
     gammaold = gamma;
     i++;
     ksp->its = i;
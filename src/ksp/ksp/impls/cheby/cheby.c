@@ -75,6 +75,38 @@ static PetscErrorCode KSPChebyshevEstEigSet_Chebyshev(KSP ksp,PetscReal a,PetscR
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode KSPChebyshevEstEigSetEstimates_Chebyshev(KSP ksp,PetscReal emax,PetscReal emin)
+{
+  KSP_Chebyshev  *cheb = (KSP_Chebyshev*)ksp->data;
+  PetscErrorCode ierr;
+  Mat            Amat,Pmat;
+  PetscBool      set;
+
+  PetscFunctionBegin;
+  if (emax <= 0.0 || emin > emax) SETERRQ2(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Invalid eigenvalue estimates: max %g min %g",(double)emax,(double)emin);
+  if (!cheb->kspest) {
+    if (cheb->emin != 0.0 && cheb->emax != 0.0) PetscFunctionReturn(0); /* the eigenvalues were set with KSPChebyshevSetEigenvalues() */
+    ierr = KSPChebyshevEstEigSet(ksp,PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE,PETSC_DECIDE);CHKERRQ(ierr);
+  }
+  ierr = KSPGetOperatorsSet(ksp,&set,NULL);CHKERRQ(ierr);
+  if (!set) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_WRONGSTATE,"Must call KSPSetOperators() before KSPChebyshevEstEigSetEstimates()");
+  cheb->emin_computed = emin;
+  cheb->emax_computed = emax;
+  cheb->emin          = cheb->tform[0]*emin + cheb->tform[1]*emax;
+  cheb->emax          = cheb->tform[2]*emin + cheb->tform[3]*emax;
+  cheb->estprovided   = PETSC_TRUE;
+  cheb->estl1         = PETSC_FALSE;
+
+  /* the estimates are used until the operators change */
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)Amat,&cheb->amatid);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)Pmat,&cheb->pmatid);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)Amat,&cheb->amatstate);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)Pmat,&cheb->pmatstate);CHKERRQ(ierr);
+  ierr = PetscInfo2(ksp,"Using the provided eigenvalue estimates: min %g max %g\n",(double)emin,(double)emax);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode KSPChebyshevEstEigSetUseNoisy_Chebyshev(KSP ksp,PetscBool use)
 {
   KSP_Chebyshev  *cheb = (KSP_Chebyshev*)ksp->data;
@@ -164,6 +196,41 @@ PetscErrorCode KSPChebyshevEstEigSet(KSP ksp,PetscReal a,PetscReal b,PetscReal c
   PetscFunctionReturn(0);
 }
 
+/*@
+   KSPChebyshevEstEigSetEstimates - Provides estimates of the extreme eigenvalues of the preconditioned operator, computed
+   elsewhere, in place of the Krylov estimate for the current operators
+
+   Logically Collective on KSP
+
+   Input Parameters:
++  ksp - the Krylov space context
+.  emax - estimate of the largest eigenvalue of the preconditioned operator
+-  emin - estimate of the smallest eigenvalue of the preconditioned operator
+
+   Notes:
+   The Chebyshev bounds are obtained from the estimates with the transform of KSPChebyshevEstEigSet(). The estimates are used
+   until the operators given to KSPSetOperators() change, in value or in structure; the eigenvalues are then estimated again
+   with the Krylov method of KSPChebyshevEstEigGetKSP(). PCGAMG uses this to pass the estimates computed while smoothing the
+   prolongators to the Chebyshev/Jacobi smoothers, see PCGAMGSetUseSAEstEig().
+
+   This does nothing if the eigenvalues were set with KSPChebyshevSetEigenvalues(). KSPSetOperators() must be called first.
+
+   Level: advanced
+
+.seealso: KSPChebyshevEstEigSet(), KSPChebyshevSetEigenvalues(), PCGAMGSetUseSAEstEig()
+@*/
+PetscErrorCode KSPChebyshevEstEigSetEstimates(KSP ksp,PetscReal emax,PetscReal emin)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveReal(ksp,emax,2);
+  PetscValidLogicalCollectiveReal(ksp,emin,3);
+  ierr = PetscTryMethod(ksp,"KSPChebyshevEstEigSetEstimates_C",(KSP,PetscReal,PetscReal),(ksp,emax,emin));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    KSPChebyshevEstEigSetUseNoisy - use a noisy right hand side in order to do the estimate instead of the given right hand side
 
@@ -329,11 +396,33 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
     PetscObjectState amatstate, pmatstate;
     PCFailedReason   pcreason;
     PC               pc;
+    PetscBool        isjacobi;
+    PCJacobiType     jtype;
 
     ierr = PetscObjectGetId((PetscObject)Amat,&amatid);CHKERRQ(ierr);
     ierr = PetscObjectGetId((PetscObject)Pmat,&pmatid);CHKERRQ(ierr);
     ierr = PetscObjectStateGet((PetscObject)Amat,&amatstate);CHKERRQ(ierr);
     ierr = PetscObjectStateGet((PetscObject)Pmat,&pmatstate);CHKERRQ(ierr);
+    if (amatid != cheb->amatid || pmatid != cheb->pmatid || amatstate != cheb->amatstate || pmatstate != cheb->pmatstate) {
+      ierr = PetscObjectTypeCompare((PetscObject)ksp->pc,PCJACOBI,&isjacobi);CHKERRQ(ierr);
+      if (isjacobi && Amat == Pmat) {
+        ierr = PCJacobiGetType(ksp->pc,&jtype);CHKERRQ(ierr);
+        if (jtype == PC_JACOBI_ROWL1) {
+          /* the eigenvalues of the l1 Jacobi preconditioned operator lie in (0,1], no estimate is needed */
+          cheb->emin_computed = 0.0;
+          cheb->emax_computed = 1.0;
+          cheb->emin          = cheb->tform[1];
+          cheb->emax          = cheb->tform[3];
+          cheb->estprovided   = PETSC_FALSE;
+          cheb->estl1         = PETSC_TRUE;
+          cheb->amatid        = amatid;
+          cheb->pmatid        = pmatid;
+          cheb->amatstate     = amatstate;
+          cheb->pmatstate     = pmatstate;
+          ierr = PetscInfo(ksp,"Using the eigenvalue bound of l1 Jacobi instead of an estimate\n");CHKERRQ(ierr);
+        }
+      }
+    }
     if (amatid != cheb->amatid || pmatid != cheb->pmatid || amatstate != cheb->amatstate || pmatstate != cheb->pmatstate) {
       PetscReal          max=0.0,min=0.0;
       Vec                B;
@@ -392,6 +481,8 @@ static PetscErrorCode KSPSolve_Chebyshev(KSP ksp)
 
       cheb->emin_computed = min;
       cheb->emax_computed = max;
+      cheb->estprovided   = PETSC_FALSE;
+      cheb->estl1         = PETSC_FALSE;
       cheb->emin = cheb->tform[0]*min + cheb->tform[1]*max;
       cheb->emax = cheb->tform[2]*min + cheb->tform[3]*max;
 
@@ -569,13 +660,19 @@ static  PetscErrorCode KSPView_Chebyshev(KSP ksp,PetscViewer viewer)
   if (iascii) {
     ierr = PetscViewerASCIIPrintf(viewer,"  eigenvalue estimates used:  min = %g, max = %g\n",(double)cheb->emin,(double)cheb->emax);CHKERRQ(ierr);
     if (cheb->kspest) {
-      ierr = PetscViewerASCIIPrintf(viewer,"  eigenvalues estimate via %s min %g, max %g\n",((PetscObject)(cheb->kspest))->type_name,(double)cheb->emin_computed,(double)cheb->emax_computed);CHKERRQ(ierr);
-      ierr = PetscViewerASCIIPrintf(viewer,"  eigenvalues estimated using %s with translations  [%g %g; %g %g]\n",((PetscObject) cheb->kspest)->type_name,(double)cheb->tform[0],(double)cheb->tform[1],(double)cheb->tform[2],(double)cheb->tform[3]);CHKERRQ(ierr);
-      ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
-      ierr = KSPView(cheb->kspest,viewer);CHKERRQ(ierr);
-      ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
-      if (cheb->usenoisy) {
-        ierr = PetscViewerASCIIPrintf(viewer,"  estimating eigenvalues using noisy right hand side\n");CHKERRQ(ierr);
+      if (cheb->estl1) {
+        ierr = PetscViewerASCIIPrintf(viewer,"  eigenvalues bounded by l1 Jacobi min %g, max %g\n",(double)cheb->emin_computed,(double)cheb->emax_computed);CHKERRQ(ierr);
+      } else if (cheb->estprovided) {
+        ierr = PetscViewerASCIIPrintf(viewer,"  eigenvalues estimate provided min %g, max %g\n",(double)cheb->emin_computed,(double)cheb->emax_computed);CHKERRQ(ierr);
+      } else {
+        ierr = PetscViewerASCIIPrintf(viewer,"  eigenvalues estimate via %s min %g, max %g\n",((PetscObject)(cheb->kspest))->type_name,(double)cheb->emin_computed,(double)cheb->emax_computed);CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPrintf(viewer,"  eigenvalues estimated using %s with translations  [%g %g; %g %g]\n",((PetscObject) cheb->kspest)->type_name,(double)cheb->tform[0],(double)cheb->tform[1],(double)cheb->tform[2],(double)cheb->tform[3]);CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPushTab(viewer);CHKERRQ(ierr);
+        ierr = KSPView(cheb->kspest,viewer);CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPopTab(viewer);CHKERRQ(ierr);
+        if (cheb->usenoisy) {
+          ierr = PetscViewerASCIIPrintf(viewer,"  estimating eigenvalues using noisy right hand side\n");CHKERRQ(ierr);
+        }
       }
     }
   }
@@ -591,6 +688,7 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
   ierr = KSPDestroy(&cheb->kspest);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevSetEigenvalues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSet_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetEstimates_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetUseNoisy_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigGetKSP_C",NULL);CHKERRQ(ierr);
   ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
@@ -618,8 +716,12 @@ static PetscErrorCode KSPDestroy_Chebyshev(KSP ksp)
           Chebyshev is configured as a smoother by default, targetting the "upper" part of the spectrum.
           The user should call KSPChebyshevSetEigenvalues() if they have eigenvalue estimates.
 
+          With the l1 Jacobi preconditioner, -pc_jacobi_type rowl1, the largest eigenvalue of the preconditioned operator is
+          bounded by one: this bound is used instead of the Krylov estimate, so no reduction is needed, neither in the setup
+          nor in the application of the smoother. KSPChebyshevEstEigSetEstimates() provides estimates computed elsewhere.
+
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP,
-           KSPChebyshevSetEigenvalues(), KSPChebyshevEstEigSet(), KSPChebyshevEstEigSetUseNoisy()
+           KSPChebyshevSetEigenvalues(), KSPChebyshevEstEigSet(), KSPChebyshevEstEigSetUseNoisy(), KSPChebyshevEstEigSetEstimates()
            KSPRICHARDSON, KSPCG, PCMG
 
 M*/
@@ -659,6 +761,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_Chebyshev(KSP ksp)
 
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevSetEigenvalues_C",KSPChebyshevSetEigenvalues_Chebyshev);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSet_C",KSPChebyshevEstEigSet_Chebyshev);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetEstimates_C",KSPChebyshevEstEigSetEstimates_Chebyshev);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigSetUseNoisy_C",KSPChebyshevEstEigSetUseNoisy_Chebyshev);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPChebyshevEstEigGetKSP_C",KSPChebyshevEstEigGetKSP_Chebyshev);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -14,6 +14,8 @@ typedef struct {
   PetscReal        tform[4];     /* transform from Krylov estimates to Chebyshev bounds */
   PetscInt         eststeps;     /* number of kspest steps in KSP used to estimate eigenvalues */
   PetscBool        usenoisy;    /* use noisy right hand side vector to estimate eigenvalues */
+  PetscBool        estprovided; /* emin_computed and emax_computed were provided with KSPChebyshevEstEigSetEstimates() */
+  PetscBool        estl1;       /* emin_computed and emax_computed are the bounds of the l1 Jacobi preconditioned operator */
   /* For tracking when to update the eigenvalue estimates */
   PetscObjectId    amatid,    pmatid;
   PetscObjectState amatstate, pmatstate;
@@ -0,0 +1,172 @@
+/*
+    Routines used for the orthogonalization of the Hessenberg matrix.
+
+    Note that for the complex numbers version, the VecDot() and
+    VecMDot() arguments within the code MUST remain in the order
+    given for correct computation of inner products.
+*/
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+
+/*@C
+     KSPGMRESLowSyncGramSchmidtOrthogonalization - Classical Gram-Schmidt orthogonalization with lagged normalization and
+                lagged reorthogonalization, which needs a single global reduction per iteration
+
+     Collective on KSP
+
+  Input Parameters:
++   ksp - KSP object, must be associated with GMRES or FGMRES Krylov method
+-   its - one less then the current GMRES restart iteration, i.e. the size of the Krylov space
+
+   Options Database Keys:
+.   -ksp_gmres_lowsyncgramschmidt - Activates KSPGMRESLowSyncGramSchmidtOrthogonalization()
+
+    Notes:
+    Classical Gram-Schmidt followed by the normalization of the new vector needs two global reductions per iteration, and
+    three with iterative refinement. Here the new vector is orthogonalized once and normalized with a norm obtained from the
+    Pythagorean theorem. Its second orthogonalization is delayed to the next iteration, where its inner products with the basis
+    and its norm are computed in the same reduction as the inner products and the norm of the next vector, see VecMDotBegin().
+    The previous column of the Hessenberg matrix and its plane rotation are then corrected, so the basis is as orthogonal as with
+    one step of iterative refinement while the residual norm of each iteration only relies on the tentative last column.
+
+    An extra reduction is only performed when a norm given by the Pythagorean theorem is lost to cancellation.
+
+   Level: intermediate
+
+   References:
+.   1. - K. Swirydowicz, J. Langou, S. Ananthan, U. Yang and S. Thomas, Low synchronization Gram-Schmidt and generalized minimal
+         residual algorithms, Numerical Linear Algebra with Applications, 28, 2021.
+
+.seealso:  KSPGMRESSetOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(),
+           KSPGMRESGetOrthogonalization()
+
+@*/
+PetscErrorCode  KSPGMRESLowSyncGramSchmidtOrthogonalization(KSP ksp,PetscInt it)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)(ksp->data);
+  PetscErrorCode ierr;
+  PetscInt       j,l;
+  PetscScalar    *hh,*hes,*lhh,*hprev,hv,tmp,r;
+  PetscReal      wnrm,vnrm = 0.0,snrm2 = 0.0,hnrm2 = 0.0,nu = 1.0,tau,tt2,tt;
+  PetscBool      flexible,match;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)ksp,KSPFGMRES,&flexible);CHKERRQ(ierr);
+  if (!flexible) {
+    ierr = PetscObjectTypeCompare((PetscObject)ksp,KSPGMRES,&match);CHKERRQ(ierr);
+    if (!match) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Low-synchronization Gram-Schmidt orthogonalization is not available for KSP type %s, only for KSPGMRES and KSPFGMRES",((PetscObject)ksp)->type_name);
+  }
+  ierr = PetscLogEventBegin(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+  if (!gmres->orthogwork) {
+    ierr = PetscMalloc1(gmres->max_k + 2,&gmres->orthogwork);CHKERRQ(ierr);
+  }
+  lhh = gmres->orthogwork;
+  hh  = HH(0,it);
+  hes = HES(0,it);
+
+  /*
+     VEC_VV(it) has only been orthogonalized once and scaled by the tentative norm tau = HES(it,it-1), and VEC_VV(it+1) is the operator
+     applied to it. All the inner products are gathered in a single reduction:
+       hh[j]  = <vnew,v_j> for j <= it and wnrm = |vnew|,
+       lhh[j] = <v_it,v_j> for j < it and vnrm = |v_it|.
+  */
+  ierr = VecMDotBegin(VEC_VV(it+1),it+1,&(VEC_VV(0)),hh);CHKERRQ(ierr);
+  ierr = VecNormBegin(VEC_VV(it+1),NORM_2,&wnrm);CHKERRQ(ierr);
+  if (it) {
+    ierr = VecMDotBegin(VEC_VV(it),it,&(VEC_VV(0)),lhh);CHKERRQ(ierr);
+    ierr = VecNormBegin(VEC_VV(it),NORM_2,&vnrm);CHKERRQ(ierr);
+  }
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(it+1)));CHKERRQ(ierr);
+  ierr = VecMDotEnd(VEC_VV(it+1),it+1,&(VEC_VV(0)),hh);CHKERRQ(ierr);
+  ierr = VecNormEnd(VEC_VV(it+1),NORM_2,&wnrm);CHKERRQ(ierr);
+  if (it) {
+    ierr = VecMDotEnd(VEC_VV(it),it,&(VEC_VV(0)),lhh);CHKERRQ(ierr);
+    ierr = VecNormEnd(VEC_VV(it),NORM_2,&vnrm);CHKERRQ(ierr);
+  }
+  KSPCheckNorm(ksp,wnrm);
+
+  if (it) {
+    /* lagged reorthogonalization and normalization of v_it */
+    for (j=0; j<it; j++) {
+      snrm2 += PetscRealPart(PetscConj(lhh[j])*lhh[j]);
+      lhh[j] = -lhh[j];
+    }
+    ierr = VecMAXPY(VEC_VV(it),it,lhh,&VEC_VV(0));CHKERRQ(ierr);
+    for (j=0; j<it; j++) lhh[j] = -lhh[j];
+    tt2 = vnrm*vnrm - snrm2;
+    if (tt2 > PETSC_SQRT_MACHINE_EPSILON*vnrm*vnrm) nu = PetscSqrtReal(tt2);
+    else {
+      ierr = VecNorm(VEC_VV(it),NORM_2,&nu);CHKERRQ(ierr);
+      ierr = PetscInfo2(ksp,"Computing the norm of the reorthogonalized vector, vnorm %g snorm %g\n",(double)vnrm,(double)PetscSqrtReal(snrm2));CHKERRQ(ierr);
+    }
+    if (nu == 0.0) {
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      ierr = PetscInfo(ksp,"Breakdown in the lagged reorthogonalization\n");CHKERRQ(ierr);
+      ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    ierr = VecScale(VEC_VV(it),1.0/nu);CHKERRQ(ierr);
+
+    /* <vnew,v_it> with the final v_it */
+    hv = hh[it];
+    for (j=0; j<it; j++) hv -= PetscConj(lhh[j])*hh[j];
+    hh[it] = hv/nu;
+
+    /* the operator applied to v_{it-1} was tau times the old v_it, so correct the previous column of the Hessenberg matrix */
+    tau   = PetscRealPart(*HES(it,it-1));
+    hprev = HES(0,it-1);
+    for (j=0; j<it; j++) hprev[j] += tau*lhh[j];
+    hprev[it] = tau*nu;
+
+    /* without a flexible preconditioner, vnew is the operator applied to the old v_it: store in hes the coefficients of the
+       operator applied to the difference between the old and the final v_it */
+    if (!flexible) {
+      for (l=0; l<=it; l++) {
+        hes[l] = 0.0;
+        for (j=PetscMax(0,l-1); j<it; j++) hes[l] += *HES(l,j)*lhh[j];
+      }
+    }
+  }
+
+  /* first orthogonalization of vnew, its norm follows from the Pythagorean theorem */
+  for (j=0; j<=it; j++) {
+    hnrm2 += PetscRealPart(PetscConj(hh[j])*hh[j]);
+    lhh[j] = -hh[j];
+  }
+  ierr = VecMAXPY(VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
+  tt2 = wnrm*wnrm - hnrm2;
+  if (tt2 > PETSC_SQRT_MACHINE_EPSILON*wnrm*wnrm) tt = PetscSqrtReal(tt2);
+  else {
+    ierr = VecNorm(VEC_VV(it+1),NORM_2,&tt);CHKERRQ(ierr);
+  }
+  if (tt != 0.0) {
+    ierr = VecScale(VEC_VV(it+1),1.0/tt);CHKERRQ(ierr);
+  }
+  if (it && !flexible) {
+    /* the operator applied to the final v_it is (vnew - V hes)/nu */
+    for (j=0; j<=it; j++) hh[j] = (hh[j] - hes[j])/nu;
+    tt /= nu;
+  }
+  for (j=0; j<=it; j++) hes[j] = hh[j];
+  *HH(it+1,it)  = tt;
+  *HES(it+1,it) = tt;
+
+  if (it) {
+    /* recompute the plane rotation of the corrected previous column, after undoing it on the right-hand side */
+    hprev = HH(0,it-1);
+    for (j=0; j<=it; j++) hprev[j] = *HES(j,it-1);
+    for (j=0; j<it-1; j++) {
+      tmp        = hprev[j];
+      hprev[j]   = PetscConj(*CC(j))*tmp + *SS(j)*hprev[j+1];
+      hprev[j+1] = *CC(j)*hprev[j+1] - *SS(j)*tmp;
+    }
+    r   = *CC(it-1) * *GRS(it-1) - *SS(it-1) * *GRS(it);
+    tmp = PetscSqrtScalar(PetscConj(hprev[it-1])*hprev[it-1] + PetscConj(hprev[it])*hprev[it]);
+    *CC(it-1)   = hprev[it-1]/tmp;
+    *SS(it-1)   = hprev[it]/tmp;
+    *GRS(it)    = -(*SS(it-1) * r);
+    *GRS(it-1)  = PetscConj(*CC(it-1)) * r;
+    hprev[it-1] = PetscConj(*CC(it-1))*hprev[it-1] + *SS(it-1)*hprev[it];
+  }
+  ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,601 @@
+/*
+    This file implements CAGMRES (the s-step, or communication-avoiding, Generalized Minimal Residual method)
+*/
+
+#include <../src/ksp/ksp/impls/gmres/cagmres/cagmresimpl.h>       /*I  "petscksp.h"  I*/
+#define CAGMRES_DELTA_DIRECTIONS 10
+#define CAGMRES_DEFAULT_MAXK     30
+
+static PetscErrorCode KSPCAGMRESUpdateHessenberg(KSP,PetscInt,PetscBool*,PetscReal*);
+static PetscErrorCode KSPCAGMRESBuildSoln(PetscScalar*,Vec,Vec,KSP,PetscInt);
+
+/*
+
+    KSPSetUp_CAGMRES - Sets up the workspace needed by cagmres.
+
+    The workspace for the eigenvalues of the Hessenberg matrix is always allocated since the Ritz values provide the
+    shifts of the Newton and Chebyshev bases.
+
+*/
+static PetscErrorCode KSPSetUp_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscInt       max_k,s = cagmres->s;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr  = KSPSetUp_GMRES(ksp);CHKERRQ(ierr);
+  max_k = cagmres->max_k;
+  if (!cagmres->Rsvd) {
+    ierr = PetscMalloc1((max_k + 3)*(max_k + 9),&cagmres->Rsvd);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,(max_k + 3)*(max_k + 9)*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscMalloc1(6*(max_k+2),&cagmres->Dsvd);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,6*(max_k+2)*sizeof(PetscReal));CHKERRQ(ierr);
+  }
+  /* KSPGMRESSetRestart() may have reset only the GMRES part */
+  ierr = PetscFree4(cagmres->gamma,cagmres->theta,cagmres->mu,cagmres->Rs);CHKERRQ(ierr);
+  ierr = PetscFree2(cagmres->re,cagmres->im);CHKERRQ(ierr);
+  ierr = PetscMalloc4(s,&cagmres->gamma,s,&cagmres->theta,s,&cagmres->mu,(max_k+1)*(s+1),&cagmres->Rs);CHKERRQ(ierr);
+  ierr = PetscMalloc2(max_k+1,&cagmres->re,max_k+1,&cagmres->im);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(3*s+(max_k+1)*(s+1))*sizeof(PetscScalar)+2*(max_k+1)*sizeof(PetscReal));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCAGMRESBlock - Extends the orthonormal basis VEC_VV(0..it) by up to sb vectors with one reduction.
+
+    The block S = [VEC_VV(it), W_1, ..., W_sb], W_k = rho_k(BA) VEC_VV(it), satisfies BA S(:,0:sb-1) = S T, T being the
+    (sb+1) x sb tridiagonal matrix of the recurrence of the basis. One reduction computes all the inner products of the W_k
+    with VEC_VV(0..it) and with each other, the Cholesky factorization of the Gram matrix of their projections on the
+    orthogonal complement of VEC_VV(0..it) (CholQR with the Pythagorean correction) provides the new orthonormal vectors,
+    and S = VV Rs. The next columns of the Hessenberg matrix are then H(:,it:it+sb-1) = (Rs T - [H_old X; 0]) Rsq^{-1},
+    where X are the first it rows and Rsq the next sb rows of Rs(:,0:sb-1).
+
+    The block is truncated before the first W_k that the Cholesky factorization finds numerically dependent.
+*/
+static PetscErrorCode KSPCAGMRESBlock(KSP ksp,PetscInt it,PetscInt *sb)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscInt       ld = cagmres->max_k+1,n = *sb,i,j,k,l;
+  PetscScalar    *work,*h,t;
+  PetscReal      dd;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* Matrix powers */
+  for (k=0; k<n; k++) {
+    PetscScalar g = cagmres->gamma[k],th = cagmres->theta[k],u = cagmres->mu[k];
+
+    ierr = KSP_PCApplyBAorAB(ksp,VEC_VV(it+k),VEC_VV(it+k+1),VEC_TEMP_MATOP);CHKERRQ(ierr);
+    if (k && u != 0.0) {
+      ierr = VecAXPBYPCZ(VEC_VV(it+k+1),-th/g,-u/g,1.0/g,VEC_VV(it+k),VEC_VV(it+k-1));CHKERRQ(ierr);
+    } else if (th != 0.0 || g != 1.0) {
+      ierr = VecAXPBY(VEC_VV(it+k+1),-th/g,1.0/g,VEC_VV(it+k));CHKERRQ(ierr);
+    }
+  }
+
+  /* Inner products of W_k with VEC_VV(0..it) and W_1..W_k, in a single reduction */
+  for (k=1; k<=n; k++) {
+    ierr = VecMDotBegin(VEC_VV(it+k),it+k+1,&VEC_VV(0),RB(0,k));CHKERRQ(ierr);
+  }
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  for (k=1; k<=n; k++) {
+    ierr = VecMDotEnd(VEC_VV(it+k),it+k+1,&VEC_VV(0),RB(0,k));CHKERRQ(ierr);
+  }
+
+  /* Cholesky factorization, in place: rows it+1..it+k of column k become the triangular factor */
+  for (k=1; k<=n; k++) {
+    for (i=1; i<k; i++) {
+      t = *RB(it+i,k);
+      for (l=0; l<it+i; l++) t -= PetscConj(*RB(l,i)) * *RB(l,k);
+      *RB(it+i,k) = t / *RB(it+i,i);
+    }
+    dd = PetscRealPart(*RB(it+k,k));
+    for (l=0; l<it+k; l++) dd -= PetscSqr(PetscAbsScalar(*RB(l,k)));
+    if (dd <= PETSC_SQRT_MACHINE_EPSILON*PetscRealPart(*RB(it+k,k))) {
+      ierr = PetscInfo3(ksp,"Block basis truncated to %D vectors at iteration %D, relative norm of the new direction %g\n",k-1,ksp->its,(double)PetscSqrtReal(PetscMax(dd,0.0)/PetscRealPart(*RB(it+k,k))));CHKERRQ(ierr);
+      n = k-1;
+      break;
+    }
+    *RB(it+k,k) = PetscSqrtReal(dd);
+  }
+  *sb = n;
+  if (!n) PetscFunctionReturn(0);
+  for (l=0; l<ld; l++) *RB(l,0) = 0.0;
+  *RB(it,0) = 1.0;
+  for (k=1; k<=n; k++) {
+    for (l=it+k+1; l<ld; l++) *RB(l,k) = 0.0;
+  }
+
+  /* Orthonormalize: VEC_VV(it+k) <- (W_k - sum_{l<it+k} VEC_VV(l) Rs(l,k)) / Rs(it+k,k) */
+  if (!cagmres->orthogwork) {ierr = PetscMalloc1(cagmres->max_k + 2,&cagmres->orthogwork);CHKERRQ(ierr);}
+  work = cagmres->orthogwork;
+  for (k=1; k<=n; k++) {
+    for (l=0; l<it+k; l++) work[l] = -*RB(l,k);
+    ierr = VecMAXPY(VEC_VV(it+k),it+k,work,&VEC_VV(0));CHKERRQ(ierr);
+    ierr = VecScale(VEC_VV(it+k),1.0 / *RB(it+k,k));CHKERRQ(ierr);
+  }
+
+  /* New columns of the Hessenberg matrix, the previous ones being in HES */
+  for (k=0; k<n; k++) {
+    h = HH(0,it+k);
+    for (l=0; l<=it+k+1; l++) {
+      h[l] = cagmres->gamma[k] * *RB(l,k+1) + cagmres->theta[k] * *RB(l,k);
+      if (k) h[l] += cagmres->mu[k] * *RB(l,k-1);
+    }
+    for (j=0; j<it; j++) {
+      t = *RB(j,k);
+      if (t == 0.0) continue;
+      for (l=0; l<=j+1; l++) h[l] -= *HES(l,j) * t;
+    }
+    for (j=0; j<k; j++) {
+      t = *RB(it+j,k);
+      for (l=0; l<=it+j+1; l++) h[l] -= *HH(l,it+j) * t;
+    }
+    for (l=0; l<=it+k+1; l++) h[l] /= *RB(it+k,k);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+
+    KSPCAGMRESCycle - Run cagmres, possibly with restart.  Return residual
+                  history if requested.
+
+    input parameters:
+.        cagmres  - structure containing parameters and work areas
+
+    output parameters:
+.        itcount - number of iterations used.  If null, ignored.
+.        converged - 0 if not converged
+
+    Notes:
+    On entry, the value in vector VEC_VV(0) should be
+    the initial residual.
+
+
+ */
+static PetscErrorCode KSPCAGMRESCycle(PetscInt *itcount,PetscBool *estimated,KSP ksp)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)(ksp->data);
+  PetscReal      res_norm,res;
+  PetscErrorCode ierr;
+  PetscInt       it = 0,k,sb,neig;
+  PetscBool      hapend = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  if (itcount) *itcount = 0;
+  ierr   = VecNormalize(VEC_VV(0),&res_norm);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,res_norm);
+  res    = res_norm;
+  *RS(0) = res_norm;
+
+  /* check for the convergence */
+  ierr        = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm  = res;
+  ierr        = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  cagmres->it = it-1;
+  ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    ierr        = PetscInfo(ksp,"Converged due to zero residual norm on entry\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  while (!ksp->reason && it < cagmres->max_k && ksp->its < ksp->max_it) {
+    sb = PetscMin(cagmres->s,PetscMin(cagmres->max_k-it,ksp->max_it-ksp->its));
+    while (cagmres->vv_allocated <= it + sb + VEC_OFFSET) {
+      ierr = KSPGMRESGetNewVectors(ksp,cagmres->vv_allocated-VEC_OFFSET);CHKERRQ(ierr);
+    }
+    ierr = KSPCAGMRESBlock(ksp,it,&sb);CHKERRQ(ierr);
+    if (!sb) {
+      if (it) break; /* restart from the current solution */
+      if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Breakdown of the block basis at the start of a cycle. Residual norm = %g",(double)res);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      break;
+    }
+
+    for (k=0; k<sb; k++) {
+      ierr        = KSPCAGMRESUpdateHessenberg(ksp,it,&hapend,&res);CHKERRQ(ierr);
+      cagmres->it = it;
+      it++;
+      ksp->its++;
+      ksp->rnorm  = res;
+
+      ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (it < cagmres->max_k || ksp->reason || ksp->its == ksp->max_it) {  /* Monitor if we are done or still iterating, but not before a restart. */
+        ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+        ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+      }
+      if (ksp->reason) break;
+      /* Catch error in happy breakdown and signal convergence and break from loop */
+      if (hapend) {
+        if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the happy break down, but convergence was not indicated. Residual norm = %g",(double)res);
+        else {
+          ksp->reason = KSP_DIVERGED_BREAKDOWN;
+          break;
+        }
+      }
+    }
+    if (ksp->reason) break;
+
+    /* The first block uses the monomial basis, the next ones the Ritz values of the Hessenberg matrix it produced */
+    if (!*estimated && cagmres->basis != KSP_SSTEP_BASIS_MONOMIAL) {
+      ierr = KSPComputeEigenvalues_GMRES(ksp,cagmres->max_k+1,cagmres->re,cagmres->im,&neig);CHKERRQ(ierr);
+      ierr = KSPSStepBasisCoefficients_Private(cagmres->basis,neig,cagmres->re,cagmres->im,cagmres->s,cagmres->gamma,cagmres->theta,cagmres->mu);CHKERRQ(ierr);
+      ierr = PetscInfo2(ksp,"%s basis from %D Ritz values\n",KSPSStepBasisTypes[cagmres->basis],neig);CHKERRQ(ierr);
+      *estimated = PETSC_TRUE;
+    }
+  }
+
+  if (itcount) *itcount = it;
+
+  /*
+    Down here we have to solve for the "best" coefficients of the Krylov
+    columns, add the solution values together, and possibly unwind the
+    preconditioning from the solution
+   */
+  /* Form the solution (or the solution so far) */
+  ierr = KSPCAGMRESBuildSoln(RS(0),ksp->vec_sol,ksp->vec_sol,ksp,it-1);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPSolve_CAGMRES - This routine applies the CAGMRES method.
+
+
+   Input Parameter:
+.     ksp - the Krylov space object that was set to use cagmres
+
+   Output Parameter:
+.     outits - number of iterations used
+
+*/
+static PetscErrorCode KSPSolve_CAGMRES(KSP ksp)
+{
+  PetscErrorCode ierr;
+  PetscInt       its,itcount;
+  KSP_CAGMRES    *cagmres   = (KSP_CAGMRES*)ksp->data;
+  PetscBool      guess_zero = ksp->guess_zero,estimated = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  ierr     = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr     = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+  ierr = KSPSStepBasisCoefficients_Private(KSP_SSTEP_BASIS_MONOMIAL,0,NULL,NULL,cagmres->s,cagmres->gamma,cagmres->theta,cagmres->mu);CHKERRQ(ierr);
+  itcount     = 0;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    ierr     = KSPInitialResidual(ksp,ksp->vec_sol,VEC_TEMP,VEC_TEMP_MATOP,VEC_VV(0),ksp->vec_rhs);CHKERRQ(ierr);
+    ierr     = KSPCAGMRESCycle(&its,&estimated,ksp);CHKERRQ(ierr);
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree4(cagmres->gamma,cagmres->theta,cagmres->mu,cagmres->Rs);CHKERRQ(ierr);
+  ierr = PetscFree2(cagmres->re,cagmres->im);CHKERRQ(ierr);
+  ierr = KSPReset_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_CAGMRES(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_CAGMRES(ksp);CHKERRQ(ierr);
+  ierr = KSPDestroy_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCAGMRESBuildSoln - create the solution from the starting vector and the
+                      current iterates.
+
+    Input parameters:
+        nrs - work area of size it + 1.
+        vguess  - index of initial guess
+        vdest - index of result.  Note that vguess may == vdest (replace
+                guess with the solution).
+        it - HH upper triangular part is a block of size (it+1) x (it+1)
+
+     This is an internal routine that knows about the CAGMRES internals.
+ */
+static PetscErrorCode KSPCAGMRESBuildSoln(PetscScalar *nrs,Vec vguess,Vec vdest,KSP ksp,PetscInt it)
+{
+  PetscScalar    tt;
+  PetscErrorCode ierr;
+  PetscInt       k,j;
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)(ksp->data);
+
+  PetscFunctionBegin;
+  /* Solve for solution vector that minimizes the residual */
+
+  if (it < 0) {                                 /* no cagmres steps have been performed */
+    ierr = VecCopy(vguess,vdest);CHKERRQ(ierr); /* VecCopy() is smart, exits immediately if vguess == vdest */
+    PetscFunctionReturn(0);
+  }
+
+  /* solve the upper triangular system - RS is the right side and HH is
+     the upper triangular matrix  - put soln in nrs */
+  if (*HH(it,it) != 0.0) nrs[it] = *RS(it) / *HH(it,it);
+  else nrs[it] = 0.0;
+
+  for (k=it-1; k>=0; k--) {
+    tt = *RS(k);
+    for (j=k+1; j<=it; j++) tt -= *HH(k,j) * nrs[j];
+    nrs[k] = tt / *HH(k,k);
+  }
+
+  /* Accumulate the correction to the solution of the preconditioned problem in TEMP */
+  ierr = VecZeroEntries(VEC_TEMP);CHKERRQ(ierr);
+  ierr = VecMAXPY(VEC_TEMP,it+1,nrs,&VEC_VV(0));CHKERRQ(ierr);
+  ierr = KSPUnwindPreconditioner(ksp,VEC_TEMP,VEC_TEMP_MATOP);CHKERRQ(ierr);
+  /* add solution to previous solution */
+  if (vdest == vguess) {
+    ierr = VecAXPY(vdest,1.0,VEC_TEMP);CHKERRQ(ierr);
+  } else {
+    ierr = VecWAXPY(vdest,1.0,VEC_TEMP,vguess);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+
+    KSPCAGMRESUpdateHessenberg - Do the scalar work for the orthogonalization.
+                            Return new residual.
+
+    input parameters:
+
+.        ksp -    Krylov space object
+.        it  -    plane rotations are applied to the (it+1)th column of the
+                  modified hessenberg (i.e. HH(:,it))
+.        hapend - PETSC_FALSE not happy breakdown ending.
+
+    output parameters:
+.        res - the new residual
+
+ */
+static PetscErrorCode KSPCAGMRESUpdateHessenberg(KSP ksp,PetscInt it,PetscBool *hapend,PetscReal *res)
+{
+  PetscScalar    *hh,*cc,*ss,*rs;
+  PetscInt       j;
+  PetscReal      hapbnd;
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)(ksp->data);
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  hh = HH(0,it);   /* pointer to beginning of column to update */
+  cc = CC(0);      /* beginning of cosine rotations */
+  ss = SS(0);      /* beginning of sine rotations */
+  rs = RS(0);      /* right hand side of least squares system */
+
+  /* The Hessenberg matrix is now correct through column it, save that form for the next blocks and for spectral analysis */
+  for (j=0; j<=it+1; j++) *HES(j,it) = hh[j];
+
+  /* check for the happy breakdown */
+  hapbnd = PetscMin(PetscAbsScalar(hh[it+1] / rs[it]),cagmres->haptol);
+  if (PetscAbsScalar(hh[it+1]) < hapbnd) {
+    ierr    = PetscInfo4(ksp,"Detected happy breakdown, current hapbnd = %14.12e H(%D,%D) = %14.12e\n",(double)hapbnd,it+1,it,(double)PetscAbsScalar(*HH(it+1,it)));CHKERRQ(ierr);
+    *hapend = PETSC_TRUE;
+  }
+
+  /* Apply all the previously computed plane rotations to the new column
+     of the Hessenberg matrix */
+  /* Note: this uses the rotation [conj(c)  s ; -s   c], c= cos(theta), s= sin(theta),
+     and some refs have [c   s ; -conj(s)  c] (don't be confused!) */
+
+  for (j=0; j<it; j++) {
+    PetscScalar hhj = hh[j];
+    hh[j]   = PetscConj(cc[j])*hhj + ss[j]*hh[j+1];
+    hh[j+1] =          -ss[j] *hhj + cc[j]*hh[j+1];
+  }
+
+  /*
+    compute the new plane rotation, and apply it to:
+     1) the right-hand-side of the Hessenberg system (RS)
+        note: it affects RS(it) and RS(it+1)
+     2) the new column of the Hessenberg matrix
+        note: it affects HH(it,it) which is currently pointed to
+        by hh and HH(it+1, it) (*(hh+1))
+    thus obtaining the updated value of the residual...
+  */
+
+  /* compute new plane rotation */
+
+  if (!*hapend) {
+    PetscReal delta = PetscSqrtReal(PetscSqr(PetscAbsScalar(hh[it])) + PetscSqr(PetscAbsScalar(hh[it+1])));
+    if (delta == 0.0) {
+      ksp->reason = KSP_DIVERGED_NULL;
+      PetscFunctionReturn(0);
+    }
+
+    cc[it] = hh[it] / delta;    /* new cosine value */
+    ss[it] = hh[it+1] / delta;  /* new sine value */
+
+    hh[it]   = PetscConj(cc[it])*hh[it] + ss[it]*hh[it+1];
+    rs[it+1] = -ss[it]*rs[it];
+    rs[it]   = PetscConj(cc[it])*rs[it];
+    *res     = PetscAbsScalar(rs[it+1]);
+  } else { /* happy breakdown: HH(it+1, it) = 0, therefore we don't need to apply
+            another rotation matrix (so RH doesn't change).  The new residual is
+            always the new sine term times the residual from last time (RS(it)),
+            but now the new sine rotation would be zero...so the residual should
+            be zero...so we will multiply "zero" by the last residual.  This might
+            not be exactly what we want to do here -could just return "zero". */
+
+    *res = 0.0;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPBuildSolution_CAGMRES
+
+     Input Parameter:
+.     ksp - the Krylov space object
+.     ptr-
+
+   Output Parameter:
+.     result - the solution
+
+   Note: this calls KSPCAGMRESBuildSoln - the same function that KSPCAGMRESCycle
+   calls directly.
+
+*/
+static PetscErrorCode KSPBuildSolution_CAGMRES(KSP ksp,Vec ptr,Vec *result)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!cagmres->sol_temp) {
+      ierr = VecDuplicate(ksp->vec_sol,&cagmres->sol_temp);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)cagmres->sol_temp);CHKERRQ(ierr);
+    }
+    ptr = cagmres->sol_temp;
+  }
+  if (!cagmres->nrs) {
+    /* allocate the work area */
+    ierr = PetscMalloc1(cagmres->max_k,&cagmres->nrs);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,cagmres->max_k*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+
+  ierr = KSPCAGMRESBuildSoln(cagmres->nrs,ksp->vec_sol,ptr,ksp,cagmres->it);CHKERRQ(ierr);
+  if (result) *result = ptr;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_CAGMRES(KSP ksp,PetscViewer viewer)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii,isstring;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D, blocks of s=%D vectors in the %s basis\n",cagmres->max_k,cagmres->s,KSPSStepBasisTypes[cagmres->basis]);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  using block classical Gram-Schmidt and Cholesky QR of each block with one reduction\n");CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  happy breakdown tolerance %g\n",(double)cagmres->haptol);CHKERRQ(ierr);
+  } else if (isstring) {
+    ierr = PetscViewerStringSPrintf(viewer,"CholQR restart %D s %D",cagmres->max_k,cagmres->s);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_CAGMRES(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscInt       s = cagmres->s;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetFromOptions_GMRES(PetscOptionsObject,ksp);CHKERRQ(ierr);
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP CAGMRES Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_cagmres_s","Number of basis vectors orthogonalized with one reduction","",s,&s,NULL);CHKERRQ(ierr);
+  if (s < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Block size %D must be positive",s);
+  if (s != cagmres->s) {
+    if (ksp->setupstage) {
+      ierr = KSPReset_CAGMRES(ksp);CHKERRQ(ierr);
+      ksp->setupstage = KSP_SETUP_NEW;
+    }
+    cagmres->s = s;
+  }
+  ierr = PetscOptionsEnum("-ksp_cagmres_basis","Polynomial basis of the Krylov space","",KSPSStepBasisTypes,(PetscEnum)cagmres->basis,(PetscEnum*)&cagmres->basis,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPCAGMRES - Implements the s-step, or communication-avoiding, Generalized Minimal Residual method.
+
+   Options Database Keys:
++   -ksp_cagmres_s <4> - the number of basis vectors computed and orthogonalized together with one reduction
+.   -ksp_cagmres_basis <newton> - polynomial basis of the blocks: monomial, newton or chebyshev
+.   -ksp_gmres_restart <restart> - the number of Krylov directions to orthogonalize against
+.   -ksp_gmres_haptol <tol> - sets the tolerance for "happy ending" (exact convergence)
+-   -ksp_gmres_preallocate - preallocate all the Krylov search directions initially (otherwise groups of
+                             vectors are allocated as needed)
+
+   Level: intermediate
+
+   Notes:
+   Each block of s basis vectors is generated from the last orthonormal vector by s applications of the preconditioned
+   operator, then orthogonalized against the previous vectors and among themselves with a single global reduction, by
+   block classical Gram-Schmidt followed by a Cholesky QR factorization. The s columns of the Hessenberg matrix follow
+   from the change of basis, so the residual norm is still available at every iteration. A block is truncated if its
+   basis becomes numerically dependent.
+
+   The first block of each solve uses the monomial basis, whose conditioning degrades quickly with s. The Newton basis
+   then uses the Ritz values of the Hessenberg matrix of this block in Leja order as shifts, the Chebyshev basis the
+   real interval containing them. The -ksp_gmres_orthog options do not apply.
+
+   Reference:
+   M. Hoemmen, Communication-avoiding Krylov subspace methods, PhD thesis, UC Berkeley, 2010.
+
+   Developer Notes:
+    This object is subclassed off of KSPGMRES
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPGMRES, KSPPGMRES, KSPCACG,
+           KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors()
+M*/
+
+PETSC_EXTERN PetscErrorCode KSPCreate_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES    *cagmres;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&cagmres);CHKERRQ(ierr);
+
+  ksp->data                              = (void*)cagmres;
+  ksp->ops->buildsolution                = KSPBuildSolution_CAGMRES;
+  ksp->ops->setup                        = KSPSetUp_CAGMRES;
+  ksp->ops->solve                        = KSPSolve_CAGMRES;
+  ksp->ops->reset                        = KSPReset_CAGMRES;
+  ksp->ops->destroy                      = KSPDestroy_CAGMRES;
+  ksp->ops->view                         = KSPView_CAGMRES;
+  ksp->ops->setfromoptions               = KSPSetFromOptions_CAGMRES;
+  ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_GMRES;
+  ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_GMRES;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetPreAllocateVectors_C",KSPGMRESSetPreAllocateVectors_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPGMRESSetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",KSPGMRESGetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetHapTol_C",KSPGMRESSetHapTol_GMRES);CHKERRQ(ierr);
+
+  cagmres->nextra_vecs    = 1;
+  cagmres->haptol         = 1.0e-30;
+  cagmres->q_preallocate  = 0;
+  cagmres->delta_allocate = CAGMRES_DELTA_DIRECTIONS;
+  cagmres->nrs            = 0;
+  cagmres->sol_temp       = 0;
+  cagmres->max_k          = CAGMRES_DEFAULT_MAXK;
+  cagmres->Rsvd           = 0;
+  cagmres->orthogwork     = 0;
+  cagmres->s              = 4;
+  cagmres->basis          = KSP_SSTEP_BASIS_NEWTON;
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,33 @@
+#if !defined(__CAGMRES)
+#define __CAGMRES
+
+#define KSPGMRES_NO_MACROS
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+
+typedef struct {
+  KSPGMRESHEADER
+  PetscInt          s;                 /* number of basis vectors orthogonalized with one reduction */
+  KSPSStepBasisType basis;
+  PetscScalar       *gamma,*theta,*mu; /* recurrence of the basis polynomials */
+  PetscScalar       *Rs;               /* coordinates of the block basis in the orthonormal basis, (max_k+1) x (s+1) */
+  PetscReal         *re,*im;           /* Ritz values */
+} KSP_CAGMRES;
+
+#define HH(a,b)  (cagmres->hh_origin + (b)*(cagmres->max_k+2)+(a))
+/* HH will be size (max_k+2)*(max_k+1)  -  think of HH as
+   being stored columnwise for access purposes. */
+#define HES(a,b) (cagmres->hes_origin + (b)*(cagmres->max_k+1)+(a))
+/* HES will be size (max_k + 1) * (max_k + 1) -
+   again, think of HES as being stored columnwise */
+#define CC(a)    (cagmres->cc_origin + (a)) /* CC will be length (max_k+1) - cosines */
+#define SS(a)    (cagmres->ss_origin + (a)) /* SS will be length (max_k+1) - sines */
+#define RS(a)    (cagmres->rs_origin + (a)) /* RS will be length (max_k+2) - rt side */
+#define RB(a,b)  (cagmres->Rs + (b)*(cagmres->max_k+1)+(a)) /* column b of Rs is the block basis vector b */
+
+/* vector names */
+#define VEC_OFFSET     2
+#define VEC_TEMP       cagmres->vecs[0]               /* work space */
+#define VEC_TEMP_MATOP cagmres->vecs[1]               /* work space */
+#define VEC_VV(i)      cagmres->vecs[VEC_OFFSET+i]    /* use to access
+                                                         othog basis vectors */
+#endif
@@ -104,6 +104,7 @@ PetscErrorCode KSPFGMRESCycle(PetscInt *itcount,KSP ksp)
   PetscInt       loc_it;                /* local count of # of dir. in Krylov space */
   PetscInt       max_k = fgmres->max_k; /* max # of directions Krylov space */
   Mat            Amat,Pmat;
+  PetscBool      normalized = (PetscBool)(fgmres->orthog == KSPGMRESLowSyncGramSchmidtOrthogonalization);
 
   PetscFunctionBegin;
   /* Number of pseudo iterations since last restart is the number
@@ -175,7 +176,10 @@ PetscErrorCode KSPFGMRESCycle(PetscInt *itcount,KSP ksp)
     ierr = (*fgmres->orthog)(ksp,loc_it);CHKERRQ(ierr);
 
     /* new entry in hessenburg is the 2-norm of our new direction */
-    ierr = VecNorm(VEC_VV(loc_it+1),NORM_2,&tt);CHKERRQ(ierr);
+    if (normalized) tt = PetscRealPart(*HES(loc_it+1,loc_it)); /* normalized with the same reduction */
+    else {
+      ierr = VecNorm(VEC_VV(loc_it+1),NORM_2,&tt);CHKERRQ(ierr);
+    }
 
     *HH(loc_it+1,loc_it)  = tt;
     *HES(loc_it+1,loc_it) = tt;
@@ -186,7 +190,7 @@ PetscErrorCode KSPFGMRESCycle(PetscInt *itcount,KSP ksp)
     hapbnd = PetscMin(fgmres->haptol,hapbnd);
     if (tt > hapbnd) {
       /* scale new direction by its norm */
-      ierr = VecScale(VEC_VV(loc_it+1),1.0/tt);CHKERRQ(ierr);
+      if (!normalized) {ierr = VecScale(VEC_VV(loc_it+1),1.0/tt);CHKERRQ(ierr);}
     } else {
       /* This happens when the solution is exactly reached. */
       /* So there is no new direction... */
@@ -640,6 +644,7 @@ PetscErrorCode  KSPGMRESGetRestart_FGMRES(KSP ksp,PetscInt *max_k)
                              vectors are allocated as needed)
 .   -ksp_gmres_classicalgramschmidt - use classical (unmodified) Gram-Schmidt to orthogonalize against the Krylov space (fast) (the default)
 .   -ksp_gmres_modifiedgramschmidt - use modified Gram-Schmidt in the orthogonalization (more stable, but slower)
+.   -ksp_gmres_lowsyncgramschmidt - use classical Gram-Schmidt with lagged normalization and refinement, one global reduction per iteration
 .   -ksp_gmres_cgs_refinement_type <refine_never,refine_ifneeded,refine_always> - determine if iterative refinement is used to increase the
                                    stability of the classical Gram-Schmidt  orthogonalization.
 .   -ksp_gmres_krylov_monitor - plot the Krylov space generated
@@ -661,7 +666,7 @@ PetscErrorCode  KSPGMRESGetRestart_FGMRES(KSP ksp,PetscInt *max_k)
 
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPGMRES, KSPLGMRES,
            KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetOrthogonalization(), KSPGMRESGetOrthogonalization(),
-           KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(),
+           KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESLowSyncGramSchmidtOrthogonalization(),
            KSPGMRESCGSRefinementType, KSPGMRESSetCGSRefinementType(),  KSPGMRESGetCGSRefinementType(), KSPGMRESMonitorKrylov(), KSPFGMRESSetModifyPC(),
            KSPFGMRESModifyPCKSP()
 
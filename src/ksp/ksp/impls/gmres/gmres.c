@@ -29,6 +29,7 @@
  */
 
 #include <../src/ksp/ksp/impls/gmres/gmresimpl.h>       /*I  "petscksp.h"  I*/
+#include <petscblaslapack.h>
 #define GMRES_DELTA_DIRECTIONS 10
 #define GMRES_DEFAULT_MAXK     30
 static PetscErrorCode KSPGMRESUpdateHessenberg(KSP,PetscInt,PetscBool,PetscReal*);
@@ -156,7 +157,10 @@ PetscErrorCode KSPGMRESCycle(PetscInt *itcount,KSP ksp)
     if (ksp->reason) break;
 
     /* vv(i+1) . vv(i+1) */
-    ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    if (gmres->orthog == KSPGMRESLowSyncGramSchmidtOrthogonalization) tt = PetscRealPart(*HES(it+1,it)); /* normalized with the same reduction */
+    else {
+      ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    }
     KSPCheckNorm(ksp,tt);
 
     /* save the magnitude */
@@ -516,6 +520,8 @@ PetscErrorCode KSPView_GMRES(KSP ksp,PetscViewer viewer)
     }
   } else if (gmres->orthog == KSPGMRESModifiedGramSchmidtOrthogonalization) {
     cstr = "Modified Gram-Schmidt Orthogonalization";
+  } else if (gmres->orthog == KSPGMRESLowSyncGramSchmidtOrthogonalization) {
+    cstr = "Low-synchronization classical Gram-Schmidt Orthogonalization with lagged normalization and refinement";
   } else {
     cstr = "unknown orthogonalization";
   }
@@ -590,6 +596,8 @@ PetscErrorCode KSPSetFromOptions_GMRES(PetscOptionItems *PetscOptionsObject,KSP
   if (flg) {ierr = KSPGMRESSetPreAllocateVectors(ksp);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroupBegin("-ksp_gmres_classicalgramschmidt","Classical (unmodified) Gram-Schmidt (fast)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESClassicalGramSchmidtOrthogonalization);CHKERRQ(ierr);}
+  ierr = PetscOptionsBoolGroup("-ksp_gmres_lowsyncgramschmidt","Classical Gram-Schmidt with lagged normalization and refinement (one reduction per iteration)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESLowSyncGramSchmidtOrthogonalization);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroupEnd("-ksp_gmres_modifiedgramschmidt","Modified Gram-Schmidt (slow,more stable)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESModifiedGramSchmidtOrthogonalization);CHKERRQ(ierr);}
   ierr = PetscOptionsEnum("-ksp_gmres_cgs_refinement_type","Type of iterative refinement for classical (unmodified) Gram-Schmidt","KSPGMRESSetCGSRefinementType",
@@ -839,6 +847,213 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_USE_COMPLEX)
+#define KSPGMRES_CONJ_TRANS "C"
+#else
+#define KSPGMRES_CONJ_TRANS "T"
+#endif
+
+/*
+    KSPMatSolve_GMRES - Block GMRES method for the columns of B, used by KSPMatSolve().
+
+    A cycle has m = max(restart/N,2) block iterations, N being the number of columns of B. Each block of N basis vectors
+    is orthogonalized against the previous ones with two passes of block classical Gram-Schmidt, and then within itself
+    with a Cholesky QR factorization. The block Hessenberg matrix is reduced to triangular form by one Householder QR
+    factorization of a 2N x N block per iteration, and the residual norms of the columns of the least squares problem
+    are read from the transformed right-hand sides.
+*/
+static PetscErrorCode KSPMatSolve_GMRES(KSP ksp,Mat B,Mat X)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)ksp->data;
+  PetscErrorCode ierr;
+  Mat            *V,T = NULL,Z;
+  Vec            x,y;
+  PetscScalar    *v,*w,*H,*Hj,*G,*C,*S,*tau,*work,*z,*xa,one = 1.0,mone = -1.0,zero = 0.0;
+  PetscReal      *rnorm0,*rnorm;
+  PetscInt       n,nc,N,m,ld,i,j,k,l,jj,pass,it0;
+  PetscBool      breakdown = PETSC_FALSE;
+  PetscBLASInt   bn,bN,b2N,bk,bld,blwork,info;
+
+  PetscFunctionBegin;
+  ierr = MatGetLocalSize(B,&n,&nc);CHKERRQ(ierr);
+  ierr = MatGetSize(B,NULL,&N);CHKERRQ(ierr);
+  m    = PetscMax(gmres->max_k/N,2);
+  ld   = (m+1)*N;
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(N,&bN);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(2*N,&b2N);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ld,&bld);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(64*N,&blwork);CHKERRQ(ierr);
+  ierr = VecCreateMPIWithArray(PetscObjectComm((PetscObject)B),1,n,PETSC_DECIDE,NULL,&x);CHKERRQ(ierr);
+  ierr = VecCreateMPIWithArray(PetscObjectComm((PetscObject)B),1,n,PETSC_DECIDE,NULL,&y);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n*ld,&v);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m+1,&V);CHKERRQ(ierr);
+  for (j=0; j<=m; j++) {
+    ierr = MatCreateDense(PetscObjectComm((PetscObject)B),n,nc,PETSC_DECIDE,N,v+j*n*N,&V[j]);CHKERRQ(ierr);
+  }
+  ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&Z);CHKERRQ(ierr);
+  ierr = PetscMalloc6(ld*m*N,&H,ld*N,&G,ld*N,&C,N*N,&S,m*N,&tau,64*N,&work);CHKERRQ(ierr);
+  ierr = PetscMalloc2(N,&rnorm0,N,&rnorm);CHKERRQ(ierr);
+
+  ksp->its    = 0;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    /* residual of the current solution, preconditioned for left preconditioning, in the first block of the basis */
+    if (!ksp->its && ksp->guess_zero) {
+      ierr = MatCopy(B,ksp->pc_side == PC_LEFT ? Z : V[0],SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    } else {
+      ierr = KSPMatSolveMatMult_Private(ksp,X,&T,x,y);CHKERRQ(ierr);
+      ierr = MatCopy(B,ksp->pc_side == PC_LEFT ? Z : V[0],SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+      ierr = MatAXPY(ksp->pc_side == PC_LEFT ? Z : V[0],-1.0,T,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    }
+    if (ksp->pc_side == PC_LEFT) {ierr = KSPMatSolvePCApply_Private(ksp,Z,V[0],x,y);CHKERRQ(ierr);}
+
+    /* V_0 S = R, G = [S; 0] */
+    ierr = KSPMatSolveDot_Private(ksp,n,N,v,N,v,S);CHKERRQ(ierr);
+#if defined(PETSC_MISSING_LAPACK_POTRF)
+    SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"POTRF - Lapack routine is unavailable.");
+#else
+    PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&bN,S,&bN,&info));
+#endif
+    if (info) {
+      ierr = PetscInfo1(ksp,"Block of residuals is rank deficient at iteration %D\n",ksp->its);CHKERRQ(ierr);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      break;
+    }
+    if (bn) PetscStackCallBLAS("BLAStrsm",BLAStrsm_("R","U","N","N",&bn,&bN,&one,S,&bN,v,&bn));
+    ierr = PetscMemzero(G,ld*N*sizeof(PetscScalar));CHKERRQ(ierr);
+    for (k=0; k<N; k++) {
+      rnorm[k] = 0.0;
+      for (i=0; i<=k; i++) {
+        G[i+k*ld] = S[i+k*N];
+        rnorm[k] += PetscRealPart(S[i+k*N]*PetscConj(S[i+k*N]));
+      }
+      rnorm[k] = PetscSqrtReal(rnorm[k]);
+      if (!ksp->its) rnorm0[k] = rnorm[k];
+    }
+    it0  = ksp->its;
+    ierr = KSPMatSolveConverged_Private(ksp,it0,N,rnorm0,rnorm);CHKERRQ(ierr);
+    if (ksp->reason) break;
+
+    for (j=0; j<m; j++) {
+      /* W = B^{-1} A V_j or A B^{-1} V_j */
+      if (ksp->pc_side == PC_LEFT) {
+        ierr = KSPMatSolveMatMult_Private(ksp,V[j],&T,x,y);CHKERRQ(ierr);
+        ierr = KSPMatSolvePCApply_Private(ksp,T,V[j+1],x,y);CHKERRQ(ierr);
+      } else {
+        ierr = KSPMatSolvePCApply_Private(ksp,V[j],Z,x,y);CHKERRQ(ierr);
+        ierr = KSPMatSolveMatMult_Private(ksp,Z,&T,x,y);CHKERRQ(ierr);
+        ierr = MatCopy(T,V[j+1],SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+      }
+      ierr = PetscLogEventBegin(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+      w    = v+(j+1)*n*N;
+      Hj   = H+j*N*ld;
+      k    = (j+1)*N;
+      ierr = PetscBLASIntCast(k,&bk);CHKERRQ(ierr);
+      ierr = PetscMemzero(Hj,ld*N*sizeof(PetscScalar));CHKERRQ(ierr);
+      for (pass=0; pass<2; pass++) {
+        ierr = KSPMatSolveDot_Private(ksp,n,k,v,N,w,C);CHKERRQ(ierr);        /* C = V^H W */
+        if (bn) {
+          PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bN,&bk,&mone,v,&bn,C,&bk,&one,w,&bn)); /* W = W - V C */
+          ierr = PetscLogFlops(2.0*n*k*N);CHKERRQ(ierr);
+        }
+        for (l=0; l<N; l++) {
+          for (i=0; i<k; i++) Hj[i+l*ld] += C[i+l*k];
+        }
+      }
+      ierr = KSPMatSolveDot_Private(ksp,n,N,w,N,w,S);CHKERRQ(ierr);         /* W = V_{j+1} S */
+#if !defined(PETSC_MISSING_LAPACK_POTRF)
+      PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&bN,S,&bN,&info));
+#endif
+      if (info) {
+        ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+        ierr = PetscInfo1(ksp,"Block of basis vectors is rank deficient at iteration %D\n",ksp->its);CHKERRQ(ierr);
+        breakdown = PETSC_TRUE;
+        break;
+      }
+      if (bn) {
+        PetscStackCallBLAS("BLAStrsm",BLAStrsm_("R","U","N","N",&bn,&bN,&one,S,&bN,w,&bn));
+        ierr = PetscLogFlops(1.0*n*N*N);CHKERRQ(ierr);
+      }
+      for (l=0; l<N; l++) {
+        for (i=0; i<=l; i++) Hj[k+i+l*ld] = S[i+l*N];
+      }
+      ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+
+      /* apply the previous reflectors to the new block column, reduce it to triangular form and apply its reflectors to G */
+#if defined(PETSC_MISSING_LAPACK_GEQRF) || defined(PETSC_MISSING_LAPACK_ORMQR)
+      SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"GEQRF/ORMQR - Lapack routines are unavailable.");
+#else
+      for (l=0; l<j; l++) {
+        PetscStackCallBLAS("LAPACKormqr",LAPACKormqr_("L",KSPGMRES_CONJ_TRANS,&b2N,&bN,&bN,H+l*N+l*N*ld,&bld,tau+l*N,Hj+l*N,&bld,work,&blwork,&info));
+        if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine XORMQR INFO=%d",(int)info);
+      }
+      PetscStackCallBLAS("LAPACKgeqrf",LAPACKgeqrf_(&b2N,&bN,Hj+j*N,&bld,tau+j*N,work,&blwork,&info));
+      if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine XGEQRF INFO=%d",(int)info);
+      PetscStackCallBLAS("LAPACKormqr",LAPACKormqr_("L",KSPGMRES_CONJ_TRANS,&b2N,&bN,&bN,Hj+j*N,&bld,tau+j*N,G+j*N,&bld,work,&blwork,&info));
+      if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine XORMQR INFO=%d",(int)info);
+#endif
+      for (l=0; l<N; l++) {
+        rnorm[l] = 0.0;
+        for (i=k; i<k+N; i++) rnorm[l] += PetscRealPart(G[i+l*ld]*PetscConj(G[i+l*ld]));
+        rnorm[l] = PetscSqrtReal(rnorm[l]);
+      }
+      ierr = KSPMatSolveConverged_Private(ksp,it0+j+1,N,rnorm0,rnorm);CHKERRQ(ierr);
+      if (ksp->reason) {j++; break;}
+    }
+
+    /* X = X + V_{0..jj-1} Y or X + B^{-1} V_{0..jj-1} Y with R Y = G */
+    jj = j;
+    if (jj) {
+      ierr = PetscBLASIntCast(jj*N,&bk);CHKERRQ(ierr);
+      for (l=0; l<N; l++) {
+        for (i=0; i<jj*N; i++) C[i+l*jj*N] = G[i+l*ld];
+      }
+#if defined(PETSC_MISSING_LAPACK_TRTRS)
+      SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"TRTRS - Lapack routine is unavailable.");
+#else
+      PetscStackCallBLAS("LAPACKtrtrs",LAPACKtrtrs_("U","N","N",&bk,&bN,H,&bld,C,&bk,&info));
+#endif
+      if (info) {
+        ierr = PetscInfo1(ksp,"Block Hessenberg matrix is singular at iteration %D\n",ksp->its);CHKERRQ(ierr);
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        break;
+      }
+      if (ksp->pc_side == PC_LEFT) {
+        if (bn) {
+          ierr = MatDenseGetArray(X,&xa);CHKERRQ(ierr);
+          PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bN,&bk,&one,v,&bn,C,&bk,&one,xa,&bn));
+          ierr = MatDenseRestoreArray(X,&xa);CHKERRQ(ierr);
+        }
+      } else {
+        if (bn) {
+          ierr = MatDenseGetArray(Z,&z);CHKERRQ(ierr);
+          PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bn,&bN,&bk,&one,v,&bn,C,&bk,&zero,z,&bn));
+          ierr = MatDenseRestoreArray(Z,&z);CHKERRQ(ierr);
+        }
+        if (!T) {ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&T);CHKERRQ(ierr);}
+        ierr = KSPMatSolvePCApply_Private(ksp,Z,T,x,y);CHKERRQ(ierr);
+        ierr = MatAXPY(X,1.0,T,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+      }
+      ierr = PetscLogFlops(2.0*n*jj*N*N);CHKERRQ(ierr);
+    }
+    if (breakdown && !ksp->reason) ksp->reason = KSP_DIVERGED_BREAKDOWN;
+  }
+
+  ierr = PetscFree2(rnorm0,rnorm);CHKERRQ(ierr);
+  ierr = PetscFree6(H,G,C,S,tau,work);CHKERRQ(ierr);
+  for (j=0; j<=m; j++) {
+    ierr = MatDestroy(&V[j]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(V);CHKERRQ(ierr);
+  ierr = PetscFree(v);CHKERRQ(ierr);
+  ierr = MatDestroy(&T);CHKERRQ(ierr);
+  ierr = MatDestroy(&Z);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*MC
      KSPGMRES - Implements the Generalized Minimal Residual method.
                 (Saad and Schultz, 1986) with restart
@@ -851,6 +1066,7 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
                              vectors are allocated as needed)
 .   -ksp_gmres_classicalgramschmidt - use classical (unmodified) Gram-Schmidt to orthogonalize against the Krylov space (fast) (the default)
 .   -ksp_gmres_modifiedgramschmidt - use modified Gram-Schmidt in the orthogonalization (more stable, but slower)
+.   -ksp_gmres_lowsyncgramschmidt - use classical Gram-Schmidt with lagged normalization and refinement, one global reduction per iteration
 .   -ksp_gmres_cgs_refinement_type <refine_never,refine_ifneeded,refine_always> - determine if iterative refinement is used to increase the
                                    stability of the classical Gram-Schmidt  orthogonalization.
 -   -ksp_gmres_krylov_monitor - plot the Krylov space generated
@@ -860,14 +1076,18 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
    Notes:
     Left and right preconditioning are supported, but not symmetric preconditioning.
 
+    KSPMatSolve() solves for several right-hand sides at once with a block GMRES method, which applies the operator to blocks of
+    basis vectors with MatMatMult(). With N right-hand sides, a cycle has max(restart/N,2) block iterations so that the basis has
+    about as many vectors as with a single right-hand side.
+
    References:
 .     1. - YOUCEF SAAD AND MARTIN H. SCHULTZ, GMRES: A GENERALIZED MINIMAL RESIDUAL ALGORITHM FOR SOLVING NONSYMMETRIC LINEAR SYSTEMS.
           SIAM J. ScI. STAT. COMPUT. Vo|. 7, No. 3, July 1986.
 
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPFGMRES, KSPLGMRES,
            KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetOrthogonalization(), KSPGMRESGetOrthogonalization(),
-           KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(),
-           KSPGMRESCGSRefinementType, KSPGMRESSetCGSRefinementType(), KSPGMRESGetCGSRefinementType(), KSPGMRESMonitorKrylov(), KSPSetPCSide()
+           KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESLowSyncGramSchmidtOrthogonalization(),
+           KSPGMRESCGSRefinementType, KSPGMRESSetCGSRefinementType(), KSPGMRESGetCGSRefinementType(), KSPGMRESMonitorKrylov(), KSPSetPCSide(), KSPMatSolve()
 
 M*/
 
@@ -889,6 +1109,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_GMRES(KSP ksp)
   ksp->ops->buildsolution                = KSPBuildSolution_GMRES;
   ksp->ops->setup                        = KSPSetUp_GMRES;
   ksp->ops->solve                        = KSPSolve_GMRES;
+  ksp->ops->matsolve                     = KSPMatSolve_GMRES;
   ksp->ops->reset                        = KSPReset_GMRES;
   ksp->ops->destroy                      = KSPDestroy_GMRES;
   ksp->ops->view                         = KSPView_GMRES;
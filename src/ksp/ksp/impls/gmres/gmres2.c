@@ -16,17 +16,21 @@ $   it is one minus the number of GMRES iterations since last restart;
 $    i.e. the size of Krylov space minus one
 
    Notes:
-   Two orthogonalization routines are predefined, including
+   Three orthogonalization routines are predefined, including
 
    KSPGMRESModifiedGramSchmidtOrthogonalization()
 
    KSPGMRESClassicalGramSchmidtOrthogonalization() - Default. Use KSPGMRESSetCGSRefinementType() to determine if
      iterative refinement is used to increase stability.
 
+   KSPGMRESLowSyncGramSchmidtOrthogonalization() - Classical Gram-Schmidt with lagged normalization and refinement, which
+     needs one global reduction per iteration. Only for KSPGMRES and KSPFGMRES.
+
 
    Options Database Keys:
 
 +  -ksp_gmres_classicalgramschmidt - Activates KSPGMRESClassicalGramSchmidtOrthogonalization() (default)
+.  -ksp_gmres_lowsyncgramschmidt - Activates KSPGMRESLowSyncGramSchmidtOrthogonalization()
 -  -ksp_gmres_modifiedgramschmidt - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
 
    Level: intermediate
@@ -34,7 +38,8 @@ $    i.e. the size of Krylov space minus one
 .keywords: KSP, GMRES, set, orthogonalization, Gram-Schmidt, iterative refinement
 
 .seealso: KSPGMRESSetRestart(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetCGSRefinementType(), KSPGMRESSetOrthogonalization(),
-          KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESGetCGSRefinementType()
+          KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESGetCGSRefinementType(),
+          KSPGMRESLowSyncGramSchmidtOrthogonalization()
 @*/
 PetscErrorCode  KSPGMRESSetOrthogonalization(KSP ksp,PetscErrorCode (*fcn)(KSP,PetscInt))
 {
@@ -63,17 +68,21 @@ $   it is one minus the number of GMRES iterations since last restart;
 $    i.e. the size of Krylov space minus one
 
    Notes:
-   Two orthogonalization routines are predefined, including
+   Three orthogonalization routines are predefined, including
 
    KSPGMRESModifiedGramSchmidtOrthogonalization()
 
    KSPGMRESClassicalGramSchmidtOrthogonalization() - Default. Use KSPGMRESSetCGSRefinementType() to determine if
      iterative refinement is used to increase stability.
 
+   KSPGMRESLowSyncGramSchmidtOrthogonalization() - Classical Gram-Schmidt with lagged normalization and refinement, which
+     needs one global reduction per iteration. Only for KSPGMRES and KSPFGMRES.
+
 
    Options Database Keys:
 
 +  -ksp_gmres_classicalgramschmidt - Activates KSPGMRESClassicalGramSchmidtOrthogonalization() (default)
+.  -ksp_gmres_lowsyncgramschmidt - Activates KSPGMRESLowSyncGramSchmidtOrthogonalization()
 -  -ksp_gmres_modifiedgramschmidt - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
 
    Level: intermediate
@@ -81,7 +90,8 @@ $    i.e. the size of Krylov space minus one
 .keywords: KSP, GMRES, set, orthogonalization, Gram-Schmidt, iterative refinement
 
 .seealso: KSPGMRESSetRestart(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetCGSRefinementType(), KSPGMRESSetOrthogonalization(),
-          KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESGetCGSRefinementType()
+          KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESGetCGSRefinementType(),
+          KSPGMRESLowSyncGramSchmidtOrthogonalization()
 @*/
 PetscErrorCode  KSPGMRESGetOrthogonalization(KSP ksp,PetscErrorCode (**fcn)(KSP,PetscInt))
 {
@@ -362,3 +362,97 @@ PetscErrorCode KSPPlotEigenContours_Private(KSP ksp,PetscInt neig,const PetscRea
   ierr = PetscFree3(xloc,yloc,value);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
+
+const char *const KSPSStepBasisTypes[] = {"MONOMIAL","NEWTON","CHEBYSHEV","KSPSStepBasisType","KSP_SSTEP_BASIS_",0};
+
+/*
+   KSPSStepBasisCoefficients_Private - Computes the recurrence M v_k = gamma_k v_{k+1} + theta_k v_k + mu_k v_{k-1},
+   k = 0,...,s-1, generating the basis of an s-step Krylov method from n estimates re + i im of the eigenvalues of M
+
+   The monomial basis is kept when there are no estimates. The Newton basis uses the estimates, in Leja order, as shifts
+   scaled by the radius of the estimated spectrum; in real arithmetic the two shifts of a complex conjugate pair are applied
+   in consecutive steps so that the recurrence stays real. The Chebyshev basis uses the real interval containing the
+   estimates, widened by 10% since Ritz values lie inside the spectrum.
+*/
+PetscErrorCode KSPSStepBasisCoefficients_Private(KSPSStepBasisType type,PetscInt n,const PetscReal *re,const PetscReal *im,PetscInt s,PetscScalar *gamma,PetscScalar *theta,PetscScalar *mu)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,m,*order;
+  PetscReal      rmin,rmax,center,radius,delta,*logprod;
+
+  PetscFunctionBegin;
+  for (k=0; k<s; k++) {
+    gamma[k] = 1.0;
+    theta[k] = 0.0;
+    mu[k]    = 0.0;
+  }
+  if (!n || type == KSP_SSTEP_BASIS_MONOMIAL) PetscFunctionReturn(0);
+  rmin = rmax = re[0];
+  for (i=1; i<n; i++) {
+    rmin = PetscMin(rmin,re[i]);
+    rmax = PetscMax(rmax,re[i]);
+  }
+  center = (rmin+rmax)/2;
+  radius = 0.0;
+  for (i=0; i<n; i++) radius = PetscMax(radius,PetscSqrtReal(PetscSqr(re[i]-center)+PetscSqr(im[i])));
+  if (radius == 0.0) radius = PetscAbsReal(center);
+  if (radius == 0.0) PetscFunctionReturn(0);
+
+  if (type == KSP_SSTEP_BASIS_CHEBYSHEV) {
+    delta = 1.1*(rmax-rmin)/2;
+    if (delta == 0.0) delta = radius;
+    for (k=0; k<s; k++) {
+      theta[k] = center;
+      gamma[k] = k ? delta/2 : delta;
+      mu[k]    = k ? delta/2 : 0.0;
+    }
+    PetscFunctionReturn(0);
+  }
+
+  /* Leja ordering: start from the estimate of largest modulus, then maximize the product of the distances to the
+     estimates already chosen. In real arithmetic only the member of positive imaginary part of a pair is a candidate. */
+  ierr = PetscMalloc2(n,&order,n,&logprod);CHKERRQ(ierr);
+  for (i=0,m=0; i<n; i++) {
+#if !defined(PETSC_USE_COMPLEX)
+    if (im[i] < 0.0) continue;
+#endif
+    order[m]   = i;
+    logprod[m] = 0.5*PetscLogReal(PetscMax(PetscSqr(re[i])+PetscSqr(im[i]),PETSC_MACHINE_EPSILON));
+    m++;
+  }
+  for (k=0; k<m; k++) {
+    PetscInt  c;
+    PetscReal t;
+
+    for (j=k+1,c=k; j<m; j++) if (logprod[j] > logprod[c]) c = j;
+    i = order[c]; order[c] = order[k]; order[k] = i;
+    t = logprod[c]; logprod[c] = logprod[k]; logprod[k] = t;
+    for (j=k+1; j<m; j++) {
+      PetscInt l = order[j];
+
+      if (!k) logprod[j] = 0.0;
+      logprod[j] += 0.5*PetscLogReal(PetscMax(PetscSqr(re[l]-re[i])+PetscSqr(im[l]-im[i]),PETSC_MACHINE_EPSILON*PetscSqr(radius)));
+#if !defined(PETSC_USE_COMPLEX)
+      if (im[i] > 0.0) logprod[j] += 0.5*PetscLogReal(PetscMax(PetscSqr(re[l]-re[i])+PetscSqr(im[l]+im[i]),PETSC_MACHINE_EPSILON*PetscSqr(radius)));
+#endif
+    }
+  }
+
+  /* Cycle through the ordered shifts when there are fewer estimates than steps */
+  for (k=0,j=0; k<s; j=(j+1)%m) {
+    i = order[j];
+    gamma[k] = radius;
+#if !defined(PETSC_USE_COMPLEX)
+    theta[k++] = re[i];
+    if (im[i] > 0.0 && k < s) {
+      gamma[k]   = radius;
+      mu[k]      = -PetscSqr(im[i])/radius;
+      theta[k++] = re[i];
+    }
+#else
+    theta[k++] = re[i] + PETSC_i*im[i];
+#endif
+  }
+  ierr = PetscFree2(order,logprod);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -4,6 +4,8 @@
 */
 
 #include <petsc/private/kspimpl.h>   /*I "petscksp.h" I*/
+#include <petsc/private/pcimpl.h>
+#include <petscblaslapack.h>
 #include <petscdm.h>
 
 PETSC_STATIC_INLINE PetscErrorCode ObjectView(PetscObject obj, PetscViewer viewer, PetscViewerFormat format)
@@ -966,6 +968,282 @@ PetscErrorCode  KSPSolveTranspose(KSP ksp,Vec b,Vec x)
   PetscFunctionReturn(0);
 }
 
+/*
+   KSPMatSolveColumns_Private - Solves for each column of B with KSPSolve(), used by KSP types without a block method
+*/
+PetscErrorCode KSPMatSolveColumns_Private(KSP ksp,Mat B,Mat X)
+{
+  PetscErrorCode     ierr;
+  Vec                b,x;
+  const PetscScalar  *barray;
+  PetscScalar        *xarray;
+  PetscInt           n,N,i,its = 0;
+  KSPConvergedReason reason = KSP_CONVERGED_ITERATING;
+
+  PetscFunctionBegin;
+  ierr = MatGetLocalSize(B,&n,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(B,NULL,&N);CHKERRQ(ierr);
+  ierr = MatCreateVecs(B,NULL,&b);CHKERRQ(ierr);
+  ierr = MatCreateVecs(X,NULL,&x);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(B,&barray);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(X,&xarray);CHKERRQ(ierr);
+  for (i=0; i<N; i++) {
+    ierr = VecPlaceArray(b,barray+i*n);CHKERRQ(ierr);
+    ierr = VecPlaceArray(x,xarray+i*n);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+    ierr = VecResetArray(b);CHKERRQ(ierr);
+    ierr = VecResetArray(x);CHKERRQ(ierr);
+    its = PetscMax(its,ksp->its);
+    if (!reason || (reason > 0 && ksp->reason < 0)) reason = ksp->reason;
+  }
+  ierr = MatDenseRestoreArrayRead(B,&barray);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(X,&xarray);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ksp->its    = its;
+  ksp->reason = N ? reason : KSP_CONVERGED_ATOL;
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPMatSolveMatMult_Private - Computes Y = A X for the operator A of the KSP, with MatMatMult() when A supports products with
+   dense matrices and one MatMult() per column otherwise. Y is created by the first call. x and y are vectors without arrays.
+*/
+PetscErrorCode KSPMatSolveMatMult_Private(KSP ksp,Mat X,Mat *Y,Vec x,Vec y)
+{
+  PetscErrorCode    ierr;
+  Mat               A;
+  PetscErrorCode    (*mult)(Mat,Mat,MatReuse,PetscReal,Mat*) = NULL;
+  char              multname[256];
+  const PetscScalar *xarray;
+  PetscScalar       *yarray;
+  PetscInt          n,N,i;
+
+  PetscFunctionBegin;
+  ierr = PCGetOperators(ksp->pc,&A,NULL);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(multname,sizeof(multname),"MatMatMult_%s_%s_C",((PetscObject)A)->type_name,((PetscObject)X)->type_name);CHKERRQ(ierr);
+  ierr = PetscObjectQueryFunction((PetscObject)X,multname,&mult);CHKERRQ(ierr);
+  if (mult) {
+    ierr = MatMatMult(A,X,*Y ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,PETSC_DEFAULT,Y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (!*Y) {ierr = MatDuplicate(X,MAT_DO_NOT_COPY_VALUES,Y);CHKERRQ(ierr);}
+  ierr = MatGetLocalSize(X,&n,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(X,NULL,&N);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(X,&xarray);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(*Y,&yarray);CHKERRQ(ierr);
+  for (i=0; i<N; i++) {
+    ierr = VecPlaceArray(x,xarray+i*n);CHKERRQ(ierr);
+    ierr = VecPlaceArray(y,yarray+i*n);CHKERRQ(ierr);
+    ierr = MatMult(A,x,y);CHKERRQ(ierr);
+    ierr = VecResetArray(x);CHKERRQ(ierr);
+    ierr = VecResetArray(y);CHKERRQ(ierr);
+  }
+  ierr = MatDenseRestoreArrayRead(X,&xarray);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(*Y,&yarray);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPMatSolvePCApply_Private - Applies the preconditioner to each column of X. x and y are vectors without arrays.
+*/
+PetscErrorCode KSPMatSolvePCApply_Private(KSP ksp,Mat X,Mat Y,Vec x,Vec y)
+{
+  PetscErrorCode    ierr;
+  PetscBool         none;
+  const PetscScalar *xarray;
+  PetscScalar       *yarray;
+  PetscInt          n,N,i;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)ksp->pc,PCNONE,&none);CHKERRQ(ierr);
+  if (none) {
+    ierr = MatCopy(X,Y,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatGetLocalSize(X,&n,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(X,NULL,&N);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(X,&xarray);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(Y,&yarray);CHKERRQ(ierr);
+  for (i=0; i<N; i++) {
+    ierr = VecPlaceArray(x,xarray+i*n);CHKERRQ(ierr);
+    ierr = VecPlaceArray(y,yarray+i*n);CHKERRQ(ierr);
+    ierr = KSP_PCApply(ksp,x,y);CHKERRQ(ierr);
+    ierr = VecResetArray(x);CHKERRQ(ierr);
+    ierr = VecResetArray(y);CHKERRQ(ierr);
+  }
+  ierr = MatDenseRestoreArrayRead(X,&xarray);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(Y,&yarray);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPMatSolveDot_Private - Computes with a single reduction the p x q matrix G = X^H Y of the inner products of the p columns of X and
+   the q columns of Y, whose n local rows are stored by columns
+*/
+PetscErrorCode KSPMatSolveDot_Private(KSP ksp,PetscInt n,PetscInt p,const PetscScalar *X,PetscInt q,const PetscScalar *Y,PetscScalar *G)
+{
+  PetscErrorCode ierr;
+  PetscBLASInt   bn,bp,bq;
+  PetscScalar    one = 1.0,zero = 0.0;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(p,&bp);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(q,&bq);CHKERRQ(ierr);
+  if (bn && bp && bq) {
+    PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bp,&bq,&bn,&one,X,&bn,Y,&bn,&zero,G,&bp));
+    ierr = PetscLogFlops(2.0*n*p*q);CHKERRQ(ierr);
+  } else {
+    ierr = PetscMemzero(G,p*q*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,G,p*q,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPMatSolveConverged_Private - Monitors the largest residual norm of the p columns and sets the converged reason of a block method:
+   every column must satisfy the tolerances with respect to its own initial residual norm
+*/
+PetscErrorCode KSPMatSolveConverged_Private(KSP ksp,PetscInt it,PetscInt p,const PetscReal *rnorm0,const PetscReal *rnorm)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+  PetscReal      rnormmax = 0.0;
+  PetscBool      nan = PETSC_FALSE,atol = PETSC_TRUE,rtol = PETSC_TRUE,dtol = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  for (i=0; i<p; i++) {
+    if (PetscIsInfOrNanReal(rnorm[i])) nan = PETSC_TRUE;
+    else rnormmax = PetscMax(rnormmax,rnorm[i]);
+    if (rnorm[i] >= ksp->abstol) {
+      atol = PETSC_FALSE;
+      if (rnorm[i] > ksp->rtol*rnorm0[i]) rtol = PETSC_FALSE;
+    }
+    if (it && rnorm[i] >= ksp->divtol*rnorm0[i]) dtol = PETSC_TRUE;
+  }
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its   = it;
+  ksp->rnorm = rnormmax;
+  if (!it) ksp->rnorm0 = rnormmax;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,rnormmax);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,it,rnormmax);CHKERRQ(ierr);
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  if (ksp->normtype == KSP_NORM_NONE) {
+    if (it >= ksp->max_it) ksp->reason = KSP_CONVERGED_ITS;
+  } else if (nan) {
+    ierr = PetscInfo(ksp,"Block solver has created a not a number (NaN) as a residual norm, declaring divergence\n");CHKERRQ(ierr);
+    ksp->reason = KSP_DIVERGED_NANORINF;
+  } else if (atol) {
+    ierr = PetscInfo2(ksp,"Block solver has converged. Residual norms are less than absolute tolerance %14.12e at iteration %D\n",(double)ksp->abstol,it);CHKERRQ(ierr);
+    ksp->reason = KSP_CONVERGED_ATOL;
+  } else if (rtol) {
+    ierr = PetscInfo2(ksp,"Block solver has converged. Residual norms are less than relative tolerance %14.12e times initial residual norms at iteration %D\n",(double)ksp->rtol,it);CHKERRQ(ierr);
+    ksp->reason = KSP_CONVERGED_RTOL;
+  } else if (dtol) {
+    ierr = PetscInfo1(ksp,"Block solver is diverging at iteration %D\n",it);CHKERRQ(ierr);
+    ksp->reason = KSP_DIVERGED_DTOL;
+  } else if (it >= ksp->max_it) {
+    ksp->reason = KSP_DIVERGED_ITS;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPMatSolve - Solves a linear system with multiple right-hand sides, stored as the columns of a dense matrix
+
+   Collective on KSP
+
+   Input Parameters:
++  ksp - iterative context obtained from KSPCreate()
+-  B - the block of right-hand sides, a MATSEQDENSE or MATMPIDENSE matrix
+
+   Output Parameter:
+.  X - the block of solutions, a dense matrix with the same layout as B, also the initial guess if KSPSetInitialGuessNonzero() was called
+
+   Notes:
+   KSPCG and KSPGMRES solve all the systems together with a block Krylov method: the operator is applied to all the vectors of a block
+   with a single MatMatMult(), so that it is read from memory once per iteration instead of once per right-hand side, and each block is
+   orthogonalized with a few reductions whatever the number of right-hand sides. The preconditioner is applied to each column.
+
+   The other KSP types, and the cases the block methods do not handle (symmetric preconditioning, null spaces, diagonal scaling, KSPSetPreSolve(),
+   KSPSetPostSolve(), KSPGuess, preconditioners with a PCPreSolve() phase), solve for each column with KSPSolve().
+   So does a block method whose block of vectors becomes rank deficient, starting from the solutions it computed so far.
+
+   For the block methods, KSPMonitor() and the residual history receive the largest residual norm of the columns and a column has converged
+   when its residual norm satisfies the tolerances of KSPSetTolerances() relative to its own initial residual norm; the user convergence
+   test of KSPSetConvergenceTest() is not used. KSPGetIterationNumber() returns the number of block iterations, or the largest number of
+   iterations of the columns when they are solved one at a time.
+
+   Level: intermediate
+
+.keywords: solve, linear system, multiple right-hand sides, block Krylov method
+
+.seealso: KSPSolve(), MatMatMult(), KSPCG, KSPGMRES
+@*/
+PetscErrorCode KSPMatSolve(KSP ksp,Mat B,Mat X)
+{
+  PetscErrorCode ierr;
+  Mat            mat,pmat;
+  MatNullSpace   nullsp,tnullsp;
+  PetscBool      match,block;
+  PetscInt       M,N,m,n,Mx,Nx,mx,nx;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidHeaderSpecific(B,MAT_CLASSID,2);
+  PetscValidHeaderSpecific(X,MAT_CLASSID,3);
+  PetscCheckSameComm(ksp,1,B,2);
+  PetscCheckSameComm(ksp,1,X,3);
+  if (B == X) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_IDN,"B and X must be different matrices");
+  ierr = PetscObjectTypeCompareAny((PetscObject)B,&match,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  if (!match) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_WRONG,"Right-hand sides must be stored in a MATSEQDENSE or MATMPIDENSE matrix");
+  ierr = PetscObjectTypeCompareAny((PetscObject)X,&match,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  if (!match) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_WRONG,"Solutions must be stored in a MATSEQDENSE or MATMPIDENSE matrix");
+  ierr = MatGetSize(B,&M,&N);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(B,&m,&n);CHKERRQ(ierr);
+  ierr = MatGetSize(X,&Mx,&Nx);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(X,&mx,&nx);CHKERRQ(ierr);
+  if (M != Mx || N != Nx || m != mx || n != nx) SETERRQ8(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_SIZ,"B and X have different layouts, (%D,%D) local (%D,%D) and (%D,%D) local (%D,%D)",M,N,m,n,Mx,Nx,mx,nx);
+
+  ksp->transpose_solve = PETSC_FALSE;
+  ierr = PetscLogEventBegin(KSP_MatSolve,ksp,B,X,0);CHKERRQ(ierr);
+  ierr = KSPSetUp(ksp);CHKERRQ(ierr);
+  ierr = KSPSetUpOnBlocks(ksp);CHKERRQ(ierr);
+  ierr = PCGetOperators(ksp->pc,&mat,&pmat);CHKERRQ(ierr);
+  ierr = MatGetNullSpace(pmat,&nullsp);CHKERRQ(ierr);
+  ierr = MatGetTransposeNullSpace(pmat,&tnullsp);CHKERRQ(ierr);
+  block = (PetscBool)(N && ksp->ops->matsolve && ksp->pc_side != PC_SYMMETRIC && !nullsp && !tnullsp && !ksp->dscale && !ksp->guess && !ksp->guess_knoll && !ksp->presolve && !ksp->postsolve && !ksp->pc->ops->presolve && !ksp->pc->ops->postsolve);
+  if (block) {
+    PetscInt  i;
+    PetscBool guess_zero = ksp->guess_zero;
+
+    if (ksp->res_hist_reset) ksp->res_hist_len = 0;
+    if (ksp->guess_zero) {ierr = MatZeroEntries(X);CHKERRQ(ierr);}
+    ksp->reason = KSP_CONVERGED_ITERATING;
+    ierr = (*ksp->ops->matsolve)(ksp,B,X);CHKERRQ(ierr);
+    if (!ksp->reason) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_PLIB,"Internal error, solver returned without setting converged reason");
+    ksp->totalits += ksp->its;
+    if (ksp->reason == KSP_DIVERGED_BREAKDOWN) {
+      i    = ksp->its;
+      ierr = PetscInfo1(ksp,"Breakdown of the block method after %D iterations, solving for each right-hand side\n",i);CHKERRQ(ierr);
+      ksp->guess_zero = PETSC_FALSE;
+      ierr = KSPMatSolveColumns_Private(ksp,B,X);CHKERRQ(ierr);
+      ksp->guess_zero = guess_zero;
+      ksp->its       += i;
+    } else if (ksp->viewReason) {
+      ierr = KSPReasonView_Internal(ksp,ksp->viewerReason,ksp->formatReason);CHKERRQ(ierr);
+    }
+  } else {
+    ierr = KSPMatSolveColumns_Private(ksp,B,X);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(KSP_MatSolve,ksp,B,X,0);CHKERRQ(ierr);
+  if (ksp->view) {ierr = ObjectView((PetscObject)ksp,ksp->viewer,ksp->format);CHKERRQ(ierr);}
+  if (ksp->errorifnotconverged && ksp->reason < 0 && ksp->reason != KSP_DIVERGED_ITS) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"KSPMatSolve has not converged, reason %s",KSPConvergedReasons[ksp->reason]);
+  PetscFunctionReturn(0);
+}
+
 /*@
    KSPResetViewers - Resets all the viewers set from the options database during KSPSetFromOptions()
 
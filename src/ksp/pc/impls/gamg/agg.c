@@ -1109,6 +1109,7 @@ static PetscErrorCode PCGAMGOptProlongator_AGG(PC pc,Mat Amat,Mat *a_P)
   PC             epc;
   PetscReal      alpha, emax, emin;
   PetscRandom    random;
+  PetscBool      isjacobi;
 
   PetscFunctionBegin;
   ierr = PetscObjectGetComm((PetscObject)Amat,&comm);CHKERRQ(ierr);
@@ -1148,6 +1149,12 @@ static PetscErrorCode PCGAMGOptProlongator_AGG(PC pc,Mat Amat,Mat *a_P)
 
     ierr = KSPComputeExtremeSingularValues(eksp, &emax, &emin);CHKERRQ(ierr);
     ierr = PetscInfo3(pc,"Smooth P0: max eigen=%e min=%e PC=%s\n",emax,emin,PCJACOBI);CHKERRQ(ierr);
+    /* keep the estimates for the Chebyshev/Jacobi smoother of this level, unless the estimator was changed from the options */
+    ierr = PetscObjectTypeCompare((PetscObject)epc,PCJACOBI,&isjacobi);CHKERRQ(ierr);
+    if (isjacobi) {
+      pc_gamg->emax[pc_gamg->current_level] = emax;
+      pc_gamg->emin[pc_gamg->current_level] = emin;
+    }
     ierr = VecDestroy(&xx);CHKERRQ(ierr);
     ierr = VecDestroy(&bb);CHKERRQ(ierr);
     ierr = KSPDestroy(&eksp);CHKERRQ(ierr);
@@ -50,7 +50,7 @@
 
 #include <petsc/private/pcimpl.h>   /*I "petscpc.h" I*/
 
-const char *const PCJacobiTypes[]    = {"DIAGONAL","ROWMAX","ROWSUM","PCJacobiType","PC_JACOBI_",0};
+const char *const PCJacobiTypes[]    = {"DIAGONAL","ROWMAX","ROWSUM","ROWL1","PCJacobiType","PC_JACOBI_",0};
 
 /*
    Private context (data structure) for the Jacobi preconditioner.
@@ -62,6 +62,7 @@ typedef struct {
                                     only for symmetric preconditioner application) */
   PetscBool userowmax;           /* set with PCJacobiSetType() */
   PetscBool userowsum;
+  PetscBool userowl1;            /* use the l1 norms of the rows */
   PetscBool useabs;              /* use the absolute values of the diagonal entries */
 } PC_Jacobi;
 
@@ -72,10 +73,13 @@ static PetscErrorCode  PCJacobiSetType_Jacobi(PC pc,PCJacobiType type)
   PetscFunctionBegin;
   j->userowmax = PETSC_FALSE;
   j->userowsum = PETSC_FALSE;
+  j->userowl1  = PETSC_FALSE;
   if (type == PC_JACOBI_ROWMAX) {
     j->userowmax = PETSC_TRUE;
   } else if (type == PC_JACOBI_ROWSUM) {
     j->userowsum = PETSC_TRUE;
+  } else if (type == PC_JACOBI_ROWL1) {
+    j->userowl1 = PETSC_TRUE;
   }
   PetscFunctionReturn(0);
 }
@@ -89,6 +93,8 @@ static PetscErrorCode  PCJacobiGetType_Jacobi(PC pc,PCJacobiType *type)
     *type = PC_JACOBI_ROWMAX;
   } else if (j->userowsum) {
     *type = PC_JACOBI_ROWSUM;
+  } else if (j->userowl1) {
+    *type = PC_JACOBI_ROWL1;
   } else {
     *type = PC_JACOBI_DIAGONAL;
   }
@@ -113,6 +119,32 @@ static PetscErrorCode  PCJacobiGetUseAbs_Jacobi(PC pc,PetscBool *flg)
   PetscFunctionReturn(0);
 }
 
+/*
+   Computes the l1 norms of the local rows, sum_j |a_ij|. By the Gershgorin theorem the eigenvalues of
+   diag(l1 norms)^{-1} A lie in [-1,1], and in (0,1] if A is symmetric positive definite.
+*/
+static PetscErrorCode PCJacobiGetRowL1_Private(Mat A,Vec diag)
+{
+  PetscErrorCode    ierr;
+  PetscInt          i,j,rstart,rend,ncols;
+  const PetscScalar *vals;
+  PetscScalar       *x;
+  PetscReal         sum;
+
+  PetscFunctionBegin;
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  ierr = VecGetArray(diag,&x);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    ierr = MatGetRow(A,i,&ncols,NULL,&vals);CHKERRQ(ierr);
+    sum  = 0.0;
+    for (j=0; j<ncols; j++) sum += PetscAbsScalar(vals[j]);
+    ierr = MatRestoreRow(A,i,&ncols,NULL,&vals);CHKERRQ(ierr);
+    x[i-rstart] = sum;
+  }
+  ierr = VecRestoreArray(diag,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* -------------------------------------------------------------------------- */
 /*
    PCSetUp_Jacobi - Prepares for the use of the Jacobi preconditioner
@@ -166,6 +198,8 @@ static PetscErrorCode PCSetUp_Jacobi(PC pc)
       ierr = MatGetRowMaxAbs(pc->pmat,diag,NULL);CHKERRQ(ierr);
     } else if (jac->userowsum) {
       ierr = MatGetRowSum(pc->pmat,diag);CHKERRQ(ierr);
+    } else if (jac->userowl1) {
+      ierr = PCJacobiGetRowL1_Private(pc->pmat,diag);CHKERRQ(ierr);
     } else {
       ierr = MatGetDiagonal(pc->pmat,diag);CHKERRQ(ierr);
     }
@@ -188,6 +222,8 @@ static PetscErrorCode PCSetUp_Jacobi(PC pc)
       ierr = MatGetRowMaxAbs(pc->pmat,diagsqrt,NULL);CHKERRQ(ierr);
     } else if (jac->userowsum) {
       ierr = MatGetRowSum(pc->pmat,diagsqrt);CHKERRQ(ierr);
+    } else if (jac->userowl1) {
+      ierr = PCJacobiGetRowL1_Private(pc->pmat,diagsqrt);CHKERRQ(ierr);
     } else {
       ierr = MatGetDiagonal(pc->pmat,diagsqrt);CHKERRQ(ierr);
     }
@@ -368,7 +404,7 @@ static PetscErrorCode PCSetFromOptions_Jacobi(PetscOptionItems *PetscOptionsObje
      PCJACOBI - Jacobi (i.e. diagonal scaling preconditioning)
 
    Options Database Key:
-+    -pc_jacobi_type <diagonal,rowmax,rowsum> - approach for forming the preconditioner
++    -pc_jacobi_type <diagonal,rowmax,rowsum,rowl1> - approach for forming the preconditioner
 -    -pc_jacobi_abs - use the absolute value of the diagonal entry
 
    Level: beginner
@@ -381,6 +417,9 @@ static PetscErrorCode PCSetFromOptions_Jacobi(PetscOptionItems *PetscOptionsObje
 
          Zero entries along the diagonal are replaced with the value 1.0
 
+         With -pc_jacobi_type rowl1 the diagonal entries are replaced with the l1 norms of the rows (l1 Jacobi); the eigenvalues
+         of the preconditioned operator are then bounded by one, which KSPCHEBYSHEV uses instead of estimating them
+
          See PCPBJACOBI for a point-block Jacobi preconditioner
 
 .seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC,
@@ -408,6 +447,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_Jacobi(PC pc)
   jac->diagsqrt  = 0;
   jac->userowmax = PETSC_FALSE;
   jac->userowsum = PETSC_FALSE;
+  jac->userowl1  = PETSC_FALSE;
   jac->useabs    = PETSC_FALSE;
 
   /*
@@ -502,16 +542,16 @@ PetscErrorCode  PCJacobiGetUseAbs(PC pc,PetscBool *flg)
 
 /*@
    PCJacobiSetType - Causes the Jacobi preconditioner to use either the diagonal, the maximum entry in each row,
-      of the sum of rows entries for the diagonal preconditioner
+      the sum of rows entries or the l1 norm of each row for the diagonal preconditioner
 
    Logically Collective on PC
 
    Input Parameters:
 +  pc - the preconditioner context
--  type - PC_JACOBI_DIAGONAL, PC_JACOBI_ROWMAX, PC_JACOBI_ROWSUM
+-  type - PC_JACOBI_DIAGONAL, PC_JACOBI_ROWMAX, PC_JACOBI_ROWSUM, PC_JACOBI_ROWL1
 
    Options Database Key:
-.  -pc_jacobi_type <diagonal,rowmax,rowsum>
+.  -pc_jacobi_type <diagonal,rowmax,rowsum,rowl1>
 
    Level: intermediate
 
@@ -538,7 +578,7 @@ PetscErrorCode  PCJacobiSetType(PC pc,PCJacobiType type)
 .  pc - the preconditioner context
 
    Output Parameter:
-.  type - PC_JACOBI_DIAGONAL, PC_JACOBI_ROWMAX, PC_JACOBI_ROWSUM
+.  type - PC_JACOBI_DIAGONAL, PC_JACOBI_ROWMAX, PC_JACOBI_ROWSUM, PC_JACOBI_ROWL1
 
    Level: intermediate
 
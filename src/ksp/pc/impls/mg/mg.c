@@ -580,6 +580,39 @@ PetscErrorCode PCView_MG(PC pc,PetscViewer viewer)
 #include <petsc/private/dmimpl.h>
 #include <petsc/private/kspimpl.h>
 
+/*
+    Passes the estimates of the extreme eigenvalues of D^{-1}A of a level, if any, to a Chebyshev smoother with the Jacobi
+    preconditioner, provided its operator is still the matrix A of the estimates; it then skips its own estimate
+*/
+static PetscErrorCode PCMGSetSmootherEstimates_Private(PC_MG_Levels *mglevel,KSP smoother)
+{
+  PetscErrorCode   ierr;
+  PetscBool        flg;
+  PCJacobiType     jtype;
+  PC               spc;
+  Mat              A,P;
+  PetscObjectId    id;
+  PetscObjectState state;
+
+  PetscFunctionBegin;
+  if (mglevel->emax_DinvA <= 0.0) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)smoother,KSPCHEBYSHEV,&flg);CHKERRQ(ierr);
+  if (!flg) PetscFunctionReturn(0);
+  ierr = KSPGetPC(smoother,&spc);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)spc,PCJACOBI,&flg);CHKERRQ(ierr);
+  if (!flg) PetscFunctionReturn(0);
+  ierr = PCJacobiGetType(spc,&jtype);CHKERRQ(ierr);
+  ierr = PCJacobiGetUseAbs(spc,&flg);CHKERRQ(ierr);
+  if (jtype != PC_JACOBI_DIAGONAL || flg) PetscFunctionReturn(0);
+  ierr = KSPGetOperators(smoother,&A,&P);CHKERRQ(ierr);
+  if (A != P) PetscFunctionReturn(0);
+  ierr = PetscObjectGetId((PetscObject)A,&id);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)A,&state);CHKERRQ(ierr);
+  if (id != mglevel->DinvA_matid || state != mglevel->DinvA_matstate) PetscFunctionReturn(0);
+  ierr = KSPChebyshevEstEigSetEstimates(smoother,mglevel->emax_DinvA,mglevel->emin_DinvA);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
     Calls setup for the KSP on each level
 */
@@ -854,6 +887,7 @@ PetscErrorCode PCSetUp_MG(PC pc)
       /* if doing only down then initial guess is zero */
       ierr = KSPSetInitialGuessNonzero(mglevels[i]->smoothd,PETSC_TRUE);CHKERRQ(ierr);
     }
+    ierr = PCMGSetSmootherEstimates_Private(mglevels[i],mglevels[i]->smoothd);CHKERRQ(ierr);
     if (mglevels[i]->eventsmoothsetup) {ierr = PetscLogEventBegin(mglevels[i]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
     ierr = KSPSetUp(mglevels[i]->smoothd);CHKERRQ(ierr);
     if (mglevels[i]->smoothd->reason == KSP_DIVERGED_PC_FAILED) {
@@ -878,6 +912,7 @@ PetscErrorCode PCSetUp_MG(PC pc)
       }
 
       ierr = KSPSetInitialGuessNonzero(mglevels[i]->smoothu,PETSC_TRUE);CHKERRQ(ierr);
+      ierr = PCMGSetSmootherEstimates_Private(mglevels[i],mglevels[i]->smoothu);CHKERRQ(ierr);
       if (mglevels[i]->eventsmoothsetup) {ierr = PetscLogEventBegin(mglevels[i]->eventsmoothsetup,0,0,0,0);CHKERRQ(ierr);}
       ierr = KSPSetUp(mglevels[i]->smoothu);CHKERRQ(ierr);
       if (mglevels[i]->smoothu->reason == KSP_DIVERGED_PC_FAILED) {
@@ -0,0 +1,161 @@
+static char help[] = "Tests the OpenMP threaded MatMult(), MatMultAdd(), MatMultTranspose() and MatMultTransposeAdd() for MATSEQAIJ.\n\
+  -m <rows> : number of grid points in each direction\n\
+  -bs <bs>  : number of unknowns per grid point, bs > 1 gives inodes\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode FillMatrix(Mat A,PetscInt m,PetscInt bs)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,l,row,col,N = m*m;
+  PetscScalar    v;
+
+  PetscFunctionBeginUser;
+  for (i=0; i<N; i++) {
+    for (k=0; k<bs; k++) {
+      row = i*bs + k;
+      for (l=0; l<bs; l++) {
+        col  = i*bs + l;
+        v    = (k == l) ? 4.0*bs + 1.0/(row+1) : 1.0/(row+col+2);
+        ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);
+        v    = -1.0 - 1.0/(row+l+1);
+        if (i%m > 0)   {col = (i-1)*bs + l; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+        if (i%m < m-1) {col = (i+1)*bs + l; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+        if (i >= m)    {col = (i-m)*bs + l; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+        if (i < N-m)   {col = (i+m)*bs + l; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+      }
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckResult(const char *name,Vec y,Vec yt)
+{
+  PetscErrorCode ierr;
+  PetscReal      norm,err;
+  Vec            d;
+
+  PetscFunctionBeginUser;
+  ierr = VecDuplicate(y,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,y,yt);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_INFINITY,&err);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  if (err > 100.0*PETSC_MACHINE_EPSILON*norm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: norm %g, threaded result differs, error %g\n",name,(double)norm,(double)err);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: norm %g, threaded result agrees\n",name,(double)norm);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B,C;
+  Vec            x,y,z,yt,xt,zt,w,wt;
+  PetscRandom    rdm;
+  PetscInt       m = 10,bs = 1,n,nz;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-bs",&bs,NULL);CHKERRQ(ierr);
+  n    = m*m*bs;
+  nz   = 5*bs;
+
+  /* A is the reference matrix, B has the threaded kernels enabled with the -thr_ prefix */
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n,n,nz,NULL,&A);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatCreate(PETSC_COMM_SELF,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,n,n,n,n);CHKERRQ(ierr);
+  ierr = MatSetOptionsPrefix(B,"thr_");CHKERRQ(ierr);
+  ierr = MatSetType(B,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(B);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(B,nz,NULL);CHKERRQ(ierr);
+  ierr = FillMatrix(A,m,bs);CHKERRQ(ierr);
+  ierr = FillMatrix(B,m,bs);CHKERRQ(ierr);
+
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rdm);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rdm);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&yt);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&xt);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&zt);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&wt);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rdm);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rdm);CHKERRQ(ierr);
+  ierr = VecSetRandom(zt,rdm);CHKERRQ(ierr);
+
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,yt);CHKERRQ(ierr);
+  ierr = CheckResult("MatMult",y,yt);CHKERRQ(ierr);
+
+  ierr = MatMultAdd(A,x,z,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,yt);CHKERRQ(ierr);
+  ierr = CheckResult("MatMultAdd",y,yt);CHKERRQ(ierr);
+
+  /* in-place MatMultAdd() */
+  ierr = VecCopy(z,y);CHKERRQ(ierr);
+  ierr = VecCopy(z,yt);CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,y,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,yt,yt);CHKERRQ(ierr);
+  ierr = CheckResult("MatMultAdd in-place",y,yt);CHKERRQ(ierr);
+
+  ierr = MatMultTranspose(A,y,w);CHKERRQ(ierr);
+  ierr = MatMultTranspose(B,y,wt);CHKERRQ(ierr);
+  ierr = CheckResult("MatMultTranspose",w,wt);CHKERRQ(ierr);
+
+  ierr = MatMultTransposeAdd(A,y,zt,w);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd(B,y,zt,wt);CHKERRQ(ierr);
+  ierr = CheckResult("MatMultTransposeAdd",w,wt);CHKERRQ(ierr);
+
+  /* the duplicate keeps the thread setting; after a new assembly with the same pattern the kernels are still used */
+  ierr = MatDuplicate(B,MAT_COPY_VALUES,&C);CHKERRQ(ierr);
+  ierr = MatScale(C,2.0);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatMult(C,x,yt);CHKERRQ(ierr);
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = VecScale(y,2.0);CHKERRQ(ierr);
+  ierr = CheckResult("MatMult of duplicate",y,yt);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&xt);CHKERRQ(ierr);
+  ierr = VecDestroy(&yt);CHKERRQ(ierr);
+  ierr = VecDestroy(&zt);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = VecDestroy(&wt);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rdm);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&C);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   build:
+      requires: openmp
+
+   test:
+      args: -thr_mat_aij_threads 3 -thr_mat_no_inode -thr_mat_view ::ascii_info
+      filter: grep -v "time imbalance"
+
+   test:
+      suffix: 2
+      args: -bs 3 -thr_mat_aij_threads 4 -thr_mat_view ::ascii_info
+      filter: grep -v "time imbalance"
+
+   test:
+      suffix: 3
+      args: -m 3 -bs 2 -thr_mat_aij_threads 16 -thr_mat_view ::ascii_info
+      filter: grep -v "time imbalance"
+
+TEST*/
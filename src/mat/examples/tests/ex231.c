@@ -0,0 +1,127 @@
+static char help[] = "Tests MatSetOption(A,MAT_USE_HASH_TABLE,PETSC_TRUE) for AIJ matrices assembled without preallocation.\n\
+  -m <m>          : number of grid points in each direction\n\
+  -flush          : do a MAT_FLUSH_ASSEMBLY in the middle of the assembly\n\
+  -column_oriented: pass the element matrices column oriented\n\n";
+
+#include <petscmat.h>
+
+/* adds Q1 element matrices of the Laplacian on an m x m grid, each process adds every size-th element so that many rows are off-process */
+static PetscErrorCode AssembleElements(Mat A,PetscInt m,PetscBool flush)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       e,ex,ey,k,l,idx[4],ne = (m-1)*(m-1);
+  PetscScalar    ke[16];
+
+  PetscFunctionBeginUser;
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)A),&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)A),&size);CHKERRQ(ierr);
+  for (e=rank; e<ne; e+=size) {
+    ex     = e%(m-1);
+    ey     = e/(m-1);
+    idx[0] = ey*m + ex; idx[1] = idx[0] + 1; idx[2] = idx[0] + m + 1; idx[3] = idx[0] + m;
+    for (k=0; k<4; k++) {
+      for (l=0; l<4; l++) ke[4*k+l] = (k == l) ? 4.0 + 1.0/(idx[k]+1) : -1.0 - 1.0/(idx[k]+2*idx[l]+2);
+    }
+    ierr = MatSetValues(A,4,idx,4,idx,ke,ADD_VALUES);CHKERRQ(ierr);
+    if (flush && e < ne/2 && e+size >= ne/2) {
+      ierr = MatAssemblyBegin(A,MAT_FLUSH_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyEnd(A,MAT_FLUSH_ASSEMBLY);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckEqual(Mat A,Mat B,const char *when)
+{
+  PetscErrorCode ierr;
+  Mat            D;
+  PetscReal      norm,err;
+
+  PetscFunctionBeginUser;
+  ierr = MatDuplicate(A,MAT_COPY_VALUES,&D);CHKERRQ(ierr);
+  ierr = MatAXPY(D,-1.0,B,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = MatNorm(D,NORM_FROBENIUS,&err);CHKERRQ(ierr);
+  ierr = MatNorm(A,NORM_FROBENIUS,&norm);CHKERRQ(ierr);
+  if (err > 100.0*PETSC_MACHINE_EPSILON*norm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Matrices assembled with and without the hash table differ %s, error %g\n",when,(double)err);CHKERRQ(ierr);
+  }
+  ierr = MatDestroy(&D);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  MatInfo        info;
+  PetscInt       m = 8,n,rstart,rend,row;
+  PetscScalar    v = 1.0;
+  PetscBool      flush = PETSC_FALSE,colorient = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-flush",&flush,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-column_oriented",&colorient,NULL);CHKERRQ(ierr);
+  n    = m*m;
+
+  /* A is the reference matrix with enough preallocation, B only gets the default preallocation of MatSetUp() */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,n,n,9,NULL,9,NULL,&A);CHKERRQ(ierr);
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,n,n);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(B);CHKERRQ(ierr);
+  ierr = MatSetUp(B);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_USE_HASH_TABLE,PETSC_TRUE);CHKERRQ(ierr);
+  if (colorient) {
+    ierr = MatSetOption(A,MAT_ROW_ORIENTED,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = MatSetOption(B,MAT_ROW_ORIENTED,PETSC_FALSE);CHKERRQ(ierr);
+  }
+  ierr = AssembleElements(A,m,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = AssembleElements(B,m,flush);CHKERRQ(ierr);
+
+  ierr = MatGetInfo(B,MAT_GLOBAL_SUM,&info);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"nonzeros %D allocated %D mallocs %D\n",(PetscInt)info.nz_used,(PetscInt)info.nz_allocated,(PetscInt)info.mallocs);CHKERRQ(ierr);
+  ierr = CheckEqual(A,B,"after the first assembly");CHKERRQ(ierr);
+
+  /* the second assembly goes through the usual path and keeps the nonzero pattern */
+  ierr = MatGetOwnershipRange(B,&rstart,&rend);CHKERRQ(ierr);
+  for (row=rstart; row<rend; row++) {
+    ierr = MatSetValues(A,1,&row,1,&row,&v,ADD_VALUES);CHKERRQ(ierr);
+    ierr = MatSetValues(B,1,&row,1,&row,&v,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = CheckEqual(A,B,"after the second assembly");CHKERRQ(ierr);
+
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -m 8
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -m 8
+
+   test:
+      suffix: 3
+      nsize: 3
+      args: -m 7 -flush -column_oriented
+
+   test:
+      suffix: 4
+      nsize: 2
+      args: -m 5 -flush
+
+TEST*/
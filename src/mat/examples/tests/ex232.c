@@ -0,0 +1,174 @@
+static char help[] = "Tests MatSetPreallocationCOO() and MatSetValuesCOO() for AIJ matrices.\n\
+  -m <m>     : number of grid points in each direction\n\
+  -ignore    : add entries with negative indices, which must be ignored\n\n";
+
+#include <petscmat.h>
+
+/* the COO entries of the Q1 element matrices of an m x m grid, each process takes every size-th element so that many rows are off-process */
+static PetscErrorCode GetElementCOO(MPI_Comm comm,PetscInt m,PetscBool ignore,PetscInt *ncoo,PetscInt **coo_i,PetscInt **coo_j)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       e,ex,ey,k,l,n = 0,idx[4],ne = (m-1)*(m-1);
+
+  PetscFunctionBeginUser;
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = PetscMalloc2(16*ne+2,coo_i,16*ne+2,coo_j);CHKERRQ(ierr);
+  for (e=rank; e<ne; e+=size) {
+    ex     = e%(m-1);
+    ey     = e/(m-1);
+    idx[0] = ey*m + ex; idx[1] = idx[0] + 1; idx[2] = idx[0] + m + 1; idx[3] = idx[0] + m;
+    for (k=0; k<4; k++) {
+      for (l=0; l<4; l++) {(*coo_i)[n] = idx[k]; (*coo_j)[n++] = idx[l];}
+    }
+  }
+  if (ignore) {
+    (*coo_i)[n] = -1;   (*coo_j)[n++] = 0;
+    (*coo_i)[n] = rank; (*coo_j)[n++] = -1;
+  }
+  *ncoo = n;
+  PetscFunctionReturn(0);
+}
+
+/* the values of the entries, given to MatSetValuesCOO() and to MatSetValues() for the reference matrix */
+static PetscScalar EntryValue(PetscInt k,PetscInt i,PetscInt j,PetscReal scale)
+{
+  return scale*((i == j) ? 4.0 + 1.0/(i+1) : -1.0 - 1.0/(i+2*j+2)) + 0.001*(k%7);
+}
+
+static PetscErrorCode CheckEqual(Mat A,Mat B,const char *when)
+{
+  PetscErrorCode ierr;
+  Mat            D;
+  PetscReal      norm,err;
+
+  PetscFunctionBeginUser;
+  ierr = MatDuplicate(A,MAT_COPY_VALUES,&D);CHKERRQ(ierr);
+  ierr = MatAXPY(D,-1.0,B,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = MatNorm(D,NORM_FROBENIUS,&err);CHKERRQ(ierr);
+  ierr = MatNorm(A,NORM_FROBENIUS,&norm);CHKERRQ(ierr);
+  if (err > 100.0*PETSC_MACHINE_EPSILON*norm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Matrices assembled with MatSetValuesCOO() and MatSetValues() differ %s, norm %g error %g\n",when,(double)norm,(double)err);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Matrices assembled with MatSetValuesCOO() and MatSetValues() agree %s, norm %g\n",when,(double)norm);CHKERRQ(ierr);
+  }
+  ierr = MatDestroy(&D);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* a local symmetric SOR sweep with both matrices, it uses the inverse diagonal cached by the previous sweep unless the new values invalidated it */
+static PetscErrorCode CheckSOR(Mat A,Mat B,const char *when)
+{
+  PetscErrorCode ierr;
+  Vec            b,x,xt;
+  PetscReal      norm,err;
+
+  PetscFunctionBeginUser;
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&xt);CHKERRQ(ierr);
+  ierr = VecSet(b,1.0);CHKERRQ(ierr);
+  ierr = MatSOR(A,b,1.0,(MatSORType)(SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,1,1,x);CHKERRQ(ierr);
+  ierr = MatSOR(B,b,1.0,(MatSORType)(SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,1,1,xt);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = VecAXPY(xt,-1.0,x);CHKERRQ(ierr);
+  ierr = VecNorm(xt,NORM_INFINITY,&err);CHKERRQ(ierr);
+  if (err > 100.0*PETSC_MACHINE_EPSILON*norm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"MatSOR() differs %s, norm %g error %g\n",when,(double)norm,(double)err);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"MatSOR() agrees %s, norm %g\n",when,(double)norm);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&xt);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  MatInfo        info;
+  PetscInt       m = 8,n,ncoo,*coo_i,*coo_j,k;
+  PetscScalar    *v;
+  PetscBool      ignore = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-ignore",&ignore,NULL);CHKERRQ(ierr);
+  n    = m*m;
+
+  ierr = GetElementCOO(PETSC_COMM_WORLD,m,ignore,&ncoo,&coo_i,&coo_j);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ncoo,&v);CHKERRQ(ierr);
+
+  /* A is assembled with MatSetValues(), B with MatSetValuesCOO() */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,n,n,9,NULL,9,NULL,&A);CHKERRQ(ierr);
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,n,n);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(B);CHKERRQ(ierr);
+  ierr = MatSetPreallocationCOO(B,ncoo,coo_i,coo_j);CHKERRQ(ierr);
+  ierr = MatGetInfo(B,MAT_GLOBAL_SUM,&info);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"nonzeros %D allocated %D\n",(PetscInt)info.nz_used,(PetscInt)info.nz_allocated);CHKERRQ(ierr);
+
+  for (k=0; k<ncoo; k++) {
+    v[k] = EntryValue(k,coo_i[k],coo_j[k],1.0);
+    if (coo_i[k] >= 0 && coo_j[k] >= 0) {ierr = MatSetValues(A,1,&coo_i[k],1,&coo_j[k],&v[k],ADD_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO(B,v,INSERT_VALUES);CHKERRQ(ierr);
+  ierr = CheckEqual(A,B,"with INSERT_VALUES");CHKERRQ(ierr);
+  ierr = CheckSOR(A,B,"with INSERT_VALUES");CHKERRQ(ierr);
+
+  /* a new set of values added to the previous ones */
+  for (k=0; k<ncoo; k++) {
+    v[k] = EntryValue(k,coo_i[k],coo_j[k],-0.5);
+    if (coo_i[k] >= 0 && coo_j[k] >= 0) {ierr = MatSetValues(A,1,&coo_i[k],1,&coo_j[k],&v[k],ADD_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO(B,v,ADD_VALUES);CHKERRQ(ierr);
+  ierr = CheckEqual(A,B,"with ADD_VALUES");CHKERRQ(ierr);
+  ierr = CheckSOR(A,B,"with ADD_VALUES");CHKERRQ(ierr);
+
+  /* new values inserted over the previous ones */
+  ierr = MatZeroEntries(A);CHKERRQ(ierr);
+  for (k=0; k<ncoo; k++) {
+    v[k] = EntryValue(k,coo_i[k],coo_j[k],2.0);
+    if (coo_i[k] >= 0 && coo_j[k] >= 0) {ierr = MatSetValues(A,1,&coo_i[k],1,&coo_j[k],&v[k],ADD_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO(B,v,INSERT_VALUES);CHKERRQ(ierr);
+  ierr = CheckEqual(A,B,"with INSERT_VALUES again");CHKERRQ(ierr);
+  ierr = CheckSOR(A,B,"with INSERT_VALUES again");CHKERRQ(ierr);
+
+  ierr = PetscFree(v);CHKERRQ(ierr);
+  ierr = PetscFree2(coo_i,coo_j);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -m 8
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -m 8
+
+   test:
+      suffix: 3
+      nsize: 4
+      args: -m 6 -ignore
+
+   test:
+      suffix: 4
+      args: -m 5 -ignore
+
+TEST*/
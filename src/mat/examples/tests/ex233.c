@@ -0,0 +1,115 @@
+static char help[] = "Tests repeated assemblies with off-process entries and -matstash_persistent.\n\
+  -m <m>     : number of grid points in each direction\n\n";
+
+#include <petscmat.h>
+
+/* sets Q1 element matrices on an m x m grid, each process sets every size-th element so that many rows are off-process;
+   with skip >= 0 the elements e with e%5 == skip are left out, which changes the stashed entries */
+static PetscErrorCode AssembleElements(Mat A,PetscInt m,PetscInt skip,PetscReal scale,InsertMode mode)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       e,ex,ey,k,l,idx[4],ne = (m-1)*(m-1);
+  PetscScalar    ke[16];
+
+  PetscFunctionBeginUser;
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)A),&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)A),&size);CHKERRQ(ierr);
+  for (e=rank; e<ne; e+=size) {
+    if (e%5 == skip) continue;
+    ex     = e%(m-1);
+    ey     = e/(m-1);
+    idx[0] = ey*m + ex; idx[1] = idx[0] + 1; idx[2] = idx[0] + m + 1; idx[3] = idx[0] + m;
+    for (k=0; k<4; k++) {
+      for (l=0; l<4; l++) ke[4*k+l] = scale*((k == l) ? 4.0 + 1.0/(idx[k]+1) : -1.0 - 1.0/(idx[k]+2*idx[l]+2));
+    }
+    ierr = MatSetValues(A,4,idx,4,idx,ke,mode);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckEqual(Mat A,Mat B,PetscInt step)
+{
+  PetscErrorCode ierr;
+  Mat            D;
+  PetscReal      norm,err;
+
+  PetscFunctionBeginUser;
+  ierr = MatDuplicate(A,MAT_COPY_VALUES,&D);CHKERRQ(ierr);
+  ierr = MatAXPY(D,-1.0,B,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = MatNorm(D,NORM_FROBENIUS,&err);CHKERRQ(ierr);
+  ierr = MatNorm(A,NORM_FROBENIUS,&norm);CHKERRQ(ierr);
+  if (err > 100.0*PETSC_MACHINE_EPSILON*norm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Step %D: norm %g, error %g\n",step,(double)norm,(double)err);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Step %D: norm %g\n",step,(double)norm);CHKERRQ(ierr);
+  }
+  ierr = MatDestroy(&D);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  PetscInt       m = 8,n,step;
+  /* the skipped elements and the scaling of the assemblies, a change in skip changes the off-process entries */
+  PetscInt       skip[]  = {-1,-1,-1,2,2,-1,-1,-1};
+  PetscReal      scale[] = {1.0,0.5,-2.0,1.5,3.0,0.25,1.0,2.0};
+  InsertMode     mode[]  = {ADD_VALUES,ADD_VALUES,ADD_VALUES,ADD_VALUES,ADD_VALUES,ADD_VALUES,INSERT_VALUES,INSERT_VALUES};
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  n    = m*m;
+
+  /* A uses the default stash, B the persistent one */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,n,n);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSetUp(A);CHKERRQ(ierr);
+  ierr = PetscOptionsSetValue(NULL,"-matstash_persistent","1");CHKERRQ(ierr);
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,n,n);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(B);CHKERRQ(ierr);
+  ierr = MatSetUp(B);CHKERRQ(ierr);
+  ierr = PetscOptionsClearValue(NULL,"-matstash_persistent");CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+
+  for (step=0; step<8; step++) {
+    ierr = AssembleElements(A,m,skip[step],scale[step],mode[step]);CHKERRQ(ierr);
+    ierr = AssembleElements(B,m,skip[step],scale[step],mode[step]);CHKERRQ(ierr);
+    ierr = CheckEqual(A,B,step);CHKERRQ(ierr);
+  }
+
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      nsize: 2
+      args: -m 6
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -m 8
+
+   test:
+      suffix: 3
+      nsize: 4
+      args: -m 7 -mat_type baij
+
+   test:
+      suffix: info
+      nsize: 3
+      args: -m 8 -info
+      filter: grep -e "communication" | sort -b
+
+TEST*/
@@ -0,0 +1,204 @@
+static char help[] = "Compares the SeqBAIJ kernels specialized for the block size with the generic ones selected by -mat_no_unroll.\n\
+  -m <m>         : number of grid points in each direction\n\
+  -bs <bs,...>   : the block sizes to test\n\
+  -timings       : print the time of both variants of each operation\n\
+  -nrep <n>      : number of repetitions of each timed operation\n\n";
+
+#include <petscmat.h>
+#include <petsctime.h>
+
+/* a block 5-point stencil on an m x m grid with dense blocks and diagonally dominant diagonal blocks */
+static PetscErrorCode CreateMatrix(PetscInt m,PetscInt bs,PetscBool nounroll,Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,l,row,col,n = m*m;
+  PetscScalar    *v;
+
+  PetscFunctionBeginUser;
+  if (nounroll) {ierr = PetscOptionsSetValue(NULL,"-mat_no_unroll","1");CHKERRQ(ierr);}
+  ierr = MatCreateSeqBAIJ(PETSC_COMM_SELF,bs,bs*n,bs*n,5,NULL,A);CHKERRQ(ierr);
+  if (nounroll) {ierr = PetscOptionsClearValue(NULL,"-mat_no_unroll");CHKERRQ(ierr);}
+  ierr = PetscMalloc1(bs*bs,&v);CHKERRQ(ierr);
+  for (row=0; row<n; row++) {
+    i = row%m; j = row/m;
+    for (k=0; k<bs; k++) {
+      for (l=0; l<bs; l++) v[k*bs+l] = (k == l) ? 4.0*bs : 1.0/(k+2*l+row%7+2);
+    }
+    ierr = MatSetValuesBlocked(*A,1,&row,1,&row,v,INSERT_VALUES);CHKERRQ(ierr);
+    for (k=0; k<bs*bs; k++) v[k] = -1.0/(k%(bs+1)+row%5+1);
+    if (i > 0)   {col = row-1; ierr = MatSetValuesBlocked(*A,1,&row,1,&col,v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i < m-1) {col = row+1; ierr = MatSetValuesBlocked(*A,1,&row,1,&col,v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j > 0)   {col = row-m; ierr = MatSetValuesBlocked(*A,1,&row,1,&col,v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j < m-1) {col = row+m; ierr = MatSetValuesBlocked(*A,1,&row,1,&col,v,INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = PetscFree(v);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Factor(Mat A,MatFactorType ftype,MatOrderingType otype,PetscBool nounroll,Mat *F)
+{
+  PetscErrorCode ierr;
+  IS             row,col;
+  MatFactorInfo  info;
+
+  PetscFunctionBeginUser;
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.fill = (ftype == MAT_FACTOR_LU) ? 5.0 : 1.0;
+  ierr = MatGetOrdering(A,otype,&row,&col);CHKERRQ(ierr);
+  ierr = MatGetFactor(A,MATSOLVERPETSC,ftype,F);CHKERRQ(ierr);
+  if (nounroll) {ierr = PetscOptionsSetValue(NULL,"-mat_no_unroll","1");CHKERRQ(ierr);}
+  if (ftype == MAT_FACTOR_LU) {ierr = MatLUFactorSymbolic(*F,A,row,col,&info);CHKERRQ(ierr);}
+  else                        {ierr = MatILUFactorSymbolic(*F,A,row,col,&info);CHKERRQ(ierr);}
+  if (nounroll) {ierr = PetscOptionsClearValue(NULL,"-mat_no_unroll");CHKERRQ(ierr);}
+  ierr = MatLUFactorNumeric(*F,A,&info);CHKERRQ(ierr);
+  ierr = ISDestroy(&row);CHKERRQ(ierr);
+  ierr = ISDestroy(&col);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckResult(Vec x,Vec y,PetscInt bs,const char *op)
+{
+  PetscErrorCode ierr;
+  Vec            d;
+  PetscReal      norm,err;
+
+  PetscFunctionBeginUser;
+  ierr = VecDuplicate(x,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,y,x);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_2,&err);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_2,&norm);CHKERRQ(ierr);
+  if (err > 100.0*PETSC_MACHINE_EPSILON*norm) {
+    ierr = PetscPrintf(PETSC_COMM_SELF,"Block size %D: %s norm %g, differs from the generic kernel, error %g\n",bs,op,(double)norm,(double)err);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_SELF,"Block size %D: %s norm %g, agrees with the generic kernel\n",bs,op,(double)norm);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PrintTimings(PetscInt bs,const char *op,PetscLogDouble tspecial,PetscLogDouble tgeneric)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  ierr = PetscPrintf(PETSC_COMM_SELF,"bs %2D %-24s specialized %10.3e s generic %10.3e s speedup %5.2f\n",bs,op,tspecial,tgeneric,tspecial > 0.0 ? tgeneric/tspecial : 0.0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A[2],F[2];
+  Vec            b,x[2],y;
+  PetscInt       m = 6,nrep = 10,bs[16] = {8,9,10,11,12,13,14,15,16},nbs = 9,nmax = 16,i,k,r;
+  PetscBool      timings = PETSC_FALSE,flg;
+  PetscLogDouble t[2],t0;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nrep",&nrep,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetIntArray(NULL,NULL,"-bs",bs,&nmax,&flg);CHKERRQ(ierr);
+  if (flg) nbs = nmax;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-timings",&timings,NULL);CHKERRQ(ierr);
+  if (!timings) nrep = 1;
+
+  for (i=0; i<nbs; i++) {
+    /* A[0] uses the kernels specialized for the block size, A[1] the generic ones */
+    for (k=0; k<2; k++) {ierr = CreateMatrix(m,bs[i],(PetscBool)k,&A[k]);CHKERRQ(ierr);}
+    ierr = MatCreateVecs(A[0],&b,&y);CHKERRQ(ierr);
+    ierr = VecDuplicate(b,&x[0]);CHKERRQ(ierr);
+    ierr = VecDuplicate(b,&x[1]);CHKERRQ(ierr);
+    ierr = VecSetRandom(b,NULL);CHKERRQ(ierr);
+    ierr = VecSetRandom(y,NULL);CHKERRQ(ierr);
+
+    for (k=0; k<2; k++) {
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      for (r=0; r<nrep; r++) {ierr = MatMult(A[k],b,x[k]);CHKERRQ(ierr);}
+      ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+      t[k] = -t0;
+    }
+    ierr = CheckResult(x[0],x[1],bs[i],"MatMult");CHKERRQ(ierr);
+    if (timings) {ierr = PrintTimings(bs[i],"MatMult",t[0],t[1]);CHKERRQ(ierr);}
+
+    for (k=0; k<2; k++) {
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      for (r=0; r<nrep; r++) {ierr = MatMultAdd(A[k],b,y,x[k]);CHKERRQ(ierr);}
+      ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+      t[k] = -t0;
+    }
+    ierr = CheckResult(x[0],x[1],bs[i],"MatMultAdd");CHKERRQ(ierr);
+    if (timings) {ierr = PrintTimings(bs[i],"MatMultAdd",t[0],t[1]);CHKERRQ(ierr);}
+
+    /* ILU(0) in the natural ordering, then LU in a permuted one */
+    for (k=0; k<2; k++) {
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      ierr = Factor(A[k],MAT_FACTOR_ILU,MATORDERINGNATURAL,(PetscBool)k,&F[k]);CHKERRQ(ierr);
+      for (r=1; r<nrep; r++) {ierr = MatLUFactorNumeric(F[k],A[k],NULL);CHKERRQ(ierr);}
+      ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+      t[k] = -t0;
+    }
+    if (timings) {ierr = PrintTimings(bs[i],"ILU(0) factorization",t[0],t[1]);CHKERRQ(ierr);}
+    for (k=0; k<2; k++) {
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      for (r=0; r<nrep; r++) {ierr = MatSolve(F[k],b,x[k]);CHKERRQ(ierr);}
+      ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+      t[k] = -t0;
+      ierr = MatDestroy(&F[k]);CHKERRQ(ierr);
+    }
+    ierr = CheckResult(x[0],x[1],bs[i],"MatSolve after ILU(0)");CHKERRQ(ierr);
+    if (timings) {ierr = PrintTimings(bs[i],"ILU(0) MatSolve",t[0],t[1]);CHKERRQ(ierr);}
+
+    for (k=0; k<2; k++) {
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      ierr = Factor(A[k],MAT_FACTOR_LU,MATORDERINGRCM,(PetscBool)k,&F[k]);CHKERRQ(ierr);
+      for (r=1; r<nrep; r++) {ierr = MatLUFactorNumeric(F[k],A[k],NULL);CHKERRQ(ierr);}
+      ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+      t[k] = -t0;
+    }
+    if (timings) {ierr = PrintTimings(bs[i],"LU factorization",t[0],t[1]);CHKERRQ(ierr);}
+    for (k=0; k<2; k++) {
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      for (r=0; r<nrep; r++) {ierr = MatSolve(F[k],b,x[k]);CHKERRQ(ierr);}
+      ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+      t[k] = -t0;
+      ierr = MatDestroy(&F[k]);CHKERRQ(ierr);
+    }
+    ierr = CheckResult(x[0],x[1],bs[i],"MatSolve after LU");CHKERRQ(ierr);
+    if (timings) {ierr = PrintTimings(bs[i],"LU MatSolve",t[0],t[1]);CHKERRQ(ierr);}
+
+    /* a symmetric sweep from a zero initial guess followed by two with a nonzero one */
+    for (k=0; k<2; k++) {
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      for (r=0; r<nrep; r++) {
+        ierr = MatSOR(A[k],b,1.0,(MatSORType)(SOR_SYMMETRIC_SWEEP|SOR_ZERO_INITIAL_GUESS),0.0,1,1,x[k]);CHKERRQ(ierr);
+        ierr = MatSOR(A[k],b,1.0,SOR_SYMMETRIC_SWEEP,0.0,2,1,x[k]);CHKERRQ(ierr);
+      }
+      ierr = PetscTimeSubtract(&t0);CHKERRQ(ierr);
+      t[k] = -t0;
+    }
+    ierr = CheckResult(x[0],x[1],bs[i],"MatSOR");CHKERRQ(ierr);
+    if (timings) {ierr = PrintTimings(bs[i],"MatSOR",t[0],t[1]);CHKERRQ(ierr);}
+
+    for (k=0; k<2; k++) {
+      ierr = MatDestroy(&A[k]);CHKERRQ(ierr);
+      ierr = VecDestroy(&x[k]);CHKERRQ(ierr);
+    }
+    ierr = VecDestroy(&b);CHKERRQ(ierr);
+    ierr = VecDestroy(&y);CHKERRQ(ierr);
+  }
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -m 5
+
+   test:
+      suffix: 2
+      args: -m 4 -bs 3,7,8,16,17
+
+TEST*/
@@ -0,0 +1,145 @@
+static char help[] = "Tests the level-scheduled triangular solves of SeqAIJ LU and ILU factors.\n\
+  -m <m>         : number of grid points in each direction\n\
+  -dof <dof>     : number of unknowns per grid point\n\
+  -schedule <s>  : level or syncfree\n\
+  -view          : view the schedule of the factors\n\n";
+
+#include <petscmat.h>
+
+/* a convection-diffusion operator on an m x m grid with dof coupled unknowns at each grid point */
+static PetscErrorCode CreateMatrix(PetscInt m,PetscInt dof,Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j,d,e,row,col,n = m*m*dof;
+  PetscScalar    v;
+
+  PetscFunctionBeginUser;
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n,n,5*dof,NULL,A);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(*A);CHKERRQ(ierr);
+  for (i=0; i<m*m; i++) {
+    for (d=0; d<dof; d++) {
+      row = i*dof + d;
+      for (e=0; e<dof; e++) {
+        col  = i*dof + e;
+        v    = (d == e) ? 4.0 + 0.1*d : -0.1/(d+e+1);
+        ierr = MatSetValues(*A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);
+      }
+      j = i%m;
+      if (j > 0)      {col = row - dof;   v = -1.2; ierr = MatSetValues(*A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+      if (j < m-1)    {col = row + dof;   v = -0.8; ierr = MatSetValues(*A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+      if (i >= m)     {col = row - m*dof; v = -1.1; ierr = MatSetValues(*A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+      if (i < m*m-m)  {col = row + m*dof; v = -0.9; ierr = MatSetValues(*A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    }
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* factors A with the serial solves and with the scheduled ones, and compares the solutions of both */
+static PetscErrorCode TestFactor(Mat A,MatFactorType ftype,PetscInt levels,MatOrderingType otype,const char *schedule,PetscBool view,Vec b)
+{
+  PetscErrorCode ierr;
+  Mat            F[2];
+  Vec            x[2];
+  IS             row,col;
+  MatFactorInfo  info;
+  PetscReal      norm,err;
+  PetscInt       k,it;
+  char           name[64];
+
+  PetscFunctionBeginUser;
+  if (ftype == MAT_FACTOR_LU) {ierr = PetscSNPrintf(name,sizeof(name),"LU with %s ordering",otype);CHKERRQ(ierr);}
+  else                        {ierr = PetscSNPrintf(name,sizeof(name),"ILU(%D) with %s ordering",levels,otype);CHKERRQ(ierr);}
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.levels = levels;
+  info.fill   = (ftype == MAT_FACTOR_LU) ? 5.0 : 1.0 + levels;
+  ierr = MatGetOrdering(A,otype,&row,&col);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    ierr = MatGetFactor(A,MATSOLVERPETSC,ftype,&F[k]);CHKERRQ(ierr);
+    if (k) {ierr = PetscOptionsSetValue(NULL,"-mat_aij_solve_schedule",schedule);CHKERRQ(ierr);}
+    if (ftype == MAT_FACTOR_LU) {ierr = MatLUFactorSymbolic(F[k],A,row,col,&info);CHKERRQ(ierr);}
+    else                        {ierr = MatILUFactorSymbolic(F[k],A,row,col,&info);CHKERRQ(ierr);}
+    if (k) {ierr = PetscOptionsClearValue(NULL,"-mat_aij_solve_schedule");CHKERRQ(ierr);}
+    ierr = MatLUFactorNumeric(F[k],A,&info);CHKERRQ(ierr);
+    ierr = VecDuplicate(b,&x[k]);CHKERRQ(ierr);
+  }
+  if (view) {
+    ierr = PetscPrintf(PETSC_COMM_SELF,"%s\n",name);CHKERRQ(ierr);
+    ierr = PetscViewerPushFormat(PETSC_VIEWER_STDOUT_SELF,PETSC_VIEWER_ASCII_INFO);CHKERRQ(ierr);
+    ierr = MatView(F[1],PETSC_VIEWER_STDOUT_SELF);CHKERRQ(ierr);
+    ierr = PetscViewerPopFormat(PETSC_VIEWER_STDOUT_SELF);CHKERRQ(ierr);
+  }
+  /* several solves so that the sync-free stamps of consecutive solves are exercised */
+  for (it=0; it<3; it++) {
+    ierr = VecScale(b,-0.5);CHKERRQ(ierr);
+    for (k=0; k<2; k++) {ierr = MatSolve(F[k],b,x[k]);CHKERRQ(ierr);}
+    ierr = VecNorm(x[0],NORM_2,&norm);CHKERRQ(ierr);
+    ierr = VecAXPY(x[1],-1.0,x[0]);CHKERRQ(ierr);
+    ierr = VecNorm(x[1],NORM_2,&err);CHKERRQ(ierr);
+    if (err > 100.0*PETSC_MACHINE_EPSILON*norm) {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%s: solve %D norm %g, error %g\n",name,it,(double)norm,(double)err);CHKERRQ(ierr);
+    } else {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%s: solve %D norm %g\n",name,it,(double)norm);CHKERRQ(ierr);
+    }
+  }
+  for (k=0; k<2; k++) {
+    ierr = MatDestroy(&F[k]);CHKERRQ(ierr);
+    ierr = VecDestroy(&x[k]);CHKERRQ(ierr);
+  }
+  ierr = ISDestroy(&row);CHKERRQ(ierr);
+  ierr = ISDestroy(&col);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  Vec            b;
+  PetscInt       m = 10,dof = 1;
+  char           schedule[64] = "level";
+  PetscBool      view = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-schedule",schedule,sizeof(schedule),NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-view",&view,NULL);CHKERRQ(ierr);
+
+  ierr = CreateMatrix(m,dof,&A);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&b,NULL);CHKERRQ(ierr);
+  ierr = VecSetRandom(b,NULL);CHKERRQ(ierr);
+
+  ierr = TestFactor(A,MAT_FACTOR_ILU,0,MATORDERINGNATURAL,schedule,view,b);CHKERRQ(ierr);
+  ierr = TestFactor(A,MAT_FACTOR_ILU,2,MATORDERINGNATURAL,schedule,view,b);CHKERRQ(ierr);
+  ierr = TestFactor(A,MAT_FACTOR_ILU,1,MATORDERINGRCM,schedule,view,b);CHKERRQ(ierr);
+  ierr = TestFactor(A,MAT_FACTOR_LU,0,MATORDERINGND,schedule,view,b);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   build:
+      requires: openmp
+
+   test:
+      args: -mat_aij_threads 3 -view
+
+   test:
+      suffix: 2
+      args: -mat_aij_threads 3 -schedule syncfree -view
+
+   test:
+      suffix: 3
+      args: -mat_aij_threads 2 -schedule syncfree -dof 3 -m 7 -view
+
+   test:
+      suffix: 4
+      args: -mat_aij_threads 1 -dof 2 -m 6 -view
+
+TEST*/
@@ -0,0 +1,176 @@
+static char help[] = "Tests the products and MatSOR() of MATAIJSINGLE matrices against those of MATAIJ.\n\
+  -m <m>  : number of grid points in each direction\n\
+  -view   : view the information of the converted matrix\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode CheckResult(const char *name,const char *op,PetscReal norm,PetscReal err)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  if (err > 1.e-5*norm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s norm %g, differs, error %g\n",name,op,(double)norm,(double)err);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s norm %g, agrees\n",name,op,(double)norm);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* compares the products of A and B, which hold the same values in double and single precision respectively */
+static PetscErrorCode CompareProducts(Mat A,Mat B,const char *name)
+{
+  PetscErrorCode ierr;
+  Vec            x,y,z[2],xt,yt,zt[2];
+  PetscReal      norm,err;
+  PetscInt       k;
+
+  PetscFunctionBeginUser;
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&yt,&xt);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,NULL);CHKERRQ(ierr);
+  ierr = VecSetRandom(y,NULL);CHKERRQ(ierr);
+  ierr = VecSetRandom(xt,NULL);CHKERRQ(ierr);
+  ierr = VecSetRandom(yt,NULL);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    ierr = VecDuplicate(y,&z[k]);CHKERRQ(ierr);
+    ierr = VecDuplicate(yt,&zt[k]);CHKERRQ(ierr);
+  }
+
+  ierr = MatMult(A,x,z[0]);CHKERRQ(ierr);
+  ierr = MatMult(B,x,z[1]);CHKERRQ(ierr);
+  ierr = VecNorm(z[0],NORM_2,&norm);CHKERRQ(ierr);
+  ierr = VecAXPY(z[1],-1.0,z[0]);CHKERRQ(ierr);
+  ierr = VecNorm(z[1],NORM_2,&err);CHKERRQ(ierr);
+  ierr = CheckResult(name,"MatMult()",norm,err);CHKERRQ(ierr);
+
+  ierr = MatMultAdd(A,x,y,z[0]);CHKERRQ(ierr);
+  ierr = VecCopy(y,z[1]);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z[1],z[1]);CHKERRQ(ierr);
+  ierr = VecNorm(z[0],NORM_2,&norm);CHKERRQ(ierr);
+  ierr = VecAXPY(z[1],-1.0,z[0]);CHKERRQ(ierr);
+  ierr = VecNorm(z[1],NORM_2,&err);CHKERRQ(ierr);
+  ierr = CheckResult(name,"MatMultAdd()",norm,err);CHKERRQ(ierr);
+
+  ierr = MatMultTranspose(A,yt,zt[0]);CHKERRQ(ierr);
+  ierr = MatMultTranspose(B,yt,zt[1]);CHKERRQ(ierr);
+  ierr = VecNorm(zt[0],NORM_2,&norm);CHKERRQ(ierr);
+  ierr = VecAXPY(zt[1],-1.0,zt[0]);CHKERRQ(ierr);
+  ierr = VecNorm(zt[1],NORM_2,&err);CHKERRQ(ierr);
+  ierr = CheckResult(name,"MatMultTranspose()",norm,err);CHKERRQ(ierr);
+
+  ierr = MatMultTransposeAdd(A,yt,xt,zt[0]);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd(B,yt,xt,zt[1]);CHKERRQ(ierr);
+  ierr = VecNorm(zt[0],NORM_2,&norm);CHKERRQ(ierr);
+  ierr = VecAXPY(zt[1],-1.0,zt[0]);CHKERRQ(ierr);
+  ierr = VecNorm(zt[1],NORM_2,&err);CHKERRQ(ierr);
+  ierr = CheckResult(name,"MatMultTransposeAdd()",norm,err);CHKERRQ(ierr);
+
+  ierr = MatSOR(A,y,1.0,(MatSORType)(SOR_ZERO_INITIAL_GUESS | SOR_LOCAL_SYMMETRIC_SWEEP),0.0,1,1,z[0]);CHKERRQ(ierr);
+  ierr = MatSOR(B,y,1.0,(MatSORType)(SOR_ZERO_INITIAL_GUESS | SOR_LOCAL_SYMMETRIC_SWEEP),0.0,1,1,z[1]);CHKERRQ(ierr);
+  ierr = VecNorm(z[0],NORM_2,&norm);CHKERRQ(ierr);
+  ierr = VecAXPY(z[1],-1.0,z[0]);CHKERRQ(ierr);
+  ierr = VecNorm(z[1],NORM_2,&err);CHKERRQ(ierr);
+  ierr = CheckResult(name,"MatSOR()",norm,err);CHKERRQ(ierr);
+
+  for (k=0; k<2; k++) {
+    ierr = VecDestroy(&z[k]);CHKERRQ(ierr);
+    ierr = VecDestroy(&zt[k]);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&xt);CHKERRQ(ierr);
+  ierr = VecDestroy(&yt);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B,C,D;
+  PetscInt       m = 32,i,j,row,col,rstart,rend;
+  PetscScalar    v;
+  PetscBool      view = PETSC_FALSE,flg;
+  MatInfo        info[2];
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-view",&view,NULL);CHKERRQ(ierr);
+
+  /* a convection-diffusion operator on an m x m grid, with values that are not exact in single precision */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,4,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (row=rstart; row<rend; row++) {
+    i = row/m; j = row%m;
+    v = 4.0 + 1.0/(row+3.0);ierr = MatSetValues(A,1,&row,1,&row,&v,INSERT_VALUES);CHKERRQ(ierr);
+    if (j > 0)   {col = row - 1; v = -1.0 - 1.0/3.0; ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j < m-1) {col = row + 1; v = -2.0/3.0;       ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i > 0)   {col = row - m; v = -1.1;           ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i < m-1) {col = row + m; v = -0.9;           ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatConvert(A,MATAIJSINGLE,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject)B,&flg,MATSEQAIJSINGLE,MATMPIAIJSINGLE,"");CHKERRQ(ierr);
+  if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"MatConvert() did not produce a MATAIJSINGLE matrix\n");CHKERRQ(ierr);}
+  ierr = CompareProducts(A,B,"converted");CHKERRQ(ierr);
+
+  /* the single precision values must follow changes of the values, also when they are set again after the assembly */
+  ierr = MatScale(A,-3.0);CHKERRQ(ierr);
+  ierr = MatScale(B,-3.0);CHKERRQ(ierr);
+  ierr = MatShift(A,1.0);CHKERRQ(ierr);
+  ierr = MatShift(B,1.0);CHKERRQ(ierr);
+  v    = 1.0/7.0;
+  ierr = MatSetValues(A,1,&rstart,1,&rstart,&v,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatSetValues(B,1,&rstart,1,&rstart,&v,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = CompareProducts(A,B,"modified");CHKERRQ(ierr);
+
+  /* the products of a duplicate, and the memory saved by storing the values in single precision only */
+  ierr = MatDuplicate(B,MAT_COPY_VALUES,&C);CHKERRQ(ierr);
+  ierr = MatDuplicate(A,MAT_COPY_VALUES,&D);CHKERRQ(ierr);
+  ierr = MatGetInfo(D,MAT_GLOBAL_SUM,&info[0]);CHKERRQ(ierr);
+  ierr = MatGetInfo(C,MAT_GLOBAL_SUM,&info[1]);CHKERRQ(ierr);
+  ierr = MatDestroy(&D);CHKERRQ(ierr);
+  if (info[1].nz_used != info[0].nz_used) {ierr = PetscPrintf(PETSC_COMM_WORLD,"MatGetInfo() nonzeros differ\n");CHKERRQ(ierr);}
+  if (info[0].memory - info[1].memory < 0.5*(sizeof(PetscScalar)-sizeof(float))*info[0].nz_used) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"MatGetInfo() memory %g, not less than the %g of MATAIJ\n",(double)info[1].memory,(double)info[0].memory);CHKERRQ(ierr);
+  }
+  ierr = CompareProducts(A,C,"duplicated");CHKERRQ(ierr);
+  if (view) {
+    ierr = PetscViewerPushFormat(PETSC_VIEWER_STDOUT_WORLD,PETSC_VIEWER_ASCII_INFO);CHKERRQ(ierr);
+    ierr = MatView(C,PETSC_VIEWER_STDOUT_WORLD);CHKERRQ(ierr);
+    ierr = PetscViewerPopFormat(PETSC_VIEWER_STDOUT_WORLD);CHKERRQ(ierr);
+  }
+  ierr = MatDestroy(&C);CHKERRQ(ierr);
+
+  /* converting back gives a MATAIJ with the rounded values */
+  ierr = MatConvert(B,MATAIJ,MAT_INPLACE_MATRIX,&B);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject)B,&flg,MATSEQAIJ,MATMPIAIJ,"");CHKERRQ(ierr);
+  if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"MatConvert() did not produce a MATAIJ matrix\n");CHKERRQ(ierr);}
+  ierr = CompareProducts(A,B,"converted back");CHKERRQ(ierr);
+
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   build:
+      requires: !complex !single
+
+   test:
+      args: -view
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -m 40
+
+TEST*/
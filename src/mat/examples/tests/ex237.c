@@ -0,0 +1,137 @@
+static char help[] = "Tests the products of AIJ matrices with 16-bit delta encoded column indices.\n\
+  -n <n>     : number of rows\n\
+  -far <d>   : distance of the long range couplings, rows with a gap larger than 65535 are not encoded\n\
+  -view      : view the information of the encoded matrix\n\n";
+
+#include <petscmat.h>
+
+/* a tridiagonal matrix with a long range coupling in every seventh row */
+static PetscErrorCode CreateMatrix(PetscInt n,PetscInt far,Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscInt       row,col,rstart,rend;
+  PetscScalar    v;
+
+  PetscFunctionBeginUser;
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,n,n,4,NULL,4,NULL,A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(*A,&rstart,&rend);CHKERRQ(ierr);
+  for (row=rstart; row<rend; row++) {
+    v = 3.0 + 1.0/(row+1.0); ierr = MatSetValues(*A,1,&row,1,&row,&v,ADD_VALUES);CHKERRQ(ierr);
+    if (row > 0)   {col = row - 1; v = -1.0; ierr = MatSetValues(*A,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);}
+    if (row < n-1) {col = row + 1; v = -0.5; ierr = MatSetValues(*A,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);}
+    if (!(row%7))  {col = (row + far)%n; v = 0.25; ierr = MatSetValues(*A,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckDifference(Vec u,Vec v,const char *name)
+{
+  PetscErrorCode ierr;
+  PetscReal      norm,err;
+
+  PetscFunctionBeginUser;
+  ierr = VecNorm(u,NORM_2,&norm);CHKERRQ(ierr);
+  ierr = VecAXPY(v,-1.0,u);CHKERRQ(ierr);
+  ierr = VecNorm(v,NORM_2,&err);CHKERRQ(ierr);
+  if (err > 100.0*PETSC_MACHINE_EPSILON*norm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s norm %g, differs, error %g\n",name,(double)norm,(double)err);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s norm %g, agrees\n",name,(double)norm);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x,y,z[2],xt,zt[2];
+  PetscInt       n = 1000,far = 400,k;
+  PetscBool      view = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-far",&far,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-view",&view,NULL);CHKERRQ(ierr);
+
+  ierr = CreateMatrix(n,far,&A);CHKERRQ(ierr);
+  ierr = PetscOptionsSetValue(NULL,"-mat_aij_delta_indices","1");CHKERRQ(ierr);
+  ierr = CreateMatrix(n,far,&B);CHKERRQ(ierr);
+  ierr = PetscOptionsClearValue(NULL,"-mat_aij_delta_indices");CHKERRQ(ierr);
+  if (view) {
+    ierr = PetscViewerPushFormat(PETSC_VIEWER_STDOUT_WORLD,PETSC_VIEWER_ASCII_INFO);CHKERRQ(ierr);
+    ierr = MatView(B,PETSC_VIEWER_STDOUT_WORLD);CHKERRQ(ierr);
+    ierr = PetscViewerPopFormat(PETSC_VIEWER_STDOUT_WORLD);CHKERRQ(ierr);
+  }
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&xt,NULL);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,NULL);CHKERRQ(ierr);
+  ierr = VecSetRandom(y,NULL);CHKERRQ(ierr);
+  ierr = VecSetRandom(xt,NULL);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    ierr = VecDuplicate(y,&z[k]);CHKERRQ(ierr);
+    ierr = VecDuplicate(x,&zt[k]);CHKERRQ(ierr);
+  }
+
+  ierr = MatMult(A,x,z[0]);CHKERRQ(ierr);
+  ierr = MatMult(B,x,z[1]);CHKERRQ(ierr);
+  ierr = CheckDifference(z[0],z[1],"MatMult()");CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,y,z[0]);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,y,z[1]);CHKERRQ(ierr);
+  ierr = CheckDifference(z[0],z[1],"MatMultAdd()");CHKERRQ(ierr);
+  ierr = MatMultTranspose(A,y,zt[0]);CHKERRQ(ierr);
+  ierr = MatMultTranspose(B,y,zt[1]);CHKERRQ(ierr);
+  ierr = CheckDifference(zt[0],zt[1],"MatMultTranspose()");CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd(A,y,xt,zt[0]);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd(B,y,xt,zt[1]);CHKERRQ(ierr);
+  ierr = CheckDifference(zt[0],zt[1],"MatMultTransposeAdd()");CHKERRQ(ierr);
+
+  /* new nonzeros change the nonzero structure, the column indices must be encoded again */
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatShift(A,1.0);CHKERRQ(ierr);
+  ierr = MatShift(B,1.0);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    Mat      C = k ? B : A;
+    PetscInt row = n/2,col = 0;
+    PetscScalar v = 2.0;
+
+    ierr = MatSetValues(C,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+  ierr = MatMult(A,x,z[0]);CHKERRQ(ierr);
+  ierr = MatMult(B,x,z[1]);CHKERRQ(ierr);
+  ierr = CheckDifference(z[0],z[1],"MatMult() after new nonzeros");CHKERRQ(ierr);
+
+  for (k=0; k<2; k++) {
+    ierr = VecDestroy(&z[k]);CHKERRQ(ierr);
+    ierr = VecDestroy(&zt[k]);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&xt);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -view
+
+   test:
+      suffix: 2
+      args: -n 80000 -far 70000 -view
+
+   test:
+      suffix: 3
+      nsize: 3
+      args: -n 80000 -far 70000
+
+TEST*/
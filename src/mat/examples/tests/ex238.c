@@ -0,0 +1,91 @@
+static char help[] = "Tests MatNormBegin() and MatNormEnd() combined with the split phase vector reductions.\n\
+  -n <n> : number of rows\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode CheckNorms(Mat A,Vec x,const char *name)
+{
+  PetscErrorCode ierr;
+  NormType       types[3] = {NORM_FROBENIUS,NORM_INFINITY,NORM_1};
+  PetscReal      norm[3],snorm[3],vnorm,svnorm;
+  PetscScalar    dot,sdot;
+  PetscInt       k;
+
+  PetscFunctionBeginUser;
+  for (k=0; k<3; k++) {ierr = MatNorm(A,types[k],&norm[k]);CHKERRQ(ierr);}
+  ierr = VecNorm(x,NORM_2,&vnorm);CHKERRQ(ierr);
+  ierr = VecDot(x,x,&dot);CHKERRQ(ierr);
+
+  ierr = VecNormBegin(x,NORM_2,&svnorm);CHKERRQ(ierr);
+  for (k=0; k<3; k++) {ierr = MatNormBegin(A,types[k],&snorm[k]);CHKERRQ(ierr);}
+  ierr = VecDotBegin(x,x,&sdot);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
+  ierr = VecNormEnd(x,NORM_2,&svnorm);CHKERRQ(ierr);
+  for (k=0; k<3; k++) {ierr = MatNormEnd(A,types[k],&snorm[k]);CHKERRQ(ierr);}
+  ierr = VecDotEnd(x,x,&sdot);CHKERRQ(ierr);
+
+  for (k=0; k<3; k++) {
+    if (PetscAbsReal(norm[k]-snorm[k]) > 100.0*PETSC_MACHINE_EPSILON*norm[k]) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: MatNormBegin() %s norm differs, %g versus %g\n",name,NormTypes[types[k]],(double)norm[k],(double)snorm[k]);CHKERRQ(ierr);
+    } else {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: MatNormBegin() %s norm %g, agrees\n",name,NormTypes[types[k]],(double)norm[k]);CHKERRQ(ierr);
+    }
+  }
+  if (PetscAbsReal(vnorm-svnorm) > 100.0*PETSC_MACHINE_EPSILON*vnorm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: VecNormBegin() differs, %g versus %g\n",name,(double)vnorm,(double)svnorm);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: VecNormBegin() %g, agrees\n",name,(double)vnorm);CHKERRQ(ierr);
+  }
+  if (PetscAbsScalar(dot-sdot) > 100.0*PETSC_MACHINE_EPSILON*PetscAbsScalar(dot)) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: VecDotBegin() differs, %g versus %g\n",name,(double)PetscRealPart(dot),(double)PetscRealPart(sdot));CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: VecDotBegin() %g, agrees\n",name,(double)PetscRealPart(dot));CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x;
+  PetscInt       n = 50,row,col,rstart,rend;
+  PetscScalar    v;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /* a nonsymmetric matrix with couplings between the processes */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,n,n,3,NULL,3,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (row=rstart; row<rend; row++) {
+    v = 2.0 + row%5;ierr = MatSetValues(A,1,&row,1,&row,&v,ADD_VALUES);CHKERRQ(ierr);
+    if (row > 0) {col = row - 1; v = -1.0 - row%3; ierr = MatSetValues(A,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);}
+    col = (row + n/2)%n; v = 0.5; ierr = MatSetValues(A,1,&row,1,&col,&v,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,NULL);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,NULL);CHKERRQ(ierr);
+
+  ierr = CheckNorms(A,x,"AIJ");CHKERRQ(ierr);
+  /* a type without the local norms, whose norms are computed completely in MatNormBegin() */
+  ierr = MatConvert(A,MATDENSE,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = CheckNorms(B,x,"dense");CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 3
+
+TEST*/
@@ -0,0 +1,149 @@
+static char help[] = "Tests the multicolor SOR of SeqAIJ matrices.\n\
+  -m <m>         : number of grid points in each direction\n\
+  -dof <dof>     : number of unknowns per grid point\n\
+  -nt <nt>       : number of threads compared to a single thread\n\
+  -view          : view the coloring\n\n";
+
+#include <petscmat.h>
+
+/* a convection-diffusion operator on an m x m grid with dof unknowns at each grid point, all the unknowns of neighboring
+   grid points are coupled so that the rows of a grid point form an inode */
+static PetscErrorCode CreateMatrix(PetscInt m,PetscInt dof,Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,d,e,row,col,nb[5],n = m*m*dof;
+  PetscScalar    v,w[5] = {4.0,-1.2,-0.8,-1.1,-0.9};
+
+  PetscFunctionBeginUser;
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n,n,5*dof,NULL,A);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(*A);CHKERRQ(ierr);
+  for (i=0; i<m*m; i++) {
+    j     = i%m;
+    nb[0] = i;
+    nb[1] = j > 0     ? i-1 : -1;
+    nb[2] = j < m-1   ? i+1 : -1;
+    nb[3] = i >= m    ? i-m : -1;
+    nb[4] = i < m*m-m ? i+m : -1;
+    for (d=0; d<dof; d++) {
+      row = i*dof + d;
+      for (k=0; k<5; k++) {
+        if (nb[k] < 0) continue;
+        for (e=0; e<dof; e++) {
+          col  = nb[k]*dof + e;
+          v    = (d == e) ? w[k] + 0.1*d*(k == 0) : -0.1/(d+e+k+1);
+          ierr = MatSetValues(*A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);
+        }
+      }
+    }
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* number of SOR iterations needed to reduce the residual norm by 1e-8 */
+static PetscErrorCode SORIterations(Mat A,Vec b,MatSORType flag,PetscReal omega,PetscInt *its)
+{
+  PetscErrorCode ierr;
+  Vec            x,r;
+  PetscReal      bnorm,rnorm;
+
+  PetscFunctionBeginUser;
+  ierr = VecDuplicate(b,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+  ierr = VecNorm(b,NORM_2,&bnorm);CHKERRQ(ierr);
+  flag = (MatSORType)(flag & ~SOR_ZERO_INITIAL_GUESS);
+  ierr = MatSOR(A,b,omega,(MatSORType)(flag | SOR_ZERO_INITIAL_GUESS),0.0,1,1,x);CHKERRQ(ierr);
+  for (*its=1; *its<1000; (*its)++) {
+    ierr = MatResidual(A,b,x,r);CHKERRQ(ierr);
+    ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+    if (rnorm < 1.e-8*bnorm) break;
+    ierr = MatSOR(A,b,omega,flag,0.0,1,1,x);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,C[2];
+  Vec            b,x[2];
+  PetscInt       m = 10,dof = 1,k,f,o,its[2];
+  PetscReal      norm,err,omegas[] = {1.0,1.3};
+  MatSORType     flags[] = {(MatSORType)(SOR_FORWARD_SWEEP | SOR_ZERO_INITIAL_GUESS),SOR_BACKWARD_SWEEP,SOR_SYMMETRIC_SWEEP,SOR_LOCAL_SYMMETRIC_SWEEP};
+  char           nt[16] = "3";
+  PetscBool      view = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-nt",nt,sizeof(nt),NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-view",&view,NULL);CHKERRQ(ierr);
+
+  /* A uses the natural ordering, C[0] and C[1] the multicolor ordering with one and with nt threads */
+  ierr = CreateMatrix(m,dof,&A);CHKERRQ(ierr);
+  ierr = PetscOptionsSetValue(NULL,"-mat_sor_multicolor","1");CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    ierr = PetscOptionsSetValue(NULL,"-mat_aij_threads",k ? nt : "1");CHKERRQ(ierr);
+    ierr = CreateMatrix(m,dof,&C[k]);CHKERRQ(ierr);
+  }
+  ierr = PetscOptionsClearValue(NULL,"-mat_aij_threads");CHKERRQ(ierr);
+  ierr = PetscOptionsClearValue(NULL,"-mat_sor_multicolor");CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&b,NULL);CHKERRQ(ierr);
+  ierr = VecSetRandom(b,NULL);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {ierr = VecDuplicate(b,&x[k]);CHKERRQ(ierr);}
+
+  /* the threads relax the rows in the same order as a single thread */
+  for (f=0; f<4; f++) {
+    for (o=0; o<2; o++) {
+      for (k=0; k<2; k++) {
+        ierr = VecSet(x[k],0.3);CHKERRQ(ierr);
+        ierr = MatSOR(C[k],b,omegas[o],flags[f],0.0,2,1,x[k]);CHKERRQ(ierr);
+      }
+      ierr = VecNorm(x[0],NORM_2,&norm);CHKERRQ(ierr);
+      ierr = VecAXPY(x[1],-1.0,x[0]);CHKERRQ(ierr);
+      ierr = VecNorm(x[1],NORM_2,&err);CHKERRQ(ierr);
+      if (err > 100.0*PETSC_MACHINE_EPSILON*norm) {
+        ierr = PetscPrintf(PETSC_COMM_SELF,"Sweep %D with omega %g: threaded multicolor SOR differs, error %g\n",f,(double)omegas[o],(double)err);CHKERRQ(ierr);
+      }
+    }
+  }
+  if (view) {
+    ierr = PetscViewerPushFormat(PETSC_VIEWER_STDOUT_SELF,PETSC_VIEWER_ASCII_INFO);CHKERRQ(ierr);
+    ierr = MatView(C[0],PETSC_VIEWER_STDOUT_SELF);CHKERRQ(ierr);
+    ierr = PetscViewerPopFormat(PETSC_VIEWER_STDOUT_SELF);CHKERRQ(ierr);
+  }
+
+  /* both orderings converge to the solution */
+  for (f=0; f<3; f++) {
+    ierr = SORIterations(A,b,flags[f],1.0,&its[0]);CHKERRQ(ierr);
+    ierr = SORIterations(C[1],b,flags[f],1.0,&its[1]);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_SELF,"Sweep %D: %D iterations with the natural ordering, %D with the multicolor ordering\n",f,its[0],its[1]);CHKERRQ(ierr);
+  }
+
+  for (k=0; k<2; k++) {
+    ierr = VecDestroy(&x[k]);CHKERRQ(ierr);
+    ierr = MatDestroy(&C[k]);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -view
+
+   test:
+      suffix: 2
+      args: -dof 3 -m 7 -nt 2 -view
+
+   test:
+      suffix: 3
+      args: -m 13 -nt 4 -mat_no_inode
+
+TEST*/
@@ -258,6 +258,11 @@ PetscErrorCode testPTAPRectangular(void)
       args: -B_matmatmult_via llcondensed
       output_file: output/ex93_1.out
 
+   test:
+      suffix: plan
+      args: -A_matptap_via plan
+      output_file: output/ex93_1.out
+
    test:
       suffix: scalable
       args: -B_matmatmult_via scalable
@@ -285,6 +285,11 @@ int main(int argc,char **argv)
       args: -Mx 10 -My 5 -Mz 10
       output_file: output/ex96_1.out
 
+   test:
+      suffix: plan
+      args: -Mx 10 -My 5 -Mz 10 -matptap_via plan
+      output_file: output/ex96_1.out
+
    test:
       suffix: nonscalable
       nsize: 3
@@ -339,6 +344,12 @@ int main(int argc,char **argv)
      args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via scalable -inner_diag_matmatmult_via rowmerge -inner_offdiag_matmatmult_via rowmerge
      output_file: output/ex96_1.out
 
+   test:
+     suffix: plan_mpi
+     nsize: 3
+     args: -Mx 10 -My 5 -Mz 10 -matmatmult_via scalable -matptap_via plan
+     output_file: output/ex96_1.out
+
    test:
      suffix: allatonce
      nsize: 3
@@ -0,0 +1,523 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+
+typedef struct {
+  PetscBool      insert;         /* the blocks have been expanded by MatSetValues() until the next final assembly */
+  struct _MatOps ops;            /* the MATMPIAIJ operations, called with the values of the blocks expanded */
+  PetscErrorCode (*normlocal)(Mat,NormType,PetscReal*);
+  PetscErrorCode (*setvaluescoo)(Mat,const PetscScalar[],InsertMode);
+} Mat_MPIAIJSingle;
+
+/*@C
+   MatCreateMPIAIJSingle - Creates a sparse parallel matrix whose local
+   portions are stored as SEQAIJSINGLE matrices (a matrix class that inherits
+   from SEQAIJ but stores the values of the assembled matrix in single
+   precision only).  The same guidelines that apply to MPIAIJ matrices for
+   preallocating the matrix storage apply here as well.
+
+      Collective on MPI_Comm
+
+   Input Parameters:
++  comm - MPI communicator
+.  m - number of local rows (or PETSC_DECIDE to have calculated if M is given)
+           This value should be the same as the local size used in creating the
+           y vector for the matrix-vector product y = Ax.
+.  n - This value should be the same as the local size used in creating the
+       x vector for the matrix-vector product y = Ax. (or PETSC_DECIDE to have
+       calculated if N is given) For square matrices n is almost always m.
+.  M - number of global rows (or PETSC_DETERMINE to have calculated if m is given)
+.  N - number of global columns (or PETSC_DETERMINE to have calculated if n is given)
+.  d_nz  - number of nonzeros per row in DIAGONAL portion of local submatrix
+           (same value is used for all local rows)
+.  d_nnz - array containing the number of nonzeros in the various rows of the
+           DIAGONAL portion of the local submatrix (possibly different for each row)
+           or NULL, if d_nz is used to specify the nonzero structure.
+           The size of this array is equal to the number of local rows, i.e 'm'.
+           For matrices you plan to factor you must leave room for the diagonal entry and
+           put in the entry even if it is zero.
+.  o_nz  - number of nonzeros per row in the OFF-DIAGONAL portion of local
+           submatrix (same value is used for all local rows).
+-  o_nnz - array containing the number of nonzeros in the various rows of the
+           OFF-DIAGONAL portion of the local submatrix (possibly different for
+           each row) or NULL, if o_nz is used to specify the nonzero
+           structure. The size of this array is equal to the number
+           of local rows, i.e 'm'.
+
+   Output Parameter:
+.  A - the matrix
+
+   Notes:
+   If the *_nnz parameter is given then the *_nz parameter is ignored
+
+   m,n,M,N parameters specify the size of the matrix, and its partitioning across
+   processors, while d_nz,d_nnz,o_nz,o_nnz parameters specify the approximate
+   storage requirements for this matrix.
+
+   If PETSC_DECIDE or PETSC_DETERMINE is used for a particular argument on one
+   processor than it must be used on all processors that share the object for
+   that argument.
+
+   The user MUST specify either the local or global matrix dimensions
+   (possibly both).
+
+   The parallel matrix is partitioned such that the first m0 rows belong to
+   process 0, the next m1 rows belong to process 1, the next m2 rows belong
+   to process 2 etc.. where m0,m1,m2... are the input parameter 'm'.
+
+   The DIAGONAL portion of the local submatrix of a processor can be defined
+   as the submatrix which is obtained by extraction the part corresponding
+   to the rows r1-r2 and columns r1-r2 of the global matrix, where r1 is the
+   first row that belongs to the processor, and r2 is the last row belonging
+   to the this processor. This is a square mxm matrix. The remaining portion
+   of the local submatrix (mxN) constitute the OFF-DIAGONAL portion.
+
+   If o_nnz, d_nnz are specified, then o_nz, and d_nz are ignored.
+
+   When calling this routine with a single process communicator, a matrix of
+   type SEQAIJSINGLE is returned.  If a matrix of type MPIAIJSINGLE is desired
+   for this type of communicator, use the construction mechanism:
+     MatCreate(...,&A); MatSetType(A,MPIAIJSINGLE); MatMPIAIJSetPreallocation(A,...);
+
+   Each nonzero takes sizeof(PetscScalar)-sizeof(float) fewer bytes than with MATMPIAIJ once the matrix is
+   assembled; see MatCreateSeqAIJSingle() for the operations that are supported.
+
+   Options Database Keys:
+.  -mat_aijsingle_int32_indices - in builds with 64-bit indices, also keep a 32-bit copy of the column indices for the products
+
+   Level: intermediate
+
+.keywords: matrix, sparse, parallel
+
+.seealso: MatCreate(), MatCreateSeqAIJSingle(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateMPIAIJSingle(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt M,PetscInt N,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,M,N);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (size > 1) {
+    ierr = MatSetType(*A,MATMPIAIJSINGLE);CHKERRQ(ierr);
+    ierr = MatMPIAIJSetPreallocation(*A,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetType(*A,MATSEQAIJSINGLE);CHKERRQ(ierr);
+    ierr = MatSeqAIJSetPreallocation(*A,d_nz,d_nnz);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatSeqAIJSingleExpand_Private(Mat,PetscBool);
+PETSC_INTERN PetscErrorCode MatSeqAIJSingleRelease_Private(Mat);
+extern PetscErrorCode MatMultDiagonalBlock_MPIAIJ(Mat,Vec,Vec);
+
+/* Expands the values of A, or of both blocks of A if it is a MATMPIAIJSINGLE, see MatSeqAIJSingleExpand_Private() */
+static PetscErrorCode MatMPIAIJSingleExpand_Private(Mat A,PetscBool hold)
+{
+  PetscErrorCode ierr;
+  PetscBool      flg;
+  Mat_MPIAIJ     *a;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATMPIAIJSINGLE,&flg);CHKERRQ(ierr);
+  if (!flg) {
+    ierr = MatSeqAIJSingleExpand_Private(A,hold);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  a = (Mat_MPIAIJ*)A->data;
+  if (a->A) {ierr = MatSeqAIJSingleExpand_Private(a->A,hold);CHKERRQ(ierr);}
+  if (a->B) {ierr = MatSeqAIJSingleExpand_Private(a->B,hold);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMPIAIJSingleRelease_Private(Mat A)
+{
+  PetscErrorCode ierr;
+  PetscBool      flg;
+  Mat_MPIAIJ     *a;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATMPIAIJSINGLE,&flg);CHKERRQ(ierr);
+  if (!flg) {
+    ierr = MatSeqAIJSingleRelease_Private(A);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  a = (Mat_MPIAIJ*)A->data;
+  if (a->A) {ierr = MatSeqAIJSingleRelease_Private(a->A);CHKERRQ(ierr);}
+  if (a->B) {ierr = MatSeqAIJSingleRelease_Private(a->B);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* The MATMPIAIJ operations that read or write the values of the blocks directly, B as in MatSeqAIJSingleCallExpanded() */
+#define MatMPIAIJSingleCallExpanded(A,B,call) \
+  do { \
+    ierr = MatMPIAIJSingleExpand_Private(A,PETSC_TRUE);CHKERRQ(ierr); \
+    if (B) {ierr = MatMPIAIJSingleExpand_Private(B,PETSC_TRUE);CHKERRQ(ierr);} \
+    ierr = call;CHKERRQ(ierr); \
+    ierr = MatMPIAIJSingleRelease_Private(A);CHKERRQ(ierr); \
+    if (B) {ierr = MatMPIAIJSingleRelease_Private(B);CHKERRQ(ierr);} \
+  } while (0)
+
+#define MatMPIAIJSingleOps(A) (((Mat_MPIAIJSingle*)(A)->spptr)->ops)
+
+static PetscErrorCode MatSetValues_MPIAIJSingle(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode is)
+{
+  PetscErrorCode   ierr;
+  Mat_MPIAIJSingle *mpiaijsingle = (Mat_MPIAIJSingle*)A->spptr;
+
+  PetscFunctionBegin;
+  /* MatSetValues_MPIAIJ() inserts into the values of the blocks directly, they stay expanded until the next final assembly */
+  if (!mpiaijsingle->insert) {
+    ierr = MatMPIAIJSingleExpand_Private(A,PETSC_FALSE);CHKERRQ(ierr);
+    mpiaijsingle->insert = PETSC_TRUE;
+  }
+  ierr = MatMPIAIJSingleOps(A).setvalues(A,m,im,n,in,v,is);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_MPIAIJSingle(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode   ierr;
+  Mat_MPIAIJSingle *mpiaijsingle = (Mat_MPIAIJSingle*)A->spptr;
+
+  PetscFunctionBegin;
+  /* the stashed values are inserted with MatSetValues_MPIAIJ(), the blocks are compressed by their own final assembly */
+  if (!mpiaijsingle->insert) {ierr = MatMPIAIJSingleExpand_Private(A,PETSC_FALSE);CHKERRQ(ierr);}
+  mpiaijsingle->insert = PETSC_TRUE;
+  ierr = MatMPIAIJSingleOps(A).assemblyend(A,mode);CHKERRQ(ierr);
+  if (mode == MAT_FINAL_ASSEMBLY) {
+    mpiaijsingle->insert       = PETSC_FALSE;
+    A->ops->multdiagonalblock = NULL;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatTranspose_MPIAIJSingle(Mat A,MatReuse reuse,Mat *B)
+{
+  PetscErrorCode ierr;
+  PetscErrorCode (*transpose)(Mat,MatReuse,Mat*) = MatMPIAIJSingleOps(A).transpose;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INPLACE_MATRIX) {
+    ierr = MatMPIAIJSingleExpand_Private(A,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = (*transpose)(A,reuse,B);CHKERRQ(ierr);
+  } else MatMPIAIJSingleCallExpanded(A,reuse == MAT_REUSE_MATRIX ? *B : NULL,(*transpose)(A,reuse,B));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatNorm_MPIAIJSingle(Mat A,NormType type,PetscReal *norm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatMPIAIJSingleCallExpanded(A,NULL,MatMPIAIJSingleOps(A).norm(A,type,norm));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatNormLocal_MPIAIJSingle(Mat A,NormType type,PetscReal *norm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatMPIAIJSingleCallExpanded(A,NULL,(*((Mat_MPIAIJSingle*)A->spptr)->normlocal)(A,type,norm));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_MPIAIJSingle(Mat A,const PetscScalar v[],InsertMode imode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatMPIAIJSingleCallExpanded(A,NULL,(*((Mat_MPIAIJSingle*)A->spptr)->setvaluescoo)(A,v,imode));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAXPY_MPIAIJSingle(Mat Y,PetscScalar a,Mat X,MatStructure str)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatMPIAIJSingleCallExpanded(Y,X,MatMPIAIJSingleOps(Y).axpy(Y,a,X,str));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCreateSubMatrices_MPIAIJSingle(Mat A,PetscInt n,const IS irow[],const IS icol[],MatReuse scall,Mat *B[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  ierr = MatMPIAIJSingleExpand_Private(A,PETSC_TRUE);CHKERRQ(ierr);
+  if (scall == MAT_REUSE_MATRIX) {
+    for (i=0; i<n; i++) {ierr = MatMPIAIJSingleExpand_Private((*B)[i],PETSC_TRUE);CHKERRQ(ierr);}
+  }
+  ierr = MatMPIAIJSingleOps(A).createsubmatrices(A,n,irow,icol,scall,B);CHKERRQ(ierr);
+  if (scall == MAT_REUSE_MATRIX) {
+    for (i=0; i<n; i++) {ierr = MatMPIAIJSingleRelease_Private((*B)[i]);CHKERRQ(ierr);}
+  }
+  ierr = MatMPIAIJSingleRelease_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCreateSubMatricesMPI_MPIAIJSingle(Mat A,PetscInt n,const IS irow[],const IS icol[],MatReuse scall,Mat *B[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  ierr = MatMPIAIJSingleExpand_Private(A,PETSC_TRUE);CHKERRQ(ierr);
+  if (scall == MAT_REUSE_MATRIX) {
+    for (i=0; i<n; i++) {ierr = MatMPIAIJSingleExpand_Private((*B)[i],PETSC_TRUE);CHKERRQ(ierr);}
+  }
+  ierr = MatMPIAIJSingleOps(A).createsubmatricesmpi(A,n,irow,icol,scall,B);CHKERRQ(ierr);
+  if (scall == MAT_REUSE_MATRIX) {
+    for (i=0; i<n; i++) {ierr = MatMPIAIJSingleRelease_Private((*B)[i]);CHKERRQ(ierr);}
+  }
+  ierr = MatMPIAIJSingleRelease_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCreateSubMatrix_MPIAIJSingle(Mat A,IS isrow,IS iscol,MatReuse call,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  MatMPIAIJSingleCallExpanded(A,call == MAT_REUSE_MATRIX ? *newmat : NULL,MatMPIAIJSingleOps(A).createsubmatrix(A,isrow,iscol,call,newmat));
+  /* some of the MATMPIAIJ algorithms assemble the submatrix from its blocks as a MATMPIAIJ */
+  if (call == MAT_INITIAL_MATRIX) {
+    ierr = PetscObjectTypeCompare((PetscObject)*newmat,MATMPIAIJ,&flg);CHKERRQ(ierr);
+    if (flg) {ierr = MatConvert(*newmat,MATMPIAIJSINGLE,MAT_INPLACE_MATRIX,newmat);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatZeroRowsColumns_MPIAIJSingle(Mat A,PetscInt N,const PetscInt rows[],PetscScalar diag,Vec x,Vec b)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatMPIAIJSingleCallExpanded(A,NULL,MatMPIAIJSingleOps(A).zerorowscolumns(A,N,rows,diag,x,b));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesRow_MPIAIJSingle(Mat A,PetscInt row,const PetscScalar v[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatMPIAIJSingleCallExpanded(A,NULL,MatMPIAIJSingleOps(A).setvaluesrow(A,row,v));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetMultiProcBlock_MPIAIJSingle(Mat A,MPI_Comm subComm,MatReuse scall,Mat *subMat)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatMPIAIJSingleCallExpanded(A,scall == MAT_REUSE_MATRIX ? *subMat : NULL,MatMPIAIJSingleOps(A).getmultiprocblock(A,subComm,scall,subMat));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatFindNonzeroRows_MPIAIJSingle(Mat A,IS *keptrows)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatMPIAIJSingleCallExpanded(A,NULL,MatMPIAIJSingleOps(A).findnonzerorows(A,keptrows));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetColumnNorms_MPIAIJSingle(Mat A,NormType type,PetscReal *norms)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatMPIAIJSingleCallExpanded(A,NULL,MatMPIAIJSingleOps(A).getcolumnnorms(A,type,norms));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatView_MPIAIJSingle(Mat A,PetscViewer viewer)
+{
+  PetscErrorCode    ierr;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+  if (iascii && (format == PETSC_VIEWER_ASCII_INFO || format == PETSC_VIEWER_ASCII_INFO_DETAIL)) {
+    ierr = MatMPIAIJSingleOps(A).view(A,viewer);CHKERRQ(ierr);
+  } else MatMPIAIJSingleCallExpanded(A,NULL,MatMPIAIJSingleOps(A).view(A,viewer));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_MPIAIJSingle(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_mpiaijsingle_mpiaij_C",NULL);CHKERRQ(ierr);
+  ierr = MatDestroy_MPIAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMPIAIJSetPreallocation_MPIAIJSingle(Mat B,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[])
+{
+  Mat_MPIAIJ     *b = (Mat_MPIAIJ*)B->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMPIAIJSetPreallocation_MPIAIJ(B,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJSingle(b->A, MATSEQAIJSINGLE, MAT_INPLACE_MATRIX, &b->A);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJSingle(b->B, MATSEQAIJSINGLE, MAT_INPLACE_MATRIX, &b->B);CHKERRQ(ierr);
+  ((Mat_MPIAIJSingle*)B->spptr)->insert = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatConvert_MPIAIJSingle_MPIAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode   ierr;
+  Mat              B = *newmat;
+  Mat_MPIAIJ       *b;
+  Mat_MPIAIJSingle *mpiaijsingle;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  b            = (Mat_MPIAIJ*)B->data;
+  mpiaijsingle = (Mat_MPIAIJSingle*)B->spptr;
+
+  /* the blocks are converted back to MATSEQAIJ, which moves their values back into double precision */
+  if (b->A) {ierr = MatConvert(b->A,MATSEQAIJ,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);}
+  if (b->B) {ierr = MatConvert(b->B,MATSEQAIJ,MAT_INPLACE_MATRIX,&b->B);CHKERRQ(ierr);}
+
+  *B->ops = mpiaijsingle->ops;
+  if (B->assembled && ((Mat_SeqAIJ*)b->A->data)->inode.size) B->ops->multdiagonalblock = MatMultDiagonalBlock_MPIAIJ;
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatNormLocal_C",mpiaijsingle->normlocal);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",mpiaijsingle->setvaluescoo);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaijsingle_mpiaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIAIJ);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSingle(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode   ierr;
+  Mat              B = *newmat;
+  Mat_MPIAIJSingle *mpiaijsingle;
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_COMPLEX)
+  SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"MATMPIAIJSINGLE is not supported for complex numbers");
+#endif
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+
+  ierr              = PetscNewLog(B,&mpiaijsingle);CHKERRQ(ierr);
+  B->spptr          = (void*)mpiaijsingle;
+  mpiaijsingle->ops = *B->ops;
+
+  /* if B is already preallocated its diagonal and off-diagonal blocks are converted as well */
+  if (B->preallocated) {
+    Mat_MPIAIJ *b = (Mat_MPIAIJ*)B->data;
+
+    ierr = MatConvert_SeqAIJ_SeqAIJSingle(b->A,MATSEQAIJSINGLE,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);
+    ierr = MatConvert_SeqAIJ_SeqAIJSingle(b->B,MATSEQAIJSINGLE,MAT_INPLACE_MATRIX,&b->B);CHKERRQ(ierr);
+  }
+
+  B->ops->setvalues            = MatSetValues_MPIAIJSingle;
+  B->ops->assemblyend          = MatAssemblyEnd_MPIAIJSingle;
+  B->ops->transpose            = MatTranspose_MPIAIJSingle;
+  B->ops->norm                 = MatNorm_MPIAIJSingle;
+  B->ops->axpy                 = MatAXPY_MPIAIJSingle;
+  B->ops->createsubmatrices    = MatCreateSubMatrices_MPIAIJSingle;
+  B->ops->createsubmatricesmpi = MatCreateSubMatricesMPI_MPIAIJSingle;
+  B->ops->createsubmatrix      = MatCreateSubMatrix_MPIAIJSingle;
+  B->ops->zerorowscolumns      = MatZeroRowsColumns_MPIAIJSingle;
+  B->ops->setvaluesrow         = MatSetValuesRow_MPIAIJSingle;
+  B->ops->getmultiprocblock    = MatGetMultiProcBlock_MPIAIJSingle;
+  B->ops->findnonzerorows      = MatFindNonzeroRows_MPIAIJSingle;
+  B->ops->getcolumnnorms       = MatGetColumnNorms_MPIAIJSingle;
+  B->ops->view                 = MatView_MPIAIJSingle;
+  B->ops->destroy              = MatDestroy_MPIAIJSingle;
+  B->ops->multdiagonalblock    = NULL;
+
+  /* as for MATSEQAIJSINGLE the products with other matrices and the finite difference colorings are not supported */
+  B->ops->matmult                  = NULL;
+  B->ops->matmultsymbolic          = NULL;
+  B->ops->matmultnumeric           = NULL;
+  B->ops->ptap                     = NULL;
+  B->ops->ptapsymbolic             = NULL;
+  B->ops->ptapnumeric              = NULL;
+  B->ops->mattransposemult         = NULL;
+  B->ops->mattransposemultsymbolic = NULL;
+  B->ops->mattransposemultnumeric  = NULL;
+  B->ops->transposematmult         = NULL;
+  B->ops->transposematmultsymbolic = NULL;
+  B->ops->transposematmultnumeric  = NULL;
+  B->ops->matmatmult               = NULL;
+  B->ops->matmatmultsymbolic       = NULL;
+  B->ops->matmatmultnumeric        = NULL;
+  B->ops->rart                     = NULL;
+  B->ops->rartsymbolic             = NULL;
+  B->ops->rartnumeric              = NULL;
+  B->ops->fdcoloringcreate         = NULL;
+  B->ops->fdcoloringsetup          = NULL;
+  B->ops->fdcoloringapply          = NULL;
+
+  ierr = PetscObjectQueryFunction((PetscObject)B,"MatNormLocal_C",&mpiaijsingle->normlocal);CHKERRQ(ierr);
+  ierr = PetscObjectQueryFunction((PetscObject)B,"MatSetValuesCOO_C",&mpiaijsingle->setvaluescoo);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatNormLocal_C",MatNormLocal_MPIAIJSingle);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_MPIAIJSingle);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJSingle);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaijsingle_mpiaij_C",MatConvert_MPIAIJSingle_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIAIJSINGLE);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJSingle(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATMPIAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_MPIAIJ_MPIAIJSingle(A,MATMPIAIJSINGLE,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATAIJSINGLE - MATAIJSINGLE = "aijsingle" - A matrix type for sparse matrices whose values are stored in single precision.
+
+   This matrix type is identical to MATSEQAIJSINGLE when constructed with a single process communicator,
+   and MATMPIAIJSINGLE otherwise.  As a result, for single process communicators,
+   MatSeqAIJSetPreallocation() is supported, and similarly MatMPIAIJSetPreallocation() is supported
+   for communicators controlling multiple processes.  It is recommended that you call both of
+   the above preallocation routines for simplicity.
+
+   Once the matrix is assembled only single precision values are kept, so each nonzero takes
+   sizeof(PetscScalar)-sizeof(float) fewer bytes than with MATAIJ. The matrix-vector products, MatSOR(),
+   MatGetRow() and MatGetDiagonal() read the single precision values and accumulate in double precision.
+   Other operations, such as the factorizations from MatGetFactor(), MatView() or MatTranspose(), expand the
+   values to double precision while they run. The products with other matrices (MatMatMult(), MatPtAP(), ...)
+   and MatFDColoring are not supported, and complex numbers are not supported.
+
+   Options Database Keys:
++ -mat_type aijsingle - sets the matrix type to "AIJSINGLE" during a call to MatSetFromOptions()
+- -mat_aijsingle_int32_indices - in builds with 64-bit indices, also keep a 32-bit copy of the column indices for the products
+
+  Level: intermediate
+
+.seealso: MatCreateMPIAIJSingle(), MatCreateSeqAIJSingle(), MATSEQAIJSINGLE, MATMPIAIJSINGLE
+M*/
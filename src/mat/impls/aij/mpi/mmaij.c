@@ -193,6 +193,7 @@ PetscErrorCode MatDisAssemble_MPIAIJ(Mat A)
   if (Baij->nonew >= 0) { /* Inherit insertion error options (if positive). */
     ((Mat_SeqAIJ*)Bnew->data)->nonew = Baij->nonew;
   }
+  ((Mat_SeqAIJ*)Bnew->data)->delta.use = Baij->delta.use;
 
   /*
    Ensure that B's nonzerostate is monotonically increasing.
@@ -1215,6 +1215,8 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   PetscLogObjectState((PetscObject)mat,"Rows=%D, Cols=%D",mat->rmap->N,mat->cmap->N);
 #endif
   ierr = MatStashDestroy_Private(&mat->stash);CHKERRQ(ierr);
+  ierr = MatAIJHashDestroy_Private(mat,&aij->hash);CHKERRQ(ierr);
+  ierr = MatResetPreallocationCOO_MPIAIJ(mat);CHKERRQ(ierr);
   ierr = VecDestroy(&aij->diag);CHKERRQ(ierr);
   ierr = MatDestroy(&aij->A);CHKERRQ(ierr);
   ierr = MatDestroy(&aij->B);CHKERRQ(ierr);
@@ -1236,8 +1238,11 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatRetrieveValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatIsTranspose_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIAIJSetPreallocation_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatNormLocal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatResetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatDiagonalScaleLocal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatConvert_mpiaij_mpisbaij_C",NULL);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_ELEMENTAL)
@@ -1823,6 +1828,9 @@ PetscErrorCode MatSetOption_MPIAIJ(Mat A,MatOption op,PetscBool flg)
   case MAT_IGNORE_OFF_PROC_ENTRIES:
     a->donotstash = flg;
     break;
+  case MAT_USE_HASH_TABLE:
+    ierr = MatSetOption_MPIAIJ_Hash(A,flg);CHKERRQ(ierr);
+    break;
   /* Symmetry flags are handled directly by MatSetOption() and they don't affect preallocation */
   case MAT_SPD:
   case MAT_SYMMETRIC:
@@ -1930,12 +1938,57 @@ PetscErrorCode MatRestoreRow_MPIAIJ(Mat mat,PetscInt row,PetscInt *nz,PetscInt *
   PetscFunctionReturn(0);
 }
 
+/*
+   The local part of the Frobenius norm (the sum of the squares) or of the infinity norm (the max of the local row sums),
+   also used by MatNormBegin() to combine the reduction with other split phase reductions
+*/
+static PetscErrorCode MatNormLocal_MPIAIJ(Mat mat,NormType type,PetscReal *lnorm)
+{
+  Mat_MPIAIJ     *aij  = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ     *amat = (Mat_SeqAIJ*)aij->A->data,*bmat = (Mat_SeqAIJ*)aij->B->data;
+  PetscErrorCode ierr;
+  PetscInt       i,j;
+  PetscReal      sum = 0.0;
+  MatScalar      *v;
+
+  PetscFunctionBegin;
+  if (type == NORM_FROBENIUS) {
+    v = amat->a;
+    for (i=0; i<amat->nz; i++) {
+      sum += PetscRealPart(PetscConj(*v)*(*v)); v++;
+    }
+    v = bmat->a;
+    for (i=0; i<bmat->nz; i++) {
+      sum += PetscRealPart(PetscConj(*v)*(*v)); v++;
+    }
+    *lnorm = sum;
+    ierr   = PetscLogFlops(2*amat->nz+2*bmat->nz);CHKERRQ(ierr);
+  } else if (type == NORM_INFINITY) { /* max row norm */
+    PetscReal ntemp = 0.0;
+    for (j=0; j<aij->A->rmap->n; j++) {
+      v   = amat->a + amat->i[j];
+      sum = 0.0;
+      for (i=0; i<amat->i[j+1]-amat->i[j]; i++) {
+        sum += PetscAbsScalar(*v); v++;
+      }
+      v = bmat->a + bmat->i[j];
+      for (i=0; i<bmat->i[j+1]-bmat->i[j]; i++) {
+        sum += PetscAbsScalar(*v); v++;
+      }
+      if (sum > ntemp) ntemp = sum;
+    }
+    *lnorm = ntemp;
+    ierr   = PetscLogFlops(PetscMax(amat->nz+bmat->nz-1,0));CHKERRQ(ierr);
+  } else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Only for the Frobenius and infinity norms");
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatNorm_MPIAIJ(Mat mat,NormType type,PetscReal *norm)
 {
   Mat_MPIAIJ     *aij  = (Mat_MPIAIJ*)mat->data;
   Mat_SeqAIJ     *amat = (Mat_SeqAIJ*)aij->A->data,*bmat = (Mat_SeqAIJ*)aij->B->data;
   PetscErrorCode ierr;
-  PetscInt       i,j,cstart = mat->cmap->rstart;
+  PetscInt       j,cstart = mat->cmap->rstart;
   PetscReal      sum = 0.0;
   MatScalar      *v;
 
@@ -1944,17 +1997,9 @@ PetscErrorCode MatNorm_MPIAIJ(Mat mat,NormType type,PetscReal *norm)
     ierr =  MatNorm(aij->A,type,norm);CHKERRQ(ierr);
   } else {
     if (type == NORM_FROBENIUS) {
-      v = amat->a;
-      for (i=0; i<amat->nz; i++) {
-        sum += PetscRealPart(PetscConj(*v)*(*v)); v++;
-      }
-      v = bmat->a;
-      for (i=0; i<bmat->nz; i++) {
-        sum += PetscRealPart(PetscConj(*v)*(*v)); v++;
-      }
+      ierr  = MatNormLocal_MPIAIJ(mat,type,&sum);CHKERRQ(ierr);
       ierr  = MPIU_Allreduce(&sum,norm,1,MPIU_REAL,MPIU_SUM,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
       *norm = PetscSqrtReal(*norm);
-      ierr = PetscLogFlops(2*amat->nz+2*bmat->nz);CHKERRQ(ierr);
     } else if (type == NORM_1) { /* max column norm */
       PetscReal *tmp,*tmp2;
       PetscInt  *jj,*garray = aij->garray;
@@ -1977,21 +2022,8 @@ PetscErrorCode MatNorm_MPIAIJ(Mat mat,NormType type,PetscReal *norm)
       ierr = PetscFree(tmp2);CHKERRQ(ierr);
       ierr = PetscLogFlops(PetscMax(amat->nz+bmat->nz-1,0));CHKERRQ(ierr);
     } else if (type == NORM_INFINITY) { /* max row norm */
-      PetscReal ntemp = 0.0;
-      for (j=0; j<aij->A->rmap->n; j++) {
-        v   = amat->a + amat->i[j];
-        sum = 0.0;
-        for (i=0; i<amat->i[j+1]-amat->i[j]; i++) {
-          sum += PetscAbsScalar(*v); v++;
-        }
-        v = bmat->a + bmat->i[j];
-        for (i=0; i<bmat->i[j+1]-bmat->i[j]; i++) {
-          sum += PetscAbsScalar(*v); v++;
-        }
-        if (sum > ntemp) ntemp = sum;
-      }
-      ierr = MPIU_Allreduce(&ntemp,norm,1,MPIU_REAL,MPIU_MAX,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
-      ierr = PetscLogFlops(PetscMax(amat->nz+bmat->nz-1,0));CHKERRQ(ierr);
+      ierr = MatNormLocal_MPIAIJ(mat,type,&sum);CHKERRQ(ierr);
+      ierr = MPIU_Allreduce(&sum,norm,1,MPIU_REAL,MPIU_MAX,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
     } else SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_SUP,"No support for two norm");
   }
   PetscFunctionReturn(0);
@@ -3493,7 +3525,8 @@ PetscErrorCode MatCreateMPIAIJWithSeqAIJ(MPI_Comm comm,Mat A,Mat B,const PetscIn
   Mat_MPIAIJ     *maij;
   Mat_SeqAIJ     *b=(Mat_SeqAIJ*)B->data,*bnew;
   PetscInt       *oi=b->i,*oj=b->j,i,nz,col;
-  PetscScalar    *oa=b->a;
+  PetscScalar    *oa;
+  PetscBool      singlemalloc;
   Mat            Bnew;
   PetscInt       m,n,N;
 
@@ -3527,7 +3560,9 @@ PetscErrorCode MatCreateMPIAIJWithSeqAIJ(MPI_Comm comm,Mat A,Mat B,const PetscIn
     oj[i] = garray[col];
   }
 
-   /* Set Bnew as off-diagonal portion of *mat */
+   /* Set Bnew as off-diagonal portion of *mat; the values are taken with MatSeqAIJGetArray() since subclasses such as
+      MATSEQAIJSINGLE do not keep them in b->a, they are not restored since B is destroyed below */
+  ierr = MatSeqAIJGetArray(B,&oa);CHKERRQ(ierr);
   ierr = MatCreateSeqAIJWithArrays(PETSC_COMM_SELF,m,N,oi,oj,oa,&Bnew);CHKERRQ(ierr);
   bnew        = (Mat_SeqAIJ*)Bnew->data;
   bnew->maxnz = b->maxnz; /* allocated nonzeros of B */
@@ -3535,12 +3570,13 @@ PetscErrorCode MatCreateMPIAIJWithSeqAIJ(MPI_Comm comm,Mat A,Mat B,const PetscIn
 
   if (B->rmap->N != Bnew->rmap->N) SETERRQ2(PETSC_COMM_SELF,0,"BN %d != BnewN %d",B->rmap->N,Bnew->rmap->N);
 
+  singlemalloc    = b->singlemalloc;
   b->singlemalloc = PETSC_FALSE; /* B arrays are shared by Bnew */
   b->free_a       = PETSC_FALSE;
   b->free_ij      = PETSC_FALSE;
   ierr = MatDestroy(&B);CHKERRQ(ierr);
 
-  bnew->singlemalloc = PETSC_TRUE; /* arrays will be freed by MatDestroy(&Bnew) */
+  bnew->singlemalloc = singlemalloc; /* arrays will be freed by MatDestroy(&Bnew) */
   bnew->free_a       = PETSC_TRUE;
   bnew->free_ij      = PETSC_TRUE;
 
@@ -3961,6 +3997,227 @@ PetscErrorCode MatMPIAIJSetPreallocationCSR_MPIAIJ(Mat B,const PetscInt Ii[],con
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode MatResetPreallocationCOO_MPIAIJ(Mat mat)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFDestroy(&aij->coo_sf);CHKERRQ(ierr);
+  ierr = PetscFree(aij->coo_rbuf);CHKERRQ(ierr);
+  ierr = PetscFree4(aij->Ajmap1,aij->Aperm1,aij->Ajmap2,aij->Aperm2);CHKERRQ(ierr);
+  ierr = PetscFree4(aij->Bjmap1,aij->Bperm1,aij->Bjmap2,aij->Bperm2);CHKERRQ(ierr);
+  aij->coo_n     = 0;
+  aij->coo_nrecv = 0;
+  aij->Annz      = 0;
+  aij->Bnnz      = 0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   The entries of rows owned by other processes are the leaves of aij->coo_sf, they point directly into the coo_i, coo_j
+   and value arrays of the user. The roots are the receive buffer of the owner, filled by increasing sender rank.
+   On the owner the local and received entries are sorted together and repeated ones merged; the entries of each
+   nonzero of the diagonal (A) and off-diagonal (B) blocks are then split into local ones, indexing the user
+   values, and received ones, indexing aij->coo_rbuf, so that the local sums overlap the communication.
+*/
+static PetscErrorCode MatSetPreallocationCOO_MPIAIJ(Mat mat,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  MPI_Comm       comm;
+  PetscMPIInt    nto = 0,nfrom,nreply,*toranks,*fromranks,*replyranks;
+  PetscInt       k,t,u,r,m,rstart,rend,cstart,cend,ntot,nremote = 0,nrecv = 0,start,nz = 0;
+  PetscInt       *rowner,*ridx,*tocounts,*fromcounts,*fromoffsets,*replyoffsets;
+  PetscInt       *i,*j,*perm,*rbuf_i,*rbuf_j,*ci,*cj,*jmap;
+  PetscInt       Annz = 0,Bnnz = 0,An1 = 0,An2 = 0,Bn1 = 0,Bn2 = 0;
+  PetscBool      diag;
+  PetscSFNode    *iremote;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr   = MatResetPreallocationCOO_MPIAIJ(mat);CHKERRQ(ierr);
+  ierr   = PetscObjectGetComm((PetscObject)mat,&comm);CHKERRQ(ierr);
+  ierr   = PetscLayoutSetUp(mat->rmap);CHKERRQ(ierr);
+  ierr   = PetscLayoutSetUp(mat->cmap);CHKERRQ(ierr);
+  m      = mat->rmap->n;
+  rstart = mat->rmap->rstart;
+  rend   = mat->rmap->rend;
+  cstart = mat->cmap->rstart;
+  cend   = mat->cmap->rend;
+
+  /* the off-process entries, ordered by owner */
+  ierr = PetscMalloc2(ncoo,&rowner,ncoo,&ridx);CHKERRQ(ierr);
+  for (k=0; k<ncoo; k++) {
+    if (coo_i[k] >= mat->rmap->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",coo_i[k],mat->rmap->N-1);
+    if (coo_j[k] >= mat->cmap->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",coo_j[k],mat->cmap->N-1);
+    if (coo_i[k] < 0 || coo_j[k] < 0 || (coo_i[k] >= rstart && coo_i[k] < rend)) continue;
+    ierr = PetscLayoutFindOwner(mat->rmap,coo_i[k],&rowner[nremote]);CHKERRQ(ierr);
+    ridx[nremote++] = k;
+  }
+  ierr = PetscSortIntWithArray(nremote,rowner,ridx);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nremote,&toranks,nremote,&tocounts);CHKERRQ(ierr);
+  for (k=0; k<nremote; k++) {
+    if (!k || rowner[k] != rowner[k-1]) {
+      toranks[nto]    = (PetscMPIInt)rowner[k];
+      tocounts[nto++] = 0;
+    }
+    tocounts[nto-1]++;
+  }
+
+  /* the owners store the received entries by increasing sender rank and tell each sender where its entries go */
+  ierr = PetscCommBuildTwoSided(comm,1,MPIU_INT,nto,toranks,tocounts,&nfrom,&fromranks,&fromcounts);CHKERRQ(ierr);
+  ierr = PetscSortMPIIntWithIntArray(nfrom,fromranks,fromcounts);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nfrom,&fromoffsets);CHKERRQ(ierr);
+  for (r=0; r<nfrom; r++) {
+    fromoffsets[r] = nrecv;
+    nrecv         += fromcounts[r];
+  }
+  ierr = PetscCommBuildTwoSided(comm,1,MPIU_INT,nfrom,fromranks,fromoffsets,&nreply,&replyranks,&replyoffsets);CHKERRQ(ierr);
+  if (nreply != nto) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Sent COO entries to %d processes but got %d replies",nto,nreply);
+  ierr = PetscSortMPIIntWithIntArray(nreply,replyranks,replyoffsets);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nremote,&iremote);CHKERRQ(ierr);
+  for (r=0,k=0; r<nto; r++) {
+    for (t=0; t<tocounts[r]; t++,k++) {
+      iremote[k].rank  = toranks[r];
+      iremote[k].index = replyoffsets[r] + t;
+    }
+  }
+  ierr = PetscSFCreate(comm,&aij->coo_sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(aij->coo_sf,nrecv,nremote,ridx,PETSC_COPY_VALUES,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(aij->coo_sf);CHKERRQ(ierr);
+  ierr = PetscFree2(rowner,ridx);CHKERRQ(ierr);
+  ierr = PetscFree2(toranks,tocounts);CHKERRQ(ierr);
+  ierr = PetscFree(fromranks);CHKERRQ(ierr);
+  ierr = PetscFree(fromcounts);CHKERRQ(ierr);
+  ierr = PetscFree(fromoffsets);CHKERRQ(ierr);
+  ierr = PetscFree(replyranks);CHKERRQ(ierr);
+  ierr = PetscFree(replyoffsets);CHKERRQ(ierr);
+
+  ierr = PetscMalloc2(nrecv,&rbuf_i,nrecv,&rbuf_j);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(aij->coo_sf,MPIU_INT,coo_i,rbuf_i,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(aij->coo_sf,MPIU_INT,coo_j,rbuf_j,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(aij->coo_sf,MPIU_INT,coo_i,rbuf_i,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(aij->coo_sf,MPIU_INT,coo_j,rbuf_j,MPIU_REPLACE);CHKERRQ(ierr);
+
+  /* all the entries of the local rows; perm[] below ncoo refers to the user values, above to the receive buffer */
+  ntot = ncoo + nrecv;
+  ierr = PetscMalloc3(ntot,&i,ntot,&j,ntot,&perm);CHKERRQ(ierr);
+  for (k=0; k<ncoo; k++) {
+    i[k]    = (coo_i[k] >= rstart && coo_i[k] < rend && coo_j[k] >= 0) ? coo_i[k] - rstart : -1;
+    j[k]    = coo_j[k];
+    perm[k] = k;
+  }
+  for (k=0; k<nrecv; k++) {
+    i[ncoo+k]    = rbuf_i[k] - rstart;
+    j[ncoo+k]    = rbuf_j[k];
+    perm[ncoo+k] = ncoo + k;
+  }
+  ierr = PetscFree2(rbuf_i,rbuf_j);CHKERRQ(ierr);
+  ierr = MatSortCOO_Private(ntot,i,j,perm,&start);CHKERRQ(ierr);
+
+  /* repeated entries form a single nonzero */
+  ierr = PetscMalloc1(ntot-start+1,&jmap);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ntot-start,&cj);CHKERRQ(ierr);
+  ierr = PetscCalloc1(m+1,&ci);CHKERRQ(ierr);
+  for (k=start; k<ntot; k++) {
+    if (k == start || i[k] != i[k-1] || j[k] != j[k-1]) {
+      cj[nz]     = j[k];
+      jmap[nz++] = k;
+      ci[i[k]+1]++;
+    }
+  }
+  jmap[nz] = ntot;
+  for (k=0; k<m; k++) ci[k+1] += ci[k];
+  ierr = MatMPIAIJSetPreallocationCSR(mat,ci,cj,NULL);CHKERRQ(ierr);
+
+  /* the nonzeros of A and B are in the same order as the merged entries */
+  for (u=0; u<nz; u++) {
+    diag = (PetscBool)(cj[u] >= cstart && cj[u] < cend);
+    if (diag) Annz++;
+    else      Bnnz++;
+    for (t=jmap[u]; t<jmap[u+1]; t++) {
+      if (perm[t] < ncoo) {if (diag) An1++; else Bn1++;}
+      else                {if (diag) An2++; else Bn2++;}
+    }
+  }
+  ierr = PetscMalloc4(Annz+1,&aij->Ajmap1,An1,&aij->Aperm1,Annz+1,&aij->Ajmap2,An2,&aij->Aperm2);CHKERRQ(ierr);
+  ierr = PetscMalloc4(Bnnz+1,&aij->Bjmap1,Bn1,&aij->Bperm1,Bnnz+1,&aij->Bjmap2,Bn2,&aij->Bperm2);CHKERRQ(ierr);
+  Annz = Bnnz = An1 = An2 = Bn1 = Bn2 = 0;
+  aij->Ajmap1[0] = aij->Ajmap2[0] = aij->Bjmap1[0] = aij->Bjmap2[0] = 0;
+  for (u=0; u<nz; u++) {
+    if (cj[u] >= cstart && cj[u] < cend) {
+      for (t=jmap[u]; t<jmap[u+1]; t++) {
+        if (perm[t] < ncoo) aij->Aperm1[An1++] = perm[t];
+        else                aij->Aperm2[An2++] = perm[t] - ncoo;
+      }
+      Annz++;
+      aij->Ajmap1[Annz] = An1;
+      aij->Ajmap2[Annz] = An2;
+    } else {
+      for (t=jmap[u]; t<jmap[u+1]; t++) {
+        if (perm[t] < ncoo) aij->Bperm1[Bn1++] = perm[t];
+        else                aij->Bperm2[Bn2++] = perm[t] - ncoo;
+      }
+      Bnnz++;
+      aij->Bjmap1[Bnnz] = Bn1;
+      aij->Bjmap2[Bnnz] = Bn2;
+    }
+  }
+  ierr = PetscFree3(i,j,perm);CHKERRQ(ierr);
+  ierr = PetscFree(jmap);CHKERRQ(ierr);
+  ierr = PetscFree(ci);CHKERRQ(ierr);
+  ierr = PetscFree(cj);CHKERRQ(ierr);
+
+  ierr = PetscMalloc1(nrecv,&aij->coo_rbuf);CHKERRQ(ierr);
+  aij->coo_n     = ncoo;
+  aij->coo_nrecv = nrecv;
+  aij->Annz      = Annz;
+  aij->Bnnz      = Bnnz;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat mat,const PetscScalar v[],InsertMode imode)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)aij->A->data,*b = (Mat_SeqAIJ*)aij->B->data;
+  const PetscInt *Ajmap1 = aij->Ajmap1,*Aperm1 = aij->Aperm1,*Ajmap2 = aij->Ajmap2,*Aperm2 = aij->Aperm2;
+  const PetscInt *Bjmap1 = aij->Bjmap1,*Bperm1 = aij->Bperm1,*Bjmap2 = aij->Bjmap2,*Bperm2 = aij->Bperm2;
+  PetscScalar    *rbuf = aij->coo_rbuf,sum;
+  MatScalar      *aa = a->a,*ba = b->a;
+  PetscInt       k,t;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!aij->coo_sf) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first");
+  if (a->nz != aij->Annz || b->nz != aij->Bnnz) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"The nonzero structure has changed since MatSetPreallocationCOO()");
+  ierr = PetscSFReduceBegin(aij->coo_sf,MPIU_SCALAR,v,rbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  for (k=0; k<aij->Annz; k++) {
+    sum = 0.0;
+    for (t=Ajmap1[k]; t<Ajmap1[k+1]; t++) sum += v[Aperm1[t]];
+    aa[k] = (imode == INSERT_VALUES) ? sum : aa[k] + sum;
+  }
+  for (k=0; k<aij->Bnnz; k++) {
+    sum = 0.0;
+    for (t=Bjmap1[k]; t<Bjmap1[k+1]; t++) sum += v[Bperm1[t]];
+    ba[k] = (imode == INSERT_VALUES) ? sum : ba[k] + sum;
+  }
+  ierr = PetscSFReduceEnd(aij->coo_sf,MPIU_SCALAR,v,rbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  if (aij->coo_nrecv) {
+    for (k=0; k<aij->Annz; k++) {
+      for (t=Ajmap2[k]; t<Ajmap2[k+1]; t++) aa[k] += rbuf[Aperm2[t]];
+    }
+    for (k=0; k<aij->Bnnz; k++) {
+      for (t=Bjmap2[k]; t<Bjmap2[k+1]; t++) ba[k] += rbuf[Bperm2[t]];
+    }
+  }
+  ierr = PetscLogFlops(Ajmap1[aij->Annz]+Ajmap2[aij->Annz]+Bjmap1[aij->Bnnz]+Bjmap2[aij->Bnnz]);CHKERRQ(ierr);
+  ierr = MatSeqAIJInvalidateDiagonal(aij->A);CHKERRQ(ierr);
+  ierr = MatSeqAIJInvalidateDiagonal(aij->B);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)aij->A);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)aij->B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    MatMPIAIJSetPreallocationCSR - Allocates memory for a sparse parallel matrix in AIJ format
    (the default parallel PETSc format).
@@ -5519,6 +5776,7 @@ PetscErrorCode MatGetCommunicationStructs(Mat A, Vec *lvec, PetscInt *colmap[],
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJCRL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJPERM(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSELL(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSingle(Mat,MatType,MatReuse,Mat*);
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMKL(Mat,MatType,MatReuse,Mat*);
 #endif
@@ -5652,11 +5910,15 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatIsTranspose_C",MatIsTranspose_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatNormLocal_C",MatNormLocal_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatResetPreallocation_C",MatResetPreallocation_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocationCSR_C",MatMPIAIJSetPreallocationCSR_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatDiagonalScaleLocal_C",MatDiagonalScaleLocal_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijperm_C",MatConvert_MPIAIJ_MPIAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijsell_C",MatConvert_MPIAIJ_MPIAIJSELL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijsingle_C",MatConvert_MPIAIJ_MPIAIJSingle);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijmkl_C",MatConvert_MPIAIJ_MPIAIJMKL);CHKERRQ(ierr);
 #endif
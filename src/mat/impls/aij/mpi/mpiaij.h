@@ -31,6 +31,10 @@ typedef struct { /* used by MatPtAP_MPIAIJ_MPIAIJ() and MatMatMult_MPIAIJ_MPIAIJ
   PetscInt                algType;                 /* implementation algorithm */
   PetscSF                 sf;                      /* use it to communicate remote part of C */
   PetscInt                *c_othi,*c_rmti;
+  PetscInt                *coff;                   /* offsets into coov of the outer product terms P(i,:)^T*AP(i,:), used by -matptap_via plan */
+  PetscInt                *pdcmap,*pocmap,*pothj;  /* columns of Pd, Po and P_oth as compressed columns of AP, used by -matptap_via plan */
+  PetscScalar             *coov;                   /* COO values of the local contribution to C, used by -matptap_via plan */
+  PetscLogDouble          flops;                   /* flops of one numeric product with the plan */
 
   Mat_Merge_SeqsToMPI *merge;
   PetscErrorCode (*destroy)(Mat);
@@ -79,6 +83,18 @@ typedef struct {
   /* used by MatMatMatMult() */
   Mat_MatMatMatMult *matmatmatmult;
 
+  /* used by MatSetValues() with MAT_USE_HASH_TABLE */
+  Mat_AIJHash *hash;
+
+  /* used by MatSetValuesCOO(), the sums of the COO entries over Xperm1[Xjmap1[k]:Xjmap1[k+1]] (in the user values)
+     and Xperm2[Xjmap2[k]:Xjmap2[k+1]] (in coo_rbuf) give the k-th nonzero of the block X = A or B */
+  PetscSF     coo_sf;              /* reduces the off-process COO values to coo_rbuf on their owner */
+  PetscInt    coo_n,coo_nrecv;     /* number of COO entries given by the user and received from other processes */
+  PetscScalar *coo_rbuf;
+  PetscInt    Annz,Bnnz;
+  PetscInt    *Ajmap1,*Aperm1,*Ajmap2,*Aperm2;
+  PetscInt    *Bjmap1,*Bperm1,*Bjmap2,*Bperm2;
+
   /* Used by MPICUSP and MPICUSPARSE classes */
   void * spptr;
 
@@ -87,6 +103,8 @@ typedef struct {
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat);
 
 PETSC_INTERN PetscErrorCode MatAssemblyEnd_MPIAIJ(Mat,MatAssemblyType);
+PETSC_INTERN PetscErrorCode MatSetOption_MPIAIJ_Hash(Mat,PetscBool);
+PETSC_INTERN PetscErrorCode MatResetPreallocationCOO_MPIAIJ(Mat);
 
 PETSC_INTERN PetscErrorCode MatSetUpMultiply_MPIAIJ(Mat);
 PETSC_INTERN PetscErrorCode MatDisAssemble_MPIAIJ(Mat);
@@ -128,9 +146,11 @@ PETSC_INTERN PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_scalable(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce_merged(Mat,Mat,PetscReal,Mat*);
+PETSC_INTERN PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_Plan(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_scalable(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_allatonce_merged(Mat,Mat,Mat);
+PETSC_INTERN PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_Plan(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatFreeIntermediateDataStructures_MPIAIJ_AP(Mat);
 PETSC_INTERN PetscErrorCode MatFreeIntermediateDataStructures_MPIAIJ_BC(Mat);
 
@@ -0,0 +1,122 @@
+/*
+  Assembly of MPIAIJ matrices through a hash table, see MatSetOption(A,MAT_USE_HASH_TABLE,PETSC_TRUE).
+
+  Locally owned entries are buffered in a hash table keyed by global (row,column), off-process entries go through
+  the usual stash. The first final MatAssemblyEnd() adds the received stash to the table, preallocates the diagonal
+  and off-diagonal blocks exactly and inserts the entries.
+*/
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+
+static PetscErrorCode MatSetValues_MPIAIJ_Hash(Mat mat,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode addv)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscBool      ignorezeroentries = ((Mat_SeqAIJ*)aij->A->data)->ignorezeroentries;
+  PetscErrorCode ierr;
+  PetscInt       i,rstart = mat->rmap->rstart,rend = mat->rmap->rend;
+
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    if (im[i] < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+    if (im[i] >= mat->rmap->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",im[i],mat->rmap->N-1);
+#endif
+    if (im[i] >= rstart && im[i] < rend) {
+      if (aij->roworiented) {
+        ierr = MatAIJHashSetValuesRow_Private(mat,aij->hash,im[i],n,in,v+i*n,1,addv,ignorezeroentries);CHKERRQ(ierr);
+      } else {
+        ierr = MatAIJHashSetValuesRow_Private(mat,aij->hash,im[i],n,in,v+i,m,addv,ignorezeroentries);CHKERRQ(ierr);
+      }
+    } else {
+      if (mat->nooffprocentries) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Setting off process row %D even though MatSetOption(,MAT_NO_OFF_PROC_ENTRIES,PETSC_TRUE) was set",im[i]);
+      if (!aij->donotstash) {
+        mat->assembled = PETSC_FALSE;
+        if (aij->roworiented) {
+          ierr = MatStashValuesRow_Private(&mat->stash,im[i],n,in,v+i*n,(PetscBool)(ignorezeroentries && (addv == ADD_VALUES)));CHKERRQ(ierr);
+        } else {
+          ierr = MatStashValuesCol_Private(&mat->stash,im[i],n,in,v+i,m,(PetscBool)(ignorezeroentries && (addv == ADD_VALUES)));CHKERRQ(ierr);
+        }
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_MPIAIJ_Hash(Mat mat,MatAssemblyType mode)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscErrorCode ierr;
+  PetscMPIInt    n;
+  PetscInt       i,j,flg,*row,*col,m = mat->rmap->n,rstart = mat->rmap->rstart;
+  PetscInt       cstart = mat->cmap->rstart,cend = mat->cmap->rend,anonew,bnonew,*ci,*cj,*dnz,*onz;
+  PetscBool      nooffprocentries,ignorezeroentries = ((Mat_SeqAIJ*)aij->A->data)->ignorezeroentries;
+  PetscScalar    *val,*ca;
+
+  PetscFunctionBegin;
+  if (!aij->donotstash && !mat->nooffprocentries) {
+    while (1) {
+      ierr = MatStashScatterGetMesg_Private(&mat->stash,&n,&row,&col,&val,&flg);CHKERRQ(ierr);
+      if (!flg) break;
+      for (i=0; i<n; i++) {
+        ierr = MatAIJHashSetValuesRow_Private(mat,aij->hash,row[i],1,col+i,val+i,1,mat->insertmode,ignorezeroentries);CHKERRQ(ierr);
+      }
+    }
+    ierr = MatStashScatterEnd_Private(&mat->stash);CHKERRQ(ierr);
+  }
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  ierr = MatAIJHashGetCSR_Private(aij->hash,rstart,m,&ci,&cj,&ca);CHKERRQ(ierr);
+  ierr = MatAIJHashDestroy_Private(mat,&aij->hash);CHKERRQ(ierr);
+  ierr = PetscInfo2(mat,"Preallocating %D nonzeros in %D rows from the hash table\n",ci[m],m);CHKERRQ(ierr);
+
+  ierr = PetscCalloc2(m,&dnz,m,&onz);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    for (j=ci[i]; j<ci[i+1]; j++) {
+      if (cj[j] >= cstart && cj[j] < cend) dnz[i]++;
+      else onz[i]++;
+    }
+  }
+  /* the exact preallocation turns on MAT_NEW_NONZERO_ALLOCATION_ERR and recreates B, keep what the user had chosen */
+  anonew = ((Mat_SeqAIJ*)aij->A->data)->nonew;
+  bnonew = ((Mat_SeqAIJ*)aij->B->data)->nonew;
+  ierr   = MatMPIAIJSetPreallocation(mat,0,dnz,0,onz);CHKERRQ(ierr);
+  ierr   = PetscFree2(dnz,onz);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    PetscInt grow = rstart + i;
+    ierr = MatSetValues_MPIAIJ(mat,1,&grow,ci[i+1]-ci[i],cj+ci[i],ca+ci[i],INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = PetscFree3(ci,cj,ca);CHKERRQ(ierr);
+  ((Mat_SeqAIJ*)aij->A->data)->nonew             = anonew;
+  ((Mat_SeqAIJ*)aij->B->data)->nonew             = bnonew;
+  ((Mat_SeqAIJ*)aij->B->data)->ignorezeroentries = ignorezeroentries;
+
+  /* the stash has already been received above */
+  nooffprocentries      = mat->nooffprocentries;
+  mat->nooffprocentries = PETSC_TRUE;
+  ierr = (*mat->ops->assemblyend)(mat,mode);CHKERRQ(ierr);
+  mat->nooffprocentries = nooffprocentries;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetOption_MPIAIJ_Hash(Mat A,PetscBool flg)
+{
+  Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
+  PetscErrorCode ierr;
+  PetscInt       nz;
+
+  PetscFunctionBegin;
+  if (flg) {
+    if (a->hash) PetscFunctionReturn(0);
+    if (A->assembled || A->was_assembled) {
+      ierr = PetscInfo(A,"MAT_USE_HASH_TABLE only applies to the first assembly of the matrix, ignored\n");CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    ierr = MatAIJHashCreate_Private(A,&a->hash);CHKERRQ(ierr);
+    A->ops->setvalues   = MatSetValues_MPIAIJ_Hash;
+    A->ops->assemblyend = MatAssemblyEnd_MPIAIJ_Hash;
+  } else if (a->hash) {
+    ierr = PetscHMapIJVGetSize(a->hash->ht,&nz);CHKERRQ(ierr);
+    if (nz) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot turn off MAT_USE_HASH_TABLE after values have been set, assemble the matrix first");
+    ierr = MatAIJHashDestroy_Private(A,&a->hash);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
@@ -1059,6 +1059,7 @@ PetscErrorCode MatCreateSubMatrix_MPIAIJ_All(Mat A,MatCreateSubMatrixOption flag
   PetscInt       sendcount,i,*rstarts = A->rmap->range,n,cnt,j;
   PetscInt       m,*b_sendj,*garray = a->garray,*lens,*jsendbuf,*a_jsendbuf,*b_jsendbuf;
   MatScalar      *sendbuf,*recvbuf,*a_sendbuf,*b_sendbuf;
+  PetscScalar    *b_a;
 
   PetscFunctionBegin;
   ierr = MPI_Comm_size(PetscObjectComm((PetscObject)A),&size);CHKERRQ(ierr);
@@ -1168,8 +1169,10 @@ PetscErrorCode MatCreateSubMatrix_MPIAIJ_All(Mat A,MatCreateSubMatrixOption flag
        Copy my part of matrix numerical values into the values location
   */
   if (flag == MAT_GET_VALUES) {
+    /* B has been assembled above, subclasses such as MATSEQAIJSINGLE then only give access to the values through MatSeqAIJGetArray() */
+    ierr      = MatSeqAIJGetArray(B,&b_a);CHKERRQ(ierr);
     sendcount = ad->nz + bd->nz;
-    sendbuf   = b->a + b->i[rstarts[rank]];
+    sendbuf   = b_a + b->i[rstarts[rank]];
     a_sendbuf = ad->a;
     b_sendbuf = bd->a;
     b_sendj   = bd->j;
@@ -1213,12 +1216,13 @@ PetscErrorCode MatCreateSubMatrix_MPIAIJ_All(Mat A,MatCreateSubMatrixOption flag
     for (i=1; i<size; i++) {
       displs[i] = displs[i-1] + recvcounts[i-1];
     }
-    recvbuf = b->a;
+    recvbuf = b_a;
 #if defined(PETSC_HAVE_MPI_IN_PLACE)
     ierr = MPI_Allgatherv(MPI_IN_PLACE,0,MPI_DATATYPE_NULL,recvbuf,recvcounts,displs,MPIU_SCALAR,PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
 #else
     ierr = MPI_Allgatherv(sendbuf,sendcount,MPIU_SCALAR,recvbuf,recvcounts,displs,MPIU_SCALAR,PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
 #endif
+    ierr = MatSeqAIJRestoreArray(B,&b_a);CHKERRQ(ierr);
   }  /* endof (flag == MAT_GET_VALUES) */
   ierr = PetscFree2(recvcounts,displs);CHKERRQ(ierr);
 
@@ -2894,7 +2898,7 @@ PetscErrorCode MatSetSeqMats_MPIAIJ(Mat C,IS rowemb,IS dcolemb,IS ocolemb,MatStr
   Mat_SeqAIJ     *Baij;
   PetscBool      seqaij,Bdisassembled;
   PetscInt       m,n,*nz,i,j,ngcol,col,rstart,rend,shift,count;
-  PetscScalar    v;
+  PetscScalar    v,*ba;
   const PetscInt *rowindices,*colindices;
 
   PetscFunctionBegin;
@@ -3013,6 +3017,7 @@ PetscErrorCode MatSetSeqMats_MPIAIJ(Mat C,IS rowemb,IS dcolemb,IS ocolemb,MatStr
 
     ierr  = PetscLayoutGetRange(C->rmap,&rstart,&rend);CHKERRQ(ierr);
     shift = rend-rstart;
+    ierr  = MatSeqAIJGetArray(B,&ba);CHKERRQ(ierr);
     count = 0;
     rowindices = NULL;
     colindices = NULL;
@@ -3030,11 +3035,12 @@ PetscErrorCode MatSetSeqMats_MPIAIJ(Mat C,IS rowemb,IS dcolemb,IS ocolemb,MatStr
 	col  = Baij->j[count];
 	if (colindices) col = colindices[col];
 	if (Bdisassembled && col>=rstart) col += shift;
-	v    = Baij->a[count];
+	v    = ba[count];
 	ierr = MatSetValues(aij->B,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);
 	++count;
       }
     }
+    ierr = MatSeqAIJRestoreArray(B,&ba);CHKERRQ(ierr);
     /* No assembly for aij->B is necessary. */
     /* FIXME: set aij->B's nonzerostate correctly. */
   } else {
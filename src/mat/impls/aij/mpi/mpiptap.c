@@ -42,6 +42,8 @@ PetscErrorCode MatView_MPIAIJ_PtAP(Mat A,PetscViewer viewer)
         ierr = PetscViewerASCIIPrintf(viewer,"using allatonce MatPtAP() implementation\n");CHKERRQ(ierr);
       } else if (ptap->algType == 3) {
         ierr = PetscViewerASCIIPrintf(viewer,"using merged allatonce MatPtAP() implementation\n");CHKERRQ(ierr);
+      } else if (ptap->algType == 4) {
+        ierr = PetscViewerASCIIPrintf(viewer,"using plan MatPtAP() implementation\n");CHKERRQ(ierr);
       }
     }
   }
@@ -103,6 +105,10 @@ PetscErrorCode MatFreeIntermediateDataStructures_MPIAIJ_AP(Mat A)
   ierr = PetscSFDestroy(&ptap->sf);CHKERRQ(ierr);
   ierr = PetscFree(ptap->c_othi);CHKERRQ(ierr);
   ierr = PetscFree(ptap->c_rmti);CHKERRQ(ierr);
+
+  ierr = PetscFree(ptap->coff);CHKERRQ(ierr);
+  ierr = PetscFree3(ptap->pdcmap,ptap->pocmap,ptap->pothj);CHKERRQ(ierr);
+  ierr = PetscFree(ptap->coov);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -125,11 +131,11 @@ PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJ_MPIAIJ(Mat A,Mat P,MatReuse scall,Pet
   PetscBool      flg;
   MPI_Comm       comm;
 #if !defined(PETSC_HAVE_HYPRE)
-  const char          *algTypes[4] = {"scalable","nonscalable","allatonce","allatonce_merged"};
-  PetscInt            nalg=4;
-#else
-  const char          *algTypes[5] = {"scalable","nonscalable","allatonce","allatonce_merged","hypre"};
+  const char          *algTypes[5] = {"scalable","nonscalable","allatonce","allatonce_merged","plan"};
   PetscInt            nalg=5;
+#else
+  const char          *algTypes[6] = {"scalable","nonscalable","allatonce","allatonce_merged","plan","hypre"};
+  PetscInt            nalg=6;
 #endif
   PetscInt            pN=P->cmap->N,alg=1; /* set default algorithm */
 
@@ -181,8 +187,14 @@ PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJ_MPIAIJ(Mat A,Mat P,MatReuse scall,Pet
       ierr = MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce_merged(A,P,fill,C);CHKERRQ(ierr);
       ierr = PetscLogEventEnd(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
       break;
-#if defined(PETSC_HAVE_HYPRE)
     case 4:
+      /* store the location of every term of P^T*A*P in the COO values of C */
+      ierr = PetscLogEventBegin(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
+      ierr = MatPtAPSymbolic_MPIAIJ_MPIAIJ_Plan(A,P,fill,C);CHKERRQ(ierr);
+      ierr = PetscLogEventEnd(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
+      break;
+#if defined(PETSC_HAVE_HYPRE)
+    case 5:
       /* Use boomerAMGBuildCoarseOperator */
       ierr = PetscLogEventBegin(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
       ierr = MatPtAPSymbolic_AIJ_AIJ_wHYPRE(A,P,fill,C);CHKERRQ(ierr);
@@ -197,7 +209,7 @@ PETSC_INTERN PetscErrorCode MatPtAP_MPIAIJ_MPIAIJ(Mat A,Mat P,MatReuse scall,Pet
       break;
     }
 
-    if (alg == 0 || alg == 1 || alg == 2 || alg == 3) {
+    if (alg == 0 || alg == 1 || alg == 2 || alg == 3 || alg == 4) {
       Mat_MPIAIJ *c  = (Mat_MPIAIJ*)(*C)->data;
       Mat_APMPI  *ap = c->ap;
       ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)(*C)),((PetscObject)(*C))->prefix,"MatFreeIntermediateDataStructures","Mat");CHKERRQ(ierr);
@@ -1590,6 +1602,254 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_allatonce_merged(Mat A,Mat P,PetscR
   PetscFunctionReturn(0);
 }
 
+/*
+   The plan algorithm records, for every local row i of A, the structure of AP(i,:) in compressed column indices and
+   the position of every term P(i,r)*AP(i,c) of the outer product P(i,:)^T*AP(i,:) in the COO values of the local
+   contribution to C. The rows of that contribution owned by other processes are sent by MatSetValuesCOO(), so the
+   numeric phase is a dense row of A*P, a gather-multiply-accumulate and a single reduction: no searches, no stash
+   and no assembly.
+*/
+PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_Plan(Mat A,Mat P,PetscReal fill,Mat *C)
+{
+  PetscErrorCode         ierr;
+  Mat_APMPI              *ptap;
+  Mat_MPIAIJ             *a=(Mat_MPIAIJ*)A->data,*p=(Mat_MPIAIJ*)P->data,*c;
+  Mat_SeqAIJ             *ad=(Mat_SeqAIJ*)(a->A)->data,*ao=NULL,*pd=(Mat_SeqAIJ*)(p->A)->data,*po=(Mat_SeqAIJ*)(p->B)->data;
+  Mat_SeqAIJ             *p_oth,*c_loc,*c_oth;
+  MPI_Comm               comm;
+  PetscMPIInt            size;
+  Mat                    Cmpi,AP_loc,Rd,Ro,C_loc,C_oth;
+  MatType                mtype;
+  ISLocalToGlobalMapping ltog;
+  PetscHSetI             ht;
+  PetscInt               am=A->rmap->n,pn=P->cmap->n,pN=P->cmap->N,pon=p->B->cmap->n,pcstart=P->cmap->rstart;
+  PetscInt               i,j,k,r,t,off,apnzi,pnzi,nloc,ncoo,nplan,nothnz,crow,loc,nout;
+  PetscInt               *api,*apj,*apjj,*coo_i,*coo_j,*coff,*gidx;
+  PetscScalar            *apv;
+  PetscLogDouble         flops = 0.0;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)A,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (size > 1) ao = (Mat_SeqAIJ*)(a->B)->data;
+
+  /* create struct Mat_APMPI and attached it to C later */
+  ierr          = PetscNew(&ptap);CHKERRQ(ierr);
+  ptap->reuse   = MAT_INITIAL_MATRIX;
+  ptap->algType = 4;
+
+  /* get P_oth by taking rows of P (= non-zero cols of local A) from other processors */
+  ierr   = MatGetBrowsOfAoCols_MPIAIJ(A,P,MAT_INITIAL_MATRIX,&ptap->startsj_s,&ptap->startsj_r,&ptap->bufa,&ptap->P_oth);CHKERRQ(ierr);
+  p_oth  = (Mat_SeqAIJ*)(ptap->P_oth)->data;
+  nothnz = p_oth->i[ptap->P_oth->rmap->n];
+
+  /* (1) symbolic AP_loc = Ad*Pd + Ad*Po + Ao*P_oth in global column indices */
+  ierr   = PetscHSetICreate(&ht);CHKERRQ(ierr);
+  ierr   = PetscMalloc1(am+1,&api);CHKERRQ(ierr);
+  api[0] = 0;
+  for (i=0; i<am; i++) {
+    ierr     = PetscHSetIClear(ht);CHKERRQ(ierr);
+    ierr     = MatPtAPSymbolicComputeOneRowOfAP_private(A,P,ptap->P_oth,i,ht,ht);CHKERRQ(ierr);
+    ierr     = PetscHSetIGetSize(ht,&apnzi);CHKERRQ(ierr);
+    api[i+1] = api[i] + apnzi;
+  }
+  ierr = PetscMalloc1(api[am]+1,&apj);CHKERRQ(ierr);
+  ierr = PetscCalloc1(api[am]+1,&apv);CHKERRQ(ierr);
+  for (i=0; i<am; i++) {
+    ierr = PetscHSetIClear(ht);CHKERRQ(ierr);
+    ierr = MatPtAPSymbolicComputeOneRowOfAP_private(A,P,ptap->P_oth,i,ht,ht);CHKERRQ(ierr);
+    off  = 0;
+    ierr = PetscHSetIGetElems(ht,&off,apj+api[i]);CHKERRQ(ierr);
+    ierr = PetscSortInt(off,apj+api[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscHSetIDestroy(&ht);CHKERRQ(ierr);
+
+  /* (2) compress the columns of AP_loc; C_loc = Pd^T*AP_loc and C_oth = Po^T*AP_loc give the local contribution to C */
+  ierr  = MatCreateSeqAIJWithArrays(PETSC_COMM_SELF,am,pN,api,apj,apv,&AP_loc);CHKERRQ(ierr);
+  ierr  = MatSeqAIJCompactOutExtraColumns_SeqAIJ(AP_loc,&ltog);CHKERRQ(ierr);
+  ierr  = MatTranspose(p->A,MAT_INITIAL_MATRIX,&Rd);CHKERRQ(ierr);
+  ierr  = MatTranspose(p->B,MAT_INITIAL_MATRIX,&Ro);CHKERRQ(ierr);
+  ierr  = MatMatMultSymbolic_SeqAIJ_SeqAIJ(Rd,AP_loc,fill,&C_loc);CHKERRQ(ierr);
+  ierr  = MatMatMultSymbolic_SeqAIJ_SeqAIJ(Ro,AP_loc,fill,&C_oth);CHKERRQ(ierr);
+  c_loc = (Mat_SeqAIJ*)C_loc->data;
+  c_oth = (Mat_SeqAIJ*)C_oth->data;
+  nloc  = c_loc->i[pn];
+  ncoo  = nloc + c_oth->i[pon];
+
+  /* the COO entries of C are those of C_loc followed by those of C_oth */
+  ierr = PetscMalloc2(ncoo,&coo_i,ncoo,&coo_j);CHKERRQ(ierr);
+  for (r=0; r<pn; r++) {
+    for (k=c_loc->i[r]; k<c_loc->i[r+1]; k++) coo_i[k] = pcstart + r;
+  }
+  for (r=0; r<pon; r++) {
+    for (k=c_oth->i[r]; k<c_oth->i[r+1]; k++) coo_i[nloc+k] = p->garray[r];
+  }
+  ierr = ISLocalToGlobalMappingApply(ltog,nloc,c_loc->j,coo_j);CHKERRQ(ierr);
+  ierr = ISLocalToGlobalMappingApply(ltog,ncoo-nloc,c_oth->j,coo_j+nloc);CHKERRQ(ierr);
+
+  /* (3) the plan: for each row i, the columns of Pd and then those of Po */
+  nplan = 0;
+  for (i=0; i<am; i++) nplan += (api[i+1]-api[i])*(pd->i[i+1]-pd->i[i]+po->i[i+1]-po->i[i]);
+  ierr  = PetscMalloc1(nplan+1,&coff);CHKERRQ(ierr);
+  nplan = 0;
+  for (i=0; i<am; i++) {
+    apnzi = api[i+1] - api[i];
+    apjj  = apj + api[i];
+    for (t=pd->i[i]; t<pd->i[i+1]; t++) {
+      crow = pd->j[t];
+      for (k=0; k<apnzi; k++) {
+        ierr = PetscFindInt(apjj[k],c_loc->i[crow+1]-c_loc->i[crow],c_loc->j+c_loc->i[crow],&loc);CHKERRQ(ierr);
+        if (loc < 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Column %D missing from row %D of the symbolic product",apjj[k],crow);
+        coff[nplan++] = c_loc->i[crow] + loc;
+      }
+    }
+    for (t=po->i[i]; t<po->i[i+1]; t++) {
+      crow = po->j[t];
+      for (k=0; k<apnzi; k++) {
+        ierr = PetscFindInt(apjj[k],c_oth->i[crow+1]-c_oth->i[crow],c_oth->j+c_oth->i[crow],&loc);CHKERRQ(ierr);
+        if (loc < 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Column %D missing from off-process row %D of the symbolic product",apjj[k],crow);
+        coff[nplan++] = nloc + c_oth->i[crow] + loc;
+      }
+    }
+    /* flops of AP(i,:) and of the outer product */
+    for (j=ad->i[i]; j<ad->i[i+1]; j++) {
+      r      = ad->j[j];
+      flops += 2.0*(pd->i[r+1]-pd->i[r]+po->i[r+1]-po->i[r]);
+    }
+    if (ao) {
+      for (j=ao->i[i]; j<ao->i[i+1]; j++) {
+        r      = ao->j[j];
+        flops += 2.0*(p_oth->i[r+1]-p_oth->i[r]);
+      }
+    }
+    pnzi   = pd->i[i+1]-pd->i[i]+po->i[i+1]-po->i[i];
+    flops += 2.0*apnzi*pnzi;
+  }
+
+  /* (4) the columns of Pd, Po and P_oth as compressed columns of AP_loc, so the numeric phase needs no mapping */
+  ierr = PetscMalloc3(pn+1,&ptap->pdcmap,pon+1,&ptap->pocmap,nothnz+1,&ptap->pothj);CHKERRQ(ierr);
+  ierr = PetscMalloc1(pn+1,&gidx);CHKERRQ(ierr);
+  for (r=0; r<pn; r++) gidx[r] = pcstart + r;
+  ierr = ISGlobalToLocalMappingApply(ltog,IS_GTOLM_MASK,pn,gidx,&nout,ptap->pdcmap);CHKERRQ(ierr);
+  ierr = ISGlobalToLocalMappingApply(ltog,IS_GTOLM_MASK,pon,p->garray,&nout,ptap->pocmap);CHKERRQ(ierr);
+  ierr = ISGlobalToLocalMappingApply(ltog,IS_GTOLM_MASK,nothnz,p_oth->j,&nout,ptap->pothj);CHKERRQ(ierr);
+  ierr = PetscFree(gidx);CHKERRQ(ierr);
+  ierr = PetscCalloc1(AP_loc->cmap->n+1,&ptap->apa);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ncoo+1,&ptap->coov);CHKERRQ(ierr);
+  ptap->api   = api;
+  ptap->apj   = apj;
+  ptap->coff  = coff;
+  ptap->flops = flops;
+
+  /* (5) C is preallocated, and the off-process rows are routed, by the COO entries */
+  ierr = MatCreate(comm,&Cmpi);CHKERRQ(ierr);
+  ierr = MatSetSizes(Cmpi,pn,pn,PETSC_DETERMINE,PETSC_DETERMINE);CHKERRQ(ierr);
+  if (P->cmap->bs > 0) {
+    ierr = PetscLayoutSetBlockSize(Cmpi->rmap,P->cmap->bs);CHKERRQ(ierr);
+    ierr = PetscLayoutSetBlockSize(Cmpi->cmap,P->cmap->bs);CHKERRQ(ierr);
+  }
+  ierr = MatGetType(A,&mtype);CHKERRQ(ierr);
+  ierr = MatSetType(Cmpi,mtype);CHKERRQ(ierr);
+  ierr = MatSetPreallocationCOO(Cmpi,ncoo,coo_i,coo_j);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)Cmpi,(am+1+api[am]+nplan+pn+pon+nothnz)*sizeof(PetscInt)+(AP_loc->cmap->n+ncoo)*sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = PetscInfo4(Cmpi,"Plan for P^T*A*P: %D nonzeros in A*P, %D outer product terms stored for %D local COO entries of C, %D of them off-process\n",api[am],nplan,ncoo,ncoo-nloc);CHKERRQ(ierr);
+
+  ierr = PetscFree2(coo_i,coo_j);CHKERRQ(ierr);
+  ierr = MatDestroy(&C_loc);CHKERRQ(ierr);
+  ierr = MatDestroy(&C_oth);CHKERRQ(ierr);
+  ierr = MatDestroy(&Rd);CHKERRQ(ierr);
+  ierr = MatDestroy(&Ro);CHKERRQ(ierr);
+  ierr = MatDestroy(&AP_loc);CHKERRQ(ierr);
+  ierr = PetscFree(apv);CHKERRQ(ierr);
+  ierr = ISLocalToGlobalMappingDestroy(&ltog);CHKERRQ(ierr);
+
+  /* attach the supporting struct to Cmpi for reuse */
+  c = (Mat_MPIAIJ*)Cmpi->data;
+  c->ap           = ptap;
+  ptap->duplicate = Cmpi->ops->duplicate;
+  ptap->destroy   = Cmpi->ops->destroy;
+  ptap->view      = Cmpi->ops->view;
+
+  Cmpi->ops->ptapnumeric = MatPtAPNumeric_MPIAIJ_MPIAIJ_Plan;
+  Cmpi->ops->destroy     = MatDestroy_MPIAIJ_PtAP;
+  Cmpi->ops->view        = MatView_MPIAIJ_PtAP;
+  Cmpi->ops->freeintermediatedatastructures = MatFreeIntermediateDataStructures_MPIAIJ_AP;
+  *C                     = Cmpi;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_Plan(Mat A,Mat P,Mat C)
+{
+  PetscErrorCode  ierr;
+  Mat_MPIAIJ      *a=(Mat_MPIAIJ*)A->data,*p=(Mat_MPIAIJ*)P->data,*c=(Mat_MPIAIJ*)C->data;
+  Mat_SeqAIJ      *ad=(Mat_SeqAIJ*)(a->A)->data,*ao=NULL,*pd=(Mat_SeqAIJ*)(p->A)->data,*po=(Mat_SeqAIJ*)(p->B)->data,*p_oth;
+  Mat_APMPI       *ptap=c->ap;
+  const PetscInt  *api,*apjj,*coff,*pdcmap,*pocmap,*pothj;
+  PetscScalar     *apa,*coov,aval,pval;
+  PetscInt        am=A->rmap->n,i,j,k,r,t,apnzi;
+  PetscMPIInt     size;
+
+  PetscFunctionBegin;
+  if (!ptap || !ptap->coff) SETERRQ(PetscObjectComm((PetscObject)C),PETSC_ERR_ARG_WRONGSTATE,"PtAP cannot be reused. Do not call MatFreeIntermediateDataStructures() or use '-mat_freeintermediatedatastructures'");
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)A),&size);CHKERRQ(ierr);
+  if (size > 1) ao = (Mat_SeqAIJ*)(a->B)->data;
+
+  /* P_oth is obtained in MatPtAPSymbolic() when reuse == MAT_INITIAL_MATRIX */
+  if (ptap->reuse == MAT_REUSE_MATRIX) {
+    ierr = MatGetBrowsOfAoCols_MPIAIJ(A,P,MAT_REUSE_MATRIX,&ptap->startsj_s,&ptap->startsj_r,&ptap->bufa,&ptap->P_oth);CHKERRQ(ierr);
+  }
+  p_oth  = (Mat_SeqAIJ*)(ptap->P_oth)->data;
+  api    = ptap->api;
+  coff   = ptap->coff;
+  pdcmap = ptap->pdcmap;
+  pocmap = ptap->pocmap;
+  pothj  = ptap->pothj;
+  apa    = ptap->apa;
+  coov   = ptap->coov;
+
+  ierr = PetscMemzero(coov,c->coo_n*sizeof(PetscScalar));CHKERRQ(ierr);
+  for (i=0; i<am; i++) {
+    /* dense row of A*P */
+    for (j=ad->i[i]; j<ad->i[i+1]; j++) {
+      r    = ad->j[j];
+      aval = ad->a[j];
+      for (t=pd->i[r]; t<pd->i[r+1]; t++) apa[pdcmap[pd->j[t]]] += aval*pd->a[t];
+      for (t=po->i[r]; t<po->i[r+1]; t++) apa[pocmap[po->j[t]]] += aval*po->a[t];
+    }
+    if (ao) {
+      for (j=ao->i[i]; j<ao->i[i+1]; j++) {
+        r    = ao->j[j];
+        aval = ao->a[j];
+        for (t=p_oth->i[r]; t<p_oth->i[r+1]; t++) apa[pothj[t]] += aval*p_oth->a[t];
+      }
+    }
+    /* C(r,:) += P(i,r)*AP(i,:) */
+    apnzi = api[i+1] - api[i];
+    apjj  = ptap->apj + api[i];
+    for (t=pd->i[i]; t<pd->i[i+1]; t++) {
+      pval = pd->a[t];
+      for (k=0; k<apnzi; k++) coov[coff[k]] += pval*apa[apjj[k]];
+      coff += apnzi;
+    }
+    for (t=po->i[i]; t<po->i[i+1]; t++) {
+      pval = po->a[t];
+      for (k=0; k<apnzi; k++) coov[coff[k]] += pval*apa[apjj[k]];
+      coff += apnzi;
+    }
+    for (k=0; k<apnzi; k++) apa[apjj[k]] = 0.0;
+  }
+  ierr = PetscLogFlops(ptap->flops);CHKERRQ(ierr);
+
+  ierr = MatSetValuesCOO(C,coov,INSERT_VALUES);CHKERRQ(ierr);
+  ptap->reuse = MAT_REUSE_MATRIX;
+
+  /* supporting struct ptap consumes almost same amount of memory as C=PtAP, release it if C will not be updated by A and P */
+  if (ptap->freestruct) {
+    ierr = MatFreeIntermediateDataStructures(C);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ(Mat A,Mat P,PetscReal fill,Mat *C)
 {
   PetscErrorCode      ierr;
@@ -288,8 +288,8 @@ PetscErrorCode MatConvertToTriples_seqsell_seqaij(Mat A,int shift,MatReuse reuse
     *c   = ptr + nz;
 
     for (i=0; i<a->totalslices; i++) {
-      for (j=a->sliidx[i],row=0; j<a->sliidx[i+1]; j++,row=((row+1)&0x07)) {
-        *ptr++ = 8*i + row + shift;
+      for (j=a->sliidx[i],row=0; j<a->sliidx[i+1]; j++,row=((row+1)%a->sliceheight)) {
+        *ptr++ = a->sliceheight*i + row + shift;
       }
     }
     for (i=0;i<nz;i++) *ptr++ = a->colidx[i] + shift;
@@ -975,6 +975,10 @@ PetscErrorCode MatView_SeqAIJ(Mat A,PetscViewer viewer)
     ierr = MatView_SeqAIJ_Draw(A,viewer);CHKERRQ(ierr);
   }
   ierr = MatView_SeqAIJ_Inode(A,viewer);CHKERRQ(ierr);
+  ierr = MatView_SeqAIJ_Threads(A,viewer);CHKERRQ(ierr);
+  ierr = MatView_SeqAIJ_Delta(A,viewer);CHKERRQ(ierr);
+  ierr = MatView_SeqAIJ_SolveLevels(A,viewer);CHKERRQ(ierr);
+  ierr = MatView_SeqAIJ_SORColor(A,viewer);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1038,6 +1042,8 @@ PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A,MatAssemblyType mode)
     ierr = MatCheckCompressedRow(A,a->nonzerorowcnt,&a->compressedrow,a->i,m,ratio);CHKERRQ(ierr);
   }
   ierr = MatAssemblyEnd_SeqAIJ_Inode(A,mode);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd_SeqAIJ_Threads(A,mode);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd_SeqAIJ_Delta(A,mode);CHKERRQ(ierr);
   ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1102,8 +1108,14 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = ISColoringDestroy(&a->coloring);CHKERRQ(ierr);
   ierr = PetscFree2(a->compressedrow.i,a->compressedrow.rindex);CHKERRQ(ierr);
   ierr = PetscFree(a->matmult_abdense);CHKERRQ(ierr);
+  ierr = MatAIJHashDestroy_Private(A,&a->hash);CHKERRQ(ierr);
+  ierr = MatResetPreallocationCOO_SeqAIJ(A);CHKERRQ(ierr);
 
   ierr = MatDestroy_SeqAIJ_Inode(A);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ_Threads(A);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ_Delta(A);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ_SolveLevels(A);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ_SORColor(A);CHKERRQ(ierr);
   ierr = PetscFree(A->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)A,0);CHKERRQ(ierr);
@@ -1127,6 +1139,8 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatResetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatReorderForNonzeroDiagonal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatPtAP_is_seqaij_C",NULL);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -1170,9 +1184,11 @@ PetscErrorCode MatSetOption_SeqAIJ(Mat A,MatOption op,PetscBool flg)
     break;
   case MAT_NEW_DIAGONALS:
   case MAT_IGNORE_OFF_PROC_ENTRIES:
-  case MAT_USE_HASH_TABLE:
     ierr = PetscInfo1(A,"Option %s ignored\n",MatOptions[op]);CHKERRQ(ierr);
     break;
+  case MAT_USE_HASH_TABLE:
+    ierr = MatSetOption_SeqAIJ_Hash(A,flg);CHKERRQ(ierr);
+    break;
   case MAT_USE_INODES:
     /* Not an error because MatSetOption_SeqAIJ_Inode handles this one */
     break;
@@ -1760,6 +1776,11 @@ PetscErrorCode MatSOR_SeqAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscR
   a->fshift = fshift;
   a->omega  = omega;
 
+  if (a->sorcolor.use && flag != SOR_APPLY_UPPER && flag != SOR_APPLY_LOWER && !(flag & SOR_EISENSTAT)) {
+    ierr = MatSOR_SeqAIJ_MultiColor(A,bb,omega,flag,its,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
   diag  = a->diag;
   t     = a->ssor_work;
   idiag = a->idiag;
@@ -3974,6 +3995,112 @@ PetscErrorCode  MatSeqAIJSetPreallocationCSR_SeqAIJ(Mat B,const PetscInt Ii[],co
   PetscFunctionReturn(0);
 }
 
+/*
+   Sorts the COO entries (i[k],j[k]) by row and then by column, perm[] is permuted along. Entries with a negative
+   row index are moved to the front, *start returns their number.
+*/
+PetscErrorCode MatSortCOO_Private(PetscInt n,PetscInt i[],PetscInt j[],PetscInt perm[],PetscInt *start)
+{
+  PetscErrorCode ierr;
+  PetscInt       k,l;
+
+  PetscFunctionBegin;
+  ierr = PetscSortIntWithArrayPair(n,i,j,perm);CHKERRQ(ierr);
+  for (k=0; k<n && i[k] < 0; k++) ;
+  *start = k;
+  while (k < n) {
+    for (l=k+1; l<n && i[l] == i[k]; l++) ;
+    ierr = PetscSortIntWithArray(l-k,j+k,perm+k);CHKERRQ(ierr);
+    k    = l;
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatResetPreallocationCOO_SeqAIJ(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr      = PetscFree(a->coo_jmap);CHKERRQ(ierr);
+  ierr      = PetscFree(a->coo_perm);CHKERRQ(ierr);
+  a->coo_n  = 0;
+  a->coo_nz = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetPreallocationCOO_SeqAIJ(Mat A,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_SeqAIJ     *a;
+  PetscErrorCode ierr;
+  PetscInt       k,m,n,start,nz = 0,*i,*j,*perm,*jmap,*ci,*cj;
+
+  PetscFunctionBegin;
+  ierr = MatResetPreallocationCOO_SeqAIJ(A);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+  m    = A->rmap->n;
+  n    = A->cmap->n;
+  ierr = PetscMalloc2(ncoo,&i,ncoo,&j);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ncoo,&perm);CHKERRQ(ierr);
+  for (k=0; k<ncoo; k++) {
+    if (coo_i[k] >= m) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",coo_i[k],m-1);
+    if (coo_j[k] >= n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",coo_j[k],n-1);
+    i[k]    = (coo_i[k] < 0 || coo_j[k] < 0) ? -1 : coo_i[k];
+    j[k]    = coo_j[k];
+    perm[k] = k;
+  }
+  ierr = MatSortCOO_Private(ncoo,i,j,perm,&start);CHKERRQ(ierr);
+
+  /* repeated entries form a single nonzero */
+  ierr = PetscMalloc1(ncoo-start+1,&jmap);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ncoo-start,&cj);CHKERRQ(ierr);
+  ierr = PetscCalloc1(m+1,&ci);CHKERRQ(ierr);
+  for (k=start; k<ncoo; k++) {
+    if (k == start || i[k] != i[k-1] || j[k] != j[k-1]) {
+      cj[nz]     = j[k];
+      jmap[nz++] = k;
+      ci[i[k]+1]++;
+    }
+  }
+  jmap[nz] = ncoo;
+  for (k=0; k<m; k++) ci[k+1] += ci[k];
+  ierr = PetscFree2(i,j);CHKERRQ(ierr);
+
+  ierr = MatSeqAIJSetPreallocationCSR(A,ci,cj,NULL);CHKERRQ(ierr);
+  ierr = PetscFree(ci);CHKERRQ(ierr);
+  ierr = PetscFree(cj);CHKERRQ(ierr);
+
+  a           = (Mat_SeqAIJ*)A->data;
+  a->coo_n    = ncoo;
+  a->coo_nz   = nz;
+  a->coo_jmap = jmap;
+  a->coo_perm = perm;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_SeqAIJ(Mat A,const PetscScalar v[],InsertMode imode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt *jmap = a->coo_jmap,*perm = a->coo_perm;
+  MatScalar      *aa = a->a;
+  PetscScalar    sum;
+  PetscInt       k,t;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!jmap) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first");
+  if (a->nz != a->coo_nz) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"The nonzero structure has changed since MatSetPreallocationCOO()");
+  for (k=0; k<a->coo_nz; k++) {
+    sum = 0.0;
+    for (t=jmap[k]; t<jmap[k+1]; t++) sum += v[perm[t]];
+    aa[k] = (imode == INSERT_VALUES) ? sum : aa[k] + sum;
+  }
+  ierr = PetscLogFlops(jmap[a->coo_nz]-jmap[0]);CHKERRQ(ierr);
+  ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 #include <../src/mat/impls/dense/seq/dense.h>
 #include <petsc/private/kernels/petscaxpy.h>
 
@@ -4249,6 +4376,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqbaij_C",MatConvert_SeqAIJ_SeqBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijperm_C",MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijsell_C",MatConvert_SeqAIJ_SeqAIJSELL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijsingle_C",MatConvert_SeqAIJ_SeqAIJSingle);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijmkl_C",MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
@@ -4271,12 +4399,17 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetPreallocation_C",MatSeqAIJSetPreallocation_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatResetPreallocation_C",MatResetPreallocation_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetPreallocationCSR_C",MatSeqAIJSetPreallocationCSR_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatReorderForNonzeroDiagonal_C",MatReorderForNonzeroDiagonal_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMult_seqdense_seqaij_C",MatMatMult_SeqDense_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultSymbolic_seqdense_seqaij_C",MatMatMultSymbolic_SeqDense_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMatMultNumeric_seqdense_seqaij_C",MatMatMultNumeric_SeqDense_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatPtAP_is_seqaij_C",MatPtAP_IS_XAIJ);CHKERRQ(ierr);
   ierr = MatCreate_SeqAIJ_Inode(B);CHKERRQ(ierr);
+  ierr = MatCreate_SeqAIJ_Threads(B);CHKERRQ(ierr);
+  ierr = MatCreate_SeqAIJ_Delta(B);CHKERRQ(ierr);
+  ierr = MatCreate_SeqAIJ_SORColor(B);CHKERRQ(ierr);
   ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
   ierr = MatSeqAIJSetTypeFromOptions(B);CHKERRQ(ierr);  /* this allows changing the matrix subtype to say MATSEQAIJPERM */
   PetscFunctionReturn(0);
@@ -4370,6 +4503,9 @@ PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat C,Mat A,MatDuplicateOption cpvalu
   C->nonzerostate  = A->nonzerostate;
 
   ierr = MatDuplicate_SeqAIJ_Inode(A,cpvalues,&C);CHKERRQ(ierr);
+  ierr = MatDuplicate_SeqAIJ_Threads(A,C);CHKERRQ(ierr);
+  ierr = MatDuplicate_SeqAIJ_Delta(A,C);CHKERRQ(ierr);
+  ierr = MatDuplicate_SeqAIJ_SORColor(A,C);CHKERRQ(ierr);
   ierr = PetscFunctionListDuplicate(((PetscObject)A)->qlist,&((PetscObject)C)->qlist);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -4727,7 +4863,7 @@ PetscErrorCode MatSetSeqMat_SeqAIJ(Mat C,IS rowemb,IS colemb,MatStructure patter
   Mat_SeqAIJ     *Baij;
   PetscBool      seqaij;
   PetscInt       m,n,*nz,i,j,count;
-  PetscScalar    v;
+  PetscScalar    v,*ba;
   const PetscInt *rowindices,*colindices;
 
   PetscFunctionBegin;
@@ -4760,6 +4896,7 @@ PetscErrorCode MatSetSeqMat_SeqAIJ(Mat C,IS rowemb,IS colemb,MatStructure patter
   if (pattern == SUBSET_NONZERO_PATTERN) {
     ierr = MatZeroEntries(C);CHKERRQ(ierr);
   }
+  ierr  = MatSeqAIJGetArray(B,&ba);CHKERRQ(ierr);
   count = 0;
   rowindices = NULL;
   colindices = NULL;
@@ -4777,11 +4914,12 @@ PetscErrorCode MatSetSeqMat_SeqAIJ(Mat C,IS rowemb,IS colemb,MatStructure patter
       PetscInt col;
       col  = Baij->j[count];
       if (colindices) col = colindices[col];
-      v    = Baij->a[count];
+      v    = ba[count];
       ierr = MatSetValues(C,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);
       ++count;
     }
   }
+  ierr = MatSeqAIJRestoreArray(B,&ba);CHKERRQ(ierr);
   /* FIXME: set C's nonzerostate correctly. */
   /* Assembly for C is necessary. */
   C->preallocated = PETSC_TRUE;
@@ -4889,6 +5027,7 @@ PetscErrorCode  MatSeqAIJRegisterAll(void)
   ierr = MatSeqAIJRegister(MATSEQAIJCRL,      MatConvert_SeqAIJ_SeqAIJCRL);CHKERRQ(ierr);
   ierr = MatSeqAIJRegister(MATSEQAIJPERM,     MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
   ierr = MatSeqAIJRegister(MATSEQAIJSELL,     MatConvert_SeqAIJ_SeqAIJSELL);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJSINGLE,   MatConvert_SeqAIJ_SeqAIJSingle);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = MatSeqAIJRegister(MATSEQAIJMKL,      MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
@@ -4,6 +4,7 @@
 
 #include <petsc/private/matimpl.h>
 #include <petscctable.h>
+#include <petsc/private/hashmapijv.h>
 
 /*
     Struct header shared by SeqAIJ, SeqBAIJ and SeqSBAIJ matrix formats
@@ -58,6 +59,8 @@ typedef struct { /* used by MatTransposeMatMult() */
 typedef struct {
   PetscInt    *api,*apj;       /* symbolic structure of A*P */
   PetscScalar *apa;            /* temporary array for storing one row of A*P */
+  PetscInt    *coff;           /* offsets into C->a of P(i,:)^T*AP(i,:) for each row i, used by -matptap_via plan */
+  PetscLogDouble flops;        /* flops of one numeric product with the plan */
   PetscErrorCode (*destroy)(Mat);
 } Mat_AP;
 
@@ -70,6 +73,12 @@ typedef struct {
   PetscErrorCode (*destroy)(Mat);
 } Mat_RARt;
 
+typedef struct { /* used by MatSetOption(A,MAT_USE_HASH_TABLE,PETSC_TRUE) until the first final assembly */
+  PetscHMapIJV   ht;                 /* entries set so far, keyed by global (row,column) */
+  PetscErrorCode (*setvalues)(Mat,PetscInt,const PetscInt[],PetscInt,const PetscInt[],const PetscScalar[],InsertMode);
+  PetscErrorCode (*assemblyend)(Mat,MatAssemblyType);
+} Mat_AIJHash;
+
 typedef struct {
   Mat BC;               /* temp matrix for storing B*C */
   PetscErrorCode (*destroy)(Mat);
@@ -97,6 +106,50 @@ typedef struct {
   PetscObjectState mat_nonzerostate;               /* non-zero state when inodes were checked for */
 } Mat_SeqAIJ_Inode;
 
+/* Info about the OpenMP threaded products (MatMult() and friends) helper class for SeqAIJ */
+typedef struct {
+  PetscInt         nthreads;                       /* number of threads used, 1 means the products are not threaded */
+  PetscInt         *rstart;                        /* first row of the block of rows of each thread, length nthreads+1 */
+  PetscInt         *nstart;                        /* first inode of the block of rows of each thread (if inodes are used) */
+  PetscScalar      *work;                          /* private accumulation buffers of each thread for MatMultTranspose() */
+  PetscInt         worksize;                       /* length of each buffer in work */
+  PetscLogDouble   *time;                          /* time each thread has spent in the products, reported by MatView() */
+  PetscObjectState mat_nonzerostate;               /* non-zero state when the rows were partitioned */
+  PetscObjectState placed_nonzerostate;            /* non-zero state when the arrays were first-touched by the threads */
+} Mat_SeqAIJ_Threads;
+
+/* Info about the 16-bit delta encoded column indices helper class for SeqAIJ, used by MatMult() and friends */
+typedef struct {
+  PetscBool        use;                            /* encode the column indices at assembly (-mat_aij_delta_indices) */
+  PetscInt         *jstart;                        /* first column of each row, or -1 if the row is not encoded */
+  unsigned short   *jd;                            /* difference of each column index to the previous one in its row, 0 for the first */
+  PetscInt         nencoded;                       /* number of rows encoded */
+  PetscObjectState mat_nonzerostate;               /* non-zero state when the column indices were encoded */
+} Mat_SeqAIJ_Delta;
+
+/* Info about the multicolor SOR helper class for SeqAIJ, the rows are sorted by color */
+typedef struct {
+  PetscBool        use;                            /* relax the rows by color in MatSOR() (-mat_sor_multicolor) */
+  PetscInt         ncolors;                        /* number of colors */
+  PetscInt         *cstart;                        /* first position in rows of each color, length ncolors+1 */
+  PetscInt         *rows;                          /* rows sorted by color */
+  PetscObjectState mat_nonzerostate;               /* non-zero state when the rows were colored */
+} Mat_SeqAIJ_SORColor;
+
+/* How MatSolve() runs the triangular solves of a factored SeqAIJ matrix */
+typedef enum {MAT_SEQAIJ_SOLVE_SERIAL,MAT_SEQAIJ_SOLVE_LEVEL,MAT_SEQAIJ_SOLVE_SYNCFREE} MatSeqAIJSolveType;
+
+/* Info about the level-scheduled triangular solves helper class for factored SeqAIJ, the rows of L and U are sorted by level */
+typedef struct {
+  MatSeqAIJSolveType type;                         /* serial, one barrier per level, or spin-waits on the rows each row depends on */
+  PetscInt           nthreads;                     /* number of threads used by the solves */
+  PetscInt           lnlevels,unlevels;            /* number of levels of L and U */
+  PetscInt           *lstart,*ustart;              /* first position in lrows (urows) of each level, length nlevels+1 */
+  PetscInt           *lrows,*urows;                /* rows of L (U) sorted by level */
+  PetscInt           *ready;                       /* syncfree: stamp of the last solve phase in which each row was computed */
+  PetscInt           stamp;                        /* syncfree: stamp of the current solve phase */
+} Mat_SeqAIJ_SolveLevels;
+
 PETSC_INTERN PetscErrorCode MatView_SeqAIJ_Inode(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode MatAssemblyEnd_SeqAIJ_Inode(Mat,MatAssemblyType);
 PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_Inode(Mat);
@@ -107,9 +160,62 @@ PETSC_INTERN PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat,Mat,MatDuplicateOpti
 PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode_inplace(Mat,Mat,const MatFactorInfo*);
 PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode(Mat,Mat,const MatFactorInfo*);
 
+PETSC_INTERN PetscErrorCode MatCreate_SeqAIJ_Threads(Mat);
+PETSC_INTERN PetscErrorCode MatAssemblyEnd_SeqAIJ_Threads(Mat,MatAssemblyType);
+PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_Threads(Mat);
+PETSC_INTERN PetscErrorCode MatDuplicate_SeqAIJ_Threads(Mat,Mat);
+PETSC_INTERN PetscErrorCode MatView_SeqAIJ_Threads(Mat,PetscViewer);
+PETSC_INTERN PetscErrorCode MatSeqAIJSolveLevelsSetUp(Mat);
+PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_SolveLevels(Mat);
+PETSC_INTERN PetscErrorCode MatView_SeqAIJ_SolveLevels(Mat,PetscViewer);
+PETSC_INTERN PetscErrorCode MatCreate_SeqAIJ_Delta(Mat);
+PETSC_INTERN PetscErrorCode MatAssemblyEnd_SeqAIJ_Delta(Mat,MatAssemblyType);
+PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_Delta(Mat);
+PETSC_INTERN PetscErrorCode MatDuplicate_SeqAIJ_Delta(Mat,Mat);
+PETSC_INTERN PetscErrorCode MatView_SeqAIJ_Delta(Mat,PetscViewer);
+PETSC_INTERN PetscErrorCode MatSeqAIJDeltaSetUp(Mat);
+PETSC_INTERN PetscErrorCode MatMult_SeqAIJ_Delta(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_Delta(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJ_Delta(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJ_Delta(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatCreate_SeqAIJ_SORColor(Mat);
+PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_SORColor(Mat);
+PETSC_INTERN PetscErrorCode MatDuplicate_SeqAIJ_SORColor(Mat,Mat);
+PETSC_INTERN PetscErrorCode MatView_SeqAIJ_SORColor(Mat,PetscViewer);
+PETSC_INTERN PetscErrorCode MatSeqAIJSORColorSetUp(Mat);
+PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ_MultiColor(Mat,Vec,PetscReal,MatSORType,PetscInt,Vec);
+#if defined(PETSC_HAVE_OPENMP)
+PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_Levels(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSeqAIJThreadsSetUp(Mat);
+PETSC_INTERN PetscErrorCode MatMult_SeqAIJ_Threads(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_Threads(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJ_Threads(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJ_Threads(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqAIJ_Inode_Threads(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_Inode_Threads(Mat,Vec,Vec,Vec);
+
+#include <omp.h>
+/*
+    MatSeqAIJThreadsEnd_Private - Called by each thread at the end of its share of a threaded product; accumulates the time
+    the thread spent in the product and waits for the other threads. The time the first thread waits for the others is
+    logged in the MAT_MultThreadImbalance event so the quality of the row partition can be checked with -log_view.
+*/
+PETSC_STATIC_INLINE void MatSeqAIJThreadsEnd_Private(Mat_SeqAIJ_Threads *threads,PetscInt tid,PetscLogDouble tstart,PetscErrorCode *ierr)
+{
+  threads->time[tid] += omp_get_wtime() - tstart;
+  if (!tid) *ierr = PetscLogEventBegin(MAT_MultThreadImbalance,0,0,0,0);
+#pragma omp barrier
+  if (!tid && !*ierr) *ierr = PetscLogEventEnd(MAT_MultThreadImbalance,0,0,0,0);
+}
+#endif
+
 typedef struct {
   SEQAIJHEADER(MatScalar);
   Mat_SeqAIJ_Inode inode;
+  Mat_SeqAIJ_Threads threads;
+  Mat_SeqAIJ_Delta delta;
+  Mat_SeqAIJ_SolveLevels solvelevels;
+  Mat_SeqAIJ_SORColor sorcolor;
   MatScalar        *saved_values;             /* location for stashing nonzero values of matrix */
 
   PetscScalar *idiag,*mdiag,*ssor_work;       /* inverse of diagonal entries, diagonal values and workspace for Eisenstat trick */
@@ -127,6 +233,11 @@ typedef struct {
   Mat_RARt            *rart;               /* used by MatRARt() */
   Mat_MatMatTransMult *abt;                /* used by MatMatTransposeMult() */
   Mat_MatTransMatMult *atb;                /* used by MatTransposeMatMult() */
+  Mat_AIJHash         *hash;               /* used by MatSetValues() with MAT_USE_HASH_TABLE */
+
+  /* used by MatSetValuesCOO(), the COO entries coo_perm[coo_jmap[k]:coo_jmap[k+1]] are summed into a[k] */
+  PetscInt            coo_n,coo_nz;        /* number of COO entries given by the user and of nonzeros they form */
+  PetscInt            *coo_jmap,*coo_perm;
 } Mat_SeqAIJ;
 
 /*
@@ -295,10 +406,20 @@ PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqDense_SeqAIJ(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Combined(Mat,Mat,Mat);
 
+PETSC_INTERN PetscErrorCode MatSetOption_SeqAIJ_Hash(Mat,PetscBool);
+PETSC_INTERN PetscErrorCode MatSortCOO_Private(PetscInt,PetscInt[],PetscInt[],PetscInt[],PetscInt*);
+PETSC_INTERN PetscErrorCode MatResetPreallocationCOO_SeqAIJ(Mat);
+PETSC_INTERN PetscErrorCode MatAIJHashCreate_Private(Mat,Mat_AIJHash**);
+PETSC_INTERN PetscErrorCode MatAIJHashDestroy_Private(Mat,Mat_AIJHash**);
+PETSC_INTERN PetscErrorCode MatAIJHashSetValuesRow_Private(Mat,Mat_AIJHash*,PetscInt,PetscInt,const PetscInt[],const PetscScalar[],PetscInt,InsertMode,PetscBool);
+PETSC_INTERN PetscErrorCode MatAIJHashGetCSR_Private(Mat_AIJHash*,PetscInt,PetscInt,PetscInt**,PetscInt**,PetscScalar**);
+
 PETSC_INTERN PetscErrorCode MatPtAP_SeqAIJ_SeqAIJ(Mat,Mat,MatReuse,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatPtAPSymbolic_SeqAIJ_SeqAIJ_SparseAxpy(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_SparseAxpy(Mat,Mat,Mat);
+PETSC_INTERN PetscErrorCode MatPtAPSymbolic_SeqAIJ_SeqAIJ_Plan(Mat,Mat,PetscReal,Mat*);
+PETSC_INTERN PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_Plan(Mat,Mat,Mat);
 
 PETSC_INTERN PetscErrorCode MatRARtSymbolic_SeqAIJ_SeqAIJ(Mat,Mat,PetscReal,Mat*);
 PETSC_INTERN PetscErrorCode MatRARtSymbolic_SeqAIJ_SeqAIJ_matmattransposemult(Mat,Mat,PetscReal,Mat*);
@@ -364,6 +485,7 @@ PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_Elemental(Mat,MatType,MatReuse,Mat
 PETSC_INTERN PetscErrorCode MatConvert_AIJ_HYPRE(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJPERM(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSELL(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJMKL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJViennaCL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatReorderForNonzeroDiagonal_SeqAIJ(Mat,PetscReal,IS,IS);
@@ -0,0 +1,260 @@
+/*
+    Versions of MatMult(), MatMultAdd(), MatMultTranspose() and MatMultTransposeAdd() for the SeqAIJ matrix storage
+  format that read the column indices from a 16-bit delta encoding instead of the PetscInt array a->j. The first column
+  of each row is kept as a PetscInt and every following column is stored as the (unsigned 16-bit) difference to the
+  column before it, so rows whose consecutive columns are less than 65536 apart (all rows of banded or RCM ordered
+  matrices, and the compacted off-diagonal block of MATMPIAIJ) are streamed with 2 bytes per nonzero instead of 4 or 8.
+  Rows with a larger gap keep using a->j.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+PetscErrorCode MatCreate_SeqAIJ_Delta(Mat B)
+{
+  Mat_SeqAIJ     *b = (Mat_SeqAIJ*)B->data;
+  PetscErrorCode ierr;
+  PetscBool      use = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"Options for SEQAIJ matrix","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_aij_delta_indices","Use 16-bit delta encoded column indices in MatMult() and related products",NULL,use,&use,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  b->delta.use = use;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJ_Delta(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(a->delta.jstart,a->delta.jd);CHKERRQ(ierr);
+  a->delta.mat_nonzerostate = 0;
+  a->delta.nencoded         = 0;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatView_SeqAIJ_Delta(Mat A,PetscViewer viewer)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode    ierr;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+
+  PetscFunctionBegin;
+  if (!a->delta.use || !a->delta.jd) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (!iascii) PetscFunctionReturn(0);
+  ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+  if (format != PETSC_VIEWER_ASCII_INFO_DETAIL && format != PETSC_VIEWER_ASCII_INFO) PetscFunctionReturn(0);
+  ierr = PetscViewerASCIIPrintf(viewer,"using 16-bit delta encoded column indices in %D of %D rows\n",a->delta.nencoded,A->rmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJ_Delta(Mat A,Mat C)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data,*c = (Mat_SeqAIJ*)C->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  c->delta.use = a->delta.use;
+  /* the factor routines duplicate without allocating the matrix space, the numeric factorization fills it in later */
+  if (!C->factortype && c->i) {
+    ierr = MatAssemblyEnd_SeqAIJ_Delta(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Encodes the column indices of each row; a row whose columns cannot all be reached with 16-bit steps gets a negative
+   start and is multiplied with a->j. Called again only when the nonzero structure has changed.
+*/
+PetscErrorCode MatSeqAIJDeltaSetUp(Mat A)
+{
+  Mat_SeqAIJ           *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Delta     *delta = &a->delta;
+  PetscErrorCode       ierr;
+  PetscInt             m = A->rmap->n,i,k,d;
+  const PetscInt       *ai = a->i,*aj = a->j;
+
+  PetscFunctionBegin;
+  if (delta->jd && delta->mat_nonzerostate == A->nonzerostate) PetscFunctionReturn(0);
+  ierr = PetscFree2(delta->jstart,delta->jd);CHKERRQ(ierr);
+  ierr = PetscMalloc2(m,&delta->jstart,ai[m]+1,&delta->jd);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,m*sizeof(PetscInt)+(ai[m]+1)*sizeof(unsigned short));CHKERRQ(ierr);
+  delta->nencoded = 0;
+  for (i=0; i<m; i++) {
+    delta->jstart[i] = -1;
+    if (ai[i+1] == ai[i]) continue;
+    delta->jd[ai[i]] = 0;
+    for (k=ai[i]+1; k<ai[i+1]; k++) {
+      d = aj[k] - aj[k-1];
+      if (d < 0 || d > 65535) break;
+      delta->jd[k] = (unsigned short)d;
+    }
+    if (k < ai[i+1]) continue;
+    delta->jstart[i] = aj[ai[i]];
+    delta->nencoded++;
+  }
+  delta->mat_nonzerostate = A->nonzerostate;
+  ierr = PetscInfo2(A,"Encoded the column indices of %D of %D rows with 16-bit deltas\n",delta->nencoded,m);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJ_Delta(Mat A,MatAssemblyType mode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+  PetscBool      isseqaij;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY || !a->delta.use || A->factortype || A->structure_only) PetscFunctionReturn(0);
+  /* subclasses such as MATSEQAIJPERM provide their own products */
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJ,&isseqaij);CHKERRQ(ierr);
+  if (!isseqaij) PetscFunctionReturn(0);
+  if (a->threads.nthreads > 1) {
+    ierr = PetscInfo(A,"Ignoring -mat_aij_delta_indices since the products use OpenMP threads\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatSeqAIJDeltaSetUp(A);CHKERRQ(ierr);
+  /* the table of functions below overrides the one set by MatSeqAIJCheckInode() */
+  A->ops->mult             = MatMult_SeqAIJ_Delta;
+  A->ops->multadd          = MatMultAdd_SeqAIJ_Delta;
+  A->ops->multtranspose    = MatMultTranspose_SeqAIJ_Delta;
+  A->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJ_Delta;
+  PetscFunctionReturn(0);
+}
+
+/* computes y = A x (add is false) or y = y + A x (add is true) */
+static PetscErrorCode MatMultAdd_SeqAIJ_Delta_Private(Mat A,const PetscScalar *x,PetscBool add,PetscScalar *y)
+{
+  Mat_SeqAIJ           *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt       *ii = a->i,*jstart = a->delta.jstart,*ridx = NULL,*aj;
+  const unsigned short *jd;
+  const MatScalar      *aa;
+  PetscInt             m = A->rmap->n,i,j,n,row,col;
+  PetscScalar          sum;
+  PetscBool            usecprow = a->compressedrow.use;
+  PetscErrorCode       ierr;
+
+  PetscFunctionBegin;
+  if (usecprow) {
+    if (!add) {ierr = PetscMemzero(y,m*sizeof(PetscScalar));CHKERRQ(ierr);}
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (i=0; i<m; i++) {
+    row = usecprow ? ridx[i] : i;
+    n   = ii[i+1] - ii[i];
+    aa  = a->a + ii[i];
+    sum = add ? y[row] : 0.0;
+    if (jstart[row] >= 0) {
+      jd  = a->delta.jd + ii[i];
+      col = jstart[row];
+      for (j=0; j<n; j++) {
+        col += jd[j];
+        sum += aa[j]*x[col];
+      }
+    } else {
+      aj = a->j + ii[i];
+      PetscSparseDensePlusDot(sum,x,aa,aj,n);
+    }
+    y[row] = sum;
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJ_Delta(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar       *y;
+  const PetscScalar *x;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJDeltaSetUp(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  ierr = MatMultAdd_SeqAIJ_Delta_Private(A,x,PETSC_FALSE,y);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJ_Delta(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar       *z;
+  const PetscScalar *x;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJDeltaSetUp(A);CHKERRQ(ierr);
+  if (zz != yy) {ierr = VecCopy(yy,zz);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  ierr = MatMultAdd_SeqAIJ_Delta_Private(A,x,PETSC_TRUE,z);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTransposeAdd_SeqAIJ_Delta(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ           *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt       *ii = a->i,*jstart,*ridx = NULL,*aj;
+  const unsigned short *jd;
+  const MatScalar      *aa;
+  PetscScalar          *y,alpha;
+  const PetscScalar    *x;
+  PetscInt             m = A->rmap->n,i,j,n,row,col;
+  PetscBool            usecprow = a->compressedrow.use;
+  PetscErrorCode       ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJDeltaSetUp(A);CHKERRQ(ierr);
+  if (zz != yy) {ierr = VecCopy(zz,yy);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  jstart = a->delta.jstart;
+  if (usecprow) {
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (i=0; i<m; i++) {
+    row   = usecprow ? ridx[i] : i;
+    n     = ii[i+1] - ii[i];
+    aa    = a->a + ii[i];
+    alpha = x[row];
+    if (jstart[row] >= 0) {
+      jd  = a->delta.jd + ii[i];
+      col = jstart[row];
+      for (j=0; j<n; j++) {
+        col    += jd[j];
+        y[col] += alpha*aa[j];
+      }
+    } else {
+      aj = a->j + ii[i];
+      for (j=0; j<n; j++) y[aj[j]] += alpha*aa[j];
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJ_Delta(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecSet(yy,0.0);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd_SeqAIJ_Delta(A,xx,yy,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
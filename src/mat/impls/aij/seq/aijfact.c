@@ -420,6 +420,7 @@ PetscErrorCode MatLUFactorSymbolic_SeqAIJ(Mat B,Mat A,IS isrow,IS iscol,const Ma
     B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
   }
   ierr = MatSeqAIJCheckInode_FactorLU(B);CHKERRQ(ierr);
+  ierr = MatSeqAIJSolveLevelsSetUp(B);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -592,6 +593,9 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *info)
   } else {
     C->ops->solve = MatSolve_SeqAIJ;
   }
+#if defined(PETSC_HAVE_OPENMP)
+  if (b->solvelevels.type != MAT_SEQAIJ_SOLVE_SERIAL) C->ops->solve = MatSolve_SeqAIJ_Levels;
+#endif
   C->ops->solveadd          = MatSolveAdd_SeqAIJ;
   C->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
   C->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
@@ -1660,6 +1664,7 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ_ilu0(Mat fact,Mat A,IS isrow,IS iscol
   ierr    = PetscMalloc1(fact->rmap->n+1,&b->solve_work);CHKERRQ(ierr);
   ierr    = PetscObjectReference((PetscObject)isrow);CHKERRQ(ierr);
   ierr    = PetscObjectReference((PetscObject)iscol);CHKERRQ(ierr);
+  ierr    = MatSeqAIJSolveLevelsSetUp(fact);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1836,6 +1841,7 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ(Mat fact,Mat A,IS isrow,IS iscol,cons
     (fact)->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
   }
   ierr = MatSeqAIJCheckInode_FactorLU(fact);CHKERRQ(ierr);
+  ierr = MatSeqAIJSolveLevelsSetUp(fact);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -0,0 +1,179 @@
+/*
+  Assembly of AIJ matrices through a hash table, see MatSetOption(A,MAT_USE_HASH_TABLE,PETSC_TRUE).
+
+  Until the first final assembly the entries are buffered in a hash table keyed by (row,column). MatAssemblyEnd()
+  then preallocates the matrix exactly and fills it, so the result is the same as if the matrix had been correctly
+  preallocated by the user, without the mallocs of an insufficient preallocation.
+*/
+#include <../src/mat/impls/aij/seq/aij.h>
+
+/*
+   Creates the hash table and remembers the MatSetValues() and MatAssemblyEnd() of A so that
+   MatAIJHashDestroy_Private() can restore them
+*/
+PetscErrorCode MatAIJHashCreate_Private(Mat A,Mat_AIJHash **hash)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNew(hash);CHKERRQ(ierr);
+  ierr = PetscHMapIJVCreate(&(*hash)->ht);CHKERRQ(ierr);
+  (*hash)->setvalues   = A->ops->setvalues;
+  (*hash)->assemblyend = A->ops->assemblyend;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAIJHashDestroy_Private(Mat A,Mat_AIJHash **hash)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!*hash) PetscFunctionReturn(0);
+  A->ops->setvalues   = (*hash)->setvalues;
+  A->ops->assemblyend = (*hash)->assemblyend;
+  ierr = PetscHMapIJVDestroy(&(*hash)->ht);CHKERRQ(ierr);
+  ierr = PetscFree(*hash);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Inserts the n values of a row, vals[k*stride] goes to column cols[k]; negative columns are ignored
+*/
+PetscErrorCode MatAIJHashSetValuesRow_Private(Mat A,Mat_AIJHash *hash,PetscInt row,PetscInt n,const PetscInt cols[],const PetscScalar vals[],PetscInt stride,InsertMode addv,PetscBool ignorezeroentries)
+{
+  PetscErrorCode ierr;
+  PetscHashIJKey key;
+  PetscScalar    value;
+  PetscBool      missing;
+  PetscInt       k;
+
+  PetscFunctionBegin;
+  key.i = row;
+  for (k=0; k<n; k++) {
+    if (cols[k] < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+    if (cols[k] >= A->cmap->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",cols[k],A->cmap->N-1);
+#endif
+    value = vals ? vals[k*stride] : 0.0;
+    if (value == 0.0 && ignorezeroentries && addv == ADD_VALUES && row != cols[k]) continue;
+    key.j = cols[k];
+    if (addv == ADD_VALUES) {
+      ierr = PetscHMapIJVQueryAdd(hash->ht,key,value,&missing);CHKERRQ(ierr);
+    } else {
+      ierr = PetscHMapIJVSet(hash->ht,key,value);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Extracts the entries of rows rstart,...,rstart+m-1 as CSR arrays with sorted column indices, free with PetscFree3(i,j,a)
+*/
+PetscErrorCode MatAIJHashGetCSR_Private(Mat_AIJHash *hash,PetscInt rstart,PetscInt m,PetscInt **i,PetscInt **j,PetscScalar **a)
+{
+  PetscErrorCode ierr;
+  PetscHashIJKey *keys;
+  PetscScalar    *vals;
+  PetscInt       k,r,nz,off = 0,*ci,*cj,*cnt;
+  PetscScalar    *ca;
+
+  PetscFunctionBegin;
+  ierr = PetscHMapIJVGetSize(hash->ht,&nz);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nz,&keys,nz,&vals);CHKERRQ(ierr);
+  ierr = PetscHMapIJVGetPairs(hash->ht,&off,keys,vals);CHKERRQ(ierr);
+  ierr = PetscMalloc3(m+1,&ci,nz,&cj,nz,&ca);CHKERRQ(ierr);
+  ierr = PetscCalloc1(m,&cnt);CHKERRQ(ierr);
+  for (k=0; k<nz; k++) cnt[keys[k].i-rstart]++;
+  ci[0] = 0;
+  for (r=0; r<m; r++) {ci[r+1] = ci[r] + cnt[r]; cnt[r] = ci[r];}
+  for (k=0; k<nz; k++) {
+    r            = keys[k].i - rstart;
+    cj[cnt[r]]   = keys[k].j;
+    ca[cnt[r]++] = vals[k];
+  }
+  for (r=0; r<m; r++) {
+    ierr = PetscSortIntWithScalarArray(ci[r+1]-ci[r],cj+ci[r],ca+ci[r]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(cnt);CHKERRQ(ierr);
+  ierr = PetscFree2(keys,vals);CHKERRQ(ierr);
+  *i = ci; *j = cj; *a = ca;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValues_SeqAIJ_Hash(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode is)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+  PetscInt       k;
+
+  PetscFunctionBegin;
+  for (k=0; k<m; k++) {
+    if (im[k] < 0) continue;
+#if defined(PETSC_USE_DEBUG)
+    if (im[k] >= A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",im[k],A->rmap->n-1);
+#endif
+    if (a->roworiented) {
+      ierr = MatAIJHashSetValuesRow_Private(A,a->hash,im[k],n,in,v ? v+k*n : NULL,1,is,a->ignorezeroentries);CHKERRQ(ierr);
+    } else {
+      ierr = MatAIJHashSetValuesRow_Private(A,a->hash,im[k],n,in,v ? v+k : NULL,m,is,a->ignorezeroentries);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_SeqAIJ_Hash(Mat A,MatAssemblyType mode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+  PetscInt       r,m = A->rmap->n,nonew,*ci,*cj,*nnz;
+  PetscScalar    *ca;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  ierr = MatAIJHashGetCSR_Private(a->hash,0,m,&ci,&cj,&ca);CHKERRQ(ierr);
+  ierr = MatAIJHashDestroy_Private(A,&a->hash);CHKERRQ(ierr);
+  ierr = PetscInfo2(A,"Preallocating %D nonzeros in %D rows from the hash table\n",ci[m],m);CHKERRQ(ierr);
+
+  /* the exact preallocation turns on MAT_NEW_NONZERO_ALLOCATION_ERR, keep what the user had chosen */
+  nonew = a->nonew;
+  ierr  = PetscMalloc1(m,&nnz);CHKERRQ(ierr);
+  for (r=0; r<m; r++) nnz[r] = ci[r+1] - ci[r];
+  ierr = MatSeqAIJSetPreallocation(A,0,nnz);CHKERRQ(ierr);
+  ierr = PetscFree(nnz);CHKERRQ(ierr);
+  a->nonew = nonew;
+
+  /* a->i is now identical to ci */
+  ierr = PetscMemcpy(a->j,cj,ci[m]*sizeof(PetscInt));CHKERRQ(ierr);
+  if (!A->structure_only) {ierr = PetscMemcpy(a->a,ca,ci[m]*sizeof(PetscScalar));CHKERRQ(ierr);}
+  for (r=0; r<m; r++) a->ilen[r] = a->imax[r];
+  a->nz = ci[m];
+  A->nonzerostate++;
+  ierr = PetscFree3(ci,cj,ca);CHKERRQ(ierr);
+
+  ierr = (*A->ops->assemblyend)(A,mode);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetOption_SeqAIJ_Hash(Mat A,PetscBool flg)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+  PetscInt       nz;
+
+  PetscFunctionBegin;
+  if (flg) {
+    if (a->hash) PetscFunctionReturn(0);
+    if (A->assembled || A->was_assembled) {
+      ierr = PetscInfo(A,"MAT_USE_HASH_TABLE only applies to the first assembly of the matrix, ignored\n");CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    ierr = MatAIJHashCreate_Private(A,&a->hash);CHKERRQ(ierr);
+    A->ops->setvalues   = MatSetValues_SeqAIJ_Hash;
+    A->ops->assemblyend = MatAssemblyEnd_SeqAIJ_Hash;
+  } else if (a->hash) {
+    ierr = PetscHMapIJVGetSize(a->hash->ht,&nz);CHKERRQ(ierr);
+    if (nz) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot turn off MAT_USE_HASH_TABLE after values have been set, assemble the matrix first");
+    ierr = MatAIJHashDestroy_Private(A,&a->hash);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,1616 @@
+/*
+  Defines basic operations for the MATSEQAIJSINGLE matrix class.
+  This class is derived from the MATSEQAIJ class, but once the matrix is assembled its values are
+  kept only in single precision (and, in builds with 64-bit indices, the column indices optionally
+  also in a 32-bit copy). The products, MatSOR(), MatGetRow() and the other operations used by the
+  solvers read the single precision values directly and accumulate in PetscScalar; the remaining
+  operations of MATSEQAIJ are called with the values expanded back to double precision for the
+  length of the call.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+typedef struct {
+  float          *a;             /* values of the assembled matrix, NULL while the values are held in the Mat_SeqAIJ */
+#if defined(PETSC_USE_64BIT_INDICES)
+  PetscBool      int32;          /* also keep a 32-bit copy of the column indices for the products */
+  int            *j;
+#endif
+  PetscInt       hold;           /* number of callers that need the double precision values to stay expanded */
+  PetscScalar    *rowvalues;     /* buffer for the row returned by MatGetRow() */
+  PetscInt       rowvalueslen;
+  struct _MatOps ops;            /* the MATSEQAIJ operations, called with the values expanded */
+  PetscErrorCode (*getarray)(Mat,PetscScalar**);
+  PetscErrorCode (*restorearray)(Mat,PetscScalar**);
+  PetscErrorCode (*storevalues)(Mat);
+  PetscErrorCode (*retrievevalues)(Mat);
+  PetscErrorCode (*setvaluescoo)(Mat,const PetscScalar[],InsertMode);
+  PetscErrorCode (*istranspose)(Mat,Mat,PetscReal,PetscBool*);
+  PetscErrorCode (*ishermitiantranspose)(Mat,Mat,PetscReal,PetscBool*);
+  PetscErrorCode (*reorderfornonzerodiagonal)(Mat,PetscReal,IS,IS);
+  PetscErrorCode (*setpreallocation)(Mat,PetscInt,const PetscInt[]);
+  PetscErrorCode (*resetpreallocation)(Mat);
+  PetscErrorCode (*setpreallocationcsr)(Mat,const PetscInt[],const PetscInt[],const PetscScalar[]);
+  PetscErrorCode (*setpreallocationcoo)(Mat,PetscInt,const PetscInt[],const PetscInt[]);
+} Mat_SeqAIJSingle;
+
+/* Moves the values of the assembled matrix into the single precision array and frees the double precision one */
+static PetscErrorCode MatSeqAIJSingleCompressValues_Private(Mat A)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscInt         i,m = A->rmap->n,nz = a->nz,*aj,*ai;
+
+  PetscFunctionBegin;
+  if (aijsingle->a || A->structure_only) PetscFunctionReturn(0);
+  ierr = PetscLogEventBegin(MAT_Convert,A,0,0,0);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nz+1,&aijsingle->a);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,(nz+1)*sizeof(float));CHKERRQ(ierr);
+  for (i=0; i<nz; i++) aijsingle->a[i] = (float)PetscRealPart(a->a[i]);
+#if defined(PETSC_USE_64BIT_INDICES)
+  if (aijsingle->int32) {
+    ierr = PetscMalloc1(nz+1,&aijsingle->j);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,(nz+1)*sizeof(int));CHKERRQ(ierr);
+    for (i=0; i<nz; i++) aijsingle->j[i] = (int)a->j[i];
+  }
+#endif
+
+  /* the values may share one allocation with the column indices and row offsets, keep those */
+  if (a->singlemalloc) {
+    ierr = PetscMalloc1(a->maxnz,&aj);CHKERRQ(ierr);
+    ierr = PetscMalloc1(m+1,&ai);CHKERRQ(ierr);
+    ierr = PetscMemcpy(aj,a->j,nz*sizeof(PetscInt));CHKERRQ(ierr);
+    ierr = PetscMemcpy(ai,a->i,(m+1)*sizeof(PetscInt));CHKERRQ(ierr);
+    ierr = PetscFree3(a->a,a->j,a->i);CHKERRQ(ierr);
+    a->j            = aj;
+    a->i            = ai;
+    a->singlemalloc = PETSC_FALSE;
+    a->free_ij      = PETSC_TRUE;
+    ierr = PetscLogObjectMemory((PetscObject)A,-(PetscLogDouble)(a->maxnz*sizeof(MatScalar)));CHKERRQ(ierr);
+  } else if (a->free_a) {
+    ierr = PetscFree(a->a);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,-(PetscLogDouble)(a->maxnz*sizeof(MatScalar)));CHKERRQ(ierr);
+  }
+  a->a      = NULL;
+  a->free_a = PETSC_TRUE;
+
+  /* the diagonal used by MatSOR() must be computed from the rounded values */
+  ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_Convert,A,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Moves the values back into a double precision array of the Mat_SeqAIJ and frees the single precision one */
+static PetscErrorCode MatSeqAIJSingleExpandValues_Private(Mat A)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscInt         i,nz = a->nz;
+
+  PetscFunctionBegin;
+  if (!aijsingle->a) PetscFunctionReturn(0);
+  ierr = PetscLogEventBegin(MAT_Convert,A,0,0,0);CHKERRQ(ierr);
+  ierr = PetscMalloc1(a->maxnz,&a->a);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,a->maxnz*sizeof(MatScalar));CHKERRQ(ierr);
+  for (i=0; i<nz; i++) a->a[i] = aijsingle->a[i];
+  for (; i<a->maxnz; i++) a->a[i] = 0.0;
+  ierr = PetscFree(aijsingle->a);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,-(PetscLogDouble)((nz+1)*sizeof(float)));CHKERRQ(ierr);
+#if defined(PETSC_USE_64BIT_INDICES)
+  if (aijsingle->j) {
+    ierr = PetscFree(aijsingle->j);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,-(PetscLogDouble)((nz+1)*sizeof(int)));CHKERRQ(ierr);
+  }
+#endif
+  ierr = PetscLogEventEnd(MAT_Convert,A,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatSeqAIJSingleExpand_Private - makes the double precision values of A available to the MATSEQAIJ code.
+   With hold they are kept until the matching MatSeqAIJSingleRelease_Private(), otherwise until the next
+   final assembly. Does nothing if A is not a MATSEQAIJSINGLE.
+*/
+PETSC_INTERN PetscErrorCode MatSeqAIJSingleExpand_Private(Mat A,PetscBool hold)
+{
+  PetscErrorCode ierr;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJSINGLE,&flg);CHKERRQ(ierr);
+  if (!flg || !A->spptr) PetscFunctionReturn(0);
+  ierr = MatSeqAIJSingleExpandValues_Private(A);CHKERRQ(ierr);
+  if (hold) ((Mat_SeqAIJSingle*)A->spptr)->hold++;
+  PetscFunctionReturn(0);
+}
+
+/* Releases a hold taken by MatSeqAIJSingleExpand_Private(), the values are compressed again once no hold remains */
+PETSC_INTERN PetscErrorCode MatSeqAIJSingleRelease_Private(Mat A)
+{
+  PetscErrorCode   ierr;
+  PetscBool        flg;
+  Mat_SeqAIJSingle *aijsingle;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJSINGLE,&flg);CHKERRQ(ierr);
+  if (!flg || !A->spptr) PetscFunctionReturn(0);
+  aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  if (aijsingle->hold) aijsingle->hold--;
+  if (!aijsingle->hold && A->assembled) {ierr = MatSeqAIJSingleCompressValues_Private(A);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*
+   The MATSEQAIJ operations that need the double precision values: B is a second matrix the operation
+   reads or fills in (NULL if none), it is expanded as well if it is a MATSEQAIJSINGLE.
+*/
+#define MatSeqAIJSingleCallExpanded(A,B,call) \
+  do { \
+    ierr = MatSeqAIJSingleExpand_Private(A,PETSC_TRUE);CHKERRQ(ierr); \
+    if (B) {ierr = MatSeqAIJSingleExpand_Private(B,PETSC_TRUE);CHKERRQ(ierr);} \
+    ierr = call;CHKERRQ(ierr); \
+    ierr = MatSeqAIJSingleRelease_Private(A);CHKERRQ(ierr); \
+    if (B) {ierr = MatSeqAIJSingleRelease_Private(B);CHKERRQ(ierr);} \
+  } while (0)
+
+#define MatSeqAIJSingleOps(A) (((Mat_SeqAIJSingle*)(A)->spptr)->ops)
+
+static PetscErrorCode MatTranspose_SeqAIJSingle(Mat A,MatReuse reuse,Mat *B)
+{
+  PetscErrorCode ierr;
+  PetscErrorCode (*transpose)(Mat,MatReuse,Mat*) = MatSeqAIJSingleOps(A).transpose;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INPLACE_MATRIX) {
+    /* A is replaced by its transpose, which is compressed by its own assembly */
+    ierr = MatSeqAIJSingleExpand_Private(A,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = (*transpose)(A,reuse,B);CHKERRQ(ierr);
+  } else MatSeqAIJSingleCallExpanded(A,reuse == MAT_REUSE_MATRIX ? *B : NULL,(*transpose)(A,reuse,B));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatEqual_SeqAIJSingle(Mat A,Mat B,PetscBool *flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,B,MatSeqAIJSingleOps(A).equal(A,B,flg));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatZeroRows_SeqAIJSingle(Mat A,PetscInt N,const PetscInt rows[],PetscScalar diag,Vec x,Vec b)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).zerorows(A,N,rows,diag,x,b));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAXPY_SeqAIJSingle(Mat Y,PetscScalar alpha,Mat X,MatStructure str)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(Y,X,MatSeqAIJSingleOps(Y).axpy(Y,alpha,X,str));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCreateSubMatrices_SeqAIJSingle(Mat A,PetscInt n,const IS irow[],const IS icol[],MatReuse scall,Mat *B[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleExpand_Private(A,PETSC_TRUE);CHKERRQ(ierr);
+  if (scall == MAT_REUSE_MATRIX) {
+    for (i=0; i<n; i++) {ierr = MatSeqAIJSingleExpand_Private((*B)[i],PETSC_TRUE);CHKERRQ(ierr);}
+  }
+  ierr = MatSeqAIJSingleOps(A).createsubmatrices(A,n,irow,icol,scall,B);CHKERRQ(ierr);
+  if (scall == MAT_REUSE_MATRIX) {
+    for (i=0; i<n; i++) {ierr = MatSeqAIJSingleRelease_Private((*B)[i]);CHKERRQ(ierr);}
+  }
+  ierr = MatSeqAIJSingleRelease_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCopy_SeqAIJSingle(Mat A,Mat B,MatStructure str)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,B,MatSeqAIJSingleOps(A).copy(A,B,str));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetRowMax_SeqAIJSingle(Mat A,Vec v,PetscInt idx[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).getrowmax(A,v,idx));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetRowMaxAbs_SeqAIJSingle(Mat A,Vec v,PetscInt idx[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).getrowmaxabs(A,v,idx));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetRowMin_SeqAIJSingle(Mat A,Vec v,PetscInt idx[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).getrowmin(A,v,idx));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetRowMinAbs_SeqAIJSingle(Mat A,Vec v,PetscInt idx[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).getrowminabs(A,v,idx));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatShift_SeqAIJSingle(Mat A,PetscScalar a)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).shift(A,a));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDiagonalSet_SeqAIJSingle(Mat A,Vec D,InsertMode is)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).diagonalset(A,D,is));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatZeroRowsColumns_SeqAIJSingle(Mat A,PetscInt N,const PetscInt rows[],PetscScalar diag,Vec x,Vec b)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).zerorowscolumns(A,N,rows,diag,x,b));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetRandom_SeqAIJSingle(Mat A,PetscRandom rctx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).setrandom(A,rctx));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatPermute_SeqAIJSingle(Mat A,IS rowp,IS colp,Mat *B)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).permute(A,rowp,colp,B));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatFindZeroDiagonals_SeqAIJSingle(Mat A,IS *zrows)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).findzerodiagonals(A,zrows));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatIsSymmetric_SeqAIJSingle(Mat A,PetscReal tol,PetscBool *flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).issymmetric(A,tol,flg));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatIsHermitian_SeqAIJSingle(Mat A,PetscReal tol,PetscBool *flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).ishermitian(A,tol,flg));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesRow_SeqAIJSingle(Mat A,PetscInt row,const PetscScalar v[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).setvaluesrow(A,row,v));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetMultiProcBlock_SeqAIJSingle(Mat A,MPI_Comm subComm,MatReuse scall,Mat *subMat)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,scall == MAT_REUSE_MATRIX ? *subMat : NULL,MatSeqAIJSingleOps(A).getmultiprocblock(A,subComm,scall,subMat));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatFindNonzeroRows_SeqAIJSingle(Mat A,IS *keptrows)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).findnonzerorows(A,keptrows));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetColumnNorms_SeqAIJSingle(Mat A,NormType type,PetscReal *norms)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).getcolumnnorms(A,type,norms));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatInvertBlockDiagonal_SeqAIJSingle(Mat A,const PetscScalar **values)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).invertblockdiagonal(A,values));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatInvertVariableBlockDiagonal_SeqAIJSingle(Mat A,PetscInt nblocks,const PetscInt *bsizes,PetscScalar *diag)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).invertvariableblockdiagonal(A,nblocks,bsizes,diag));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCreateMPIMatConcatenateSeqMat_SeqAIJSingle(MPI_Comm comm,Mat inmat,PetscInt n,MatReuse scall,Mat *outmat)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(inmat,NULL,MatSeqAIJSingleOps(inmat).creatempimatconcatenateseqmat(comm,inmat,n,scall,outmat));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatLoad_SeqAIJSingle(Mat A,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatSeqAIJSingleOps(A).load(A,viewer));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJGetArray_SeqAIJSingle(Mat A,PetscScalar *array[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* the array stays expanded until it is restored */
+  ierr = MatSeqAIJSingleExpand_Private(A,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = (*((Mat_SeqAIJSingle*)A->spptr)->getarray)(A,array);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJRestoreArray_SeqAIJSingle(Mat A,PetscScalar *array[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = (*((Mat_SeqAIJSingle*)A->spptr)->restorearray)(A,array);CHKERRQ(ierr);
+  ierr = MatSeqAIJSingleRelease_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatStoreValues_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,(*((Mat_SeqAIJSingle*)A->spptr)->storevalues)(A));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatRetrieveValues_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,(*((Mat_SeqAIJSingle*)A->spptr)->retrievevalues)(A));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatIsTranspose_SeqAIJSingle(Mat A,Mat B,PetscReal tol,PetscBool *f)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,B,(*((Mat_SeqAIJSingle*)A->spptr)->istranspose)(A,B,tol,f));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatIsHermitianTranspose_SeqAIJSingle(Mat A,Mat B,PetscReal tol,PetscBool *f)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,B,(*((Mat_SeqAIJSingle*)A->spptr)->ishermitiantranspose)(A,B,tol,f));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatReorderForNonzeroDiagonal_SeqAIJSingle(Mat A,PetscReal abstol,IS ris,IS cis)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,(*((Mat_SeqAIJSingle*)A->spptr)->reorderfornonzerodiagonal)(A,abstol,ris,cis));
+  PetscFunctionReturn(0);
+}
+
+/* The preallocation routines free and reallocate the values of the Mat_SeqAIJ, they are compressed at the next assembly */
+static PetscErrorCode MatSeqAIJSetPreallocation_SeqAIJSingle(Mat A,PetscInt nz,const PetscInt nnz[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleExpandValues_Private(A);CHKERRQ(ierr);
+  ierr = (*((Mat_SeqAIJSingle*)A->spptr)->setpreallocation)(A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatResetPreallocation_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleExpandValues_Private(A);CHKERRQ(ierr);
+  ierr = (*((Mat_SeqAIJSingle*)A->spptr)->resetpreallocation)(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJSetPreallocationCSR_SeqAIJSingle(Mat A,const PetscInt i[],const PetscInt j[],const PetscScalar v[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleExpandValues_Private(A);CHKERRQ(ierr);
+  ierr = (*((Mat_SeqAIJSingle*)A->spptr)->setpreallocationcsr)(A,i,j,v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetPreallocationCOO_SeqAIJSingle(Mat A,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleExpandValues_Private(A);CHKERRQ(ierr);
+  ierr = (*((Mat_SeqAIJSingle*)A->spptr)->setpreallocationcoo)(A,ncoo,coo_i,coo_j);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_SeqAIJSingle(Mat A,const PetscScalar v[],InsertMode imode)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  const PetscInt   *jmap = a->coo_jmap,*perm = a->coo_perm;
+  float            *aa = aijsingle->a;
+  PetscScalar      sum;
+  PetscInt         k,t;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (!aa) {
+    ierr = (*aijsingle->setvaluescoo)(A,v,imode);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (!jmap) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first");
+  if (a->nz != a->coo_nz) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"The nonzero structure has changed since MatSetPreallocationCOO()");
+  for (k=0; k<a->coo_nz; k++) {
+    sum = 0.0;
+    for (t=jmap[k]; t<jmap[k+1]; t++) sum += v[perm[t]];
+    aa[k] = (float)PetscRealPart((imode == INSERT_VALUES) ? sum : aa[k] + sum);
+  }
+  ierr = PetscLogFlops(jmap[a->coo_nz]-jmap[0]);CHKERRQ(ierr);
+  ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetValues_SeqAIJSingle(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode is)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* the values stay expanded until the next final assembly */
+  if (((Mat_SeqAIJSingle*)A->spptr)->a) {ierr = MatSeqAIJSingleExpandValues_Private(A);CHKERRQ(ierr);}
+  ierr = MatSetValues_SeqAIJ(A,m,im,n,in,v,is);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatGetValues_SeqAIJSingle(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],PetscScalar v[])
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscInt         *rp,k,low,high,t,row,nrow,i,col,l,*aj = a->j;
+  PetscInt         *ai = a->i,*ailen = a->ilen;
+  const float      *ap;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (!aijsingle->a) {
+    ierr = MatSeqAIJSingleOps(A).getvalues(A,m,im,n,in,v);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  for (k=0; k<m; k++) { /* loop over rows */
+    row = im[k];
+    if (row < 0) {v += n; continue;}
+    if (row >= A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",row,A->rmap->n-1);
+    rp   = aj + ai[row]; ap = aijsingle->a + ai[row];
+    nrow = ailen[row];
+    for (l=0; l<n; l++) { /* loop over columns */
+      if (in[l] < 0) {v++; continue;}
+      if (in[l] >= A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",in[l],A->cmap->n-1);
+      col  = in[l];
+      high = nrow; low = 0; /* assume unsorted */
+      while (high-low > 5) {
+        t = (low+high)/2;
+        if (rp[t] > col) high = t;
+        else low = t;
+      }
+      for (i=low; i<high; i++) {
+        if (rp[i] > col) break;
+        if (rp[i] == col) {
+          *v++ = ap[i];
+          goto finished;
+        }
+      }
+      *v++ = 0.0;
+finished:;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatGetRow_SeqAIJSingle(Mat A,PetscInt row,PetscInt *nz,PetscInt **idx,PetscScalar **v)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscInt         i;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (!aijsingle->a) {
+    ierr = MatGetRow_SeqAIJ(A,row,nz,idx,v);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (row < 0 || row >= A->rmap->n) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row %D out of range",row);
+
+  *nz = a->i[row+1] - a->i[row];
+  if (v) {
+    /* only one row may be gotten at a time, so a single buffer of the length of the longest row suffices */
+    if (aijsingle->rowvalueslen < a->rmax) {
+      ierr = PetscFree(aijsingle->rowvalues);CHKERRQ(ierr);
+      ierr = PetscMalloc1(a->rmax,&aijsingle->rowvalues);CHKERRQ(ierr);
+      aijsingle->rowvalueslen = a->rmax;
+    }
+    for (i=0; i<*nz; i++) aijsingle->rowvalues[i] = aijsingle->a[a->i[row]+i];
+    *v = *nz ? aijsingle->rowvalues : NULL;
+  }
+  if (idx) *idx = *nz ? a->j + a->i[row] : NULL;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatGetDiagonal_SeqAIJSingle(Mat A,Vec v)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscErrorCode   ierr;
+  PetscInt         i,j,n,*ai = a->i,*aj = a->j;
+  PetscScalar      *x;
+
+  PetscFunctionBegin;
+  if (!aijsingle->a) {
+    ierr = MatSeqAIJSingleOps(A).getdiagonal(A,v);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecGetLocalSize(v,&n);CHKERRQ(ierr);
+  if (n != A->rmap->n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Nonconforming matrix and vector");
+  ierr = VecGetArray(v,&x);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    x[i] = 0.0;
+    for (j=ai[i]; j<ai[i+1]; j++) {
+      if (aj[j] == i) {
+        x[i] = aijsingle->a[j];
+        break;
+      }
+    }
+  }
+  ierr = VecRestoreArray(v,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatNorm_SeqAIJSingle(Mat A,NormType type,PetscReal *nrm)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  const float      *v = aijsingle->a;
+  PetscReal        sum = 0.0,*tmp;
+  PetscErrorCode   ierr;
+  PetscInt         i,j;
+
+  PetscFunctionBegin;
+  if (!v) {
+    ierr = MatSeqAIJSingleOps(A).norm(A,type,nrm);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (type == NORM_FROBENIUS) {
+    for (i=0; i<a->nz; i++) sum += (PetscReal)v[i]*(PetscReal)v[i];
+    *nrm = PetscSqrtReal(sum);
+    ierr = PetscLogFlops(2*a->nz);CHKERRQ(ierr);
+  } else if (type == NORM_1) {
+    ierr = PetscCalloc1(A->cmap->n+1,&tmp);CHKERRQ(ierr);
+    *nrm = 0.0;
+    for (j=0; j<a->nz; j++) tmp[a->j[j]] += PetscAbsReal((PetscReal)v[j]);
+    for (j=0; j<A->cmap->n; j++) {
+      if (tmp[j] > *nrm) *nrm = tmp[j];
+    }
+    ierr = PetscFree(tmp);CHKERRQ(ierr);
+    ierr = PetscLogFlops(PetscMax(a->nz-1,0));CHKERRQ(ierr);
+  } else if (type == NORM_INFINITY) {
+    *nrm = 0.0;
+    for (j=0; j<A->rmap->n; j++) {
+      sum = 0.0;
+      for (i=a->i[j]; i<a->i[j+1]; i++) sum += PetscAbsReal((PetscReal)v[i]);
+      if (sum > *nrm) *nrm = sum;
+    }
+    ierr = PetscLogFlops(PetscMax(a->nz-1,0));CHKERRQ(ierr);
+  } else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support for two norm");
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatScale_SeqAIJSingle(Mat A,PetscScalar alpha)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscInt         i;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (!aijsingle->a) {
+    ierr = MatSeqAIJSingleOps(A).scale(A,alpha);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  for (i=0; i<a->nz; i++) aijsingle->a[i] = (float)PetscRealPart(aijsingle->a[i]*alpha);
+  ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+  ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDiagonalScale_SeqAIJSingle(Mat A,Vec ll,Vec rr)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle  *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  const PetscScalar *l,*r;
+  PetscInt          i,j,m,n,nz = a->nz;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (!aijsingle->a) {
+    ierr = MatSeqAIJSingleOps(A).diagonalscale(A,ll,rr);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (ll) {
+    /* the local size is used so that VecMPI can be passed to this routine by MatDiagonalScale_MPIAIJ() */
+    ierr = VecGetLocalSize(ll,&m);CHKERRQ(ierr);
+    if (m != A->rmap->n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Left scaling vector wrong length");
+    ierr = VecGetArrayRead(ll,&l);CHKERRQ(ierr);
+    for (i=0; i<m; i++) {
+      for (j=a->i[i]; j<a->i[i+1]; j++) aijsingle->a[j] = (float)PetscRealPart(aijsingle->a[j]*l[i]);
+    }
+    ierr = VecRestoreArrayRead(ll,&l);CHKERRQ(ierr);
+    ierr = PetscLogFlops(nz);CHKERRQ(ierr);
+  }
+  if (rr) {
+    ierr = VecGetLocalSize(rr,&n);CHKERRQ(ierr);
+    if (n != A->cmap->n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Right scaling vector wrong length");
+    ierr = VecGetArrayRead(rr,&r);CHKERRQ(ierr);
+    for (j=0; j<nz; j++) aijsingle->a[j] = (float)PetscRealPart(aijsingle->a[j]*r[a->j[j]]);
+    ierr = VecRestoreArrayRead(rr,&r);CHKERRQ(ierr);
+    ierr = PetscLogFlops(nz);CHKERRQ(ierr);
+  }
+  ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatZeroEntries_SeqAIJSingle(Mat A)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (!aijsingle->a) {
+    ierr = MatSeqAIJSingleOps(A).zeroentries(A);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscMemzero(aijsingle->a,a->nz*sizeof(float));CHKERRQ(ierr);
+  ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The products below are written once for the PetscInt column indices and once for the 32-bit copy of them;
+   the values are always read in single precision and the sums are accumulated in PetscScalar. The rows of an
+   inode have the same column indices, so each entry of x is loaded once for all the rows of the node
+   (the nodes have at most inode.max_limit = 5 rows).
+*/
+#define MatSeqAIJSingle_MultInode(IdxType,ajbase) \
+  do { \
+    const IdxType *aj; \
+    PetscScalar   sums[5],xj; \
+    PetscInt      node,nsz,k,row = 0; \
+    for (node=0; node<a->inode.node_count; node++) { \
+      nsz = a->inode.size[node]; \
+      n   = ii[row+1] - ii[row]; \
+      aj  = (ajbase) + ii[row]; \
+      aa  = aijsingle->a + ii[row]; \
+      for (k=0; k<nsz; k++) sums[k] = add ? y[row+k] : 0.0; \
+      for (j=0; j<n; j++) { \
+        xj = x[aj[j]]; \
+        for (k=0; k<nsz; k++) sums[k] += (PetscScalar)aa[k*n+j]*xj; \
+      } \
+      for (k=0; k<nsz; k++) y[row+k] = sums[k]; \
+      row += nsz; \
+    } \
+  } while (0)
+
+#define MatSeqAIJSingle_Mult(IdxType,ajbase) \
+  do { \
+    const IdxType *aj; \
+    if (usecprow) { \
+      for (i=0; i<m; i++) { \
+        n   = ii[i+1] - ii[i]; \
+        aj  = (ajbase) + ii[i]; \
+        aa  = aijsingle->a + ii[i]; \
+        sum = add ? y[ridx[i]] : 0.0; \
+        for (j=0; j<n; j++) sum += (PetscScalar)aa[j]*x[aj[j]]; \
+        y[ridx[i]] = sum; \
+      } \
+    } else { \
+      for (i=0; i<m; i++) { \
+        n   = ii[i+1] - ii[i]; \
+        aj  = (ajbase) + ii[i]; \
+        aa  = aijsingle->a + ii[i]; \
+        sum = add ? y[i] : 0.0; \
+        for (j=0; j<n; j++) sum += (PetscScalar)aa[j]*x[aj[j]]; \
+        y[i] = sum; \
+      } \
+    } \
+  } while (0)
+
+#define MatSeqAIJSingle_MultTranspose(IdxType,ajbase) \
+  do { \
+    const IdxType *aj; \
+    for (i=0; i<m; i++) { \
+      n     = ii[i+1] - ii[i]; \
+      aj    = (ajbase) + ii[i]; \
+      aa    = aijsingle->a + ii[i]; \
+      alpha = usecprow ? x[ridx[i]] : x[i]; \
+      for (j=0; j<n; j++) y[aj[j]] += alpha*(PetscScalar)aa[j]; \
+    } \
+  } while (0)
+
+static PetscErrorCode MatMultAdd_SeqAIJSingle_Private(Mat A,Vec xx,PetscBool add,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle  *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscScalar       *y,sum;
+  const PetscScalar *x;
+  const float       *aa;
+  PetscErrorCode    ierr;
+  PetscInt          m = A->rmap->n,n,i,j;
+  const PetscInt    *ii = a->i,*ridx = NULL;
+  PetscBool         useinode = (PetscBool)(a->inode.use && a->inode.size),usecprow = a->compressedrow.use;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (useinode) {
+#if defined(PETSC_USE_64BIT_INDICES)
+    if (aijsingle->j) MatSeqAIJSingle_MultInode(int,aijsingle->j);
+    else
+#endif
+    MatSeqAIJSingle_MultInode(PetscInt,a->j);
+  } else {
+    if (usecprow) {
+      if (!add) {ierr = PetscMemzero(y,m*sizeof(PetscScalar));CHKERRQ(ierr);}
+      m    = a->compressedrow.nrows;
+      ii   = a->compressedrow.i;
+      ridx = a->compressedrow.rindex;
+    }
+#if defined(PETSC_USE_64BIT_INDICES)
+    if (aijsingle->j) MatSeqAIJSingle_Mult(int,aijsingle->j);
+    else
+#endif
+    MatSeqAIJSingle_Mult(PetscInt,a->j);
+  }
+  ierr = PetscLogFlops(add ? 2.0*a->nz : 2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJSingle(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!((Mat_SeqAIJSingle*)A->spptr)->a) {
+    ierr = MatMult_SeqAIJ(A,xx,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatMultAdd_SeqAIJSingle_Private(A,xx,PETSC_FALSE,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJSingle(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!((Mat_SeqAIJSingle*)A->spptr)->a) {
+    ierr = MatMultAdd_SeqAIJ(A,xx,yy,zz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (zz != yy) {ierr = VecCopy(yy,zz);CHKERRQ(ierr);}
+  ierr = MatMultAdd_SeqAIJSingle_Private(A,xx,PETSC_TRUE,zz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTransposeAdd_SeqAIJSingle(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle  *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscScalar       *y,alpha;
+  const PetscScalar *x;
+  const float       *aa;
+  PetscErrorCode    ierr;
+  PetscInt          m = A->rmap->n,n,i,j;
+  const PetscInt    *ii = a->i,*ridx = NULL;
+  PetscBool         usecprow = a->compressedrow.use;
+
+  PetscFunctionBegin;
+  if (!aijsingle->a) {
+    ierr = MatMultTransposeAdd_SeqAIJ(A,xx,zz,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (zz != yy) {ierr = VecCopy(zz,yy);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (usecprow) {
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+#if defined(PETSC_USE_64BIT_INDICES)
+  if (aijsingle->j) MatSeqAIJSingle_MultTranspose(int,aijsingle->j);
+  else
+#endif
+  MatSeqAIJSingle_MultTranspose(PetscInt,a->j);
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJSingle(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecSet(yy,0.0);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd_SeqAIJSingle(A,xx,yy,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Same as MatInvertDiagonal_SeqAIJ() with the diagonal read from the single precision values */
+static PetscErrorCode MatInvertDiagonal_SeqAIJSingle(Mat A,PetscScalar omega,PetscScalar fshift)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscErrorCode   ierr;
+  PetscInt         i,*diag,m = A->rmap->n;
+  const float      *v = aijsingle->a;
+  PetscScalar      *idiag,*mdiag;
+
+  PetscFunctionBegin;
+  if (a->idiagvalid) PetscFunctionReturn(0);
+  ierr = MatMarkDiagonal_SeqAIJ(A);CHKERRQ(ierr);
+  diag = a->diag;
+  if (!a->idiag) {
+    ierr = PetscMalloc3(m,&a->idiag,m,&a->mdiag,m,&a->ssor_work);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,3*m*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  mdiag = a->mdiag;
+  idiag = a->idiag;
+
+  if (omega == 1.0 && PetscRealPart(fshift) <= 0.0) {
+    for (i=0; i<m; i++) {
+      mdiag[i] = v[diag[i]];
+      if (!PetscAbsScalar(mdiag[i])) { /* zero diagonal */
+        if (PetscRealPart(fshift)) {
+          ierr = PetscInfo1(A,"Zero diagonal on row %D\n",i);CHKERRQ(ierr);
+          A->factorerrortype             = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+          A->factorerror_zeropivot_value = 0.0;
+          A->factorerror_zeropivot_row   = i;
+        } else SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Zero diagonal on row %D",i);
+      }
+      idiag[i] = 1.0/mdiag[i];
+    }
+    ierr = PetscLogFlops(m);CHKERRQ(ierr);
+  } else {
+    for (i=0; i<m; i++) {
+      mdiag[i] = v[diag[i]];
+      idiag[i] = omega/(fshift + mdiag[i]);
+    }
+    ierr = PetscLogFlops(2.0*m);CHKERRQ(ierr);
+  }
+  a->idiagvalid = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+#define MatSeqAIJSingle_MinusDot(sum,r,v,idx,n) do {PetscInt k_; for (k_=0; k_<(n); k_++) sum -= (PetscScalar)(v)[k_]*(r)[(idx)[k_]];} while (0)
+#define MatSeqAIJSingle_PlusDot(sum,r,v,idx,n)  do {PetscInt k_; for (k_=0; k_<(n); k_++) sum += (PetscScalar)(v)[k_]*(r)[(idx)[k_]];} while (0)
+
+/*
+   Point SOR on the single precision values, the same sweeps as MatSOR_SeqAIJ(). The inode SOR is not used, its
+   block diagonals are kept in PetscScalar; the multicolor sweeps are run on the expanded values.
+*/
+PetscErrorCode MatSOR_SeqAIJSingle(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle  *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+  PetscScalar       *x,d,sum,*t,scale;
+  const float       *v,*aa = aijsingle->a;
+  const PetscScalar *idiag,*mdiag;
+  const PetscScalar *b,*bs,*xb,*ts;
+  PetscErrorCode    ierr;
+  PetscInt          n,m = A->rmap->n,i;
+  const PetscInt    *idx,*diag;
+
+  PetscFunctionBegin;
+  if (!aa || (a->sorcolor.use && flag != SOR_APPLY_UPPER && flag != SOR_APPLY_LOWER && !(flag & SOR_EISENSTAT))) {
+    MatSeqAIJSingleCallExpanded(A,NULL,MatSOR_SeqAIJ(A,bb,omega,flag,fshift,its,lits,xx));
+    PetscFunctionReturn(0);
+  }
+  its = its*lits;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) {ierr = MatInvertDiagonal_SeqAIJSingle(A,omega,fshift);CHKERRQ(ierr);}
+  a->fshift = fshift;
+  a->omega  = omega;
+
+  diag  = a->diag;
+  t     = a->ssor_work;
+  idiag = a->idiag;
+  mdiag = a->mdiag;
+
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  /* We count flops by assuming the upper triangular and lower triangular parts have the same number of nonzeros */
+  if (flag == SOR_APPLY_UPPER) {
+    /* apply (U + D/omega) to the vector */
+    bs = b;
+    for (i=0; i<m; i++) {
+      d   = fshift + mdiag[i];
+      n   = a->i[i+1] - diag[i] - 1;
+      idx = a->j + diag[i] + 1;
+      v   = aa + diag[i] + 1;
+      sum = b[i]*d/omega;
+      MatSeqAIJSingle_PlusDot(sum,bs,v,idx,n);
+      x[i] = sum;
+    }
+    ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+    ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  if (flag == SOR_APPLY_LOWER) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"SOR_APPLY_LOWER is not implemented");
+  else if (flag & SOR_EISENSTAT) {
+    /* Applies (L + E)^{-1} A (U + E)^{-1} with Eisenstat's trick, where A = L + U + D and E = D/omega */
+    scale = (2.0/omega) - 1.0;
+
+    /*  x = (E + U)^{-1} b */
+    for (i=m-1; i>=0; i--) {
+      n   = a->i[i+1] - diag[i] - 1;
+      idx = a->j + diag[i] + 1;
+      v   = aa + diag[i] + 1;
+      sum = b[i];
+      MatSeqAIJSingle_MinusDot(sum,x,v,idx,n);
+      x[i] = sum*idiag[i];
+    }
+
+    /*  t = b - (2*E - D)x */
+    for (i=0; i<m; i++) t[i] = b[i] - scale*mdiag[i]*x[i];
+
+    /*  t = (E + L)^{-1}t */
+    ts = t;
+    for (i=0; i<m; i++) {
+      n   = diag[i] - a->i[i];
+      idx = a->j + a->i[i];
+      v   = aa + a->i[i];
+      sum = t[i];
+      MatSeqAIJSingle_MinusDot(sum,ts,v,idx,n);
+      t[i] = sum*idiag[i];
+      /*  x = x + t */
+      x[i] += t[i];
+    }
+
+    ierr = PetscLogFlops(6.0*m-1 + 2.0*a->nz);CHKERRQ(ierr);
+    ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        n   = diag[i] - a->i[i];
+        idx = a->j + a->i[i];
+        v   = aa + a->i[i];
+        sum = b[i];
+        MatSeqAIJSingle_MinusDot(sum,x,v,idx,n);
+        t[i] = sum;
+        x[i] = sum*idiag[i];
+      }
+      xb   = t;
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        n   = a->i[i+1] - diag[i] - 1;
+        idx = a->j + diag[i] + 1;
+        v   = aa + diag[i] + 1;
+        sum = xb[i];
+        MatSeqAIJSingle_MinusDot(sum,x,v,idx,n);
+        if (xb == b) {
+          x[i] = sum*idiag[i];
+        } else {
+          x[i] = (1-omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        /* lower */
+        n   = diag[i] - a->i[i];
+        idx = a->j + a->i[i];
+        v   = aa + a->i[i];
+        sum = b[i];
+        MatSeqAIJSingle_MinusDot(sum,x,v,idx,n);
+        t[i] = sum;             /* save application of the lower-triangular part */
+        /* upper */
+        n   = a->i[i+1] - diag[i] - 1;
+        idx = a->j + diag[i] + 1;
+        v   = aa + diag[i] + 1;
+        MatSeqAIJSingle_MinusDot(sum,x,v,idx,n);
+        x[i] = (1. - omega)*x[i] + sum*idiag[i]; /* omega in idiag */
+      }
+      xb   = t;
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        sum = xb[i];
+        if (xb == b) {
+          /* whole matrix (no checkpointing available) */
+          n   = a->i[i+1] - a->i[i];
+          idx = a->j + a->i[i];
+          v   = aa + a->i[i];
+          MatSeqAIJSingle_MinusDot(sum,x,v,idx,n);
+          x[i] = (1. - omega)*x[i] + (sum + mdiag[i]*x[i])*idiag[i];
+        } else { /* lower-triangular part has been saved, so only apply upper-triangular */
+          n   = a->i[i+1] - diag[i] - 1;
+          idx = a->j + diag[i] + 1;
+          v   = aa + diag[i] + 1;
+          MatSeqAIJSingle_MinusDot(sum,x,v,idx,n);
+          x[i] = (1. - omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      if (xb == b) {
+        ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+      } else {
+        ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+      }
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* The operations the assembly of a MATSEQAIJ may replace (with the inode, threaded or delta encoded versions) */
+static PetscErrorCode MatSeqAIJSingleSetProductOps_Private(Mat B)
+{
+  PetscFunctionBegin;
+  B->ops->mult              = MatMult_SeqAIJSingle;
+  B->ops->multadd           = MatMultAdd_SeqAIJSingle;
+  B->ops->multtranspose     = MatMultTranspose_SeqAIJSingle;
+  B->ops->multtransposeadd  = MatMultTransposeAdd_SeqAIJSingle;
+  B->ops->sor               = MatSOR_SeqAIJSingle;
+  B->ops->multdiagonalblock = NULL;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJSingle(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  ierr = MatSeqAIJSingleExpandValues_Private(A);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  ierr = MatSeqAIJSingleSetProductOps_Private(A);CHKERRQ(ierr);
+  if (!((Mat_SeqAIJSingle*)A->spptr)->hold) {ierr = MatSeqAIJSingleCompressValues_Private(A);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJSingle(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr,*aijsingle_dest;
+
+  PetscFunctionBegin;
+  /* the values of a compressed matrix are copied in single precision, after the duplicate is compressed */
+  ierr = MatDuplicate_SeqAIJ(A,(aijsingle->a && op == MAT_COPY_VALUES) ? MAT_DO_NOT_COPY_VALUES : op,M);CHKERRQ(ierr);
+  aijsingle_dest = (Mat_SeqAIJSingle*)(*M)->spptr;
+#if defined(PETSC_USE_64BIT_INDICES)
+  aijsingle_dest->int32 = aijsingle->int32;
+#endif
+  ierr = MatSeqAIJSingleSetProductOps_Private(*M);CHKERRQ(ierr);
+  ierr = MatSeqAIJSingleCompressValues_Private(*M);CHKERRQ(ierr);
+  if (aijsingle->a && op == MAT_COPY_VALUES) {
+    ierr = PetscMemcpy(aijsingle_dest->a,aijsingle->a,a->nz*sizeof(float));CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode   ierr;
+  Mat_SeqAIJSingle *aijsingle = (Mat_SeqAIJSingle*)A->spptr;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used, then this SeqAIJSingle matrix will not have an spptr pointer. */
+  if (aijsingle) {
+    ierr = PetscFree(aijsingle->a);CHKERRQ(ierr);
+#if defined(PETSC_USE_64BIT_INDICES)
+    ierr = PetscFree(aijsingle->j);CHKERRQ(ierr);
+#endif
+    ierr = PetscFree(aijsingle->rowvalues);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaijsingle_seqaij_C",NULL);CHKERRQ(ierr);
+
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ() to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatView_SeqAIJSingle(Mat A,PetscViewer viewer)
+{
+  PetscErrorCode    ierr;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+  PetscInt          aij = (PetscInt)(sizeof(MatScalar)+sizeof(PetscInt)),stored = (PetscInt)(sizeof(float)+sizeof(PetscInt));
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+  if (iascii && (format == PETSC_VIEWER_ASCII_INFO || format == PETSC_VIEWER_ASCII_INFO_DETAIL)) {
+    ierr = MatView_SeqAIJ(A,viewer);CHKERRQ(ierr);
+#if defined(PETSC_USE_64BIT_INDICES)
+    if (((Mat_SeqAIJSingle*)A->spptr)->int32) stored += (PetscInt)sizeof(int);
+#endif
+    ierr = PetscViewerASCIIPrintf(viewer,"values stored in single precision: %D bytes per nonzero instead of %D\n",stored,aij);CHKERRQ(ierr);
+#if defined(PETSC_USE_64BIT_INDICES)
+    if (((Mat_SeqAIJSingle*)A->spptr)->int32) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  the products read a 32-bit copy of the column indices: %D bytes per nonzero\n",(PetscInt)(sizeof(float)+sizeof(int)));CHKERRQ(ierr);
+    }
+#endif
+  } else MatSeqAIJSingleCallExpanded(A,NULL,MatView_SeqAIJ(A,viewer));
+  PetscFunctionReturn(0);
+}
+
+/* The factorizations are computed from the expanded values, the factors are MATSEQAIJ (MATSEQSBAIJ) in double precision */
+static PetscErrorCode MatLUFactorNumeric_SeqAIJSingle(Mat F,Mat A,const MatFactorInfo *info)
+{
+  PetscErrorCode ierr,(*numeric)(Mat,Mat,const MatFactorInfo*);
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQueryFunction((PetscObject)F,"MatLUFactorNumeric_SeqAIJSingle_C",&numeric);CHKERRQ(ierr);
+  MatSeqAIJSingleCallExpanded(A,NULL,(*numeric)(F,A,info));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCholeskyFactorNumeric_SeqAIJSingle(Mat F,Mat A,const MatFactorInfo *info)
+{
+  PetscErrorCode ierr,(*numeric)(Mat,Mat,const MatFactorInfo*);
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQueryFunction((PetscObject)F,"MatCholeskyFactorNumeric_SeqAIJSingle_C",&numeric);CHKERRQ(ierr);
+  MatSeqAIJSingleCallExpanded(A,NULL,(*numeric)(F,A,info));
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJSingleWrapLUFactorNumeric_Private(Mat F)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (F->ops->lufactornumeric != MatLUFactorNumeric_SeqAIJSingle) {
+    ierr = PetscObjectComposeFunction((PetscObject)F,"MatLUFactorNumeric_SeqAIJSingle_C",F->ops->lufactornumeric);CHKERRQ(ierr);
+    F->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJSingle;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJSingleWrapCholeskyFactorNumeric_Private(Mat F)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (F->ops->choleskyfactornumeric != MatCholeskyFactorNumeric_SeqAIJSingle) {
+    ierr = PetscObjectComposeFunction((PetscObject)F,"MatCholeskyFactorNumeric_SeqAIJSingle_C",F->ops->choleskyfactornumeric);CHKERRQ(ierr);
+    F->ops->choleskyfactornumeric = MatCholeskyFactorNumeric_SeqAIJSingle;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatLUFactorSymbolic_SeqAIJSingle(Mat F,Mat A,IS isrow,IS iscol,const MatFactorInfo *info)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatLUFactorSymbolic_SeqAIJ(F,A,isrow,iscol,info));
+  ierr = MatSeqAIJSingleWrapLUFactorNumeric_Private(F);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatILUFactorSymbolic_SeqAIJSingle(Mat F,Mat A,IS isrow,IS iscol,const MatFactorInfo *info)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatILUFactorSymbolic_SeqAIJ(F,A,isrow,iscol,info));
+  ierr = MatSeqAIJSingleWrapLUFactorNumeric_Private(F);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCholeskyFactorSymbolic_SeqAIJSingle(Mat F,Mat A,IS perm,const MatFactorInfo *info)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatCholeskyFactorSymbolic_SeqAIJ(F,A,perm,info));
+  ierr = MatSeqAIJSingleWrapCholeskyFactorNumeric_Private(F);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatICCFactorSymbolic_SeqAIJSingle(Mat F,Mat A,IS perm,const MatFactorInfo *info)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  MatSeqAIJSingleCallExpanded(A,NULL,MatICCFactorSymbolic_SeqAIJ(F,A,perm,info));
+  ierr = MatSeqAIJSingleWrapCholeskyFactorNumeric_Private(F);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat,MatFactorType,Mat*);
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaijsingle_petsc(Mat A,MatFactorType ftype,Mat *F)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetFactor_seqaij_petsc(A,ftype,F);CHKERRQ(ierr);
+  if (ftype == MAT_FACTOR_LU || ftype == MAT_FACTOR_ILU || ftype == MAT_FACTOR_ILUDT) {
+    (*F)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqAIJSingle;
+    (*F)->ops->lufactorsymbolic  = MatLUFactorSymbolic_SeqAIJSingle;
+  } else {
+    (*F)->ops->iccfactorsymbolic      = MatICCFactorSymbolic_SeqAIJSingle;
+    (*F)->ops->choleskyfactorsymbolic = MatCholeskyFactorSymbolic_SeqAIJSingle;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJSingleSetOps_Private(Mat B)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSingleSetProductOps_Private(B);CHKERRQ(ierr);
+  B->ops->setvalues       = MatSetValues_SeqAIJSingle;
+  B->ops->getvalues       = MatGetValues_SeqAIJSingle;
+  B->ops->getrow          = MatGetRow_SeqAIJSingle;
+  B->ops->getdiagonal     = MatGetDiagonal_SeqAIJSingle;
+  B->ops->norm            = MatNorm_SeqAIJSingle;
+  B->ops->scale           = MatScale_SeqAIJSingle;
+  B->ops->diagonalscale   = MatDiagonalScale_SeqAIJSingle;
+  B->ops->zeroentries     = MatZeroEntries_SeqAIJSingle;
+  B->ops->duplicate       = MatDuplicate_SeqAIJSingle;
+  B->ops->assemblyend     = MatAssemblyEnd_SeqAIJSingle;
+  B->ops->destroy         = MatDestroy_SeqAIJSingle;
+  B->ops->view            = MatView_SeqAIJSingle;
+
+  B->ops->transpose                     = MatTranspose_SeqAIJSingle;
+  B->ops->equal                         = MatEqual_SeqAIJSingle;
+  B->ops->zerorows                      = MatZeroRows_SeqAIJSingle;
+  B->ops->axpy                          = MatAXPY_SeqAIJSingle;
+  B->ops->createsubmatrices             = MatCreateSubMatrices_SeqAIJSingle;
+  B->ops->copy                          = MatCopy_SeqAIJSingle;
+  B->ops->getrowmax                     = MatGetRowMax_SeqAIJSingle;
+  B->ops->getrowmaxabs                  = MatGetRowMaxAbs_SeqAIJSingle;
+  B->ops->getrowmin                     = MatGetRowMin_SeqAIJSingle;
+  B->ops->getrowminabs                  = MatGetRowMinAbs_SeqAIJSingle;
+  B->ops->shift                         = MatShift_SeqAIJSingle;
+  B->ops->diagonalset                   = MatDiagonalSet_SeqAIJSingle;
+  B->ops->zerorowscolumns               = MatZeroRowsColumns_SeqAIJSingle;
+  B->ops->setrandom                     = MatSetRandom_SeqAIJSingle;
+  B->ops->permute                       = MatPermute_SeqAIJSingle;
+  B->ops->findzerodiagonals             = MatFindZeroDiagonals_SeqAIJSingle;
+  B->ops->issymmetric                   = MatIsSymmetric_SeqAIJSingle;
+  B->ops->ishermitian                   = MatIsHermitian_SeqAIJSingle;
+  B->ops->setvaluesrow                  = MatSetValuesRow_SeqAIJSingle;
+  B->ops->getmultiprocblock             = MatGetMultiProcBlock_SeqAIJSingle;
+  B->ops->findnonzerorows               = MatFindNonzeroRows_SeqAIJSingle;
+  B->ops->getcolumnnorms                = MatGetColumnNorms_SeqAIJSingle;
+  B->ops->invertblockdiagonal           = MatInvertBlockDiagonal_SeqAIJSingle;
+  B->ops->invertvariableblockdiagonal   = MatInvertVariableBlockDiagonal_SeqAIJSingle;
+  B->ops->creatempimatconcatenateseqmat = MatCreateMPIMatConcatenateSeqMat_SeqAIJSingle;
+  B->ops->load                          = MatLoad_SeqAIJSingle;
+
+  /* in-place factorizations would turn the matrix into a MATSEQAIJ factor, use MatGetFactor() */
+  B->ops->lufactor  = NULL;
+  B->ops->ilufactor = NULL;
+
+  /* the products with other matrices and the finite difference colorings write into or keep pointers to the values */
+  B->ops->matmult                   = NULL;
+  B->ops->matmultsymbolic           = NULL;
+  B->ops->matmultnumeric            = NULL;
+  B->ops->ptap                      = NULL;
+  B->ops->ptapsymbolic              = NULL;
+  B->ops->ptapnumeric               = NULL;
+  B->ops->mattransposemult          = NULL;
+  B->ops->mattransposemultsymbolic  = NULL;
+  B->ops->mattransposemultnumeric   = NULL;
+  B->ops->transposematmult          = NULL;
+  B->ops->transposematmultsymbolic  = NULL;
+  B->ops->transposematmultnumeric   = NULL;
+  B->ops->matmatmult                = NULL;
+  B->ops->matmatmultsymbolic        = NULL;
+  B->ops->matmatmultnumeric         = NULL;
+  B->ops->rart                      = NULL;
+  B->ops->rartsymbolic              = NULL;
+  B->ops->rartnumeric               = NULL;
+  B->ops->transposecoloringcreate   = NULL;
+  B->ops->transcoloringapplysptoden = NULL;
+  B->ops->transcoloringapplydentosp = NULL;
+  B->ops->fdcoloringcreate          = NULL;
+  B->ops->fdcoloringsetup           = NULL;
+  B->ops->fdcoloringapply           = NULL;
+  PetscFunctionReturn(0);
+}
+
+/* Replaces a function composed by MATSEQAIJ with its MATSEQAIJSINGLE version, saving the original in orig */
+#define MatSeqAIJSingleComposeFunction(B,name,orig,fn) \
+  do { \
+    ierr = PetscObjectQueryFunction((PetscObject)(B),name,&(orig));CHKERRQ(ierr); \
+    ierr = PetscObjectComposeFunction((PetscObject)(B),name,fn);CHKERRQ(ierr); \
+  } while (0)
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJSingle_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATSEQAIJSINGLE to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode   ierr;
+  Mat              B = *newmat;
+  Mat_SeqAIJ       *b;
+  Mat_SeqAIJSingle *aijsingle;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  b         = (Mat_SeqAIJ*)B->data;
+  aijsingle = (Mat_SeqAIJSingle*)B->spptr;
+
+  /* Move the values back into double precision and reset the original function pointers. */
+  ierr = MatSeqAIJSingleExpandValues_Private(B);CHKERRQ(ierr);
+  *B->ops = aijsingle->ops;
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJGetArray_C",aijsingle->getarray);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJRestoreArray_C",aijsingle->restorearray);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatStoreValues_C",aijsingle->storevalues);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",aijsingle->retrievevalues);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",aijsingle->setvaluescoo);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatIsTranspose_C",aijsingle->istranspose);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatIsHermitianTranspose_C",aijsingle->ishermitiantranspose);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatReorderForNonzeroDiagonal_C",aijsingle->reorderfornonzerodiagonal);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetPreallocation_C",aijsingle->setpreallocation);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatResetPreallocation_C",aijsingle->resetpreallocation);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetPreallocationCSR_C",aijsingle->setpreallocationcsr);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",aijsingle->setpreallocationcoo);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijsingle_seqaij_C",NULL);CHKERRQ(ierr);
+
+  /* Clean up the Mat_SeqAIJSingle data structure. */
+  ierr = PetscFree(aijsingle->rowvalues);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+
+  /* Select the inode, threaded and delta encoded products again, as the assembly of a MATSEQAIJ does. */
+  if (B->assembled) {
+    b->inode.checked = PETSC_FALSE;
+    ierr = MatSeqAIJCheckInode(B);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd_SeqAIJ_Threads(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd_SeqAIJ_Delta(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJSingle converts a SeqAIJ matrix into a
+ * SeqAIJSingle matrix.  This routine is called by the MatCreate_SeqAIJSingle()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJSingle one, whose values are then rounded to single precision. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode   ierr;
+  Mat              B = *newmat;
+  Mat_SeqAIJSingle *aijsingle;
+  PetscBool        sametype;
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_COMPLEX)
+  SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"MATSEQAIJSINGLE is not supported for complex numbers");
+#endif
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr       = PetscNewLog(B,&aijsingle);CHKERRQ(ierr);
+  B->spptr   = (void*)aijsingle;
+  aijsingle->ops = *B->ops;
+
+  /* Parse command line options. */
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)A),((PetscObject)A)->prefix,"AIJSINGLE Options","Mat");CHKERRQ(ierr);
+#if defined(PETSC_USE_64BIT_INDICES)
+  ierr = PetscOptionsBool("-mat_aijsingle_int32_indices","Keep a 32-bit copy of the column indices for the products","None",aijsingle->int32,&aijsingle->int32,NULL);CHKERRQ(ierr);
+  if (aijsingle->int32 && B->cmap->n > PETSC_MPI_INT_MAX) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Too many columns for 32-bit column indices");
+#endif
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+
+  ierr = MatSeqAIJSingleSetOps_Private(B);CHKERRQ(ierr);
+  MatSeqAIJSingleComposeFunction(B,"MatSeqAIJGetArray_C",aijsingle->getarray,MatSeqAIJGetArray_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatSeqAIJRestoreArray_C",aijsingle->restorearray,MatSeqAIJRestoreArray_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatStoreValues_C",aijsingle->storevalues,MatStoreValues_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatRetrieveValues_C",aijsingle->retrievevalues,MatRetrieveValues_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatSetValuesCOO_C",aijsingle->setvaluescoo,MatSetValuesCOO_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatIsTranspose_C",aijsingle->istranspose,MatIsTranspose_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatIsHermitianTranspose_C",aijsingle->ishermitiantranspose,MatIsHermitianTranspose_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatReorderForNonzeroDiagonal_C",aijsingle->reorderfornonzerodiagonal,MatReorderForNonzeroDiagonal_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatSeqAIJSetPreallocation_C",aijsingle->setpreallocation,MatSeqAIJSetPreallocation_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatResetPreallocation_C",aijsingle->resetpreallocation,MatResetPreallocation_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatSeqAIJSetPreallocationCSR_C",aijsingle->setpreallocationcsr,MatSeqAIJSetPreallocationCSR_SeqAIJSingle);
+  MatSeqAIJSingleComposeFunction(B,"MatSetPreallocationCOO_C",aijsingle->setpreallocationcoo,MatSetPreallocationCOO_SeqAIJSingle);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijsingle_seqaij_C",MatConvert_SeqAIJSingle_SeqAIJ);CHKERRQ(ierr);
+
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJSINGLE);CHKERRQ(ierr);
+  if (B->assembled) {ierr = MatSeqAIJSingleCompressValues_Private(B);CHKERRQ(ierr);}
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJSingle - Creates a sparse matrix of type SEQAIJSINGLE.
+   This type inherits from AIJ, but once the matrix is assembled its values are stored in
+   single precision only: each nonzero takes sizeof(float)+sizeof(PetscInt) bytes instead of
+   sizeof(PetscScalar)+sizeof(PetscInt). MatMult(), MatMultAdd(), MatMultTranspose(), MatMultTransposeAdd(),
+   MatSOR(), MatGetDiagonal(), MatGetRow() and MatGetValues() read the single precision values and accumulate
+   in PetscScalar, which reduces the memory traffic of bandwidth-bound Krylov solves, at the price of
+   perturbing the operator by the single precision roundoff.
+   Because SEQAIJSINGLE is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijsingle" can be used to make
+   sequential AIJ matrices default to being instances of MATSEQAIJSINGLE.
+
+   Collective on MPI_Comm
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Options Database Keys:
+.  -mat_aijsingle_int32_indices - in builds with 64-bit indices, also keep a 32-bit copy of the column indices for the products
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   The values set with MatSetValues() are rounded to single precision at the final assembly; until then they are
+   kept in double precision. Operations without a single precision implementation, such as MatTranspose(),
+   MatAXPY() or MatCreateSubMatrices(), expand the values to double precision for the length of the call.
+   The factorizations from MatGetFactor() are computed from the expanded values and stored in double precision,
+   so the matrix can be used as the preconditioner matrix of PCILU, PCICC, PCJACOBI and PCSOR and of PCMG smoothers.
+   The products with other matrices (MatMatMult(), MatPtAP(), ...) and MatFDColoring are not supported.
+   MatGetInfo() reports the memory used, with the single precision values.
+
+   Not available for complex numbers.
+
+   Level: intermediate
+
+.keywords: matrix, sparse, mixed precision
+
+.seealso: MatCreate(), MatCreateMPIAIJSingle(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateSeqAIJSingle(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJSINGLE);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSingle(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJSingle(A,MATSEQAIJSINGLE,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
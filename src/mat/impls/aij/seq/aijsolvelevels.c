@@ -0,0 +1,274 @@
+/*
+    Level-scheduled triangular solves for the LU and ILU factors of the SeqAIJ matrix storage format. Row i of L is in
+  level 1 + the largest level of the rows j < i it references (0 if it references none) and the rows of a level do not
+  depend on each other, likewise for U in the reverse direction. The levels are computed once from the nonzero structure
+  of the factor by the symbolic factorization; MatSolve() then runs the rows of each level with the OpenMP threads of
+  -mat_aij_threads, either with a barrier after each level or, for the sync-free variant, with each row waiting only
+  for the rows it references.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+static const char *const MatSeqAIJSolveTypes[] = {"serial","level","syncfree","MatSeqAIJSolveType","MAT_SEQAIJ_SOLVE_",0};
+
+PetscErrorCode MatDestroy_SeqAIJ_SolveLevels(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree4(a->solvelevels.lstart,a->solvelevels.lrows,a->solvelevels.ustart,a->solvelevels.urows);CHKERRQ(ierr);
+  ierr = PetscFree(a->solvelevels.ready);CHKERRQ(ierr);
+  a->solvelevels.lnlevels = a->solvelevels.unlevels = 0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Sorts the rows by level with a counting sort, so the rows of each level stay in increasing order; start[] gets the
+   first position in rows[] of each level.
+*/
+static PetscErrorCode MatSeqAIJSolveLevelsSort_Private(PetscInt n,PetscInt nlevels,const PetscInt *level,PetscInt *start,PetscInt *rows)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,*next;
+
+  PetscFunctionBegin;
+  ierr = PetscCalloc1(nlevels+1,&next);CHKERRQ(ierr);
+  for (i=0; i<n; i++) next[level[i]+1]++;
+  for (i=0; i<nlevels; i++) next[i+1] += next[i];
+  ierr = PetscMemcpy(start,next,(nlevels+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  for (i=0; i<n; i++) rows[next[level[i]]++] = i;
+  ierr = PetscFree(next);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Called at the end of the symbolic LU and ILU factorizations, when the nonzero structure of the factor is known
+*/
+PetscErrorCode MatSeqAIJSolveLevelsSetUp(Mat fact)
+{
+  Mat_SeqAIJ             *b = (Mat_SeqAIJ*)fact->data;
+  Mat_SeqAIJ_SolveLevels *levels = &b->solvelevels;
+  PetscErrorCode         ierr;
+  PetscInt               n = fact->rmap->n,i,k,lev,*level;
+  const PetscInt         *bi = b->i,*bj = b->j,*bdiag = b->diag,*vj;
+  MatSeqAIJSolveType     type = MAT_SEQAIJ_SOLVE_SERIAL;
+
+  PetscFunctionBegin;
+  ierr = MatDestroy_SeqAIJ_SolveLevels(fact);CHKERRQ(ierr);
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)fact),((PetscObject)fact)->prefix,"Options for SEQAIJ factored matrix","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsEnum("-mat_aij_solve_schedule","Schedule of the rows in the triangular solves","None",MatSeqAIJSolveTypes,(PetscEnum)type,(PetscEnum*)&type,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+#if !defined(PETSC_HAVE_OPENMP)
+  if (type != MAT_SEQAIJ_SOLVE_SERIAL) {
+    ierr = PetscInfo(fact,"Ignoring -mat_aij_solve_schedule since PETSc was not configured with OpenMP\n");CHKERRQ(ierr);
+    type = MAT_SEQAIJ_SOLVE_SERIAL;
+  }
+#endif
+  levels->type     = type;
+  levels->nthreads = b->threads.nthreads;
+  if (type == MAT_SEQAIJ_SOLVE_SERIAL) PetscFunctionReturn(0);
+
+  ierr = PetscMalloc1(n,&level);CHKERRQ(ierr);
+  /* levels of L, the strictly lower triangular part of row i is bj[bi[i]:bi[i+1]] */
+  levels->lnlevels = 0;
+  for (i=0; i<n; i++) {
+    lev = 0;
+    vj  = bj + bi[i];
+    for (k=0; k<bi[i+1]-bi[i]; k++) lev = PetscMax(lev,level[vj[k]]+1);
+    level[i]         = lev;
+    levels->lnlevels = PetscMax(levels->lnlevels,lev+1);
+  }
+  /* U has at most n levels */
+  ierr = PetscMalloc4(levels->lnlevels+1,&levels->lstart,n,&levels->lrows,n+1,&levels->ustart,n,&levels->urows);CHKERRQ(ierr);
+  ierr = MatSeqAIJSolveLevelsSort_Private(n,levels->lnlevels,level,levels->lstart,levels->lrows);CHKERRQ(ierr);
+
+  /* levels of U, the strictly upper triangular part of row i is bj[bdiag[i+1]+1:bdiag[i]] */
+  levels->unlevels = 0;
+  for (i=n-1; i>=0; i--) {
+    lev = 0;
+    vj  = bj + bdiag[i+1] + 1;
+    for (k=0; k<bdiag[i]-bdiag[i+1]-1; k++) lev = PetscMax(lev,level[vj[k]]+1);
+    level[i]         = lev;
+    levels->unlevels = PetscMax(levels->unlevels,lev+1);
+  }
+  ierr = MatSeqAIJSolveLevelsSort_Private(n,levels->unlevels,level,levels->ustart,levels->urows);CHKERRQ(ierr);
+  ierr = PetscFree(level);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)fact,(levels->lnlevels+3*n+2)*sizeof(PetscInt));CHKERRQ(ierr);
+
+  if (type == MAT_SEQAIJ_SOLVE_SYNCFREE) {
+    ierr = PetscCalloc1(n,&levels->ready);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)fact,n*sizeof(PetscInt));CHKERRQ(ierr);
+    levels->stamp = 0;
+  }
+  ierr = PetscInfo4(fact,"%s triangular solves with %D threads, %D levels in L and %D levels in U\n",MatSeqAIJSolveTypes[type],levels->nthreads,levels->lnlevels,levels->unlevels);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatView_SeqAIJ_SolveLevels(Mat A,PetscViewer viewer)
+{
+  Mat_SeqAIJ             *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_SolveLevels *levels = &a->solvelevels;
+  PetscErrorCode         ierr;
+  PetscBool              iascii;
+  PetscViewerFormat      format;
+  PetscInt               k,n = A->rmap->n,lmax = 0,umax = 0;
+
+  PetscFunctionBegin;
+  if (!A->factortype || levels->type == MAT_SEQAIJ_SOLVE_SERIAL || !levels->lstart) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (!iascii) PetscFunctionReturn(0);
+  ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+  if (format != PETSC_VIEWER_ASCII_INFO_DETAIL && format != PETSC_VIEWER_ASCII_INFO) PetscFunctionReturn(0);
+  for (k=0; k<levels->lnlevels; k++) lmax = PetscMax(lmax,levels->lstart[k+1]-levels->lstart[k]);
+  for (k=0; k<levels->unlevels; k++) umax = PetscMax(umax,levels->ustart[k+1]-levels->ustart[k]);
+  ierr = PetscViewerASCIIPrintf(viewer,"%s scheduled triangular solves with %D threads\n",MatSeqAIJSolveTypes[levels->type],levels->nthreads);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"  L: %D levels, rows per level average %g max %D\n",levels->lnlevels,levels->lnlevels ? (double)n/levels->lnlevels : 0.0,lmax);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"  U: %D levels, rows per level average %g max %D\n",levels->unlevels,levels->unlevels ? (double)n/levels->unlevels : 0.0,umax);CHKERRQ(ierr);
+  if (format == PETSC_VIEWER_ASCII_INFO_DETAIL) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  rows in each level of L:");CHKERRQ(ierr);
+    ierr = PetscViewerASCIIUseTabs(viewer,PETSC_FALSE);CHKERRQ(ierr);
+    for (k=0; k<levels->lnlevels; k++) {ierr = PetscViewerASCIIPrintf(viewer," %D",levels->lstart[k+1]-levels->lstart[k]);CHKERRQ(ierr);}
+    ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
+    ierr = PetscViewerASCIIUseTabs(viewer,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  rows in each level of U:");CHKERRQ(ierr);
+    ierr = PetscViewerASCIIUseTabs(viewer,PETSC_FALSE);CHKERRQ(ierr);
+    for (k=0; k<levels->unlevels; k++) {ierr = PetscViewerASCIIPrintf(viewer," %D",levels->ustart[k+1]-levels->ustart[k]);CHKERRQ(ierr);}
+    ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
+    ierr = PetscViewerASCIIUseTabs(viewer,PETSC_TRUE);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_OPENMP)
+/*
+   Same arithmetic as MatSolve_SeqAIJ(), so the result does not depend on the schedule or the number of threads.
+
+   With the sync-free schedule each thread takes its rows of a triangle in level order and waits on the ready[] stamps
+   of the rows they reference. A row only references rows of lower levels, which come earlier in the order, so the
+   lowest row not yet computed never waits and the solve cannot deadlock.
+*/
+PetscErrorCode MatSolve_SeqAIJ_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ             *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_SolveLevels *levels = &a->solvelevels;
+  PetscErrorCode         ierr;
+  PetscInt               n = A->rmap->n,lstamp,ustamp;
+  const PetscInt         *ai = a->i,*aj = a->j,*adiag = a->diag,*r,*c;
+  const PetscInt         *lstart = levels->lstart,*lrows = levels->lrows,*ustart = levels->ustart,*urows = levels->urows;
+  PetscInt               *ready = levels->ready;
+  PetscScalar            *x,*tmp = a->solve_work;
+  const PetscScalar      *b;
+  const MatScalar        *aa = a->a;
+  PetscBool              syncfree = (PetscBool)(levels->type == MAT_SEQAIJ_SOLVE_SYNCFREE);
+
+  PetscFunctionBegin;
+  if (!lstart) { /* for example a MatDuplicate() of the factor */
+    ierr = MatSolve_SeqAIJ(A,bb,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (!n) PetscFunctionReturn(0);
+  if (syncfree) {
+    if (levels->stamp > PETSC_MAX_INT - 2) {
+      ierr          = PetscMemzero(ready,n*sizeof(PetscInt));CHKERRQ(ierr);
+      levels->stamp = 0;
+    }
+    lstamp = ++levels->stamp;
+    ustamp = ++levels->stamp;
+  } else lstamp = ustamp = 0;
+
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+
+#pragma omp parallel num_threads(levels->nthreads)
+  {
+    PetscInt        lev,p,i,k,nz,f;
+    const PetscInt  *vi;
+    const MatScalar *v;
+    PetscScalar     sum;
+
+    /* forward solve the lower triangular */
+    if (syncfree) {
+#pragma omp for schedule(static,1)
+      for (p=0; p<n; p++) {
+        i   = lrows[p];
+        nz  = ai[i+1] - ai[i];
+        v   = aa + ai[i];
+        vi  = aj + ai[i];
+        for (k=0; k<nz; k++) {
+          do {
+#pragma omp atomic read
+            f = ready[vi[k]];
+          } while (f != lstamp);
+        }
+#pragma omp flush
+        sum = b[r[i]];
+        PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+        tmp[i] = sum;
+#pragma omp flush
+#pragma omp atomic write
+        ready[i] = lstamp;
+      }
+    } else {
+      for (lev=0; lev<levels->lnlevels; lev++) {
+#pragma omp for schedule(static)
+        for (p=lstart[lev]; p<lstart[lev+1]; p++) {
+          i   = lrows[p];
+          nz  = ai[i+1] - ai[i];
+          v   = aa + ai[i];
+          vi  = aj + ai[i];
+          sum = b[r[i]];
+          PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+          tmp[i] = sum;
+        }
+      }
+    }
+
+    /* backward solve the upper triangular, after the barrier at the end of the forward solve */
+    if (syncfree) {
+#pragma omp for schedule(static,1)
+      for (p=0; p<n; p++) {
+        i   = urows[p];
+        nz  = adiag[i] - adiag[i+1] - 1;
+        v   = aa + adiag[i+1] + 1;
+        vi  = aj + adiag[i+1] + 1;
+        for (k=0; k<nz; k++) {
+          do {
+#pragma omp atomic read
+            f = ready[vi[k]];
+          } while (f != ustamp);
+        }
+#pragma omp flush
+        sum = tmp[i];
+        PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+        x[c[i]] = tmp[i] = sum*v[nz];
+#pragma omp flush
+#pragma omp atomic write
+        ready[i] = ustamp;
+      }
+    } else {
+      for (lev=0; lev<levels->unlevels; lev++) {
+#pragma omp for schedule(static)
+        for (p=ustart[lev]; p<ustart[lev+1]; p++) {
+          i   = urows[p];
+          nz  = adiag[i] - adiag[i+1] - 1;
+          v   = aa + adiag[i+1] + 1;
+          vi  = aj + adiag[i+1] + 1;
+          sum = tmp[i];
+          PetscSparseDenseMinusDot(sum,tmp,v,vi,nz);
+          x[c[i]] = tmp[i] = sum*v[nz]; /* v[nz] = aa[adiag[i]] */
+        }
+      }
+    }
+  }
+
+  ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz - A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
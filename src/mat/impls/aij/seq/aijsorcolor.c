@@ -0,0 +1,200 @@
+/*
+    Multicolor SOR and Gauss-Seidel for the SeqAIJ matrix storage format. The rows are colored with a distance one
+  MatColoring of the (symmetrized) nonzero structure so that no two rows of the same color are coupled; a sweep then
+  relaxes the colors one after the other, and the rows of each color are relaxed concurrently by the OpenMP threads of
+  -mat_aij_threads with a barrier between colors. The ordering of the unknowns, and thus the result of MatSOR(), does
+  not depend on the number of threads. The coloring is computed by the first MatSOR() and again only when the nonzero
+  structure has changed.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+PetscErrorCode MatCreate_SeqAIJ_SORColor(Mat B)
+{
+  Mat_SeqAIJ     *b = (Mat_SeqAIJ*)B->data;
+  PetscErrorCode ierr;
+  PetscBool      use = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"Options for SEQAIJ matrix","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-mat_sor_multicolor","Order the rows by color in MatSOR() and relax the rows of each color with the threads of -mat_aij_threads",NULL,use,&use,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  b->sorcolor.use = use;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJ_SORColor(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(a->sorcolor.cstart,a->sorcolor.rows);CHKERRQ(ierr);
+  a->sorcolor.ncolors          = 0;
+  a->sorcolor.mat_nonzerostate = 0;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatView_SeqAIJ_SORColor(Mat A,PetscViewer viewer)
+{
+  Mat_SeqAIJ          *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_SORColor *sorcolor = &a->sorcolor;
+  PetscErrorCode      ierr;
+  PetscBool           iascii;
+  PetscViewerFormat   format;
+  PetscInt            c,nmin,nmax;
+
+  PetscFunctionBegin;
+  if (!sorcolor->use) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (!iascii) PetscFunctionReturn(0);
+  ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+  if (format != PETSC_VIEWER_ASCII_INFO_DETAIL && format != PETSC_VIEWER_ASCII_INFO) PetscFunctionReturn(0);
+  if (!sorcolor->rows) {
+    ierr = PetscViewerASCIIPrintf(viewer,"multicolor SOR, coloring not yet computed\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  nmin = PETSC_MAX_INT;
+  nmax = 0;
+  for (c=0; c<sorcolor->ncolors; c++) {
+    nmin = PetscMin(nmin,sorcolor->cstart[c+1]-sorcolor->cstart[c]);
+    nmax = PetscMax(nmax,sorcolor->cstart[c+1]-sorcolor->cstart[c]);
+  }
+  ierr = PetscViewerASCIIPrintf(viewer,"multicolor SOR with %D colors and %D threads, rows per color: min %D max %D\n",sorcolor->ncolors,a->threads.nthreads,nmin,nmax);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJ_SORColor(Mat A,Mat C)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ*)A->data,*c = (Mat_SeqAIJ*)C->data;
+
+  PetscFunctionBegin;
+  c->sorcolor.use = a->sorcolor.use;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Colors the rows with a distance one coloring of the nonzero structure of A + A^T, or of A if it is known to be
+   structurally symmetric, and lists the rows of each color in increasing order. The coloring type defaults to greedy
+   with lexical weights, which gives the red-black ordering on five point stencils; it can be changed with the
+   MatColoring options prefixed by -[prefix]sor_, e.g. -sor_mat_coloring_type jp.
+*/
+PetscErrorCode MatSeqAIJSORColorSetUp(Mat A)
+{
+  Mat_SeqAIJ          *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_SORColor *sorcolor = &a->sorcolor;
+  PetscErrorCode      ierr;
+  Mat                 G;
+  MatColoring         mc;
+  ISColoring          iscoloring;
+  IS                  *is;
+  PetscInt            c,k,nc,n,cnt = 0;
+  const PetscInt      *rows;
+
+  PetscFunctionBegin;
+  if (sorcolor->rows && sorcolor->mat_nonzerostate == A->nonzerostate) PetscFunctionReturn(0);
+  ierr = MatDestroy_SeqAIJ_SORColor(A);CHKERRQ(ierr);
+  if (A->structurally_symmetric_set && A->structurally_symmetric) {
+    ierr = PetscObjectReference((PetscObject)A);CHKERRQ(ierr);
+    G    = A;
+  } else {
+    ierr = MatTranspose(A,MAT_INITIAL_MATRIX,&G);CHKERRQ(ierr);
+    ierr = MatAXPY(G,1.0,A,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  }
+  ierr = MatColoringCreate(G,&mc);CHKERRQ(ierr);
+  ierr = PetscObjectSetOptionsPrefix((PetscObject)mc,((PetscObject)A)->prefix);CHKERRQ(ierr);
+  ierr = PetscObjectAppendOptionsPrefix((PetscObject)mc,"sor_");CHKERRQ(ierr);
+  ierr = MatColoringSetDistance(mc,1);CHKERRQ(ierr);
+  ierr = MatColoringSetType(mc,MATCOLORINGGREEDY);CHKERRQ(ierr);
+  ierr = MatColoringSetWeightType(mc,MAT_COLORING_WEIGHT_LEXICAL);CHKERRQ(ierr);
+  ierr = MatColoringSetFromOptions(mc);CHKERRQ(ierr);
+  ierr = MatColoringApply(mc,&iscoloring);CHKERRQ(ierr);
+  ierr = MatColoringDestroy(&mc);CHKERRQ(ierr);
+  ierr = MatDestroy(&G);CHKERRQ(ierr);
+
+  ierr = ISColoringGetIS(iscoloring,&nc,&is);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nc+1,&sorcolor->cstart,A->rmap->n,&sorcolor->rows);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,(nc+1+A->rmap->n)*sizeof(PetscInt));CHKERRQ(ierr);
+  sorcolor->cstart[0] = 0;
+  for (c=0; c<nc; c++) {
+    ierr = ISGetLocalSize(is[c],&n);CHKERRQ(ierr);
+    ierr = ISGetIndices(is[c],&rows);CHKERRQ(ierr);
+    for (k=0; k<n; k++) sorcolor->rows[cnt++] = rows[k];
+    ierr = ISRestoreIndices(is[c],&rows);CHKERRQ(ierr);
+    sorcolor->cstart[c+1] = cnt;
+  }
+  ierr = ISColoringRestoreIS(iscoloring,&is);CHKERRQ(ierr);
+  ierr = ISColoringDestroy(&iscoloring);CHKERRQ(ierr);
+  if (cnt != A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Coloring has %D rows, matrix has %D",cnt,A->rmap->n);
+  sorcolor->ncolors          = nc;
+  sorcolor->mat_nonzerostate = A->nonzerostate;
+  ierr = PetscInfo3(A,"Multicolor SOR with %D colors for %D rows, %D threads\n",nc,A->rmap->n,a->threads.nthreads);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Called by MatSOR_SeqAIJ() once idiag[] = omega/(mdiag[] + fshift) is up to date, for the forward, backward and
+   symmetric sweeps (local or not, with or without zero initial guess); its is the total number of sweeps its*lits.
+   Row i is relaxed with x[i] = (1 - omega) x[i] + idiag[i] (b[i] - sum_{j != i} a_ij x[j]). The flops of the colors
+   skipped by the symmetric sweeps with omega = 1 are not subtracted.
+*/
+PetscErrorCode MatSOR_SeqAIJ_MultiColor(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscInt its,Vec xx)
+{
+  Mat_SeqAIJ          *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_SORColor *sorcolor = &a->sorcolor;
+  PetscErrorCode      ierr;
+  PetscScalar         *x;
+  const PetscScalar   *b;
+  const MatScalar     *aa = a->a,*idiag = a->idiag,*mdiag = a->mdiag;
+  const PetscInt      *ai = a->i,*aj = a->j;
+  PetscBool           forward,backward;
+  PetscInt            nsweeps;
+
+  PetscFunctionBegin;
+  ierr     = MatSeqAIJSORColorSetUp(A);CHKERRQ(ierr);
+  forward  = (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) ? PETSC_TRUE : PETSC_FALSE;
+  backward = (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) ? PETSC_TRUE : PETSC_FALSE;
+  nsweeps  = (forward ? 1 : 0) + (backward ? 1 : 0);
+  if (flag & SOR_ZERO_INITIAL_GUESS) {ierr = VecSet(xx,0.0);CHKERRQ(ierr);}
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel num_threads(a->threads.nthreads)
+#endif
+  {
+    const PetscInt  *rows = sorcolor->rows,*cstart = sorcolor->cstart,nc = sorcolor->ncolors;
+    const MatScalar *v;
+    const PetscInt  *idx;
+    PetscScalar     sum;
+    PetscInt        k,s,c,cc,p,i,n,last = -1;
+
+    for (k=0; k<its; k++) {
+      for (s=0; s<2; s++) {
+        if ((!s && !forward) || (s && !backward)) continue;
+        for (cc=0; cc<nc; cc++) {
+          c = s ? nc-1-cc : cc;
+          /* the rows of a color only depend on the other colors, so with omega = 1 relaxing it twice in a row does nothing */
+          if (c == last && omega == 1.0) continue;
+          last = c;
+          /* the implicit barrier at the end of the loop separates the colors */
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+          for (p=cstart[c]; p<cstart[c+1]; p++) {
+            i   = rows[p];
+            n   = ai[i+1] - ai[i];
+            idx = aj + ai[i];
+            v   = aa + ai[i];
+            sum = b[i];
+            PetscSparseDenseMinusDot(sum,x,v,idx,n);
+            x[i] = (1. - omega)*x[i] + (sum + mdiag[i]*x[i])*idiag[i];
+          }
+        }
+      }
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = PetscLogFlops(its*nsweeps*(2.0*a->nz + 4.0*A->rmap->n));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
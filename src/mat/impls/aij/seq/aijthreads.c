@@ -0,0 +1,378 @@
+/*
+    OpenMP threaded versions of MatMult(), MatMultAdd(), MatMultTranspose() and MatMultTransposeAdd() for the
+  SeqAIJ matrix storage format. The rows are split into nthreads contiguous blocks with (roughly) the same number of
+  nonzeros, and the a, i and j arrays are first-touched by the thread that owns them so that on NUMA machines each
+  block lives in the memory closest to the core that uses it. If the OpenMP runtime provides fewer threads than
+  requested the blocks are shared out cyclically between the threads that are available.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+PetscErrorCode MatCreate_SeqAIJ_Threads(Mat B)
+{
+  Mat_SeqAIJ     *b = (Mat_SeqAIJ*)B->data;
+  PetscErrorCode ierr;
+  PetscInt       nthreads = 1;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"Options for SEQAIJ matrix","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aij_threads","Number of OpenMP threads used by MatMult() and related products, 0 for omp_get_max_threads()",NULL,nthreads,&nthreads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (nthreads < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D cannot be negative",nthreads);
+#if defined(PETSC_HAVE_OPENMP)
+  if (!nthreads) nthreads = omp_get_max_threads();
+#else
+  if (nthreads != 1) {
+    ierr     = PetscInfo(B,"Ignoring -mat_aij_threads since PETSc was not configured with OpenMP\n");CHKERRQ(ierr);
+    nthreads = 1;
+  }
+#endif
+  b->threads.nthreads = nthreads;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJ_Threads(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(a->threads.rstart,a->threads.nstart,a->threads.time);CHKERRQ(ierr);
+  ierr = PetscFree(a->threads.work);CHKERRQ(ierr);
+  a->threads.worksize = 0;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatView_SeqAIJ_Threads(Mat A,PetscViewer viewer)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Threads *threads = &a->threads;
+  PetscErrorCode     ierr;
+  PetscBool          iascii;
+  PetscViewerFormat  format;
+  PetscInt           t,nz,nzmin,nzmax;
+  PetscLogDouble     tmax = 0.0,tsum = 0.0;
+
+  PetscFunctionBegin;
+  if (threads->nthreads < 2) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (!iascii) PetscFunctionReturn(0);
+  ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+  if (format != PETSC_VIEWER_ASCII_INFO_DETAIL && format != PETSC_VIEWER_ASCII_INFO) PetscFunctionReturn(0);
+  ierr = PetscViewerASCIIPrintf(viewer,"using %D OpenMP threads for MatMult() and related products\n",threads->nthreads);CHKERRQ(ierr);
+  if (!threads->rstart) PetscFunctionReturn(0);
+  nzmin = PETSC_MAX_INT;
+  nzmax = 0;
+  for (t=0; t<threads->nthreads; t++) {
+    nz    = a->i[threads->rstart[t+1]] - a->i[threads->rstart[t]];
+    nzmin = PetscMin(nzmin,nz);
+    nzmax = PetscMax(nzmax,nz);
+    tmax  = PetscMax(tmax,threads->time[t]);
+    tsum += threads->time[t];
+  }
+  ierr = PetscViewerASCIIPrintf(viewer,"  nonzeros per thread: min %D max %D\n",nzmin,nzmax);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"  time imbalance (max/average) %g\n",tsum > 0.0 ? (double)(tmax*threads->nthreads/tsum) : 1.0);CHKERRQ(ierr);
+  if (format == PETSC_VIEWER_ASCII_INFO_DETAIL) {
+    ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+    for (t=0; t<threads->nthreads; t++) {
+      ierr = PetscViewerASCIISynchronizedPrintf(viewer,"  [%D] rows %D to %D, nonzeros %D, time %g\n",t,threads->rstart[t],threads->rstart[t+1],a->i[threads->rstart[t+1]] - a->i[threads->rstart[t]],(double)threads->time[t]);CHKERRQ(ierr);
+    }
+    ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJ_Threads(Mat A,Mat C)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data,*c = (Mat_SeqAIJ*)C->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  c->threads.nthreads = a->threads.nthreads;
+  /* the factor routines duplicate without allocating the matrix space, the numeric factorization fills it in later */
+  if (!C->factortype && c->i) {
+    ierr = MatAssemblyEnd_SeqAIJ_Threads(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_OPENMP)
+/*
+   Splits the rows (or the inodes if they are used) into nthreads contiguous blocks, balancing the number of nonzeros
+   plus the number of rows of each block. Called again only when the nonzero structure has changed.
+*/
+PetscErrorCode MatSeqAIJThreadsSetUp(Mat A)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Threads *threads = &a->threads;
+  PetscErrorCode     ierr;
+  PetscInt           nt = threads->nthreads,m = A->rmap->n,t,i,row,lo,hi,mid,nz,nzmax = 0;
+  const PetscInt     *ai = a->i,*ns = a->inode.size;
+  PetscReal          target;
+
+  PetscFunctionBegin;
+  if (threads->rstart && threads->mat_nonzerostate == A->nonzerostate) PetscFunctionReturn(0);
+  if (!threads->rstart) {
+    ierr = PetscMalloc3(nt+1,&threads->rstart,nt+1,&threads->nstart,nt,&threads->time);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,2*(nt+1)*sizeof(PetscInt)+nt*sizeof(PetscLogDouble));CHKERRQ(ierr);
+  }
+  threads->rstart[0] = threads->nstart[0] = 0;
+  if (ns) {
+    for (i=0,row=0,t=1; i<a->inode.node_count && t<nt; row+=ns[i++]) {
+      target = ((PetscReal)t*(ai[m]+m))/nt;
+      while (t < nt && (PetscReal)ai[row]+row >= target) {
+        threads->nstart[t] = i;
+        threads->rstart[t] = row;
+        target = ((PetscReal)++t*(ai[m]+m))/nt;
+      }
+    }
+    for (; t<=nt; t++) {
+      threads->nstart[t] = a->inode.node_count;
+      threads->rstart[t] = m;
+    }
+  } else {
+    for (t=1; t<nt; t++) {
+      /* first row r with ai[r] + r >= t*(nz + m)/nt */
+      target = ((PetscReal)t*(ai[m]+m))/nt;
+      lo     = threads->rstart[t-1];
+      hi     = m;
+      while (lo < hi) {
+        mid = lo + (hi - lo)/2;
+        if ((PetscReal)ai[mid]+mid < target) lo = mid + 1;
+        else hi = mid;
+      }
+      threads->rstart[t] = lo;
+    }
+    threads->rstart[nt] = m;
+  }
+  for (t=0; t<nt; t++) {
+    nz               = ai[threads->rstart[t+1]] - ai[threads->rstart[t]];
+    nzmax            = PetscMax(nzmax,nz);
+    threads->time[t] = 0.0;
+  }
+  ierr = PetscInfo3(A,"Split %D rows over %D threads, nonzero imbalance (max/average) %g\n",m,nt,ai[m] ? (double)((PetscReal)nzmax*nt/ai[m]) : 1.0);CHKERRQ(ierr);
+  threads->mat_nonzerostate = A->nonzerostate;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Copies the a, i and j arrays into newly allocated arrays, each thread copying its own block of rows so that the
+   pages holding the block are placed (on first touch) in the memory closest to that thread
+*/
+static PetscErrorCode MatSeqAIJThreadsFirstTouch_Private(Mat A)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Threads *threads = &a->threads;
+  PetscErrorCode     ierr;
+  PetscInt           m = A->rmap->n,nz = a->i[m],*ai,*aj;
+  MatScalar          *aa;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc3(nz,&aa,nz,&aj,m+1,&ai);CHKERRQ(ierr);
+#pragma omp parallel num_threads(threads->nthreads)
+  {
+    PetscInt tid = omp_get_thread_num(),nthr = omp_get_num_threads(),blk,i;
+
+    for (blk=tid; blk<threads->nthreads; blk+=nthr) {
+      for (i=threads->rstart[blk]; i<threads->rstart[blk+1]; i++) ai[i] = a->i[i];
+      for (i=a->i[threads->rstart[blk]]; i<a->i[threads->rstart[blk+1]]; i++) {
+        aj[i] = a->j[i];
+        aa[i] = a->a[i];
+      }
+    }
+  }
+  ai[m] = a->i[m];
+  ierr  = MatSeqXAIJFreeAIJ(A,&a->a,&a->j,&a->i);CHKERRQ(ierr);
+
+  a->a            = aa;
+  a->j            = aj;
+  a->i            = ai;
+  a->maxnz        = nz;
+  a->singlemalloc = PETSC_TRUE;
+  ierr = PetscInfo1(A,"Placed matrix arrays with first touch by %D threads\n",threads->nthreads);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
+PetscErrorCode MatAssemblyEnd_SeqAIJ_Threads(Mat A,MatAssemblyType mode)
+{
+#if defined(PETSC_HAVE_OPENMP)
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Threads *threads = &a->threads;
+  PetscErrorCode     ierr;
+  PetscBool          isseqaij;
+#endif
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP)
+  if (mode == MAT_FLUSH_ASSEMBLY || threads->nthreads < 2 || A->factortype || A->structure_only) PetscFunctionReturn(0);
+  /* subclasses such as MATSEQAIJPERM provide their own products */
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQAIJ,&isseqaij);CHKERRQ(ierr);
+  if (!isseqaij) PetscFunctionReturn(0);
+  ierr = MatSeqAIJThreadsSetUp(A);CHKERRQ(ierr);
+  if (a->singlemalloc && a->nz && threads->placed_nonzerostate != A->nonzerostate) {
+    ierr = MatSeqAIJThreadsFirstTouch_Private(A);CHKERRQ(ierr);
+    threads->placed_nonzerostate = A->nonzerostate;
+  }
+  /* the table of functions below overrides the one set by MatSeqAIJCheckInode() */
+  if (a->inode.size) {
+    A->ops->mult    = MatMult_SeqAIJ_Inode_Threads;
+    A->ops->multadd = MatMultAdd_SeqAIJ_Inode_Threads;
+  } else {
+    A->ops->mult    = MatMult_SeqAIJ_Threads;
+    A->ops->multadd = MatMultAdd_SeqAIJ_Threads;
+  }
+  A->ops->multtranspose    = MatMultTranspose_SeqAIJ_Threads;
+  A->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJ_Threads;
+#endif
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_OPENMP)
+PetscErrorCode MatMult_SeqAIJ_Threads(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Threads *threads = &a->threads;
+  PetscScalar        *y;
+  const PetscScalar  *x;
+  PetscErrorCode     ierr,lerr = 0;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJThreadsSetUp(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+#pragma omp parallel num_threads(threads->nthreads)
+  {
+    PetscInt        tid    = omp_get_thread_num(),nthr = omp_get_num_threads(),blk,i,n;
+    PetscLogDouble  tstart = omp_get_wtime();
+    const PetscInt  *aj,*ii = a->i;
+    const MatScalar *aa;
+    PetscScalar     sum;
+
+    for (blk=tid; blk<threads->nthreads; blk+=nthr) {
+      for (i=threads->rstart[blk]; i<threads->rstart[blk+1]; i++) {
+        n   = ii[i+1] - ii[i];
+        aj  = a->j + ii[i];
+        aa  = a->a + ii[i];
+        sum = 0.0;
+        PetscSparseDensePlusDot(sum,x,aa,aj,n);
+        y[i] = sum;
+      }
+    }
+    MatSeqAIJThreadsEnd_Private(threads,tid,tstart,&lerr);
+  }
+  CHKERRQ(lerr);
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJ_Threads(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Threads *threads = &a->threads;
+  PetscScalar        *y,*z;
+  const PetscScalar  *x;
+  PetscErrorCode     ierr,lerr = 0;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJThreadsSetUp(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+#pragma omp parallel num_threads(threads->nthreads)
+  {
+    PetscInt        tid    = omp_get_thread_num(),nthr = omp_get_num_threads(),blk,i,n;
+    PetscLogDouble  tstart = omp_get_wtime();
+    const PetscInt  *aj,*ii = a->i;
+    const MatScalar *aa;
+    PetscScalar     sum;
+
+    for (blk=tid; blk<threads->nthreads; blk+=nthr) {
+      for (i=threads->rstart[blk]; i<threads->rstart[blk+1]; i++) {
+        n   = ii[i+1] - ii[i];
+        aj  = a->j + ii[i];
+        aa  = a->a + ii[i];
+        sum = y[i];
+        PetscSparseDensePlusDot(sum,x,aa,aj,n);
+        z[i] = sum;
+      }
+    }
+    MatSeqAIJThreadsEnd_Private(threads,tid,tstart,&lerr);
+  }
+  CHKERRQ(lerr);
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Each block of rows accumulates its contributions into a private buffer of the length of the result, the buffers
+   are then summed into the result with the columns split between the threads
+*/
+PetscErrorCode MatMultTransposeAdd_SeqAIJ_Threads(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Threads *threads = &a->threads;
+  PetscScalar        *y;
+  const PetscScalar  *x;
+  PetscErrorCode     ierr,lerr = 0;
+  PetscInt           n = A->cmap->n;
+
+  PetscFunctionBegin;
+  if (zz != yy) {ierr = VecCopy(zz,yy);CHKERRQ(ierr);}
+  ierr = MatSeqAIJThreadsSetUp(A);CHKERRQ(ierr);
+  if (threads->worksize != n) {
+    ierr = PetscFree(threads->work);CHKERRQ(ierr);
+    ierr = PetscMalloc1(threads->nthreads*n,&threads->work);CHKERRQ(ierr);
+    threads->worksize = n;
+  }
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+#pragma omp parallel num_threads(threads->nthreads)
+  {
+    PetscInt        tid    = omp_get_thread_num(),nthr = omp_get_num_threads(),blk,i,j,t,nz;
+    PetscLogDouble  tstart = omp_get_wtime();
+    const PetscInt  *aj,*ii = a->i;
+    const MatScalar *aa;
+    PetscScalar     *w,alpha,sum;
+
+    for (blk=tid; blk<threads->nthreads; blk+=nthr) {
+      w = threads->work + blk*n;
+      for (j=0; j<n; j++) w[j] = 0.0;
+      for (i=threads->rstart[blk]; i<threads->rstart[blk+1]; i++) {
+        nz    = ii[i+1] - ii[i];
+        aj    = a->j + ii[i];
+        aa    = a->a + ii[i];
+        alpha = x[i];
+        for (j=0; j<nz; j++) w[aj[j]] += alpha*aa[j];
+      }
+    }
+#pragma omp barrier
+#pragma omp for schedule(static) nowait
+    for (j=0; j<n; j++) {
+      sum = 0.0;
+      for (t=0; t<threads->nthreads; t++) sum += threads->work[t*n+j];
+      y[j] += sum;
+    }
+    MatSeqAIJThreadsEnd_Private(threads,tid,tstart,&lerr);
+  }
+  CHKERRQ(lerr);
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJ_Threads(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecSet(yy,0.0);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd_SeqAIJ_Threads(A,xx,yy,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
@@ -373,35 +373,31 @@ static PetscErrorCode MatRestoreColumnIJ_SeqAIJ_Inode(Mat A,PetscInt oshift,Pets
 
 /* ----------------------------------------------------------- */
 
-static PetscErrorCode MatMult_SeqAIJ_Inode(Mat A,Vec xx,Vec yy)
+/*
+   Computes y[row..] = A[row..,:] x for the inodes node_start <= i < node_end, where row is the first row of node_start.
+
+   This does not use PetscFunctionBegin/PetscFunctionReturn since it is called from within OpenMP threads by
+   MatMult_SeqAIJ_Inode_Threads(); it returns a nonzero error code for unsupported node sizes instead of calling SETERRQ()
+*/
+PETSC_STATIC_INLINE PetscErrorCode MatMultKernel_SeqAIJ_Inode(const Mat_SeqAIJ *a,const PetscScalar *x,PetscScalar *y,PetscInt node_start,PetscInt node_end,PetscInt row)
 {
-  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
   PetscScalar       sum1,sum2,sum3,sum4,sum5,tmp0,tmp1;
-  PetscScalar       *y;
-  const PetscScalar *x;
   const MatScalar   *v1,*v2,*v3,*v4,*v5;
-  PetscErrorCode    ierr;
-  PetscInt          i1,i2,n,i,row,node_max,nsz,sz,nonzerorow=0;
+  PetscInt          i1,i2,n,i,nsz,sz;
   const PetscInt    *idx,*ns,*ii;
 
 #if defined(PETSC_HAVE_PRAGMA_DISJOINT)
 #pragma disjoint(*x,*y,*v1,*v2,*v3,*v4,*v5)
 #endif
 
-  PetscFunctionBegin;
-  if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
-  node_max = a->inode.node_count;
-  ns       = a->inode.size;     /* Node Size array */
-  ierr     = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
-  ierr     = VecGetArray(yy,&y);CHKERRQ(ierr);
-  idx      = a->j;
-  v1       = a->a;
-  ii       = a->i;
+  ns  = a->inode.size;     /* Node Size array */
+  idx = a->j + a->i[row];
+  v1  = a->a + a->i[row];
+  ii  = a->i + row;
 
-  for (i = 0,row = 0; i< node_max; ++i) {
+  for (i = node_start; i< node_end; ++i) {
     nsz         = ns[i];
     n           = ii[1] - ii[0];
-    nonzerorow += (n>0)*nsz;
     ii         += nsz;
     PetscPrefetchBlock(idx+nsz*n,n,0,PETSC_PREFETCH_HINT_NTA);    /* Prefetch the indices for the block row after the current one */
     PetscPrefetchBlock(v1+nsz*n,nsz*n,0,PETSC_PREFETCH_HINT_NTA); /* Prefetch the values for the block row after the current one  */
@@ -553,41 +549,47 @@ static PetscErrorCode MatMult_SeqAIJ_Inode(Mat A,Vec xx,Vec yy)
       idx    +=4*sz;
       break;
     default:
-      SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
+      return PETSC_ERR_COR;
     }
   }
-  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
-  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
-  ierr = PetscLogFlops(2.0*a->nz - nonzerorow);CHKERRQ(ierr);
-  PetscFunctionReturn(0);
+  return 0;
 }
-/* ----------------------------------------------------------- */
-/* Almost same code as the MatMult_SeqAIJ_Inode() */
-static PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat A,Vec xx,Vec zz,Vec yy)
+
+static PetscErrorCode MatMult_SeqAIJ_Inode(Mat A,Vec xx,Vec yy)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
-  PetscScalar       sum1,sum2,sum3,sum4,sum5,tmp0,tmp1;
-  const MatScalar   *v1,*v2,*v3,*v4,*v5;
+  PetscScalar       *y;
   const PetscScalar *x;
-  PetscScalar       *y,*z,*zt;
   PetscErrorCode    ierr;
-  PetscInt          i1,i2,n,i,row,node_max,nsz,sz;
-  const PetscInt    *idx,*ns,*ii;
 
   PetscFunctionBegin;
   if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
-  node_max = a->inode.node_count;
-  ns       = a->inode.size;     /* Node Size array */
-
   ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
-  ierr = VecGetArrayPair(zz,yy,&z,&y);CHKERRQ(ierr);
-  zt = z;
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  ierr = MatMultKernel_SeqAIJ_Inode(a,x,y,0,a->inode.node_count,0);
+  if (ierr) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+/* ----------------------------------------------------------- */
+/* Almost same code as the MatMultKernel_SeqAIJ_Inode(), computes y = z + A x for the given inodes */
+PETSC_STATIC_INLINE PetscErrorCode MatMultAddKernel_SeqAIJ_Inode(const Mat_SeqAIJ *a,const PetscScalar *x,const PetscScalar *z,PetscScalar *y,PetscInt node_start,PetscInt node_end,PetscInt row)
+{
+  PetscScalar       sum1,sum2,sum3,sum4,sum5,tmp0,tmp1;
+  const MatScalar   *v1,*v2,*v3,*v4,*v5;
+  const PetscScalar *zt;
+  PetscInt          i1,i2,n,i,nsz,sz;
+  const PetscInt    *idx,*ns,*ii;
 
-  idx = a->j;
-  v1  = a->a;
-  ii  = a->i;
+  ns  = a->inode.size;     /* Node Size array */
+  zt  = z + row;
+  idx = a->j + a->i[row];
+  v1  = a->a + a->i[row];
+  ii  = a->i + row;
 
-  for (i = 0,row = 0; i< node_max; ++i) {
+  for (i = node_start; i< node_end; ++i) {
     nsz = ns[i];
     n   = ii[1] - ii[0];
     ii += nsz;
@@ -739,15 +741,99 @@ static PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat A,Vec xx,Vec zz,Vec yy)
       idx    +=4*sz;
       break;
     default:
-      SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
+      return PETSC_ERR_COR;
     }
   }
+  return 0;
+}
+
+static PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  const PetscScalar *x;
+  PetscScalar       *y,*z;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(zz,yy,&z,&y);CHKERRQ(ierr);
+  ierr = MatMultAddKernel_SeqAIJ_Inode(a,x,z,y,0,a->inode.node_count,0);
+  if (ierr) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
   ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecRestoreArrayPair(zz,yy,&z,&y);CHKERRQ(ierr);
   ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_HAVE_OPENMP)
+/*
+   Threaded versions of MatMult_SeqAIJ_Inode() and MatMultAdd_SeqAIJ_Inode(); each thread processes the block of
+   inodes computed by MatSeqAIJThreadsSetUp()
+*/
+PetscErrorCode MatMult_SeqAIJ_Inode_Threads(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Threads *threads = &a->threads;
+  PetscScalar        *y;
+  const PetscScalar  *x;
+  PetscErrorCode     ierr,kerr = 0,lerr = 0;
+
+  PetscFunctionBegin;
+  if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
+  ierr = MatSeqAIJThreadsSetUp(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+#pragma omp parallel num_threads(threads->nthreads) reduction(|:kerr)
+  {
+    PetscInt       tid    = omp_get_thread_num(),nthr = omp_get_num_threads(),blk;
+    PetscLogDouble tstart = omp_get_wtime();
+
+    for (blk=tid; blk<threads->nthreads; blk+=nthr) {
+      kerr |= MatMultKernel_SeqAIJ_Inode(a,x,y,threads->nstart[blk],threads->nstart[blk+1],threads->rstart[blk]);
+    }
+    MatSeqAIJThreadsEnd_Private(threads,tid,tstart,&lerr);
+  }
+  if (kerr) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
+  CHKERRQ(lerr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJ_Inode_Threads(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ         *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJ_Threads *threads = &a->threads;
+  const PetscScalar  *x;
+  PetscScalar        *y,*z;
+  PetscErrorCode     ierr,kerr = 0,lerr = 0;
+
+  PetscFunctionBegin;
+  if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
+  ierr = MatSeqAIJThreadsSetUp(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(zz,yy,&z,&y);CHKERRQ(ierr);
+#pragma omp parallel num_threads(threads->nthreads) reduction(|:kerr)
+  {
+    PetscInt       tid    = omp_get_thread_num(),nthr = omp_get_num_threads(),blk;
+    PetscLogDouble tstart = omp_get_wtime();
+
+    for (blk=tid; blk<threads->nthreads; blk+=nthr) {
+      kerr |= MatMultAddKernel_SeqAIJ_Inode(a,x,z,y,threads->nstart[blk],threads->nstart[blk+1],threads->rstart[blk]);
+    }
+    MatSeqAIJThreadsEnd_Private(threads,tid,tstart,&lerr);
+  }
+  if (kerr) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
+  CHKERRQ(lerr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(zz,yy,&z,&y);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
 /* ----------------------------------------------------------- */
 PetscErrorCode MatSolve_SeqAIJ_Inode_inplace(Mat A,Vec bb,Vec xx)
 {
@@ -1845,6 +1931,9 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode(Mat B,Mat A,const MatFactorInfo *
   } else {
     C->ops->solve           = MatSolve_SeqAIJ;
   }
+#if defined(PETSC_HAVE_OPENMP)
+  if (b->solvelevels.type != MAT_SEQAIJ_SOLVE_SERIAL) C->ops->solve = MatSolve_SeqAIJ_Levels;
+#endif
   C->ops->solveadd          = MatSolveAdd_SeqAIJ;
   C->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
   C->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
@@ -2735,6 +2824,10 @@ PetscErrorCode MatSOR_SeqAIJ_Inode(Mat A,Vec bb,PetscReal omega,MatSORType flag,
   const PetscInt    *sizes = a->inode.size,*idx,*diag = a->diag,*ii = a->i;
 
   PetscFunctionBegin;
+  if (a->sorcolor.use && flag != SOR_APPLY_UPPER && flag != SOR_APPLY_LOWER && !(flag & SOR_EISENSTAT)) {
+    ierr = MatSOR_SeqAIJ(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   allowzeropivot = PetscNot(A->erroriffailure);
   if (omega != 1.0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support for omega != 1.0; use -mat_no_inode");
   if (fshift != 0.0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support for fshift != 0.0; use -mat_no_inode");
@@ -17,11 +17,11 @@ PETSC_INTERN PetscErrorCode MatPtAP_SeqAIJ_SeqAIJ(Mat A,Mat P,MatReuse scall,Pet
 {
   PetscErrorCode      ierr;
 #if !defined(PETSC_HAVE_HYPRE)
-  const char          *algTypes[2] = {"scalable","rap"};
-  PetscInt            nalg = 2;
-#else
-  const char          *algTypes[3] = {"scalable","rap","hypre"};
+  const char          *algTypes[3] = {"scalable","rap","plan"};
   PetscInt            nalg = 3;
+#else
+  const char          *algTypes[4] = {"scalable","rap","plan","hypre"};
+  PetscInt            nalg = 4;
 #endif
   PetscInt            alg = 1; /* set default algorithm */
   Mat                 Pt;
@@ -34,6 +34,9 @@ PETSC_INTERN PetscErrorCode MatPtAP_SeqAIJ_SeqAIJ(Mat A,Mat P,MatReuse scall,Pet
      Alg 'scalable' determines which implementations to be used:
        "rap":      Pt = P^T and C = Pt*A*P
        "scalable": do outer product and two sparse axpy in MatPtAPNumeric() - might slow, does not store structure of A*P.
+       "plan":     store the structure of A*P and the location in C of every outer product term, so that
+                   MatPtAPNumeric() with MAT_REUSE_MATRIX needs no searches - fast, but the plan takes as much
+                   memory as there are flops in the outer product.
        "hypre":    use boomerAMGBuildCoarseOperator.
      */
     ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)A),((PetscObject)A)->prefix,"MatPtAP","Mat");CHKERRQ(ierr);
@@ -53,8 +56,13 @@ PETSC_INTERN PetscErrorCode MatPtAP_SeqAIJ_SeqAIJ(Mat A,Mat P,MatReuse scall,Pet
       (*C)->ops->ptapnumeric = MatPtAPNumeric_SeqAIJ_SeqAIJ;
       PetscFunctionReturn(0);
       break;
-#if defined(PETSC_HAVE_HYPRE)
     case 2:
+      ierr = PetscLogEventBegin(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
+      ierr = MatPtAPSymbolic_SeqAIJ_SeqAIJ_Plan(A,P,fill,C);CHKERRQ(ierr);
+      ierr = PetscLogEventEnd(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
+      break;
+#if defined(PETSC_HAVE_HYPRE)
+    case 3:
       ierr = PetscLogEventBegin(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
       ierr = MatPtAPSymbolic_AIJ_AIJ_wHYPRE(A,P,fill,C);CHKERRQ(ierr);
       ierr = PetscLogEventEnd(MAT_PtAPSymbolic,A,P,0,0);CHKERRQ(ierr);
@@ -83,6 +91,7 @@ PetscErrorCode MatDestroy_SeqAIJ_PtAP(Mat A)
   ierr = PetscFree(ap->apa);CHKERRQ(ierr);
   ierr = PetscFree(ap->api);CHKERRQ(ierr);
   ierr = PetscFree(ap->apj);CHKERRQ(ierr);
+  ierr = PetscFree(ap->coff);CHKERRQ(ierr);
   ierr = (ap->destroy)(A);CHKERRQ(ierr);
   ierr = PetscFree(ap);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -294,6 +303,128 @@ PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_SparseAxpy(Mat A,Mat P,Mat C)
   PetscFunctionReturn(0);
 }
 
+/*
+   Symbolic product that also records, for every row i of A, the structure of the row AP(i,:) and the position
+   in C->a of each term P(i,r)*AP(i,c) of the outer product P(i,:)^T*AP(i,:). The numeric phase then only has to
+   gather and accumulate.
+*/
+PetscErrorCode MatPtAPSymbolic_SeqAIJ_SeqAIJ_Plan(Mat A,Mat P,PetscReal fill,Mat *C)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data,*p = (Mat_SeqAIJ*)P->data,*c;
+  Mat_AP         *ap;
+  PetscInt       *ai=a->i,*aj=a->j,*pi=p->i,*pj=p->j,*ci,*cj,*api,*apj,*apjj,*coff,*mark;
+  PetscInt       am=A->rmap->N,pn=P->cmap->N;
+  PetscInt       i,j,k,r,prow,crow,apnzi,nplan,loc;
+  PetscLogDouble flops = 0.0;
+
+  PetscFunctionBegin;
+  ierr = MatPtAPSymbolic_SeqAIJ_SeqAIJ_SparseAxpy(A,P,fill,C);CHKERRQ(ierr);
+  c    = (Mat_SeqAIJ*)(*C)->data;
+  ci   = c->i;
+  cj   = c->j;
+
+  /* count the nonzeros of A*P and the number of outer product terms */
+  ierr   = PetscMalloc1(am+1,&api);CHKERRQ(ierr);
+  ierr   = PetscMalloc1(pn,&mark);CHKERRQ(ierr);
+  for (k=0; k<pn; k++) mark[k] = -1;
+  api[0] = 0;
+  nplan  = 0;
+  for (i=0; i<am; i++) {
+    apnzi = 0;
+    for (j=ai[i]; j<ai[i+1]; j++) {
+      prow   = aj[j];
+      flops += 2.0*(pi[prow+1]-pi[prow]);
+      for (k=pi[prow]; k<pi[prow+1]; k++) {
+        if (mark[pj[k]] != i) {mark[pj[k]] = i; apnzi++;}
+      }
+    }
+    api[i+1] = api[i] + apnzi;
+    nplan   += apnzi*(pi[i+1]-pi[i]);
+  }
+
+  /* fill in the column indices of A*P and the plan */
+  ierr = PetscMalloc1(api[am]+1,&apj);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nplan+1,&coff);CHKERRQ(ierr);
+  for (k=0; k<pn; k++) mark[k] = -1;
+  nplan = 0;
+  for (i=0; i<am; i++) {
+    apjj  = apj + api[i];
+    apnzi = 0;
+    for (j=ai[i]; j<ai[i+1]; j++) {
+      prow = aj[j];
+      for (k=pi[prow]; k<pi[prow+1]; k++) {
+        if (mark[pj[k]] != i) {mark[pj[k]] = i; apjj[apnzi++] = pj[k];}
+      }
+    }
+    ierr = PetscSortInt(apnzi,apjj);CHKERRQ(ierr);
+    for (r=pi[i]; r<pi[i+1]; r++) {
+      crow = pj[r];
+      for (k=0; k<apnzi; k++) {
+        ierr = PetscFindInt(apjj[k],ci[crow+1]-ci[crow],cj+ci[crow],&loc);CHKERRQ(ierr);
+        if (loc < 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Column %D missing from row %D of the symbolic product",apjj[k],crow);
+        coff[nplan++] = ci[crow] + loc;
+      }
+    }
+    flops += 2.0*apnzi*(pi[i+1]-pi[i]);
+  }
+  ierr = PetscFree(mark);CHKERRQ(ierr);
+
+  ierr = PetscNew(&ap);CHKERRQ(ierr);
+  ierr = PetscCalloc1(pn,&ap->apa);CHKERRQ(ierr);
+  ap->api     = api;
+  ap->apj     = apj;
+  ap->coff    = coff;
+  ap->flops   = flops;
+  ap->destroy = (*C)->ops->destroy;
+  c->ap       = ap;
+  ierr = PetscLogObjectMemory((PetscObject)(*C),(am+1+api[am]+nplan)*sizeof(PetscInt)+pn*sizeof(PetscScalar));CHKERRQ(ierr);
+  ierr = PetscInfo3((*C),"Plan for P^T*A*P: %D nonzeros in A*P, %D outer product terms stored for %D nonzeros in C\n",api[am],nplan,ci[pn]);CHKERRQ(ierr);
+
+  (*C)->ops->destroy     = MatDestroy_SeqAIJ_PtAP;
+  (*C)->ops->ptapnumeric = MatPtAPNumeric_SeqAIJ_SeqAIJ_Plan;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_Plan(Mat A,Mat P,Mat C)
+{
+  PetscErrorCode  ierr;
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ*)A->data,*p = (Mat_SeqAIJ*)P->data,*c = (Mat_SeqAIJ*)C->data;
+  Mat_AP          *ap = c->ap;
+  const PetscInt  *ai=a->i,*aj=a->j,*pi=p->i,*pj=p->j,*api=ap->api,*coff=ap->coff,*apjj,*pjj;
+  const MatScalar *aa=a->a,*pa=p->a,*paj;
+  MatScalar       *ca=c->a,*apa=ap->apa,aval,pval;
+  PetscInt        am=A->rmap->N,i,j,k,r,prow,pnzj,apnzi;
+
+  PetscFunctionBegin;
+  ierr = PetscMemzero(ca,c->i[C->rmap->n]*sizeof(MatScalar));CHKERRQ(ierr);
+  for (i=0; i<am; i++) {
+    /* dense row of A*P */
+    for (j=ai[i]; j<ai[i+1]; j++) {
+      prow = aj[j];
+      aval = aa[j];
+      pnzj = pi[prow+1] - pi[prow];
+      pjj  = pj + pi[prow];
+      paj  = pa + pi[prow];
+      for (k=0; k<pnzj; k++) apa[pjj[k]] += aval*paj[k];
+    }
+    /* C(r,:) += P(i,r)*AP(i,:) */
+    apnzi = api[i+1] - api[i];
+    apjj  = ap->apj + api[i];
+    for (r=pi[i]; r<pi[i+1]; r++) {
+      pval = pa[r];
+      for (k=0; k<apnzi; k++) ca[coff[k]] += pval*apa[apjj[k]];
+      coff += apnzi;
+    }
+    for (k=0; k<apnzi; k++) apa[apjj[k]] = 0.0;
+  }
+  ierr = PetscLogFlops(ap->flops);CHKERRQ(ierr);
+
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ(Mat A,Mat P,Mat C)
 {
   PetscErrorCode      ierr;
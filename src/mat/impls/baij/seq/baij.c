@@ -2855,22 +2855,46 @@ PetscErrorCode  MatSeqBAIJSetPreallocation_SeqBAIJ(Mat B,PetscInt bs,PetscInt nz
       B->ops->mult    = MatMult_SeqBAIJ_7;
       B->ops->multadd = MatMultAdd_SeqBAIJ_7;
       break;
+    case 8:
+      B->ops->mult    = MatMult_SeqBAIJ_8_Fixed;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_8_Fixed;
+      break;
     case 9:
 #if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
       B->ops->mult    = MatMult_SeqBAIJ_9_AVX2;
       B->ops->multadd = MatMultAdd_SeqBAIJ_9_AVX2;
 #else
-      B->ops->mult    = MatMult_SeqBAIJ_N;
-      B->ops->multadd = MatMultAdd_SeqBAIJ_N;
+      B->ops->mult    = MatMult_SeqBAIJ_9_Fixed;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_9_Fixed;
 #endif
       break;
+    case 10:
+      B->ops->mult    = MatMult_SeqBAIJ_10_Fixed;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_10_Fixed;
+      break;
     case 11:
       B->ops->mult    = MatMult_SeqBAIJ_11;
-      B->ops->multadd = MatMultAdd_SeqBAIJ_11;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_11_Fixed;
+      break;
+    case 12:
+      B->ops->mult    = MatMult_SeqBAIJ_12_Fixed;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_12_Fixed;
+      break;
+    case 13:
+      B->ops->mult    = MatMult_SeqBAIJ_13_Fixed;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_13_Fixed;
+      break;
+    case 14:
+      B->ops->mult    = MatMult_SeqBAIJ_14_Fixed;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_14_Fixed;
       break;
     case 15:
       B->ops->mult    = MatMult_SeqBAIJ_15_ver1;
-      B->ops->multadd = MatMultAdd_SeqBAIJ_N;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_15_Fixed;
+      break;
+    case 16:
+      B->ops->mult    = MatMult_SeqBAIJ_16_Fixed;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_16_Fixed;
       break;
     default:
       B->ops->mult    = MatMult_SeqBAIJ_N;
@@ -2879,6 +2903,19 @@ PetscErrorCode  MatSeqBAIJSetPreallocation_SeqBAIJ(Mat B,PetscInt bs,PetscInt nz
     }
   }
   B->ops->sor = MatSOR_SeqBAIJ;
+  if (!flg) {
+    switch (bs) {
+    case 8:  B->ops->sor = MatSOR_SeqBAIJ_8_Fixed;  break;
+    case 9:  B->ops->sor = MatSOR_SeqBAIJ_9_Fixed;  break;
+    case 10: B->ops->sor = MatSOR_SeqBAIJ_10_Fixed; break;
+    case 11: B->ops->sor = MatSOR_SeqBAIJ_11_Fixed; break;
+    case 12: B->ops->sor = MatSOR_SeqBAIJ_12_Fixed; break;
+    case 13: B->ops->sor = MatSOR_SeqBAIJ_13_Fixed; break;
+    case 14: B->ops->sor = MatSOR_SeqBAIJ_14_Fixed; break;
+    case 15: B->ops->sor = MatSOR_SeqBAIJ_15_Fixed; break;
+    case 16: B->ops->sor = MatSOR_SeqBAIJ_16_Fixed; break;
+    }
+  }
   b->mbs = mbs;
   b->nbs = nbs;
   if (!skipallocation) {
@@ -234,6 +234,25 @@ PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_7(Mat,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_9_AVX2(Mat,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_11(Mat,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_N(Mat,Vec,Vec,Vec);
+
+/* kernels for the block sizes 8 to 16 instantiated from the macros in baijfixed.c */
+#define MatSeqBAIJ_Fixed_Declare(BS) \
+  PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_##BS##_Fixed(Mat,Vec,Vec); \
+  PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_##BS##_Fixed(Mat,Vec,Vec,Vec); \
+  PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_##BS##_NaturalOrdering_Fixed(Mat,Vec,Vec); \
+  PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_##BS##_Fixed(Mat,Vec,Vec); \
+  PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqBAIJ_##BS##_Fixed(Mat,Mat,const MatFactorInfo*); \
+  PETSC_INTERN PetscErrorCode MatSOR_SeqBAIJ_##BS##_Fixed(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec)
+MatSeqBAIJ_Fixed_Declare(8);
+MatSeqBAIJ_Fixed_Declare(9);
+MatSeqBAIJ_Fixed_Declare(10);
+MatSeqBAIJ_Fixed_Declare(11);
+MatSeqBAIJ_Fixed_Declare(12);
+MatSeqBAIJ_Fixed_Declare(13);
+MatSeqBAIJ_Fixed_Declare(14);
+MatSeqBAIJ_Fixed_Declare(15);
+MatSeqBAIJ_Fixed_Declare(16);
+
 PETSC_INTERN PetscErrorCode MatLoad_SeqBAIJ(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode MatSeqBAIJSetNumericFactorization_inplace(Mat,PetscBool);
 PETSC_INTERN PetscErrorCode MatSeqBAIJSetNumericFactorization(Mat,PetscBool);
@@ -10,8 +10,16 @@
 */
 PetscErrorCode MatSeqBAIJSetNumericFactorization(Mat fact,PetscBool natural)
 {
+  PetscErrorCode ierr;
+  PetscBool      flg = PETSC_FALSE;
+
   PetscFunctionBegin;
-  if (natural) {
+  ierr = PetscOptionsGetBool(((PetscObject)fact)->options,((PetscObject)fact)->prefix,"-mat_no_unroll",&flg,NULL);CHKERRQ(ierr);
+  if (flg) {
+    /* the generic kernels, for comparison with the ones specialized for the block size */
+    if (fact->rmap->bs == 1) fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_1;
+    else                     fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_N;
+  } else if (natural) {
     switch (fact->rmap->bs) {
     case 1:
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_1;
@@ -34,16 +42,37 @@ PetscErrorCode MatSeqBAIJSetNumericFactorization(Mat fact,PetscBool natural)
     case 7:
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_7_NaturalOrdering;
       break;
+    case 8:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_8_Fixed;
+      break;
     case 9:
 #if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_9_NaturalOrdering;
 #else
-      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_N;
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_9_Fixed;
 #endif
       break;
+    case 10:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_10_Fixed;
+      break;
+    case 11:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_11_Fixed;
+      break;
+    case 12:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_12_Fixed;
+      break;
+    case 13:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_13_Fixed;
+      break;
+    case 14:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_14_Fixed;
+      break;
     case 15:
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_15_NaturalOrdering;
       break;
+    case 16:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_16_Fixed;
+      break;
     default:
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_N;
       break;
@@ -71,6 +100,33 @@ PetscErrorCode MatSeqBAIJSetNumericFactorization(Mat fact,PetscBool natural)
     case 7:
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_7;
       break;
+    case 8:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_8_Fixed;
+      break;
+    case 9:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_9_Fixed;
+      break;
+    case 10:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_10_Fixed;
+      break;
+    case 11:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_11_Fixed;
+      break;
+    case 12:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_12_Fixed;
+      break;
+    case 13:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_13_Fixed;
+      break;
+    case 14:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_14_Fixed;
+      break;
+    case 15:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_15_Fixed;
+      break;
+    case 16:
+      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_16_Fixed;
+      break;
     default:
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_N;
       break;
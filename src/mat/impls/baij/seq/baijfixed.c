@@ -0,0 +1,421 @@
+/*
+    MATSEQBAIJ kernels for the block sizes 8 to 16.
+
+    Each kernel is written once below as a macro of the block size BS, which is a compile-time constant in every
+    instance at the end of the file. The compiler unrolls the loops over a block and keeps a block row of the result
+    in registers, instead of the BLAS calls of the _N kernels that cost more than they compute for such small blocks.
+*/
+#include <../src/mat/impls/baij/seq/baij.h>
+#include <petsc/private/kernels/blockinvert.h>
+
+/* s = s - A w, A is a BS x BS block stored by columns */
+#define PetscKernel_v_gets_v_minus_A_times_w_BS(BS,s,A,w) do {  \
+    PetscInt _k,_l;                                             \
+    for (_k=0; _k<BS; _k++) {                                   \
+      const PetscScalar _wk = (w)[_k];                          \
+      for (_l=0; _l<BS; _l++) (s)[_l] -= (A)[_k*BS+_l]*_wk;     \
+    }                                                           \
+  } while (0)
+
+/* s = s + A w */
+#define PetscKernel_v_gets_v_plus_A_times_w_BS(BS,s,A,w) do {   \
+    PetscInt _k,_l;                                             \
+    for (_k=0; _k<BS; _k++) {                                   \
+      const PetscScalar _wk = (w)[_k];                          \
+      for (_l=0; _l<BS; _l++) (s)[_l] += (A)[_k*BS+_l]*_wk;     \
+    }                                                           \
+  } while (0)
+
+/* s = A w */
+#define PetscKernel_v_gets_A_times_w_BS(BS,s,A,w) do {          \
+    PetscInt _l;                                                \
+    for (_l=0; _l<BS; _l++) (s)[_l] = 0.0;                      \
+    PetscKernel_v_gets_v_plus_A_times_w_BS(BS,s,A,w);           \
+  } while (0)
+
+/* A = A B, W is a work array of length BS*BS */
+#define PetscKernel_A_gets_A_times_B_BS(BS,A,B,W) do {          \
+    PetscInt _r,_c,_k;                                          \
+    for (_k=0; _k<BS*BS; _k++) (W)[_k] = (A)[_k];               \
+    for (_c=0; _c<BS; _c++) {                                   \
+      for (_r=0; _r<BS; _r++) (A)[_c*BS+_r] = 0.0;              \
+      for (_k=0; _k<BS; _k++) {                                 \
+        const MatScalar _b = (B)[_c*BS+_k];                     \
+        for (_r=0; _r<BS; _r++) (A)[_c*BS+_r] += (W)[_k*BS+_r]*_b; \
+      }                                                         \
+    }                                                           \
+  } while (0)
+
+/* A = A - B C */
+#define PetscKernel_A_gets_A_minus_B_times_C_BS(BS,A,B,C) do {  \
+    PetscInt _r,_c,_k;                                          \
+    for (_c=0; _c<BS; _c++) {                                   \
+      for (_k=0; _k<BS; _k++) {                                 \
+        const MatScalar _ck = (C)[_c*BS+_k];                    \
+        for (_r=0; _r<BS; _r++) (A)[_c*BS+_r] -= (B)[_k*BS+_r]*_ck; \
+      }                                                         \
+    }                                                           \
+  } while (0)
+
+#define DEF_MatMult_SeqBAIJ_Fixed(BS)                                   \
+  PetscErrorCode MatMult_SeqBAIJ_##BS##_Fixed(Mat A,Vec xx,Vec zz)      \
+  {                                                                     \
+    Mat_SeqBAIJ       *a = (Mat_SeqBAIJ*)A->data;                       \
+    PetscScalar       *z = NULL,*zarray,sum[BS];                        \
+    const PetscScalar *x;                                               \
+    const MatScalar   *v = a->a;                                        \
+    PetscErrorCode    ierr;                                             \
+    const PetscInt    *ii,*idx = a->j,*ridx = NULL;                     \
+    PetscInt          mbs,i,j,l,n;                                      \
+    PetscBool         usecprow = a->compressedrow.use;                  \
+                                                                        \
+    PetscFunctionBegin;                                                 \
+    ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);                        \
+    ierr = VecGetArray(zz,&zarray);CHKERRQ(ierr);                       \
+    if (usecprow) {                                                     \
+      mbs  = a->compressedrow.nrows;                                    \
+      ii   = a->compressedrow.i;                                        \
+      ridx = a->compressedrow.rindex;                                   \
+      ierr = PetscMemzero(zarray,BS*a->mbs*sizeof(PetscScalar));CHKERRQ(ierr); \
+    } else {                                                            \
+      mbs = a->mbs;                                                     \
+      ii  = a->i;                                                       \
+      z   = zarray;                                                     \
+    }                                                                   \
+    for (i=0; i<mbs; i++) {                                             \
+      n = ii[i+1] - ii[i];                                              \
+      for (l=0; l<BS; l++) sum[l] = 0.0;                                \
+      for (j=0; j<n; j++) {                                             \
+        PetscKernel_v_gets_v_plus_A_times_w_BS(BS,sum,v,x+BS*idx[j]);    \
+        v += BS*BS;                                                     \
+      }                                                                 \
+      idx += n;                                                         \
+      if (usecprow) z = zarray + BS*ridx[i];                            \
+      for (l=0; l<BS; l++) z[l] = sum[l];                               \
+      if (!usecprow) z += BS;                                           \
+    }                                                                   \
+    ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);                    \
+    ierr = VecRestoreArray(zz,&zarray);CHKERRQ(ierr);                   \
+    ierr = PetscLogFlops(2.0*BS*BS*a->nz - BS*a->nonzerorowcnt);CHKERRQ(ierr); \
+    PetscFunctionReturn(0);                                             \
+  }
+
+#define DEF_MatMultAdd_SeqBAIJ_Fixed(BS)                                \
+  PetscErrorCode MatMultAdd_SeqBAIJ_##BS##_Fixed(Mat A,Vec xx,Vec yy,Vec zz) \
+  {                                                                     \
+    Mat_SeqBAIJ       *a = (Mat_SeqBAIJ*)A->data;                       \
+    PetscScalar       *y = NULL,*z = NULL,*yarray,*zarray,sum[BS];      \
+    const PetscScalar *x;                                               \
+    const MatScalar   *v = a->a;                                        \
+    PetscErrorCode    ierr;                                             \
+    const PetscInt    *ii,*idx = a->j,*ridx = NULL;                     \
+    PetscInt          mbs = a->mbs,i,j,l,n;                             \
+    PetscBool         usecprow = a->compressedrow.use;                  \
+                                                                        \
+    PetscFunctionBegin;                                                 \
+    ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);                        \
+    ierr = VecGetArrayPair(yy,zz,&yarray,&zarray);CHKERRQ(ierr);        \
+    if (usecprow) {                                                     \
+      if (zz != yy) {ierr = PetscMemcpy(zarray,yarray,BS*mbs*sizeof(PetscScalar));CHKERRQ(ierr);} \
+      mbs  = a->compressedrow.nrows;                                    \
+      ii   = a->compressedrow.i;                                        \
+      ridx = a->compressedrow.rindex;                                   \
+    } else {                                                            \
+      ii = a->i;                                                        \
+      y  = yarray;                                                      \
+      z  = zarray;                                                      \
+    }                                                                   \
+    for (i=0; i<mbs; i++) {                                             \
+      n = ii[i+1] - ii[i];                                              \
+      if (usecprow) {                                                   \
+        y = yarray + BS*ridx[i];                                        \
+        z = zarray + BS*ridx[i];                                        \
+      }                                                                 \
+      for (l=0; l<BS; l++) sum[l] = y[l];                               \
+      for (j=0; j<n; j++) {                                             \
+        PetscKernel_v_gets_v_plus_A_times_w_BS(BS,sum,v,x+BS*idx[j]);    \
+        v += BS*BS;                                                     \
+      }                                                                 \
+      idx += n;                                                         \
+      for (l=0; l<BS; l++) z[l] = sum[l];                               \
+      if (!usecprow) {y += BS; z += BS;}                                \
+    }                                                                   \
+    ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);                    \
+    ierr = VecRestoreArrayPair(yy,zz,&yarray,&zarray);CHKERRQ(ierr);    \
+    ierr = PetscLogFlops(2.0*BS*BS*a->nz);CHKERRQ(ierr);                \
+    PetscFunctionReturn(0);                                             \
+  }
+
+/*
+   The factor stores the inverses of the diagonal blocks, see MatLUFactorNumeric_SeqBAIJ_N(); rows and columns are
+   permuted by the ordering of the factorization unless the solve is the _NaturalOrdering one
+*/
+#define DEF_MatSolve_SeqBAIJ_Fixed(BS,NATURAL,SUFFIX)                   \
+  PetscErrorCode MatSolve_SeqBAIJ_##BS##SUFFIX(Mat A,Vec bb,Vec xx)     \
+  {                                                                     \
+    Mat_SeqBAIJ       *a = (Mat_SeqBAIJ*)A->data;                       \
+    PetscErrorCode    ierr;                                             \
+    const PetscInt    *r = NULL,*c = NULL,*ai = a->i,*aj = a->j,*adiag = a->diag,*vi; \
+    PetscInt          i,k,l,nz,n = a->mbs;                              \
+    const MatScalar   *aa = a->a,*v;                                    \
+    PetscScalar       *x,*t = a->solve_work,s[BS];                      \
+    const PetscScalar *b;                                               \
+                                                                        \
+    PetscFunctionBegin;                                                 \
+    ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);                        \
+    ierr = VecGetArray(xx,&x);CHKERRQ(ierr);                            \
+    if (!NATURAL) {                                                     \
+      ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);                     \
+      ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);                     \
+    }                                                                   \
+    /* forward solve the lower triangular */                            \
+    for (i=0; i<n; i++) {                                               \
+      const PetscScalar *bi = b + BS*(NATURAL ? i : r[i]);              \
+      v  = aa + BS*BS*ai[i];                                            \
+      vi = aj + ai[i];                                                  \
+      nz = ai[i+1] - ai[i];                                             \
+      for (l=0; l<BS; l++) s[l] = bi[l];                                \
+      for (k=0; k<nz; k++) {                                            \
+        PetscKernel_v_gets_v_minus_A_times_w_BS(BS,s,v,t+BS*vi[k]);     \
+        v += BS*BS;                                                     \
+      }                                                                 \
+      for (l=0; l<BS; l++) t[BS*i+l] = s[l];                            \
+    }                                                                   \
+    /* backward solve the upper triangular */                           \
+    for (i=n-1; i>=0; i--) {                                            \
+      PetscScalar *xi = x + BS*(NATURAL ? i : c[i]);                    \
+      v  = aa + BS*BS*(adiag[i+1]+1);                                   \
+      vi = aj + adiag[i+1]+1;                                           \
+      nz = adiag[i] - adiag[i+1] - 1;                                   \
+      for (l=0; l<BS; l++) s[l] = t[BS*i+l];                            \
+      for (k=0; k<nz; k++) {                                            \
+        PetscKernel_v_gets_v_minus_A_times_w_BS(BS,s,v,t+BS*vi[k]);     \
+        v += BS*BS;                                                     \
+      }                                                                 \
+      PetscKernel_v_gets_A_times_w_BS(BS,t+BS*i,aa+BS*BS*adiag[i],s);   \
+      for (l=0; l<BS; l++) xi[l] = t[BS*i+l];                           \
+    }                                                                   \
+    if (!NATURAL) {                                                     \
+      ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);                 \
+      ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);                 \
+    }                                                                   \
+    ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);                    \
+    ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);                        \
+    ierr = PetscLogFlops(2.0*BS*BS*a->nz - BS*A->cmap->n);CHKERRQ(ierr); \
+    PetscFunctionReturn(0);                                             \
+  }
+
+/* Same algorithm as MatLUFactorNumeric_SeqBAIJ_N(), which also handles the natural ordering */
+#define DEF_MatLUFactorNumeric_SeqBAIJ_Fixed(BS)                        \
+  PetscErrorCode MatLUFactorNumeric_SeqBAIJ_##BS##_Fixed(Mat B,Mat A,const MatFactorInfo *info) \
+  {                                                                     \
+    Mat_SeqBAIJ     *a = (Mat_SeqBAIJ*)A->data,*b = (Mat_SeqBAIJ*)B->data; \
+    PetscErrorCode  ierr;                                               \
+    const PetscInt  *r,*ic,*ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j,*bdiag = b->diag,*ajtmp,*bjtmp,*pj; \
+    PetscInt        i,j,k,nz,nzL,row,n = a->mbs,pivots[BS];             \
+    MatScalar       *rtmp,*pc,*pv,mwork[BS*BS],vwork[BS];               \
+    const MatScalar *aa = a->a,*v;                                      \
+    PetscBool       row_identity,col_identity,allowzeropivot,zeropivotdetected,flg; \
+                                                                        \
+    PetscFunctionBegin;                                                 \
+    ierr = ISGetIndices(b->row,&r);CHKERRQ(ierr);                       \
+    ierr = ISGetIndices(b->icol,&ic);CHKERRQ(ierr);                     \
+    allowzeropivot = PetscNot(A->erroriffailure);                       \
+    ierr = PetscCalloc1(BS*BS*n,&rtmp);CHKERRQ(ierr);                   \
+                                                                        \
+    for (i=0; i<n; i++) {                                               \
+      /* zero rtmp in the L and U parts of row i */                     \
+      nz    = bi[i+1] - bi[i];                                          \
+      bjtmp = bj + bi[i];                                               \
+      for (j=0; j<nz; j++) {ierr = PetscMemzero(rtmp+BS*BS*bjtmp[j],BS*BS*sizeof(MatScalar));CHKERRQ(ierr);} \
+      nz    = bdiag[i] - bdiag[i+1];                                    \
+      bjtmp = bj + bdiag[i+1]+1;                                        \
+      for (j=0; j<nz; j++) {ierr = PetscMemzero(rtmp+BS*BS*bjtmp[j],BS*BS*sizeof(MatScalar));CHKERRQ(ierr);} \
+                                                                        \
+      /* load in initial (unfactored row) */                            \
+      nz    = ai[r[i]+1] - ai[r[i]];                                    \
+      ajtmp = aj + ai[r[i]];                                            \
+      v     = aa + BS*BS*ai[r[i]];                                      \
+      for (j=0; j<nz; j++) {ierr = PetscMemcpy(rtmp+BS*BS*ic[ajtmp[j]],v+BS*BS*j,BS*BS*sizeof(MatScalar));CHKERRQ(ierr);} \
+                                                                        \
+      /* elimination */                                                 \
+      bjtmp = bj + bi[i];                                               \
+      nzL   = bi[i+1] - bi[i];                                          \
+      for (k=0; k<nzL; k++) {                                           \
+        row = bjtmp[k];                                                 \
+        pc  = rtmp + BS*BS*row;                                         \
+        for (flg=PETSC_FALSE,j=0; j<BS*BS; j++) {                       \
+          if (pc[j] != (MatScalar)0.0) {flg = PETSC_TRUE; break;}       \
+        }                                                               \
+        if (flg) {                                                      \
+          pv = b->a + BS*BS*bdiag[row];                                 \
+          PetscKernel_A_gets_A_times_B_BS(BS,pc,pv,mwork);              \
+          pj = b->j + bdiag[row+1]+1;                                   \
+          pv = b->a + BS*BS*(bdiag[row+1]+1);                           \
+          nz = bdiag[row] - bdiag[row+1] - 1;                           \
+          for (j=0; j<nz; j++) PetscKernel_A_gets_A_minus_B_times_C_BS(BS,rtmp+BS*BS*pj[j],pc,pv+BS*BS*j); \
+          ierr = PetscLogFlops(2*BS*BS*BS*(nz+1)-BS*BS);CHKERRQ(ierr);  \
+        }                                                               \
+      }                                                                 \
+                                                                        \
+      /* finished row so stick it into b->a, L part */                  \
+      pv = b->a + BS*BS*bi[i];                                          \
+      pj = b->j + bi[i];                                                \
+      nz = bi[i+1] - bi[i];                                             \
+      for (j=0; j<nz; j++) {ierr = PetscMemcpy(pv+BS*BS*j,rtmp+BS*BS*pj[j],BS*BS*sizeof(MatScalar));CHKERRQ(ierr);} \
+                                                                        \
+      /* invert the diagonal block for the triangular solves */         \
+      pv   = b->a + BS*BS*bdiag[i];                                     \
+      pj   = b->j + bdiag[i];                                           \
+      ierr = PetscMemcpy(pv,rtmp+BS*BS*pj[0],BS*BS*sizeof(MatScalar));CHKERRQ(ierr); \
+      ierr = PetscKernel_A_gets_inverse_A(BS,pv,pivots,vwork,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr); \
+      if (zeropivotdetected) B->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT; \
+                                                                        \
+      /* U part */                                                      \
+      pv = b->a + BS*BS*(bdiag[i+1]+1);                                 \
+      pj = b->j + bdiag[i+1]+1;                                         \
+      nz = bdiag[i] - bdiag[i+1] - 1;                                   \
+      for (j=0; j<nz; j++) {ierr = PetscMemcpy(pv+BS*BS*j,rtmp+BS*BS*pj[j],BS*BS*sizeof(MatScalar));CHKERRQ(ierr);} \
+    }                                                                   \
+    (void)mwork;                                                        \
+    ierr = PetscFree(rtmp);CHKERRQ(ierr);                               \
+    ierr = ISRestoreIndices(b->icol,&ic);CHKERRQ(ierr);                 \
+    ierr = ISRestoreIndices(b->row,&r);CHKERRQ(ierr);                   \
+                                                                        \
+    ierr = ISIdentity(b->row,&row_identity);CHKERRQ(ierr);              \
+    ierr = ISIdentity(b->icol,&col_identity);CHKERRQ(ierr);             \
+    if (row_identity && col_identity) B->ops->solve = MatSolve_SeqBAIJ_##BS##_NaturalOrdering_Fixed; \
+    else                              B->ops->solve = MatSolve_SeqBAIJ_##BS##_Fixed; \
+    B->ops->solvetranspose = MatSolveTranspose_SeqBAIJ_N;               \
+    B->assembled           = PETSC_TRUE;                                \
+    ierr = PetscLogFlops(1.333333333333*BS*BS*BS*b->mbs);CHKERRQ(ierr); /* from inverting diagonal blocks */ \
+    PetscFunctionReturn(0);                                             \
+  }
+
+/*
+   Same iterations as MatSOR_SeqBAIJ(), the inverses of the diagonal blocks come from MatInvertBlockDiagonal()
+*/
+#define DEF_MatSOR_SeqBAIJ_Fixed(BS)                                    \
+  PetscErrorCode MatSOR_SeqBAIJ_##BS##_Fixed(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx) \
+  {                                                                     \
+    Mat_SeqBAIJ       *a = (Mat_SeqBAIJ*)A->data;                       \
+    PetscScalar       *x,*t,s[BS],w[BS];                                \
+    const MatScalar   *v,*aa = a->a,*idiag;                             \
+    const PetscScalar *b,*xb;                                           \
+    PetscErrorCode    ierr;                                             \
+    PetscInt          m = a->mbs,i,k,l,nz;                              \
+    const PetscInt    *diag,*ai = a->i,*aj = a->j,*vi;                  \
+                                                                        \
+    PetscFunctionBegin;                                                 \
+    its = its*lits;                                                     \
+    if (flag & SOR_EISENSTAT) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support yet for Eisenstat"); \
+    if (its <= 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Relaxation requires global its %D and local its %D both positive",its,lits); \
+    if (fshift) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Sorry, no support for diagonal shift"); \
+    if (omega != 1.0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Sorry, no support for non-trivial relaxation factor"); \
+    if ((flag & SOR_APPLY_UPPER) || (flag & SOR_APPLY_LOWER)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Sorry, no support for applying upper or lower triangular parts"); \
+                                                                        \
+    if (!a->idiagvalid) {ierr = MatInvertBlockDiagonal(A,NULL);CHKERRQ(ierr);} \
+    if (!m) PetscFunctionReturn(0);                                     \
+    diag = a->diag;                                                     \
+    if (!a->sor_workt) {ierr = PetscMalloc1(PetscMax(A->rmap->n,A->cmap->n),&a->sor_workt);CHKERRQ(ierr);} \
+    t    = a->sor_workt;                                                \
+    ierr = VecGetArray(xx,&x);CHKERRQ(ierr);                            \
+    ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);                        \
+                                                                        \
+    if (flag & SOR_ZERO_INITIAL_GUESS) {                                \
+      xb = b;                                                           \
+      if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) { \
+        /* x_i = D_i^{-1} (b_i - L_i x), t keeps b_i - L_i x for the backward sweep */ \
+        idiag = a->idiag;                                               \
+        for (i=0; i<m; i++) {                                           \
+          v  = aa + BS*BS*ai[i];                                        \
+          vi = aj + ai[i];                                              \
+          nz = diag[i] - ai[i];                                         \
+          for (l=0; l<BS; l++) s[l] = b[BS*i+l];                        \
+          for (k=0; k<nz; k++) {                                        \
+            PetscKernel_v_gets_v_minus_A_times_w_BS(BS,s,v,x+BS*vi[k]); \
+            v += BS*BS;                                                 \
+          }                                                             \
+          for (l=0; l<BS; l++) t[BS*i+l] = s[l];                        \
+          PetscKernel_v_gets_A_times_w_BS(BS,x+BS*i,idiag,s);           \
+          idiag += BS*BS;                                               \
+        }                                                               \
+        ierr = PetscLogFlops(1.0*BS*BS*a->nz);CHKERRQ(ierr);            \
+        xb = t;                                                         \
+      }                                                                 \
+      if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) { \
+        /* x_i = D_i^{-1} (xb_i - U_i x) */                             \
+        idiag = a->idiag + BS*BS*(m-1);                                 \
+        for (i=m-1; i>=0; i--) {                                        \
+          v  = aa + BS*BS*(diag[i]+1);                                  \
+          vi = aj + diag[i] + 1;                                        \
+          nz = ai[i+1] - diag[i] - 1;                                   \
+          for (l=0; l<BS; l++) s[l] = xb[BS*i+l];                       \
+          for (k=0; k<nz; k++) {                                        \
+            PetscKernel_v_gets_v_minus_A_times_w_BS(BS,s,v,x+BS*vi[k]); \
+            v += BS*BS;                                                 \
+          }                                                             \
+          PetscKernel_v_gets_A_times_w_BS(BS,x+BS*i,idiag,s);           \
+          idiag -= BS*BS;                                               \
+        }                                                               \
+        ierr = PetscLogFlops(1.0*BS*BS*a->nz);CHKERRQ(ierr);            \
+      }                                                                 \
+      its--;                                                            \
+    }                                                                   \
+    while (its--) {                                                     \
+      /* x_i = x_i + D_i^{-1} (b_i - A_i x) */                          \
+      if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) { \
+        idiag = a->idiag;                                               \
+        for (i=0; i<m; i++) {                                           \
+          v  = aa + BS*BS*ai[i];                                        \
+          vi = aj + ai[i];                                              \
+          nz = ai[i+1] - ai[i];                                         \
+          for (l=0; l<BS; l++) w[l] = b[BS*i+l];                        \
+          for (k=0; k<nz; k++) {                                        \
+            PetscKernel_v_gets_v_minus_A_times_w_BS(BS,w,v,x+BS*vi[k]); \
+            v += BS*BS;                                                 \
+          }                                                             \
+          PetscKernel_v_gets_v_plus_A_times_w_BS(BS,x+BS*i,idiag,w);    \
+          idiag += BS*BS;                                               \
+        }                                                               \
+        ierr = PetscLogFlops(2.0*BS*BS*a->nz);CHKERRQ(ierr);            \
+      }                                                                 \
+      if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) { \
+        idiag = a->idiag + BS*BS*(m-1);                                 \
+        for (i=m-1; i>=0; i--) {                                        \
+          v  = aa + BS*BS*ai[i];                                        \
+          vi = aj + ai[i];                                              \
+          nz = ai[i+1] - ai[i];                                         \
+          for (l=0; l<BS; l++) w[l] = b[BS*i+l];                        \
+          for (k=0; k<nz; k++) {                                        \
+            PetscKernel_v_gets_v_minus_A_times_w_BS(BS,w,v,x+BS*vi[k]); \
+            v += BS*BS;                                                 \
+          }                                                             \
+          PetscKernel_v_gets_v_plus_A_times_w_BS(BS,x+BS*i,idiag,w);    \
+          idiag -= BS*BS;                                               \
+        }                                                               \
+        ierr = PetscLogFlops(2.0*BS*BS*a->nz);CHKERRQ(ierr);            \
+      }                                                                 \
+    }                                                                   \
+    ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);                        \
+    ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);                    \
+    PetscFunctionReturn(0);                                             \
+  }
+
+#define DEF_SeqBAIJ_Fixed(BS)                           \
+  DEF_MatMult_SeqBAIJ_Fixed(BS)                         \
+  DEF_MatMultAdd_SeqBAIJ_Fixed(BS)                      \
+  DEF_MatSolve_SeqBAIJ_Fixed(BS,1,_NaturalOrdering_Fixed) \
+  DEF_MatSolve_SeqBAIJ_Fixed(BS,0,_Fixed)               \
+  DEF_MatLUFactorNumeric_SeqBAIJ_Fixed(BS)              \
+  DEF_MatSOR_SeqBAIJ_Fixed(BS)
+
+DEF_SeqBAIJ_Fixed(8)
+DEF_SeqBAIJ_Fixed(9)
+DEF_SeqBAIJ_Fixed(10)
+DEF_SeqBAIJ_Fixed(11)
+DEF_SeqBAIJ_Fixed(12)
+DEF_SeqBAIJ_Fixed(13)
+DEF_SeqBAIJ_Fixed(14)
+DEF_SeqBAIJ_Fixed(15)
+DEF_SeqBAIJ_Fixed(16)
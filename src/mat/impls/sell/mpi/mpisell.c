@@ -75,28 +75,28 @@ PetscErrorCode MatCreateColmap_MPISELL_Private(Mat mat)
     lastcol1 = col; \
     while (high1-low1 > 5) { \
       t = (low1+high1)/2; \
-      if (*(cp1+8*t) > col) high1 = t; \
+      if (*(cp1+a->sliceheight*t) > col) high1 = t; \
       else                   low1 = t; \
     } \
     for (_i=low1; _i<high1; _i++) { \
-      if (*(cp1+8*_i) > col) break; \
-      if (*(cp1+8*_i) == col) { \
-        if (addv == ADD_VALUES) *(vp1+8*_i) += value;   \
-        else                     *(vp1+8*_i) = value; \
+      if (*(cp1+a->sliceheight*_i) > col) break; \
+      if (*(cp1+a->sliceheight*_i) == col) { \
+        if (addv == ADD_VALUES) *(vp1+a->sliceheight*_i) += value;   \
+        else                     *(vp1+a->sliceheight*_i) = value; \
         goto a_noinsert; \
       } \
     }  \
     if (value == 0.0 && ignorezeroentries) {low1 = 0; high1 = nrow1;goto a_noinsert;} \
     if (nonew == 1) {low1 = 0; high1 = nrow1; goto a_noinsert;} \
     if (nonew == -1) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Inserting a new nonzero at global row/column (%D, %D) into matrix", orow, ocol); \
-    MatSeqXSELLReallocateSELL(A,am,1,nrow1,a->sliidx,row/8,row,col,a->colidx,a->val,cp1,vp1,nonew,MatScalar); \
+    MatSeqXSELLReallocateSELL(A,am,1,nrow1,a->sliidx,a->sliceheight,row/a->sliceheight,row,col,a->colidx,a->val,cp1,vp1,nonew,MatScalar); \
     /* shift up all the later entries in this row */ \
     for (ii=nrow1-1; ii>=_i; ii--) { \
-      *(cp1+8*(ii+1)) = *(cp1+8*ii); \
-      *(vp1+8*(ii+1)) = *(vp1+8*ii); \
+      *(cp1+a->sliceheight*(ii+1)) = *(cp1+a->sliceheight*ii); \
+      *(vp1+a->sliceheight*(ii+1)) = *(vp1+a->sliceheight*ii); \
     } \
-    *(cp1+8*_i) = col; \
-    *(vp1+8*_i) = value; \
+    *(cp1+a->sliceheight*_i) = col; \
+    *(vp1+a->sliceheight*_i) = value; \
     a->nz++; nrow1++; A->nonzerostate++; \
     a_noinsert: ; \
     a->rlen[row] = nrow1; \
@@ -109,28 +109,28 @@ PetscErrorCode MatCreateColmap_MPISELL_Private(Mat mat)
     lastcol2 = col; \
     while (high2-low2 > 5) { \
       t = (low2+high2)/2; \
-      if (*(cp2+8*t) > col) high2 = t; \
+      if (*(cp2+b->sliceheight*t) > col) high2 = t; \
       else low2  = t; \
     } \
     for (_i=low2; _i<high2; _i++) { \
-      if (*(cp2+8*_i) > col) break; \
-      if (*(cp2+8*_i) == col) { \
-        if (addv == ADD_VALUES) *(vp2+8*_i) += value; \
-        else                     *(vp2+8*_i) = value; \
+      if (*(cp2+b->sliceheight*_i) > col) break; \
+      if (*(cp2+b->sliceheight*_i) == col) { \
+        if (addv == ADD_VALUES) *(vp2+b->sliceheight*_i) += value; \
+        else                     *(vp2+b->sliceheight*_i) = value; \
         goto b_noinsert; \
       } \
     } \
     if (value == 0.0 && ignorezeroentries) {low2 = 0; high2 = nrow2; goto b_noinsert;} \
     if (nonew == 1) {low2 = 0; high2 = nrow2; goto b_noinsert;} \
     if (nonew == -1) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Inserting a new nonzero at global row/column (%D, %D) into matrix", orow, ocol); \
-    MatSeqXSELLReallocateSELL(B,bm,1,nrow2,b->sliidx,row/8,row,col,b->colidx,b->val,cp2,vp2,nonew,MatScalar); \
+    MatSeqXSELLReallocateSELL(B,bm,1,nrow2,b->sliidx,b->sliceheight,row/b->sliceheight,row,col,b->colidx,b->val,cp2,vp2,nonew,MatScalar); \
     /* shift up all the later entries in this row */ \
     for (ii=nrow2-1; ii>=_i; ii--) { \
-      *(cp2+8*(ii+1)) = *(cp2+8*ii); \
-      *(vp2+8*(ii+1)) = *(vp2+8*ii); \
+      *(cp2+b->sliceheight*(ii+1)) = *(cp2+b->sliceheight*ii); \
+      *(vp2+b->sliceheight*(ii+1)) = *(vp2+b->sliceheight*ii); \
     } \
-    *(cp2+8*_i) = col; \
-    *(vp2+8*_i) = value; \
+    *(cp2+b->sliceheight*_i) = col; \
+    *(vp2+b->sliceheight*_i) = value; \
     b->nz++; nrow2++; B->nonzerostate++; \
     b_noinsert: ; \
     b->rlen[row] = nrow2; \
@@ -163,14 +163,14 @@ PetscErrorCode MatSetValues_MPISELL(Mat mat,PetscInt m,const PetscInt im[],Petsc
     if (im[i] >= rstart && im[i] < rend) {
       row      = im[i] - rstart;
       lastcol1 = -1;
-      shift1   = a->sliidx[row>>3]+(row&0x07); /* starting index of the row */
+      shift1   = a->sliidx[row/a->sliceheight]+row%a->sliceheight; /* starting index of the row */
       cp1      = a->colidx+shift1;
       vp1      = a->val+shift1;
       nrow1    = a->rlen[row];
       low1     = 0;
       high1    = nrow1;
       lastcol2 = -1;
-      shift2   = b->sliidx[row>>3]+(row&0x07); /* starting index of the row */
+      shift2   = b->sliidx[row/b->sliceheight]+row%b->sliceheight; /* starting index of the row */
       cp2      = b->colidx+shift2;
       vp2      = b->val+shift2;
       nrow2    = b->rlen[row];
@@ -205,7 +205,7 @@ PetscErrorCode MatSetValues_MPISELL(Mat mat,PetscInt m,const PetscInt im[],Petsc
               /* Reinitialize the variables required by MatSetValues_SeqSELL_B_Private() */
               B      = sell->B;
               b      = (Mat_SeqSELL*)B->data;
-              shift2 = b->sliidx[row>>3]+(row&0x07); /* starting index of the row */
+              shift2 = b->sliidx[row/b->sliceheight]+row%b->sliceheight; /* starting index of the row */
               cp2    = b->colidx+shift2;
               vp2    = b->val+shift2;
               nrow2  = b->rlen[row];
@@ -625,9 +625,9 @@ PetscErrorCode MatView_MPISELL_ASCIIorDraworSocket(Mat mat,PetscViewer viewer)
     acolidx = Aloc->colidx; aval = Aloc->val;
     for (i=0; i<Aloc->totalslices; i++) { /* loop over slices */
       for (j=Aloc->sliidx[i]; j<Aloc->sliidx[i+1]; j++) {
-        isnonzero = (PetscBool)((j-Aloc->sliidx[i])/8 < Aloc->rlen[(i<<3)+(j&0x07)]);
+        isnonzero = (PetscBool)((j-Aloc->sliidx[i])/Aloc->sliceheight < Aloc->rlen[i*Aloc->sliceheight+(j-Aloc->sliidx[i])%Aloc->sliceheight]);
         if (isnonzero) { /* check the mask bit */
-          row  = (i<<3)+(j&0x07) + mat->rmap->rstart; /* i<<3 is the starting row of this slice */
+          row  = i*Aloc->sliceheight+(j-Aloc->sliidx[i])%Aloc->sliceheight + mat->rmap->rstart; /* i*sliceheight is the starting row of this slice */
           col  = *acolidx + mat->rmap->rstart;
           ierr = MatSetValues(A,1,&row,1,&col,aval,INSERT_VALUES);CHKERRQ(ierr);
         }
@@ -640,9 +640,9 @@ PetscErrorCode MatView_MPISELL_ASCIIorDraworSocket(Mat mat,PetscViewer viewer)
     acolidx = Aloc->colidx; aval = Aloc->val;
     for (i=0; i<Aloc->totalslices; i++) {
       for (j=Aloc->sliidx[i]; j<Aloc->sliidx[i+1]; j++) {
-        isnonzero = (PetscBool)((j-Aloc->sliidx[i])/8 < Aloc->rlen[(i<<3)+(j&0x07)]);
+        isnonzero = (PetscBool)((j-Aloc->sliidx[i])/Aloc->sliceheight < Aloc->rlen[i*Aloc->sliceheight+(j-Aloc->sliidx[i])%Aloc->sliceheight]);
         if (isnonzero) {
-          row  = (i<<3)+(j&0x07) + mat->rmap->rstart;
+          row  = i*Aloc->sliceheight+(j-Aloc->sliidx[i])%Aloc->sliceheight + mat->rmap->rstart;
           col  = sell->garray[*acolidx];
           ierr = MatSetValues(A,1,&row,1,&col,aval,INSERT_VALUES);CHKERRQ(ierr);
         }
@@ -25,10 +25,10 @@ PetscErrorCode MatGetColumnIJ_SeqSELL_Color(Mat A,PetscInt oshift,PetscBool symm
   ierr = PetscMalloc1(a->nz+1,&cja);CHKERRQ(ierr);
   ierr = PetscMalloc1(a->nz+1,&cspidx);CHKERRQ(ierr);
 
-  totalslices = A->rmap->n/8+((A->rmap->n & 0x07)?1:0); /* floor(n/8) */
+  totalslices = a->totalslices;
   for (i=0; i<totalslices; i++) { /* loop over slices */
-    for (j=a->sliidx[i],row=0; j<a->sliidx[i+1]; j++,row=((row+1)&0x07)) {
-      isnonzero = (PetscBool)((j-a->sliidx[i])/8 < a->rlen[8*i+row]);
+    for (j=a->sliidx[i],row=0; j<a->sliidx[i+1]; j++,row=((row+1)%a->sliceheight)) {
+      isnonzero = (PetscBool)((j-a->sliidx[i])/a->sliceheight < a->rlen[a->sliceheight*i+row]);
       if (isnonzero) collengths[a->colidx[j]]++;
     }
   }
@@ -40,12 +40,12 @@ PetscErrorCode MatGetColumnIJ_SeqSELL_Color(Mat A,PetscInt oshift,PetscBool symm
   ierr = PetscMemzero(collengths,n*sizeof(PetscInt));CHKERRQ(ierr);
 
   for (i=0; i<totalslices; i++) { /* loop over slices */
-    for (j=a->sliidx[i],row=0; j<a->sliidx[i+1]; j++,row=((row+1)&0x07)) {
-      isnonzero = (PetscBool)((j-a->sliidx[i])/8 < a->rlen[8*i+row]);
+    for (j=a->sliidx[i],row=0; j<a->sliidx[i+1]; j++,row=((row+1)%a->sliceheight)) {
+      isnonzero = (PetscBool)((j-a->sliidx[i])/a->sliceheight < a->rlen[a->sliceheight*i+row]);
       if (isnonzero) {
         col = a->colidx[j];
         cspidx[cia[col]+collengths[col]-oshift] = j; /* index of a->colidx */
-        cja[cia[col]+collengths[col]-oshift] = 8*i+row +oshift; /* row index */
+        cja[cia[col]+collengths[col]-oshift] = a->sliceheight*i+row +oshift; /* row index */
         collengths[col]++;
       }
     }
@@ -5,33 +5,6 @@
 #include <../src/mat/impls/sell/seq/sell.h>  /*I   "petscmat.h"  I*/
 #include <petscblaslapack.h>
 #include <petsc/private/kernels/blocktranspose.h>
-#if defined(PETSC_HAVE_IMMINTRIN_H) && (defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__)) || defined(__AVX__)) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-
-  #include <immintrin.h>
-
-  #if !defined(_MM_SCALE_8)
-  #define _MM_SCALE_8    8
-  #endif
-
-  #if defined(__AVX512F__)
-  /* these do not work
-   vec_idx  = _mm512_loadunpackhi_epi32(vec_idx,acolidx);
-   vec_vals = _mm512_loadunpackhi_pd(vec_vals,aval);
-  */
-    #define AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y) \
-    /* if the mask bit is set, copy from acolidx, otherwise from vec_idx */ \
-    vec_idx  = _mm256_loadu_si256((__m256i const*)acolidx); \
-    vec_vals = _mm512_loadu_pd(aval); \
-    vec_x    = _mm512_i32gather_pd(vec_idx,x,_MM_SCALE_8); \
-    vec_y    = _mm512_fmadd_pd(vec_x,vec_vals,vec_y)
-  #elif defined(__AVX2__) && defined(__FMA__)
-    #define AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y) \
-    vec_vals = _mm256_loadu_pd(aval); \
-    vec_idx  = _mm_loadu_si128((__m128i const*)acolidx); /* SSE2 */ \
-    vec_x    = _mm256_i32gather_pd(x,vec_idx,_MM_SCALE_8); \
-    vec_y    = _mm256_fmadd_pd(vec_x,vec_vals,vec_y)
-  #endif
-#endif  /* PETSC_HAVE_IMMINTRIN_H */
 
 /*@C
  MatSeqSELLSetPreallocation - For good matrix assembly performance
@@ -114,10 +87,10 @@ PetscErrorCode MatSeqSELLSetPreallocation_SeqSELL(Mat B,PetscInt maxallocrow,con
 
   b = (Mat_SeqSELL*)B->data;
 
-  totalslices = B->rmap->n/8+((B->rmap->n & 0x07)?1:0); /* ceil(n/8) */
+  totalslices = B->rmap->n/b->sliceheight+((B->rmap->n % b->sliceheight)?1:0); /* ceil(n/sliceheight) */
   b->totalslices = totalslices;
   if (!skipallocation) {
-    if (B->rmap->n & 0x07) {ierr = PetscInfo1(B,"Padding rows to the SEQSELL matrix because the number of rows is not the multiple of 8 (value %D)\n",B->rmap->n);CHKERRQ(ierr);}
+    if (B->rmap->n % b->sliceheight) {ierr = PetscInfo2(B,"Padding rows to the SEQSELL matrix because the number of rows is not the multiple of the slice height %D (value %D)\n",b->sliceheight,B->rmap->n);CHKERRQ(ierr);}
 
     if (!b->sliidx) { /* sliidx gives the starting index of each slice, the last element is the total space allocated */
       ierr = PetscMalloc1(totalslices+1,&b->sliidx);CHKERRQ(ierr);
@@ -126,23 +99,23 @@ PetscErrorCode MatSeqSELLSetPreallocation_SeqSELL(Mat B,PetscInt maxallocrow,con
     if (!rlen) { /* if rlen is not provided, allocate same space for all the slices */
       if (maxallocrow == PETSC_DEFAULT || maxallocrow == PETSC_DECIDE) maxallocrow = 10;
       else if (maxallocrow < 0) maxallocrow = 1;
-      for (i=0; i<=totalslices; i++) b->sliidx[i] = i*8*maxallocrow;
+      for (i=0; i<=totalslices; i++) b->sliidx[i] = i*b->sliceheight*maxallocrow;
     } else {
       maxallocrow = 0;
       b->sliidx[0] = 0;
       for (i=1; i<totalslices; i++) {
         b->sliidx[i] = 0;
-        for (j=0;j<8;j++) {
-          b->sliidx[i] = PetscMax(b->sliidx[i],rlen[8*(i-1)+j]);
+        for (j=0;j<b->sliceheight;j++) {
+          b->sliidx[i] = PetscMax(b->sliidx[i],rlen[b->sliceheight*(i-1)+j]);
         }
         maxallocrow = PetscMax(b->sliidx[i],maxallocrow);
-        b->sliidx[i] = b->sliidx[i-1] + 8*b->sliidx[i];
+        b->sliidx[i] = b->sliidx[i-1] + b->sliceheight*b->sliidx[i];
       }
       /* last slice */
       b->sliidx[totalslices] = 0;
-      for (j=(totalslices-1)*8;j<B->rmap->n;j++) b->sliidx[totalslices] = PetscMax(b->sliidx[totalslices],rlen[j]);
+      for (j=(totalslices-1)*b->sliceheight;j<B->rmap->n;j++) b->sliidx[totalslices] = PetscMax(b->sliidx[totalslices],rlen[j]);
       maxallocrow = PetscMax(b->sliidx[totalslices],maxallocrow);
-      b->sliidx[totalslices] = b->sliidx[totalslices-1] + 8*b->sliidx[totalslices];
+      b->sliidx[totalslices] = b->sliidx[totalslices-1] + b->sliceheight*b->sliidx[totalslices];
     }
 
     /* allocate space for val, colidx, rlen */
@@ -152,8 +125,8 @@ PetscErrorCode MatSeqSELLSetPreallocation_SeqSELL(Mat B,PetscInt maxallocrow,con
     ierr = PetscMalloc2(b->sliidx[totalslices],&b->val,b->sliidx[totalslices],&b->colidx);CHKERRQ(ierr);
     ierr = PetscLogObjectMemory((PetscObject)B,b->sliidx[totalslices]*(sizeof(PetscScalar)+sizeof(PetscInt)));CHKERRQ(ierr);
     /* b->rlen will count nonzeros in each row so far. We dont copy rlen to b->rlen because the matrix has not been set. */
-    ierr = PetscCalloc1(8*totalslices,&b->rlen);CHKERRQ(ierr);
-    ierr = PetscLogObjectMemory((PetscObject)B,8*totalslices*sizeof(PetscInt));CHKERRQ(ierr);
+    ierr = PetscCalloc1(b->sliceheight*totalslices,&b->rlen);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)B,b->sliceheight*totalslices*sizeof(PetscInt));CHKERRQ(ierr);
 
     b->singlemalloc = PETSC_TRUE;
     b->free_val     = PETSC_TRUE;
@@ -182,7 +155,7 @@ PetscErrorCode MatGetRow_SeqSELL(Mat A,PetscInt row,PetscInt *nz,PetscInt **idx,
   PetscFunctionBegin;
   if (row < 0 || row >= A->rmap->n) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row %D out of range",row);
   if (nz) *nz = a->rlen[row];
-  shift = a->sliidx[row>>3]+(row&0x07);
+  shift = a->sliidx[row/a->sliceheight]+row%a->sliceheight;
   if (!a->getrowcols) {
     PetscErrorCode ierr;
 
@@ -190,12 +163,12 @@ PetscErrorCode MatGetRow_SeqSELL(Mat A,PetscInt row,PetscInt *nz,PetscInt **idx,
   }
   if (idx) {
     PetscInt j;
-    for (j=0; j<a->rlen[row]; j++) a->getrowcols[j] = a->colidx[shift+8*j];
+    for (j=0; j<a->rlen[row]; j++) a->getrowcols[j] = a->colidx[shift+a->sliceheight*j];
     *idx = a->getrowcols;
   }
   if (v) {
     PetscInt j;
-    for (j=0; j<a->rlen[row]; j++) a->getrowvals[j] = a->val[shift+8*j];
+    for (j=0; j<a->rlen[row]; j++) a->getrowvals[j] = a->val[shift+a->sliceheight*j];
     *v = a->getrowvals;
   }
   PetscFunctionReturn(0);
@@ -292,203 +265,123 @@ PetscErrorCode MatConvert_SeqAIJ_SeqSELL(Mat A,MatType newtype,MatReuse reuse,Ma
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode MatMult_SeqSELL(Mat A,Vec xx,Vec yy)
+/*
+   z = A*x + y, or z = A*x when y is NULL; y and z may be the same array.
+   Rows of a slice are processed in groups of 8 so that the common slice height of 8 gets a fully unrolled loop.
+*/
+static PetscErrorCode MatMultKernel_SeqSELL(Mat A,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
 {
-  Mat_SeqSELL       *a=(Mat_SeqSELL*)A->data;
-  PetscScalar       *y;
-  const PetscScalar *x;
-  const MatScalar   *aval=a->val;
-  PetscInt          totalslices=a->totalslices;
-  const PetscInt    *acolidx=a->colidx;
-  PetscInt          i,j;
-  PetscErrorCode    ierr;
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m512d           vec_x,vec_y,vec_vals;
-  __m256i           vec_idx;
-  __mmask8          mask;
-  __m512d           vec_x2,vec_y2,vec_vals2,vec_x3,vec_y3,vec_vals3,vec_x4,vec_y4,vec_vals4;
-  __m256i           vec_idx2,vec_idx3,vec_idx4;
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m128i           vec_idx;
-  __m256d           vec_x,vec_y,vec_y2,vec_vals;
-  MatScalar         yval;
-  PetscInt          r,rows_left,row,nnz_in_row;
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m128d           vec_x_tmp;
-  __m256d           vec_x,vec_y,vec_y2,vec_vals;
-  MatScalar         yval;
-  PetscInt          r,rows_left,row,nnz_in_row;
-#else
-  PetscScalar       sum[8];
-#endif
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const PetscInt  sh=a->sliceheight,m=A->rmap->n,*sliidx=a->sliidx;
+  const MatScalar *aval;
+  const PetscInt  *acolidx;
+  PetscInt        i,j,c,r,row,nrows;
+  PetscScalar     sum[8];
 
 #if defined(PETSC_HAVE_PRAGMA_DISJOINT)
-#pragma disjoint(*x,*y,*aval)
+#pragma disjoint(*x,*z,*aval)
 #endif
 
   PetscFunctionBegin;
-  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
-  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  for (i=0; i<totalslices; i++) { /* loop over slices */
-    PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-
-    vec_y  = _mm512_setzero_pd();
-    vec_y2 = _mm512_setzero_pd();
-    vec_y3 = _mm512_setzero_pd();
-    vec_y4 = _mm512_setzero_pd();
-
-    j = a->sliidx[i]>>3; /* 8 bytes are read at each time, corresponding to a slice columnn */
-    switch ((a->sliidx[i+1]-a->sliidx[i])/8 & 3) {
-    case 3:
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx3,vec_x3,vec_vals3,vec_y3);
-      acolidx += 8; aval += 8;
-      j += 3;
-      break;
-    case 2:
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
-      acolidx += 8; aval += 8;
-      j += 2;
-      break;
-    case 1:
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      j += 1;
-      break;
-    }
-    #pragma novector
-    for (; j<(a->sliidx[i+1]>>3); j+=4) {
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx3,vec_x3,vec_vals3,vec_y3);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx4,vec_x4,vec_vals4,vec_y4);
-      acolidx += 8; aval += 8;
-    }
-
-    vec_y = _mm512_add_pd(vec_y,vec_y2);
-    vec_y = _mm512_add_pd(vec_y,vec_y3);
-    vec_y = _mm512_add_pd(vec_y,vec_y4);
-    if (i == totalslices-1 && A->rmap->n & 0x07) { /* if last slice has padding rows */
-      mask = (__mmask8)(0xff >> (8-(A->rmap->n & 0x07)));
-      _mm512_mask_storeu_pd(&y[8*i],mask,vec_y);
-    } else {
-      _mm512_storeu_pd(&y[8*i],vec_y);
-    }
-  }
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  for (i=0; i<totalslices; i++) { /* loop over full slices */
-    PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-
-    /* last slice may have padding rows. Don't use vectorization. */
-    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
-      rows_left = A->rmap->n - 8*i;
-      for (r=0; r<rows_left; ++r) {
-        yval = (MatScalar)0;
-        row = 8*i + r;
-        nnz_in_row = a->rlen[row];
-        for (j=0; j<nnz_in_row; ++j) yval += aval[8*j+r] * x[acolidx[8*j+r]];
-        y[row] = yval;
+  for (i=0; i<a->totalslices; i++) { /* loop over slices */
+    PetscPrefetchBlock(a->colidx+sliidx[i],sliidx[i+1]-sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+    PetscPrefetchBlock(a->val+sliidx[i],sliidx[i+1]-sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+    for (c=0; c<sh; c+=8) { /* loop over groups of at most 8 rows in the slice */
+      row = i*sh+c;
+      if (row >= m) break;
+      nrows   = PetscMin(PetscMin(8,sh-c),m-row); /* the last slice may have padding rows */
+      aval    = a->val+sliidx[i]+c;
+      acolidx = a->colidx+sliidx[i]+c;
+      for (r=0; r<8; r++) sum[r] = 0.0;
+      if (nrows == 8) {
+        for (j=0; j<sliidx[i+1]-sliidx[i]; j+=sh) {
+          sum[0] += aval[j] * x[acolidx[j]];
+          sum[1] += aval[j+1] * x[acolidx[j+1]];
+          sum[2] += aval[j+2] * x[acolidx[j+2]];
+          sum[3] += aval[j+3] * x[acolidx[j+3]];
+          sum[4] += aval[j+4] * x[acolidx[j+4]];
+          sum[5] += aval[j+5] * x[acolidx[j+5]];
+          sum[6] += aval[j+6] * x[acolidx[j+6]];
+          sum[7] += aval[j+7] * x[acolidx[j+7]];
+        }
+      } else {
+        for (j=0; j<sliidx[i+1]-sliidx[i]; j+=sh) {
+          for (r=0; r<nrows; r++) sum[r] += aval[j+r] * x[acolidx[j+r]];
+        }
       }
-      break;
-    }
-
-    vec_y  = _mm256_setzero_pd();
-    vec_y2 = _mm256_setzero_pd();
-
-    /* Process slice of height 8 (512 bits) via two subslices of height 4 (256 bits) via AVX */
-    #pragma novector
-    #pragma unroll(2)
-    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
-      AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      aval += 4; acolidx += 4;
-      AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y2);
-      aval += 4; acolidx += 4;
-    }
-
-    _mm256_storeu_pd(y+i*8,vec_y);
-    _mm256_storeu_pd(y+i*8+4,vec_y2);
-  }
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  for (i=0; i<totalslices; i++) { /* loop over full slices */
-    PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-
-    vec_y  = _mm256_setzero_pd();
-    vec_y2 = _mm256_setzero_pd();
-
-    /* last slice may have padding rows. Don't use vectorization. */
-    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
-      rows_left = A->rmap->n - 8*i;
-      for (r=0; r<rows_left; ++r) {
-        yval = (MatScalar)0;
-        row = 8*i + r;
-        nnz_in_row = a->rlen[row];
-        for (j=0; j<nnz_in_row; ++j) yval += aval[8*j + r] * x[acolidx[8*j + r]];
-        y[row] = yval;
+      if (y) {
+        for (r=0; r<nrows; r++) z[row+r] = y[row+r] + sum[r];
+      } else {
+        for (r=0; r<nrows; r++) z[row+r] = sum[r];
       }
-      break;
     }
+  }
+  PetscFunctionReturn(0);
+}
 
-    /* Process slice of height 8 (512 bits) via two subslices of height 4 (256 bits) via AVX */
-    #pragma novector
-    #pragma unroll(2)
-    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
-      vec_vals  = _mm256_loadu_pd(aval);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x,vec_x_tmp,0);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x,vec_x_tmp,1);
-      vec_y     = _mm256_add_pd(_mm256_mul_pd(vec_x,vec_vals),vec_y);
-      aval     += 4;
-
-      vec_vals  = _mm256_loadu_pd(aval);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x,vec_x_tmp,0);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x,vec_x_tmp,1);
-      vec_y2    = _mm256_add_pd(_mm256_mul_pd(vec_x,vec_vals),vec_y2);
-      aval     += 4;
-    }
+/*
+   y = y + A^T*x
+*/
+static PetscErrorCode MatMultTransposeKernel_SeqSELL(Mat A,const PetscScalar *x,PetscScalar *y)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const PetscInt  sh=a->sliceheight,m=A->rmap->n,*sliidx=a->sliidx;
+  const MatScalar *aval;
+  const PetscInt  *acolidx;
+  PetscInt        i,j,r,row,nrows;
 
-    _mm256_storeu_pd(y + i*8,     vec_y);
-    _mm256_storeu_pd(y + i*8 + 4, vec_y2);
-  }
-#else
-  for (i=0; i<totalslices; i++) { /* loop over slices */
-    for (j=0; j<8; j++) sum[j] = 0.0;
-    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
-      sum[0] += aval[j] * x[acolidx[j]];
-      sum[1] += aval[j+1] * x[acolidx[j+1]];
-      sum[2] += aval[j+2] * x[acolidx[j+2]];
-      sum[3] += aval[j+3] * x[acolidx[j+3]];
-      sum[4] += aval[j+4] * x[acolidx[j+4]];
-      sum[5] += aval[j+5] * x[acolidx[j+5]];
-      sum[6] += aval[j+6] * x[acolidx[j+6]];
-      sum[7] += aval[j+7] * x[acolidx[j+7]];
-    }
-    if (i == totalslices-1 && (A->rmap->n & 0x07)) { /* if last slice has padding rows */
-      for(j=0; j<(A->rmap->n & 0x07); j++) y[8*i+j] = sum[j];
+#if defined(PETSC_HAVE_PRAGMA_DISJOINT)
+#pragma disjoint(*x,*y,*aval)
+#endif
+
+  PetscFunctionBegin;
+  for (i=0; i<a->totalslices; i++) { /* loop over slices */
+    row     = i*sh;
+    nrows   = PetscMin(sh,m-row); /* the last slice may have padding rows */
+    aval    = a->val+sliidx[i];
+    acolidx = a->colidx+sliidx[i];
+    if (sh == 8 && nrows == 8) { /* the unrolled loop steps over whole slices of height 8 */
+      for (j=0; j<sliidx[i+1]-sliidx[i]; j+=8) {
+        y[acolidx[j]]   += aval[j] * x[row];
+        y[acolidx[j+1]] += aval[j+1] * x[row+1];
+        y[acolidx[j+2]] += aval[j+2] * x[row+2];
+        y[acolidx[j+3]] += aval[j+3] * x[row+3];
+        y[acolidx[j+4]] += aval[j+4] * x[row+4];
+        y[acolidx[j+5]] += aval[j+5] * x[row+5];
+        y[acolidx[j+6]] += aval[j+6] * x[row+6];
+        y[acolidx[j+7]] += aval[j+7] * x[row+7];
+      }
     } else {
-      for(j=0; j<8; j++) y[8*i+j] = sum[j];
+      for (r=0; r<nrows; r++) {
+        for (j=0; j<a->rlen[row+r]; j++) y[acolidx[sh*j+r]] += aval[sh*j+r] * x[row+r];
+      }
     }
   }
-#endif
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqSELL(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqSELL       *a=(Mat_SeqSELL*)A->data;
+  PetscScalar       *y;
+  const PetscScalar *x;
+  PetscErrorCode    ierr;
 
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  switch (a->kernel) {
+#if defined(MATSEQSELL_AVX_KERNELS)
+  case MATSEQSELL_KERNEL_AVX512:
+    ierr = MatMultKernel_SeqSELL_AVX512(A,x,NULL,y);CHKERRQ(ierr);
+    break;
+  case MATSEQSELL_KERNEL_AVX2:
+    ierr = MatMultKernel_SeqSELL_AVX2(A,x,NULL,y);CHKERRQ(ierr);
+    break;
+#endif
+  default:
+    ierr = MatMultKernel_SeqSELL(A,x,NULL,y);CHKERRQ(ierr);
+  }
   ierr = PetscLogFlops(2.0*a->nz-a->nonzerorowcnt);CHKERRQ(ierr); /* theoretical minimal FLOPs */
   ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
@@ -501,160 +394,23 @@ PetscErrorCode MatMultAdd_SeqSELL(Mat A,Vec xx,Vec yy,Vec zz)
   Mat_SeqSELL       *a=(Mat_SeqSELL*)A->data;
   PetscScalar       *y,*z;
   const PetscScalar *x;
-  const MatScalar   *aval=a->val;
-  PetscInt          totalslices=a->totalslices;
-  const PetscInt    *acolidx=a->colidx;
-  PetscInt          i,j;
   PetscErrorCode    ierr;
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m512d           vec_x,vec_y,vec_vals;
-  __m256i           vec_idx;
-  __mmask8          mask;
-  __m512d           vec_x2,vec_y2,vec_vals2,vec_x3,vec_y3,vec_vals3,vec_x4,vec_y4,vec_vals4;
-  __m256i           vec_idx2,vec_idx3,vec_idx4;
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m128d           vec_x_tmp;
-  __m256d           vec_x,vec_y,vec_y2,vec_vals;
-  MatScalar         yval;
-  PetscInt          r,row,nnz_in_row;
-#else
-  PetscScalar       sum[8];
-#endif
-
-#if defined(PETSC_HAVE_PRAGMA_DISJOINT)
-#pragma disjoint(*x,*y,*aval)
-#endif
 
   PetscFunctionBegin;
   ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  for (i=0; i<totalslices; i++) { /* loop over slices */
-    PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-
-    if (i == totalslices-1 && A->rmap->n & 0x07) { /* if last slice has padding rows */
-      mask   = (__mmask8)(0xff >> (8-(A->rmap->n & 0x07)));
-      vec_y  = _mm512_mask_loadu_pd(vec_y,mask,&y[8*i]);
-    } else {
-      vec_y  = _mm512_loadu_pd(&y[8*i]);
-    }
-    vec_y2 = _mm512_setzero_pd();
-    vec_y3 = _mm512_setzero_pd();
-    vec_y4 = _mm512_setzero_pd();
-
-    j = a->sliidx[i]>>3; /* 8 bytes are read at each time, corresponding to a slice columnn */
-    switch ((a->sliidx[i+1]-a->sliidx[i])/8 & 3) {
-    case 3:
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx3,vec_x3,vec_vals3,vec_y3);
-      acolidx += 8; aval += 8;
-      j += 3;
-      break;
-    case 2:
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
-      acolidx += 8; aval += 8;
-      j += 2;
-      break;
-    case 1:
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      j += 1;
-      break;
-    }
-    #pragma novector
-    for (; j<(a->sliidx[i+1]>>3); j+=4) {
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx3,vec_x3,vec_vals3,vec_y3);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx4,vec_x4,vec_vals4,vec_y4);
-      acolidx += 8; aval += 8;
-    }
-
-    vec_y = _mm512_add_pd(vec_y,vec_y2);
-    vec_y = _mm512_add_pd(vec_y,vec_y3);
-    vec_y = _mm512_add_pd(vec_y,vec_y4);
-    if (i == totalslices-1 && A->rmap->n & 0x07) { /* if last slice has padding rows */
-      _mm512_mask_storeu_pd(&z[8*i],mask,vec_y);
-    } else {
-      _mm512_storeu_pd(&z[8*i],vec_y);
-    }
-  }
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  for (i=0; i<totalslices; i++) { /* loop over full slices */
-    PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-
-    /* last slice may have padding rows. Don't use vectorization. */
-    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
-      for (r=0; r<(A->rmap->n & 0x07); ++r) {
-        row        = 8*i + r;
-        yval       = (MatScalar)0.0;
-        nnz_in_row = a->rlen[row];
-        for (j=0; j<nnz_in_row; ++j) yval += aval[8*j+r] * x[acolidx[8*j+r]];
-        z[row] = y[row] + yval;
-      }
-      break;
-    }
-
-    vec_y  = _mm256_loadu_pd(y+8*i);
-    vec_y2 = _mm256_loadu_pd(y+8*i+4);
-
-    /* Process slice of height 8 (512 bits) via two subslices of height 4 (256 bits) via AVX */
-    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
-      vec_vals  = _mm256_loadu_pd(aval);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x,vec_x_tmp,0);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x,vec_x_tmp,1);
-      vec_y     = _mm256_add_pd(_mm256_mul_pd(vec_x,vec_vals),vec_y);
-      aval     += 4;
-
-      vec_vals  = _mm256_loadu_pd(aval);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x,vec_x_tmp,0);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x,vec_x_tmp,1);
-      vec_y2    = _mm256_add_pd(_mm256_mul_pd(vec_x,vec_vals),vec_y2);
-      aval     += 4;
-    }
-
-    _mm256_storeu_pd(z+i*8,vec_y);
-    _mm256_storeu_pd(z+i*8+4,vec_y2);
-  }
-#else
-  for (i=0; i<totalslices; i++) { /* loop over slices */
-    for (j=0; j<8; j++) sum[j] = 0.0;
-    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
-      sum[0] += aval[j] * x[acolidx[j]];
-      sum[1] += aval[j+1] * x[acolidx[j+1]];
-      sum[2] += aval[j+2] * x[acolidx[j+2]];
-      sum[3] += aval[j+3] * x[acolidx[j+3]];
-      sum[4] += aval[j+4] * x[acolidx[j+4]];
-      sum[5] += aval[j+5] * x[acolidx[j+5]];
-      sum[6] += aval[j+6] * x[acolidx[j+6]];
-      sum[7] += aval[j+7] * x[acolidx[j+7]];
-    }
-    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
-      for (j=0; j<(A->rmap->n & 0x07); j++) z[8*i+j] = y[8*i+j] + sum[j];
-    } else {
-      for (j=0; j<8; j++) z[8*i+j] = y[8*i+j] + sum[j];
-    }
-  }
+  switch (a->kernel) {
+#if defined(MATSEQSELL_AVX_KERNELS)
+  case MATSEQSELL_KERNEL_AVX512:
+    ierr = MatMultKernel_SeqSELL_AVX512(A,x,y,z);CHKERRQ(ierr);
+    break;
+  case MATSEQSELL_KERNEL_AVX2:
+    ierr = MatMultKernel_SeqSELL_AVX2(A,x,y,z);CHKERRQ(ierr);
+    break;
 #endif
-
+  default:
+    ierr = MatMultKernel_SeqSELL(A,x,y,z);CHKERRQ(ierr);
+  }
   ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
@@ -666,15 +422,8 @@ PetscErrorCode MatMultTransposeAdd_SeqSELL(Mat A,Vec xx,Vec zz,Vec yy)
   Mat_SeqSELL       *a=(Mat_SeqSELL*)A->data;
   PetscScalar       *y;
   const PetscScalar *x;
-  const MatScalar   *aval=a->val;
-  const PetscInt    *acolidx=a->colidx;
-  PetscInt          i,j,r,row,nnz_in_row,totalslices=a->totalslices;
   PetscErrorCode    ierr;
 
-#if defined(PETSC_HAVE_PRAGMA_DISJOINT)
-#pragma disjoint(*x,*y,*aval)
-#endif
-
   PetscFunctionBegin;
   if (A->symmetric) {
     ierr = MatMultAdd_SeqSELL(A,xx,zz,yy);CHKERRQ(ierr);
@@ -683,25 +432,17 @@ PetscErrorCode MatMultTransposeAdd_SeqSELL(Mat A,Vec xx,Vec zz,Vec yy)
   if (zz != yy) { ierr = VecCopy(zz,yy);CHKERRQ(ierr); }
   ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
-  for (i=0; i<a->totalslices; i++) { /* loop over slices */
-    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
-      for (r=0; r<(A->rmap->n & 0x07); ++r) {
-        row        = 8*i + r;
-        nnz_in_row = a->rlen[row];
-        for (j=0; j<nnz_in_row; ++j) y[acolidx[8*j+r]] += aval[8*j+r] * x[row];
-      }
-      break;
-    }
-    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
-      y[acolidx[j]]   += aval[j] * x[8*i];
-      y[acolidx[j+1]] += aval[j+1] * x[8*i+1];
-      y[acolidx[j+2]] += aval[j+2] * x[8*i+2];
-      y[acolidx[j+3]] += aval[j+3] * x[8*i+3];
-      y[acolidx[j+4]] += aval[j+4] * x[8*i+4];
-      y[acolidx[j+5]] += aval[j+5] * x[8*i+5];
-      y[acolidx[j+6]] += aval[j+6] * x[8*i+6];
-      y[acolidx[j+7]] += aval[j+7] * x[8*i+7];
-    }
+  switch (a->kernel) {
+#if defined(MATSEQSELL_AVX_KERNELS)
+  case MATSEQSELL_KERNEL_AVX512:
+    ierr = MatMultTransposeKernel_SeqSELL_AVX512(A,x,y);CHKERRQ(ierr);
+    break;
+  case MATSEQSELL_KERNEL_AVX2:
+    ierr = MatMultTransposeKernel_SeqSELL_AVX2(A,x,y);CHKERRQ(ierr);
+    break;
+#endif
+  default:
+    ierr = MatMultTransposeKernel_SeqSELL(A,x,y);CHKERRQ(ierr);
   }
   ierr = PetscLogFlops(2.0*a->sliidx[a->totalslices]);CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
@@ -765,11 +506,11 @@ PetscErrorCode MatMarkDiagonal_SeqSELL(Mat A)
     a->free_diag = PETSC_TRUE;
   }
   for (i=0; i<m; i++) { /* loop over rows */
-    shift = a->sliidx[i>>3]+(i&0x07); /* starting index of the row i */
+    shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight; /* starting index of the row i */
     a->diag[i] = -1;
     for (j=0; j<a->rlen[i]; j++) {
-      if (a->colidx[shift+j*8] == i) {
-        a->diag[i] = shift+j*8;
+      if (a->colidx[shift+j*a->sliceheight] == i) {
+        a->diag[i] = shift+j*a->sliceheight;
         break;
       }
     }
@@ -933,11 +674,11 @@ PetscErrorCode MatGetDiagonal_SeqSELL(Mat A,Vec v)
   ierr = VecSet(v,zero);CHKERRQ(ierr);
   ierr = VecGetArray(v,&x);CHKERRQ(ierr);
   for (i=0; i<n; i++) { /* loop over rows */
-    shift = a->sliidx[i>>3]+(i&0x07); /* starting index of the row i */
+    shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight; /* starting index of the row i */
     x[i] = 0;
     for (j=0; j<a->rlen[i]; j++) {
-      if (a->colidx[shift+j*8] == i) {
-        x[i] = a->val[shift+j*8];
+      if (a->colidx[shift+j*a->sliceheight] == i) {
+        x[i] = a->val[shift+j*a->sliceheight];
         break;
       }
     }
@@ -961,8 +702,8 @@ PetscErrorCode MatDiagonalScale_SeqSELL(Mat A,Vec ll,Vec rr)
     if (m != A->rmap->n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Left scaling vector wrong length");
     ierr = VecGetArrayRead(ll,&l);CHKERRQ(ierr);
     for (i=0; i<a->totalslices; i++) { /* loop over slices */
-      for (j=a->sliidx[i],row=0; j<a->sliidx[i+1]; j++,row=((row+1)&0x07)) {
-        a->val[j] *= l[8*i+row];
+      for (j=a->sliidx[i],row=0; j<a->sliidx[i+1]; j++,row=((row+1)%a->sliceheight)) {
+        a->val[j] *= l[a->sliceheight*i+row];
       }
     }
     ierr = VecRestoreArrayRead(ll,&l);CHKERRQ(ierr);
@@ -1000,7 +741,7 @@ PetscErrorCode MatGetValues_SeqSELL(Mat A,PetscInt m,const PetscInt im[],PetscIn
 #if defined(PETSC_USE_DEBUG)
     if (row >= A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",row,A->rmap->n-1);
 #endif
-    shift = a->sliidx[row>>3]+(row&0x07); /* starting index of the row */
+    shift = a->sliidx[row/a->sliceheight]+row%a->sliceheight; /* starting index of the row */
     cp = a->colidx+shift; /* pointer to the row */
     vp = a->val+shift; /* pointer to the row */
     for (l=0; l<n; l++) { /* loop over requested columns */
@@ -1012,13 +753,13 @@ PetscErrorCode MatGetValues_SeqSELL(Mat A,PetscInt m,const PetscInt im[],PetscIn
       high = a->rlen[row]; low = 0; /* assume unsorted */
       while (high-low > 5) {
         t = (low+high)/2;
-        if (*(cp+t*8) > col) high = t;
+        if (*(cp+t*a->sliceheight) > col) high = t;
         else low = t;
       }
       for (i=low; i<high; i++) {
-        if (*(cp+8*i) > col) break;
-        if (*(cp+8*i) == col) {
-          *v++ = *(vp+8*i);
+        if (*(cp+a->sliceheight*i) > col) break;
+        if (*(cp+a->sliceheight*i) == col) {
+          *v++ = *(vp+a->sliceheight*i);
           goto finished;
         }
       }
@@ -1057,12 +798,12 @@ PetscErrorCode MatView_SeqSELL_ASCII(Mat A,PetscViewer viewer)
     ierr = PetscViewerASCIIPrintf(viewer,"zzz = [\n");CHKERRQ(ierr);
 
     for (i=0; i<m; i++) {
-      shift = a->sliidx[i>>3]+(i&0x07);
+      shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight;
       for (j=0; j<a->rlen[i]; j++) {
 #if defined(PETSC_USE_COMPLEX)
-        ierr = PetscViewerASCIIPrintf(viewer,"%D %D  %18.16e %18.16e\n",i+1,a->colidx[shift+8*j]+1,(double)PetscRealPart(a->val[shift+8*j]),(double)PetscImaginaryPart(a->val[shift+8*j]));CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPrintf(viewer,"%D %D  %18.16e %18.16e\n",i+1,a->colidx[shift+a->sliceheight*j]+1,(double)PetscRealPart(a->val[shift+a->sliceheight*j]),(double)PetscImaginaryPart(a->val[shift+a->sliceheight*j]));CHKERRQ(ierr);
 #else
-        ierr = PetscViewerASCIIPrintf(viewer,"%D %D  %18.16e\n",i+1,a->colidx[shift+8*j]+1,(double)a->val[shift+8*j]);CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPrintf(viewer,"%D %D  %18.16e\n",i+1,a->colidx[shift+a->sliceheight*j]+1,(double)a->val[shift+a->sliceheight*j]);CHKERRQ(ierr);
 #endif
       }
     }
@@ -1078,24 +819,27 @@ PetscErrorCode MatView_SeqSELL_ASCII(Mat A,PetscViewer viewer)
     ierr = PetscObjectGetName((PetscObject)A,&name);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(viewer,"];\n %s = spconvert(zzz);\n",name);CHKERRQ(ierr);
     ierr = PetscViewerASCIIUseTabs(viewer,PETSC_TRUE);CHKERRQ(ierr);
-  } else if (format == PETSC_VIEWER_ASCII_FACTOR_INFO || format == PETSC_VIEWER_ASCII_INFO) {
+  } else if (format == PETSC_VIEWER_ASCII_FACTOR_INFO) {
+    PetscFunctionReturn(0);
+  } else if (format == PETSC_VIEWER_ASCII_INFO) {
+    ierr = PetscViewerASCIIPrintf(viewer,"slice height %D, total slices %D\n",a->sliceheight,a->totalslices);CHKERRQ(ierr);
     PetscFunctionReturn(0);
   } else if (format == PETSC_VIEWER_ASCII_COMMON) {
     ierr = PetscViewerASCIIUseTabs(viewer,PETSC_FALSE);CHKERRQ(ierr);
     for (i=0; i<m; i++) {
       ierr = PetscViewerASCIIPrintf(viewer,"row %D:",i);CHKERRQ(ierr);
-      shift = a->sliidx[i>>3]+(i&0x07);
+      shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight;
       for (j=0; j<a->rlen[i]; j++) {
 #if defined(PETSC_USE_COMPLEX)
-        if (PetscImaginaryPart(a->val[shift+8*j]) > 0.0 && PetscRealPart(a->val[shift+8*j]) != 0.0) {
-          ierr = PetscViewerASCIIPrintf(viewer," (%D, %g + %g i)",a->colidx[shift+8*j],(double)PetscRealPart(a->val[shift+8*j]),(double)PetscImaginaryPart(a->val[shift+8*j]));CHKERRQ(ierr);
-        } else if (PetscImaginaryPart(a->val[shift+8*j]) < 0.0 && PetscRealPart(a->val[shift+8*j]) != 0.0) {
-          ierr = PetscViewerASCIIPrintf(viewer," (%D, %g - %g i)",a->colidx[shift+8*j],(double)PetscRealPart(a->val[shift+8*j]),(double)-PetscImaginaryPart(a->val[shift+8*j]));CHKERRQ(ierr);
-        } else if (PetscRealPart(a->val[shift+8*j]) != 0.0) {
-          ierr = PetscViewerASCIIPrintf(viewer," (%D, %g) ",a->colidx[shift+8*j],(double)PetscRealPart(a->val[shift+8*j]));CHKERRQ(ierr);
+        if (PetscImaginaryPart(a->val[shift+a->sliceheight*j]) > 0.0 && PetscRealPart(a->val[shift+a->sliceheight*j]) != 0.0) {
+          ierr = PetscViewerASCIIPrintf(viewer," (%D, %g + %g i)",a->colidx[shift+a->sliceheight*j],(double)PetscRealPart(a->val[shift+a->sliceheight*j]),(double)PetscImaginaryPart(a->val[shift+a->sliceheight*j]));CHKERRQ(ierr);
+        } else if (PetscImaginaryPart(a->val[shift+a->sliceheight*j]) < 0.0 && PetscRealPart(a->val[shift+a->sliceheight*j]) != 0.0) {
+          ierr = PetscViewerASCIIPrintf(viewer," (%D, %g - %g i)",a->colidx[shift+a->sliceheight*j],(double)PetscRealPart(a->val[shift+a->sliceheight*j]),(double)-PetscImaginaryPart(a->val[shift+a->sliceheight*j]));CHKERRQ(ierr);
+        } else if (PetscRealPart(a->val[shift+a->sliceheight*j]) != 0.0) {
+          ierr = PetscViewerASCIIPrintf(viewer," (%D, %g) ",a->colidx[shift+a->sliceheight*j],(double)PetscRealPart(a->val[shift+a->sliceheight*j]));CHKERRQ(ierr);
         }
 #else
-        if (a->val[shift+8*j] != 0.0) {ierr = PetscViewerASCIIPrintf(viewer," (%D, %g) ",a->colidx[shift+8*j],(double)a->val[shift+8*j]);CHKERRQ(ierr);}
+        if (a->val[shift+a->sliceheight*j] != 0.0) {ierr = PetscViewerASCIIPrintf(viewer," (%D, %g) ",a->colidx[shift+a->sliceheight*j],(double)a->val[shift+a->sliceheight*j]);CHKERRQ(ierr);}
 #endif
       }
       ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
@@ -1117,9 +861,9 @@ PetscErrorCode MatView_SeqSELL_ASCII(Mat A,PetscViewer viewer)
     ierr = PetscViewerASCIIUseTabs(viewer,PETSC_FALSE);CHKERRQ(ierr);
     for (i=0; i<m; i++) {
       jcnt = 0;
-      shift = a->sliidx[i>>3]+(i&0x07);
+      shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight;
       for (j=0; j<A->cmap->n; j++) {
-        if (jcnt < a->rlen[i] && j == a->colidx[shift+8*j]) {
+        if (jcnt < a->rlen[i] && j == a->colidx[shift+a->sliceheight*j]) {
           value = a->val[cnt++];
           jcnt++;
         } else {
@@ -1148,12 +892,12 @@ PetscErrorCode MatView_SeqSELL_ASCII(Mat A,PetscViewer viewer)
 #endif
     ierr = PetscViewerASCIIPrintf(viewer,"%D %D %D\n", m, A->cmap->n, a->nz);CHKERRQ(ierr);
     for (i=0; i<m; i++) {
-      shift = a->sliidx[i>>3]+(i&0x07);
+      shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight;
       for (j=0; j<a->rlen[i]; j++) {
 #if defined(PETSC_USE_COMPLEX)
-        ierr = PetscViewerASCIIPrintf(viewer,"%D %D %g %g\n",i+fshift,a->colidx[shift+8*j]+fshift,(double)PetscRealPart(a->val[shift+8*j]),(double)PetscImaginaryPart(a->val[shift+8*j]));CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPrintf(viewer,"%D %D %g %g\n",i+fshift,a->colidx[shift+a->sliceheight*j]+fshift,(double)PetscRealPart(a->val[shift+a->sliceheight*j]),(double)PetscImaginaryPart(a->val[shift+a->sliceheight*j]));CHKERRQ(ierr);
 #else
-        ierr = PetscViewerASCIIPrintf(viewer,"%D %D %g\n",i+fshift,a->colidx[shift+8*j]+fshift,(double)a->val[shift+8*j]);CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPrintf(viewer,"%D %D %g\n",i+fshift,a->colidx[shift+a->sliceheight*j]+fshift,(double)a->val[shift+a->sliceheight*j]);CHKERRQ(ierr);
 #endif
       }
     }
@@ -1162,17 +906,17 @@ PetscErrorCode MatView_SeqSELL_ASCII(Mat A,PetscViewer viewer)
     for (i=0; i<a->totalslices; i++) { /* loop over slices */
       PetscInt row;
       ierr = PetscViewerASCIIPrintf(viewer,"slice %D: %D %D\n",i,a->sliidx[i],a->sliidx[i+1]);CHKERRQ(ierr);
-      for (j=a->sliidx[i],row=0; j<a->sliidx[i+1]; j++,row=((row+1)&0x07)) {
+      for (j=a->sliidx[i],row=0; j<a->sliidx[i+1]; j++,row=((row+1)%a->sliceheight)) {
 #if defined(PETSC_USE_COMPLEX)
         if (PetscImaginaryPart(a->val[j]) > 0.0) {
-          ierr = PetscViewerASCIIPrintf(viewer,"  %D %D %g + %g i\n",8*i+row,a->colidx[j],(double)PetscRealPart(a->val[j]),(double)PetscImaginaryPart(a->val[j]));CHKERRQ(ierr);
+          ierr = PetscViewerASCIIPrintf(viewer,"  %D %D %g + %g i\n",a->sliceheight*i+row,a->colidx[j],(double)PetscRealPart(a->val[j]),(double)PetscImaginaryPart(a->val[j]));CHKERRQ(ierr);
         } else if (PetscImaginaryPart(a->val[j]) < 0.0) {
-          ierr = PetscViewerASCIIPrintf(viewer,"  %D %D %g - %g i\n",8*i+row,a->colidx[j],(double)PetscRealPart(a->val[j]),-(double)PetscImaginaryPart(a->val[j]));CHKERRQ(ierr);
+          ierr = PetscViewerASCIIPrintf(viewer,"  %D %D %g - %g i\n",a->sliceheight*i+row,a->colidx[j],(double)PetscRealPart(a->val[j]),-(double)PetscImaginaryPart(a->val[j]));CHKERRQ(ierr);
         } else {
-          ierr = PetscViewerASCIIPrintf(viewer,"  %D %D %g\n",8*i+row,a->colidx[j],(double)PetscRealPart(a->val[j]));CHKERRQ(ierr);
+          ierr = PetscViewerASCIIPrintf(viewer,"  %D %D %g\n",a->sliceheight*i+row,a->colidx[j],(double)PetscRealPart(a->val[j]));CHKERRQ(ierr);
         }
 #else
-        ierr = PetscViewerASCIIPrintf(viewer,"  %D %D %g\n",8*i+row,a->colidx[j],(double)a->val[j]);CHKERRQ(ierr);
+        ierr = PetscViewerASCIIPrintf(viewer,"  %D %D %g\n",a->sliceheight*i+row,a->colidx[j],(double)a->val[j]);CHKERRQ(ierr);
 #endif
       }
     }
@@ -1180,14 +924,14 @@ PetscErrorCode MatView_SeqSELL_ASCII(Mat A,PetscViewer viewer)
     ierr = PetscViewerASCIIUseTabs(viewer,PETSC_FALSE);CHKERRQ(ierr);
     if (A->factortype) {
       for (i=0; i<m; i++) {
-        shift = a->sliidx[i>>3]+(i&0x07);
+        shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight;
         ierr = PetscViewerASCIIPrintf(viewer,"row %D:",i);CHKERRQ(ierr);
         /* L part */
-        for (j=shift; j<a->diag[i]; j+=8) {
+        for (j=shift; j<a->diag[i]; j+=a->sliceheight) {
 #if defined(PETSC_USE_COMPLEX)
-          if (PetscImaginaryPart(a->val[shift+8*j]) > 0.0) {
+          if (PetscImaginaryPart(a->val[shift+a->sliceheight*j]) > 0.0) {
             ierr = PetscViewerASCIIPrintf(viewer," (%D, %g + %g i)",a->colidx[j],(double)PetscRealPart(a->val[j]),(double)PetscImaginaryPart(a->val[j]));CHKERRQ(ierr);
-          } else if (PetscImaginaryPart(a->val[shift+8*j]) < 0.0) {
+          } else if (PetscImaginaryPart(a->val[shift+a->sliceheight*j]) < 0.0) {
             ierr = PetscViewerASCIIPrintf(viewer," (%D, %g - %g i)",a->colidx[j],(double)PetscRealPart(a->val[j]),(double)(-PetscImaginaryPart(a->val[j])));CHKERRQ(ierr);
           } else {
             ierr = PetscViewerASCIIPrintf(viewer," (%D, %g) ",a->colidx[j],(double)PetscRealPart(a->val[j]));CHKERRQ(ierr);
@@ -1211,7 +955,7 @@ PetscErrorCode MatView_SeqSELL_ASCII(Mat A,PetscViewer viewer)
 #endif
 
         /* U part */
-        for (j=a->diag[i]+1; j<shift+8*a->rlen[i]; j+=8) {
+        for (j=a->diag[i]+1; j<shift+a->sliceheight*a->rlen[i]; j+=a->sliceheight) {
 #if defined(PETSC_USE_COMPLEX)
           if (PetscImaginaryPart(a->val[j]) > 0.0) {
             ierr = PetscViewerASCIIPrintf(viewer," (%D, %g + %g i)",a->colidx[j],(double)PetscRealPart(a->val[j]),(double)PetscImaginaryPart(a->val[j]));CHKERRQ(ierr);
@@ -1228,19 +972,19 @@ PetscErrorCode MatView_SeqSELL_ASCII(Mat A,PetscViewer viewer)
       }
     } else {
       for (i=0; i<m; i++) {
-        shift = a->sliidx[i>>3]+(i&0x07);
+        shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight;
         ierr = PetscViewerASCIIPrintf(viewer,"row %D:",i);CHKERRQ(ierr);
         for (j=0; j<a->rlen[i]; j++) {
 #if defined(PETSC_USE_COMPLEX)
           if (PetscImaginaryPart(a->val[j]) > 0.0) {
-            ierr = PetscViewerASCIIPrintf(viewer," (%D, %g + %g i)",a->colidx[shift+8*j],(double)PetscRealPart(a->val[shift+8*j]),(double)PetscImaginaryPart(a->val[shift+8*j]));CHKERRQ(ierr);
+            ierr = PetscViewerASCIIPrintf(viewer," (%D, %g + %g i)",a->colidx[shift+a->sliceheight*j],(double)PetscRealPart(a->val[shift+a->sliceheight*j]),(double)PetscImaginaryPart(a->val[shift+a->sliceheight*j]));CHKERRQ(ierr);
           } else if (PetscImaginaryPart(a->val[j]) < 0.0) {
-            ierr = PetscViewerASCIIPrintf(viewer," (%D, %g - %g i)",a->colidx[shift+8*j],(double)PetscRealPart(a->val[shift+8*j]),(double)-PetscImaginaryPart(a->val[shift+8*j]));CHKERRQ(ierr);
+            ierr = PetscViewerASCIIPrintf(viewer," (%D, %g - %g i)",a->colidx[shift+a->sliceheight*j],(double)PetscRealPart(a->val[shift+a->sliceheight*j]),(double)-PetscImaginaryPart(a->val[shift+a->sliceheight*j]));CHKERRQ(ierr);
           } else {
-            ierr = PetscViewerASCIIPrintf(viewer," (%D, %g) ",a->colidx[shift+8*j],(double)PetscRealPart(a->val[shift+8*j]));CHKERRQ(ierr);
+            ierr = PetscViewerASCIIPrintf(viewer," (%D, %g) ",a->colidx[shift+a->sliceheight*j],(double)PetscRealPart(a->val[shift+a->sliceheight*j]));CHKERRQ(ierr);
           }
 #else
-          ierr = PetscViewerASCIIPrintf(viewer," (%D, %g) ",a->colidx[shift+8*j],(double)a->val[shift+8*j]);CHKERRQ(ierr);
+          ierr = PetscViewerASCIIPrintf(viewer," (%D, %g) ",a->colidx[shift+a->sliceheight*j],(double)a->val[shift+a->sliceheight*j]);CHKERRQ(ierr);
 #endif
         }
         ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
@@ -1276,31 +1020,31 @@ PetscErrorCode MatView_SeqSELL_Draw_Zoom(PetscDraw draw,void *Aa)
     /* Blue for negative, Cyan for zero and  Red for positive */
     color = PETSC_DRAW_BLUE;
     for (i=0; i<m; i++) {
-      shift = a->sliidx[i>>3]+(i&0x07); /* starting index of the row i */
+      shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight; /* starting index of the row i */
       y_l = m - i - 1.0; y_r = y_l + 1.0;
       for (j=0; j<a->rlen[i]; j++) {
-        x_l = a->colidx[shift+j*8]; x_r = x_l + 1.0;
-        if (PetscRealPart(a->val[shift+8*j]) >=  0.) continue;
+        x_l = a->colidx[shift+j*a->sliceheight]; x_r = x_l + 1.0;
+        if (PetscRealPart(a->val[shift+a->sliceheight*j]) >=  0.) continue;
         ierr = PetscDrawRectangle(draw,x_l,y_l,x_r,y_r,color,color,color,color);CHKERRQ(ierr);
       }
     }
     color = PETSC_DRAW_CYAN;
     for (i=0; i<m; i++) {
-      shift = a->sliidx[i>>3]+(i&0x07);
+      shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight;
       y_l = m - i - 1.0; y_r = y_l + 1.0;
       for (j=0; j<a->rlen[i]; j++) {
-        x_l = a->colidx[shift+j*8]; x_r = x_l + 1.0;
-        if (a->val[shift+8*j] !=  0.) continue;
+        x_l = a->colidx[shift+j*a->sliceheight]; x_r = x_l + 1.0;
+        if (a->val[shift+a->sliceheight*j] !=  0.) continue;
         ierr = PetscDrawRectangle(draw,x_l,y_l,x_r,y_r,color,color,color,color);CHKERRQ(ierr);
       }
     }
     color = PETSC_DRAW_RED;
     for (i=0; i<m; i++) {
-      shift = a->sliidx[i>>3]+(i&0x07);
+      shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight;
       y_l = m - i - 1.0; y_r = y_l + 1.0;
       for (j=0; j<a->rlen[i]; j++) {
-        x_l = a->colidx[shift+j*8]; x_r = x_l + 1.0;
-        if (PetscRealPart(a->val[shift+8*j]) <=  0.) continue;
+        x_l = a->colidx[shift+j*a->sliceheight]; x_r = x_l + 1.0;
+        if (PetscRealPart(a->val[shift+a->sliceheight*j]) <=  0.) continue;
         ierr = PetscDrawRectangle(draw,x_l,y_l,x_r,y_r,color,color,color,color);CHKERRQ(ierr);
       }
     }
@@ -1320,11 +1064,11 @@ PetscErrorCode MatView_SeqSELL_Draw_Zoom(PetscDraw draw,void *Aa)
 
     ierr = PetscDrawCollectiveBegin(draw);CHKERRQ(ierr);
     for (i=0; i<m; i++) {
-      shift = a->sliidx[i>>3]+(i&0x07);
+      shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight;
       y_l = m - i - 1.0;
       y_r = y_l + 1.0;
       for (j=0; j<a->rlen[i]; j++) {
-        x_l = a->colidx[shift+j*8];
+        x_l = a->colidx[shift+j*a->sliceheight];
         x_r = x_l + 1.0;
         color = PetscDrawRealToColor(PetscAbsScalar(a->val[count]),minv,maxv);
         ierr = PetscDrawRectangle(draw,x_l,y_l,x_r,y_r,color,color,color,color);CHKERRQ(ierr);
@@ -1397,8 +1141,8 @@ PetscErrorCode MatAssemblyEnd_SeqSELL(Mat A,MatAssemblyType mode)
     shift = a->sliidx[i];    /* starting index of the slice */
     cp    = a->colidx+shift; /* pointer to the column indices of the slice */
     vp    = a->val+shift;    /* pointer to the nonzero values of the slice */
-    for (row_in_slice=0; row_in_slice<8; ++row_in_slice) { /* loop over rows in the slice */
-      row  = 8*i + row_in_slice;
+    for (row_in_slice=0; row_in_slice<a->sliceheight; ++row_in_slice) { /* loop over rows in the slice */
+      row  = a->sliceheight*i + row_in_slice;
       nrow = a->rlen[row]; /* number of nonzeros in row */
       /*
         Search for the nearest nonzero. Normally setting the index to zero may cause extra communication.
@@ -1406,10 +1150,10 @@ PetscErrorCode MatAssemblyEnd_SeqSELL(Mat A,MatAssemblyType mode)
       */
       lastcol = 0;
       if (nrow>0) { /* nonempty row */
-        lastcol = cp[8*(nrow-1)+row_in_slice]; /* use the index from the last nonzero at current row */
+        lastcol = cp[a->sliceheight*(nrow-1)+row_in_slice]; /* use the index from the last nonzero at current row */
       } else if (!row_in_slice) { /* first row of the currect slice is empty */
-        for (j=1;j<8;j++) {
-          if (a->rlen[8*i+j]) {
+        for (j=1;j<a->sliceheight;j++) {
+          if (a->rlen[a->sliceheight*i+j]) {
             lastcol = cp[j];
             break;
           }
@@ -1418,9 +1162,9 @@ PetscErrorCode MatAssemblyEnd_SeqSELL(Mat A,MatAssemblyType mode)
         if (a->sliidx[i+1] != shift) lastcol = cp[row_in_slice-1]; /* use the index from the previous row */
       }
 
-      for (k=nrow; k<(a->sliidx[i+1]-shift)/8; ++k) {
-        cp[8*k+row_in_slice] = lastcol;
-        vp[8*k+row_in_slice] = (MatScalar)0;
+      for (k=nrow; k<(a->sliidx[i+1]-shift)/a->sliceheight; ++k) {
+        cp[a->sliceheight*k+row_in_slice] = lastcol;
+        vp[a->sliceheight*k+row_in_slice] = (MatScalar)0;
       }
     }
   }
@@ -1471,7 +1215,7 @@ PetscErrorCode MatSetValues_SeqSELL(Mat A,PetscInt m,const PetscInt im[],PetscIn
 #if defined(PETSC_USE_DEBUG)
     if (row >= A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",row,A->rmap->n-1);
 #endif
-    shift = a->sliidx[row>>3]+(row&0x07); /* starting index of the row */
+    shift = a->sliidx[row/a->sliceheight]+row%a->sliceheight; /* starting index of the row */
     cp    = a->colidx+shift; /* pointer to the row */
     vp    = a->val+shift; /* pointer to the row */
     nrow  = a->rlen[row];
@@ -1497,14 +1241,14 @@ PetscErrorCode MatSetValues_SeqSELL(Mat A,PetscInt m,const PetscInt im[],PetscIn
       lastcol = col;
       while (high-low > 5) {
         t = (low+high)/2;
-        if (*(cp+t*8) > col) high = t;
+        if (*(cp+t*a->sliceheight) > col) high = t;
         else low = t;
       }
       for (i=low; i<high; i++) {
-        if (*(cp+i*8) > col) break;
-        if (*(cp+i*8) == col) {
-          if (is == ADD_VALUES) *(vp+i*8) += value;
-          else *(vp+i*8) = value;
+        if (*(cp+i*a->sliceheight) > col) break;
+        if (*(cp+i*a->sliceheight) == col) {
+          if (is == ADD_VALUES) *(vp+i*a->sliceheight) += value;
+          else *(vp+i*a->sliceheight) = value;
           low = i + 1;
           goto noinsert;
         }
@@ -1513,15 +1257,15 @@ PetscErrorCode MatSetValues_SeqSELL(Mat A,PetscInt m,const PetscInt im[],PetscIn
       if (nonew == 1) goto noinsert;
       if (nonew == -1) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Inserting a new nonzero (%D, %D) in the matrix", row, col);
       /* If the current row length exceeds the slice width (e.g. nrow==slice_width), allocate a new space, otherwise do nothing */
-      MatSeqXSELLReallocateSELL(A,A->rmap->n,1,nrow,a->sliidx,row/8,row,col,a->colidx,a->val,cp,vp,nonew,MatScalar);
+      MatSeqXSELLReallocateSELL(A,A->rmap->n,1,nrow,a->sliidx,a->sliceheight,row/a->sliceheight,row,col,a->colidx,a->val,cp,vp,nonew,MatScalar);
       /* add the new nonzero to the high position, shift the remaining elements in current row to the right by one slot */
       for (ii=nrow-1; ii>=i; ii--) {
-        *(cp+(ii+1)*8) = *(cp+ii*8);
-        *(vp+(ii+1)*8) = *(vp+ii*8);
+        *(cp+(ii+1)*a->sliceheight) = *(cp+ii*a->sliceheight);
+        *(vp+(ii+1)*a->sliceheight) = *(vp+ii*a->sliceheight);
       }
       a->rlen[row]++;
-      *(cp+i*8) = col;
-      *(vp+i*8) = value;
+      *(cp+i*a->sliceheight) = col;
+      *(vp+i*a->sliceheight) = value;
       a->nz++;
       A->nonzerostate++;
       low = i+1; high++; nrow++;
@@ -1660,10 +1404,10 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
   if (flag & SOR_ZERO_INITIAL_GUESS) {
     if ((flag & SOR_FORWARD_SWEEP) || (flag & SOR_LOCAL_FORWARD_SWEEP)) {
       for (i=0; i<m; i++) {
-        shift = a->sliidx[i>>3]+(i&0x07); /* starting index of the row i */
+        shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight; /* starting index of the row i */
         sum   = b[i];
-        n     = (diag[i]-shift)/8;
-        for (j=0; j<n; j++) sum -= a->val[shift+j*8]*x[a->colidx[shift+j*8]];
+        n     = (diag[i]-shift)/a->sliceheight;
+        for (j=0; j<n; j++) sum -= a->val[shift+j*a->sliceheight]*x[a->colidx[shift+j*a->sliceheight]];
         t[i]  = sum;
         x[i]  = sum*idiag[i];
       }
@@ -1672,10 +1416,10 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
     } else xb = b;
     if ((flag & SOR_BACKWARD_SWEEP) || (flag & SOR_LOCAL_BACKWARD_SWEEP)) {
       for (i=m-1; i>=0; i--) {
-        shift = a->sliidx[i>>3]+(i&0x07); /* starting index of the row i */
+        shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight; /* starting index of the row i */
         sum   = xb[i];
-        n     = a->rlen[i]-(diag[i]-shift)/8-1;
-        for (j=1; j<=n; j++) sum -= a->val[diag[i]+j*8]*x[a->colidx[diag[i]+j*8]];
+        n     = a->rlen[i]-(diag[i]-shift)/a->sliceheight-1;
+        for (j=1; j<=n; j++) sum -= a->val[diag[i]+j*a->sliceheight]*x[a->colidx[diag[i]+j*a->sliceheight]];
         if (xb == b) {
           x[i] = sum*idiag[i];
         } else {
@@ -1690,14 +1434,14 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
     if ((flag & SOR_FORWARD_SWEEP) || (flag & SOR_LOCAL_FORWARD_SWEEP)) {
       for (i=0; i<m; i++) {
         /* lower */
-        shift = a->sliidx[i>>3]+(i&0x07); /* starting index of the row i */
+        shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight; /* starting index of the row i */
         sum   = b[i];
-        n     = (diag[i]-shift)/8;
-        for (j=0; j<n; j++) sum -= a->val[shift+j*8]*x[a->colidx[shift+j*8]];
+        n     = (diag[i]-shift)/a->sliceheight;
+        for (j=0; j<n; j++) sum -= a->val[shift+j*a->sliceheight]*x[a->colidx[shift+j*a->sliceheight]];
         t[i]  = sum;             /* save application of the lower-triangular part */
         /* upper */
-        n     = a->rlen[i]-(diag[i]-shift)/8-1;
-        for (j=1; j<=n; j++) sum -= a->val[diag[i]+j*8]*x[a->colidx[diag[i]+j*8]];
+        n     = a->rlen[i]-(diag[i]-shift)/a->sliceheight-1;
+        for (j=1; j<=n; j++) sum -= a->val[diag[i]+j*a->sliceheight]*x[a->colidx[diag[i]+j*a->sliceheight]];
         x[i]  = (1.-omega)*x[i]+sum*idiag[i];  /* omega in idiag */
       }
       xb   = t;
@@ -1705,16 +1449,16 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
     } else xb = b;
     if ((flag & SOR_BACKWARD_SWEEP) || (flag & SOR_LOCAL_BACKWARD_SWEEP)) {
       for (i=m-1; i>=0; i--) {
-        shift = a->sliidx[i>>3]+(i&0x07); /* starting index of the row i */
+        shift = a->sliidx[i/a->sliceheight]+i%a->sliceheight; /* starting index of the row i */
         sum = xb[i];
         if (xb == b) {
           /* whole matrix (no checkpointing available) */
           n     = a->rlen[i];
-          for (j=0; j<n; j++) sum -= a->val[shift+j*8]*x[a->colidx[shift+j*8]];
+          for (j=0; j<n; j++) sum -= a->val[shift+j*a->sliceheight]*x[a->colidx[shift+j*a->sliceheight]];
           x[i] = (1.-omega)*x[i]+(sum+mdiag[i]*x[i])*idiag[i];
         } else { /* lower-triangular part has been saved, so only apply upper-triangular */
-          n     = a->rlen[i]-(diag[i]-shift)/8-1;
-          for (j=1; j<=n; j++) sum -= a->val[diag[i]+j*8]*x[a->colidx[diag[i]+j*8]];
+          n     = a->rlen[i]-(diag[i]-shift)/a->sliceheight-1;
+          for (j=1; j<=n; j++) sum -= a->val[diag[i]+j*a->sliceheight]*x[a->colidx[diag[i]+j*a->sliceheight]];
           x[i]  = (1.-omega)*x[i]+sum*idiag[i];  /* omega in idiag */
         }
       }
@@ -1932,6 +1676,26 @@ PetscErrorCode MatSeqSELLRestoreArray(Mat A,PetscScalar **array)
   PetscFunctionReturn(0);
 }
 
+/*
+   Chooses the MatMult() kernels from the instruction sets supported by the CPU we are running on; the vector kernels
+   process a slice in groups of 8 (AVX-512) or 4 (AVX2) rows so the slice height must be a multiple of that.
+*/
+static PetscErrorCode MatSeqSELLSelectKernel_Private(Mat A)
+{
+  Mat_SeqSELL    *a = (Mat_SeqSELL*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  a->kernel = MATSEQSELL_KERNEL_SCALAR;
+#if defined(MATSEQSELL_AVX_KERNELS)
+  __builtin_cpu_init();
+  if (!(a->sliceheight % 8) && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd")) a->kernel = MATSEQSELL_KERNEL_AVX512;
+  else if (!(a->sliceheight % 4) && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) a->kernel = MATSEQSELL_KERNEL_AVX2;
+#endif
+  ierr = PetscInfo2(A,"Slice height %D, using %s MatMult() kernels\n",a->sliceheight,a->kernel == MATSEQSELL_KERNEL_AVX512 ? "AVX-512" : (a->kernel == MATSEQSELL_KERNEL_AVX2 ? "AVX2" : "scalar"));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PETSC_EXTERN PetscErrorCode MatCreate_SeqSELL(Mat B)
 {
   Mat_SeqSELL    *b;
@@ -1966,6 +1730,13 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqSELL(Mat B)
   b->fshift             = 0.0;
   b->idiagvalid         = PETSC_FALSE;
   b->keepnonzeropattern = PETSC_FALSE;
+  b->sliceheight        = 8;
+
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"Options for SEQSELL matrix","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_sell_slice_height","Number of rows stored together in a slice","None",b->sliceheight,&b->sliceheight,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (b->sliceheight < 1) SETERRQ1(PetscObjectComm((PetscObject)B),PETSC_ERR_ARG_OUTOFRANGE,"Slice height %D must be positive",b->sliceheight);
+  ierr = MatSeqSELLSelectKernel_Private(B);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQSELL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqSELLGetArray_C",MatSeqSELLGetArray_SeqSELL);CHKERRQ(ierr);
@@ -2001,7 +1772,10 @@ PetscErrorCode MatDuplicateNoCreate_SeqSELL(Mat C,Mat A,MatDuplicateOption cpval
   ierr = PetscLayoutReference(A->rmap,&C->rmap);CHKERRQ(ierr);
   ierr = PetscLayoutReference(A->cmap,&C->cmap);CHKERRQ(ierr);
 
-  ierr = PetscMalloc1(8*totalslices,&c->rlen);CHKERRQ(ierr);
+  c->sliceheight = a->sliceheight;
+  c->totalslices = a->totalslices;
+  ierr = MatSeqSELLSelectKernel_Private(C);CHKERRQ(ierr);
+  ierr = PetscMalloc1(c->sliceheight*totalslices,&c->rlen);CHKERRQ(ierr);
   ierr = PetscLogObjectMemory((PetscObject)C,m*sizeof(PetscInt));CHKERRQ(ierr);
   ierr = PetscMalloc1(totalslices+1,&c->sliidx);CHKERRQ(ierr);
   ierr = PetscLogObjectMemory((PetscObject)C, (totalslices+1)*sizeof(PetscInt));CHKERRQ(ierr);
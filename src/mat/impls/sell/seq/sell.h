@@ -5,6 +5,15 @@
 #include <petsc/private/matimpl.h>
 #include <petscctable.h>
 
+/*
+ The SIMD kernels in sellavx.c are compiled with function target attributes and selected at runtime
+*/
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(PETSC_HAVE_ATTRIBUTE_TARGET) && defined(PETSC_HAVE_BUILTIN_CPU_SUPPORTS) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+#define MATSEQSELL_AVX_KERNELS
+#endif
+
+typedef enum {MATSEQSELL_KERNEL_SCALAR,MATSEQSELL_KERNEL_AVX2,MATSEQSELL_KERNEL_AVX512} MatSeqSELLKernelType;
+
 /*
  Struct header for SeqSELL matrix format
 */
@@ -37,6 +46,7 @@ Mat         parent;            /* set if this matrix was formed with MatDuplicat
 means that this shares some data structures with the parent including diag, ilen, imax, i, j */ \
 PetscInt    *sliidx;           /* slice index */ \
 PetscInt    totalslices;       /* total number of slices */ \
+PetscInt    sliceheight;       /* number of rows in a slice */ \
 PetscInt    *getrowcols;       /* workarray for MatGetRow_SeqSELL */ \
 PetscScalar *getrowvals        /* workarray for MatGetRow_SeqSELL */ \
 
@@ -47,6 +57,7 @@ typedef struct {
   PetscBool   idiagvalid;                /* current idiag[] and mdiag[] are valid */
   PetscScalar fshift,omega;              /* last used omega and fshift */
   ISColoring  coloring;                  /* set with MatADSetColoring() used by MatADSetValues() */
+  MatSeqSELLKernelType kernel;           /* kernel used by MatMult() and MatMultTranspose(), chosen at runtime */
 } Mat_SeqSELL;
 
 /*
@@ -65,11 +76,11 @@ PETSC_STATIC_INLINE PetscErrorCode MatSeqXSELLFreeSELL(Mat AA,MatScalar **val,Pe
   return 0;
 }
 
-#define MatSeqXSELLReallocateSELL(Amat,AM,BS2,WIDTH,SIDX,SID,ROW,COL,COLIDX,VAL,CP,VP,NONEW,datatype) \
-if (WIDTH >= (SIDX[SID+1]-SIDX[SID])/8) { \
+#define MatSeqXSELLReallocateSELL(Amat,AM,BS2,WIDTH,SIDX,SH,SID,ROW,COL,COLIDX,VAL,CP,VP,NONEW,datatype) \
+if (WIDTH >= (SIDX[SID+1]-SIDX[SID])/SH) { \
 Mat_SeqSELL *Ain = (Mat_SeqSELL*)Amat->data; \
-/* there is no extra room in row, therefore enlarge 8 elements (1 slice column) */ \
-PetscInt new_size=Ain->maxallocmat+8,*new_colidx; \
+/* there is no extra room in row, therefore enlarge SH elements (1 slice column) */ \
+PetscInt new_size=Ain->maxallocmat+SH,*new_colidx; \
 datatype *new_val; \
 \
 if (NONEW == -2) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"New nonzero at (%D,%D) caused a malloc\nUse MatSetOption(A, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE) to turn off this check",ROW,COL); \
@@ -79,13 +90,13 @@ ierr = PetscMalloc2(BS2*new_size,&new_val,BS2*new_size,&new_colidx);CHKERRQ(ierr
 /* copy over old data into new slots by two steps: one step for data before the current slice and the other for the rest */ \
 ierr = PetscMemcpy(new_val,VAL,SIDX[SID+1]*sizeof(datatype));CHKERRQ(ierr); \
 ierr = PetscMemcpy(new_colidx,COLIDX,SIDX[SID+1]*sizeof(PetscInt));CHKERRQ(ierr); \
-ierr = PetscMemcpy(new_val+SIDX[SID+1]+8,VAL+SIDX[SID+1],(SIDX[AM>>3]-SIDX[SID+1])*sizeof(datatype));CHKERRQ(ierr); \
-ierr = PetscMemcpy(new_colidx+SIDX[SID+1]+8,COLIDX+SIDX[SID+1],(SIDX[AM>>3]-SIDX[SID+1])*sizeof(PetscInt));CHKERRQ(ierr); \
+ierr = PetscMemcpy(new_val+SIDX[SID+1]+SH,VAL+SIDX[SID+1],(SIDX[Ain->totalslices]-SIDX[SID+1])*sizeof(datatype));CHKERRQ(ierr); \
+ierr = PetscMemcpy(new_colidx+SIDX[SID+1]+SH,COLIDX+SIDX[SID+1],(SIDX[Ain->totalslices]-SIDX[SID+1])*sizeof(PetscInt));CHKERRQ(ierr); \
 /* update slice_idx */ \
-for (ii=SID+1;ii<=AM>>3;ii++) { SIDX[ii] += 8; } \
+for (ii=SID+1;ii<=Ain->totalslices;ii++) { SIDX[ii] += SH; } \
 /* update pointers. Notice that they point to the FIRST postion of the row */ \
-CP = new_colidx+SIDX[SID]+(ROW & 0x07); \
-VP = new_val+SIDX[SID]+(ROW & 0x07); \
+CP = new_colidx+SIDX[SID]+(ROW % SH); \
+VP = new_val+SIDX[SID]+(ROW % SH); \
 /* free up old matrix storage */ \
 ierr              = MatSeqXSELLFreeSELL(A,&Ain->val,&Ain->colidx);CHKERRQ(ierr); \
 Ain->val          = (MatScalar*) new_val; \
@@ -106,37 +117,37 @@ if (WIDTH>=Ain->rlenmax) Ain->rlenmax++; \
   lastcol = col; \
   while (high-low > 5) { \
     t = (low+high)/2; \
-    if (*(cp+8*t) > col) high = t; \
+    if (*(cp+a->sliceheight*t) > col) high = t; \
     else low = t; \
   } \
   for (_i=low; _i<high; _i++) { \
-    if (*(cp+8*_i) > col) break; \
-    if (*(cp+8*_i) == col) { \
-      if (addv == ADD_VALUES)*(vp+8*_i) += value; \
-      else *(vp+8*_i) = value; \
+    if (*(cp+a->sliceheight*_i) > col) break; \
+    if (*(cp+a->sliceheight*_i) == col) { \
+      if (addv == ADD_VALUES)*(vp+a->sliceheight*_i) += value; \
+      else *(vp+a->sliceheight*_i) = value; \
       found = PETSC_TRUE; \
       break; \
     } \
   } \
   if (!found) { \
     if (a->nonew == -1) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Inserting a new nonzero at global row/column (%D, %D) into matrix", orow, ocol); \
-    if (a->nonew != 1 && !(value == 0.0 && a->ignorezeroentries) && a->rlen[row] >= (a->sliidx[row/8+1]-a->sliidx[row/8])/8) { \
-      /* there is no extra room in row, therefore enlarge 8 elements (1 slice column) */ \
-      if (a->maxallocmat < a->sliidx[a->totalslices]+8) { \
+    if (a->nonew != 1 && !(value == 0.0 && a->ignorezeroentries) && a->rlen[row] >= (a->sliidx[row/a->sliceheight+1]-a->sliidx[row/a->sliceheight])/a->sliceheight) { \
+      /* there is no extra room in row, therefore enlarge sliceheight elements (1 slice column) */ \
+      if (a->maxallocmat < a->sliidx[a->totalslices]+a->sliceheight) { \
         /* allocates a larger array for the XSELL matrix types; only extend the current slice by one more column. */ \
-        PetscInt  new_size=a->maxallocmat+8,*new_colidx; \
+        PetscInt  new_size=a->maxallocmat+a->sliceheight,*new_colidx; \
         MatScalar *new_val; \
         if (a->nonew == -2) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"New nonzero at (%D,%D) caused a malloc\nUse MatSetOption(A, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE) to turn off this check",orow,ocol); \
         /* malloc new storage space */ \
         ierr = PetscMalloc2(new_size,&new_val,new_size,&new_colidx);CHKERRQ(ierr); \
         /* copy over old data into new slots by two steps: one step for data before the current slice and the other for the rest */ \
-        ierr = PetscMemcpy(new_val,a->val,a->sliidx[row/8+1]*sizeof(MatScalar));CHKERRQ(ierr); \
-        ierr = PetscMemcpy(new_colidx,a->colidx,a->sliidx[row/8+1]*sizeof(PetscInt));CHKERRQ(ierr); \
-        ierr = PetscMemcpy(new_val+a->sliidx[row/8+1]+8,a->val+a->sliidx[row/8+1],(a->sliidx[a->totalslices]-a->sliidx[row/8+1])*sizeof(MatScalar));CHKERRQ(ierr);  \
-        ierr = PetscMemcpy(new_colidx+a->sliidx[row/8+1]+8,a->colidx+a->sliidx[row/8+1],(a->sliidx[a->totalslices]-a->sliidx[row/8+1])*sizeof(PetscInt));CHKERRQ(ierr); \
+        ierr = PetscMemcpy(new_val,a->val,a->sliidx[row/a->sliceheight+1]*sizeof(MatScalar));CHKERRQ(ierr); \
+        ierr = PetscMemcpy(new_colidx,a->colidx,a->sliidx[row/a->sliceheight+1]*sizeof(PetscInt));CHKERRQ(ierr); \
+        ierr = PetscMemcpy(new_val+a->sliidx[row/a->sliceheight+1]+a->sliceheight,a->val+a->sliidx[row/a->sliceheight+1],(a->sliidx[a->totalslices]-a->sliidx[row/a->sliceheight+1])*sizeof(MatScalar));CHKERRQ(ierr);  \
+        ierr = PetscMemcpy(new_colidx+a->sliidx[row/a->sliceheight+1]+a->sliceheight,a->colidx+a->sliidx[row/a->sliceheight+1],(a->sliidx[a->totalslices]-a->sliidx[row/a->sliceheight+1])*sizeof(PetscInt));CHKERRQ(ierr); \
         /* update pointers. Notice that they point to the FIRST postion of the row */ \
-        cp = new_colidx+a->sliidx[row/8]+(row & 0x07); \
-        vp = new_val+a->sliidx[row/8]+(row & 0x07); \
+        cp = new_colidx+a->sliidx[row/a->sliceheight]+(row % a->sliceheight); \
+        vp = new_val+a->sliidx[row/a->sliceheight]+(row % a->sliceheight); \
         /* free up old matrix storage */ \
         ierr            = MatSeqXSELLFreeSELL(A,&a->val,&a->colidx);CHKERRQ(ierr); \
         a->val          = (MatScalar*)new_val; \
@@ -146,21 +157,21 @@ if (WIDTH>=Ain->rlenmax) Ain->rlenmax++; \
         a->reallocs++; \
       } else { \
         /* no need to reallocate, just shift the following slices to create space for the added slice column */ \
-        ierr = PetscMemmove(a->val+a->sliidx[row/8+1]+8,a->val+a->sliidx[row/8+1],(a->sliidx[a->totalslices]-a->sliidx[row/8+1])*sizeof(MatScalar));CHKERRQ(ierr);  \
-        ierr = PetscMemmove(a->colidx+a->sliidx[row/8+1]+8,a->colidx+a->sliidx[row/8+1],(a->sliidx[a->totalslices]-a->sliidx[row/8+1])*sizeof(PetscInt));CHKERRQ(ierr); \
+        ierr = PetscMemmove(a->val+a->sliidx[row/a->sliceheight+1]+a->sliceheight,a->val+a->sliidx[row/a->sliceheight+1],(a->sliidx[a->totalslices]-a->sliidx[row/a->sliceheight+1])*sizeof(MatScalar));CHKERRQ(ierr);  \
+        ierr = PetscMemmove(a->colidx+a->sliidx[row/a->sliceheight+1]+a->sliceheight,a->colidx+a->sliidx[row/a->sliceheight+1],(a->sliidx[a->totalslices]-a->sliidx[row/a->sliceheight+1])*sizeof(PetscInt));CHKERRQ(ierr); \
       } \
       /* update slice_idx */ \
-      for (ii=row/8+1;ii<=a->totalslices;ii++) a->sliidx[ii] += 8; \
+      for (ii=row/a->sliceheight+1;ii<=a->totalslices;ii++) a->sliidx[ii] += a->sliceheight; \
       if (a->rlen[row]>=a->maxallocrow) a->maxallocrow++; \
       if (a->rlen[row]>=a->rlenmax) a->rlenmax++; \
     } \
     /* shift up all the later entries in this row */ \
     for (ii=a->rlen[row]-1; ii>=_i; ii--) { \
-      *(cp+8*(ii+1)) = *(cp+8*ii); \
-      *(vp+8*(ii+1)) = *(vp+8*ii); \
+      *(cp+a->sliceheight*(ii+1)) = *(cp+a->sliceheight*ii); \
+      *(vp+a->sliceheight*(ii+1)) = *(vp+a->sliceheight*ii); \
     } \
-    *(cp+8*_i) = col; \
-    *(vp+8*_i) = value; \
+    *(cp+a->sliceheight*_i) = col; \
+    *(vp+a->sliceheight*_i) = value; \
     a->nz++; a->rlen[row]++; A->nonzerostate++; \
     low = _i+1; high++; \
   } \
@@ -202,4 +213,10 @@ PETSC_INTERN PetscErrorCode MatRestoreColumnIJ_SeqSELL_Color(Mat,PetscInt,PetscB
 PETSC_INTERN PetscErrorCode MatConjugate_SeqSELL(Mat A);
 PETSC_INTERN PetscErrorCode MatScale_SeqSELL(Mat,PetscScalar);
 PETSC_INTERN PetscErrorCode MatDiagonalScale_SeqSELL(Mat,Vec,Vec);
+#if defined(MATSEQSELL_AVX_KERNELS)
+PETSC_INTERN PetscErrorCode MatMultKernel_SeqSELL_AVX512(Mat,const PetscScalar*,const PetscScalar*,PetscScalar*);
+PETSC_INTERN PetscErrorCode MatMultKernel_SeqSELL_AVX2(Mat,const PetscScalar*,const PetscScalar*,PetscScalar*);
+PETSC_INTERN PetscErrorCode MatMultTransposeKernel_SeqSELL_AVX512(Mat,const PetscScalar*,PetscScalar*);
+PETSC_INTERN PetscErrorCode MatMultTransposeKernel_SeqSELL_AVX2(Mat,const PetscScalar*,PetscScalar*);
+#endif
 #endif
@@ -0,0 +1,245 @@
+/*
+  AVX2 and AVX-512 kernels for the SELL matrix storage format. They are compiled with function-level target
+  attributes so that a single build contains all the variants; MatSeqSELLSelectKernel_Private() picks one at
+  runtime from the features of the CPU and the slice height of the matrix.
+*/
+#include <../src/mat/impls/sell/seq/sell.h>
+
+#if defined(MATSEQSELL_AVX_KERNELS)
+#include <immintrin.h>
+
+#if !defined(_MM_SCALE_8)
+#define _MM_SCALE_8    8
+#endif
+
+#define AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y) \
+  vec_idx  = _mm256_loadu_si256((__m256i const*)acolidx); \
+  vec_vals = _mm512_loadu_pd(aval); \
+  vec_x    = _mm512_i32gather_pd(vec_idx,x,_MM_SCALE_8); \
+  vec_y    = _mm512_fmadd_pd(vec_x,vec_vals,vec_y)
+
+#define AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y) \
+  vec_vals = _mm256_loadu_pd(aval); \
+  vec_idx  = _mm_loadu_si128((__m128i const*)acolidx); /* SSE2 */ \
+  vec_x    = _mm256_i32gather_pd(x,vec_idx,_MM_SCALE_8); \
+  vec_y    = _mm256_fmadd_pd(vec_x,vec_vals,vec_y)
+
+/*
+   z = A*x + y, or z = A*x when y is NULL; y and z may be the same array.
+   Each slice is processed in groups of 8 rows, one 512-bit register per group, so the slice height must be a multiple of 8.
+*/
+__attribute__((target("avx512f")))
+PetscErrorCode MatMultKernel_SeqSELL_AVX512(Mat A,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const PetscInt  sh=a->sliceheight,m=A->rmap->n,*sliidx=a->sliidx;
+  const PetscInt  *acolidx;
+  const MatScalar *aval;
+  PetscInt        i,j,c,row,ncols;
+  __m512d         vec_x,vec_y,vec_vals,vec_x2,vec_y2,vec_vals2,vec_x3,vec_y3,vec_vals3,vec_x4,vec_y4,vec_vals4;
+  __m256i         vec_idx,vec_idx2,vec_idx3,vec_idx4;
+  __mmask8        mask;
+
+  PetscFunctionBegin;
+  for (i=0; i<a->totalslices; i++) { /* loop over slices */
+    PetscPrefetchBlock(a->colidx+sliidx[i],sliidx[i+1]-sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+    PetscPrefetchBlock(a->val+sliidx[i],sliidx[i+1]-sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+    ncols = (sliidx[i+1]-sliidx[i])/sh;
+    for (c=0; c<sh; c+=8) { /* loop over groups of 8 rows in the slice */
+      row = i*sh+c;
+      if (row >= m) break;
+      mask    = (row+8 > m) ? (__mmask8)(0xff >> (row+8-m)) : (__mmask8)0xff; /* the last slice may have padding rows */
+      acolidx = a->colidx+sliidx[i]+c;
+      aval    = a->val+sliidx[i]+c;
+
+      vec_y  = y ? _mm512_maskz_loadu_pd(mask,y+row) : _mm512_setzero_pd();
+      vec_y2 = _mm512_setzero_pd();
+      vec_y3 = _mm512_setzero_pd();
+      vec_y4 = _mm512_setzero_pd();
+
+      j = 0;
+      switch (ncols & 3) {
+      case 3:
+        AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+        acolidx += sh; aval += sh;
+        AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
+        acolidx += sh; aval += sh;
+        AVX512_Mult_Private(vec_idx3,vec_x3,vec_vals3,vec_y3);
+        acolidx += sh; aval += sh;
+        j = 3;
+        break;
+      case 2:
+        AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+        acolidx += sh; aval += sh;
+        AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
+        acolidx += sh; aval += sh;
+        j = 2;
+        break;
+      case 1:
+        AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+        acolidx += sh; aval += sh;
+        j = 1;
+        break;
+      }
+      for (; j<ncols; j+=4) {
+        AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+        acolidx += sh; aval += sh;
+        AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
+        acolidx += sh; aval += sh;
+        AVX512_Mult_Private(vec_idx3,vec_x3,vec_vals3,vec_y3);
+        acolidx += sh; aval += sh;
+        AVX512_Mult_Private(vec_idx4,vec_x4,vec_vals4,vec_y4);
+        acolidx += sh; aval += sh;
+      }
+
+      vec_y = _mm512_add_pd(vec_y,vec_y2);
+      vec_y = _mm512_add_pd(vec_y,vec_y3);
+      vec_y = _mm512_add_pd(vec_y,vec_y4);
+      _mm512_mask_storeu_pd(z+row,mask,vec_y);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   y = y + A^T*x. The products of a slice column are scattered with one gather/scatter pair unless two of its
+   rows hit the same column, which is detected with the AVX-512CD conflict instruction.
+*/
+__attribute__((target("avx512f,avx512cd")))
+PetscErrorCode MatMultTransposeKernel_SeqSELL_AVX512(Mat A,const PetscScalar *x,PetscScalar *y)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const PetscInt  sh=a->sliceheight,m=A->rmap->n,*sliidx=a->sliidx;
+  const PetscInt  *acolidx;
+  const MatScalar *aval;
+  PetscInt        i,j,c,r,row,nrows,ncols;
+  __m512d         vec_x,vec_y,vec_vals;
+  __m512i         vec_conflict;
+  __m256i         vec_idx;
+  __mmask8        mask;
+
+  PetscFunctionBegin;
+  for (i=0; i<a->totalslices; i++) { /* loop over slices */
+    ncols = (sliidx[i+1]-sliidx[i])/sh;
+    for (c=0; c<sh; c+=8) { /* loop over groups of 8 rows in the slice */
+      row = i*sh+c;
+      if (row >= m) break;
+      nrows   = PetscMin(8,m-row);
+      mask    = (__mmask8)(0xff >> (8-nrows));
+      acolidx = a->colidx+sliidx[i]+c;
+      aval    = a->val+sliidx[i]+c;
+      vec_x   = _mm512_maskz_loadu_pd(mask,x+row); /* padding rows multiply the padding zeros by zero */
+      for (j=0; j<ncols; j++) {
+        vec_idx      = _mm256_loadu_si256((__m256i const*)acolidx);
+        vec_conflict = _mm512_maskz_conflict_epi32(0xff,_mm512_castsi256_si512(vec_idx));
+        if (!_mm512_mask_test_epi32_mask(0xff,vec_conflict,vec_conflict)) {
+          vec_vals = _mm512_loadu_pd(aval);
+          vec_y    = _mm512_i32gather_pd(vec_idx,y,_MM_SCALE_8);
+          vec_y    = _mm512_fmadd_pd(vec_vals,vec_x,vec_y);
+          _mm512_i32scatter_pd(y,vec_idx,vec_y,_MM_SCALE_8);
+        } else {
+          for (r=0; r<nrows; r++) y[acolidx[r]] += aval[r]*x[row+r];
+        }
+        acolidx += sh; aval += sh;
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   z = A*x + y, or z = A*x when y is NULL; y and z may be the same array.
+   Each slice is processed in groups of 4 rows, one 256-bit register per group, so the slice height must be a multiple of 4.
+*/
+__attribute__((target("avx2,fma")))
+PetscErrorCode MatMultKernel_SeqSELL_AVX2(Mat A,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const PetscInt  sh=a->sliceheight,m=A->rmap->n,*sliidx=a->sliidx;
+  const PetscInt  *acolidx;
+  const MatScalar *aval;
+  PetscInt        i,j,c,r,row,ncols;
+  PetscScalar     sum;
+  __m256d         vec_x,vec_y,vec_y2,vec_vals;
+  __m128i         vec_idx;
+
+  PetscFunctionBegin;
+  for (i=0; i<a->totalslices; i++) { /* loop over slices */
+    PetscPrefetchBlock(a->colidx+sliidx[i],sliidx[i+1]-sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+    PetscPrefetchBlock(a->val+sliidx[i],sliidx[i+1]-sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+    ncols = (sliidx[i+1]-sliidx[i])/sh;
+    for (c=0; c<sh; c+=4) { /* loop over groups of 4 rows in the slice */
+      row = i*sh+c;
+      if (row >= m) break;
+      acolidx = a->colidx+sliidx[i]+c;
+      aval    = a->val+sliidx[i]+c;
+
+      /* the last slice may have padding rows. Don't use vectorization. */
+      if (row+4 > m) {
+        for (r=0; r<m-row; r++) {
+          sum = y ? y[row+r] : 0.0;
+          for (j=0; j<a->rlen[row+r]; j++) sum += aval[j*sh+r]*x[acolidx[j*sh+r]];
+          z[row+r] = sum;
+        }
+        break;
+      }
+
+      vec_y  = y ? _mm256_loadu_pd(y+row) : _mm256_setzero_pd();
+      vec_y2 = _mm256_setzero_pd();
+      for (j=0; j+1<ncols; j+=2) {
+        AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+        acolidx += sh; aval += sh;
+        AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y2);
+        acolidx += sh; aval += sh;
+      }
+      if (j < ncols) {
+        AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+      }
+      _mm256_storeu_pd(z+row,_mm256_add_pd(vec_y,vec_y2));
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   y = y + A^T*x. AVX2 has no scatter instruction, so only the products are vectorized.
+*/
+__attribute__((target("avx2,fma")))
+PetscErrorCode MatMultTransposeKernel_SeqSELL_AVX2(Mat A,const PetscScalar *x,PetscScalar *y)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const PetscInt  sh=a->sliceheight,m=A->rmap->n,*sliidx=a->sliidx;
+  const PetscInt  *acolidx;
+  const MatScalar *aval;
+  PetscInt        i,j,c,r,row,ncols;
+  PetscScalar     prod[4];
+  __m256d         vec_x;
+
+  PetscFunctionBegin;
+  for (i=0; i<a->totalslices; i++) { /* loop over slices */
+    ncols = (sliidx[i+1]-sliidx[i])/sh;
+    for (c=0; c<sh; c+=4) { /* loop over groups of 4 rows in the slice */
+      row = i*sh+c;
+      if (row >= m) break;
+      acolidx = a->colidx+sliidx[i]+c;
+      aval    = a->val+sliidx[i]+c;
+      if (row+4 > m) {
+        for (r=0; r<m-row; r++) {
+          for (j=0; j<a->rlen[row+r]; j++) y[acolidx[j*sh+r]] += aval[j*sh+r]*x[row+r];
+        }
+        break;
+      }
+      vec_x = _mm256_loadu_pd(x+row);
+      for (j=0; j<ncols; j++) {
+        _mm256_storeu_pd(prod,_mm256_mul_pd(_mm256_loadu_pd(aval),vec_x));
+        y[acolidx[0]] += prod[0];
+        y[acolidx[1]] += prod[1];
+        y[acolidx[2]] += prod[2];
+        y[acolidx[3]] += prod[3];
+        acolidx += sh; aval += sh;
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+#endif
@@ -27,6 +27,9 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJPERM(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSELL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJSELL(Mat);
 
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSingle(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJSingle(Mat);
+
 #if defined PETSC_HAVE_MKL_SPARSE
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJMKL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJMKL(Mat);
@@ -108,6 +111,10 @@ PetscErrorCode  MatRegisterAll(void)
   ierr = MatRegister(MATMPIAIJSELL,     MatCreate_MPIAIJSELL);CHKERRQ(ierr);
   ierr = MatRegister(MATSEQAIJSELL,     MatCreate_SeqAIJSELL);CHKERRQ(ierr);
 
+  ierr = MatRegisterRootName(MATAIJSINGLE,MATSEQAIJSINGLE,MATMPIAIJSINGLE);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJSINGLE,   MatCreate_MPIAIJSingle);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJSINGLE,   MatCreate_SeqAIJSingle);CHKERRQ(ierr);
+
 #if defined PETSC_HAVE_MKL_SPARSE
   ierr = MatRegisterRootName(MATAIJMKL, MATSEQAIJMKL,MATMPIAIJMKL);CHKERRQ(ierr);
   ierr = MatRegister(MATMPIAIJMKL,      MatCreate_MPIAIJMKL);CHKERRQ(ierr);
@@ -32,9 +32,10 @@ PetscLogEvent MAT_Getsymtranspose, MAT_Getsymtransreduced, MAT_Transpose_SeqAIJ,
 PetscLogEvent MAT_GetBrowsOfAocols, MAT_Getlocalmat, MAT_Getlocalmatcondensed, MAT_Seqstompi, MAT_Seqstompinum, MAT_Seqstompisym;
 PetscLogEvent MAT_Applypapt, MAT_Applypapt_numeric, MAT_Applypapt_symbolic, MAT_GetSequentialNonzeroStructure;
 PetscLogEvent MAT_GetMultiProcBlock;
-PetscLogEvent MAT_CUSPARSECopyToGPU, MAT_SetValuesBatch;
+PetscLogEvent MAT_CUSPARSECopyToGPU, MAT_SetValuesBatch, MAT_PreallCOO, MAT_SetValuesCOO;
 PetscLogEvent MAT_ViennaCLCopyToGPU;
 PetscLogEvent MAT_Merge,MAT_Residual,MAT_SetRandom;
+PetscLogEvent MAT_MultThreadImbalance;
 PetscLogEvent MATCOLORING_Apply,MATCOLORING_Comm,MATCOLORING_Local,MATCOLORING_ISCreate,MATCOLORING_SetUp,MATCOLORING_Weights;
 
 const char *const MatFactorTypes[] = {"NONE","LU","CHOLESKY","ILU","ICC","ILUDT","MatFactorType","MAT_FACTOR_",0};
@@ -2032,6 +2033,95 @@ PetscErrorCode MatSetValuesBatch(Mat mat, PetscInt nb, PetscInt bs, PetscInt row
   PetscFunctionReturn(0);
 }
 
+/*@C
+   MatSetPreallocationCOO - Sets the nonzero structure of a matrix from a list of (row,column) entries in coordinate (COO) format
+
+   Collective on Mat
+
+   Input Parameters:
++  mat - the matrix, its type and sizes must have been set
+.  ncoo - the number of entries given by this process
+.  coo_i - the global row indices of the entries
+-  coo_j - the global column indices of the entries
+
+   Notes:
+   The entries may be repeated and may belong to rows owned by other processes; entries with a negative row or
+   column index are ignored. The list is analyzed only once: the matrix is preallocated exactly, assembled with zero
+   values and the communication needed for the off-process entries is set up, so that MatSetValuesCOO() only needs the
+   array of values, given in the same order as coo_i and coo_j. The nonzero structure cannot change afterwards.
+
+   Currently supported by MATSEQAIJ and MATMPIAIJ.
+
+   Level: intermediate
+
+   Concepts: matrices^preallocating
+
+.seealso: MatSetValuesCOO(), MatSeqAIJSetPreallocationCSR(), MatMPIAIJSetPreallocationCSR(), MatSetValues()
+@*/
+PetscErrorCode MatSetPreallocationCOO(Mat mat,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
+  PetscValidType(mat,1);
+  if (ncoo) {
+    PetscValidIntPointer(coo_i,3);
+    PetscValidIntPointer(coo_j,4);
+  }
+  if (ncoo < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of entries cannot be negative: %D",ncoo);
+  if (mat->factortype) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Not for factored matrix");
+  ierr = PetscLogEventBegin(MAT_PreallCOO,mat,0,0,0);CHKERRQ(ierr);
+  ierr = PetscUseMethod(mat,"MatSetPreallocationCOO_C",(Mat,PetscInt,const PetscInt[],const PetscInt[]),(mat,ncoo,coo_i,coo_j));CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_PreallCOO,mat,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatSetValuesCOO - Sets the values of a matrix whose nonzero structure was given by MatSetPreallocationCOO()
+
+   Collective on Mat
+
+   Input Parameters:
++  mat - the matrix
+.  v - the values, in the same order as the coo_i and coo_j arrays given to MatSetPreallocationCOO()
+-  imode - INSERT_VALUES to replace the values of the matrix, ADD_VALUES to add to them
+
+   Notes:
+   Repeated entries are always summed, the sum is then inserted or added according to imode. The values given for
+   entries in rows owned by other processes are sent to their owners with the PetscSF built by
+   MatSetPreallocationCOO(), the matrix stash is not used.
+
+   The matrix is assembled on return, there is no need to call MatAssemblyBegin() and MatAssemblyEnd().
+
+   Level: intermediate
+
+   Concepts: matrices^putting entries in
+
+.seealso: MatSetPreallocationCOO(), MatSetValues(), InsertMode, INSERT_VALUES, ADD_VALUES
+@*/
+PetscErrorCode MatSetValuesCOO(Mat mat,const PetscScalar v[],InsertMode imode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
+  PetscValidType(mat,1);
+  PetscValidLogicalCollectiveEnum(mat,imode,3);
+  if (imode != INSERT_VALUES && imode != ADD_VALUES) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Only INSERT_VALUES and ADD_VALUES are supported");
+  if (mat->factortype) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Not for factored matrix");
+  ierr = PetscLogEventBegin(MAT_SetValuesCOO,mat,0,0,0);CHKERRQ(ierr);
+  ierr = PetscUseMethod(mat,"MatSetValuesCOO_C",(Mat,const PetscScalar[],InsertMode),(mat,v,imode));CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_SetValuesCOO,mat,0,0,0);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)mat);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA)
+  if (mat->valid_GPU_matrix != PETSC_OFFLOAD_UNALLOCATED) {
+    mat->valid_GPU_matrix = PETSC_OFFLOAD_CPU;
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
 /*@
    MatSetLocalToGlobalMapping - Sets a local-to-global numbering for use by
    the routine MatSetValuesLocal() to allow users to insert matrix entries
@@ -5298,6 +5388,112 @@ PetscErrorCode MatNorm(Mat mat,NormType type,PetscReal *nrm)
   PetscFunctionReturn(0);
 }
 
+/* the matrix types that can compute the local part of a norm do so for NORM_FROBENIUS and NORM_INFINITY */
+static PetscErrorCode MatNormGetLocal_Private(Mat mat,NormType type,PetscErrorCode (**f)(Mat,NormType,PetscReal*))
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  *f   = NULL;
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)mat),&size);CHKERRQ(ierr);
+  if (size > 1 && (type == NORM_FROBENIUS || type == NORM_INFINITY)) {
+    ierr = PetscObjectQueryFunction((PetscObject)mat,"MatNormLocal_C",f);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatNormBegin - Starts a split phase norm computation, the reduction over the processes is combined with
+   the other split phase reductions of the communicator.
+
+   Collective on Mat
+
+   Input Parameters:
++  mat - the matrix
+.  type - the type of norm, NORM_1, NORM_FROBENIUS, NORM_INFINITY
+-  nrm - where the result will go (can be NULL)
+
+   Level: advanced
+
+   Notes:
+   Each call to MatNormBegin() should be paired with a call to MatNormEnd().
+
+   MATMPIAIJ only computes the local part of NORM_FROBENIUS and NORM_INFINITY here; other matrix types and norms
+   are computed completely by MatNormBegin().
+
+   Concepts: matrices^norm
+   Concepts: norm^of matrix
+
+.seealso: MatNorm(), MatNormEnd(), VecNormBegin(), PetscCommSplitReductionBegin(), PetscCommSplitReductionValuesBegin()
+@*/
+PetscErrorCode MatNormBegin(Mat mat,NormType type,PetscReal *nrm)
+{
+  PetscErrorCode ierr;
+  PetscErrorCode (*f)(Mat,NormType,PetscReal*);
+  PetscReal      lnrm;
+  PetscScalar    v;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
+  PetscValidType(mat,1);
+  if (!mat->assembled) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_WRONGSTATE,"Not for unassembled matrix");
+  if (mat->factortype) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_WRONGSTATE,"Not for factored matrix");
+  MatCheckPreallocated(mat,1);
+
+  ierr = MatNormGetLocal_Private(mat,type,&f);CHKERRQ(ierr);
+  if (f) {
+    ierr = (*f)(mat,type,&lnrm);CHKERRQ(ierr);
+    v    = lnrm;
+    ierr = PetscCommSplitReductionValuesBegin(PetscObjectComm((PetscObject)mat),type == NORM_FROBENIUS ? PETSC_SR_REDUCE_SUM : PETSC_SR_REDUCE_MAX,1,&v);CHKERRQ(ierr);
+  } else {
+    /* the norm is the same on all processes, so the max leaves it unchanged */
+    ierr = MatNorm(mat,type,&lnrm);CHKERRQ(ierr);
+    v    = lnrm;
+    ierr = PetscCommSplitReductionValuesBegin(PetscObjectComm((PetscObject)mat),PETSC_SR_REDUCE_MAX,1,&v);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatNormEnd - Ends a split phase norm computation.
+
+   Collective on Mat
+
+   Input Parameters:
++  mat - the matrix
+-  type - the type of norm given to MatNormBegin()
+
+   Output Parameters:
+.  nrm - the resulting norm
+
+   Level: advanced
+
+   Notes:
+   Each call to MatNormBegin() should be paired with a call to MatNormEnd().
+
+.seealso: MatNorm(), MatNormBegin(), VecNormEnd(), PetscCommSplitReductionBegin()
+@*/
+PetscErrorCode MatNormEnd(Mat mat,NormType type,PetscReal *nrm)
+{
+  PetscErrorCode ierr;
+  PetscErrorCode (*f)(Mat,NormType,PetscReal*);
+  PetscScalar    v;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat,MAT_CLASSID,1);
+  PetscValidRealPointer(nrm,3);
+  ierr = MatNormGetLocal_Private(mat,type,&f);CHKERRQ(ierr);
+  if (f && type == NORM_FROBENIUS) {
+    ierr = PetscCommSplitReductionValuesEnd(PetscObjectComm((PetscObject)mat),PETSC_SR_REDUCE_SUM,1,&v);CHKERRQ(ierr);
+    *nrm = PetscSqrtReal(PetscRealPart(v));
+  } else {
+    ierr = PetscCommSplitReductionValuesEnd(PetscObjectComm((PetscObject)mat),PETSC_SR_REDUCE_MAX,1,&v);CHKERRQ(ierr);
+    *nrm = PetscRealPart(v);
+  }
+  PetscFunctionReturn(0);
+}
+
 /*
      This variable is used to prevent counting of MatAssemblyBegin() that
    are called from within a MatAssemblyEnd().
@@ -5328,6 +5524,11 @@ static PetscInt MatAssemblyEnd_InUse = 0;
    out by assembly. If you intend to use that extra space on a subsequent assembly, be sure to insert explicit zeros
    before MAT_FINAL_ASSEMBLY so the space is not compressed out.
 
+   Options Database Keys:
++  -matstash_legacy - use the older communication of off-process entries
+-  -matstash_persistent - record the communication of off-process entries; later assemblies that set exactly the same
+                          off-process entries in the same order only send the values, with persistent MPI requests
+
    Level: beginner
 
    Concepts: matrices^assembling
@@ -5570,6 +5771,11 @@ PetscErrorCode MatAssemblyEnd(Mat mat,MatAssemblyType type)
    should be used with MAT_USE_HASH_TABLE flag. This option is currently
    supported by MATMPIBAIJ format only.
 
+   For MATSEQAIJ and MATMPIAIJ, MAT_USE_HASH_TABLE set before the first MatSetValues() instead
+   stores the entries in a hash table until the first MAT_FINAL_ASSEMBLY; MatAssemblyEnd() then
+   preallocates the matrix exactly and inserts the entries. No preallocation needs to be provided
+   and no mallocs are made for new nonzeros. The option has no effect once the matrix has been assembled.
+
    MAT_KEEP_NONZERO_PATTERN indicates when MatZeroRows() is called the zeroed entries
    are kept in the nonzero structure
 
@@ -11,6 +11,10 @@ static PetscErrorCode MatStashScatterBegin_BTS(Mat,MatStash*,PetscInt*);
 static PetscErrorCode MatStashScatterGetMesg_BTS(MatStash*,PetscMPIInt*,PetscInt**,PetscInt**,PetscScalar**,PetscInt*);
 static PetscErrorCode MatStashScatterEnd_BTS(MatStash*);
 static PetscErrorCode MatStashScatterDestroy_BTS(MatStash*);
+static PetscErrorCode MatStashScatterBegin_Persistent(Mat,MatStash*,PetscInt*);
+static PetscErrorCode MatStashScatterGetMesg_Persistent(MatStash*,PetscMPIInt*,PetscInt**,PetscInt**,PetscScalar**,PetscInt*);
+static PetscErrorCode MatStashScatterEnd_Persistent(MatStash*);
+static PetscErrorCode MatStashScatterDestroy_Persistent(MatStash*);
 #endif
 
 /*
@@ -80,6 +84,10 @@ PetscErrorCode MatStashCreate_Private(MPI_Comm comm,PetscInt bs,MatStash *stash)
   stash->reproduce   = PETSC_FALSE;
   stash->blocktype   = MPI_DATATYPE_NULL;
 
+  stash->pers_setup  = PETSC_FALSE;
+  stash->pers_record = PETSC_FALSE;
+  stash->pers_replay = PETSC_FALSE;
+
   ierr = PetscOptionsGetBool(NULL,NULL,"-matstash_reproduce",&stash->reproduce,NULL);CHKERRQ(ierr);
 #if !defined(PETSC_HAVE_MPIUNI)
   ierr = PetscOptionsGetBool(NULL,NULL,"-matstash_legacy",&flg,NULL);CHKERRQ(ierr);
@@ -88,6 +96,13 @@ PetscErrorCode MatStashCreate_Private(MPI_Comm comm,PetscInt bs,MatStash *stash)
     stash->ScatterGetMesg = MatStashScatterGetMesg_BTS;
     stash->ScatterEnd     = MatStashScatterEnd_BTS;
     stash->ScatterDestroy = MatStashScatterDestroy_BTS;
+    ierr = PetscOptionsGetBool(NULL,NULL,"-matstash_persistent",&flg,NULL);CHKERRQ(ierr);
+    if (flg) {
+      stash->ScatterBegin   = MatStashScatterBegin_Persistent;
+      stash->ScatterGetMesg = MatStashScatterGetMesg_Persistent;
+      stash->ScatterEnd     = MatStashScatterEnd_Persistent;
+      stash->ScatterDestroy = MatStashScatterDestroy_Persistent;
+    }
   } else {
 #endif
     stash->ScatterBegin   = MatStashScatterBegin_Ref;
@@ -709,7 +724,8 @@ static PetscErrorCode MatStashSortCompress_Private(MatStash *stash,InsertMode in
 {
   PetscErrorCode ierr;
   PetscMatStashSpace space;
-  PetscInt n = stash->n,bs = stash->bs,bs2 = bs*bs,cnt,*row,*col,*perm,rowstart,i;
+  PetscInt n = stash->n,bs = stash->bs,bs2 = bs*bs,cnt,*row,*col,*perm,rowstart,i,nb = 0;
+  PetscInt *map = stash->pers_record ? stash->pers_map : NULL;
   PetscScalar **valptr;
 
   PetscFunctionBegin;
@@ -737,7 +753,9 @@ static PetscErrorCode MatStashSortCompress_Private(MatStash *stash,InsertMode in
         block->row = row[rowstart];
         block->col = col[colstart];
         ierr = PetscMemcpy(block->vals,valptr[perm[colstart]],bs2*sizeof(block->vals[0]));CHKERRQ(ierr);
+        if (map) map[perm[colstart]] = nb;
         for (j=colstart+1; j<i && col[j] == col[colstart]; j++) { /* Add any extra stashed blocks at the same (row,col) */
+          if (map) map[perm[j]] = nb;
           if (insertmode == ADD_VALUES) {
             for (l=0; l<bs2; l++) block->vals[l] += valptr[perm[j]][l];
           } else {
@@ -745,6 +763,7 @@ static PetscErrorCode MatStashSortCompress_Private(MatStash *stash,InsertMode in
           }
         }
         colstart = j;
+        nb++;
       }
       rowstart = i;
     }
@@ -986,19 +1005,12 @@ static PetscErrorCode MatStashScatterGetMesg_BTS(MatStash *stash,PetscMPIInt *n,
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode MatStashScatterEnd_BTS(MatStash *stash)
+/* Empties the stash after the values have been communicated */
+static PetscErrorCode MatStashReset_BTS(MatStash *stash)
 {
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
-  ierr = MPI_Waitall(stash->nsendranks,stash->sendreqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
-  if (stash->subset_off_proc) { /* Reuse the communication contexts, so consolidate and reset segrecvblocks  */
-    void *dummy;
-    ierr = PetscSegBufferExtractInPlace(stash->segrecvblocks,&dummy);CHKERRQ(ierr);
-  } else {                      /* No reuse, so collect everything. */
-    ierr = MatStashScatterDestroy_BTS(stash);CHKERRQ(ierr);
-  }
-
   /* Now update nmaxold to be app 10% more than max n used, this way the
      wastage of space is reduced the next time this stash is used.
      Also update the oldmax, only if it increases */
@@ -1020,6 +1032,23 @@ static PetscErrorCode MatStashScatterEnd_BTS(MatStash *stash)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode MatStashScatterEnd_BTS(MatStash *stash)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Waitall(stash->nsendranks,stash->sendreqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  if (stash->subset_off_proc) { /* Reuse the communication contexts, so consolidate and reset segrecvblocks  */
+    void *dummy;
+    ierr = PetscSegBufferExtractInPlace(stash->segrecvblocks,&dummy);CHKERRQ(ierr);
+  } else {                      /* No reuse, so collect everything. */
+    ierr = MatStashScatterDestroy_BTS(stash);CHKERRQ(ierr);
+  }
+
+  ierr = MatStashReset_BTS(stash);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode MatStashScatterDestroy_BTS(MatStash *stash)
 {
   PetscErrorCode ierr;
@@ -1042,4 +1071,186 @@ static PetscErrorCode MatStashScatterDestroy_BTS(MatStash *stash)
   ierr = PetscFree2(stash->some_indices,stash->some_statuses);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
+
+/*
+   Persistent communication, -matstash_persistent
+
+   The first assembly goes through the BTS communication above and records the rows and columns of the stashed
+   entries in the order they were set, the block of the send buffer each of them is compressed into and the blocks
+   received from each rank. Later assemblies that stash exactly the same entries in the same order on every process
+   skip the sorting and compression, and only send the values with persistent requests. Any difference falls back
+   to the BTS communication, which is then recorded again.
+*/
+static PetscErrorCode MatStashPersistentDestroy_Private(MatStash *stash)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    i;
+
+  PetscFunctionBegin;
+  if (!stash->pers_setup) PetscFunctionReturn(0);
+  for (i=0; i<stash->pers_nsend; i++) {ierr = MPI_Request_free(&stash->pers_sendreqs[i]);CHKERRQ(ierr);}
+  for (i=0; i<stash->pers_nrecv; i++) {ierr = MPI_Request_free(&stash->pers_recvreqs[i]);CHKERRQ(ierr);}
+  ierr = PetscFree3(stash->pers_idx,stash->pers_idy,stash->pers_map);CHKERRQ(ierr);
+  ierr = PetscFree2(stash->pers_sendvals,stash->pers_sendreqs);CHKERRQ(ierr);
+  ierr = PetscFree4(stash->pers_recvrow,stash->pers_recvcol,stash->pers_recvvals,stash->pers_recvoffset);CHKERRQ(ierr);
+  ierr = PetscFree2(stash->pers_recvreqs,stash->pers_some_indices);CHKERRQ(ierr);
+  stash->pers_nsend = 0;
+  stash->pers_nrecv = 0;
+  stash->pers_setup = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatStashScatterBegin_Persistent(Mat mat,MatStash *stash,PetscInt owners[])
+{
+  PetscErrorCode     ierr;
+  PetscMatStashSpace space;
+  PetscInt           i,k,l,n = stash->n,bs2 = stash->bs*stash->bs,off;
+  PetscMPIInt        mismatch,gmismatch,count;
+  PetscBool          subsetoffprocentries;
+  PetscScalar        *v;
+
+  PetscFunctionBegin;
+  if (stash->pers_setup) {
+    mismatch = (n != stash->pers_n || (n && mat->insertmode != stash->pers_insertmode)) ? 1 : 0;
+    for (space=stash->space_head,k=0; space && !mismatch; space=space->next) {
+      for (i=0; i<space->local_used; i++,k++) {
+        if (space->idx[i] != stash->pers_idx[k] || space->idy[i] != stash->pers_idy[k]) {mismatch = 1; break;}
+      }
+    }
+    ierr = MPIU_Allreduce(&mismatch,&gmismatch,1,MPI_INT,MPI_MAX,stash->comm);CHKERRQ(ierr);
+    if (!gmismatch) {
+      if (stash->pers_nrecv && mat->insertmode != NOT_SET_VALUES && mat->insertmode != stash->pers_recvmode) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Some processors inserted others added");
+      if (stash->pers_nrecv) {ierr = MPI_Startall(stash->pers_nrecv,stash->pers_recvreqs);CHKERRQ(ierr);}
+      if (stash->pers_insertmode == ADD_VALUES) {ierr = PetscMemzero(stash->pers_sendvals,stash->pers_nblocks*bs2*sizeof(PetscScalar));CHKERRQ(ierr);}
+      for (space=stash->space_head,k=0; space; space=space->next) {
+        for (i=0; i<space->local_used; i++,k++) {
+          v = stash->pers_sendvals + stash->pers_map[k]*bs2;
+          if (stash->pers_insertmode == ADD_VALUES) {
+            for (l=0; l<bs2; l++) v[l] += space->val[i*bs2+l];
+          } else {
+            for (l=0; l<bs2; l++) v[l] = space->val[i*bs2+l];
+          }
+        }
+      }
+      if (stash->pers_nsend) {ierr = MPI_Startall(stash->pers_nsend,stash->pers_sendreqs);CHKERRQ(ierr);}
+      stash->some_i      = 0;
+      stash->some_count  = 0;
+      stash->recvcount   = 0;
+      stash->insertmode  = &mat->insertmode;
+      stash->pers_replay = PETSC_TRUE;
+      PetscFunctionReturn(0);
+    }
+    ierr = PetscInfo(NULL,"Stashed entries differ from the recorded ones, recording the communication again\n");CHKERRQ(ierr);
+    ierr = MatStashPersistentDestroy_Private(stash);CHKERRQ(ierr);
+  }
+
+  /* Record the stashed entries, MatStashSortCompress_Private() fills pers_map */
+  ierr = PetscMalloc3(n,&stash->pers_idx,n,&stash->pers_idy,n,&stash->pers_map);CHKERRQ(ierr);
+  for (space=stash->space_head,k=0; space; space=space->next) {
+    ierr = PetscMemcpy(stash->pers_idx+k,space->idx,space->local_used*sizeof(PetscInt));CHKERRQ(ierr);
+    ierr = PetscMemcpy(stash->pers_idy+k,space->idy,space->local_used*sizeof(PetscInt));CHKERRQ(ierr);
+    k   += space->local_used;
+  }
+  stash->pers_n          = n;
+  stash->pers_insertmode = mat->insertmode;
+  stash->pers_record     = PETSC_TRUE;
+
+  /* The persistent requests replace the reuse of MAT_SUBSET_OFF_PROC_ENTRIES, so the BTS context is not kept */
+  subsetoffprocentries      = mat->subsetoffprocentries;
+  mat->subsetoffprocentries = PETSC_FALSE;
+  ierr = MatStashScatterBegin_BTS(mat,stash,owners);CHKERRQ(ierr);
+  mat->subsetoffprocentries = subsetoffprocentries;
+
+  stash->pers_nsend = stash->nsendranks;
+  for (i=0,stash->pers_nblocks=0; i<stash->nsendranks; i++) stash->pers_nblocks += stash->sendhdr[i].count;
+  ierr = PetscMalloc2(stash->pers_nblocks*bs2,&stash->pers_sendvals,stash->pers_nsend,&stash->pers_sendreqs);CHKERRQ(ierr);
+  ierr = PetscCommGetNewTag(stash->comm,&stash->pers_tag);CHKERRQ(ierr);
+  for (i=0,off=0; i<stash->nsendranks; i++) {
+    ierr = PetscMPIIntCast(stash->sendhdr[i].count*bs2,&count);CHKERRQ(ierr);
+    ierr = MPI_Send_init(stash->pers_sendvals+off,count,MPIU_SCALAR,stash->sendranks[i],stash->pers_tag,stash->comm,&stash->pers_sendreqs[i]);CHKERRQ(ierr);
+    off += count;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatStashScatterGetMesg_Persistent(MatStash *stash,PetscMPIInt *n,PetscInt **row,PetscInt **col,PetscScalar **val,PetscInt *flg)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    i;
+  PetscInt       bs2 = stash->bs*stash->bs;
+
+  PetscFunctionBegin;
+  if (!stash->pers_replay) {
+    ierr = MatStashScatterGetMesg_BTS(stash,n,row,col,val,flg);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  *flg = 0;
+  if (stash->some_i == stash->some_count) {
+    if (stash->recvcount == stash->pers_nrecv) PetscFunctionReturn(0); /* Done */
+    ierr = MPI_Waitsome(stash->pers_nrecv,stash->pers_recvreqs,&stash->some_count,stash->pers_some_indices,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    stash->some_i = 0;
+  }
+  i = stash->pers_some_indices[stash->some_i++];
+  stash->recvcount++;
+  if (PetscUnlikely(*stash->insertmode == NOT_SET_VALUES)) *stash->insertmode = stash->pers_recvmode;
+  /* Return the whole message, the blocks of each row are contiguous */
+  *n   = (PetscMPIInt)(stash->pers_recvoffset[i+1] - stash->pers_recvoffset[i]);
+  *row = stash->pers_recvrow + stash->pers_recvoffset[i];
+  *col = stash->pers_recvcol + stash->pers_recvoffset[i];
+  *val = stash->pers_recvvals + stash->pers_recvoffset[i]*bs2;
+  *flg = 1;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatStashScatterEnd_Persistent(MatStash *stash)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,b,nblocks,bs2 = stash->bs*stash->bs;
+  PetscMPIInt    count;
+  MatStashFrame  *frame;
+  MatStashBlock  *block;
+
+  PetscFunctionBegin;
+  if (stash->pers_replay) {
+    ierr = MPI_Waitall(stash->pers_nsend,stash->pers_sendreqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    stash->pers_replay = PETSC_FALSE;
+    ierr = MatStashReset_BTS(stash);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (stash->pers_record) { /* Keep the received rows and columns before the BTS context is destroyed */
+    ierr = MPI_Waitall(stash->nrecvranks,stash->recvreqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    for (i=0,nblocks=0; i<stash->nrecvranks; i++) nblocks += stash->recvframes[i].count;
+    stash->pers_nrecv = stash->nrecvranks;
+    ierr = PetscMalloc4(nblocks,&stash->pers_recvrow,nblocks,&stash->pers_recvcol,nblocks*bs2,&stash->pers_recvvals,stash->pers_nrecv+1,&stash->pers_recvoffset);CHKERRQ(ierr);
+    ierr = PetscMalloc2(stash->pers_nrecv,&stash->pers_recvreqs,stash->pers_nrecv,&stash->pers_some_indices);CHKERRQ(ierr);
+    stash->pers_recvoffset[0] = 0;
+    for (i=0; i<stash->nrecvranks; i++) {
+      frame = &stash->recvframes[i];
+      for (b=0; b<frame->count; b++) {
+        block = (MatStashBlock*)&((char*)frame->buffer)[b*stash->blocktype_size];
+        stash->pers_recvrow[stash->pers_recvoffset[i]+b] = block->row < 0 ? -(block->row+1) : block->row;
+        stash->pers_recvcol[stash->pers_recvoffset[i]+b] = block->col;
+      }
+      stash->pers_recvoffset[i+1] = stash->pers_recvoffset[i] + frame->count;
+      ierr = PetscMPIIntCast(frame->count*bs2,&count);CHKERRQ(ierr);
+      ierr = MPI_Recv_init(stash->pers_recvvals+stash->pers_recvoffset[i]*bs2,count,MPIU_SCALAR,stash->recvranks[i],stash->pers_tag,stash->comm,&stash->pers_recvreqs[i]);CHKERRQ(ierr);
+    }
+    stash->pers_recvmode = *stash->insertmode;
+    stash->pers_record   = PETSC_FALSE;
+    stash->pers_setup    = PETSC_TRUE;
+    ierr = PetscInfo3(NULL,"Recorded the communication of %D stashed entries, %d sends and %d receives\n",stash->pers_n,stash->pers_nsend,stash->pers_nrecv);CHKERRQ(ierr);
+  }
+  ierr = MatStashScatterEnd_BTS(stash);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatStashScatterDestroy_Persistent(MatStash *stash)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatStashPersistentDestroy_Private(stash);CHKERRQ(ierr);
+  ierr = MatStashScatterDestroy_BTS(stash);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 #endif
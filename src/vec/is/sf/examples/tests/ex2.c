@@ -0,0 +1,155 @@
+static const char help[] = "Test star forest communication (PetscSF) on contiguous, strided and 3D box layouts of roots and leaves\n\n";
+
+/*T
+    Description: Each process owns a 4x4x4 box of roots. Its leaves reference the first plane of its own box, a 2x2x2
+    sub-box of the box of the next process and, in reverse order, a column of the box of the previous process.
+T*/
+
+#include <petscsf.h>
+
+#define M 4
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscSF        sf;
+  PetscSFNode    *iremote;
+  PetscInt       *ilocal,*rootdata,*leafdata,*expected,i,j,k,l,nleaves,nroots = M*M*M,nleavesalloc = M*M+8+2*M;
+  PetscScalar    *rootscalar,*leafscalar;
+  PetscMPIInt    rank,size,next,prev;
+  MPI_Datatype   triple;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  next = (rank+1)%size;
+  prev = (rank+size-1)%size;
+
+  ierr = PetscMalloc2(nleavesalloc,&ilocal,nleavesalloc,&iremote);CHKERRQ(ierr);
+  nleaves = 0;
+  for (i=0; i<M*M; i++, nleaves++) {  /* contiguous roots and leaves */
+    ilocal[nleaves]        = i;
+    iremote[nleaves].rank  = rank;
+    iremote[nleaves].index = i;
+  }
+  for (k=1; k<3; k++) {               /* box of roots, contiguous leaves */
+    for (j=1; j<3; j++) {
+      for (i=1; i<3; i++, nleaves++) {
+        ilocal[nleaves]        = nleaves;
+        iremote[nleaves].rank  = next;
+        iremote[nleaves].index = i+j*M+k*M*M;
+      }
+    }
+  }
+  for (j=0; j<M; j++, nleaves++) {    /* general roots, strided leaves */
+    ilocal[nleaves]        = M*M+8+2*j;
+    iremote[nleaves].rank  = prev;
+    iremote[nleaves].index = (M-1-j)*M;
+  }
+  ierr = PetscSFCreate(PETSC_COMM_WORLD,&sf);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(sf,nroots,nleaves,ilocal,PETSC_COPY_VALUES,iremote,PETSC_COPY_VALUES);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscSFViewFromOptions(sf,NULL,"-sf_view");CHKERRQ(ierr);
+
+  ierr = PetscMalloc3(3*nroots,&rootdata,3*nleavesalloc,&leafdata,nroots,&expected);CHKERRQ(ierr);
+
+  /* Broadcast */
+  for (i=0; i<nroots; i++) rootdata[i] = 1000*rank+i;
+  for (l=0; l<nleavesalloc; l++) leafdata[l] = -1;
+  ierr = PetscSFBcastBegin(sf,MPIU_INT,rootdata,leafdata);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sf,MPIU_INT,rootdata,leafdata);CHKERRQ(ierr);
+  for (l=0; l<nleaves; l++) {
+    if (leafdata[ilocal[l]] != 1000*iremote[l].rank+iremote[l].index) {ierr = PetscPrintf(PETSC_COMM_SELF,"[%d] Bcast: wrong leaf %D\n",rank,ilocal[l]);CHKERRQ(ierr);}
+  }
+
+  /* Broadcast of a unit of three integers */
+  ierr = MPI_Type_contiguous(3,MPIU_INT,&triple);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(&triple);CHKERRQ(ierr);
+  for (i=0; i<3*nroots; i++) rootdata[i] = 1000*rank+i;
+  ierr = PetscSFBcastBegin(sf,triple,rootdata,leafdata);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sf,triple,rootdata,leafdata);CHKERRQ(ierr);
+  for (l=0; l<nleaves; l++) {
+    for (k=0; k<3; k++) {
+      if (leafdata[3*ilocal[l]+k] != 1000*iremote[l].rank+3*iremote[l].index+k) {ierr = PetscPrintf(PETSC_COMM_SELF,"[%d] Bcast of triples: wrong leaf %D\n",rank,ilocal[l]);CHKERRQ(ierr);}
+    }
+  }
+  ierr = MPI_Type_free(&triple);CHKERRQ(ierr);
+
+  /* Reduction counting the leaves of each root */
+  for (i=0; i<nroots; i++) rootdata[i] = expected[i] = 0;
+  for (l=0; l<nleavesalloc; l++) leafdata[l] = 1;
+  for (l=0; l<nleaves; l++) expected[iremote[l].index]++;
+  ierr = PetscSFReduceBegin(sf,MPIU_INT,leafdata,rootdata,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(sf,MPIU_INT,leafdata,rootdata,MPIU_SUM);CHKERRQ(ierr);
+  for (i=0; i<nroots; i++) {
+    if (rootdata[i] != expected[i]) {ierr = PetscPrintf(PETSC_COMM_SELF,"[%d] Reduce: wrong root %D\n",rank,i);CHKERRQ(ierr);}
+  }
+
+  /* Reduction replacing the roots of the box, which have one leaf on the previous process */
+  for (l=0; l<nleavesalloc; l++) leafdata[l] = 1000*rank+l;
+  ierr = PetscSFReduceBegin(sf,MPIU_INT,leafdata,rootdata,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(sf,MPIU_INT,leafdata,rootdata,MPIU_REPLACE);CHKERRQ(ierr);
+  for (l=M*M; l<M*M+8; l++) {
+    if (rootdata[iremote[l].index] != 1000*prev+l) {ierr = PetscPrintf(PETSC_COMM_SELF,"[%d] Reduce with replacement: wrong root %D\n",rank,iremote[l].index);CHKERRQ(ierr);}
+  }
+
+  /* Reduction adding scalars, roots of the first plane have leaves on up to three processes */
+  ierr = PetscMalloc2(nroots,&rootscalar,nleavesalloc,&leafscalar);CHKERRQ(ierr);
+  for (i=0; i<nroots; i++) rootscalar[i] = expected[i] = 0;
+  for (l=0; l<nleavesalloc; l++) leafscalar[l] = l;
+  for (l=0; l<nleaves; l++) expected[iremote[l].index] += ilocal[l];
+  ierr = PetscSFReduceBegin(sf,MPIU_SCALAR,leafscalar,rootscalar,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(sf,MPIU_SCALAR,leafscalar,rootscalar,MPIU_SUM);CHKERRQ(ierr);
+  for (i=0; i<nroots; i++) {
+    if (PetscAbsScalar(rootscalar[i]-(PetscReal)expected[i]) > 0) {ierr = PetscPrintf(PETSC_COMM_SELF,"[%d] Reduce of scalars: wrong root %D\n",rank,i);CHKERRQ(ierr);}
+  }
+  /* the conflict-free colors of the basic types are computed by this first reduction of scalars */
+  ierr = PetscSFViewFromOptions(sf,NULL,"-sf_view_reduced");CHKERRQ(ierr);
+  ierr = PetscFree2(rootscalar,leafscalar);CHKERRQ(ierr);
+
+  ierr = PetscFree3(rootdata,leafdata,expected);CHKERRQ(ierr);
+  ierr = PetscFree2(ilocal,iremote);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: basic
+      nsize: 3
+      args: -sf_type basic -sf_view ::ascii_info -sf_view_reduced ::ascii_info
+
+   test:
+      suffix: basic_nonpersistent
+      nsize: 3
+      args: -sf_type basic -sf_basic_persistent 0 -sf_view ::ascii_info -sf_view_reduced ::ascii_info
+      output_file: output/ex2_basic.out
+
+   test:
+      suffix: basic_threads
+      nsize: 3
+      args: -sf_type basic -sf_basic_threads 2 -sf_view ::ascii_info -sf_view_reduced ::ascii_info
+      requires: define(PETSC_HAVE_OPENMP)
+
+   test:
+      suffix: neighbor
+      nsize: 3
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+      args: -sf_type neighbor -sf_view ::ascii_info -sf_view_reduced ::ascii_info
+
+   test:
+      suffix: shared
+      nsize: 3
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+      args: -sf_type shared -sf_view ::ascii_info -sf_view_reduced ::ascii_info
+
+   test:
+      suffix: twolevel
+      nsize: 3
+      requires: define(PETSC_HAVE_MPI_TYPE_DUP)
+      args: -sf_type twolevel -sf_twolevel_node_size 2 -sf_view ::ascii_info
+
+TEST*/
@@ -568,4 +568,119 @@ int main(int argc,char **argv)
       suffix: 9_char
       nsize: 4
       args: -sf_type basic -test_bcast -test_reduce -test_op max -test_char
+
+   test:
+      suffix: basic_nonpersistent
+      nsize: 4
+      args: -test_bcast -sf_type basic -sf_basic_persistent 0
+      output_file: output/ex1_1_basic.out
+
+   test:
+      suffix: 2_basic_nonpersistent
+      nsize: 4
+      args: -test_reduce -sf_type basic -sf_basic_persistent 0
+      output_file: output/ex1_2_basic.out
+
+   test:
+      suffix: neighbor
+      nsize: 4
+      args: -test_bcast -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 2_neighbor
+      nsize: 4
+      args: -test_reduce -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 4_neighbor
+      nsize: 4
+      args: -test_gather -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: bcastop_neighbor
+      nsize: 4
+      args: -test_bcastop -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 8_neighbor
+      nsize: 3
+      args: -test_bcast -test_sf_distribute -sf_type neighbor
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 9_char_neighbor
+      nsize: 4
+      args: -sf_type neighbor -test_bcast -test_reduce -test_op max -test_char
+      requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: shared
+      nsize: 4
+      args: -test_bcast -sf_type shared
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 2_shared
+      nsize: 4
+      args: -test_reduce -sf_type shared
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 2_noshared
+      nsize: 4
+      args: -test_reduce -sf_type shared -noshared
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+      output_file: output/ex1_2_shared.out
+
+   test:
+      suffix: 4_shared
+      nsize: 4
+      args: -test_gather -sf_type shared
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: bcastop_shared
+      nsize: 4
+      args: -test_bcastop -sf_type shared
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 8_shared
+      nsize: 3
+      args: -test_bcast -test_sf_distribute -sf_type shared
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: twolevel
+      nsize: 4
+      args: -test_bcast -sf_type twolevel -sf_twolevel_node_size 2
+      requires: define(PETSC_HAVE_MPI_TYPE_DUP)
+
+   test:
+      suffix: 2_twolevel
+      nsize: 4
+      args: -test_reduce -sf_type twolevel -sf_twolevel_node_size 2
+      requires: define(PETSC_HAVE_MPI_TYPE_DUP)
+
+   test:
+      suffix: 4_twolevel
+      nsize: 4
+      args: -test_gather -sf_type twolevel -sf_twolevel_node_size 2
+      requires: define(PETSC_HAVE_MPI_TYPE_DUP)
+
+   test:
+      suffix: bcastop_twolevel
+      nsize: 4
+      args: -test_bcastop -sf_type twolevel -sf_twolevel_node_size 2
+      requires: define(PETSC_HAVE_MPI_TYPE_DUP)
+
+   test:
+      suffix: 8_twolevel
+      nsize: 3
+      args: -test_bcast -test_sf_distribute -sf_type twolevel -sf_twolevel_node_size 2
+      requires: define(PETSC_HAVE_MPI_TYPE_DUP)
 TEST*/
@@ -0,0 +1,324 @@
+
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
+
+/*
+   PETSCSFNEIGHBOR uses the setup and the packing of PETSCSFBASIC, but communicates with all the neighbors at once
+   with MPI_Ineighbor_alltoallv() on two distributed graph communicators, one for each direction. The packed data
+   of all the ranks is stored contiguously, so the per-rank pointers root[] and leaf[] of the pack are used unchanged.
+*/
+typedef struct {
+  SFBASICHEADER;
+  MPI_Comm    comms[2];    /* Distributed graph communicators for PETSC_SF_LEAF2ROOT_REDUCE and PETSC_SF_ROOT2LEAF_BCAST */
+  PetscMPIInt *rootcounts; /* Number of units exchanged with each non-distinguished rank referencing my roots */
+  PetscMPIInt *rootdispls; /* Offsets of these in the non-distinguished part of the root buffer */
+  PetscMPIInt *leafcounts; /* Number of units exchanged with each non-distinguished rank owning roots of my leaves */
+  PetscMPIInt *leafdispls;
+} PetscSF_Neighbor;
+
+static PetscErrorCode PetscSFSetUp_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscInt         i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  const PetscInt   *rootoffset,*leafoffset;
+  PetscMPIInt      *rootranks,*leafranks,*rootweights,*leafweights,nrootneighbors,nleafneighbors,empty = 0;
+  MPI_Comm         comm;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSetUp_Basic(sf);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL);CHKERRQ(ierr);
+
+  /* The distinguished ranks (this process) communicate through the buffers, they are not neighbors */
+  ierr = PetscMalloc4(nrootranks-ndrootranks,&dat->rootcounts,nrootranks-ndrootranks,&dat->rootdispls,nleafranks-ndleafranks,&dat->leafcounts,nleafranks-ndleafranks,&dat->leafdispls);CHKERRQ(ierr);
+  for (i=ndrootranks; i<nrootranks; i++) {
+    ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&dat->rootcounts[i-ndrootranks]);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(rootoffset[i]-rootoffset[ndrootranks],&dat->rootdispls[i-ndrootranks]);CHKERRQ(ierr);
+  }
+  for (i=ndleafranks; i<nleafranks; i++) {
+    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&dat->leafcounts[i-ndleafranks]);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(leafoffset[i]-leafoffset[ndleafranks],&dat->leafdispls[i-ndleafranks]);CHKERRQ(ierr);
+  }
+
+  /* Roots receive from the leaf ranks in a reduction and send to them in a broadcast. The edges are weighted by the
+     message lengths instead of passing MPI_UNWEIGHTED, a sentinel pointer that compilers flag as reading past the end of
+     an object; a rank without neighbors in one direction passes a valid pointer to an empty array */
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(nrootranks-ndrootranks,&nrootneighbors);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(nleafranks-ndleafranks,&nleafneighbors);CHKERRQ(ierr);
+  rootranks   = nrootneighbors ? dat->iranks+ndrootranks : &empty;
+  leafranks   = nleafneighbors ? sf->ranks+ndleafranks : &empty;
+  rootweights = nrootneighbors ? dat->rootcounts : &empty;
+  leafweights = nleafneighbors ? dat->leafcounts : &empty;
+  ierr = MPI_Dist_graph_create_adjacent(comm,nrootneighbors,rootranks,rootweights,nleafneighbors,leafranks,leafweights,MPI_INFO_NULL,0,&dat->comms[PETSC_SF_LEAF2ROOT_REDUCE]);CHKERRQ(ierr);
+  ierr = MPI_Dist_graph_create_adjacent(comm,nleafneighbors,leafranks,leafweights,nrootneighbors,rootranks,rootweights,MPI_INFO_NULL,0,&dat->comms[PETSC_SF_ROOT2LEAF_BCAST]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFNeighborGetPack(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFBasicPack *mylink)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link,*p;
+  PetscInt         nrootranks,ndrootranks,nleafranks,ndleafranks,i;
+  const PetscInt   *rootoffset,*leafoffset;
+
+  PetscFunctionBegin;
+  /* Look for types in cache */
+  for (p=&dat->avail; (link=*p); p=&link->next) {
+    PetscBool match;
+    ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
+    if (match) {
+      *p = link->next;          /* Remove from available list */
+      goto found;
+    }
+  }
+
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscNew(&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackTypeSetup(link,unit);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nrootranks,&link->root,nleafranks,&link->leaf);CHKERRQ(ierr);
+  /* One request for reduce (leaf to root) and one for bcast (root to leaf) communication */
+  ierr = PetscMalloc1(2,&link->requests);CHKERRQ(ierr);
+  link->requests[PETSC_SF_LEAF2ROOT_REDUCE] = MPI_REQUEST_NULL;
+  link->requests[PETSC_SF_ROOT2LEAF_BCAST]  = MPI_REQUEST_NULL;
+
+  ierr = PetscMalloc(rootoffset[nrootranks]*link->unitbytes,&link->rootbuf);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) link->root[i] = link->rootbuf + rootoffset[i]*link->unitbytes;
+  ierr = PetscMalloc((leafoffset[nleafranks]-leafoffset[ndleafranks])*link->unitbytes,&link->leafbuf);CHKERRQ(ierr);
+  for (i=0; i<nleafranks; i++) {
+    if (i < ndleafranks) {      /* Leaf buffers for distinguished ranks are pointers directly into root buffers */
+      if (ndrootranks != 1) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Cannot match distinguished ranks");
+      link->leaf[i] = link->root[0];
+      continue;
+    }
+    link->leaf[i] = link->leafbuf + (leafoffset[i]-leafoffset[ndleafranks])*link->unitbytes;
+  }
+
+found:
+  link->key  = key;
+  link->next = dat->inuse;
+  dat->inuse = link;
+
+  *mylink = link;
+  PetscFunctionReturn(0);
+}
+
+/* Start the exchange between the non-distinguished parts of the packed root and leaf buffers */
+static PetscErrorCode PetscSFNeighborStart(PetscSF sf,PetscSFBasicPack link,MPI_Datatype unit,PetscSFDirection direction)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscInt         ndrootranks,ndleafranks;
+  const PetscInt   *rootoffset,*leafoffset;
+  char             *rootbuf,*leafbuf;
+
+  PetscFunctionBegin;
+  ierr    = PetscSFBasicGetRootInfo(sf,NULL,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr    = PetscSFBasicGetLeafInfo(sf,NULL,&ndleafranks,NULL,&leafoffset,NULL);CHKERRQ(ierr);
+  rootbuf = link->rootbuf + rootoffset[ndrootranks]*link->unitbytes;
+  leafbuf = link->leafbuf;
+  if (direction == PETSC_SF_LEAF2ROOT_REDUCE) {
+    ierr = MPI_Ineighbor_alltoallv(leafbuf,dat->leafcounts,dat->leafdispls,unit,rootbuf,dat->rootcounts,dat->rootdispls,unit,dat->comms[direction],&link->requests[direction]);CHKERRQ(ierr);
+  } else {
+    ierr = MPI_Ineighbor_alltoallv(rootbuf,dat->rootcounts,dat->rootdispls,unit,leafbuf,dat->leafcounts,dat->leafdispls,unit,dat->comms[direction],&link->requests[direction]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFNeighborWait(PetscSF sf,PetscSFBasicPack link,PetscSFDirection direction)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Wait(&link->requests[direction],MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link,next;
+  PetscInt         i;
+
+  PetscFunctionBegin;
+  if (dat->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
+  for (link=dat->avail; link; link=next) {
+    next = link->next;
+    if (!link->isbuiltin) {ierr = MPI_Type_free(&link->unit);CHKERRQ(ierr);}
+    ierr = PetscFree(link->rootbuf);CHKERRQ(ierr);
+    ierr = PetscFree(link->leafbuf);CHKERRQ(ierr);
+    ierr = PetscFree2(link->root,link->leaf);CHKERRQ(ierr);
+    ierr = PetscFree(link->requests);CHKERRQ(ierr);
+    ierr = PetscFree(link);CHKERRQ(ierr);
+  }
+  dat->avail = NULL;
+  for (i=0; i<2; i++) {
+    if (dat->comms[i] != MPI_COMM_NULL) {ierr = MPI_Comm_free(&dat->comms[i]);CHKERRQ(ierr);}
+  }
+  ierr = PetscFree4(dat->rootcounts,dat->rootdispls,dat->leafcounts,dat->leafdispls);CHKERRQ(ierr);
+  ierr = PetscSFReset_Basic(sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Neighbor(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Neighbor(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         i,nrootranks;
+  const PetscInt   *rootoffset,*rootloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFNeighborGetPack(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) PetscSFBasicPackData(link,&dat->rootpackopt[i],rootoffset[i+1]-rootoffset[i],rootloc+rootoffset[i],rootdata,link->root[i]);
+  ierr = PetscSFNeighborStart(sf,link,unit,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpEnd_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,rootdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFNeighborWait(sf,link,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
+  ierr = PetscSFBasicUnpackLeafData(sf,link,unit,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpBegin_Neighbor(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastEnd_Neighbor(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpEnd_Neighbor(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Neighbor(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         i,nleafranks;
+  const PetscInt   *leafoffset,*leafloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,NULL,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
+  ierr = PetscSFNeighborGetPack(sf,unit,leafdata,&link);CHKERRQ(ierr);
+  for (i=0; i<nleafranks; i++) PetscSFBasicPackData(link,&dat->leafpackopt[i],leafoffset[i+1]-leafoffset[i],leafloc+leafoffset[i],leafdata,link->leaf[i]);
+  ierr = PetscSFNeighborStart(sf,link,unit,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Neighbor(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFNeighborWait(sf,link,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
+  ierr = PetscSFBasicUnpackRootData(sf,link,unit,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpBegin_Neighbor(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceBegin_Neighbor(sf,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpEnd_Neighbor(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  void             (*FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+  PetscInt         i,nrootranks;
+  const PetscInt   *rootoffset,*rootloc;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFNeighborWait(sf,link,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
+  /* Process local fetch-and-op, then send the fetched values back to the leaves */
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackGetFetchAndOp(sf,link,op,&FetchAndOp);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) (*FetchAndOp)(rootoffset[i+1]-rootoffset[i],link->bs,rootloc+rootoffset[i],rootdata,link->root[i]);
+  ierr = PetscSFNeighborStart(sf,link,unit,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
+  ierr = PetscSFNeighborWait(sf,link,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
+  ierr = PetscSFBasicUnpackLeafData(sf,link,unit,leafupdate,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   PETSCSFNEIGHBOR - A PetscSF that communicates with MPI-3 neighborhood collectives
+
+   Notes:
+   The setup and the packing of the data are those of PETSCSFBASIC. PetscSFSetUp() creates two distributed graph
+   communicators with MPI_Dist_graph_create_adjacent(), one for each direction of the communication, and each broadcast
+   or reduction exchanges the packed data with all the neighbors in one MPI_Ineighbor_alltoallv(). This scales better
+   than the point to point messages of PETSCSFBASIC when a process has many neighbors.
+
+   Options Database Keys:
+.  -sf_type neighbor - use this implementation, also for the vector scatters of type VECSCATTERSF
+
+   Level: intermediate
+
+.seealso: PetscSFCreate(), PetscSFSetType(), PETSCSFBASIC, PETSCSFWINDOW
+M*/
+PETSC_EXTERN PetscErrorCode PetscSFCreate_Neighbor(PetscSF sf)
+{
+  PetscSF_Neighbor *dat;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  sf->ops->SetUp           = PetscSFSetUp_Neighbor;
+  sf->ops->Reset           = PetscSFReset_Neighbor;
+  sf->ops->Destroy         = PetscSFDestroy_Neighbor;
+  sf->ops->View            = PetscSFView_Basic;
+  sf->ops->BcastBegin      = PetscSFBcastBegin_Neighbor;
+  sf->ops->BcastEnd        = PetscSFBcastEnd_Neighbor;
+  sf->ops->BcastAndOpBegin = PetscSFBcastAndOpBegin_Neighbor;
+  sf->ops->BcastAndOpEnd   = PetscSFBcastAndOpEnd_Neighbor;
+  sf->ops->ReduceBegin     = PetscSFReduceBegin_Neighbor;
+  sf->ops->ReduceEnd       = PetscSFReduceEnd_Neighbor;
+  sf->ops->FetchAndOpBegin = PetscSFFetchAndOpBegin_Neighbor;
+  sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Neighbor;
+  sf->ops->GetLeafRanks    = PetscSFGetLeafRanks_Basic;
+
+  ierr = PetscNewLog(sf,&dat);CHKERRQ(ierr);
+  dat->comms[0] = MPI_COMM_NULL;
+  dat->comms[1] = MPI_COMM_NULL;
+  sf->data      = (void*)dat;
+  PetscFunctionReturn(0);
+}
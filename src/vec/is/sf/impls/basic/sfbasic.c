@@ -1,58 +1,8 @@
 
-#include <petsc/private/sfimpl.h> /*I "petscsf.h" I*/
-
-typedef struct _n_PetscSFBasicPack *PetscSFBasicPack;
-struct _n_PetscSFBasicPack {
-  void (*Pack)(PetscInt,PetscInt,const PetscInt*,const void*,void*);
-  void (*UnpackInsert)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackAdd)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMin)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMax)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMinloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
-  void (*UnpackMult)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackLXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*UnpackBXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
-  void (*FetchAndInsert)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndAdd)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMin)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMax)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMinloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndMult)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndLXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-  void (*FetchAndBXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
-
-  MPI_Datatype     unit;
-  PetscBool        isbuiltin;   /* Is unit an MPI builtin datatype? */
-  size_t           unitbytes;   /* Number of bytes in a unit */
-  PetscInt         bs;          /* Number of basic units in a unit */
-  const void       *key;        /* Array used as key for operation */
-  char             **root;      /* Packed root data, indexed by leaf rank */
-  char             **leaf;      /* Packed leaf data, indexed by root rank */
-  MPI_Request      *requests;   /* Array of root requests followed by leaf requests */
-  PetscSFBasicPack next;
-};
-
-typedef struct {
-  PetscMPIInt      tag;
-  PetscMPIInt      niranks;     /* Number of incoming ranks (ranks accessing my roots) */
-  PetscMPIInt      ndiranks;    /* Number of incoming ranks (ranks accessing my roots) in distinguished set */
-  PetscMPIInt      *iranks;     /* Array of ranks that reference my roots */
-  PetscInt         itotal;      /* Total number of graph edges referencing my roots */
-  PetscInt         *ioffset;    /* Array of length niranks+1 holding offset in irootloc[] for each rank */
-  PetscInt         *irootloc;   /* Incoming roots referenced by ranks starting at ioffset[rank] */
-  PetscSFBasicPack avail;       /* One or more entries per MPI Datatype, lazily constructed */
-  PetscSFBasicPack inuse;       /* Buffers being used for transactions that have not yet completed */
-} PetscSF_Basic;
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
 
 #if !defined(PETSC_HAVE_MPI_TYPE_DUP)
 PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype)
@@ -551,7 +501,202 @@ DEF_Block(char,6)
 DEF_Block(char,7)
 #endif
 
-static PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
+/* Find the layout (see PetscSFPackOpt) followed by the n indices of idx, checking every index */
+static PetscErrorCode PetscSFBasicDetectPattern(PetscInt n,const PetscInt *idx,PetscSFPackOpt *opt)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,start,dx,dy,dz,X,Z;
+
+  PetscFunctionBegin;
+  ierr = PetscMemzero(opt,sizeof(*opt));CHKERRQ(ierr);
+  opt->pattern = PETSCSF_PACK_GENERAL;
+  if (!n) PetscFunctionReturn(0);
+  start = idx[0];
+  for (dx=1; dx<n && idx[dx] == start+dx; dx++) ;
+  if (n % dx) PetscFunctionReturn(0);
+  X = (dx < n) ? idx[dx]-start : dx;
+  if (X <= 0) PetscFunctionReturn(0);
+  for (dy=1; dy*dx<n && idx[dy*dx] == start+dy*X; dy++) ;
+  if (n % (dx*dy)) PetscFunctionReturn(0);
+  dz = n/(dx*dy);
+  Z  = (dz > 1) ? idx[dx*dy]-start : dy*X;
+  if (Z <= 0) PetscFunctionReturn(0);
+  for (k=0; k<dz; k++) {
+    for (j=0; j<dy; j++) {
+      for (i=0; i<dx; i++) {
+        if (idx[(k*dy+j)*dx+i] != start+i+j*X+k*Z) PetscFunctionReturn(0);
+      }
+    }
+  }
+  if (dx == n)                 opt->pattern = PETSCSF_PACK_CONTIGUOUS;
+  else if (dx == 1 && dz == 1) opt->pattern = PETSCSF_PACK_STRIDED;
+  else                         opt->pattern = PETSCSF_PACK_BOX;
+  opt->start = start;
+  opt->dx    = dx;
+  opt->dy    = dy;
+  opt->dz    = dz;
+  opt->X     = X;
+  opt->Z     = Z;
+  PetscFunctionReturn(0);
+}
+
+/* Copy the units of the layout opt from data to the packed buffer buf (pack) or back (unpack with replacement), in the
+   order of the indices. Rows of a few units are copied with a memcpy() of constant size the compiler can inline. */
+#define PetscSFBasicCopyRows(rowbytes) do {                                         \
+    for (k=0; k<opt->dz; k++) {                                                     \
+      char *u = data + (opt->start+k*opt->Z)*unitbytes;                             \
+      for (j=0; j<opt->dy; j++,u+=opt->X*unitbytes,buf+=(rowbytes)) {               \
+        if (pack) memcpy(buf,u,(rowbytes));                                         \
+        else      memcpy(u,buf,(rowbytes));                                         \
+      }                                                                             \
+    }                                                                               \
+  } while (0)
+
+static void PetscSFBasicCopyLayout(const PetscSFPackOpt *opt,size_t unitbytes,char *data,char *buf,PetscBool pack)
+{
+  const size_t rowbytes = opt->dx*unitbytes;
+  PetscInt     j,k;
+
+  if (opt->pattern == PETSCSF_PACK_CONTIGUOUS) {
+    if (pack) memcpy(buf,data+opt->start*unitbytes,rowbytes);
+    else      memcpy(data+opt->start*unitbytes,buf,rowbytes);
+  } else if (rowbytes == 4)  PetscSFBasicCopyRows(4);
+  else if   (rowbytes == 8)  PetscSFBasicCopyRows(8);
+  else if   (rowbytes == 16) PetscSFBasicCopyRows(16);
+  else                       PetscSFBasicCopyRows(rowbytes);
+}
+
+/*
+   Sort the incoming entries of each rank by color, such that the entries of one color have distinct roots, so that the
+   reductions with MPI_SUM can be unpacked without conflicts. The color of an entry is the number of entries before it
+   with the same root, within its rank, or among all the ranks when several threads unpack different ranks at once.
+   Rank i has icolorstart[i+1]-icolorstart[i]-1 colors, at most as many as its entries, whose offsets are stored from
+   icoloroffset[icolorstart[i]]; ncolors is the largest of these numbers, usually 1 for a single thread. The colors are
+   only needed by the reductions of PetscScalar with MPI_SUM, so they are computed by the first one.
+*/
+static PetscErrorCode PetscSFBasicSetUpColors(PetscSF sf)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+  PetscInt       i,j,c,nc,nci,maxroot = -1,*count,*color,*offset;
+
+  PetscFunctionBegin;
+  /* some callers pass a number of roots smaller than the root indices used, so size count by the largest root index */
+  for (j=0; j<bas->itotal; j++) maxroot = PetscMax(maxroot,bas->irootloc[j]);
+  ierr = PetscCalloc1(maxroot+1,&count);CHKERRQ(ierr);
+  ierr = PetscMalloc1(bas->itotal,&color);CHKERRQ(ierr);
+  ierr = PetscMalloc1(bas->niranks+1,&bas->icolorstart);CHKERRQ(ierr);
+  bas->icolorstart[0] = 0;
+  for (i=0,nc=0; i<bas->niranks; i++) {
+    for (j=bas->ioffset[i],nci=0; j<bas->ioffset[i+1]; j++) {
+      color[j] = count[bas->irootloc[j]]++;
+      nci      = PetscMax(nci,color[j]+1);
+    }
+    if (bas->nthreads < 2) {
+      for (j=bas->ioffset[i]; j<bas->ioffset[i+1]; j++) count[bas->irootloc[j]] = 0;
+    }
+    bas->icolorstart[i+1] = bas->icolorstart[i]+nci+1;
+    nc = PetscMax(nc,nci);
+  }
+  ierr = PetscFree(count);CHKERRQ(ierr);
+  bas->icolorthreads = (bas->nthreads > 1) ? PETSC_TRUE : PETSC_FALSE;
+
+  bas->ncolors = nc;
+  ierr = PetscMalloc1(bas->icolorstart[bas->niranks],&bas->icoloroffset);CHKERRQ(ierr);
+  for (i=0; i<bas->niranks; i++) {
+    offset = bas->icoloroffset+bas->icolorstart[i];
+    nci    = bas->icolorstart[i+1]-bas->icolorstart[i]-1;
+    ierr   = PetscMemzero(offset,(nci+1)*sizeof(PetscInt));CHKERRQ(ierr);
+    for (j=bas->ioffset[i]; j<bas->ioffset[i+1]; j++) offset[color[j]+1]++;
+    offset[0] = bas->ioffset[i];
+    for (c=0; c<nci; c++) offset[c+1] += offset[c];
+  }
+  if (nc > 1) {
+    ierr = PetscMalloc2(bas->itotal,&bas->icolorperm,bas->itotal,&bas->icolorloc);CHKERRQ(ierr);
+    for (i=0; i<bas->niranks; i++) {
+      offset = bas->icoloroffset+bas->icolorstart[i];
+      nci    = bas->icolorstart[i+1]-bas->icolorstart[i]-1;
+      for (j=bas->ioffset[i]; j<bas->ioffset[i+1]; j++) {
+        PetscInt k = offset[color[j]]++;
+        bas->icolorperm[k] = j-bas->ioffset[i];
+        bas->icolorloc[k]  = bas->irootloc[j];
+      }
+      for (c=nci; c>0; c--) offset[c] = offset[c-1];
+      offset[0] = bas->ioffset[i];
+    }
+  }
+  ierr = PetscFree(color);CHKERRQ(ierr);
+  bas->icolorsetup = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/* Add the entries of color c of rank i of the root buffers to rootdata, if tid >= 0 as thread tid of nth */
+PETSC_STATIC_INLINE void PetscSFBasicUnpackAddColor(PetscSF_Basic *bas,PetscSFBasicPack link,PetscInt i,PetscInt c,PetscInt tid,PetscInt nth,PetscScalar *u)
+{
+  const PetscInt    *offset = bas->icoloroffset+bas->icolorstart[i];
+  const PetscScalar *p = (const PetscScalar*)link->root[i];
+  PetscInt          k,start,end;
+
+  if (c >= bas->icolorstart[i+1]-bas->icolorstart[i]-1) return;
+  start = offset[c];
+  end   = offset[c+1];
+  if (tid >= 0) {
+    PetscInt n = end-start;
+    end   = start+(PetscInt)((PetscInt64)n*(tid+1)/nth);
+    start = start+(PetscInt)((PetscInt64)n*tid/nth);
+  }
+  if (bas->icolorperm) {
+    const PetscInt *perm = bas->icolorperm,*loc = bas->icolorloc;
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp simd
+#endif
+    for (k=start; k<end; k++) u[loc[k]] += p[perm[k]];
+  } else {
+    const PetscInt *loc = bas->irootloc,base = bas->ioffset[i];
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp simd
+#endif
+    for (k=start; k<end; k++) u[loc[k]] += p[k-base];
+  }
+}
+
+/* Unpack the root buffers of all the ranks into rootdata with MPI_SUM for PetscScalar, one color after the other */
+static PetscErrorCode PetscSFBasicUnpackAddColored(PetscSF sf,PetscSFBasicPack link,PetscScalar *rootdata)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+  PetscInt       i,c;
+
+  PetscFunctionBegin;
+  if (!bas->icolorsetup) {ierr = PetscSFBasicSetUpColors(sf);CHKERRQ(ierr);}
+#if defined(PETSC_HAVE_OPENMP)
+  if (bas->icolorthreads && bas->nthreads > 1 && bas->itotal >= 1024*bas->nthreads) {
+#pragma omp parallel num_threads(bas->nthreads)
+    {
+      PetscInt tid = omp_get_thread_num(),nth = omp_get_num_threads(),ti,tc;
+
+      for (tc=0; tc<bas->ncolors; tc++) {
+        for (ti=0; ti<bas->niranks; ti++) PetscSFBasicUnpackAddColor(bas,link,ti,tc,tid,nth,rootdata);
+#pragma omp barrier
+      }
+    }
+    PetscFunctionReturn(0);
+  }
+#endif
+  for (c=0; c<bas->ncolors; c++) {
+    for (i=0; i<bas->niranks; i++) PetscSFBasicUnpackAddColor(bas,link,i,c,-1,1,rootdata);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Pack the n units of data indexed by idx into buf; opt, if not NULL, is the layout of idx */
+void PetscSFBasicPackData(PetscSFBasicPack link,const PetscSFPackOpt *opt,PetscInt n,const PetscInt *idx,const void *data,void *buf)
+{
+  if (opt && opt->pattern != PETSCSF_PACK_GENERAL) PetscSFBasicCopyLayout(opt,link->unitbytes,(char*)data,(char*)buf,PETSC_TRUE);
+  else (*link->Pack)(n,link->bs,idx,data,buf);
+}
+
+PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode ierr;
@@ -628,10 +773,15 @@ static PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
   }
   ierr = MPI_Waitall(nreqs,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
   ierr = PetscFree(reqs);CHKERRQ(ierr);
+
+  /* Detect contiguous, strided and 3D box layouts of the roots and leaves of each rank, packed with copies of rows */
+  ierr = PetscMalloc2(bas->niranks,&bas->rootpackopt,sf->nranks,&bas->leafpackopt);CHKERRQ(ierr);
+  for (i=0; i<bas->niranks; i++) {ierr = PetscSFBasicDetectPattern(bas->ioffset[i+1]-bas->ioffset[i],bas->irootloc+bas->ioffset[i],&bas->rootpackopt[i]);CHKERRQ(ierr);}
+  for (i=0; i<sf->nranks; i++) {ierr = PetscSFBasicDetectPattern(sf->roffset[i+1]-sf->roffset[i],sf->rmine+sf->roffset[i],&bas->leafpackopt[i]);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicPackTypeSetup(PetscSFBasicPack link,MPI_Datatype unit)
+PetscErrorCode PetscSFBasicPackTypeSetup(PetscSFBasicPack link,MPI_Datatype unit)
 {
   PetscErrorCode ierr;
   PetscBool      isInt,isPetscInt,isPetscReal,is2Int,is2PetscInt,isSignedChar,isUnsignedChar;
@@ -754,7 +904,7 @@ static PetscErrorCode PetscSFBasicPackGetUnpackOp(PetscSF sf,PetscSFBasicPack li
   else *UnpackOp = NULL;
   PetscFunctionReturn(0);
 }
-static PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*))
+PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack link,MPI_Op op,void (**FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*))
 {
   PetscFunctionBegin;
   *FetchAndOp = NULL;
@@ -775,8 +925,6 @@ static PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF sf,PetscSFBasicPack
   PetscFunctionReturn(0);
 }
 
-typedef enum {PETSC_SF_LEAF2ROOT_REDUCE, PETSC_SF_ROOT2LEAF_BCAST} PetscSFDirection;
-
 static PetscErrorCode PetscSFBasicPackGetReqs(PetscSF sf,PetscSFBasicPack link,PetscSFDirection direction,MPI_Request **rootreqs,MPI_Request **leafreqs)
 {
   PetscSF_Basic *bas   = (PetscSF_Basic*)sf->data;
@@ -799,7 +947,70 @@ static PetscErrorCode PetscSFBasicPackWaitall(PetscSF sf,PetscSFBasicPack link,P
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,PetscInt *ndrootranks,const PetscMPIInt **rootranks,const PetscInt **rootoffset,const PetscInt **rootloc)
+/* Post the receives from all non-distinguished ranks, into the root buffers for a reduction and into the leaf buffers for a broadcast */
+static PetscErrorCode PetscSFBasicPackStartRecvs(PetscSF sf,PetscSFBasicPack link,MPI_Datatype unit,PetscSFDirection direction)
+{
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode    ierr;
+  PetscInt          i,nranks,ndranks;
+  const PetscInt    *offset;
+  const PetscMPIInt *ranks;
+  char              **buf;
+  MPI_Request       *reqs;
+  PetscMPIInt       n;
+
+  PetscFunctionBegin;
+  if (direction == PETSC_SF_LEAF2ROOT_REDUCE) {
+    ierr = PetscSFBasicGetRootInfo(sf,&nranks,&ndranks,&ranks,&offset,NULL);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackGetReqs(sf,link,direction,&reqs,NULL);CHKERRQ(ierr);
+    buf  = link->root;
+  } else {
+    ierr = PetscSFBasicGetLeafInfo(sf,&nranks,&ndranks,&ranks,&offset,NULL);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackGetReqs(sf,link,direction,NULL,&reqs);CHKERRQ(ierr);
+    buf  = link->leaf;
+  }
+  if (link->persistent) {
+    ierr = PetscMPIIntCast(offset[nranks]-offset[ndranks],&n);CHKERRQ(ierr);
+    ierr = MPI_Startall_irecv(n,unit,nranks-ndranks,reqs);CHKERRQ(ierr);
+  } else {
+    for (i=ndranks; i<nranks; i++) {
+      ierr = PetscMPIIntCast(offset[i+1]-offset[i],&n);CHKERRQ(ierr);
+      ierr = MPI_Irecv(buf[i],n,unit,ranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&reqs[i-ndranks]);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Send the n packed units of the non-distinguished rank i, from its root buffer for a broadcast and from its leaf buffer for a reduction,
+   or from buf with a nonpersistent request if buf is not NULL */
+static PetscErrorCode PetscSFBasicPackStartSend(PetscSF sf,PetscSFBasicPack link,MPI_Datatype unit,PetscSFDirection direction,PetscInt i,PetscMPIInt n,const void *buf)
+{
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode    ierr;
+  PetscInt          ndranks;
+  const PetscMPIInt *ranks;
+  char              **packbuf;
+  MPI_Request       *reqs;
+
+  PetscFunctionBegin;
+  if (direction == PETSC_SF_ROOT2LEAF_BCAST) {
+    ierr = PetscSFBasicGetRootInfo(sf,NULL,&ndranks,&ranks,NULL,NULL);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackGetReqs(sf,link,direction,&reqs,NULL);CHKERRQ(ierr);
+    packbuf = link->root;
+  } else {
+    ierr = PetscSFBasicGetLeafInfo(sf,NULL,&ndranks,&ranks,NULL,NULL);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackGetReqs(sf,link,direction,NULL,&reqs);CHKERRQ(ierr);
+    packbuf = link->leaf;
+  }
+  if (link->persistent && !buf) {
+    ierr = MPI_Start_isend(n,unit,&reqs[i-ndranks]);CHKERRQ(ierr);
+  } else {
+    ierr = MPI_Isend(buf ? (void*)buf : packbuf[i],n,unit,ranks[i],bas->tag,PetscObjectComm((PetscObject)sf),&reqs[i-ndranks]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,PetscInt *ndrootranks,const PetscMPIInt **rootranks,const PetscInt **rootoffset,const PetscInt **rootloc)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
@@ -812,7 +1023,7 @@ static PetscErrorCode PetscSFBasicGetRootInfo(PetscSF sf,PetscInt *nrootranks,Pe
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,PetscInt *ndleafranks,const PetscMPIInt **leafranks,const PetscInt **leafoffset,const PetscInt **leafloc)
+PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF sf,PetscInt *nleafranks,PetscInt *ndleafranks,const PetscMPIInt **leafranks,const PetscInt **leafoffset,const PetscInt **leafloc)
 {
   PetscFunctionBegin;
   if (nleafranks)  *nleafranks  = sf->nranks;
@@ -851,6 +1062,7 @@ static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const voi
   ierr = PetscNew(&link);CHKERRQ(ierr);
   ierr = PetscSFBasicPackTypeSetup(link,unit);CHKERRQ(ierr);
   ierr = PetscMalloc2(nrootranks,&link->root,nleafranks,&link->leaf);CHKERRQ(ierr);
+  link->persistent = bas->persistent;
   /* Double the requests. First half are used for reduce (leaf to root) communication, second half for bcast (root to leaf) communication */
   half     = nrootranks + nleafranks;
   ierr     = PetscCalloc1(half*2,&link->requests);CHKERRQ(ierr);
@@ -861,10 +1073,12 @@ static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const voi
   /* Allocate buffer and then init the persistent communcation */
   for (i=0; i<nrootranks; i++) {
     ierr = PetscMalloc((rootoffset[i+1]-rootoffset[i])*link->unitbytes,&link->root[i]);CHKERRQ(ierr);
-    if (i >= ndrootranks) {
+    if (i >= ndrootranks && link->persistent) {
       ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
       ierr = MPI_Recv_init(link->root[i],n,unit,bas->iranks[i],bas->tag,comm,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);      /* reduce */
-      ierr = MPI_Send_init(link->root[i],n,unit,bas->iranks[i],bas->tag,comm,&rootreqs[i-ndrootranks+half]);CHKERRQ(ierr); /* bcast  */
+      /* Contiguous roots are sent directly from rootdata, see PetscSFBcastAndOpBegin_Basic() */
+      if (bas->rootpackopt[i].pattern == PETSCSF_PACK_CONTIGUOUS) rootreqs[i-ndrootranks+half] = MPI_REQUEST_NULL;
+      else {ierr = MPI_Send_init(link->root[i],n,unit,bas->iranks[i],bas->tag,comm,&rootreqs[i-ndrootranks+half]);CHKERRQ(ierr);} /* bcast  */
     }
   }
   for (i=0; i<nleafranks; i++) {
@@ -874,8 +1088,10 @@ static PetscErrorCode PetscSFBasicGetPack(PetscSF sf,MPI_Datatype unit,const voi
       continue;
     }
     ierr = PetscMalloc((leafoffset[i+1]-leafoffset[i])*link->unitbytes,&link->leaf[i]);CHKERRQ(ierr);
+    if (!link->persistent) continue;
     ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
-    ierr = MPI_Send_init(link->leaf[i],n,unit,sf->ranks[i],bas->tag,comm,&leafreqs[i-ndleafranks]);CHKERRQ(ierr);      /* reduce */
+    if (bas->leafpackopt[i].pattern == PETSCSF_PACK_CONTIGUOUS) leafreqs[i-ndleafranks] = MPI_REQUEST_NULL; /* sent directly from leafdata */
+    else {ierr = MPI_Send_init(link->leaf[i],n,unit,sf->ranks[i],bas->tag,comm,&leafreqs[i-ndleafranks]);CHKERRQ(ierr);} /* reduce */
     ierr = MPI_Recv_init(link->leaf[i],n,unit,sf->ranks[i],bas->tag,comm,&leafreqs[i-ndleafranks+half]);CHKERRQ(ierr); /* bcast  */
   }
 
@@ -888,7 +1104,7 @@ found:
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicGetPackInUse(PetscSF sf,MPI_Datatype unit,const void *key,PetscCopyMode cmode,PetscSFBasicPack *mylink)
+PetscErrorCode PetscSFBasicGetPackInUse(PetscSF sf,MPI_Datatype unit,const void *key,PetscCopyMode cmode,PetscSFBasicPack *mylink)
 {
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
@@ -913,7 +1129,7 @@ static PetscErrorCode PetscSFBasicGetPackInUse(PetscSF sf,MPI_Datatype unit,cons
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFBasicReclaimPack(PetscSF sf,PetscSFBasicPack *link)
+PetscErrorCode PetscSFBasicReclaimPack(PetscSF sf,PetscSFBasicPack *link)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
@@ -927,15 +1143,27 @@ static PetscErrorCode PetscSFBasicReclaimPack(PetscSF sf,PetscSFBasicPack *link)
 
 static PetscErrorCode PetscSFSetFromOptions_Basic(PetscOptionItems *PetscOptionsObject,PetscSF sf)
 {
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Basic options");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-sf_basic_persistent","Use persistent requests, created once per unit type and restarted by each communication","PetscSFSetFromOptions",bas->persistent,&bas->persistent,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-sf_basic_threads","Number of OpenMP threads unpacking the reductions of PetscScalar with MPI_SUM, 0 for omp_get_max_threads()","PetscSFSetFromOptions",bas->nthreads,&bas->nthreads,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
+  if (bas->nthreads < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D cannot be negative",bas->nthreads);
+#if defined(PETSC_HAVE_OPENMP)
+  if (!bas->nthreads) bas->nthreads = omp_get_max_threads();
+#else
+  if (bas->nthreads != 1) {
+    ierr          = PetscInfo(sf,"Ignoring -sf_basic_threads since PETSc was not configured with OpenMP\n");CHKERRQ(ierr);
+    bas->nthreads = 1;
+  }
+#endif
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFReset_Basic(PetscSF sf)
+PetscErrorCode PetscSFReset_Basic(PetscSF sf)
 {
   PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
@@ -945,6 +1173,11 @@ static PetscErrorCode PetscSFReset_Basic(PetscSF sf)
   if (bas->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
   ierr = PetscFree2(bas->iranks,bas->ioffset);CHKERRQ(ierr);
   ierr = PetscFree(bas->irootloc);CHKERRQ(ierr);
+  ierr = PetscFree2(bas->rootpackopt,bas->leafpackopt);CHKERRQ(ierr);
+  ierr = PetscFree(bas->icolorstart);CHKERRQ(ierr);
+  ierr = PetscFree(bas->icoloroffset);CHKERRQ(ierr);
+  ierr = PetscFree2(bas->icolorperm,bas->icolorloc);CHKERRQ(ierr);
+  bas->icolorsetup = PETSC_FALSE;
   for (link=bas->avail; link; link=next) {
     PetscInt i;
     next = link->next;
@@ -952,10 +1185,10 @@ static PetscErrorCode PetscSFReset_Basic(PetscSF sf)
     for (i=0; i<bas->niranks; i++) {ierr = PetscFree(link->root[i]);CHKERRQ(ierr);}
     for (i=sf->ndranks; i<sf->nranks; i++) {ierr = PetscFree(link->leaf[i]);CHKERRQ(ierr);} /* Free only non-distinguished leaf buffers */
     ierr = PetscFree2(link->root,link->leaf);CHKERRQ(ierr);
-    /* Free persistent requests using MPI_Request_free */
-    for (i=0; i<sf->nranks+bas->niranks-(sf->ndranks+bas->ndiranks); i++) {
-      ierr = MPI_Request_free(&link->requests[i]);CHKERRQ(ierr); /* used in reduce */
-      ierr = MPI_Request_free(&link->requests[sf->nranks+bas->niranks+i]);CHKERRQ(ierr); /* used in bcast */
+    /* Free persistent requests using MPI_Request_free; the sends of contiguous data have none */
+    for (i=0; link->persistent && i<sf->nranks+bas->niranks-(sf->ndranks+bas->ndiranks); i++) {
+      if (link->requests[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->requests[i]);CHKERRQ(ierr);} /* used in reduce */
+      if (link->requests[sf->nranks+bas->niranks+i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->requests[sf->nranks+bas->niranks+i]);CHKERRQ(ierr);} /* used in bcast */
     }
     ierr = PetscFree(link->requests);CHKERRQ(ierr);
     ierr = PetscFree(link);CHKERRQ(ierr);
@@ -974,63 +1207,102 @@ static PetscErrorCode PetscSFDestroy_Basic(PetscSF sf)
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
+static PetscErrorCode PetscSFBasicViewPattern(PetscViewer viewer,PetscMPIInt rank,const char *what,PetscMPIInt remote,PetscInt n,const PetscSFPackOpt *opt)
 {
-  /* PetscSF_Basic *bas = (PetscSF_Basic*)sf->data; */
   PetscErrorCode ierr;
-  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  switch (opt->pattern) {
+  case PETSCSF_PACK_GENERAL:
+    ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] %s rank %d: %D general\n",rank,what,remote,n);CHKERRQ(ierr);
+    break;
+  case PETSCSF_PACK_CONTIGUOUS:
+    ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] %s rank %d: %D contiguous from %D\n",rank,what,remote,n,opt->start);CHKERRQ(ierr);
+    break;
+  case PETSCSF_PACK_STRIDED:
+    ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] %s rank %d: %D strided from %D by %D\n",rank,what,remote,n,opt->start,opt->X);CHKERRQ(ierr);
+    break;
+  case PETSCSF_PACK_BOX:
+    ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] %s rank %d: %D box %Dx%Dx%D from %D with row stride %D, plane stride %D\n",rank,what,remote,n,opt->dx,opt->dy,opt->dz,opt->start,opt->X,opt->Z);CHKERRQ(ierr);
+    break;
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
+{
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode    ierr;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+  PetscMPIInt       rank;
+  PetscInt          i;
 
   PetscFunctionBegin;
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
   if (iascii) {
     ierr = PetscViewerASCIIPrintf(viewer,"  sort=%s\n",sf->rankorder ? "rank-order" : "unordered");CHKERRQ(ierr);
+    ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+    if (format == PETSC_VIEWER_ASCII_INFO && sf->setupcalled) {
+      /* Layouts of the packed data, rows of contiguous, strided and box layouts are copied without an index list */
+      ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)sf),&rank);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+      for (i=0; i<bas->niranks; i++) {ierr = PetscSFBasicViewPattern(viewer,rank,"Roots for",bas->iranks[i],bas->ioffset[i+1]-bas->ioffset[i],&bas->rootpackopt[i]);CHKERRQ(ierr);}
+      for (i=0; i<sf->nranks; i++) {ierr = PetscSFBasicViewPattern(viewer,rank,"Leaves from",sf->ranks[i],sf->roffset[i+1]-sf->roffset[i],&bas->leafpackopt[i]);CHKERRQ(ierr);}
+      if (bas->icolorsetup) {
+        ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] Reductions with MPI_SUM unpacked in %D conflict-free colors by %D threads\n",rank,bas->ncolors,PetscMax(bas->nthreads,1));CHKERRQ(ierr);
+      } else {
+        ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] Reductions with MPI_SUM unpacked in conflict-free colors by %D threads, computed by the first one\n",rank,PetscMax(bas->nthreads,1));CHKERRQ(ierr);
+      }
+      ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+    }
   }
   PetscFunctionReturn(0);
 }
 
 static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
 {
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode    ierr;
   PetscSFBasicPack  link;
-  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
-  const PetscInt    *rootoffset,*leafoffset,*rootloc,*leafloc;
-  const PetscMPIInt *rootranks,*leafranks;
-  MPI_Request       *rootreqs,*leafreqs;
+  PetscInt          i,nrootranks,ndrootranks;
+  const PetscInt    *rootoffset,*rootloc;
   PetscMPIInt       n;
 
   PetscFunctionBegin;
-  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
-  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
   ierr = PetscSFBasicGetPack(sf,unit,rootdata,&link);CHKERRQ(ierr);
 
-  ierr = PetscSFBasicPackGetReqs(sf,link,PETSC_SF_ROOT2LEAF_BCAST,&rootreqs,&leafreqs);CHKERRQ(ierr);
   /* Eagerly post leaf receives, but only from non-distinguished ranks -- distinguished ranks will receive via shared memory */
-  ierr = PetscMPIIntCast(leafoffset[nleafranks]-leafoffset[ndleafranks],&n);CHKERRQ(ierr);
-  ierr = MPI_Startall_irecv(n,unit,nleafranks-ndleafranks,leafreqs);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackStartRecvs(sf,link,unit,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
 
-  /* Pack and send root data */
+  /* Pack and send root data, contiguous roots of non-distinguished ranks are sent without packing */
   for (i=0; i<nrootranks; i++) {
     void *packstart = link->root[i];
     ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
-    (*link->Pack)(n,link->bs,rootloc+rootoffset[i],rootdata,packstart);
+    if (i >= ndrootranks && bas->rootpackopt[i].pattern == PETSCSF_PACK_CONTIGUOUS) {
+      ierr = PetscSFBasicPackStartSend(sf,link,unit,PETSC_SF_ROOT2LEAF_BCAST,i,n,(const char*)rootdata+bas->rootpackopt[i].start*link->unitbytes);CHKERRQ(ierr);
+      continue;
+    }
+    PetscSFBasicPackData(link,&bas->rootpackopt[i],n,rootloc+rootoffset[i],rootdata,packstart);
     if (i < ndrootranks) continue; /* shared memory */
-    ierr = MPI_Start_isend(n,unit,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackStartSend(sf,link,unit,PETSC_SF_ROOT2LEAF_BCAST,i,n,NULL);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+/* Unpack the leaf buffers of all the ranks into leafdata with op */
+PetscErrorCode PetscSFBasicUnpackLeafData(PetscSF sf,PetscSFBasicPack link,MPI_Datatype unit,void *leafdata,MPI_Op op)
 {
+  PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   PetscErrorCode   ierr;
-  PetscSFBasicPack link;
   PetscInt         i,nleafranks,ndleafranks;
   const PetscInt   *leafoffset,*leafloc;
   void             (*UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
   PetscMPIInt      typesize = -1;
 
   PetscFunctionBegin;
-  ierr = PetscSFBasicGetPackInUse(sf,unit,rootdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
-  ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
   ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
   ierr = PetscSFBasicPackGetUnpackOp(sf,link,op,&UnpackOp);CHKERRQ(ierr);
 
@@ -1040,7 +1312,8 @@ PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const voi
   for (i=0; i<nleafranks; i++) {
     PetscMPIInt n   = leafoffset[i+1] - leafoffset[i];
     char *packstart = (char *) link->leaf[i];
-    if (UnpackOp) { (*UnpackOp)(n,link->bs,leafloc+leafoffset[i],leafdata,(const void *)packstart); }
+    if (UnpackOp == link->UnpackInsert && bas->leafpackopt[i].pattern != PETSCSF_PACK_GENERAL) PetscSFBasicCopyLayout(&bas->leafpackopt[i],link->unitbytes,(char*)leafdata,packstart,PETSC_FALSE);
+    else if (UnpackOp) { (*UnpackOp)(n,link->bs,leafloc+leafoffset[i],leafdata,(const void *)packstart); }
 #if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
     else if (n) { /* the op should be defined to operate on the whole datatype, so we ignore link->bs */
       PetscInt j;
@@ -1050,7 +1323,18 @@ PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const voi
     else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
 #endif
   }
+  PetscFunctionReturn(0);
+}
 
+PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,rootdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
+  ierr = PetscSFBasicUnpackLeafData(sf,link,unit,leafdata,op);CHKERRQ(ierr);
   ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1077,49 +1361,51 @@ PetscErrorCode PetscSFBcastEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *ro
 /* leaf -> root with reduction */
 PetscErrorCode PetscSFReduceBegin_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
 {
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
   PetscSFBasicPack  link;
   PetscErrorCode    ierr;
-  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
-  const PetscInt    *rootoffset,*leafoffset,*rootloc,*leafloc;
-  const PetscMPIInt *rootranks,*leafranks;
-  MPI_Request       *rootreqs,*leafreqs;
+  PetscInt          i,nleafranks,ndleafranks;
+  const PetscInt    *leafoffset,*leafloc;
   PetscMPIInt       n;
 
   PetscFunctionBegin;
-  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
-  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
   ierr = PetscSFBasicGetPack(sf,unit,leafdata,&link);CHKERRQ(ierr);
 
-  ierr = PetscSFBasicPackGetReqs(sf,link,PETSC_SF_LEAF2ROOT_REDUCE,&rootreqs,&leafreqs);CHKERRQ(ierr);
   /* Eagerly post root receives for non-distinguished ranks */
-  ierr = PetscMPIIntCast(rootoffset[nrootranks]-rootoffset[ndrootranks],&n);CHKERRQ(ierr);
-  ierr = MPI_Startall_irecv(n,unit,nrootranks-ndrootranks,rootreqs);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackStartRecvs(sf,link,unit,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
 
-  /* Pack and send leaf data */
+  /* Pack and send leaf data, contiguous leaves of non-distinguished ranks are sent without packing */
   for (i=0; i<nleafranks; i++) {
     void *packstart = link->leaf[i];
     ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
-    (*link->Pack)(n,link->bs,leafloc+leafoffset[i],leafdata,packstart);
+    if (i >= ndleafranks && bas->leafpackopt[i].pattern == PETSCSF_PACK_CONTIGUOUS) {
+      ierr = PetscSFBasicPackStartSend(sf,link,unit,PETSC_SF_LEAF2ROOT_REDUCE,i,n,(const char*)leafdata+bas->leafpackopt[i].start*link->unitbytes);CHKERRQ(ierr);
+      continue;
+    }
+    PetscSFBasicPackData(link,&bas->leafpackopt[i],n,leafloc+leafoffset[i],leafdata,packstart);
     if (i < ndleafranks) continue; /* shared memory */
-    ierr = MPI_Start_isend(n,unit,&leafreqs[i-ndleafranks]);CHKERRQ(ierr);
+    ierr = PetscSFBasicPackStartSend(sf,link,unit,PETSC_SF_LEAF2ROOT_REDUCE,i,n,NULL);CHKERRQ(ierr);
   }
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+/* Unpack the root buffers of all the ranks into rootdata with op */
+PetscErrorCode PetscSFBasicUnpackRootData(PetscSF sf,PetscSFBasicPack link,MPI_Datatype unit,void *rootdata,MPI_Op op)
 {
+  PetscSF_Basic    *bas = (PetscSF_Basic*)sf->data;
   void             (*UnpackOp)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
   PetscErrorCode   ierr;
-  PetscSFBasicPack link;
   PetscInt         i,nrootranks;
   PetscMPIInt      typesize = -1;
   const PetscInt   *rootoffset,*rootloc;
 
   PetscFunctionBegin;
-  ierr = PetscSFBasicGetPackInUse(sf,unit,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
-  /* This implementation could be changed to unpack as receives arrive, at the cost of non-determinism */
-  ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
   ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  if ((op == MPI_SUM || op == MPIU_SUM) && link->isbuiltin && link->unit == MPIU_SCALAR) {
+    ierr = PetscSFBasicUnpackAddColored(sf,link,(PetscScalar*)rootdata);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscSFBasicPackGetUnpackOp(sf,link,op,&UnpackOp);CHKERRQ(ierr);
   if (UnpackOp) {
     typesize = link->unitbytes;
@@ -1131,7 +1417,9 @@ static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const
     PetscMPIInt n   = rootoffset[i+1] - rootoffset[i];
     char *packstart = (char *) link->root[i];
 
-    if (UnpackOp) {
+    if (UnpackOp == link->UnpackInsert && bas->rootpackopt[i].pattern != PETSCSF_PACK_GENERAL) {
+      PetscSFBasicCopyLayout(&bas->rootpackopt[i],link->unitbytes,(char*)rootdata,packstart,PETSC_FALSE);
+    } else if (UnpackOp) {
       (*UnpackOp)(n,link->bs,rootloc+rootoffset[i],rootdata,(const void *)packstart);
     }
 #if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
@@ -1146,6 +1434,19 @@ static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const
     else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
 #endif
   }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  /* This implementation could be changed to unpack as receives arrive, at the cost of non-determinism */
+  ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
+  ierr = PetscSFBasicUnpackRootData(sf,link,unit,rootdata,op);CHKERRQ(ierr);
   ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1161,25 +1462,22 @@ static PetscErrorCode PetscSFFetchAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,
 
 static PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
 {
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
   void              (*FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*);
   PetscErrorCode    ierr;
   PetscSFBasicPack  link;
-  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  PetscInt          i,nrootranks,ndrootranks,nleafranks;
   const PetscInt    *rootoffset,*leafoffset,*rootloc,*leafloc;
-  const PetscMPIInt *rootranks,*leafranks;
-  MPI_Request       *rootreqs,*leafreqs;
   PetscMPIInt       n;
 
   PetscFunctionBegin;
   ierr = PetscSFBasicGetPackInUse(sf,unit,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
   /* This implementation could be changed to unpack as receives arrive, at the cost of non-determinism */
   ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_LEAF2ROOT_REDUCE);CHKERRQ(ierr);
-  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
-  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
-  ierr = PetscSFBasicPackGetReqs(sf,link,PETSC_SF_ROOT2LEAF_BCAST,&rootreqs,&leafreqs);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,NULL,NULL,&leafoffset,&leafloc);CHKERRQ(ierr);
   /* Post leaf receives */
-  ierr = PetscMPIIntCast(leafoffset[nleafranks]-leafoffset[ndleafranks],&n);CHKERRQ(ierr);
-  ierr = MPI_Startall_irecv(n,unit,nleafranks-ndleafranks,leafreqs);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackStartRecvs(sf,link,unit,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
 
   /* Process local fetch-and-op, post root sends */
   ierr = PetscSFBasicPackGetFetchAndOp(sf,link,op,&FetchAndOp);CHKERRQ(ierr);
@@ -1188,19 +1486,21 @@ static PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,vo
     ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
     (*FetchAndOp)(n,link->bs,rootloc+rootoffset[i],rootdata,packstart);
     if (i < ndrootranks) continue; /* shared memory */
-    ierr = MPI_Start_isend(n,unit,&rootreqs[i-ndrootranks]);CHKERRQ(ierr);
+    /* Contiguous roots have no persistent send request, see PetscSFBasicGetPack() */
+    ierr = PetscSFBasicPackStartSend(sf,link,unit,PETSC_SF_ROOT2LEAF_BCAST,i,n,bas->rootpackopt[i].pattern == PETSCSF_PACK_CONTIGUOUS ? packstart : NULL);CHKERRQ(ierr);
   }
   ierr = PetscSFBasicPackWaitall(sf,link,PETSC_SF_ROOT2LEAF_BCAST);CHKERRQ(ierr);
   for (i=0; i<nleafranks; i++) {
-    const void  *packstart = link->leaf[i];
+    void *packstart = link->leaf[i];
     ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
-    (*link->UnpackInsert)(n,link->bs,leafloc+leafoffset[i],leafupdate,packstart);
+    if (bas->leafpackopt[i].pattern != PETSCSF_PACK_GENERAL) PetscSFBasicCopyLayout(&bas->leafpackopt[i],link->unitbytes,(char*)leafupdate,(char*)packstart,PETSC_FALSE);
+    else (*link->UnpackInsert)(n,link->bs,leafloc+leafoffset[i],leafupdate,packstart);
   }
   ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
-static PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF sf,PetscInt *niranks,const PetscMPIInt **iranks,const PetscInt **ioffset,const PetscInt **irootloc)
+PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF sf,PetscInt *niranks,const PetscMPIInt **iranks,const PetscInt **ioffset,const PetscInt **irootloc)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
 
@@ -1234,6 +1534,8 @@ PETSC_EXTERN PetscErrorCode PetscSFCreate_Basic(PetscSF sf)
   sf->ops->GetLeafRanks    = PetscSFGetLeafRanks_Basic;
 
   ierr = PetscNewLog(sf,&bas);CHKERRQ(ierr);
-  sf->data = (void*)bas;
+  bas->persistent = PETSC_TRUE;
+  bas->nthreads   = 1;
+  sf->data        = (void*)bas;
   PetscFunctionReturn(0);
 }
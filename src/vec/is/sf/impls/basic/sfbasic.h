@@ -0,0 +1,107 @@
+#if !defined(__SFBASIC_H)
+#define __SFBASIC_H
+
+#include <petsc/private/sfimpl.h>
+
+typedef struct _n_PetscSFBasicPack *PetscSFBasicPack;
+struct _n_PetscSFBasicPack {
+  void (*Pack)(PetscInt,PetscInt,const PetscInt*,const void*,void*);
+  void (*UnpackInsert)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackAdd)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMin)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMax)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMinloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,const void*);
+  void (*UnpackMult)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackLAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackBAND)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackLOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackBOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackLXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*UnpackBXOR)(PetscInt,PetscInt,const PetscInt*,void*,const void *);
+  void (*FetchAndInsert)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndAdd)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMin)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMax)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMinloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMaxloc)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndMult)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndLAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndBAND)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndLOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndBOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndLXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  void (*FetchAndBXOR)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+
+  MPI_Datatype     unit;
+  PetscBool        isbuiltin;   /* Is unit an MPI builtin datatype? */
+  size_t           unitbytes;   /* Number of bytes in a unit */
+  PetscInt         bs;          /* Number of basic units in a unit */
+  const void       *key;        /* Array used as key for operation */
+  char             **root;      /* Packed root data, indexed by leaf rank */
+  char             **leaf;      /* Packed leaf data, indexed by root rank */
+  char             *rootbuf;    /* Contiguous storage of root[] when all ranks are communicated at once (PETSCSFNEIGHBOR) */
+  char             *leafbuf;    /* Contiguous storage of the non-distinguished leaf[] (PETSCSFNEIGHBOR) */
+  char             **rootpack;  /* Where roots are packed for each leaf rank, when different from root[] (PETSCSFSHARED) */
+  char             **leafpack;  /* Where leaves are packed for each root rank, when different from leaf[] (PETSCSFSHARED) */
+  MPI_Win          win;         /* Shared memory window holding the packed data (PETSCSFSHARED) */
+  PetscBool        persistent;  /* Are the requests persistent, initialized once for the buffers of this pack? */
+  MPI_Request      *requests;   /* Array of root requests followed by leaf requests */
+  PetscSFBasicPack next;
+};
+
+/* Layout of the indices of the roots or leaves communicated with one rank, detected by PetscSFSetUp_Basic():
+   idx[(k*dy+j)*dx+i] = start + i + j*X + k*Z for 0 <= i < dx, 0 <= j < dy and 0 <= k < dz */
+typedef enum {PETSCSF_PACK_GENERAL,PETSCSF_PACK_CONTIGUOUS,PETSCSF_PACK_STRIDED,PETSCSF_PACK_BOX} PetscSFPackPattern;
+
+typedef struct {
+  PetscSFPackPattern pattern;
+  PetscInt           start;       /* First index */
+  PetscInt           dx,dy,dz;    /* Number of contiguous indices in a row, rows in a plane and planes */
+  PetscInt           X,Z;         /* Distance between the first indices of two consecutive rows and planes */
+} PetscSFPackOpt;
+
+/* Implementations derived from PETSCSFBASIC start their data with these fields */
+#define SFBASICHEADER \
+  PetscMPIInt      tag;         /* Tag used for the communication of this PetscSF */                      \
+  PetscMPIInt      niranks;     /* Number of incoming ranks (ranks accessing my roots) */                 \
+  PetscMPIInt      ndiranks;    /* Number of incoming ranks (ranks accessing my roots) in distinguished set */ \
+  PetscMPIInt      *iranks;     /* Array of ranks that reference my roots */                              \
+  PetscInt         itotal;      /* Total number of graph edges referencing my roots */                   \
+  PetscInt         *ioffset;    /* Array of length niranks+1 holding offset in irootloc[] for each rank */ \
+  PetscInt         *irootloc;   /* Incoming roots referenced by ranks starting at ioffset[rank] */        \
+  PetscBool        persistent;  /* Create persistent requests for new packs */                            \
+  PetscSFPackOpt   *rootpackopt; /* Layout of irootloc[] for each incoming rank */                        \
+  PetscSFPackOpt   *leafpackopt; /* Layout of the local leaves for each outgoing rank */                 \
+  PetscInt         nthreads;    /* Number of OpenMP threads unpacking the reductions with MPI_SUM */     \
+  PetscBool        icolorsetup; /* Have the colors been computed, by the first reduction with MPI_SUM? */ \
+  PetscInt         ncolors;     /* Largest number of groups of incoming entries with distinct roots of a rank */ \
+  PetscInt         *icolorstart; /* Start of the color offsets of rank i in icoloroffset[], CSR of length niranks+1 */ \
+  PetscInt         *icoloroffset; /* Start of each color of rank i in icolorloc[] at icolorstart[i]+color */ \
+  PetscInt         *icolorperm; /* Position in the buffer of rank i of each entry, NULL if not permuted */ \
+  PetscInt         *icolorloc;  /* Roots of the entries sorted by color within each rank */              \
+  PetscBool        icolorthreads; /* Are the colors conflict-free among all the ranks, for threads? */   \
+  PetscSFBasicPack avail;       /* One or more entries per MPI Datatype, lazily constructed */            \
+  PetscSFBasicPack inuse        /* Buffers being used for transactions that have not yet completed */
+
+typedef struct {
+  SFBASICHEADER;
+} PetscSF_Basic;
+
+typedef enum {PETSC_SF_LEAF2ROOT_REDUCE, PETSC_SF_ROOT2LEAF_BCAST} PetscSFDirection;
+
+PETSC_INTERN PetscErrorCode PetscSFSetUp_Basic(PetscSF);
+PETSC_INTERN PetscErrorCode PetscSFReset_Basic(PetscSF);
+PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF,PetscViewer);
+PETSC_INTERN PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
+PETSC_INTERN PetscErrorCode PetscSFBasicPackTypeSetup(PetscSFBasicPack,MPI_Datatype);
+PETSC_INTERN PetscErrorCode PetscSFBasicPackGetFetchAndOp(PetscSF,PetscSFBasicPack,MPI_Op,void (**)(PetscInt,PetscInt,const PetscInt*,void*,void*));
+PETSC_INTERN PetscErrorCode PetscSFBasicGetRootInfo(PetscSF,PetscInt*,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
+PETSC_INTERN PetscErrorCode PetscSFBasicGetLeafInfo(PetscSF,PetscInt*,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
+PETSC_INTERN PetscErrorCode PetscSFBasicGetPackInUse(PetscSF,MPI_Datatype,const void*,PetscCopyMode,PetscSFBasicPack*);
+PETSC_INTERN PetscErrorCode PetscSFBasicReclaimPack(PetscSF,PetscSFBasicPack*);
+PETSC_INTERN void           PetscSFBasicPackData(PetscSFBasicPack,const PetscSFPackOpt*,PetscInt,const PetscInt*,const void*,void*);
+PETSC_INTERN PetscErrorCode PetscSFBasicUnpackLeafData(PetscSF,PetscSFBasicPack,MPI_Datatype,void*,MPI_Op);
+PETSC_INTERN PetscErrorCode PetscSFBasicUnpackRootData(PetscSF,PetscSFBasicPack,MPI_Datatype,void*,MPI_Op);
+
+#endif
@@ -0,0 +1,419 @@
+#include <../src/vec/is/sf/impls/basic/sfbasic.h> /*I "petscsf.h" I*/
+
+/*
+   PETSCSFSHARED uses the setup and the packing of PETSCSFBASIC. Each process packs its data in a window allocated with
+   MPI_Win_allocate_shared() on the communicator of its node, and the other processes of the node unpack it from there
+   directly, so on-node data is copied once instead of going through the MPI buffers. Only the processes of other nodes
+   are sent messages. The window is synchronized with MPI_Win_sync() and a barrier on the node: before packing, so the
+   readers of the previous communication with the same pack are done, and before unpacking, so the writers are done.
+*/
+typedef struct {
+  SFBASICHEADER;
+  MPI_Comm    shmcomm;    /* Communicator of the processes of this node, owned by PetscShmCommGet() */
+  PetscMPIInt useshm;     /* Does any process of this node communicate through shared memory? Same on the whole node */
+  PetscMPIInt *rootshm;   /* Rank in shmcomm of each rank referencing my roots, MPI_PROC_NULL if off node or distinguished */
+  PetscMPIInt *leafshm;   /* Rank in shmcomm of each rank owning roots of my leaves, MPI_PROC_NULL if off node or distinguished */
+  PetscInt    *rootshmoffset; /* Offset, in units, of the leaves packed for me in the window of each on-node rank referencing my roots */
+  PetscInt    *leafshmoffset; /* Offset, in units, of the roots packed for me in the window of each on-node rank owning roots of my leaves */
+} PetscSF_Shared;
+
+static PetscErrorCode PetscSFSetUp_Shared(PetscSF sf)
+{
+  PetscSF_Shared    *dat = (PetscSF_Shared*)sf->data;
+  PetscErrorCode    ierr;
+  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks,*leafshmsend;
+  const PetscInt    *rootoffset,*leafoffset;
+  const PetscMPIInt *rootranks,*leafranks;
+  PetscMPIInt       rtag,ltag,nreqs = 0,onnode = 0;
+  PetscShmComm      pshmcomm;
+  MPI_Comm          comm;
+  MPI_Request       *reqs;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSetUp_Basic(sf);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  ierr = PetscShmCommGet(comm,&pshmcomm);CHKERRQ(ierr);
+  ierr = PetscShmCommGetMpiShmComm(pshmcomm,&dat->shmcomm);CHKERRQ(ierr);
+
+  ierr = PetscMalloc4(nrootranks,&dat->rootshm,nleafranks,&dat->leafshm,nrootranks,&dat->rootshmoffset,nleafranks,&dat->leafshmoffset);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) {
+    dat->rootshm[i] = MPI_PROC_NULL;
+    if (i >= ndrootranks) {ierr = PetscShmCommGlobalToLocal(pshmcomm,rootranks[i],&dat->rootshm[i]);CHKERRQ(ierr);}
+    if (dat->rootshm[i] != MPI_PROC_NULL) onnode = 1;
+  }
+  for (i=0; i<nleafranks; i++) {
+    dat->leafshm[i] = MPI_PROC_NULL;
+    if (i >= ndleafranks) {ierr = PetscShmCommGlobalToLocal(pshmcomm,leafranks[i],&dat->leafshm[i]);CHKERRQ(ierr);}
+    if (dat->leafshm[i] != MPI_PROC_NULL) onnode = 1;
+  }
+  /* The windows and the barriers are collective on the node, so all its processes must agree on using them */
+  ierr = MPIU_Allreduce(&onnode,&dat->useshm,1,MPI_INT,MPI_MAX,dat->shmcomm);CHKERRQ(ierr);
+
+  /* The window of each process holds its packed roots, indexed by rootoffset[], followed by its packed leaves, indexed by
+     leafoffset[]. Tell the on-node roots and leaves where the data packed for them is in my window. */
+  ierr = PetscObjectGetNewTag((PetscObject)sf,&rtag);CHKERRQ(ierr);
+  ierr = PetscObjectGetNewTag((PetscObject)sf,&ltag);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nleafranks,&leafshmsend);CHKERRQ(ierr);
+  ierr = PetscMalloc1(2*(nrootranks+nleafranks),&reqs);CHKERRQ(ierr);
+  for (i=ndrootranks; i<nrootranks; i++) {
+    if (dat->rootshm[i] == MPI_PROC_NULL) continue;
+    ierr = MPI_Irecv(&dat->rootshmoffset[i],1,MPIU_INT,rootranks[i],ltag,comm,&reqs[nreqs++]);CHKERRQ(ierr);
+    ierr = MPI_Isend((void*)&rootoffset[i],1,MPIU_INT,rootranks[i],rtag,comm,&reqs[nreqs++]);CHKERRQ(ierr);
+  }
+  for (i=ndleafranks; i<nleafranks; i++) {
+    if (dat->leafshm[i] == MPI_PROC_NULL) continue;
+    leafshmsend[i] = rootoffset[nrootranks] + leafoffset[i];
+    ierr = MPI_Irecv(&dat->leafshmoffset[i],1,MPIU_INT,leafranks[i],rtag,comm,&reqs[nreqs++]);CHKERRQ(ierr);
+    ierr = MPI_Isend(&leafshmsend[i],1,MPIU_INT,leafranks[i],ltag,comm,&reqs[nreqs++]);CHKERRQ(ierr);
+  }
+  ierr = MPI_Waitall(nreqs,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = PetscFree(reqs);CHKERRQ(ierr);
+  ierr = PetscFree(leafshmsend);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSharedGetPack(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFBasicPack *mylink)
+{
+  PetscSF_Shared   *dat = (PetscSF_Shared*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link,*p;
+  PetscInt         nrootranks,ndrootranks,nleafranks,ndleafranks,i;
+  const PetscInt   *rootoffset,*leafoffset;
+  char             *buf,*rbuf;
+  size_t           size;
+  MPI_Aint         rsize;
+  PetscMPIInt      rdisp;
+
+  PetscFunctionBegin;
+  /* Look for types in cache */
+  for (p=&dat->avail; (link=*p); p=&link->next) {
+    PetscBool match;
+    ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
+    if (match) {
+      *p = link->next;          /* Remove from available list */
+      goto found;
+    }
+  }
+
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscNew(&link);CHKERRQ(ierr);
+  ierr = PetscSFBasicPackTypeSetup(link,unit);CHKERRQ(ierr);
+  ierr = PetscMalloc4(nrootranks,&link->root,nleafranks,&link->leaf,nrootranks,&link->rootpack,nleafranks,&link->leafpack);CHKERRQ(ierr);
+  /* Requests for the ranks off this node, roots followed by leaves */
+  ierr = PetscMalloc1(nrootranks+nleafranks,&link->requests);CHKERRQ(ierr);
+  for (i=0; i<nrootranks+nleafranks; i++) link->requests[i] = MPI_REQUEST_NULL;
+
+  /* Round the window of each process up to PETSC_MEMALIGN bytes so that the contiguous windows of the node stay aligned */
+  size      = (rootoffset[nrootranks]+leafoffset[nleafranks])*link->unitbytes;
+  size      = ((size+PETSC_MEMALIGN-1)/PETSC_MEMALIGN)*PETSC_MEMALIGN;
+  link->win = MPI_WIN_NULL;
+  if (dat->useshm) {
+    ierr = MPI_Win_allocate_shared((MPI_Aint)size,1,MPI_INFO_NULL,dat->shmcomm,&buf,&link->win);CHKERRQ(ierr);
+    ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK,link->win);CHKERRQ(ierr);
+  } else {
+    ierr = PetscMalloc(size,&link->rootbuf);CHKERRQ(ierr);
+    buf  = link->rootbuf;
+  }
+  for (i=0; i<nrootranks; i++) link->root[i] = link->rootpack[i] = buf + rootoffset[i]*link->unitbytes;
+  for (i=0; i<nleafranks; i++) {
+    if (i < ndleafranks) {      /* Leaf buffers for distinguished ranks are pointers directly into root buffers */
+      if (ndrootranks != 1) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Cannot match distinguished ranks");
+      link->leaf[i] = link->leafpack[i] = link->root[0];
+      continue;
+    }
+    link->leaf[i] = link->leafpack[i] = buf + (rootoffset[nrootranks]+leafoffset[i])*link->unitbytes;
+  }
+  /* The packed data of on-node ranks is unpacked from their windows */
+  for (i=ndrootranks; i<nrootranks; i++) {
+    if (dat->rootshm[i] == MPI_PROC_NULL) continue;
+    ierr = MPI_Win_shared_query(link->win,dat->rootshm[i],&rsize,&rdisp,&rbuf);CHKERRQ(ierr);
+    link->root[i] = rbuf + dat->rootshmoffset[i]*link->unitbytes;
+  }
+  for (i=ndleafranks; i<nleafranks; i++) {
+    if (dat->leafshm[i] == MPI_PROC_NULL) continue;
+    ierr = MPI_Win_shared_query(link->win,dat->leafshm[i],&rsize,&rdisp,&rbuf);CHKERRQ(ierr);
+    link->leaf[i] = rbuf + dat->leafshmoffset[i]*link->unitbytes;
+  }
+
+found:
+  link->key  = key;
+  link->next = dat->inuse;
+  dat->inuse = link;
+
+  *mylink = link;
+  PetscFunctionReturn(0);
+}
+
+/* Make the writes of all the processes of the node to the window of the pack visible to all of them */
+static PetscErrorCode PetscSFSharedSync(PetscSF sf,PetscSFBasicPack link)
+{
+  PetscSF_Shared *dat = (PetscSF_Shared*)sf->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!dat->useshm) PetscFunctionReturn(0);
+  ierr = MPI_Win_sync(link->win);CHKERRQ(ierr);
+  ierr = MPI_Barrier(dat->shmcomm);CHKERRQ(ierr);
+  ierr = MPI_Win_sync(link->win);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSharedWaitall(PetscSF sf,PetscSFBasicPack link)
+{
+  PetscErrorCode ierr;
+  PetscInt       nrootranks,nleafranks;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  ierr = MPI_Waitall(nrootranks+nleafranks,link->requests,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Shared(PetscSF sf)
+{
+  PetscSF_Shared   *dat = (PetscSF_Shared*)sf->data;
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link,next;
+
+  PetscFunctionBegin;
+  if (dat->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
+  for (link=dat->avail; link; link=next) {
+    next = link->next;
+    if (!link->isbuiltin) {ierr = MPI_Type_free(&link->unit);CHKERRQ(ierr);}
+    if (link->win != MPI_WIN_NULL) {
+      ierr = MPI_Win_unlock_all(link->win);CHKERRQ(ierr);
+      ierr = MPI_Win_free(&link->win);CHKERRQ(ierr);
+    }
+    ierr = PetscFree(link->rootbuf);CHKERRQ(ierr);
+    ierr = PetscFree4(link->root,link->leaf,link->rootpack,link->leafpack);CHKERRQ(ierr);
+    ierr = PetscFree(link->requests);CHKERRQ(ierr);
+    ierr = PetscFree(link);CHKERRQ(ierr);
+  }
+  dat->avail = NULL;
+  ierr = PetscFree4(dat->rootshm,dat->leafshm,dat->rootshmoffset,dat->leafshmoffset);CHKERRQ(ierr);
+  ierr = PetscSFReset_Basic(sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Shared(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Shared(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBegin_Shared(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscSF_Shared    *dat = (PetscSF_Shared*)sf->data;
+  PetscErrorCode    ierr;
+  PetscSFBasicPack  link;
+  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  const PetscInt    *rootoffset,*leafoffset,*rootloc;
+  const PetscMPIInt *rootranks,*leafranks;
+  PetscMPIInt       n;
+  MPI_Comm          comm = PetscObjectComm((PetscObject)sf);
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFSharedGetPack(sf,unit,rootdata,&link);CHKERRQ(ierr);
+
+  /* Post leaf receives from the ranks off this node */
+  for (i=ndleafranks; i<nleafranks; i++) {
+    if (dat->leafshm[i] != MPI_PROC_NULL) continue;
+    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+    ierr = MPI_Irecv(link->leaf[i],n,unit,leafranks[i],dat->tag,comm,&link->requests[nrootranks+i]);CHKERRQ(ierr);
+  }
+
+  /* Pack root data once the ranks of this node are done reading what was packed before, send it off node */
+  ierr = PetscSFSharedSync(sf,link);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) {
+    ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+    PetscSFBasicPackData(link,&dat->rootpackopt[i],n,rootloc+rootoffset[i],rootdata,link->rootpack[i]);
+    if (i < ndrootranks || dat->rootshm[i] != MPI_PROC_NULL) continue;
+    ierr = MPI_Isend(link->rootpack[i],n,unit,rootranks[i],dat->tag,comm,&link->requests[i]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpEnd_Shared(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,rootdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFSharedWaitall(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFSharedSync(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFBasicUnpackLeafData(sf,link,unit,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastBegin_Shared(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpBegin_Shared(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastEnd_Shared(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpEnd_Shared(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Shared(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Shared    *dat = (PetscSF_Shared*)sf->data;
+  PetscErrorCode    ierr;
+  PetscSFBasicPack  link;
+  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  const PetscInt    *rootoffset,*leafoffset,*leafloc;
+  const PetscMPIInt *rootranks,*leafranks;
+  PetscMPIInt       n;
+  MPI_Comm          comm = PetscObjectComm((PetscObject)sf);
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
+  ierr = PetscSFSharedGetPack(sf,unit,leafdata,&link);CHKERRQ(ierr);
+
+  /* Post root receives from the ranks off this node */
+  for (i=ndrootranks; i<nrootranks; i++) {
+    if (dat->rootshm[i] != MPI_PROC_NULL) continue;
+    ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+    ierr = MPI_Irecv(link->root[i],n,unit,rootranks[i],dat->tag,comm,&link->requests[i]);CHKERRQ(ierr);
+  }
+
+  /* Pack leaf data once the ranks of this node are done reading what was packed before, send it off node */
+  ierr = PetscSFSharedSync(sf,link);CHKERRQ(ierr);
+  for (i=0; i<nleafranks; i++) {
+    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+    PetscSFBasicPackData(link,&dat->leafpackopt[i],n,leafloc+leafoffset[i],leafdata,link->leafpack[i]);
+    if (i < ndleafranks || dat->leafshm[i] != MPI_PROC_NULL) continue;
+    ierr = MPI_Isend(link->leafpack[i],n,unit,leafranks[i],dat->tag,comm,&link->requests[nrootranks+i]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Shared(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode   ierr;
+  PetscSFBasicPack link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFSharedWaitall(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFSharedSync(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFBasicUnpackRootData(sf,link,unit,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpBegin_Shared(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReduceBegin_Shared(sf,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpEnd_Shared(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF_Shared    *dat = (PetscSF_Shared*)sf->data;
+  void              (*FetchAndOp)(PetscInt,PetscInt,const PetscInt*,void*,void*);
+  PetscErrorCode    ierr;
+  PetscSFBasicPack  link;
+  PetscInt          i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  const PetscInt    *rootoffset,*leafoffset,*rootloc,*leafloc;
+  const PetscMPIInt *rootranks,*leafranks;
+  PetscMPIInt       n;
+  MPI_Comm          comm = PetscObjectComm((PetscObject)sf);
+
+  PetscFunctionBegin;
+  ierr = PetscSFBasicGetPackInUse(sf,unit,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFSharedWaitall(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFSharedSync(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetRootInfo(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,&rootloc);CHKERRQ(ierr);
+  ierr = PetscSFBasicGetLeafInfo(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,&leafloc);CHKERRQ(ierr);
+
+  /* The fetched values replace the packed leaves, in the windows of the on-node ranks and in the buffers of the others */
+  for (i=ndleafranks; i<nleafranks; i++) {
+    if (dat->leafshm[i] != MPI_PROC_NULL) continue;
+    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+    ierr = MPI_Irecv(link->leafpack[i],n,unit,leafranks[i],dat->tag,comm,&link->requests[nrootranks+i]);CHKERRQ(ierr);
+  }
+  ierr = PetscSFBasicPackGetFetchAndOp(sf,link,op,&FetchAndOp);CHKERRQ(ierr);
+  for (i=0; i<nrootranks; i++) {
+    ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+    (*FetchAndOp)(n,link->bs,rootloc+rootoffset[i],rootdata,link->root[i]);
+    if (i < ndrootranks || dat->rootshm[i] != MPI_PROC_NULL) continue;
+    ierr = MPI_Isend(link->root[i],n,unit,rootranks[i],dat->tag,comm,&link->requests[i]);CHKERRQ(ierr);
+  }
+  ierr = PetscSFSharedWaitall(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFSharedSync(sf,link);CHKERRQ(ierr);
+  for (i=0; i<nleafranks; i++) {
+    ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+    (*link->UnpackInsert)(n,link->bs,leafloc+leafoffset[i],leafupdate,link->leafpack[i]);
+  }
+  ierr = PetscSFBasicReclaimPack(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   PETSCSFSHARED - A PetscSF that communicates through MPI-3 shared memory with the processes of the same node
+
+   Notes:
+   The setup and the packing of the data are those of PETSCSFBASIC. PetscSFSetUp() finds the processes of the same
+   node with PetscShmCommGet(). Each process packs its data in a window allocated with MPI_Win_allocate_shared() and
+   the other processes of its node unpack it directly from there, messages are only sent to the processes of other
+   nodes. Every communication synchronizes all the processes of the node twice, with MPI_Win_sync() and MPI_Barrier(),
+   so like a collective operation it must be called in the same order by all of them.
+
+   Options Database Keys:
++  -sf_type shared - use this implementation, also for the vector scatters of type VECSCATTERSF
+-  -noshared - treat all the processes as being on other nodes
+
+   Level: intermediate
+
+.seealso: PetscSFCreate(), PetscSFSetType(), PETSCSFBASIC, PETSCSFNEIGHBOR, PetscShmCommGet()
+M*/
+PETSC_EXTERN PetscErrorCode PetscSFCreate_Shared(PetscSF sf)
+{
+  PetscSF_Shared *dat;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  sf->ops->SetUp           = PetscSFSetUp_Shared;
+  sf->ops->Reset           = PetscSFReset_Shared;
+  sf->ops->Destroy         = PetscSFDestroy_Shared;
+  sf->ops->View            = PetscSFView_Basic;
+  sf->ops->BcastBegin      = PetscSFBcastBegin_Shared;
+  sf->ops->BcastEnd        = PetscSFBcastEnd_Shared;
+  sf->ops->BcastAndOpBegin = PetscSFBcastAndOpBegin_Shared;
+  sf->ops->BcastAndOpEnd   = PetscSFBcastAndOpEnd_Shared;
+  sf->ops->ReduceBegin     = PetscSFReduceBegin_Shared;
+  sf->ops->ReduceEnd       = PetscSFReduceEnd_Shared;
+  sf->ops->FetchAndOpBegin = PetscSFFetchAndOpBegin_Shared;
+  sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Shared;
+  sf->ops->GetLeafRanks    = PetscSFGetLeafRanks_Basic;
+
+  ierr = PetscNewLog(sf,&dat);CHKERRQ(ierr);
+  dat->shmcomm = MPI_COMM_NULL;
+  sf->data     = (void*)dat;
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,524 @@
+#include <petsc/private/sfimpl.h> /*I "petscsf.h" I*/
+
+/*
+   PETSCSFTWOLEVEL groups the processes in nodes, process 0 of each node being its leader. The graph is split in four
+   PETSCSFBASIC star forests, so that only the leaders communicate between nodes:
+
+     local    - on the node communicator, the edges whose root and leaf are on the same node
+     gather   - on the node communicator, the roots of the node referenced by other nodes (roots) to the send buffer of
+                the leader (leaves), one unit per edge
+     exchange - on the leader communicator, the send buffer of a leader (leaves) to the receive buffers of the leaders
+                of the referencing nodes (roots), so the data goes in the opposite direction of the graph
+     scatter  - on the node communicator, the receive buffer of the leader (roots) to the leaves of the node referencing
+                other nodes
+
+   A broadcast is gather, exchange (reduction with MPIU_REPLACE) and scatter. A reduction goes backwards, the operation
+   being applied only by gather. Each receive slot has a single leaf, so the other steps can replace.
+*/
+typedef struct _n_PetscSFTwoLevelLink *PetscSFTwoLevelLink;
+struct _n_PetscSFTwoLevelLink {
+  MPI_Datatype        unit;
+  PetscBool           isbuiltin;  /* Is unit an MPI builtin datatype? */
+  const void          *key;       /* Array used as key for operation */
+  char                *sendbuf;   /* Units of the roots of this node referenced by other nodes, on the leader */
+  char                *recvbuf;   /* Units of the roots of other nodes referenced by this node, on the leader */
+  PetscSFTwoLevelLink next;
+};
+
+typedef struct {
+  PetscInt            nodesize;   /* Number of consecutive processes in a node, 0 for the processes sharing memory */
+  MPI_Comm            nodecomm;   /* Processes of my node */
+  MPI_Comm            leadercomm; /* Leaders of all the nodes, MPI_COMM_NULL on the other processes */
+  PetscMPIInt         nnodes;     /* Number of nodes */
+  PetscMPIInt         node;       /* My node, rank of its leader in leadercomm */
+  PetscInt            nlocal;     /* Number of my leaves whose roots are on my node */
+  PetscInt            nremote;    /* Number of my leaves whose roots are on other nodes */
+  PetscMPIInt         nsrcnodes;  /* Number of nodes owning roots of this node's leaves, on the leader */
+  PetscMPIInt         ndstnodes;  /* Number of nodes referencing roots of this node, on the leader */
+  PetscInt            nsend;      /* Number of units in sendbuf */
+  PetscInt            nrecv;      /* Number of units in recvbuf */
+  PetscSF             local,gather,exchange,scatter;
+  PetscSFTwoLevelLink avail;      /* Buffers ready to be used */
+  PetscSFTwoLevelLink inuse;      /* Buffers being used by operations that have not yet completed */
+} PetscSF_TwoLevel;
+
+static PetscErrorCode PetscSFTwoLevelCreateSF(PetscSF sf,MPI_Comm comm,PetscInt nroots,PetscInt nleaves,PetscInt *ilocal,PetscSFNode *iremote,PetscSF *newsf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFCreate(comm,newsf);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)sf,(PetscObject)*newsf);CHKERRQ(ierr);
+  ierr = PetscSFSetType(*newsf,PETSCSFBASIC);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(*newsf,nroots,nleaves,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(*newsf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetUp_TwoLevel(PetscSF sf)
+{
+  PetscSF_TwoLevel *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode   ierr;
+  MPI_Comm         comm,pcomm;
+  PetscMPIInt      rank,noderank,nodesize,pair[2],nranks,niranks,*iranks,*idata,*ranknode,cnt,*counts = NULL,*displs = NULL,*srcranks = NULL,*dstranks = NULL,tag,nreqs;
+  PetscInt         i,j,k,r,offset,nrecv,*lilocal,*rilocal,*roots,*recvroots = NULL,*slotnode,*perm,*requests = NULL,*srccounts = NULL,*dstcounts = NULL,*recvrequests = NULL;
+  PetscSFNode      *liremote,*riremote,*giremote = NULL,*eiremote = NULL;
+  MPI_Request      *reqs;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  if (tl->nodesize > 0) {
+    ierr = MPI_Comm_split(comm,(PetscMPIInt)(rank/tl->nodesize),rank,&tl->nodecomm);CHKERRQ(ierr);
+  } else {
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    ierr = MPI_Comm_split_type(comm,MPI_COMM_TYPE_SHARED,rank,MPI_INFO_NULL,&tl->nodecomm);CHKERRQ(ierr);
+#else
+    ierr = MPI_Comm_split(comm,rank,rank,&tl->nodecomm);CHKERRQ(ierr);
+#endif
+  }
+  ierr = MPI_Comm_rank(tl->nodecomm,&noderank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(tl->nodecomm,&nodesize);CHKERRQ(ierr);
+  ierr = MPI_Comm_split(comm,noderank ? MPI_UNDEFINED : 0,rank,&tl->leadercomm);CHKERRQ(ierr);
+  if (!noderank) {
+    ierr = MPI_Comm_rank(tl->leadercomm,&tl->node);CHKERRQ(ierr);
+    ierr = MPI_Comm_size(tl->leadercomm,&tl->nnodes);CHKERRQ(ierr);
+  }
+  pair[0] = tl->node;
+  pair[1] = tl->nnodes;
+  ierr = MPI_Bcast(pair,2,MPI_INT,0,tl->nodecomm);CHKERRQ(ierr);
+  tl->node   = pair[0];
+  tl->nnodes = pair[1];
+
+  /* Node of each rank owning roots of my leaves and its rank in the node, asked only from these ranks; the ranks are
+     also those of PetscSFGetRanks() */
+  ierr = PetscSFSetUpRanks(sf,MPI_GROUP_EMPTY);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(sf->nranks,&nranks);CHKERRQ(ierr);
+  ierr = PetscCommDuplicate(comm,&pcomm,&tag);CHKERRQ(ierr);
+  ierr = PetscCommBuildTwoSided(pcomm,1,MPI_INT,nranks,sf->ranks,sf->ranks,&niranks,&iranks,&idata);CHKERRQ(ierr);
+  ierr = PetscMalloc2(2*nranks,&ranknode,nranks+niranks,&reqs);CHKERRQ(ierr);
+  pair[0] = tl->node;
+  pair[1] = noderank;
+  for (i=0; i<nranks; i++) {ierr = MPI_Irecv(ranknode+2*i,2,MPI_INT,sf->ranks[i],tag,pcomm,&reqs[i]);CHKERRQ(ierr);}
+  for (i=0; i<niranks; i++) {ierr = MPI_Isend(pair,2,MPI_INT,iranks[i],tag,pcomm,&reqs[nranks+i]);CHKERRQ(ierr);}
+  ierr = MPI_Waitall(nranks+niranks,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = PetscFree(iranks);CHKERRQ(ierr);
+  ierr = PetscFree(idata);CHKERRQ(ierr);
+  ierr = PetscCommDestroy(&pcomm);CHKERRQ(ierr);
+
+  /* Split my leaves into those referencing roots of my node and those referencing other nodes, the latter are numbered
+     in the receive buffer of the leader after those of the processes of lower rank in the node */
+  tl->nlocal = tl->nremote = 0;
+  for (r=0; r<nranks; r++) {
+    if (ranknode[2*r] == tl->node) tl->nlocal += sf->roffset[r+1]-sf->roffset[r];
+    else tl->nremote += sf->roffset[r+1]-sf->roffset[r];
+  }
+  ierr = MPI_Scan(&tl->nremote,&offset,1,MPIU_INT,MPI_SUM,tl->nodecomm);CHKERRQ(ierr);
+  offset -= tl->nremote;
+  ierr = PetscMalloc2(tl->nlocal,&lilocal,tl->nlocal,&liremote);CHKERRQ(ierr);
+  ierr = PetscMalloc2(tl->nremote,&rilocal,tl->nremote,&riremote);CHKERRQ(ierr);
+  ierr = PetscMalloc1(3*tl->nremote,&roots);CHKERRQ(ierr);
+  for (r=0,j=0,k=0; r<nranks; r++) {
+    for (i=sf->roffset[r]; i<sf->roffset[r+1]; i++) {
+      if (ranknode[2*r] == tl->node) {
+        lilocal[j]        = sf->rmine[i];
+        liremote[j].rank  = ranknode[2*r+1];
+        liremote[j].index = sf->rremote[i];
+        j++;
+      } else {
+        rilocal[k]        = sf->rmine[i];
+        riremote[k].rank  = 0;
+        riremote[k].index = offset+k;
+        roots[3*k]        = ranknode[2*r];
+        roots[3*k+1]      = ranknode[2*r+1];
+        roots[3*k+2]      = sf->rremote[i];
+        k++;
+      }
+    }
+  }
+  ierr = PetscFree2(ranknode,reqs);CHKERRQ(ierr);
+  ierr = MPI_Reduce(&tl->nremote,&nrecv,1,MPIU_INT,MPI_SUM,0,tl->nodecomm);CHKERRQ(ierr);
+  tl->nrecv = noderank ? 0 : nrecv;
+  ierr = PetscSFTwoLevelCreateSF(sf,tl->nodecomm,sf->nroots,tl->nlocal,lilocal,liremote,&tl->local);CHKERRQ(ierr);
+  ierr = PetscSFTwoLevelCreateSF(sf,tl->nodecomm,tl->nrecv,tl->nremote,rilocal,riremote,&tl->scatter);CHKERRQ(ierr);
+
+  /* The leader collects the roots referenced by each receive slot, with the node of their owner and its rank there */
+  ierr = PetscMPIIntCast(3*tl->nremote,&cnt);CHKERRQ(ierr);
+  if (!noderank) {
+    ierr = PetscMalloc2(nodesize,&counts,nodesize+1,&displs);CHKERRQ(ierr);
+    ierr = PetscMalloc1(3*tl->nrecv,&recvroots);CHKERRQ(ierr);
+  }
+  ierr = MPI_Gather(&cnt,1,MPI_INT,counts,1,MPI_INT,0,tl->nodecomm);CHKERRQ(ierr);
+  if (!noderank) {
+    displs[0] = 0;
+    for (i=0; i<nodesize; i++) displs[i+1] = displs[i]+counts[i];
+  }
+  ierr = MPI_Gatherv(roots,cnt,MPIU_INT,recvroots,counts,displs,MPIU_INT,0,tl->nodecomm);CHKERRQ(ierr);
+  ierr = PetscFree(roots);CHKERRQ(ierr);
+
+  tl->nsend = 0;
+  if (!noderank) {
+    /* Request from the leader of each node the roots it owns, with the slots where they are received */
+    ierr = PetscMalloc2(tl->nrecv,&slotnode,tl->nrecv,&perm);CHKERRQ(ierr);
+    for (i=0; i<tl->nrecv; i++) {
+      slotnode[i] = recvroots[3*i];
+      perm[i]     = i;
+    }
+    ierr = PetscSortIntWithArray(tl->nrecv,slotnode,perm);CHKERRQ(ierr);
+    for (i=0,tl->nsrcnodes=0; i<tl->nrecv; i++) if (!i || slotnode[i] != slotnode[i-1]) tl->nsrcnodes++;
+    ierr = PetscMalloc3(tl->nsrcnodes,&srcranks,tl->nsrcnodes+1,&srccounts,3*tl->nrecv,&requests);CHKERRQ(ierr);
+    for (i=0,j=-1; i<tl->nrecv; i++) {
+      PetscInt s = perm[i];
+      if (!i || slotnode[i] != slotnode[i-1]) {
+        j++;
+        srcranks[j]  = (PetscMPIInt)slotnode[i];
+        srccounts[j] = 0;
+      }
+      srccounts[j]++;
+      requests[3*i]   = recvroots[3*s+1];
+      requests[3*i+1] = recvroots[3*s+2];
+      requests[3*i+2] = s;
+    }
+    ierr = PetscFree2(slotnode,perm);CHKERRQ(ierr);
+
+    ierr = PetscCommDuplicate(tl->leadercomm,&pcomm,&tag);CHKERRQ(ierr);
+    ierr = PetscCommBuildTwoSided(pcomm,1,MPIU_INT,tl->nsrcnodes,srcranks,srccounts,&tl->ndstnodes,&dstranks,&dstcounts);CHKERRQ(ierr);
+    for (i=0; i<tl->ndstnodes; i++) tl->nsend += dstcounts[i];
+    ierr = PetscMalloc1(3*tl->nsend,&recvrequests);CHKERRQ(ierr);
+    ierr = PetscMalloc1(tl->ndstnodes+tl->nsrcnodes,&reqs);CHKERRQ(ierr);
+    for (i=0,k=0,nreqs=0; i<tl->ndstnodes; k+=dstcounts[i],i++,nreqs++) {
+      ierr = PetscMPIIntCast(3*dstcounts[i],&cnt);CHKERRQ(ierr);
+      ierr = MPI_Irecv(recvrequests+3*k,cnt,MPIU_INT,dstranks[i],tag,pcomm,&reqs[nreqs]);CHKERRQ(ierr);
+    }
+    for (i=0,k=0; i<tl->nsrcnodes; k+=srccounts[i],i++,nreqs++) {
+      ierr = PetscMPIIntCast(3*srccounts[i],&cnt);CHKERRQ(ierr);
+      ierr = MPI_Isend(requests+3*k,cnt,MPIU_INT,srcranks[i],tag,pcomm,&reqs[nreqs]);CHKERRQ(ierr);
+    }
+    ierr = MPI_Waitall(nreqs,reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    ierr = PetscFree(reqs);CHKERRQ(ierr);
+    ierr = PetscCommDestroy(&pcomm);CHKERRQ(ierr);
+
+    /* Send slot t holds the root requested by recvrequests[3*t..3*t+2], gathered from the node and sent to that slot */
+    ierr = PetscMalloc1(tl->nsend,&giremote);CHKERRQ(ierr);
+    ierr = PetscMalloc1(tl->nsend,&eiremote);CHKERRQ(ierr);
+    for (i=0,k=0; i<tl->ndstnodes; i++) {
+      for (j=0; j<dstcounts[i]; j++,k++) {
+        giremote[k].rank  = recvrequests[3*k];
+        giremote[k].index = recvrequests[3*k+1];
+        eiremote[k].rank  = dstranks[i];
+        eiremote[k].index = recvrequests[3*k+2];
+      }
+    }
+    ierr = PetscFree(recvrequests);CHKERRQ(ierr);
+    ierr = PetscFree(dstranks);CHKERRQ(ierr);
+    ierr = PetscFree(dstcounts);CHKERRQ(ierr);
+    ierr = PetscFree3(srcranks,srccounts,requests);CHKERRQ(ierr);
+    ierr = PetscFree2(counts,displs);CHKERRQ(ierr);
+    ierr = PetscFree(recvroots);CHKERRQ(ierr);
+  }
+  ierr = PetscSFTwoLevelCreateSF(sf,tl->nodecomm,sf->nroots,tl->nsend,NULL,giremote,&tl->gather);CHKERRQ(ierr);
+  if (!noderank) {ierr = PetscSFTwoLevelCreateSF(sf,tl->leadercomm,tl->nrecv,tl->nsend,NULL,eiremote,&tl->exchange);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_TwoLevel(PetscSF sf)
+{
+  PetscSF_TwoLevel    *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode      ierr;
+  PetscSFTwoLevelLink link,next;
+
+  PetscFunctionBegin;
+  if (tl->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
+  for (link=tl->avail; link; link=next) {
+    next = link->next;
+    if (!link->isbuiltin) {ierr = MPI_Type_free(&link->unit);CHKERRQ(ierr);}
+    ierr = PetscFree2(link->sendbuf,link->recvbuf);CHKERRQ(ierr);
+    ierr = PetscFree(link);CHKERRQ(ierr);
+  }
+  tl->avail = NULL;
+  ierr = PetscSFDestroy(&tl->local);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&tl->gather);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&tl->exchange);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&tl->scatter);CHKERRQ(ierr);
+  if (tl->nodecomm != MPI_COMM_NULL) {ierr = MPI_Comm_free(&tl->nodecomm);CHKERRQ(ierr);}
+  if (tl->leadercomm != MPI_COMM_NULL) {ierr = MPI_Comm_free(&tl->leadercomm);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_TwoLevel(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_TwoLevel(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetFromOptions_TwoLevel(PetscOptionItems *PetscOptionsObject,PetscSF sf)
+{
+  PetscSF_TwoLevel *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF TwoLevel options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-sf_twolevel_node_size","Number of consecutive processes forming a node, 0 for the processes sharing memory","PetscSFSetFromOptions",tl->nodesize,&tl->nodesize,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFView_TwoLevel(PetscSF sf,PetscViewer viewer)
+{
+  PetscSF_TwoLevel  *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode    ierr;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+  PetscMPIInt       rank;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii && sf->setupcalled) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  nodes=%d\n",tl->nnodes);CHKERRQ(ierr);
+    ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+    if (format == PETSC_VIEWER_ASCII_INFO) {
+      ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)sf),&rank);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] node %d, %D leaves with roots on the node, %D on other nodes\n",rank,tl->node,tl->nlocal,tl->nremote);CHKERRQ(ierr);
+      if (tl->exchange) {ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] leader receiving %D units from %d nodes, sending %D units to %d nodes\n",rank,tl->nrecv,tl->nsrcnodes,tl->nsend,tl->ndstnodes);CHKERRQ(ierr);}
+      ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFTwoLevelGetLink(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFTwoLevelLink *mylink)
+{
+  PetscSF_TwoLevel    *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode      ierr;
+  PetscSFTwoLevelLink link,*p;
+  PetscMPIInt         ni,na,nd,combiner;
+  MPI_Aint            lb,extent;
+
+  PetscFunctionBegin;
+  for (p=&tl->avail; (link=*p); p=&link->next) {
+    PetscBool match;
+    ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
+    if (match) {
+      *p = link->next;
+      goto found;
+    }
+  }
+  ierr = PetscNew(&link);CHKERRQ(ierr);
+  ierr = MPI_Type_get_extent(unit,&lb,&extent);CHKERRQ(ierr);
+  ierr = PetscMalloc2(tl->nsend*extent,&link->sendbuf,tl->nrecv*extent,&link->recvbuf);CHKERRQ(ierr);
+  ierr = MPI_Type_get_envelope(unit,&ni,&na,&nd,&combiner);CHKERRQ(ierr);
+  link->isbuiltin = (combiner == MPI_COMBINER_NAMED) ? PETSC_TRUE : PETSC_FALSE;
+  if (link->isbuiltin) link->unit = unit;
+  else {ierr = MPI_Type_dup(unit,&link->unit);CHKERRQ(ierr);}
+found:
+  link->key = key;
+  link->next = tl->inuse;
+  tl->inuse  = link;
+  *mylink    = link;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFTwoLevelGetLinkInUse(PetscSF sf,MPI_Datatype unit,const void *key,PetscSFTwoLevelLink *mylink)
+{
+  PetscSF_TwoLevel    *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode      ierr;
+  PetscSFTwoLevelLink link,*p;
+
+  PetscFunctionBegin;
+  for (p=&tl->inuse; (link=*p); p=&link->next) {
+    PetscBool match;
+    ierr = MPIPetsc_Type_compare(unit,link->unit,&match);CHKERRQ(ierr);
+    if (match && key == link->key) {
+      *p      = link->next;
+      *mylink = link;
+      PetscFunctionReturn(0);
+    }
+  }
+  SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Could not find the buffers of the operation");
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFTwoLevelReclaimLink(PetscSF sf,PetscSFTwoLevelLink *link)
+{
+  PetscSF_TwoLevel *tl = (PetscSF_TwoLevel*)sf->data;
+
+  PetscFunctionBegin;
+  (*link)->key  = NULL;
+  (*link)->next = tl->avail;
+  tl->avail     = *link;
+  *link         = NULL;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBegin_TwoLevel(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscSF_TwoLevel    *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode      ierr;
+  PetscSFTwoLevelLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFTwoLevelGetLink(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpBegin(tl->local,unit,rootdata,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(tl->gather,unit,rootdata,link->sendbuf);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(tl->gather,unit,rootdata,link->sendbuf);CHKERRQ(ierr);
+  if (tl->exchange) {ierr = PetscSFReduceBegin(tl->exchange,unit,link->sendbuf,link->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpEnd_TwoLevel(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscSF_TwoLevel    *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode      ierr;
+  PetscSFTwoLevelLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFTwoLevelGetLinkInUse(sf,unit,rootdata,&link);CHKERRQ(ierr);
+  if (tl->exchange) {ierr = PetscSFReduceEnd(tl->exchange,unit,link->sendbuf,link->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);}
+  ierr = PetscSFBcastAndOpBegin(tl->scatter,unit,link->recvbuf,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpEnd(tl->scatter,unit,link->recvbuf,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpEnd(tl->local,unit,rootdata,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFTwoLevelReclaimLink(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastBegin_TwoLevel(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpBegin_TwoLevel(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastEnd_TwoLevel(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFBcastAndOpEnd_TwoLevel(sf,unit,rootdata,leafdata,MPIU_REPLACE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceBegin_TwoLevel(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_TwoLevel    *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode      ierr;
+  PetscSFTwoLevelLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFTwoLevelGetLink(sf,unit,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(tl->local,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(tl->scatter,unit,leafdata,link->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(tl->scatter,unit,leafdata,link->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  if (tl->exchange) {ierr = PetscSFBcastBegin(tl->exchange,unit,link->recvbuf,link->sendbuf);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_TwoLevel(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_TwoLevel    *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode      ierr;
+  PetscSFTwoLevelLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFTwoLevelGetLinkInUse(sf,unit,leafdata,&link);CHKERRQ(ierr);
+  if (tl->exchange) {ierr = PetscSFBcastEnd(tl->exchange,unit,link->recvbuf,link->sendbuf);CHKERRQ(ierr);}
+  ierr = PetscSFReduceBegin(tl->gather,unit,link->sendbuf,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(tl->gather,unit,link->sendbuf,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(tl->local,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFTwoLevelReclaimLink(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpBegin_TwoLevel(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF_TwoLevel    *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode      ierr;
+  PetscSFTwoLevelLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFTwoLevelGetLink(sf,unit,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpBegin(tl->local,unit,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(tl->scatter,unit,leafdata,link->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(tl->scatter,unit,leafdata,link->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  if (tl->exchange) {ierr = PetscSFBcastBegin(tl->exchange,unit,link->recvbuf,link->sendbuf);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpEnd_TwoLevel(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscSF_TwoLevel    *tl = (PetscSF_TwoLevel*)sf->data;
+  PetscErrorCode      ierr;
+  PetscSFTwoLevelLink link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFTwoLevelGetLinkInUse(sf,unit,leafdata,&link);CHKERRQ(ierr);
+  if (tl->exchange) {ierr = PetscSFBcastEnd(tl->exchange,unit,link->recvbuf,link->sendbuf);CHKERRQ(ierr);}
+  /* PETSCSFBASIC packs leafdata in PetscSFFetchAndOpBegin(), so the fetched values can replace it in sendbuf */
+  ierr = PetscSFFetchAndOpBegin(tl->gather,unit,rootdata,link->sendbuf,link->sendbuf,op);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpEnd(tl->gather,unit,rootdata,link->sendbuf,link->sendbuf,op);CHKERRQ(ierr);
+  if (tl->exchange) {
+    ierr = PetscSFReduceBegin(tl->exchange,unit,link->sendbuf,link->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(tl->exchange,unit,link->sendbuf,link->recvbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  }
+  ierr = PetscSFBcastBegin(tl->scatter,unit,link->recvbuf,leafupdate);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(tl->scatter,unit,link->recvbuf,leafupdate);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpEnd(tl->local,unit,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  ierr = PetscSFTwoLevelReclaimLink(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   PETSCSFTWOLEVEL - A PetscSF that communicates between nodes only through one process of each node
+
+   Notes:
+   PetscSFSetUp() groups the processes in nodes, those sharing memory by default. The data that the processes of a node
+   exchange with other nodes is first gathered on the node by its first process, the leader, which sends it in a single
+   message to the leader of each other node involved, and scattered on the receiving node. Each process then only
+   exchanges messages with the processes of its node and the leaders with the leaders of the neighboring nodes, so the
+   number of messages, and the cost of finding who communicates with whom in PetscSFSetUp(), grow with the number of
+   neighboring nodes instead of the number of neighboring processes. The price is copying the data twice more and the
+   reductions, including those of PetscSFFetchAndOpBegin(), being applied at the roots only.
+
+   The communication on the node and between the leaders is done with PETSCSFBASIC star forests.
+
+   Options Database Keys:
++  -sf_type twolevel - use this implementation, also for the vector scatters of type VECSCATTERSF
+-  -sf_twolevel_node_size <n> - form nodes of n processes of consecutive ranks instead of those sharing memory
+
+   Level: intermediate
+
+.seealso: PetscSFCreate(), PetscSFSetType(), PETSCSFBASIC, PETSCSFSHARED
+M*/
+PETSC_EXTERN PetscErrorCode PetscSFCreate_TwoLevel(PetscSF sf)
+{
+  PetscSF_TwoLevel *tl;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  sf->ops->SetUp           = PetscSFSetUp_TwoLevel;
+  sf->ops->SetFromOptions  = PetscSFSetFromOptions_TwoLevel;
+  sf->ops->Reset           = PetscSFReset_TwoLevel;
+  sf->ops->Destroy         = PetscSFDestroy_TwoLevel;
+  sf->ops->View            = PetscSFView_TwoLevel;
+  sf->ops->BcastBegin      = PetscSFBcastBegin_TwoLevel;
+  sf->ops->BcastEnd        = PetscSFBcastEnd_TwoLevel;
+  sf->ops->BcastAndOpBegin = PetscSFBcastAndOpBegin_TwoLevel;
+  sf->ops->BcastAndOpEnd   = PetscSFBcastAndOpEnd_TwoLevel;
+  sf->ops->ReduceBegin     = PetscSFReduceBegin_TwoLevel;
+  sf->ops->ReduceEnd       = PetscSFReduceEnd_TwoLevel;
+  sf->ops->FetchAndOpBegin = PetscSFFetchAndOpBegin_TwoLevel;
+  sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_TwoLevel;
+
+  ierr = PetscNewLog(sf,&tl);CHKERRQ(ierr);
+  tl->nodecomm   = MPI_COMM_NULL;
+  tl->leadercomm = MPI_COMM_NULL;
+  sf->data       = (void*)tl;
+  PetscFunctionReturn(0);
+}
@@ -226,7 +226,12 @@ PetscErrorCode PetscSFSetUp(PetscSF sf)
 
    Options Database Keys:
 +  -sf_type - implementation type, see PetscSFSetType()
--  -sf_rank_order - sort composite points for gathers and scatters in rank order, gathers are non-deterministic otherwise
+.  -sf_rank_order - sort composite points for gathers and scatters in rank order, gathers are non-deterministic otherwise
+.  -sf_basic_persistent - PETSCSFBASIC creates persistent MPI requests once per unit type and only starts them in each
+                          communication (default), with false it posts new MPI_Isend() and MPI_Irecv() each time
+-  -sf_basic_threads <n> - number of OpenMP threads adding the received PetscScalar to the roots in PetscSFReduceEnd() with
+                          MPI_SUM, 0 for omp_get_max_threads(); the first such reduction groups the entries in colors
+                          without repeated roots so that the threads need no atomics
 
    Level: intermediate
 
@@ -562,6 +567,10 @@ PetscErrorCode PetscSFGetLeafRange(PetscSF sf,PetscInt *minleaf,PetscInt *maxlea
 +  sf - star forest
 -  viewer - viewer to display graph, for example PETSC_VIEWER_STDOUT_WORLD
 
+   Notes:
+   With the format PETSC_VIEWER_ASCII_INFO, PETSCSFBASIC and the types derived from it also show, for each process, whether
+   the roots and leaves communicated with it are contiguous, strided, a 3D box or general.
+
    Level: beginner
 
 .seealso: PetscSFCreate(), PetscSFSetGraph()
@@ -1070,6 +1079,9 @@ PetscErrorCode PetscSFCreateEmbeddedLeafSF(PetscSF sf, PetscInt nleaves, const P
    Output Arguments:
 .  leafdata - buffer to update with values from each leaf's respective root
 
+   Notes:
+   rootdata must not be modified before PetscSFBcastEnd(), it may be sent directly instead of being copied.
+
    Level: intermediate
 
 .seealso: PetscSFCreate(), PetscSFSetGraph(), PetscSFView(), PetscSFBcastEnd(), PetscSFReduceBegin()
@@ -1131,6 +1143,9 @@ PetscErrorCode PetscSFBcastEnd(PetscSF sf,MPI_Datatype unit,const void *rootdata
    Output Arguments:
 .  leafdata - buffer to be reduced with values from each leaf's respective root
 
+   Notes:
+   rootdata must not be modified before PetscSFBcastAndOpEnd(), it may be sent directly instead of being copied.
+
    Level: intermediate
 
 .seealso: PetscSFBcastAndOpEnd(), PetscSFBcastBegin(), PetscSFBcastEnd()
@@ -1193,6 +1208,9 @@ PetscErrorCode PetscSFBcastAndOpEnd(PetscSF sf,MPI_Datatype unit,const void *roo
    Output Arguments:
 .  rootdata - result of reduction of values from all leaves of each root
 
+   Notes:
+   leafdata must not be modified before PetscSFReduceEnd(), it may be sent directly instead of being copied.
+
    Level: intermediate
 
 .seealso: PetscSFBcastBegin()
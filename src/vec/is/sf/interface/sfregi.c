@@ -4,6 +4,15 @@ PETSC_EXTERN PetscErrorCode PetscSFCreate_Basic(PetscSF);
 #if defined(PETSC_HAVE_MPI_WIN_CREATE) && defined(PETSC_HAVE_MPI_TYPE_DUP)
 PETSC_EXTERN PetscErrorCode PetscSFCreate_Window(PetscSF);
 #endif
+#if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+PETSC_EXTERN PetscErrorCode PetscSFCreate_Neighbor(PetscSF);
+#endif
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+PETSC_EXTERN PetscErrorCode PetscSFCreate_Shared(PetscSF);
+#endif
+#if defined(PETSC_HAVE_MPI_TYPE_DUP)
+PETSC_EXTERN PetscErrorCode PetscSFCreate_TwoLevel(PetscSF);
+#endif
 
 PetscFunctionList PetscSFList;
 PetscBool         PetscSFRegisterAllCalled;
@@ -29,6 +38,15 @@ PetscErrorCode  PetscSFRegisterAll(void)
   ierr = PetscSFRegister(PETSCSFBASIC,  PetscSFCreate_Basic);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MPI_WIN_CREATE) && defined(PETSC_HAVE_MPI_TYPE_DUP)
   ierr = PetscSFRegister(PETSCSFWINDOW, PetscSFCreate_Window);CHKERRQ(ierr);
+#endif
+#if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+  ierr = PetscSFRegister(PETSCSFNEIGHBOR,PetscSFCreate_Neighbor);CHKERRQ(ierr);
+#endif
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  ierr = PetscSFRegister(PETSCSFSHARED,  PetscSFCreate_Shared);CHKERRQ(ierr);
+#endif
+#if defined(PETSC_HAVE_MPI_TYPE_DUP)
+  ierr = PetscSFRegister(PETSCSFTWOLEVEL,PetscSFCreate_TwoLevel);CHKERRQ(ierr);
 #endif
   PetscFunctionReturn(0);
 }
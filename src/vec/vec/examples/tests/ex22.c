@@ -68,6 +68,18 @@ int main(int argc,char **argv)
       test:
         suffix: standard
         args: -vec_type standard
+      test:
+        requires: define(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+        suffix: sf_neighbor
+        args: -vec_type standard -vecscatter_type sf -sf_type neighbor
+      test:
+        requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+        suffix: sf_shared
+        args: -vec_type standard -vecscatter_type sf -sf_type shared
+      test:
+        requires: define(PETSC_HAVE_MPI_TYPE_DUP)
+        suffix: sf_twolevel
+        args: -vec_type standard -vecscatter_type sf -sf_type twolevel -sf_twolevel_node_size 2
       test:
         requires: cuda
         suffix: cuda
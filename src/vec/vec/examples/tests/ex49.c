@@ -0,0 +1,152 @@
+static char help[] = "Tests the fused VecWAXPYDotNorm() and VecAYPXAXPY() against the separate operations.\n\
+  -n <n> : local length of the vectors\n\n";
+
+#include <petscvec.h>
+
+static PetscErrorCode CheckVec(Vec u,Vec v,const char *name)
+{
+  PetscErrorCode ierr;
+  PetscReal      norm,err;
+  Vec            d;
+
+  PetscFunctionBeginUser;
+  ierr = VecDuplicate(u,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,u,v);CHKERRQ(ierr);
+  ierr = VecNorm(u,NORM_2,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_2,&err);CHKERRQ(ierr);
+  if (err > 100.0*PETSC_MACHINE_EPSILON*norm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: vector norm %g, vectors differ, error %g\n",name,(double)norm,(double)err);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: vector norm %g, vectors agree\n",name,(double)norm);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckScalar(PetscScalar a,PetscScalar b,const char *name,const char *what)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  if (PetscAbsScalar(a-b) > 1000.0*PETSC_MACHINE_EPSILON*PetscAbsScalar(a)) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s differs, %g versus %g\n",name,what,(double)PetscAbsScalar(a),(double)PetscAbsScalar(b));CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s %g, agrees\n",name,what,(double)PetscRealPart(a));CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* w = alpha x + y with (w,z) and ||w||, for a separate or an in place result and the possible choices of z */
+static PetscErrorCode TestWAXPYDotNorm(Vec x,Vec y,Vec z,PetscBool inplace,PetscInt zcase)
+{
+  PetscErrorCode ierr;
+  Vec            w[2],y1,zz[2];
+  PetscScalar    alpha = -0.75,dp[2] = {0.0,0.0};
+  PetscReal      nm[2],cached;
+  PetscInt       k;
+  char           name[64];
+
+  PetscFunctionBeginUser;
+  ierr = PetscSNPrintf(name,sizeof(name),"VecWAXPYDotNorm() %s, z case %D",inplace ? "in place" : "out of place",zcase);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&y1);CHKERRQ(ierr);
+  ierr = VecCopy(y,y1);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    if (inplace) w[k] = k ? y1 : y;
+    else {ierr = VecDuplicate(y,&w[k]);CHKERRQ(ierr);}
+    switch (zcase) {
+    case 0: zz[k] = NULL; break;
+    case 1: zz[k] = z; break;
+    case 2: zz[k] = w[k]; break;
+    case 3: zz[k] = x; break;
+    default: zz[k] = k ? y1 : y; break;
+    }
+  }
+  /* the separate operations */
+  if (inplace) {ierr = VecAXPY(w[0],alpha,x);CHKERRQ(ierr);}
+  else         {ierr = VecWAXPY(w[0],alpha,x,y);CHKERRQ(ierr);}
+  if (zz[0]) {ierr = VecDot(w[0],zz[0],&dp[0]);CHKERRQ(ierr);}
+  ierr = VecNorm(w[0],NORM_2,&nm[0]);CHKERRQ(ierr);
+  /* the fused operation */
+  ierr = VecWAXPYDotNorm(w[1],alpha,x,y1,zz[1],zz[1] ? &dp[1] : NULL,&nm[1]);CHKERRQ(ierr);
+  ierr = CheckVec(w[0],w[1],name);CHKERRQ(ierr);
+  ierr = CheckScalar(dp[0],dp[1],name,"dot");CHKERRQ(ierr);
+  ierr = CheckScalar(nm[0],nm[1],name,"norm");CHKERRQ(ierr);
+  ierr = VecNorm(w[1],NORM_2,&cached);CHKERRQ(ierr);
+  if (cached != nm[1]) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: the cached norm is not the computed one\n",name);CHKERRQ(ierr);}
+  if (inplace) {ierr = VecCopy(y1,y);CHKERRQ(ierr);}
+  else {
+    for (k=0; k<2; k++) {ierr = VecDestroy(&w[k]);CHKERRQ(ierr);}
+  }
+  ierr = VecDestroy(&y1);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TestAYPXAXPY(Vec x,Vec y,Vec w,PetscScalar beta)
+{
+  PetscErrorCode ierr;
+  Vec            y1,w1;
+  PetscScalar    alpha = 1.25;
+
+  PetscFunctionBeginUser;
+  ierr = VecDuplicate(y,&y1);CHKERRQ(ierr);
+  ierr = VecDuplicate(w,&w1);CHKERRQ(ierr);
+  ierr = VecCopy(y,y1);CHKERRQ(ierr);
+  ierr = VecCopy(w,w1);CHKERRQ(ierr);
+  ierr = VecAYPX(y,beta,x);CHKERRQ(ierr);
+  ierr = VecAXPY(w,alpha,y);CHKERRQ(ierr);
+  ierr = VecAYPXAXPY(y1,beta,x,alpha,w1);CHKERRQ(ierr);
+  ierr = CheckVec(y,y1,"VecAYPXAXPY() y");CHKERRQ(ierr);
+  ierr = CheckVec(w,w1,"VecAYPXAXPY() w");CHKERRQ(ierr);
+  ierr = VecDestroy(&y1);CHKERRQ(ierr);
+  ierr = VecDestroy(&w1);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  Vec            x,y,z,w;
+  PetscRandom    rctx;
+  PetscInt       n = 37,zcase;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rctx);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rctx);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rctx);CHKERRQ(ierr);
+  ierr = VecSetRandom(y,rctx);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rctx);CHKERRQ(ierr);
+  ierr = VecSetRandom(w,rctx);CHKERRQ(ierr);
+
+  for (zcase=0; zcase<5; zcase++) {
+    ierr = TestWAXPYDotNorm(x,y,z,PETSC_FALSE,zcase);CHKERRQ(ierr);
+    ierr = TestWAXPYDotNorm(x,y,z,PETSC_TRUE,zcase);CHKERRQ(ierr);
+  }
+  ierr = TestAYPXAXPY(x,y,w,0.5);CHKERRQ(ierr);
+  ierr = TestAYPXAXPY(x,y,w,0.0);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rctx);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -n 1000
+
+TEST*/
@@ -0,0 +1,141 @@
+static char help[] = "Tests reductions of arbitrary values combined with the split phase vector reductions.\n\
+  -n <n>     : local length of the vectors\n\
+  -nv <nv>   : number of values in each of the reductions\n\n";
+
+#include <petscvec.h>
+
+static PetscScalar Product(PetscScalar a,PetscScalar b)
+{
+  return a*b;
+}
+
+static PetscErrorCode CheckScalar(PetscScalar a,PetscScalar b,const char *name)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBeginUser;
+  if (PetscAbsScalar(a-b) > 1000.0*PETSC_MACHINE_EPSILON*PetscAbsScalar(a)) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: results differ, %g versus %g\n",name,(double)PetscAbsScalar(a),(double)PetscAbsScalar(b));CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: result %g, agrees\n",name,(double)PetscAbsScalar(a));CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* compares the values one by one, and prints their sum once they all agree */
+static PetscErrorCode CheckValues(const PetscScalar *a,const PetscScalar *b,PetscInt n,const char *name)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,ndiff = 0;
+  PetscReal      sum = 0.0;
+
+  PetscFunctionBeginUser;
+  for (i=0; i<n; i++) {
+    sum += PetscAbsScalar(a[i]);
+    if (PetscAbsScalar(a[i]-b[i]) > 1000.0*PETSC_MACHINE_EPSILON*PetscAbsScalar(a[i])) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: value %D differs, %g versus %g\n",name,i,(double)PetscAbsScalar(a[i]),(double)PetscAbsScalar(b[i]));CHKERRQ(ierr);
+      ndiff++;
+    }
+  }
+  if (!ndiff) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %D values with sum %g, agree\n",name,n,(double)sum);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode       ierr;
+  Vec                  x,y;
+  PetscInt             n = 20,nv = 12,i,k;
+  PetscMPIInt          rank,size;
+  PetscScalar          *local,*result[4],*expected[4],dot[2];
+  PetscReal            norm[2],*lreal,*greal;
+  PetscBool            done;
+  PetscSRReductionType types[4] = {PETSC_SR_REDUCE_SUM,PETSC_SR_REDUCE_MAX,PETSC_SR_REDUCE_MIN,PETSC_SR_REDUCE_SUM};
+  const char           *names[4] = {"sum","max","min","product"};
+  MPI_Comm             comm;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  comm = PETSC_COMM_WORLD;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nv",&nv,NULL);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = PetscSplitReductionRegisterOp(Product,&types[3]);CHKERRQ(ierr);
+
+  ierr = VecCreate(comm,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,NULL);CHKERRQ(ierr);
+  ierr = VecSetRandom(y,NULL);CHKERRQ(ierr);
+
+  ierr = PetscMalloc3(nv,&local,nv,&lreal,nv,&greal);CHKERRQ(ierr);
+  for (k=0; k<4; k++) {ierr = PetscMalloc2(nv,&result[k],nv,&expected[k]);CHKERRQ(ierr);}
+
+  /* the results of separate blocking reductions */
+  for (i=0; i<nv; i++) lreal[i] = 1.0 + (PetscReal)((rank+1)*(i+3)%7)/8.0;
+  ierr = MPIU_Allreduce(lreal,greal,nv,MPIU_REAL,MPIU_SUM,comm);CHKERRQ(ierr);
+  for (i=0; i<nv; i++) expected[0][i] = greal[i];
+  ierr = MPIU_Allreduce(lreal,greal,nv,MPIU_REAL,MPIU_MAX,comm);CHKERRQ(ierr);
+  for (i=0; i<nv; i++) expected[1][i] = greal[i];
+  ierr = MPIU_Allreduce(lreal,greal,nv,MPIU_REAL,MPIU_MIN,comm);CHKERRQ(ierr);
+  for (i=0; i<nv; i++) expected[2][i] = greal[i];
+  for (i=0; i<nv; i++) {
+    PetscMPIInt r;
+
+    expected[3][i] = 1.0;
+    for (r=0; r<size; r++) expected[3][i] *= 1.0 + (PetscReal)((r+1)*(i+3)%7)/8.0;
+  }
+  ierr = VecDot(x,y,&dot[0]);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_2,&norm[0]);CHKERRQ(ierr);
+
+  /* the same reductions queued together, more values than the initial size of the split reduction */
+  for (i=0; i<nv; i++) local[i] = lreal[i];
+  for (k=0; k<4; k++) {
+    ierr = PetscCommSplitReductionValuesBegin(comm,types[k],nv,local);CHKERRQ(ierr);
+    if (k == 1) {ierr = VecDotBegin(x,y,&dot[1]);CHKERRQ(ierr);}
+  }
+  ierr = VecNormBegin(x,NORM_2,&norm[1]);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+  do {
+    ierr = PetscCommSplitReductionTest(comm,&done);CHKERRQ(ierr);
+  } while (!done);
+  for (k=0; k<4; k++) {
+    ierr = PetscCommSplitReductionValuesEnd(comm,types[k],nv,result[k]);CHKERRQ(ierr);
+    if (k == 1) {ierr = VecDotEnd(x,y,&dot[1]);CHKERRQ(ierr);}
+  }
+  ierr = VecNormEnd(x,NORM_2,&norm[1]);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionTest(comm,&done);CHKERRQ(ierr);
+  if (done) {ierr = PetscPrintf(comm,"PetscCommSplitReductionTest() is true without a pending reduction\n");CHKERRQ(ierr);}
+
+  for (k=0; k<4; k++) {ierr = CheckValues(expected[k],result[k],nv,names[k]);CHKERRQ(ierr);}
+  ierr = CheckScalar(dot[0],dot[1],"VecDotBegin()");CHKERRQ(ierr);
+  ierr = CheckScalar(norm[0],norm[1],"VecNormBegin()");CHKERRQ(ierr);
+
+  /* a reduction of values alone, without PetscCommSplitReductionBegin() */
+  ierr = PetscCommSplitReductionValuesBegin(comm,PETSC_SR_REDUCE_MAX,nv,local);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionValuesEnd(comm,PETSC_SR_REDUCE_MAX,nv,result[1]);CHKERRQ(ierr);
+  ierr = CheckValues(expected[1],result[1],nv,"max alone");CHKERRQ(ierr);
+
+  for (k=0; k<4; k++) {ierr = PetscFree2(result[k],expected[k]);CHKERRQ(ierr);}
+  ierr = PetscFree3(local,lreal,greal);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 3
+
+   test:
+      suffix: 3
+      nsize: 3
+      args: -splitreduction_async 0 -nv 5
+
+TEST*/
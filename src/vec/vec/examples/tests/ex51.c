@@ -0,0 +1,98 @@
+static char help[] = "Tests VecMDot() and VecMAXPY() against VecDot() and VecAXPY() for the kernels selected with -vec_mdot_kernel.\n\
+  -n <n> : local length of the vectors\n\n";
+
+#include <petscvec.h>
+
+static PetscErrorCode TestMDotMAXPY(Vec x,PetscInt nv,Vec *y)
+{
+  PetscErrorCode ierr;
+  PetscScalar    *z,*alpha,dot;
+  PetscReal      nrm,err,sum;
+  PetscInt       k;
+  Vec            w;
+
+  PetscFunctionBeginUser;
+  ierr = PetscMalloc2(nv,&z,nv,&alpha);CHKERRQ(ierr);
+  ierr = VecMDot(x,nv,y,z);CHKERRQ(ierr);
+  for (k=0,sum=0.0; k<nv; k++) {
+    ierr = VecDot(x,y[k],&dot);CHKERRQ(ierr);
+    sum += PetscAbsScalar(dot);
+    if (PetscAbsScalar(dot-z[k]) > 1000.0*PETSC_MACHINE_EPSILON*PetscAbsScalar(dot)) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"VecMDot() with %D vectors: error in result %D %g\n",nv,k,(double)PetscAbsScalar(dot-z[k]));CHKERRQ(ierr);
+    }
+  }
+
+  for (k=0; k<nv; k++) alpha[k] = 1.0/(k+2.0) - 0.25;
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecCopy(x,w);CHKERRQ(ierr);
+  for (k=0; k<nv; k++) {ierr = VecAXPY(w,alpha[k],y[k]);CHKERRQ(ierr);}
+  ierr = VecMAXPY(x,nv,alpha,y);CHKERRQ(ierr);
+  ierr = VecNorm(w,NORM_2,&nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(w,-1.0,x);CHKERRQ(ierr);
+  ierr = VecNorm(w,NORM_2,&err);CHKERRQ(ierr);
+  if (err > 1000.0*PETSC_MACHINE_EPSILON*nrm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"VecMAXPY() with %D vectors: error %g\n",nv,(double)err);CHKERRQ(ierr);
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%D vectors: sum of the dots %g, norm %g\n",nv,(double)sum,(double)nrm);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = PetscFree2(z,alpha);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  Vec            x,*y;
+  PetscInt       n = 2053,nvs[] = {1,2,3,4,5,7,8,13,32,37},i,nvmax = 37;
+  PetscRandom    rctx;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rctx);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rctx);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  /* separate duplicates, so that the vectors are not handed to BLAS gemv as the contiguous ones from VecDuplicateVecs() */
+  ierr = PetscMalloc1(nvmax,&y);CHKERRQ(ierr);
+  for (i=0; i<nvmax; i++) {ierr = VecDuplicate(x,&y[i]);CHKERRQ(ierr);}
+  ierr = VecSetRandom(x,rctx);CHKERRQ(ierr);
+  for (i=0; i<nvmax; i++) {ierr = VecSetRandom(y[i],rctx);CHKERRQ(ierr);}
+
+  for (i=0; i<(PetscInt)(sizeof(nvs)/sizeof(nvs[0])); i++) {
+    ierr = TestMDotMAXPY(x,nvs[i],y);CHKERRQ(ierr);
+  }
+
+  for (i=0; i<nvmax; i++) {ierr = VecDestroy(&y[i]);CHKERRQ(ierr);}
+  ierr = PetscFree(y);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rctx);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -info
+      filter: grep -e "kernels for VecMDot" -e "vectors:"
+
+   test:
+      suffix: unrolled
+      args: -vec_mdot_kernel unrolled
+
+   test:
+      suffix: blocked
+      args: -vec_mdot_kernel blocked -n 1025 -info
+      filter: grep -e "kernels for VecMDot" -e "vectors:"
+
+   test:
+      suffix: avx2
+      args: -vec_mdot_kernel avx2 -n 7
+
+   test:
+      suffix: threads
+      nsize: 2
+      args: -vec_mdot_threads 3 -n 10001
+
+TEST*/
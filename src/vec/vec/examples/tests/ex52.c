@@ -0,0 +1,120 @@
+static char help[] = "Tests VecMDot() and VecMAXPY() on the contiguous vectors from VecDuplicateVecs() mixed with other vectors.\n\
+  -n <n> : local length of the vectors\n\n";
+
+#include <petscvec.h>
+
+static PetscErrorCode TestMDotMAXPY(Vec x,PetscInt nv,Vec *y,const char *name)
+{
+  PetscErrorCode ierr;
+  PetscScalar    *z,*alpha,dot;
+  PetscReal      nrm,err,sum;
+  PetscInt       k,ndiff;
+  Vec            w,v;
+
+  PetscFunctionBeginUser;
+  ierr = PetscMalloc2(nv,&z,nv,&alpha);CHKERRQ(ierr);
+  ierr = VecMDot(x,nv,y,z);CHKERRQ(ierr);
+  for (k=0,ndiff=0,sum=0.0; k<nv; k++) {
+    ierr = VecDot(x,y[k],&dot);CHKERRQ(ierr);
+    sum += PetscAbsScalar(dot);
+    if (PetscAbsScalar(dot-z[k]) > 1000.0*PETSC_MACHINE_EPSILON*PetscAbsScalar(dot)) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: VecMDot() result %D differs, %g versus %g\n",name,k,(double)PetscAbsScalar(dot),(double)PetscAbsScalar(z[k]));CHKERRQ(ierr);
+      ndiff++;
+    }
+  }
+  if (!ndiff) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: VecMDot() %D results with sum %g, agree\n",name,nv,(double)sum);CHKERRQ(ierr);}
+
+  for (k=0; k<nv; k++) alpha[k] = 1.0/(k+2.0) - 0.25;
+  ierr = VecDuplicate(x,&v);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecCopy(x,v);CHKERRQ(ierr);
+  ierr = VecCopy(x,w);CHKERRQ(ierr);
+  for (k=0; k<nv; k++) {ierr = VecAXPY(w,alpha[k],y[k]);CHKERRQ(ierr);}
+  ierr = VecMAXPY(v,nv,alpha,y);CHKERRQ(ierr);
+  ierr = VecNorm(w,NORM_2,&nrm);CHKERRQ(ierr);
+  ierr = VecAXPY(w,-1.0,v);CHKERRQ(ierr);
+  ierr = VecNorm(w,NORM_2,&err);CHKERRQ(ierr);
+  if (err > 1000.0*PETSC_MACHINE_EPSILON*nrm) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: VecMAXPY() norm %g, differs, error %g\n",name,(double)nrm,(double)err);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: VecMAXPY() norm %g, agrees\n",name,(double)nrm);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&v);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = PetscFree2(z,alpha);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode    ierr;
+  Vec               x,*y,*u,mixed[12];
+  PetscInt          n = 1031,i,m = 7,contiguous = 0;
+  const PetscScalar *y0,*yi;
+  PetscRandom       rctx;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rctx);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rctx);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,n,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rctx);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,m,&y);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,3,&u);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {ierr = VecSetRandom(y[i],rctx);CHKERRQ(ierr);}
+  for (i=0; i<3; i++) {ierr = VecSetRandom(u[i],rctx);CHKERRQ(ierr);}
+
+  /* the columns of one VecDuplicateVecs() are contiguous */
+  ierr = VecGetArrayRead(y[0],&y0);CHKERRQ(ierr);
+  for (i=1; i<m; i++) {
+    ierr = VecGetArrayRead(y[i],&yi);CHKERRQ(ierr);
+    if (yi != y0+i*n) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Vector %D of VecDuplicateVecs() is not contiguous with the first one\n",i);CHKERRQ(ierr);}
+    else contiguous++;
+    ierr = VecRestoreArrayRead(y[i],&yi);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(y[0],&y0);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%D of the %D vectors of VecDuplicateVecs() follow the first one\n",contiguous,m-1);CHKERRQ(ierr);
+  ierr = TestMDotMAXPY(x,m,y,"contiguous");CHKERRQ(ierr);
+
+  /* runs of contiguous vectors separated by vectors from elsewhere, including a duplicate of a column */
+  mixed[0] = u[2];
+  for (i=0; i<4; i++) mixed[1+i] = y[i];
+  mixed[5] = u[0];
+  mixed[6] = y[6];
+  mixed[7] = u[1];
+  mixed[8] = u[2];
+  ierr = VecDuplicate(y[4],&mixed[9]);CHKERRQ(ierr);
+  ierr = VecSetRandom(mixed[9],rctx);CHKERRQ(ierr);
+  mixed[10] = y[4];
+  mixed[11] = y[5];
+  ierr = TestMDotMAXPY(x,12,mixed,"mixed");CHKERRQ(ierr);
+
+  /* the block stays valid until its last vector is destroyed */
+  for (i=0; i<m-1; i++) {ierr = VecDestroy(&y[i]);CHKERRQ(ierr);}
+  ierr = TestMDotMAXPY(x,1,&y[m-1],"remaining");CHKERRQ(ierr);
+  ierr = TestMDotMAXPY(x,1,&mixed[9],"duplicate");CHKERRQ(ierr);
+  ierr = VecDestroy(&y[m-1]);CHKERRQ(ierr);
+  ierr = PetscFree(y);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(3,&u);CHKERRQ(ierr);
+  ierr = VecDestroy(&mixed[9]);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rctx);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+
+   test:
+      suffix: 2
+      nsize: 2
+
+   test:
+      suffix: nogemv
+      args: -vec_mdot_use_gemv 0 -vec_maxpy_use_gemv 0
+
+TEST*/
@@ -16,13 +16,17 @@ typedef struct {
 } Vec_Seq;
 
 PETSC_INTERN PetscErrorCode VecMDot_Seq(Vec,PetscInt,const Vec[],PetscScalar*);
+PETSC_INTERN PetscErrorCode VecMDot_Seq_Unrolled(Vec,PetscInt,const Vec[],PetscScalar*);
 PETSC_INTERN PetscErrorCode VecMTDot_Seq(Vec,PetscInt,const Vec[],PetscScalar*);
 PETSC_INTERN PetscErrorCode VecMin_Seq(Vec,PetscInt*,PetscReal*);
 PETSC_INTERN PetscErrorCode VecSet_Seq(Vec,PetscScalar);
 PETSC_INTERN PetscErrorCode VecMAXPY_Seq(Vec,PetscInt,const PetscScalar*,Vec*);
+PETSC_INTERN PetscErrorCode VecMAXPY_Seq_Unrolled(Vec,PetscInt,const PetscScalar*,Vec*);
 PETSC_INTERN PetscErrorCode VecAYPX_Seq(Vec,PetscScalar,Vec);
 PETSC_INTERN PetscErrorCode VecWAXPY_Seq(Vec,PetscScalar,Vec,Vec);
 PETSC_INTERN PetscErrorCode VecAXPBYPCZ_Seq(Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec);
+PETSC_INTERN PetscErrorCode VecWAXPYDotNorm_Seq(Vec,PetscScalar,Vec,Vec,Vec,PetscScalar*,PetscReal*);
+PETSC_INTERN PetscErrorCode VecAYPXAXPY_Seq(Vec,PetscScalar,Vec,PetscScalar,Vec);
 PETSC_INTERN PetscErrorCode VecMaxPointwiseDivide_Seq(Vec,Vec,PetscReal*);
 PETSC_INTERN PetscErrorCode VecPlaceArray_Seq(Vec,const PetscScalar*);
 PETSC_INTERN PetscErrorCode VecResetArray_Seq(Vec);
@@ -254,6 +254,8 @@ PetscErrorCode VecCreate_MPICUDA_Private(Vec vv,PetscBool alloc,PetscInt nghost,
   ierr = PetscObjectChangeTypeName((PetscObject)vv,VECMPICUDA);CHKERRQ(ierr);
 
   vv->ops->dotnorm2               = VecDotNorm2_MPICUDA;
+  vv->ops->waxpydotnorm           = NULL;
+  vv->ops->aypxaxpy               = NULL;
   vv->ops->waxpy                  = VecWAXPY_SeqCUDA;
   vv->ops->duplicate              = VecDuplicate_MPICUDA;
   vv->ops->dot                    = VecDot_MPICUDA;
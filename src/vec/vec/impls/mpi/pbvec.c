@@ -80,12 +80,61 @@ static PetscErrorCode VecDuplicate_MPI(Vec win,Vec *v)
 
   ierr = PetscObjectListDuplicate(((PetscObject)win)->olist,&((PetscObject)(*v))->olist);CHKERRQ(ierr);
   ierr = PetscFunctionListDuplicate(((PetscObject)win)->qlist,&((PetscObject)(*v))->qlist);CHKERRQ(ierr);
+  /* a duplicate of a column of VecDuplicateVecs_MPI() has its own storage */
+  ierr = PetscObjectCompose((PetscObject)*v,"VecContiguousArray",NULL);CHKERRQ(ierr);
 
   (*v)->map->bs   = PetscAbs(win->map->bs);
   (*v)->bstash.bs = win->bstash.bs;
   PetscFunctionReturn(0);
 }
 
+/*
+   VecDuplicateVecs_MPI - Duplicates a VECMPI without ghost points into m vectors whose local arrays are
+   the consecutive columns of one column-major block, see VecDuplicateVecs_Seq()
+*/
+static PetscErrorCode VecDuplicateVecs_MPI(Vec win,PetscInt m,Vec *V[])
+{
+  PetscErrorCode ierr;
+  Vec_MPI        *w = (Vec_MPI*)win->data;
+  PetscInt       i,n = win->map->n;
+  PetscBool      ismpi;
+  PetscScalar    *array;
+  PetscContainer container;
+  Vec            v;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(win,VEC_CLASSID,1);
+  PetscValidPointer(V,3);
+  ierr = PetscObjectTypeCompare((PetscObject)win,VECMPI,&ismpi);CHKERRQ(ierr);
+  if (!ismpi || w->nghost || w->localrep || m < 2) {
+    ierr = VecDuplicateVecs_Default(win,m,V);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscMalloc1(m,V);CHKERRQ(ierr);
+  ierr = PetscCalloc1((size_t)m*n,&array);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,array);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,PetscContainerUserDestroyDefault);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    ierr = VecCreate(PetscObjectComm((PetscObject)win),&v);CHKERRQ(ierr);
+    ierr = PetscLayoutReference(win->map,&v->map);CHKERRQ(ierr);
+    ierr = VecCreate_MPI_Private(v,PETSC_TRUE,0,array+(size_t)i*n);CHKERRQ(ierr);
+    ierr = PetscMemcpy(v->ops,win->ops,sizeof(struct _VecOps));CHKERRQ(ierr);
+    ierr = PetscObjectListDuplicate(((PetscObject)win)->olist,&((PetscObject)v)->olist);CHKERRQ(ierr);
+    ierr = PetscFunctionListDuplicate(((PetscObject)win)->qlist,&((PetscObject)v)->qlist);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject)v,"VecContiguousArray",(PetscObject)container);CHKERRQ(ierr);
+
+    v->stash.donotstash   = win->stash.donotstash;
+    v->stash.ignorenegidx = win->stash.ignorenegidx;
+    v->map->bs            = PetscAbs(win->map->bs);
+    v->bstash.bs          = win->bstash.bs;
+    (*V)[i]               = v;
+  }
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)(*V)[0],(size_t)m*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 
 static PetscErrorCode VecSetOption_MPI(Vec V,VecOption op,PetscBool flag)
 {
@@ -401,7 +450,7 @@ static PetscErrorCode VecSetFromOptions_MPI(PetscOptionItems *PetscOptionsObject
 
 
 static struct _VecOps DvOps = { VecDuplicate_MPI, /* 1 */
-                                VecDuplicateVecs_Default,
+                                VecDuplicateVecs_MPI,
                                 VecDestroyVecs_Default,
                                 VecDot_MPI,
                                 VecMDot_MPI,
@@ -469,7 +518,13 @@ static struct _VecOps DvOps = { VecDuplicate_MPI, /* 1 */
                                 VecStrideSubSetGather_Default,
                                 VecStrideSubSetScatter_Default,
                                 0,
-                                0
+                                0,
+                                0,
+                                0,
+                                0,
+                                0,
+                                VecWAXPYDotNorm_MPI,
+                                VecAYPXAXPY_Seq
 };
 
 /*
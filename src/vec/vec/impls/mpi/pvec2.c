@@ -80,6 +80,21 @@ PetscErrorCode VecNorm_MPI(Vec xin,NormType type,PetscReal *z)
 
 extern MPI_Op MPIU_MAXINDEX_OP, MPIU_MININDEX_OP;
 
+PetscErrorCode VecWAXPYDotNorm_MPI(Vec win,PetscScalar alpha,Vec xin,Vec yin,Vec zin,PetscScalar *dp,PetscReal *nm)
+{
+  PetscScalar    work[2],sum[2];
+  PetscReal      nmx;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr    = VecWAXPYDotNorm_Seq(win,alpha,xin,yin,zin,&work[0],&nmx);CHKERRQ(ierr);
+  work[1] = nmx;
+  ierr    = MPIU_Allreduce(work,sum,2,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)win));CHKERRQ(ierr);
+  *dp     = sum[0];
+  *nm     = PetscRealPart(sum[1]);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode VecMax_MPI(Vec xin,PetscInt *idx,PetscReal *z)
 {
   PetscErrorCode ierr;
@@ -817,13 +817,64 @@ PetscErrorCode VecDuplicate_Seq(Vec win,Vec *V)
   ierr = PetscObjectListDuplicate(((PetscObject)win)->olist,&((PetscObject)(*V))->olist);CHKERRQ(ierr);
   ierr = PetscFunctionListDuplicate(((PetscObject)win)->qlist,&((PetscObject)(*V))->qlist);CHKERRQ(ierr);
 
+  /* a duplicate of a column of VecDuplicateVecs_Seq() has its own storage */
+  ierr = PetscObjectCompose((PetscObject)*V,"VecContiguousArray",NULL);CHKERRQ(ierr);
+
   (*V)->ops->view          = win->ops->view;
   (*V)->stash.ignorenegidx = win->stash.ignorenegidx;
   PetscFunctionReturn(0);
 }
 
+/*
+   VecDuplicateVecs_Seq - Duplicates a VECSEQ into m vectors whose arrays are the consecutive
+   columns of one m*n column-major block, so VecMDot_Seq() and VecMAXPY_Seq() can process them
+   with a single BLAS gemv. The block is kept in a PetscContainer composed with each of the vectors
+   and is freed when the last of them is destroyed.
+*/
+static PetscErrorCode VecDuplicateVecs_Seq(Vec w,PetscInt m,Vec *V[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i,n = w->map->n;
+  PetscBool      isseq;
+  PetscScalar    *array;
+  PetscContainer container;
+  Vec            v;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(w,VEC_CLASSID,1);
+  PetscValidPointer(V,3);
+  ierr = PetscObjectTypeCompare((PetscObject)w,VECSEQ,&isseq);CHKERRQ(ierr);
+#if defined(PETSC_USE_MIXED_PRECISION)
+  isseq = PETSC_FALSE;
+#endif
+  if (!isseq || m < 2) {
+    ierr = VecDuplicateVecs_Default(w,m,V);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscMalloc1(m,V);CHKERRQ(ierr);
+  ierr = PetscCalloc1((size_t)m*n,&array);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,array);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,PetscContainerUserDestroyDefault);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    ierr = VecCreate(PetscObjectComm((PetscObject)w),&v);CHKERRQ(ierr);
+    ierr = PetscLayoutReference(w->map,&v->map);CHKERRQ(ierr);
+    ierr = VecCreate_Seq_Private(v,array+(size_t)i*n);CHKERRQ(ierr);
+    ierr = PetscObjectListDuplicate(((PetscObject)w)->olist,&((PetscObject)v)->olist);CHKERRQ(ierr);
+    ierr = PetscFunctionListDuplicate(((PetscObject)w)->qlist,&((PetscObject)v)->qlist);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject)v,"VecContiguousArray",(PetscObject)container);CHKERRQ(ierr);
+
+    v->ops->view          = w->ops->view;
+    v->stash.ignorenegidx = w->stash.ignorenegidx;
+    (*V)[i]               = v;
+  }
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)(*V)[0],(size_t)m*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static struct _VecOps DvOps = {VecDuplicate_Seq, /* 1 */
-                               VecDuplicateVecs_Default,
+                               VecDuplicateVecs_Seq,
                                VecDestroyVecs_Default,
                                VecDot_Seq,
                                VecMDot_Seq,
@@ -890,7 +941,13 @@ static struct _VecOps DvOps = {VecDuplicate_Seq, /* 1 */
                                VecStrideSubSetGather_Default,
                                VecStrideSubSetScatter_Default,
                                0,
-                               0
+                               0,
+                               0,
+                               0,
+                               0,
+                               0,
+                               VecWAXPYDotNorm_Seq,
+                               VecAYPXAXPY_Seq
 };
 
 
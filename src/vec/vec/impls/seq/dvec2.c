@@ -10,7 +10,7 @@
 
 #if defined(PETSC_USE_FORTRAN_KERNEL_MDOT)
 #include <../src/vec/vec/impls/seq/ftn-kernels/fmdot.h>
-PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+PetscErrorCode VecMDot_Seq_Unrolled(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
 {
   PetscErrorCode    ierr;
   PetscInt          i,nv_rem,n = xin->map->n;
@@ -91,7 +91,7 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
 }
 
 #else
-PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+PetscErrorCode VecMDot_Seq_Unrolled(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
 {
   PetscErrorCode    ierr;
   PetscInt          n = xin->map->n,i,j,nv_rem,j_rem;
@@ -553,7 +553,7 @@ PetscErrorCode VecSet_Seq(Vec xin,PetscScalar alpha)
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode VecMAXPY_Seq(Vec xin, PetscInt nv,const PetscScalar *alpha,Vec *y)
+PetscErrorCode VecMAXPY_Seq_Unrolled(Vec xin, PetscInt nv,const PetscScalar *alpha,Vec *y)
 {
   PetscErrorCode    ierr;
   PetscInt          n = xin->map->n,j,j_rem;
@@ -711,6 +711,93 @@ PetscErrorCode VecWAXPY_Seq(Vec win, PetscScalar alpha,Vec xin,Vec yin)
   PetscFunctionReturn(0);
 }
 
+/*
+   Fused w = alpha x + y followed by the local parts of (w,z) and (w,w), each vector is read once.
+   w may be y and z may be any of the vectors or NULL; nm returns the square of the norm.
+*/
+PetscErrorCode VecWAXPYDotNorm_Seq(Vec win,PetscScalar alpha,Vec xin,Vec yin,Vec zin,PetscScalar *dp,PetscReal *nm)
+{
+  PetscErrorCode    ierr;
+  PetscInt          i,n = win->map->n;
+  PetscScalar       *ww,t,dpx = 0.0;
+  PetscReal         nmx = 0.0;
+  const PetscScalar *xx,*yy,*zz;
+
+  PetscFunctionBegin;
+  ierr = VecGetArray(win,&ww);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
+  if (yin == win) yy = ww;
+  else {ierr = VecGetArrayRead(yin,&yy);CHKERRQ(ierr);}
+  if (!zin) {
+    for (i=0; i<n; i++) {
+      t      = yy[i] + alpha*xx[i];
+      ww[i]  = t;
+      nmx   += PetscRealPart(t*PetscConj(t));
+    }
+  } else if (zin == win) {
+    for (i=0; i<n; i++) {
+      t      = yy[i] + alpha*xx[i];
+      ww[i]  = t;
+      nmx   += PetscRealPart(t*PetscConj(t));
+    }
+    dpx = nmx;
+  } else {
+    if (zin == xin) zz = xx;
+    else if (zin == yin) zz = yy;
+    else {ierr = VecGetArrayRead(zin,&zz);CHKERRQ(ierr);}
+    for (i=0; i<n; i++) {
+      t      = yy[i] + alpha*xx[i];
+      ww[i]  = t;
+      dpx   += t*PetscConj(zz[i]);
+      nmx   += PetscRealPart(t*PetscConj(t));
+    }
+    if (zin != xin && zin != yin) {ierr = VecRestoreArrayRead(zin,&zz);CHKERRQ(ierr);}
+  }
+  if (yin != win) {ierr = VecRestoreArrayRead(yin,&yy);CHKERRQ(ierr);}
+  ierr = VecRestoreArrayRead(xin,&xx);CHKERRQ(ierr);
+  ierr = VecRestoreArray(win,&ww);CHKERRQ(ierr);
+  ierr = PetscLogFlops((zin && zin != win ? 6.0 : 4.0)*n);CHKERRQ(ierr);
+  *dp  = dpx;
+  *nm  = nmx;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Fused y = x + beta y followed by w = w + alpha y, the new y is used while it is still in register
+*/
+PetscErrorCode VecAYPXAXPY_Seq(Vec yin,PetscScalar beta,Vec xin,PetscScalar alpha,Vec win)
+{
+  PetscErrorCode    ierr;
+  PetscInt          i,n = yin->map->n;
+  PetscScalar       *yy,*ww,t;
+  const PetscScalar *xx;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
+  ierr = VecGetArray(yin,&yy);CHKERRQ(ierr);
+  ierr = VecGetArray(win,&ww);CHKERRQ(ierr);
+  if (beta == (PetscScalar)0.0) {
+    /* as in VecAYPX() the old values of y are not used, they may not even be set */
+    for (i=0; i<n; i++) {
+      t      = xx[i];
+      yy[i]  = t;
+      ww[i] += alpha*t;
+    }
+    ierr = PetscLogFlops(2.0*n);CHKERRQ(ierr);
+  } else {
+    for (i=0; i<n; i++) {
+      t      = xx[i] + beta*yy[i];
+      yy[i]  = t;
+      ww[i] += alpha*t;
+    }
+    ierr = PetscLogFlops(4.0*n);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(xin,&xx);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yin,&yy);CHKERRQ(ierr);
+  ierr = VecRestoreArray(win,&ww);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode VecMaxPointwiseDivide_Seq(Vec xin,Vec yin,PetscReal *max)
 {
   PetscErrorCode    ierr;
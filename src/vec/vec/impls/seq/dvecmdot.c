@@ -0,0 +1,506 @@
+
+/*
+    Blocked VecMDot() and VecMAXPY() for the sequential vectors (and the local part of the parallel ones), used by the
+  orthogonalizations of GMRES and its relatives. The vectors are processed in tiles of VEC_MDOT_TILE entries; within a
+  tile all the vectors go by while the tile of x stays in the L1 cache, so x is read (and for VecMAXPY() written) once
+  instead of once for every four vectors as in the unrolled kernels of dvec2.c. The loops over a tile may use AVX2 or
+  AVX-512, and with -vec_mdot_threads the tiles are split between OpenMP threads.
+
+    -vec_mdot_kernel <unrolled,blocked,avx2,avx512> selects the kernels. The default remains unrolled, the kernels of
+  dvec2.c, so that results do not depend on the CPU; the blocked and SIMD kernels are only used when asked for, and
+  -vec_mdot_threads alone selects blocked. A SIMD kernel the CPU does not support falls back to the best one it does.
+
+    Vectors from VecDuplicateVecs() share one column-major block, see VecDuplicateVecs_Seq(); runs of them whose arrays
+  are consecutive columns are handed to a single BLAS gemv instead, unless -vec_mdot_use_gemv 0 (-vec_maxpy_use_gemv 0).
+*/
+#include <../src/vec/vec/impls/dvecimpl.h>
+#include <petscblaslapack.h>
+
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(PETSC_HAVE_ATTRIBUTE_TARGET) && defined(PETSC_HAVE_BUILTIN_CPU_SUPPORTS) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+#define VEC_MDOT_AVX_KERNELS
+#include <immintrin.h>
+#endif
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+#define VEC_MDOT_TILE  1024 /* entries of x that stay in cache while the vectors go by */
+#define VEC_MDOT_BATCH 32   /* number of vectors whose arrays are obtained at once */
+
+typedef enum {VEC_MDOT_KERNEL_UNROLLED,VEC_MDOT_KERNEL_BLOCKED,VEC_MDOT_KERNEL_AVX2,VEC_MDOT_KERNEL_AVX512} VecMDotKernelType;
+static const char *const VecMDotKernelTypes[] = {"unrolled","blocked","avx2","avx512"};
+
+static VecMDotKernelType VecMDotKernel   = VEC_MDOT_KERNEL_UNROLLED;
+static PetscInt          VecMDotThreads  = 1;
+static PetscBool         VecMDotUseGEMV  = PETSC_TRUE;
+static PetscBool         VecMAXPYUseGEMV = PETSC_TRUE;
+
+typedef void (*VecMDotTileFunction)(PetscInt,const PetscScalar*,PetscInt,const PetscScalar*const*,PetscInt,PetscScalar*);
+typedef void (*VecMAXPYTileFunction)(PetscInt,PetscScalar*,PetscInt,const PetscScalar*,const PetscScalar*const*,PetscInt);
+
+/* z[k] += sum_i x[i] conj(y[k][off+i]) for the n entries of a tile and the nv vectors */
+static void VecMDotTile_Blocked(PetscInt n,const PetscScalar *x,PetscInt nv,const PetscScalar *const *y,PetscInt off,PetscScalar *z)
+{
+  PetscInt          i,k;
+  const PetscScalar *y0,*y1,*y2,*y3;
+  PetscScalar       s0,s1,s2,s3,xi;
+
+  for (k=0; k+4<=nv; k+=4) {
+    y0 = y[k]+off; y1 = y[k+1]+off; y2 = y[k+2]+off; y3 = y[k+3]+off;
+    s0 = s1 = s2 = s3 = 0.0;
+    for (i=0; i<n; i++) {
+      xi  = x[i];
+      s0 += xi*PetscConj(y0[i]); s1 += xi*PetscConj(y1[i]);
+      s2 += xi*PetscConj(y2[i]); s3 += xi*PetscConj(y3[i]);
+    }
+    z[k] += s0; z[k+1] += s1; z[k+2] += s2; z[k+3] += s3;
+  }
+  for (; k<nv; k++) {
+    y0 = y[k]+off;
+    s0 = 0.0;
+    for (i=0; i<n; i++) s0 += x[i]*PetscConj(y0[i]);
+    z[k] += s0;
+  }
+}
+
+/* x[i] += sum_k alpha[k] y[k][off+i] for the n entries of a tile and the nv vectors */
+static void VecMAXPYTile_Blocked(PetscInt n,PetscScalar *x,PetscInt nv,const PetscScalar *alpha,const PetscScalar *const *y,PetscInt off)
+{
+  PetscInt          i,k;
+  const PetscScalar *y0,*y1,*y2,*y3;
+  PetscScalar       a0,a1,a2,a3;
+
+  for (k=0; k+4<=nv; k+=4) {
+    y0 = y[k]+off; y1 = y[k+1]+off; y2 = y[k+2]+off; y3 = y[k+3]+off;
+    a0 = alpha[k]; a1 = alpha[k+1]; a2 = alpha[k+2]; a3 = alpha[k+3];
+    for (i=0; i<n; i++) x[i] += a0*y0[i] + a1*y1[i] + a2*y2[i] + a3*y3[i];
+  }
+  for (; k<nv; k++) {
+    y0 = y[k]+off;
+    a0 = alpha[k];
+    for (i=0; i<n; i++) x[i] += a0*y0[i];
+  }
+}
+
+#if defined(VEC_MDOT_AVX_KERNELS)
+__attribute__((target("avx2,fma")))
+PETSC_STATIC_INLINE double VecMDotReduce_AVX2(__m256d s)
+{
+  __m128d t = _mm_add_pd(_mm256_castpd256_pd128(s),_mm256_extractf128_pd(s,1));
+  return _mm_cvtsd_f64(_mm_add_sd(t,_mm_unpackhi_pd(t,t)));
+}
+
+__attribute__((target("avx2,fma")))
+static void VecMDotTile_AVX2(PetscInt n,const PetscScalar *x,PetscInt nv,const PetscScalar *const *y,PetscInt off,PetscScalar *z)
+{
+  PetscInt          i,k,nr = n - n%4;
+  const PetscScalar *y0,*y1,*y2,*y3;
+  PetscScalar       t0,t1,t2,t3;
+  __m256d           xv,s0,s1,s2,s3;
+
+  for (k=0; k+4<=nv; k+=4) {
+    y0 = y[k]+off; y1 = y[k+1]+off; y2 = y[k+2]+off; y3 = y[k+3]+off;
+    s0 = s1 = s2 = s3 = _mm256_setzero_pd();
+    for (i=0; i<nr; i+=4) {
+      xv = _mm256_loadu_pd(x+i);
+      s0 = _mm256_fmadd_pd(xv,_mm256_loadu_pd(y0+i),s0);
+      s1 = _mm256_fmadd_pd(xv,_mm256_loadu_pd(y1+i),s1);
+      s2 = _mm256_fmadd_pd(xv,_mm256_loadu_pd(y2+i),s2);
+      s3 = _mm256_fmadd_pd(xv,_mm256_loadu_pd(y3+i),s3);
+    }
+    t0 = t1 = t2 = t3 = 0.0;
+    for (; i<n; i++) {t0 += x[i]*y0[i]; t1 += x[i]*y1[i]; t2 += x[i]*y2[i]; t3 += x[i]*y3[i];}
+    z[k]   += VecMDotReduce_AVX2(s0) + t0;
+    z[k+1] += VecMDotReduce_AVX2(s1) + t1;
+    z[k+2] += VecMDotReduce_AVX2(s2) + t2;
+    z[k+3] += VecMDotReduce_AVX2(s3) + t3;
+  }
+  for (; k<nv; k++) {
+    y0 = y[k]+off;
+    s0 = _mm256_setzero_pd();
+    for (i=0; i<nr; i+=4) s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x+i),_mm256_loadu_pd(y0+i),s0);
+    t0 = 0.0;
+    for (; i<n; i++) t0 += x[i]*y0[i];
+    z[k] += VecMDotReduce_AVX2(s0) + t0;
+  }
+}
+
+__attribute__((target("avx2,fma")))
+static void VecMAXPYTile_AVX2(PetscInt n,PetscScalar *x,PetscInt nv,const PetscScalar *alpha,const PetscScalar *const *y,PetscInt off)
+{
+  PetscInt          i,k,nr = n - n%4;
+  const PetscScalar *y0,*y1,*y2,*y3;
+  __m256d           xv,a0,a1,a2,a3;
+
+  for (k=0; k+4<=nv; k+=4) {
+    y0 = y[k]+off; y1 = y[k+1]+off; y2 = y[k+2]+off; y3 = y[k+3]+off;
+    a0 = _mm256_set1_pd(alpha[k]);   a1 = _mm256_set1_pd(alpha[k+1]);
+    a2 = _mm256_set1_pd(alpha[k+2]); a3 = _mm256_set1_pd(alpha[k+3]);
+    for (i=0; i<nr; i+=4) {
+      xv = _mm256_loadu_pd(x+i);
+      xv = _mm256_fmadd_pd(a0,_mm256_loadu_pd(y0+i),xv);
+      xv = _mm256_fmadd_pd(a1,_mm256_loadu_pd(y1+i),xv);
+      xv = _mm256_fmadd_pd(a2,_mm256_loadu_pd(y2+i),xv);
+      xv = _mm256_fmadd_pd(a3,_mm256_loadu_pd(y3+i),xv);
+      _mm256_storeu_pd(x+i,xv);
+    }
+    for (; i<n; i++) x[i] += alpha[k]*y0[i] + alpha[k+1]*y1[i] + alpha[k+2]*y2[i] + alpha[k+3]*y3[i];
+  }
+  for (; k<nv; k++) {
+    y0 = y[k]+off;
+    a0 = _mm256_set1_pd(alpha[k]);
+    for (i=0; i<nr; i+=4) _mm256_storeu_pd(x+i,_mm256_fmadd_pd(a0,_mm256_loadu_pd(y0+i),_mm256_loadu_pd(x+i)));
+    for (; i<n; i++) x[i] += alpha[k]*y0[i];
+  }
+}
+
+/* the last n%8 entries of a tile are handled with masked loads and stores */
+__attribute__((target("avx512f")))
+static void VecMDotTile_AVX512(PetscInt n,const PetscScalar *x,PetscInt nv,const PetscScalar *const *y,PetscInt off,PetscScalar *z)
+{
+  PetscInt          i,k,nr = n - n%8;
+  const PetscScalar *y0,*y1,*y2,*y3;
+  __mmask8          mask = (__mmask8)(0xff >> (8 - n%8));
+  __m512d           xv,s0,s1,s2,s3;
+
+  for (k=0; k+4<=nv; k+=4) {
+    y0 = y[k]+off; y1 = y[k+1]+off; y2 = y[k+2]+off; y3 = y[k+3]+off;
+    s0 = s1 = s2 = s3 = _mm512_setzero_pd();
+    for (i=0; i<nr; i+=8) {
+      xv = _mm512_loadu_pd(x+i);
+      s0 = _mm512_fmadd_pd(xv,_mm512_loadu_pd(y0+i),s0);
+      s1 = _mm512_fmadd_pd(xv,_mm512_loadu_pd(y1+i),s1);
+      s2 = _mm512_fmadd_pd(xv,_mm512_loadu_pd(y2+i),s2);
+      s3 = _mm512_fmadd_pd(xv,_mm512_loadu_pd(y3+i),s3);
+    }
+    if (nr < n) {
+      xv = _mm512_maskz_loadu_pd(mask,x+nr);
+      s0 = _mm512_fmadd_pd(xv,_mm512_maskz_loadu_pd(mask,y0+nr),s0);
+      s1 = _mm512_fmadd_pd(xv,_mm512_maskz_loadu_pd(mask,y1+nr),s1);
+      s2 = _mm512_fmadd_pd(xv,_mm512_maskz_loadu_pd(mask,y2+nr),s2);
+      s3 = _mm512_fmadd_pd(xv,_mm512_maskz_loadu_pd(mask,y3+nr),s3);
+    }
+    z[k]   += _mm512_reduce_add_pd(s0);
+    z[k+1] += _mm512_reduce_add_pd(s1);
+    z[k+2] += _mm512_reduce_add_pd(s2);
+    z[k+3] += _mm512_reduce_add_pd(s3);
+  }
+  for (; k<nv; k++) {
+    y0 = y[k]+off;
+    s0 = _mm512_setzero_pd();
+    for (i=0; i<nr; i+=8) s0 = _mm512_fmadd_pd(_mm512_loadu_pd(x+i),_mm512_loadu_pd(y0+i),s0);
+    if (nr < n) s0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask,x+nr),_mm512_maskz_loadu_pd(mask,y0+nr),s0);
+    z[k] += _mm512_reduce_add_pd(s0);
+  }
+}
+
+__attribute__((target("avx512f")))
+static void VecMAXPYTile_AVX512(PetscInt n,PetscScalar *x,PetscInt nv,const PetscScalar *alpha,const PetscScalar *const *y,PetscInt off)
+{
+  PetscInt          i,k,nr = n - n%8;
+  const PetscScalar *y0,*y1,*y2,*y3;
+  __mmask8          mask = (__mmask8)(0xff >> (8 - n%8));
+  __m512d           xv,a0,a1,a2,a3;
+
+  for (k=0; k+4<=nv; k+=4) {
+    y0 = y[k]+off; y1 = y[k+1]+off; y2 = y[k+2]+off; y3 = y[k+3]+off;
+    a0 = _mm512_set1_pd(alpha[k]);   a1 = _mm512_set1_pd(alpha[k+1]);
+    a2 = _mm512_set1_pd(alpha[k+2]); a3 = _mm512_set1_pd(alpha[k+3]);
+    for (i=0; i<nr; i+=8) {
+      xv = _mm512_loadu_pd(x+i);
+      xv = _mm512_fmadd_pd(a0,_mm512_loadu_pd(y0+i),xv);
+      xv = _mm512_fmadd_pd(a1,_mm512_loadu_pd(y1+i),xv);
+      xv = _mm512_fmadd_pd(a2,_mm512_loadu_pd(y2+i),xv);
+      xv = _mm512_fmadd_pd(a3,_mm512_loadu_pd(y3+i),xv);
+      _mm512_storeu_pd(x+i,xv);
+    }
+    if (nr < n) {
+      xv = _mm512_maskz_loadu_pd(mask,x+nr);
+      xv = _mm512_fmadd_pd(a0,_mm512_maskz_loadu_pd(mask,y0+nr),xv);
+      xv = _mm512_fmadd_pd(a1,_mm512_maskz_loadu_pd(mask,y1+nr),xv);
+      xv = _mm512_fmadd_pd(a2,_mm512_maskz_loadu_pd(mask,y2+nr),xv);
+      xv = _mm512_fmadd_pd(a3,_mm512_maskz_loadu_pd(mask,y3+nr),xv);
+      _mm512_mask_storeu_pd(x+nr,mask,xv);
+    }
+  }
+  for (; k<nv; k++) {
+    y0 = y[k]+off;
+    a0 = _mm512_set1_pd(alpha[k]);
+    for (i=0; i<nr; i+=8) _mm512_storeu_pd(x+i,_mm512_fmadd_pd(a0,_mm512_loadu_pd(y0+i),_mm512_loadu_pd(x+i)));
+    if (nr < n) _mm512_mask_storeu_pd(x+nr,mask,_mm512_fmadd_pd(a0,_mm512_maskz_loadu_pd(mask,y0+nr),_mm512_maskz_loadu_pd(mask,x+nr)));
+  }
+}
+#endif
+
+static void VecMDotRange_Private(VecMDotTileFunction tile,PetscInt start,PetscInt end,const PetscScalar *x,PetscInt nv,const PetscScalar *const *y,PetscScalar *z)
+{
+  PetscInt i;
+
+  for (i=start; i<end; i+=VEC_MDOT_TILE) (*tile)(PetscMin(VEC_MDOT_TILE,end-i),x+i,nv,y,i,z);
+}
+
+static void VecMAXPYRange_Private(VecMAXPYTileFunction tile,PetscInt start,PetscInt end,PetscScalar *x,PetscInt nv,const PetscScalar *alpha,const PetscScalar *const *y)
+{
+  PetscInt i;
+
+  for (i=start; i<end; i+=VEC_MDOT_TILE) (*tile)(PetscMin(VEC_MDOT_TILE,end-i),x+i,nv,alpha,y,i);
+}
+
+#if defined(PETSC_HAVE_OPENMP)
+/* the part of the n entries handled by thread tid of nth, the boundaries are multiples of 8 so that SIMD loads stay aligned with the vector start */
+PETSC_STATIC_INLINE void VecMDotThreadRange_Private(PetscInt n,PetscInt tid,PetscInt nth,PetscInt *start,PetscInt *end)
+{
+  *start = (PetscInt)(((PetscInt64)n*tid/nth)/8*8);
+  *end   = (tid == nth-1) ? n : (PetscInt)(((PetscInt64)n*(tid+1)/nth)/8*8);
+}
+#endif
+
+/*
+   VecMDotSeqInitialize_Private - Selects the kernels of VecMDot_Seq() and VecMAXPY_Seq() from the CPU and the options
+   -vec_mdot_kernel, -vec_mdot_threads, -vec_mdot_use_gemv and -vec_maxpy_use_gemv; called by VecInitializePackage()
+*/
+PetscErrorCode VecMDotSeqInitialize_Private(void)
+{
+  PetscErrorCode    ierr;
+  VecMDotKernelType best = VEC_MDOT_KERNEL_BLOCKED;
+  PetscInt          kernel,nthreads = 1;
+  PetscBool         flg,set;
+
+  PetscFunctionBegin;
+#if defined(VEC_MDOT_AVX_KERNELS)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) best = VEC_MDOT_KERNEL_AVX512;
+  else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) best = VEC_MDOT_KERNEL_AVX2;
+#endif
+  VecMDotKernel = VEC_MDOT_KERNEL_UNROLLED;
+  ierr = PetscOptionsGetEList(NULL,NULL,"-vec_mdot_kernel",VecMDotKernelTypes,4,&kernel,&flg);CHKERRQ(ierr);
+  if (flg) {
+    if (kernel > (PetscInt)best) {
+      ierr = PetscInfo2(NULL,"The %s kernels for VecMDot() are not available, using %s\n",VecMDotKernelTypes[kernel],VecMDotKernelTypes[best]);CHKERRQ(ierr);
+      VecMDotKernel = best;
+    } else VecMDotKernel = (VecMDotKernelType)kernel;
+  }
+  ierr = PetscOptionsGetInt(NULL,NULL,"-vec_mdot_threads",&nthreads,&set);CHKERRQ(ierr);
+  if (set && !flg) VecMDotKernel = VEC_MDOT_KERNEL_BLOCKED;
+  if (nthreads < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D cannot be negative",nthreads);
+#if defined(PETSC_HAVE_OPENMP)
+  if (!nthreads) nthreads = omp_get_max_threads();
+#else
+  if (nthreads != 1) {
+    ierr     = PetscInfo(NULL,"Ignoring -vec_mdot_threads since PETSc was not configured with OpenMP\n");CHKERRQ(ierr);
+    nthreads = 1;
+  }
+#endif
+  VecMDotThreads = nthreads;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-vec_mdot_use_gemv",&VecMDotUseGEMV,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-vec_maxpy_use_gemv",&VecMAXPYUseGEMV,NULL);CHKERRQ(ierr);
+  ierr = PetscInfo2(NULL,"Using the %s kernels for VecMDot() and VecMAXPY() with %D threads\n",VecMDotKernelTypes[VecMDotKernel],VecMDotThreads);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecMDot_Seq_Blocked(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode      ierr;
+  PetscInt            n = xin->map->n,nt = VecMDotThreads,nb,b,k;
+  const PetscScalar   *x,*y[VEC_MDOT_BATCH];
+  PetscScalar         *work = NULL;
+  VecMDotTileFunction tile = VecMDotTile_Blocked;
+
+  PetscFunctionBegin;
+  if (VecMDotKernel == VEC_MDOT_KERNEL_UNROLLED) {
+    ierr = VecMDot_Seq_Unrolled(xin,nv,yin,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#if defined(VEC_MDOT_AVX_KERNELS)
+  if (VecMDotKernel == VEC_MDOT_KERNEL_AVX512) tile = VecMDotTile_AVX512;
+  else if (VecMDotKernel == VEC_MDOT_KERNEL_AVX2) tile = VecMDotTile_AVX2;
+#endif
+  if (n < nt*VEC_MDOT_TILE) nt = 1;
+  if (nt > 1) {ierr = PetscMalloc1(nt*VEC_MDOT_BATCH,&work);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xin,&x);CHKERRQ(ierr);
+  for (k=0; k<nv; k++) z[k] = 0.0;
+  for (b=0; b<nv; b+=VEC_MDOT_BATCH) {
+    nb = PetscMin(VEC_MDOT_BATCH,nv-b);
+    for (k=0; k<nb; k++) {ierr = VecGetArrayRead(yin[b+k],&y[k]);CHKERRQ(ierr);}
+    if (nt > 1) {
+#if defined(PETSC_HAVE_OPENMP)
+      PetscInt t;
+
+      ierr = PetscMemzero(work,nt*nb*sizeof(PetscScalar));CHKERRQ(ierr);
+#pragma omp parallel num_threads(nt)
+      {
+        PetscInt tid = omp_get_thread_num(),nth = omp_get_num_threads(),start,end;
+
+        VecMDotThreadRange_Private(n,tid,nth,&start,&end);
+        VecMDotRange_Private(tile,start,end,x,nb,y,work+tid*nb);
+      }
+      for (t=0; t<nt; t++) {
+        for (k=0; k<nb; k++) z[b+k] += work[t*nb+k];
+      }
+#endif
+    } else VecMDotRange_Private(tile,0,n,x,nb,y,z+b);
+    for (k=0; k<nb; k++) {ierr = VecRestoreArrayRead(yin[b+k],&y[k]);CHKERRQ(ierr);}
+  }
+  ierr = VecRestoreArrayRead(xin,&x);CHKERRQ(ierr);
+  ierr = PetscFree(work);CHKERRQ(ierr);
+  ierr = PetscLogFlops(PetscMax(nv*(2.0*n-1),0.0));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecMAXPY_Seq_Blocked(Vec xin,PetscInt nv,const PetscScalar *alpha,Vec *yin)
+{
+  PetscErrorCode       ierr;
+  PetscInt             n = xin->map->n,nt = VecMDotThreads,nb,b,k;
+  const PetscScalar    *y[VEC_MDOT_BATCH];
+  PetscScalar          *x;
+  VecMAXPYTileFunction tile = VecMAXPYTile_Blocked;
+
+  PetscFunctionBegin;
+  if (VecMDotKernel == VEC_MDOT_KERNEL_UNROLLED) {
+    ierr = VecMAXPY_Seq_Unrolled(xin,nv,alpha,yin);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#if defined(VEC_MDOT_AVX_KERNELS)
+  if (VecMDotKernel == VEC_MDOT_KERNEL_AVX512) tile = VecMAXPYTile_AVX512;
+  else if (VecMDotKernel == VEC_MDOT_KERNEL_AVX2) tile = VecMAXPYTile_AVX2;
+#endif
+  if (n < nt*VEC_MDOT_TILE) nt = 1;
+  ierr = PetscLogFlops(nv*2.0*n);CHKERRQ(ierr);
+  ierr = VecGetArray(xin,&x);CHKERRQ(ierr);
+  for (b=0; b<nv; b+=VEC_MDOT_BATCH) {
+    nb = PetscMin(VEC_MDOT_BATCH,nv-b);
+    for (k=0; k<nb; k++) {ierr = VecGetArrayRead(yin[b+k],&y[k]);CHKERRQ(ierr);}
+    if (nt > 1) {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel num_threads(nt)
+      {
+        PetscInt tid = omp_get_thread_num(),nth = omp_get_num_threads(),start,end;
+
+        VecMDotThreadRange_Private(n,tid,nth,&start,&end);
+        VecMAXPYRange_Private(tile,start,end,x,nb,alpha+b,y);
+      }
+#endif
+    } else VecMAXPYRange_Private(tile,0,n,x,nb,alpha+b,y);
+    for (k=0; k<nb; k++) {ierr = VecRestoreArrayRead(yin[b+k],&y[k]);CHKERRQ(ierr);}
+  }
+  ierr = VecRestoreArray(xin,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* the number of vectors, starting with y[0], whose arrays are consecutive columns of one block with leading dimension n */
+static PetscErrorCode VecMDotContiguousLength_Private(PetscInt n,PetscInt nv,const Vec y[],PetscInt *len)
+{
+  PetscErrorCode    ierr;
+  const PetscScalar *y0,*yk;
+  PetscInt          k;
+
+  PetscFunctionBegin;
+  *len = PetscMin(nv,1);
+  if (nv < 2 || !n) PetscFunctionReturn(0);
+  ierr = VecGetArrayRead(y[0],&y0);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(y[0],&y0);CHKERRQ(ierr);
+  for (k=1; k<nv; k++) {
+    ierr = VecGetArrayRead(y[k],&yk);CHKERRQ(ierr);
+    ierr = VecRestoreArrayRead(y[k],&yk);CHKERRQ(ierr);
+    if (yk != y0+k*n) break;
+  }
+  *len = k;
+  PetscFunctionReturn(0);
+}
+
+/* z = Y^H x with the nv columns of Y starting at the array of y[0] */
+static PetscErrorCode VecMDot_Seq_GEMV(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode    ierr;
+  const PetscScalar *x,*y,one = 1.0,zero = 0.0;
+  PetscBLASInt      bn,bnv,ione = 1;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(xin->map->n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(nv,&bnv);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xin,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(yin[0],&y);CHKERRQ(ierr);
+  PetscStackCallBLAS("BLASgemv",BLASgemv_("C",&bn,&bnv,&one,y,&bn,x,&ione,&zero,z,&ione));
+  ierr = VecRestoreArrayRead(yin[0],&y);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xin,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(nv*(2.0*xin->map->n-1));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* x = x + Y alpha with the nv columns of Y starting at the array of y[0] */
+static PetscErrorCode VecMAXPY_Seq_GEMV(Vec xin,PetscInt nv,const PetscScalar *alpha,Vec *yin)
+{
+  PetscErrorCode    ierr;
+  const PetscScalar *y,one = 1.0;
+  PetscScalar       *x;
+  PetscBLASInt      bn,bnv,ione = 1;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(xin->map->n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(nv,&bnv);CHKERRQ(ierr);
+  ierr = VecGetArray(xin,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(yin[0],&y);CHKERRQ(ierr);
+  PetscStackCallBLAS("BLASgemv",BLASgemv_("N",&bn,&bnv,&one,y,&bn,alpha,&ione,&one,x,&ione));
+  ierr = VecRestoreArrayRead(yin[0],&y);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xin,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(nv*2.0*xin->map->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The vectors are split into runs of contiguous ones, each handled by one gemv, and the stretches between them, handled
+   by the blocked (or unrolled) kernels
+*/
+PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode ierr;
+  PetscInt       n = xin->map->n,k = 0,e,len;
+
+  PetscFunctionBegin;
+  if (!VecMDotUseGEMV) {
+    ierr = VecMDot_Seq_Blocked(xin,nv,yin,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  while (k < nv) {
+    ierr = VecMDotContiguousLength_Private(n,nv-k,yin+k,&len);CHKERRQ(ierr);
+    if (len > 1) {
+      ierr = VecMDot_Seq_GEMV(xin,len,yin+k,z+k);CHKERRQ(ierr);
+      k   += len;
+    } else {
+      for (e=k+1; e<nv; e++) {
+        ierr = VecMDotContiguousLength_Private(n,nv-e,yin+e,&len);CHKERRQ(ierr);
+        if (len > 1) break;
+      }
+      ierr = VecMDot_Seq_Blocked(xin,e-k,yin+k,z+k);CHKERRQ(ierr);
+      k    = e;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecMAXPY_Seq(Vec xin,PetscInt nv,const PetscScalar *alpha,Vec *yin)
+{
+  PetscErrorCode ierr;
+  PetscInt       n = xin->map->n,k = 0,e,len;
+
+  PetscFunctionBegin;
+  if (!VecMAXPYUseGEMV) {
+    ierr = VecMAXPY_Seq_Blocked(xin,nv,alpha,yin);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  while (k < nv) {
+    ierr = VecMDotContiguousLength_Private(n,nv-k,yin+k,&len);CHKERRQ(ierr);
+    if (len > 1) {
+      ierr = VecMAXPY_Seq_GEMV(xin,len,alpha+k,yin+k);CHKERRQ(ierr);
+      k   += len;
+    } else {
+      for (e=k+1; e<nv; e++) {
+        ierr = VecMDotContiguousLength_Private(n,nv-e,yin+e,&len);CHKERRQ(ierr);
+        if (len > 1) break;
+      }
+      ierr = VecMAXPY_Seq_Blocked(xin,e-k,alpha+k,yin+k);CHKERRQ(ierr);
+      k    = e;
+    }
+  }
+  PetscFunctionReturn(0);
+}
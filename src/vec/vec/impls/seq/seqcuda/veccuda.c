@@ -395,6 +395,8 @@ PetscErrorCode VecCreate_SeqCUDA_Private(Vec V,const PetscScalar *array)
   V->ops->aypx                   = VecAYPX_SeqCUDA;
   V->ops->waxpy                  = VecWAXPY_SeqCUDA;
   V->ops->dotnorm2               = VecDotNorm2_SeqCUDA;
+  V->ops->waxpydotnorm           = NULL;
+  V->ops->aypxaxpy               = NULL;
   V->ops->placearray             = VecPlaceArray_SeqCUDA;
   V->ops->replacearray           = VecReplaceArray_SeqCUDA;
   V->ops->resetarray             = VecResetArray_SeqCUDA;
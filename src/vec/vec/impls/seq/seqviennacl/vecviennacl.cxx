@@ -1083,6 +1083,8 @@ PETSC_EXTERN PetscErrorCode VecCreate_SeqViennaCL(Vec V)
   V->ops->aypx            = VecAYPX_SeqViennaCL;
   V->ops->waxpy           = VecWAXPY_SeqViennaCL;
   V->ops->dotnorm2        = VecDotNorm2_SeqViennaCL;
+  V->ops->waxpydotnorm    = NULL;
+  V->ops->aypxaxpy        = NULL;
   V->ops->placearray      = VecPlaceArray_SeqViennaCL;
   V->ops->replacearray    = VecReplaceArray_SeqViennaCL;
   V->ops->resetarray      = VecResetArray_SeqViennaCL;
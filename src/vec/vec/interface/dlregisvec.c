@@ -178,6 +178,8 @@ PetscErrorCode  VecInitializePackage(void)
   ierr = PetscLogEventRegister("VecAXPBYCZ",       VEC_CLASSID,&VEC_AXPBYPCZ);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecWAXPY",         VEC_CLASSID,&VEC_WAXPY);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecMAXPY",         VEC_CLASSID,&VEC_MAXPY);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecWAXPYDotNorm",  VEC_CLASSID,&VEC_WAXPYDotNorm);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecAYPXAXPY",      VEC_CLASSID,&VEC_AYPXAXPY);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecSwap",          VEC_CLASSID,&VEC_Swap);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecOps",           VEC_CLASSID,&VEC_Ops);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecAssemblyBegin", VEC_CLASSID,&VEC_AssemblyBegin);CHKERRQ(ierr);
@@ -242,6 +244,9 @@ PetscErrorCode  VecInitializePackage(void)
   ierr = MPI_Op_create(MPIU_MaxIndex_Local,2,&MPIU_MAXINDEX_OP);CHKERRQ(ierr);
   ierr = MPI_Op_create(MPIU_MinIndex_Local,2,&MPIU_MININDEX_OP);CHKERRQ(ierr);
 
+  /* Select the kernels of VecMDot() and VecMAXPY() for the sequential vectors */
+  ierr = VecMDotSeqInitialize_Private();CHKERRQ(ierr);
+
   /* Register the different norm types for cached norms */
   for (i=0; i<4; i++) {
     ierr = PetscObjectComposedDataRegister(NormIds+i);CHKERRQ(ierr);
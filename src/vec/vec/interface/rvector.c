@@ -802,6 +802,140 @@ PetscErrorCode  VecWAXPY(Vec w,PetscScalar alpha,Vec x,Vec y)
   PetscFunctionReturn(0);
 }
 
+/*@
+   VecWAXPYDotNorm - Computes w = alpha x + y together with the inner product (w,z) and the 2-norm of the new w,
+   passing over the vectors only once when the vector type provides a fused kernel.
+
+   Collective on Vec
+
+   Input Parameters:
++  alpha - the scalar
+.  x, y  - the vectors
+-  z     - the vector for the inner product, or NULL
+
+   Output Parameters:
++  w  - the result, it may be y in which case this computes y = y + alpha x
+.  dp - the inner product w'conj(z) as computed by VecDot(w,z), or NULL if z is NULL
+-  nm - the 2-norm of w, or NULL
+
+   Level: advanced
+
+   Notes:
+    w cannot be x, z may be any of the vectors.
+
+    Vector types without a fused kernel compute the result with VecWAXPY() or VecAXPY(), VecDot() and VecNorm().
+    The norm is cached in w so a following VecNorm() with NORM_2 is free.
+
+   Concepts: vector^BLAS
+   Concepts: BLAS
+
+.seealso: VecWAXPY(), VecAXPY(), VecDot(), VecNorm(), VecDotNorm2(), VecAYPXAXPY()
+@*/
+PetscErrorCode  VecWAXPYDotNorm(Vec w,PetscScalar alpha,Vec x,Vec y,Vec z,PetscScalar *dp,PetscReal *nm)
+{
+  PetscErrorCode ierr;
+  PetscScalar    dpx = 0.0;
+  PetscReal      nmx;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(w,VEC_CLASSID,1);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,3);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,4);
+  PetscValidType(w,1);
+  PetscValidType(x,3);
+  PetscValidType(y,4);
+  PetscCheckSameTypeAndComm(x,3,y,4);
+  PetscCheckSameTypeAndComm(y,4,w,1);
+  VecCheckSameSize(x,3,y,4);
+  VecCheckSameSize(x,3,w,1);
+  if (z) {
+    PetscValidHeaderSpecific(z,VEC_CLASSID,5);
+    PetscValidType(z,5);
+    PetscCheckSameTypeAndComm(z,5,w,1);
+    VecCheckSameSize(z,5,w,1);
+    PetscValidScalarPointer(dp,6);
+  }
+  if (nm) PetscValidRealPointer(nm,7);
+  if (w == x) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Result vector w cannot be same as input vector x");
+  PetscValidLogicalCollectiveScalar(y,alpha,2);
+
+  ierr = PetscLogEventBegin(VEC_WAXPYDotNorm,x,y,w,0);CHKERRQ(ierr);
+  if (w->ops->waxpydotnorm) {
+    /* the implementations return the square of the norm */
+    ierr = (*w->ops->waxpydotnorm)(w,alpha,x,y,z,&dpx,&nmx);CHKERRQ(ierr);
+    ierr = PetscObjectStateIncrease((PetscObject)w);CHKERRQ(ierr);
+    nmx  = PetscSqrtReal(nmx);
+    ierr = PetscObjectComposedDataSetReal((PetscObject)w,NormIds[NORM_2],nmx);CHKERRQ(ierr);
+    if (z) *dp = dpx;
+    if (nm) *nm = nmx;
+  } else {
+    if (w == y) {ierr = VecAXPY(w,alpha,x);CHKERRQ(ierr);}
+    else        {ierr = VecWAXPY(w,alpha,x,y);CHKERRQ(ierr);}
+    if (z)  {ierr = VecDot(w,z,dp);CHKERRQ(ierr);}
+    if (nm) {ierr = VecNorm(w,NORM_2,nm);CHKERRQ(ierr);}
+  }
+  ierr = PetscLogEventEnd(VEC_WAXPYDotNorm,x,y,w,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecAYPXAXPY - Computes y = x + beta y followed by w = w + alpha y, passing over the vectors only once
+   when the vector type provides a fused kernel.
+
+   Logically Collective on Vec
+
+   Input Parameters:
++  beta, alpha - the scalars
+-  x - the vector
+
+   Output Parameters:
++  y - the result of the first update
+-  w - the result of the second update
+
+   Level: advanced
+
+   Notes:
+    x, y and w must be different vectors. As with VecAYPX(), the values of y are not used when beta is zero.
+
+    Vector types without a fused kernel compute the result with VecAYPX() and VecAXPY().
+
+   Concepts: vector^BLAS
+   Concepts: BLAS
+
+.seealso: VecAYPX(), VecAXPY(), VecWAXPYDotNorm()
+@*/
+PetscErrorCode  VecAYPXAXPY(Vec y,PetscScalar beta,Vec x,PetscScalar alpha,Vec w)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(y,VEC_CLASSID,1);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,3);
+  PetscValidHeaderSpecific(w,VEC_CLASSID,5);
+  PetscValidType(y,1);
+  PetscValidType(x,3);
+  PetscValidType(w,5);
+  PetscCheckSameTypeAndComm(x,3,y,1);
+  PetscCheckSameTypeAndComm(x,3,w,5);
+  VecCheckSameSize(x,3,y,1);
+  VecCheckSameSize(x,3,w,5);
+  if (x == y || x == w || y == w) SETERRQ(PetscObjectComm((PetscObject)x),PETSC_ERR_ARG_IDN,"x, y, and w must be different vectors");
+  PetscValidLogicalCollectiveScalar(y,beta,2);
+  PetscValidLogicalCollectiveScalar(y,alpha,4);
+
+  ierr = PetscLogEventBegin(VEC_AYPXAXPY,x,y,w,0);CHKERRQ(ierr);
+  if (y->ops->aypxaxpy) {
+    ierr = (*y->ops->aypxaxpy)(y,beta,x,alpha,w);CHKERRQ(ierr);
+    ierr = PetscObjectStateIncrease((PetscObject)y);CHKERRQ(ierr);
+    ierr = PetscObjectStateIncrease((PetscObject)w);CHKERRQ(ierr);
+  } else {
+    ierr = VecAYPX(y,beta,x);CHKERRQ(ierr);
+    ierr = VecAXPY(w,alpha,y);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(VEC_AYPXAXPY,x,y,w,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 
 /*@C
    VecSetValues - Inserts or adds values into certain locations of a vector.
@@ -1155,6 +1289,11 @@ PetscErrorCode  VecMTDot(Vec x,PetscInt nv,const Vec y[],PetscScalar val[])
    Output Parameter:
 .  val - array of the dot products (does not allocate the array)
 
+   Options Database Keys:
++  -vec_mdot_kernel <unrolled,blocked,avx2,avx512> - the kernels used by VECSEQ and VECMPI, by default unrolled
+.  -vec_mdot_threads <n> - number of OpenMP threads used by the blocked kernels (selected by this option unless -vec_mdot_kernel is given), 0 for omp_get_max_threads()
+-  -vec_mdot_use_gemv <true,false> - use a single BLAS gemv for the vectors from one VecDuplicateVecs(), whose arrays are contiguous
+
    Notes for Users of Complex Numbers:
    For complex vectors, VecMDot() computes
 $     val = (x,y) = y^H x,
@@ -1205,6 +1344,11 @@ PetscErrorCode  VecMDot(Vec x,PetscInt nv,const Vec y[],PetscScalar val[])
 .  y - one vector
 -  x - array of vectors
 
+   Options Database Keys:
++  -vec_mdot_kernel <unrolled,blocked,avx2,avx512> - the kernels used by VECSEQ and VECMPI, see VecMDot()
+.  -vec_mdot_threads <n> - number of OpenMP threads used by these kernels
+-  -vec_maxpy_use_gemv <true,false> - use a single BLAS gemv for the vectors from one VecDuplicateVecs(), whose arrays are contiguous
+
    Level: intermediate
 
    Notes:
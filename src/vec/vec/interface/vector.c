@@ -12,7 +12,7 @@ PetscLogEvent VEC_Norm, VEC_Normalize, VEC_Scale, VEC_Copy, VEC_Set, VEC_AXPY, V
 PetscLogEvent VEC_MTDot, VEC_MAXPY, VEC_Swap, VEC_AssemblyBegin, VEC_ScatterBegin, VEC_ScatterEnd;
 PetscLogEvent VEC_AssemblyEnd, VEC_PointwiseMult, VEC_SetValues, VEC_Load;
 PetscLogEvent VEC_SetRandom, VEC_ReduceArithmetic, VEC_ReduceCommunication,VEC_ReduceBegin,VEC_ReduceEnd,VEC_Ops;
-PetscLogEvent VEC_DotNorm2, VEC_AXPBYPCZ;
+PetscLogEvent VEC_DotNorm2, VEC_AXPBYPCZ, VEC_WAXPYDotNorm, VEC_AYPXAXPY;
 PetscLogEvent VEC_ViennaCLCopyFromGPU, VEC_ViennaCLCopyToGPU;
 PetscLogEvent VEC_CUDACopyFromGPU, VEC_CUDACopyToGPU;
 PetscLogEvent VEC_CUDACopyFromGPUSome, VEC_CUDACopyToGPUSome;
@@ -429,6 +429,10 @@ PetscErrorCode  VecDestroy(Vec *v)
    Use VecDestroyVecs() to free the space. Use VecDuplicate() to form a single
    vector.
 
+   For VECSEQ and VECMPI (without ghost points) the arrays of the m vectors are the consecutive columns
+   of one column-major block, so that VecMDot() and VecMAXPY() on them are computed with a single BLAS gemv.
+   The block is freed when the last of the vectors is destroyed.
+
    Fortran Note:
    The Fortran interface is slightly different from that given below, it
    requires one to pass in V a Vec (integer) array of size at least m.
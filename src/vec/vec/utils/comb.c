@@ -17,6 +17,10 @@
          - The order of the xxxEnd() functions MUST be in the same order
            as the xxxBegin(). There is extensive error checking to try to
            insure that the user calls the routines in the correct order
+
+       Any mix of sums, max, min and reductions registered with PetscSplitReductionRegisterOp() can be
+   queued with PetscCommSplitReductionValuesBegin(), MatNormBegin() and the VecXxxBegin() routines; all of
+   them are combined in one (nonblocking) MPI_Allreduce().
 */
 
 #include <petsc/private/vecimpl.h>    /*I   "petscvec.h"    I*/
@@ -46,6 +50,12 @@ some of each.
 
 static PetscErrorCode PetscSplitReductionApply(PetscSplitReduction*);
 
+/*
+   The user defined reductions, their PetscSRReductionType is PETSC_SR_REDUCE_MIN + 1 + the index in this array
+*/
+static PetscScalar (**PetscSplitReductionUserOps)(PetscScalar,PetscScalar) = NULL;
+static PetscInt   PetscSplitReductionNumUserOps = 0,PetscSplitReductionMaxUserOps = 0;
+
 /*
    PetscSplitReductionCreate - Creates a data structure to contain the queued information.
 */
@@ -94,18 +104,66 @@ PETSC_EXTERN void MPIAPI PetscSplitReduction_Local(void *in,void *out,PetscMPIIn
   }
   count = count/2;
   for (i=0; i<count; i++) {
+    PetscInt type = (PetscInt)PetscRealPart(xin[count+i]);
      /* second half of xin[] is flags for reduction type */
-    if      ((PetscInt)PetscRealPart(xin[count+i]) == PETSC_SR_REDUCE_SUM) xout[i] += xin[i];
-    else if ((PetscInt)PetscRealPart(xin[count+i]) == PETSC_SR_REDUCE_MAX) xout[i] = PetscMax(*(PetscReal*)(xout+i),*(PetscReal*)(xin+i));
-    else if ((PetscInt)PetscRealPart(xin[count+i]) == PETSC_SR_REDUCE_MIN) xout[i] = PetscMin(*(PetscReal*)(xout+i),*(PetscReal*)(xin+i));
-    else {
-      (*PetscErrorPrintf)("Reduction type input is not PETSC_SR_REDUCE_SUM, PETSC_SR_REDUCE_MAX, or PETSC_SR_REDUCE_MIN");
+    if      (type == PETSC_SR_REDUCE_SUM) xout[i] += xin[i];
+    else if (type == PETSC_SR_REDUCE_MAX) xout[i] = PetscMax(*(PetscReal*)(xout+i),*(PetscReal*)(xin+i));
+    else if (type == PETSC_SR_REDUCE_MIN) xout[i] = PetscMin(*(PetscReal*)(xout+i),*(PetscReal*)(xin+i));
+    else if (type > PETSC_SR_REDUCE_MIN && type <= PETSC_SR_REDUCE_MIN + PetscSplitReductionNumUserOps) {
+      xout[i] = (*PetscSplitReductionUserOps[type-PETSC_SR_REDUCE_MIN-1])(xin[i],xout[i]);
+    } else {
+      (*PetscErrorPrintf)("Reduction type input is not PETSC_SR_REDUCE_SUM, PETSC_SR_REDUCE_MAX, PETSC_SR_REDUCE_MIN or registered with PetscSplitReductionRegisterOp()");
       MPI_Abort(MPI_COMM_SELF,1);
     }
   }
   PetscFunctionReturnVoid();
 }
 
+/*
+   PetscSplitReductionGetMPIOp - Selects the MPI operation for the queued reductions. PetscSplitReduction_Op is needed
+   when the reductions are a mix of sums, max and min or when some of them are user defined; it finds the type of each
+   value in the second half of lvalues[].
+*/
+static PetscErrorCode PetscSplitReductionGetMPIOp(PetscSplitReduction *sr,PetscMPIInt *count,MPI_Datatype *datatype,MPI_Op *op)
+{
+  PetscInt    i,numops = sr->numopsbegin,*reducetype = sr->reducetype;
+  PetscInt    sum_flg = 0,max_flg = 0,min_flg = 0,user_flg = 0;
+  PetscMPIInt cmul = sizeof(PetscScalar)/sizeof(PetscReal);
+
+  PetscFunctionBegin;
+  /* determine if all reductions are sum, max, or min */
+  for (i=0; i<numops; i++) {
+    if      (reducetype[i] == PETSC_SR_REDUCE_MAX) max_flg = 1;
+    else if (reducetype[i] == PETSC_SR_REDUCE_SUM) sum_flg = 1;
+    else if (reducetype[i] == PETSC_SR_REDUCE_MIN) min_flg = 1;
+    else if (reducetype[i] > PETSC_SR_REDUCE_MIN && reducetype[i] <= PETSC_SR_REDUCE_MIN + PetscSplitReductionNumUserOps) user_flg = 1;
+    else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Error in PetscSplitReduction() data structure, probably memory corruption");
+  }
+  if (user_flg || sum_flg + max_flg + min_flg > 1) {
+    /*
+       after all the entires in lvalues we store the reducetype flags to indicate
+       to the reduction operations what are sums and what are max
+    */
+    for (i=0; i<numops; i++) sr->lvalues[numops+i] = reducetype[i];
+    *count    = 2*numops;
+    *datatype = MPIU_SCALAR;
+    *op       = PetscSplitReduction_Op;
+  } else if (max_flg) { /* Compute max of real and imag parts separately, presumably only the real part is used */
+    *count    = cmul*numops;
+    *datatype = MPIU_REAL;
+    *op       = MPIU_MAX;
+  } else if (min_flg) {
+    *count    = cmul*numops;
+    *datatype = MPIU_REAL;
+    *op       = MPIU_MIN;
+  } else {
+    *count    = numops;
+    *datatype = MPIU_SCALAR;
+    *op       = MPIU_SUM;
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@
    PetscCommSplitReductionBegin - Begin an asynchronous split-mode reduction
 
@@ -120,7 +178,8 @@ PETSC_EXTERN void MPIAPI PetscSplitReduction_Local(void *in,void *out,PetscMPIIn
    Calling this function is optional when using split-mode reduction. On supporting hardware, calling this after all
    VecXxxBegin() allows the reduction to make asynchronous progress before the result is needed (in VecXxxEnd()).
 
-.seealso: VecNormBegin(), VecNormEnd(), VecDotBegin(), VecDotEnd(), VecTDotBegin(), VecTDotEnd(), VecMDotBegin(), VecMDotEnd(), VecMTDotBegin(), VecMTDotEnd()
+.seealso: VecNormBegin(), VecNormEnd(), VecDotBegin(), VecDotEnd(), VecTDotBegin(), VecTDotEnd(), VecMDotBegin(), VecMDotEnd(), VecMTDotBegin(), VecMTDotEnd(),
+          PetscCommSplitReductionValuesBegin(), MatNormBegin(), PetscCommSplitReductionTest()
 @*/
 PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm comm)
 {
@@ -130,39 +189,19 @@ PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm comm)
   PetscFunctionBegin;
   ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
   if (sr->numopsend > 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Cannot call this after VecxxxEnd() has been called");
-  if (sr->async) {              /* Bad reuse, setup code copied from PetscSplitReductionApply(). */
-    PetscInt       i,numops = sr->numopsbegin,*reducetype = sr->reducetype;
-    PetscScalar    *lvalues = sr->lvalues,*gvalues = sr->gvalues;
-    PetscInt       sum_flg = 0,max_flg = 0, min_flg = 0;
-    MPI_Comm       comm = sr->comm;
-    PetscMPIInt    size,cmul = sizeof(PetscScalar)/sizeof(PetscReal);;
+  if (sr->async) {
+    PetscInt     numops = sr->numopsbegin;
+    PetscMPIInt  size,count;
+    MPI_Datatype datatype;
+    MPI_Op       op;
+
     ierr = PetscLogEventBegin(VEC_ReduceBegin,0,0,0,0);CHKERRQ(ierr);
     ierr = MPI_Comm_size(sr->comm,&size);CHKERRQ(ierr);
     if (size == 1) {
-      ierr = PetscMemcpy(gvalues,lvalues,numops*sizeof(PetscScalar));CHKERRQ(ierr);
+      ierr = PetscMemcpy(sr->gvalues,sr->lvalues,numops*sizeof(PetscScalar));CHKERRQ(ierr);
     } else {
-      /* determine if all reductions are sum, max, or min */
-      for (i=0; i<numops; i++) {
-        if      (reducetype[i] == PETSC_SR_REDUCE_MAX) max_flg = 1;
-        else if (reducetype[i] == PETSC_SR_REDUCE_SUM) sum_flg = 1;
-        else if (reducetype[i] == PETSC_SR_REDUCE_MIN) min_flg = 1;
-        else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Error in PetscSplitReduction() data structure, probably memory corruption");
-      }
-      if (sum_flg + max_flg + min_flg > 1) {
-        /*
-         after all the entires in lvalues we store the reducetype flags to indicate
-         to the reduction operations what are sums and what are max
-         */
-        for (i=0; i<numops; i++) lvalues[numops+i] = reducetype[i];
-
-        ierr = MPIPetsc_Iallreduce(lvalues,gvalues,2*numops,MPIU_SCALAR,PetscSplitReduction_Op,comm,&sr->request);CHKERRQ(ierr);
-      } else if (max_flg) {   /* Compute max of real and imag parts separately, presumably only the real part is used */
-        ierr = MPIPetsc_Iallreduce((PetscReal*)lvalues,(PetscReal*)gvalues,cmul*numops,MPIU_REAL,MPIU_MAX,comm,&sr->request);CHKERRQ(ierr);
-      } else if (min_flg) {
-        ierr = MPIPetsc_Iallreduce((PetscReal*)lvalues,(PetscReal*)gvalues,cmul*numops,MPIU_REAL,MPIU_MIN,comm,&sr->request);CHKERRQ(ierr);
-      } else {
-        ierr = MPIPetsc_Iallreduce(lvalues,gvalues,numops,MPIU_SCALAR,MPIU_SUM,comm,&sr->request);CHKERRQ(ierr);
-      }
+      ierr = PetscSplitReductionGetMPIOp(sr,&count,&datatype,&op);CHKERRQ(ierr);
+      ierr = MPIPetsc_Iallreduce(sr->lvalues,sr->gvalues,count,datatype,op,sr->comm,&sr->request);CHKERRQ(ierr);
     }
     sr->state     = STATE_PENDING;
     sr->numopsend = 0;
@@ -196,46 +235,73 @@ PetscErrorCode PetscSplitReductionEnd(PetscSplitReduction *sr)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PetscCommSplitReductionTest - Tests if the split-mode reduction started with PetscCommSplitReductionBegin() has completed,
+   giving MPI the opportunity to make progress on it
+
+   Collective but not synchronizing
+
+   Input Arguments:
+.  comm - communicator on which split reduction has been queued
+
+   Output Arguments:
+.  flg - PETSC_TRUE if the results are available, so that the VecXxxEnd() will not wait
+
+   Level: advanced
+
+   Notes:
+   Call this between pieces of local work that are overlapped with the reduction; some MPI implementations only
+   progress nonblocking collectives from inside MPI calls. flg is PETSC_FALSE if PetscCommSplitReductionBegin() has
+   not been called.
+
+.seealso: PetscCommSplitReductionBegin(), VecNormBegin(), VecDotBegin(), PetscCommSplitReductionValuesBegin()
+@*/
+PetscErrorCode PetscCommSplitReductionTest(MPI_Comm comm,PetscBool *flg)
+{
+  PetscErrorCode      ierr;
+  PetscSplitReduction *sr;
+  PetscMPIInt         done;
+
+  PetscFunctionBegin;
+  PetscValidPointer(flg,2);
+  ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
+  switch (sr->state) {
+  case STATE_PENDING:
+    if (sr->request != MPI_REQUEST_NULL) {
+      ierr = MPI_Test(&sr->request,&done,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+      if (done) sr->state = STATE_END;
+    } else sr->state = STATE_END;
+    *flg = (sr->state == STATE_END) ? PETSC_TRUE : PETSC_FALSE;
+    break;
+  case STATE_END:
+    *flg = PETSC_TRUE;
+    break;
+  default:
+    *flg = PETSC_FALSE;
+  }
+  PetscFunctionReturn(0);
+}
+
 /*
    PetscSplitReductionApply - Actually do the communication required for a split phase reduction
 */
 static PetscErrorCode PetscSplitReductionApply(PetscSplitReduction *sr)
 {
   PetscErrorCode ierr;
-  PetscInt       i,numops = sr->numopsbegin,*reducetype = sr->reducetype;
-  PetscScalar    *lvalues = sr->lvalues,*gvalues = sr->gvalues;
-  PetscInt       sum_flg  = 0,max_flg = 0, min_flg = 0;
-  MPI_Comm       comm     = sr->comm;
-  PetscMPIInt    size,cmul = sizeof(PetscScalar)/sizeof(PetscReal);
+  PetscInt       numops = sr->numopsbegin;
+  PetscMPIInt    size,count;
+  MPI_Datatype   datatype;
+  MPI_Op         op;
 
   PetscFunctionBegin;
   if (sr->numopsend > 0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Cannot call this after VecxxxEnd() has been called");
   ierr = PetscLogEventBegin(VEC_ReduceCommunication,0,0,0,0);CHKERRQ(ierr);
   ierr = MPI_Comm_size(sr->comm,&size);CHKERRQ(ierr);
   if (size == 1) {
-    ierr = PetscMemcpy(gvalues,lvalues,numops*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscMemcpy(sr->gvalues,sr->lvalues,numops*sizeof(PetscScalar));CHKERRQ(ierr);
   } else {
-    /* determine if all reductions are sum, max, or min */
-    for (i=0; i<numops; i++) {
-      if      (reducetype[i] == PETSC_SR_REDUCE_MAX) max_flg = 1;
-      else if (reducetype[i] == PETSC_SR_REDUCE_SUM) sum_flg = 1;
-      else if (reducetype[i] == PETSC_SR_REDUCE_MIN) min_flg = 1;
-      else SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Error in PetscSplitReduction() data structure, probably memory corruption");
-    }
-    if (sum_flg + max_flg + min_flg > 1) {
-      /*
-         after all the entires in lvalues we store the reducetype flags to indicate
-         to the reduction operations what are sums and what are max
-      */
-      for (i=0; i<numops; i++) lvalues[numops+i] = reducetype[i];
-      ierr = MPIU_Allreduce(lvalues,gvalues,2*numops,MPIU_SCALAR,PetscSplitReduction_Op,comm);CHKERRQ(ierr);
-    } else if (max_flg) {     /* Compute max of real and imag parts separately, presumably only the real part is used */
-      ierr = MPIU_Allreduce((PetscReal*)lvalues,(PetscReal*)gvalues,cmul*numops,MPIU_REAL,MPIU_MAX,comm);CHKERRQ(ierr);
-    } else if (min_flg) {
-      ierr = MPIU_Allreduce((PetscReal*)lvalues,(PetscReal*)gvalues,cmul*numops,MPIU_REAL,MPIU_MIN,comm);CHKERRQ(ierr);
-    } else {
-      ierr = MPIU_Allreduce(lvalues,gvalues,numops,MPIU_SCALAR,MPIU_SUM,comm);CHKERRQ(ierr);
-    }
+    ierr = PetscSplitReductionGetMPIOp(sr,&count,&datatype,&op);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(sr->lvalues,sr->gvalues,count,datatype,op,sr->comm);CHKERRQ(ierr);
   }
   sr->state     = STATE_END;
   sr->numopsend = 0;
@@ -588,14 +654,140 @@ PetscErrorCode  VecNormEnd(Vec x,NormType ntype,PetscReal *result)
   PetscFunctionReturn(0);
 }
 
-/*
-   Possibly add
+static PetscErrorCode PetscSplitReductionUserOpsDestroy(void)
+{
+  PetscErrorCode ierr;
 
-     PetscReductionSumBegin/End()
-     PetscReductionMaxBegin/End()
-     PetscReductionMinBegin/End()
-   or have more like MPI with a single function with flag for Op? Like first better
-*/
+  PetscFunctionBegin;
+  ierr = PetscFree(PetscSplitReductionUserOps);CHKERRQ(ierr);
+  PetscSplitReductionNumUserOps = 0;
+  PetscSplitReductionMaxUserOps = 0;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSplitReductionRegisterOp - Registers a user defined reduction for PetscCommSplitReductionValuesBegin()
+
+   Not Collective, but must be called in the same order on all processes
+
+   Input Parameter:
+.  op - the function combining two values, it must be associative and commutative
+
+   Output Parameter:
+.  type - the reduction type to pass to PetscCommSplitReductionValuesBegin() and PetscCommSplitReductionValuesEnd()
+
+   Level: advanced
+
+   Notes:
+   The values are combined one by one, so a reduction of several values needs one type for each of them.
+
+.seealso: PetscCommSplitReductionValuesBegin(), PetscCommSplitReductionValuesEnd(), PetscSRReductionType
+@*/
+PetscErrorCode PetscSplitReductionRegisterOp(PetscScalar (*op)(PetscScalar,PetscScalar),PetscSRReductionType *type)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidPointer(type,2);
+  if (PetscSplitReductionNumUserOps == PetscSplitReductionMaxUserOps) {
+    PetscScalar (**ops)(PetscScalar,PetscScalar);
+
+    if (!PetscSplitReductionMaxUserOps) {ierr = PetscRegisterFinalize(PetscSplitReductionUserOpsDestroy);CHKERRQ(ierr);}
+    PetscSplitReductionMaxUserOps = PetscMax(4,2*PetscSplitReductionMaxUserOps);
+    ierr = PetscMalloc1(PetscSplitReductionMaxUserOps,&ops);CHKERRQ(ierr);
+    ierr = PetscMemcpy(ops,PetscSplitReductionUserOps,PetscSplitReductionNumUserOps*sizeof(*ops));CHKERRQ(ierr);
+    ierr = PetscFree(PetscSplitReductionUserOps);CHKERRQ(ierr);
+    PetscSplitReductionUserOps = ops;
+  }
+  PetscSplitReductionUserOps[PetscSplitReductionNumUserOps++] = op;
+  *type = (PetscSRReductionType)(PETSC_SR_REDUCE_MIN + PetscSplitReductionNumUserOps);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscCommSplitReductionValuesBegin - Queues the local contributions of a reduction of arbitrary values in the split phase
+   reduction of a communicator, so that they are communicated together with the other split phase reductions
+
+   Collective but not synchronizing
+
+   Input Parameters:
++  comm - the communicator
+.  type - PETSC_SR_REDUCE_SUM, PETSC_SR_REDUCE_MAX, PETSC_SR_REDUCE_MIN or a type obtained with PetscSplitReductionRegisterOp()
+.  n - the number of values
+-  local - the local contributions
+
+   Level: advanced
+
+   Notes:
+   Each call to PetscCommSplitReductionValuesBegin() should be paired with a call to PetscCommSplitReductionValuesEnd()
+   with the same type and number of values. Any number of values may be queued. The max and min compare the real parts.
+
+.seealso: PetscCommSplitReductionValuesEnd(), PetscCommSplitReductionBegin(), PetscCommSplitReductionTest(), PetscSplitReductionRegisterOp(),
+          VecDotBegin(), VecNormBegin(), MatNormBegin()
+@*/
+PetscErrorCode PetscCommSplitReductionValuesBegin(MPI_Comm comm,PetscSRReductionType type,PetscInt n,const PetscScalar local[])
+{
+  PetscErrorCode      ierr;
+  PetscSplitReduction *sr;
+  PetscInt            i;
+
+  PetscFunctionBegin;
+  if (n) PetscValidScalarPointer(local,4);
+  if (type < PETSC_SR_REDUCE_SUM || type > PETSC_SR_REDUCE_MIN + PetscSplitReductionNumUserOps) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Unknown reduction type %D",(PetscInt)type);
+  ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
+  if (sr->state != STATE_BEGIN) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Called before all VecxxxEnd() called");
+  while (sr->numopsbegin + n > sr->maxops) {
+    ierr = PetscSplitReductionExtend(sr);CHKERRQ(ierr);
+  }
+  for (i=0; i<n; i++) {
+    sr->reducetype[sr->numopsbegin] = type;
+    sr->invecs[sr->numopsbegin]     = NULL;
+    sr->lvalues[sr->numopsbegin++]  = local[i];
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscCommSplitReductionValuesEnd - Gets the result of a reduction queued with PetscCommSplitReductionValuesBegin()
+
+   Collective
+
+   Input Parameters:
++  comm - the communicator
+.  type - the type of the reduction given to PetscCommSplitReductionValuesBegin()
+-  n - the number of values
+
+   Output Parameter:
+.  result - the reduced values
+
+   Level: advanced
+
+.seealso: PetscCommSplitReductionValuesBegin(), PetscCommSplitReductionBegin(), PetscCommSplitReductionTest()
+@*/
+PetscErrorCode PetscCommSplitReductionValuesEnd(MPI_Comm comm,PetscSRReductionType type,PetscInt n,PetscScalar result[])
+{
+  PetscErrorCode      ierr;
+  PetscSplitReduction *sr;
+  PetscInt            i;
+
+  PetscFunctionBegin;
+  if (n) PetscValidScalarPointer(result,4);
+  ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
+  ierr = PetscSplitReductionEnd(sr);CHKERRQ(ierr);
+
+  if (sr->numopsend + n > sr->numopsbegin) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called VecxxxEnd() more times then VecxxxBegin()");
+  for (i=0; i<n; i++) {
+    if (sr->reducetype[sr->numopsend] != type) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called PetscCommSplitReductionValuesEnd() in a different order or with a different type than the xxxBegin()");
+    result[i] = sr->gvalues[sr->numopsend++];
+  }
+
+  if (sr->numopsend == sr->numopsbegin) {
+    sr->state       = STATE_BEGIN;
+    sr->numopsend   = 0;
+    sr->numopsbegin = 0;
+  }
+  PetscFunctionReturn(0);
+}
 
 /*@
    VecMDotBegin - Starts a split phase multiple dot product computation.
@@ -540,6 +540,9 @@ static PetscErrorCode VecScatterSetUp_SF(VecScatter vscat)
     ierr = PetscSFSetGraph(data->lsf,nroots,lnleaves,lilocal,PETSC_OWN_POINTER,liremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
   }
 
+  /* the implementation of the whole scatter can be chosen with -sf_type, lsf is on PETSC_COMM_SELF and stays basic */
+  ierr = PetscSFSetFromOptions(data->sf);CHKERRQ(ierr);
+
   /* vecscatter uses eager setup */
   ierr = PetscSFSetUp(data->sf);CHKERRQ(ierr);
   ierr = PetscSFSetUp(data->lsf);CHKERRQ(ierr);